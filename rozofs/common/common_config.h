@@ -46,6 +46,18 @@ typedef struct _common_config_global_t {
   // order to collocate some RozoFS modules on the same node for memory
   // access efficiency.
   uint32_t    numa_aware;
+  // Whether the large buffer pools are allocated on explicit 2MB huge pages
+  // (MAP_HUGETLB/SHM_HUGETLB). Huge pages must have been reserved through
+  // /proc/sys/vm/nr_hugepages, else transparent huge pages are used.
+  uint32_t    buffer_hugepage;
+  // Whether the socket controller of the RozoFS processes waits for
+  // events with epoll instead of select. With epoll only the sockets
+  // with a conditional receive are polled on each loop.
+  uint32_t    sockctrl_epoll;
+  // Whether the stream sockets of the RozoFS processes send the queued
+  // messages with one sendmsg call and read ahead the next message header
+  // with recvmsg.
+  uint32_t    socket_vectored_io;
   // Number of slices in the STORIO.
   uint32_t    storio_slice_number;
   // File distribution mode upon cluster, storages and devices. Check rozofs.conf manual.
@@ -57,12 +69,17 @@ typedef struct _common_config_global_t {
   uint32_t    storio_dscp;
   // DSCP for exchanges from/to the EXPORTD.
   uint32_t    export_dscp;
+  // Whether the STORIO disk threads, the STORCLI Mojette threads and the 
+  // rozofsmount fuse reply threads exchange with their main thread through 
+  // shared memory rings instead of AF_UNIX sockets.
+  uint32_t    thread_ring;
 
   /*
   ** export scope configuration elements
   */
 
   // Max number of file that the exportd can remove from storages in a run.
+  // The files are removed by batches sent to every storage in parallel.
   // A new run occurs every 2 seconds.
   uint32_t    trashed_file_per_run;
   // High trash water mark when FID recycling is activated.
@@ -74,6 +91,10 @@ typedef struct _common_config_global_t {
   uint32_t    export_buf_cnt;
   // To activate export writebehind attributes thread.
   uint32_t    export_attr_thread;
+  // Number of metadata shard threads of an exportd slave. The getattr requests
+  // are processed by the thread of the shard of their FID, while the other 
+  // requests stay in the main thread. 0 keeps every request in the main thread.
+  uint32_t    export_shard_threads;
   // Support of deleted directory/file versioning.
   uint32_t    export_versioning;
   // Number of MB to account a file for during file distribution phase
@@ -103,6 +124,22 @@ typedef struct _common_config_global_t {
 
   // Whether STORCLI acknowleges write request on inverse or forward STORIO responses.
   uint32_t    wr_ack_on_inverse;
+  // Whether STORCLI acknowleges write request once inverse+1 projections are
+  // written, and completes the other projections in the background.
+  uint32_t    wr_ack_early;
+  // Whether STORCLI reads the projections preferentially on the storages 
+  // that answer the fastest and have the least pending reads.
+  uint32_t    storcli_latency_select;
+  // Percentile of the projection read response times after which STORCLI 
+  // reads a spare projection when some projections are still missing.
+  // 0 keeps the fixed spare read delay.
+  uint32_t    storcli_hedge_percentile;
+  // Maximum number of lookup and getattr requests rozofsmount packs in one
+  // EP_BATCH request to the exportd. 0 or 1 sends every request alone.
+  uint32_t    client_batch_max;
+  // Number of directory entries rozofsmount keeps from the EP_READDIRPLUS
+  // responses to answer the lookups that follow a readdir. 0 disables readdirplus.
+  uint32_t    client_readdirplus_cache;
   // To activate rozofsmount reply fuse threads.
   uint32_t    rozofsmount_fuse_reply_thread;
   // To activate fast reconnect from client to exportd
@@ -126,6 +163,21 @@ typedef struct _common_config_global_t {
 
   // Number of disk threads in the STORIO.
   uint32_t    nb_disk_thread;
+  // Whether STORIO disk threads use io_uring to keep several chunk 
+  // reads and writes in flight instead of one blocking request per thread.
+  uint32_t    storio_io_uring;
+  // Number of requests each STORIO disk thread keeps in flight 
+  // when io_uring is used.
+  uint32_t    storio_io_uring_depth;
+  // Whether STORIO queues the read and write requests per device, 
+  // ordering them by offset and merging the contiguous ones.
+  uint32_t    storio_scheduler;
+  // Maximum number of disk accesses in flight per device 
+  // when the STORIO scheduler is enabled.
+  uint32_t    storio_scheduler_depth;
+  // Delay in micro seconds after which a request queued by the STORIO 
+  // scheduler is served whatever its offset.
+  uint32_t    storio_scheduler_window;
   // Whether STORIO is in multiple (1 STORIO per cluster) 
   // or single mode (only 1 STORIO).
   uint32_t    storio_multiple_mode;
@@ -181,6 +233,17 @@ typedef struct _common_config_global_t {
   // spareOnly  only self repair on a spare disk
   // relocate   also repair on remaining disks when no spare available
   char *      device_selfhealing_mode;
+  // Number of FIDs a rebuild process rebuilds in parallel, each one 
+  // on its own thread with its own connections to the storios.
+  uint32_t    rebuild_fid_parallel;
+  // Number of decoded block ranges a rebuild thread may queue for being 
+  // written on the rebuilt storio while it reads the next ones.
+  // 0 means the projections are written synchronously.
+  uint32_t    rebuild_write_queue;
+  // Maximum size in MB of the journal of the chunks written on spare
+  // storages while a nominal storage is unreachable. There is one journal
+  // per nominal storage. 0 disables the journal.
+  uint32_t    storio_dirty_journal;
   // Export host names or IP addresses separated with / 
   // Required for selfhealing.
   // Required for spare file restoring to its nominal location.
@@ -192,6 +255,12 @@ typedef struct _common_config_global_t {
   // Spare file restoring : throughput limitation for reading and analyzing spare files in MB/s
   // 0 means no limit
   uint32_t    spare_restore_read_throughput;
+  // Spare file restoring : number of spare files restored in parallel.
+  // The most recently written spare files are restored first.
+  uint32_t    spare_restore_parallel;
+  // Spare file restoring : maximum number of restorations running in parallel
+  // toward the same storage
+  uint32_t    spare_restore_per_storage;
 } common_config_t;
 
 extern common_config_t common_config;
@@ -58,6 +58,18 @@ char * show_module_global(char * pChar) {
   pChar += rozofs_string_append(pChar,"// order to collocate some RozoFS modules on the same node for memory\n");
   pChar += rozofs_string_append(pChar,"// access efficiency.\n");
   COMMON_CONFIG_SHOW_BOOL(numa_aware,False);
+  pChar += rozofs_string_append(pChar,"// Whether the large buffer pools are allocated on explicit 2MB huge pages\n");
+  pChar += rozofs_string_append(pChar,"// (MAP_HUGETLB/SHM_HUGETLB). Huge pages must have been reserved through\n");
+  pChar += rozofs_string_append(pChar,"// /proc/sys/vm/nr_hugepages, else transparent huge pages are used.\n");
+  COMMON_CONFIG_SHOW_BOOL(buffer_hugepage,False);
+  pChar += rozofs_string_append(pChar,"// Whether the socket controller of the RozoFS processes waits for\n");
+  pChar += rozofs_string_append(pChar,"// events with epoll instead of select. With epoll only the sockets\n");
+  pChar += rozofs_string_append(pChar,"// with a conditional receive are polled on each loop.\n");
+  COMMON_CONFIG_SHOW_BOOL(sockctrl_epoll,False);
+  pChar += rozofs_string_append(pChar,"// Whether the stream sockets of the RozoFS processes send the queued\n");
+  pChar += rozofs_string_append(pChar,"// messages with one sendmsg call and read ahead the next message header\n");
+  pChar += rozofs_string_append(pChar,"// with recvmsg.\n");
+  COMMON_CONFIG_SHOW_BOOL(socket_vectored_io,False);
   pChar += rozofs_string_append(pChar,"// Number of slices in the STORIO.\n");
   COMMON_CONFIG_SHOW_INT_OPT(storio_slice_number,1024,"8:(32*1024)");
   pChar += rozofs_string_append(pChar,"// File distribution mode upon cluster, storages and devices. Check rozofs.conf manual.\n");
@@ -69,6 +81,10 @@ char * show_module_global(char * pChar) {
   COMMON_CONFIG_SHOW_INT_OPT(storio_dscp,46,"0:46");
   pChar += rozofs_string_append(pChar,"// DSCP for exchanges from/to the EXPORTD.\n");
   COMMON_CONFIG_SHOW_INT_OPT(export_dscp,34,"0:34");
+  pChar += rozofs_string_append(pChar,"// Whether the STORIO disk threads, the STORCLI Mojette threads and the \n");
+  pChar += rozofs_string_append(pChar,"// rozofsmount fuse reply threads exchange with their main thread through \n");
+  pChar += rozofs_string_append(pChar,"// shared memory rings instead of AF_UNIX sockets.\n");
+  COMMON_CONFIG_SHOW_BOOL(thread_ring,False);
   return pChar;
 }
 /*____________________________________________________________________________________________
@@ -82,8 +98,9 @@ char * show_module_export(char * pChar) {
   pChar += rozofs_string_append(pChar,"# export scope configuration elements\n");
   pChar += rozofs_string_append(pChar,"#\n\n");
   pChar += rozofs_string_append(pChar,"// Max number of file that the exportd can remove from storages in a run.\n");
+  pChar += rozofs_string_append(pChar,"// The files are removed by batches sent to every storage in parallel.\n");
   pChar += rozofs_string_append(pChar,"// A new run occurs every 2 seconds.\n");
-  COMMON_CONFIG_SHOW_INT_OPT(trashed_file_per_run,7,"0:5000");
+  COMMON_CONFIG_SHOW_INT_OPT(trashed_file_per_run,7,"0:100000");
   pChar += rozofs_string_append(pChar,"// High trash water mark when FID recycling is activated.\n");
   pChar += rozofs_string_append(pChar,"// When the trash has already this number of files, files are no more\n");
   pChar += rozofs_string_append(pChar,"// deleted but recycled.\n");
@@ -93,6 +110,10 @@ char * show_module_export(char * pChar) {
   COMMON_CONFIG_SHOW_INT_OPT(export_buf_cnt,128,"32:1024");
   pChar += rozofs_string_append(pChar,"// To activate export writebehind attributes thread.\n");
   COMMON_CONFIG_SHOW_BOOL(export_attr_thread,True);
+  pChar += rozofs_string_append(pChar,"// Number of metadata shard threads of an exportd slave. The getattr requests\n");
+  pChar += rozofs_string_append(pChar,"// are processed by the thread of the shard of their FID, while the other \n");
+  pChar += rozofs_string_append(pChar,"// requests stay in the main thread. 0 keeps every request in the main thread.\n");
+  COMMON_CONFIG_SHOW_INT_OPT(export_shard_threads,0,"0:16");
   pChar += rozofs_string_append(pChar,"// Support of deleted directory/file versioning.\n");
   COMMON_CONFIG_SHOW_BOOL(export_versioning,False);
   pChar += rozofs_string_append(pChar,"// Number of MB to account a file for during file distribution phase\n");
@@ -129,6 +150,22 @@ char * show_module_client(char * pChar) {
   pChar += rozofs_string_append(pChar,"#\n\n");
   pChar += rozofs_string_append(pChar,"// Whether STORCLI acknowleges write request on inverse or forward STORIO responses.\n");
   COMMON_CONFIG_SHOW_BOOL(wr_ack_on_inverse,False);
+  pChar += rozofs_string_append(pChar,"// Whether STORCLI acknowleges write request once inverse+1 projections are\n");
+  pChar += rozofs_string_append(pChar,"// written, and completes the other projections in the background.\n");
+  COMMON_CONFIG_SHOW_BOOL(wr_ack_early,False);
+  pChar += rozofs_string_append(pChar,"// Whether STORCLI reads the projections preferentially on the storages \n");
+  pChar += rozofs_string_append(pChar,"// that answer the fastest and have the least pending reads.\n");
+  COMMON_CONFIG_SHOW_BOOL(storcli_latency_select,False);
+  pChar += rozofs_string_append(pChar,"// Percentile of the projection read response times after which STORCLI \n");
+  pChar += rozofs_string_append(pChar,"// reads a spare projection when some projections are still missing.\n");
+  pChar += rozofs_string_append(pChar,"// 0 keeps the fixed spare read delay.\n");
+  COMMON_CONFIG_SHOW_INT_OPT(storcli_hedge_percentile,0,"0:99");
+  pChar += rozofs_string_append(pChar,"// Maximum number of lookup and getattr requests rozofsmount packs in one\n");
+  pChar += rozofs_string_append(pChar,"// EP_BATCH request to the exportd. 0 or 1 sends every request alone.\n");
+  COMMON_CONFIG_SHOW_INT_OPT(client_batch_max,0,"0:16");
+  pChar += rozofs_string_append(pChar,"// Number of directory entries rozofsmount keeps from the EP_READDIRPLUS\n");
+  pChar += rozofs_string_append(pChar,"// responses to answer the lookups that follow a readdir. 0 disables readdirplus.\n");
+  COMMON_CONFIG_SHOW_INT_OPT(client_readdirplus_cache,0,"0:1048576");
   pChar += rozofs_string_append(pChar,"// To activate rozofsmount reply fuse threads.\n");
   COMMON_CONFIG_SHOW_BOOL(rozofsmount_fuse_reply_thread,False);
   pChar += rozofs_string_append(pChar,"// To activate fast reconnect from client to exportd\n");
@@ -159,6 +196,21 @@ char * show_module_storage(char * pChar) {
   pChar += rozofs_string_append(pChar,"#\n\n");
   pChar += rozofs_string_append(pChar,"// Number of disk threads in the STORIO.\n");
   COMMON_CONFIG_SHOW_INT_OPT(nb_disk_thread,4,"2:64");
+  pChar += rozofs_string_append(pChar,"// Whether STORIO disk threads use io_uring to keep several chunk \n");
+  pChar += rozofs_string_append(pChar,"// reads and writes in flight instead of one blocking request per thread.\n");
+  COMMON_CONFIG_SHOW_BOOL(storio_io_uring,False);
+  pChar += rozofs_string_append(pChar,"// Number of requests each STORIO disk thread keeps in flight \n");
+  pChar += rozofs_string_append(pChar,"// when io_uring is used.\n");
+  COMMON_CONFIG_SHOW_INT_OPT(storio_io_uring_depth,64,"8:1024");
+  pChar += rozofs_string_append(pChar,"// Whether STORIO queues the read and write requests per device, \n");
+  pChar += rozofs_string_append(pChar,"// ordering them by offset and merging the contiguous ones.\n");
+  COMMON_CONFIG_SHOW_BOOL(storio_scheduler,False);
+  pChar += rozofs_string_append(pChar,"// Maximum number of disk accesses in flight per device \n");
+  pChar += rozofs_string_append(pChar,"// when the STORIO scheduler is enabled.\n");
+  COMMON_CONFIG_SHOW_INT_OPT(storio_scheduler_depth,4,"1:64");
+  pChar += rozofs_string_append(pChar,"// Delay in micro seconds after which a request queued by the STORIO \n");
+  pChar += rozofs_string_append(pChar,"// scheduler is served whatever its offset.\n");
+  COMMON_CONFIG_SHOW_INT_OPT(storio_scheduler_window,2000,"0:1000000");
   pChar += rozofs_string_append(pChar,"// Whether STORIO is in multiple (1 STORIO per cluster) \n");
   pChar += rozofs_string_append(pChar,"// or single mode (only 1 STORIO).\n");
   COMMON_CONFIG_SHOW_BOOL(storio_multiple_mode,True);
@@ -214,6 +266,17 @@ char * show_module_storage(char * pChar) {
   pChar += rozofs_string_append(pChar,"// spareOnly  only self repair on a spare disk\n");
   pChar += rozofs_string_append(pChar,"// relocate   also repair on remaining disks when no spare available\n");
   COMMON_CONFIG_SHOW_STRING(device_selfhealing_mode,"spareOnly");
+  pChar += rozofs_string_append(pChar,"// Number of FIDs a rebuild process rebuilds in parallel, each one \n");
+  pChar += rozofs_string_append(pChar,"// on its own thread with its own connections to the storios.\n");
+  COMMON_CONFIG_SHOW_INT_OPT(rebuild_fid_parallel,1,"1:64");
+  pChar += rozofs_string_append(pChar,"// Number of decoded block ranges a rebuild thread may queue for being \n");
+  pChar += rozofs_string_append(pChar,"// written on the rebuilt storio while it reads the next ones.\n");
+  pChar += rozofs_string_append(pChar,"// 0 means the projections are written synchronously.\n");
+  COMMON_CONFIG_SHOW_INT_OPT(rebuild_write_queue,0,"0:64");
+  pChar += rozofs_string_append(pChar,"// Maximum size in MB of the journal of the chunks written on spare\n");
+  pChar += rozofs_string_append(pChar,"// storages while a nominal storage is unreachable. There is one journal\n");
+  pChar += rozofs_string_append(pChar,"// per nominal storage. 0 disables the journal.\n");
+  COMMON_CONFIG_SHOW_INT_OPT(storio_dirty_journal,0,"0:4096");
   pChar += rozofs_string_append(pChar,"// Export host names or IP addresses separated with / \n");
   pChar += rozofs_string_append(pChar,"// Required for selfhealing.\n");
   pChar += rozofs_string_append(pChar,"// Required for spare file restoring to its nominal location.\n");
@@ -225,6 +288,12 @@ char * show_module_storage(char * pChar) {
   pChar += rozofs_string_append(pChar,"// Spare file restoring : throughput limitation for reading and analyzing spare files in MB/s\n");
   pChar += rozofs_string_append(pChar,"// 0 means no limit\n");
   COMMON_CONFIG_SHOW_INT(spare_restore_read_throughput,5);
+  pChar += rozofs_string_append(pChar,"// Spare file restoring : number of spare files restored in parallel.\n");
+  pChar += rozofs_string_append(pChar,"// The most recently written spare files are restored first.\n");
+  COMMON_CONFIG_SHOW_INT_OPT(spare_restore_parallel,4,"1:64");
+  pChar += rozofs_string_append(pChar,"// Spare file restoring : maximum number of restorations running in parallel\n");
+  pChar += rozofs_string_append(pChar,"// toward the same storage\n");
+  COMMON_CONFIG_SHOW_INT_OPT(spare_restore_per_storage,2,"1:64");
   return pChar;
 }
 /*____________________________________________________________________________________________
@@ -317,6 +386,18 @@ static inline void common_config_generated_read(char * fname) {
   // order to collocate some RozoFS modules on the same node for memory 
   // access efficiency. 
   COMMON_CONFIG_READ_BOOL(numa_aware,False);
+  // Whether the large buffer pools are allocated on explicit 2MB huge pages 
+  // (MAP_HUGETLB/SHM_HUGETLB). Huge pages must have been reserved through 
+  // /proc/sys/vm/nr_hugepages, else transparent huge pages are used. 
+  COMMON_CONFIG_READ_BOOL(buffer_hugepage,False);
+  // Whether the socket controller of the RozoFS processes waits for 
+  // events with epoll instead of select. With epoll only the sockets 
+  // with a conditional receive are polled on each loop. 
+  COMMON_CONFIG_READ_BOOL(sockctrl_epoll,False);
+  // Whether the stream sockets of the RozoFS processes send the queued 
+  // messages with one sendmsg call and read ahead the next message header 
+  // with recvmsg. 
+  COMMON_CONFIG_READ_BOOL(socket_vectored_io,False);
   // Number of slices in the STORIO. 
   COMMON_CONFIG_READ_INT_MINMAX(storio_slice_number,1024,8,(32*1024));
   // File distribution mode upon cluster, storages and devices. Check rozofs.conf manual. 
@@ -328,12 +409,17 @@ static inline void common_config_generated_read(char * fname) {
   COMMON_CONFIG_READ_INT_MINMAX(storio_dscp,46,0,46);
   // DSCP for exchanges from/to the EXPORTD. 
   COMMON_CONFIG_READ_INT_MINMAX(export_dscp,34,0,34);
+  // Whether the STORIO disk threads, the STORCLI Mojette threads and the  
+  // rozofsmount fuse reply threads exchange with their main thread through  
+  // shared memory rings instead of AF_UNIX sockets. 
+  COMMON_CONFIG_READ_BOOL(thread_ring,False);
   /*
   ** export scope configuration elements
   */
   // Max number of file that the exportd can remove from storages in a run. 
+  // The files are removed by batches sent to every storage in parallel. 
   // A new run occurs every 2 seconds. 
-  COMMON_CONFIG_READ_INT_MINMAX(trashed_file_per_run,7,0,5000);
+  COMMON_CONFIG_READ_INT_MINMAX(trashed_file_per_run,7,0,100000);
   // High trash water mark when FID recycling is activated. 
   // When the trash has already this number of files, files are no more 
   // deleted but recycled. 
@@ -343,6 +429,10 @@ static inline void common_config_generated_read(char * fname) {
   COMMON_CONFIG_READ_INT_MINMAX(export_buf_cnt,128,32,1024);
   // To activate export writebehind attributes thread. 
   COMMON_CONFIG_READ_BOOL(export_attr_thread,True);
+  // Number of metadata shard threads of an exportd slave. The getattr requests 
+  // are processed by the thread of the shard of their FID, while the other  
+  // requests stay in the main thread. 0 keeps every request in the main thread. 
+  COMMON_CONFIG_READ_INT_MINMAX(export_shard_threads,0,0,16);
   // Support of deleted directory/file versioning. 
   COMMON_CONFIG_READ_BOOL(export_versioning,False);
   // Number of MB to account a file for during file distribution phase 
@@ -370,6 +460,22 @@ static inline void common_config_generated_read(char * fname) {
   */
   // Whether STORCLI acknowleges write request on inverse or forward STORIO responses. 
   COMMON_CONFIG_READ_BOOL(wr_ack_on_inverse,False);
+  // Whether STORCLI acknowleges write request once inverse+1 projections are 
+  // written, and completes the other projections in the background. 
+  COMMON_CONFIG_READ_BOOL(wr_ack_early,False);
+  // Whether STORCLI reads the projections preferentially on the storages  
+  // that answer the fastest and have the least pending reads. 
+  COMMON_CONFIG_READ_BOOL(storcli_latency_select,False);
+  // Percentile of the projection read response times after which STORCLI  
+  // reads a spare projection when some projections are still missing. 
+  // 0 keeps the fixed spare read delay. 
+  COMMON_CONFIG_READ_INT_MINMAX(storcli_hedge_percentile,0,0,99);
+  // Maximum number of lookup and getattr requests rozofsmount packs in one 
+  // EP_BATCH request to the exportd. 0 or 1 sends every request alone. 
+  COMMON_CONFIG_READ_INT_MINMAX(client_batch_max,0,0,16);
+  // Number of directory entries rozofsmount keeps from the EP_READDIRPLUS 
+  // responses to answer the lookups that follow a readdir. 0 disables readdirplus. 
+  COMMON_CONFIG_READ_INT_MINMAX(client_readdirplus_cache,0,0,1048576);
   // To activate rozofsmount reply fuse threads. 
   COMMON_CONFIG_READ_BOOL(rozofsmount_fuse_reply_thread,False);
   // To activate fast reconnect from client to exportd 
@@ -391,6 +497,21 @@ static inline void common_config_generated_read(char * fname) {
   */
   // Number of disk threads in the STORIO. 
   COMMON_CONFIG_READ_INT_MINMAX(nb_disk_thread,4,2,64);
+  // Whether STORIO disk threads use io_uring to keep several chunk  
+  // reads and writes in flight instead of one blocking request per thread. 
+  COMMON_CONFIG_READ_BOOL(storio_io_uring,False);
+  // Number of requests each STORIO disk thread keeps in flight  
+  // when io_uring is used. 
+  COMMON_CONFIG_READ_INT_MINMAX(storio_io_uring_depth,64,8,1024);
+  // Whether STORIO queues the read and write requests per device,  
+  // ordering them by offset and merging the contiguous ones. 
+  COMMON_CONFIG_READ_BOOL(storio_scheduler,False);
+  // Maximum number of disk accesses in flight per device  
+  // when the STORIO scheduler is enabled. 
+  COMMON_CONFIG_READ_INT_MINMAX(storio_scheduler_depth,4,1,64);
+  // Delay in micro seconds after which a request queued by the STORIO  
+  // scheduler is served whatever its offset. 
+  COMMON_CONFIG_READ_INT_MINMAX(storio_scheduler_window,2000,0,1000000);
   // Whether STORIO is in multiple (1 STORIO per cluster)  
   // or single mode (only 1 STORIO). 
   COMMON_CONFIG_READ_BOOL(storio_multiple_mode,True);
@@ -446,6 +567,17 @@ static inline void common_config_generated_read(char * fname) {
   // spareOnly  only self repair on a spare disk 
   // relocate   also repair on remaining disks when no spare available 
   COMMON_CONFIG_READ_STRING(device_selfhealing_mode,"spareOnly");
+  // Number of FIDs a rebuild process rebuilds in parallel, each one  
+  // on its own thread with its own connections to the storios. 
+  COMMON_CONFIG_READ_INT_MINMAX(rebuild_fid_parallel,1,1,64);
+  // Number of decoded block ranges a rebuild thread may queue for being  
+  // written on the rebuilt storio while it reads the next ones. 
+  // 0 means the projections are written synchronously. 
+  COMMON_CONFIG_READ_INT_MINMAX(rebuild_write_queue,0,0,64);
+  // Maximum size in MB of the journal of the chunks written on spare 
+  // storages while a nominal storage is unreachable. There is one journal 
+  // per nominal storage. 0 disables the journal. 
+  COMMON_CONFIG_READ_INT_MINMAX(storio_dirty_journal,0,0,4096);
   // Export host names or IP addresses separated with /  
   // Required for selfhealing. 
   // Required for spare file restoring to its nominal location. 
@@ -457,6 +589,12 @@ static inline void common_config_generated_read(char * fname) {
   // Spare file restoring : throughput limitation for reading and analyzing spare files in MB/s 
   // 0 means no limit 
   COMMON_CONFIG_READ_INT(spare_restore_read_throughput,5);
+  // Spare file restoring : number of spare files restored in parallel. 
+  // The most recently written spare files are restored first. 
+  COMMON_CONFIG_READ_INT_MINMAX(spare_restore_parallel,4,1,64);
+  // Spare file restoring : maximum number of restorations running in parallel 
+  // toward the same storage 
+  COMMON_CONFIG_READ_INT_MINMAX(spare_restore_per_storage,2,1,64);
  
   config_destroy(&cfg);
 }
@@ -30,6 +30,274 @@ typedef struct hash_entry {
     list_t list;
 } hash_entry_t;
 
+/*
+**________________________________________________________________
+**  O P E N   A D D R E S S I N G   T A B L E
+**________________________________________________________________
+*/
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define HTABLE_OA_GROUP     16    /**< slots whose control bytes are probed together */
+#define HTABLE_OA_EMPTY     0x80  /**< control byte of a free slot */
+#define HTABLE_OA_DELETED   0xFE  /**< control byte of a removed entry */
+#define HTABLE_OA_MIGRATE   8     /**< groups moved to the new array on each update */
+
+typedef struct htable_oa_slot {
+    void *key;
+    void *value;
+} htable_oa_slot_t;
+
+typedef struct htable_oa_table {
+    uint32_t          mask;     /**< number of groups - 1 */
+    uint32_t          count;    /**< number of entries */
+    uint32_t          deleted;  /**< number of removed entries slots */
+    uint8_t          *ctrl;     /**< control bytes: hash bits, empty or deleted */
+    htable_oa_slot_t *slots;
+} htable_oa_table_t;
+
+typedef struct htable_oa_shard {
+    htable_oa_table_t cur;      /**< array receiving the new entries */
+    htable_oa_table_t old;      /**< array being moved (ctrl is NULL when none) */
+    uint32_t          next;     /**< next group of old to move */
+} htable_oa_shard_t;
+
+/*
+** The hash functions of the callers do not spread the low bits enough
+** for a power of 2 table
+*/
+static inline uint32_t htable_oa_mix(uint32_t hash) {
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+/*
+** Bit mask of the slots of a group whose control byte is <byte>
+*/
+static inline uint32_t htable_oa_match(uint8_t *ctrl, uint8_t byte) {
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128((__m128i *) ctrl);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char) byte)));
+#else
+    uint32_t mask = 0;
+    int i;
+    for (i = 0; i < HTABLE_OA_GROUP; i++)
+        if (ctrl[i] == byte) mask |= (1 << i);
+    return mask;
+#endif
+}
+
+/*
+** Bit mask of the slots of a group that are empty or deleted
+*/
+static inline uint32_t htable_oa_match_free(uint8_t *ctrl) {
+#ifdef __SSE2__
+    return _mm_movemask_epi8(_mm_loadu_si128((__m128i *) ctrl));
+#else
+    uint32_t mask = 0;
+    int i;
+    for (i = 0; i < HTABLE_OA_GROUP; i++)
+        if (ctrl[i] & 0x80) mask |= (1 << i);
+    return mask;
+#endif
+}
+
+static void htable_oa_table_alloc(htable_oa_table_t * t, uint32_t nb_groups) {
+    t->mask = nb_groups - 1;
+    t->count = 0;
+    t->deleted = 0;
+    t->ctrl = xmalloc(nb_groups * HTABLE_OA_GROUP);
+    memset(t->ctrl, HTABLE_OA_EMPTY, nb_groups * HTABLE_OA_GROUP);
+    t->slots = xmalloc(nb_groups * HTABLE_OA_GROUP * sizeof (htable_oa_slot_t));
+}
+
+static void htable_oa_table_free(htable_oa_table_t * t) {
+    if (t->ctrl) xfree(t->ctrl);
+    if (t->slots) xfree(t->slots);
+    t->ctrl = NULL;
+    t->slots = NULL;
+}
+
+/*
+** Index of the slot of a key, -1 when not found.
+** The groups are probed in triangular order, which visits every group
+** of a power of 2 table. A group with an empty slot ends the probe.
+*/
+static inline int htable_oa_find(htable_t * h, htable_oa_table_t * t, void *key, uint32_t mix) {
+    uint32_t group = mix & t->mask;
+    uint32_t step = 0;
+    uint32_t match;
+    uint8_t *ctrl;
+    int idx;
+
+    while (1) {
+        ctrl = t->ctrl + group * HTABLE_OA_GROUP;
+        match = htable_oa_match(ctrl, mix >> 25);
+        while (match) {
+            idx = group * HTABLE_OA_GROUP + __builtin_ctz(match);
+            if (h->cmp(t->slots[idx].key, key) == 0) return idx;
+            match &= match - 1;
+        }
+        if (htable_oa_match(ctrl, HTABLE_OA_EMPTY)) return -1;
+        step++;
+        group = (group + step) & t->mask;
+    }
+}
+
+/*
+** Insert a key that is not in the table
+*/
+static inline void htable_oa_insert(htable_oa_table_t * t, void *key, void *value, uint32_t mix) {
+    uint32_t group = mix & t->mask;
+    uint32_t step = 0;
+    uint32_t match;
+    int idx;
+
+    while ((match = htable_oa_match_free(t->ctrl + group * HTABLE_OA_GROUP)) == 0) {
+        step++;
+        group = (group + step) & t->mask;
+    }
+    idx = group * HTABLE_OA_GROUP + __builtin_ctz(match);
+    if (t->ctrl[idx] == HTABLE_OA_DELETED) t->deleted--;
+    t->ctrl[idx] = mix >> 25;
+    t->slots[idx].key = key;
+    t->slots[idx].value = value;
+    t->count++;
+}
+
+/*
+** Remove the entry of a slot. The slot can be freed when its group
+** has an empty slot, since no probe went through this group.
+*/
+static inline void htable_oa_remove(htable_oa_table_t * t, int idx) {
+    uint8_t *ctrl = t->ctrl + (idx & ~(HTABLE_OA_GROUP - 1));
+
+    if (htable_oa_match(ctrl, HTABLE_OA_EMPTY)) {
+        t->ctrl[idx] = HTABLE_OA_EMPTY;
+    } else {
+        t->ctrl[idx] = HTABLE_OA_DELETED;
+        t->deleted++;
+    }
+    t->count--;
+}
+
+/*
+** Move some groups of the old array in the current one
+*/
+static void htable_oa_migrate(htable_t * h, htable_oa_shard_t * s, uint32_t nb_groups) {
+    uint32_t idx;
+    int i;
+
+    while ((s->old.ctrl != NULL) && (nb_groups-- > 0)) {
+        idx = s->next * HTABLE_OA_GROUP;
+        for (i = 0; i < HTABLE_OA_GROUP; i++, idx++) {
+            if (s->old.ctrl[idx] & 0x80) continue;
+            htable_oa_insert(&s->cur, s->old.slots[idx].key, s->old.slots[idx].value,
+                    htable_oa_mix(h->hash(s->old.slots[idx].key)));
+            /*
+            ** the entry must no more be found in the old array
+            */
+            s->old.ctrl[idx] = HTABLE_OA_DELETED;
+        }
+        s->next++;
+        if (s->next > s->old.mask) htable_oa_table_free(&s->old);
+    }
+}
+
+/*
+** Keep 1/8 of the slots free so that every probe ends on an empty slot.
+** The array is doubled when at least half full, else the removed
+** entries are cleaned by moving the entries to an array of the same size.
+*/
+static inline void htable_oa_reserve(htable_t * h, htable_oa_shard_t * s) {
+    uint32_t nb_groups;
+
+    if ((s->cur.count + s->cur.deleted) < (s->cur.mask + 1) * (HTABLE_OA_GROUP - 2)) return;
+
+    htable_oa_migrate(h, s, s->old.mask + 1);
+    nb_groups = s->cur.mask + 1;
+    if (s->cur.count >= nb_groups * HTABLE_OA_GROUP / 2) nb_groups *= 2;
+    s->old = s->cur;
+    s->next = 0;
+    htable_oa_table_alloc(&s->cur, nb_groups);
+}
+
+static inline htable_oa_shard_t *htable_oa_shard(htable_t * h, uint32_t hash) {
+    return h->oa + ((h->lock_size > 1) ? (hash % h->lock_size) : 0);
+}
+
+static void *htable_oa_get(htable_t * h, void *key, uint32_t hash) {
+    htable_oa_shard_t *s = htable_oa_shard(h, hash);
+    uint32_t mix = htable_oa_mix(hash);
+    void *value = NULL;
+    int idx;
+
+    if (h->oa_locked) pthread_rwlock_rdlock(&h->lock[s - h->oa]);
+    if ((idx = htable_oa_find(h, &s->cur, key, mix)) >= 0) {
+        value = s->cur.slots[idx].value;
+    } else if ((s->old.ctrl != NULL) && ((idx = htable_oa_find(h, &s->old, key, mix)) >= 0)) {
+        value = s->old.slots[idx].value;
+    }
+    if (h->oa_locked) pthread_rwlock_unlock(&h->lock[s - h->oa]);
+    return value;
+}
+
+static void htable_oa_put(htable_t * h, void *key, void *value, uint32_t hash) {
+    htable_oa_shard_t *s = htable_oa_shard(h, hash);
+    uint32_t mix = htable_oa_mix(hash);
+    int idx;
+
+    if (h->oa_locked) pthread_rwlock_wrlock(&h->lock[s - h->oa]);
+    // If entry exits replace value.
+    if ((idx = htable_oa_find(h, &s->cur, key, mix)) >= 0) {
+        s->cur.slots[idx].value = value;
+    } else if ((s->old.ctrl != NULL) && ((idx = htable_oa_find(h, &s->old, key, mix)) >= 0)) {
+        s->old.slots[idx].value = value;
+    } else {
+        htable_oa_reserve(h, s);
+        htable_oa_insert(&s->cur, key, value, mix);
+    }
+    htable_oa_migrate(h, s, HTABLE_OA_MIGRATE);
+    if (h->oa_locked) pthread_rwlock_unlock(&h->lock[s - h->oa]);
+}
+
+static void *htable_oa_del(htable_t * h, void *key, uint32_t hash) {
+    htable_oa_shard_t *s = htable_oa_shard(h, hash);
+    uint32_t mix = htable_oa_mix(hash);
+    void *value = NULL;
+    int idx;
+
+    if (h->oa_locked) pthread_rwlock_wrlock(&h->lock[s - h->oa]);
+    if ((idx = htable_oa_find(h, &s->cur, key, mix)) >= 0) {
+        value = s->cur.slots[idx].value;
+        htable_oa_remove(&s->cur, idx);
+    } else if ((s->old.ctrl != NULL) && ((idx = htable_oa_find(h, &s->old, key, mix)) >= 0)) {
+        value = s->old.slots[idx].value;
+        htable_oa_remove(&s->old, idx);
+    }
+    htable_oa_migrate(h, s, HTABLE_OA_MIGRATE);
+    if (h->oa_locked) pthread_rwlock_unlock(&h->lock[s - h->oa]);
+    return value;
+}
+
+static void htable_oa_release(htable_t * h) {
+    uint32_t i;
+
+    for (i = 0; i < h->lock_size; i++) {
+        htable_oa_table_free(&h->oa[i].cur);
+        htable_oa_table_free(&h->oa[i].old);
+        if (h->oa_locked) pthread_rwlock_destroy(&h->lock[i]);
+    }
+    xfree(h->oa);
+    h->oa = NULL;
+}
+
+
 inline void htable_initialize(htable_t * h, uint32_t size, uint32_t(*hash) (void *),
                        int (*cmp) (void *, void *)) {
     list_t *it;
@@ -39,6 +307,8 @@ inline void htable_initialize(htable_t * h, uint32_t size, uint32_t(*hash) (void
     h->cmp = cmp;
     h->size = size;
     h->lock_size = ROZOFS_HTABLE_MAX_LOCK;
+    h->oa = NULL;
+    h->oa_locked = 0;
     h->buckets = xmalloc(size * sizeof (list_t));
     for (it = h->buckets; it != h->buckets + size; it++)
         list_init(it);
@@ -49,6 +319,13 @@ inline void htable_release(htable_t * h) {
     list_t *it;
     DEBUG_FUNCTION;
 
+    if (h->oa != NULL) {
+        htable_oa_release(h);
+        h->hash = 0;
+        h->cmp = 0;
+        h->size = 0;
+        return;
+    }
     for (it = h->buckets; it != h->buckets + h->size; it++) {
         list_t *p, *q;
         list_for_each_forward_safe(p, q, it) {
@@ -72,6 +349,10 @@ inline void htable_put(htable_t * h, void *key, void *value) {
 
     DEBUG_FUNCTION;
 
+    if (h->oa != NULL) {
+        htable_oa_put(h, key, value, h->hash(key));
+        return;
+    }
     bucket = h->buckets + (h->hash(key) % h->size);
     // If entry exits replace value.
     list_for_each_forward(p, bucket) {
@@ -95,6 +376,8 @@ inline void *htable_get(htable_t * h, void *key) {
     list_t *p;
     DEBUG_FUNCTION;
 
+    if (h->oa != NULL) return htable_oa_get(h, key, h->hash(key));
+
     list_for_each_forward(p, h->buckets + (h->hash(key) % h->size)) {
         hash_entry_t *he = list_entry(p, hash_entry_t, list);
         if (h->cmp(he->key, key) == 0) {
@@ -110,6 +393,8 @@ inline void *htable_del(htable_t * h, void *key) {
     list_t *p, *q;
     DEBUG_FUNCTION;
 
+    if (h->oa != NULL) return htable_oa_del(h, key, h->hash(key));
+
     list_for_each_forward_safe(p, q, h->buckets + (h->hash(key) % h->size)) {
         hash_entry_t *he = list_entry(p, hash_entry_t, list);
         if (h->cmp(he->key, key) == 0) {
@@ -147,6 +432,8 @@ int htable_initialize_th(htable_t * h, uint32_t size,uint32_t lock_size, uint32_
     h->hash = hash;
     h->cmp = cmp;
     h->size = size;
+    h->oa = NULL;
+    h->oa_locked = 0;
     h->buckets = xmalloc(size * sizeof (list_t));
     for (it = h->buckets; it != h->buckets + size; it++)
         list_init(it);
@@ -175,6 +462,8 @@ int htable_initialize_th(htable_t * h, uint32_t size,uint32_t lock_size, uint32_
 void *htable_get_th(htable_t * h, void *key,uint32_t hash) {
     list_t *p;
     DEBUG_FUNCTION;
+
+    if (h->oa != NULL) return htable_oa_get(h, key, hash);
     /*
     ** take the read lock because of LRU handling
     */
@@ -208,6 +497,8 @@ void *htable_del_th(htable_t * h, void *key,uint32_t hash) {
     list_t *p, *q;
     DEBUG_FUNCTION;
 
+    if (h->oa != NULL) return htable_oa_del(h, key, hash);
+
     pthread_rwlock_wrlock(&h->lock[hash%h->lock_size]);
 
     list_for_each_forward_safe(p, q, h->buckets + (hash % h->size)) {
@@ -241,6 +532,10 @@ void htable_put_th(htable_t * h, void *key, void *value,uint32_t hash) {
 
     DEBUG_FUNCTION;
 
+    if (h->oa != NULL) {
+        htable_oa_put(h, key, value, hash);
+        return;
+    }
     bucket = h->buckets + (hash % h->size);
     // If entry exits replace value.
     
@@ -268,3 +563,47 @@ void htable_put_th(htable_t * h, void *key, void *value,uint32_t hash) {
     pthread_rwlock_unlock(&h->lock[hash%h->lock_size]);
 
 }
+/*
+**________________________________________________________________
+*/
+/**
+*  Init of an open addressing hash table
+
+   @param h: pointer to the hash table context
+   @param size : expected number of entries
+   @param lock_size: number of shards and locks (0 for no lock)
+   @param hash : pointer to the hash function
+   @param cmp : compare to the match function
+   
+   @retval 0 on success
+   @retval < 0 error (see errno for details)
+*/
+int htable_initialize_oa(htable_t * h, uint32_t size,uint32_t lock_size, uint32_t(*hash) (void *),
+                       int (*cmp) (void *, void *)) {
+    uint32_t nb_groups;
+    int i;
+    DEBUG_FUNCTION;
+
+    memset(h, 0, sizeof (htable_t));
+    h->hash = hash;
+    h->cmp = cmp;
+    h->size = size;
+    h->oa_locked = (lock_size != 0);
+    h->lock_size = (lock_size > ROZOFS_HTABLE_MAX_LOCK)?ROZOFS_HTABLE_MAX_LOCK:lock_size;
+    if (h->lock_size == 0) h->lock_size = 1;
+    /*
+    ** Size every shard for its part of the expected entries
+    */
+    nb_groups = 1;
+    while (nb_groups * (HTABLE_OA_GROUP - 2) < size / h->lock_size) nb_groups <<= 1;
+
+    h->oa = xmalloc(h->lock_size * sizeof (htable_oa_shard_t));
+    memset(h->oa, 0, h->lock_size * sizeof (htable_oa_shard_t));
+    for (i = 0; i < h->lock_size; i++) {
+        htable_oa_table_alloc(&h->oa[i].cur, nb_groups);
+        if (h->oa_locked) {
+            if (pthread_rwlock_init(&h->lock[i], NULL) != 0) return -1;
+        }
+    }
+    return 0;
+}
@@ -24,6 +24,9 @@
 #include "list.h"
 
 #define ROZOFS_HTABLE_MAX_LOCK 16
+
+struct htable_oa_shard;
+
 typedef struct htable {
     uint32_t(*hash) (void *);
     int (*cmp) (void *, void *);
@@ -31,6 +34,8 @@ typedef struct htable {
     uint32_t lock_size;
     pthread_rwlock_t lock[ROZOFS_HTABLE_MAX_LOCK]; /**< lock used for insertion/LRU handling */
     list_t *buckets;
+    struct htable_oa_shard *oa;    /**< shards of the open addressing table (NULL when chained) */
+    uint32_t oa_locked;            /**< every open addressing access takes the shard lock */
 } htable_t;
 
 void htable_initialize(htable_t * h, uint32_t size, uint32_t(*hash) (void *),
@@ -101,4 +106,33 @@ void *htable_del_th(htable_t * h, void *key,uint32_t hash);
   
 */
 void htable_put_th(htable_t * h, void *key, void *value,uint32_t hash);
+/*
+**________________________________________________________________
+*/
+/**
+*  Init of an open addressing hash table
+
+   The entries are stored in arrays of key/value slots with one
+   control byte per slot holding 7 bits of the hash. The control bytes
+   are probed 16 at a time, so a lookup usually reads one cache line
+   of control bytes and the slot of the matching entry, and an insertion
+   allocates nothing. The table grows by moving a few slots to the
+   new array on each insertion or removal.
+   The table is split in lock_size shards, each one protected by one of
+   the locks of the table. With a lock_size of 0 the table is not locked
+   and must only be used by one thread.
+   The table is then used through the htable_put/get/del services and
+   their _th variants.
+
+   @param h: pointer to the hash table context
+   @param size : expected number of entries
+   @param lock_size: number of shards and locks (0 for no lock)
+   @param hash : pointer to the hash function
+   @param cmp : compare to the match function
+   
+   @retval 0 on success
+   @retval < 0 error (see errno for details)
+*/
+int htable_initialize_oa(htable_t * h, uint32_t size,uint32_t lock_size, uint32_t(*hash) (void *),
+                       int (*cmp) (void *, void *));
 #endif
@@ -18,20 +18,36 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <string.h>
 #include <math.h>
 #include <rozofs/rozofs.h>
 #include <cpuid.h> /* __get_cpuid_max, __get_cpuid */
 #include <mmintrin.h> /* MMX instrinsics  __m64 integer type  */
 #include <xmmintrin.h> /* SSE  __m128  float */
+#include <immintrin.h> /* AVX2 __m256i, AVX-512 __m512i */
 #include "transform.h"
 #include <rozofs/common/log.h>
+#include <rozofs/common/xmalloc.h>
+#include <rozofs/rozofs_srv.h>
 
 
 #define BIN_UPDATE ((k + k_offsets[l])/* * updated->angle.q */+ l * updated->angle.p - offsets[i])
 #define BIN_SET ((k + k_offsets[l])/* * p->angle.q */+ l * p->angle.p - offsets[l])
 #define SUP_IDX (l * cols + k + k_offsets[l])
 
+/*
+** Size of the local buffer used by transform128_inverse_copy: it must hold the
+** projections of the largest block size
+*/
+#define TRANSFORM128_COPY_BUF_SZ (ROZOFS_BSIZE_BYTES(ROZOFS_BSIZE_MAX)+ROZOFS_SAFE_MAX_STORCLI*1024)
+/*
+** Size of the buffer used by the batched inverse. It is too big for the
+** stack of the threads, so each thread allocates it on its first batch.
+*/
+#define TRANSFORM128_BATCH_BUF_SZ (2*TRANSFORM128_COPY_BUF_SZ)
+static __thread char * transform128_batch_buf = NULL;
+
 /*
 **____________________________________________________________________________
 */
@@ -68,6 +84,167 @@ __m128 work0;
 /*
 **____________________________________________________________________________
 */
+/**
+*  XOR a run of n consecutive 128 bits pixels into n consecutive 128 bits bins
+
+   Each engine provides its own version: pixels and bins are contiguous in
+   the forward transform, so the run can be processed with the widest
+   registers available on the CPU.
+*/
+static inline void xor128_run_generic(bin_t *bin, pxl_t *pix, int n)
+{
+  while (n > 0) {
+    bin[0] ^= pix[0];
+    bin[1] ^= pix[1];
+    bin += 2;
+    pix += 2;
+    n--;
+  }
+}
+
+static inline void xor128_run_sse(bin_t *bin, pxl_t *pix, int n)
+{
+  for (; n >= 8; n -= 8) {
+    xor128_1_ptr(&bin[0],&pix[2*0]);
+    xor128_1_ptr(&bin[2],&pix[2*1]);
+    xor128_1_ptr(&bin[4],&pix[2*2]);
+    xor128_1_ptr(&bin[6],&pix[2*3]);
+    xor128_1_ptr(&bin[8],&pix[2*4]);
+    xor128_1_ptr(&bin[10],&pix[2*5]);
+    xor128_1_ptr(&bin[12],&pix[2*6]);
+    xor128_1_ptr(&bin[14],&pix[2*7]);
+    bin += 8*2;
+    pix += 8*2;
+  }
+  for (; n > 0; n--) {
+    xor128_1_ptr(&bin[0],&pix[0]);
+    bin += 2;
+    pix += 2;
+  }
+}
+
+__attribute__((target("avx2")))
+static inline void xor128_run_avx2(bin_t *bin, pxl_t *pix, int n)
+{
+  __m256i b0,b1,p0,p1;
+
+  for (; n >= 4; n -= 4) {
+    b0 = _mm256_loadu_si256((const __m256i *)(bin));
+    b1 = _mm256_loadu_si256((const __m256i *)(bin+4));
+    p0 = _mm256_loadu_si256((const __m256i *)(pix));
+    p1 = _mm256_loadu_si256((const __m256i *)(pix+4));
+    _mm256_storeu_si256((__m256i *)(bin),   _mm256_xor_si256(b0,p0));
+    _mm256_storeu_si256((__m256i *)(bin+4), _mm256_xor_si256(b1,p1));
+    bin += 4*2;
+    pix += 4*2;
+  }
+  if (n >= 2) {
+    b0 = _mm256_loadu_si256((const __m256i *)(bin));
+    p0 = _mm256_loadu_si256((const __m256i *)(pix));
+    _mm256_storeu_si256((__m256i *)(bin), _mm256_xor_si256(b0,p0));
+    bin += 2*2;
+    pix += 2*2;
+    n   -= 2;
+  }
+  if (n) {
+    __m128i w0 = _mm_loadu_si128((const __m128i *)(bin));
+    __m128i w1 = _mm_loadu_si128((const __m128i *)(pix));
+    _mm_storeu_si128((__m128i *)(bin), _mm_xor_si128(w0,w1));
+  }
+}
+
+__attribute__((target("avx512f")))
+static inline void xor128_run_avx512(bin_t *bin, pxl_t *pix, int n)
+{
+  __m512i b0,b1,p0,p1;
+
+  for (; n >= 8; n -= 8) {
+    b0 = _mm512_loadu_si512((const void *)(bin));
+    b1 = _mm512_loadu_si512((const void *)(bin+8));
+    p0 = _mm512_loadu_si512((const void *)(pix));
+    p1 = _mm512_loadu_si512((const void *)(pix+8));
+    _mm512_storeu_si512((void *)(bin),   _mm512_xor_si512(b0,p0));
+    _mm512_storeu_si512((void *)(bin+8), _mm512_xor_si512(b1,p1));
+    bin += 8*2;
+    pix += 8*2;
+  }
+  if (n >= 4) {
+    b0 = _mm512_loadu_si512((const void *)(bin));
+    p0 = _mm512_loadu_si512((const void *)(pix));
+    _mm512_storeu_si512((void *)(bin), _mm512_xor_si512(b0,p0));
+    bin += 4*2;
+    pix += 4*2;
+    n   -= 4;
+  }
+  if (n) {
+    /*
+    ** 1 to 3 remaining pixels: use a masked 512 bits access (2 lanes of 64 bits per pixel)
+    */
+    __mmask8 mask = (__mmask8)((1 << (2*n)) - 1);
+    b0 = _mm512_maskz_loadu_epi64(mask,(const void *)(bin));
+    p0 = _mm512_maskz_loadu_epi64(mask,(const void *)(pix));
+    _mm512_mask_storeu_epi64((void *)(bin),mask,_mm512_xor_si512(b0,p0));
+  }
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+*  One step of the inverse: the pixel found in the bin of projection l is
+   written in the support and then removed from the bins of all the other
+   projections.
+   
+   Pixels of the reconstruction path are serially dependent (the bin of the
+   next column is only complete once the current pixel has been removed), so
+   the inverse always works on one 128 bits pixel at a time whatever the engine.
+*/
+static inline void inverse128_step_generic(pxl_t *pix, bin_t *src, projection_t *projections,
+                                           int rows, int l, int idx, int *offsets)
+{
+  int i;
+  uint64_t v0 = src[0];
+  uint64_t v1 = src[1];
+  
+  pix[0] = v0;
+  pix[1] = v1;
+  for (i = 0; i < rows; i++) {
+    if (i==l) continue;
+    projection_t *updated = projections + i;
+    bin_t *dst = &updated->bins[2*(idx + l * updated->angle.p - offsets[i])];
+    dst[0] ^= v0;
+    dst[1] ^= v1;
+  }
+}
+
+static inline void inverse128_step_sse(pxl_t *pix, bin_t *src, projection_t *projections,
+                                       int rows, int l, int idx, int *offsets)
+{
+  int i;
+  __m128 bin = write128_1_ret(pix,src);
+  for (i = 0; i < rows; i++) {
+    if (i==l) continue;
+    projection_t *updated = projections + i;
+    xor128_1(&updated->bins[2*(idx + l * updated->angle.p - offsets[i])],bin);
+  }
+}
+
+__attribute__((target("avx2")))
+static inline void inverse128_step_vex(pxl_t *pix, bin_t *src, projection_t *projections,
+                                       int rows, int l, int idx, int *offsets)
+{
+  int i;
+  __m128i bin = _mm_loadu_si128((const __m128i *)(src));
+  _mm_storeu_si128((__m128i *)(pix), bin);
+  for (i = 0; i < rows; i++) {
+    if (i==l) continue;
+    projection_t *updated = projections + i;
+    __m128i *dst = (__m128i *)&updated->bins[2*(idx + l * updated->angle.p - offsets[i])];
+    _mm_storeu_si128(dst, _mm_xor_si128(_mm_loadu_si128(dst),bin));
+  }
+}
+/*
+**____________________________________________________________________________
+*/
 static inline int compare_slope(const void *e1, const void *e2) {
     projection_t *p1 = (projection_t *) e1;
     projection_t *p2 = (projection_t *) e2;
@@ -84,26 +261,18 @@ static inline int max(int a, int b) {
 **____________________________________________________________________________
 */
 /**
-* Perform a Mojette transform inverse in 128 bits mode to decode a buffer
-
-  @param support: pointer to the decoded buffer
+*  Sort the projections and compute the bins offsets and the initial column
+   offsets of the reconstruction path
+   
   @param rows: number of rows
-  @param cols: number of colunms in the buffer
   @param np: number of projections involved in the inverse procedure
   @param projections: pointer to the projections contexts
-  
+  @param offsets: array where the bins offsets are returned
+  @param k_offsets: array where the column offsets are returned
 */
-void transform128_inverse (pxl_t * support, int rows, int cols, int np,
-        projection_t * projections) {
-    int s_minus, s_plus, s, i, rdv, k, l;
-    //double tmp;
-    int *k_offsets, *offsets;
-    int transform_buf_offset[1024];
-    int transform_buf_k_offsets[1024];    
-    k_offsets = transform_buf_k_offsets;
-    offsets = transform_buf_offset;
-
-    cols = (cols)/2;
+static inline void transform128_inverse_prepare(int rows, int np, projection_t * projections,
+                                                int *offsets, int *k_offsets) {
+    int s_minus, s_plus, i, rdv;
     
     qsort((void *) projections, np, sizeof (projection_t), compare_slope_inline);
     for (i = 0; i < np; i++) {
@@ -112,13 +281,12 @@ void transform128_inverse (pxl_t * support, int rows, int cols, int np,
                 0 ? (rows - 1) * projections[i].angle.p : 0;
     }
 
-    // compute s_minus, s_plus, and finally s
-    s_minus = s_plus = s = 0;
+    // compute s_minus, s_plus
+    s_minus = s_plus = 0;
     for (i = 1; i < rows - 1; i++) {
         s_minus += max_inline(0, -projections[i].angle.p);
         s_plus += max_inline(0, projections[i].angle.p);
     }
-    s = s_minus - s_plus;
 
     // compute the rendez-vous row rdv
     rdv = rows - 1;
@@ -133,18 +301,45 @@ void transform128_inverse (pxl_t * support, int rows, int cols, int np,
     for (i = rdv - 1; i >= 0; i--) {
         k_offsets[i] = k_offsets[i + 1] + projections[i + 1].angle.p;
     }
-
+}
+/*
+**____________________________________________________________________________
+*/
+typedef void (*inverse128_step_f)(pxl_t *pix, bin_t *src, projection_t *projections,
+                                  int rows, int l, int idx, int *offsets);
+/**
+*  Reconstruction path of the inverse. It is instantiated once per engine with
+   the step function of that engine.
+   
+   Several blocks rebuilt from the same projection set can be decoded in the
+   same pass: each step of the reconstruction path is applied to every block
+   of the batch before moving to the next one, so the loop control and the
+   offsets are shared by the blocks and their bins stay hot in the cache.
+
+  @param supports: pointer to the decoded buffer of each block
+  @param nb: number of blocks in the batch
+  @param rows: number of rows
+  @param cols: number of 128 bits colunms in the buffer
+  @param prj: sorted projections contexts of each block
+  @param offsets: bins offsets of each projection
+  @param k_offsets: initial column offsets of each projection
+  @param step: engine specific reconstruction step
+*/
+static inline __attribute__((always_inline)) 
+void transform128_inverse_body(pxl_t ** supports, int nb, int rows, int cols,
+                               projection_t (*prj)[ROZOFS_SAFE_MAX_STORCLI], int *offsets, int *k_offsets,
+                               inverse128_step_f step) {
+    int k, l, b;
+    int rdv = rows - 1;
+    
     // Reconstruct
     // While all projections aren't needed (avoid if statement in general case)
     for (k = -max_inline(k_offsets[0], k_offsets[rows - 1]); k < 0; k++) {
         for (l = 0; l <= rdv; l++) {
             if (k + k_offsets[l] >= 0) {
-                projection_t *p = projections + l;
-                __m128 bin = write128_1_ret(&support[2*SUP_IDX],&projections[l].bins[2*BIN_SET]);
-                for (i = 0; i < rows; i++) {
-		    if (i==l) continue;
-                    projection_t *updated = projections + i;
-                    xor128_1(&updated->bins[2*BIN_UPDATE],bin);
+                projection_t *p = prj[0] + l;
+                for (b = 0; b < nb; b++) {
+                    step(&supports[b][2*SUP_IDX],&prj[b][l].bins[2*BIN_SET],prj[b],rows,l,k + k_offsets[l],offsets);
                 }
             }
         }
@@ -152,12 +347,9 @@ void transform128_inverse (pxl_t * support, int rows, int cols, int np,
     // scan the reconstruction path while every projections are used
     for (k = 0; k < cols - max_inline(k_offsets[0], k_offsets[rows - 1]); k++) {
         for (l = 0; l <= rdv; l++) {
-            projection_t *p = projections + l;
-            __m128 bin = write128_1_ret(&support[2*SUP_IDX],&projections[l].bins[2*BIN_SET]);
-            for (i = 0; i < rows; i++) {
-		if (i==l) continue;
-                projection_t *updated = projections + i;
-                xor128_1(&updated->bins[2*BIN_UPDATE],bin);
+            projection_t *p = prj[0] + l;
+            for (b = 0; b < nb; b++) {
+                step(&supports[b][2*SUP_IDX],&prj[b][l].bins[2*BIN_SET],prj[b],rows,l,k + k_offsets[l],offsets);
             }
         }
     }
@@ -165,36 +357,243 @@ void transform128_inverse (pxl_t * support, int rows, int cols, int np,
     for (k = cols - max_inline(k_offsets[0], k_offsets[rows - 1]); k < cols; k++) {
         for (l = 0; l <= rdv; l++) {
             if (k + k_offsets[l] < cols) {
-                projection_t *p = projections + l;
-                __m128 bin = write128_1_ret(&support[2*SUP_IDX],&projections[l].bins[2*BIN_SET]);
-                for (i = 0; i < rows; i++) {
-		    if (i==l) continue;
-                    projection_t *updated = projections + i;
-                    xor128_1(&updated->bins[2*BIN_UPDATE],bin);
+                projection_t *p = prj[0] + l;
+                for (b = 0; b < nb; b++) {
+                    step(&supports[b][2*SUP_IDX],&prj[b][l].bins[2*BIN_SET],prj[b],rows,l,k + k_offsets[l],offsets);
                 }
             }
         }
     }
 }
+/*
+**____________________________________________________________________________
+*/
+typedef void (*xor128_run_f)(bin_t *bin, pxl_t *pix, int n);
+/**
+*  Forward transform of one projection. It is instantiated once per engine with
+   the XOR run function of that engine.
+   
+    @param support: pointer to the buffer to encode
+    @param rows: numbers of rows in which the buffer is divided
+    @param cols: numbers of 128 bits colunms
+    @param p: projection context
+    @param offset: bins offset of the projection
+    @param xor_run: engine specific XOR function
+*/
+static inline __attribute__((always_inline)) 
+void transform128_forward_body(pxl_t * support, int rows, int cols,
+                               projection_t * p, int offset,
+                               xor128_run_f xor_run) {
+    int l;
+    int last_pbin_idx = p->size*2;
+    int row_size = cols*2;
+    
+    memset(p->bins, 0, (p->size) * 2*sizeof (bin_t));
+
+    for (l = 0; l < rows; l++) {
+        int support_idx = 2*(l * p->angle.p - offset);
+        int loop = (last_pbin_idx - support_idx)/2;
+        if (loop > cols) loop=cols;
+        if (loop <= 0) continue;
+        xor_run(p->bins + support_idx,support + l*row_size, loop);
+    }
+}
+/*
+**____________________________________________________________________________
+*/
+/*
+** Engine instantiations
+*/
+#define TRANSFORM128_INSTANTIATE(engine,target_attr,xor_run,step) \
+target_attr \
+static void transform128_forward_one_proj_##engine(bin_t * support, int rows, int cols,\
+        uint8_t proj_id, projection_t * projections) {\
+    int offset = projections[proj_id].angle.p < 0 ? (rows - 1) * projections[proj_id].angle.p : 0;\
+    transform128_forward_body(support,rows,cols/2,projections+proj_id,offset,xor_run);\
+}\
+target_attr \
+static void transform128_forward_##engine(bin_t * support, int rows, int cols, int np,\
+        projection_t * projections) {\
+    int i;\
+    for (i = 0; i < np; i++) {\
+      int offset = projections[i].angle.p < 0 ? (rows - 1) * projections[i].angle.p : 0;\
+      transform128_forward_body(support,rows,cols/2,projections+i,offset,xor_run);\
+    }\
+}\
+target_attr \
+static void transform128_inverse_prepared_##engine(pxl_t * support, int rows, int cols,\
+        projection_t * projections, int *offsets, int *k_offsets) {\
+    transform128_inverse_body(&support,1,rows,cols,(projection_t (*)[ROZOFS_SAFE_MAX_STORCLI])projections,offsets,k_offsets,step);\
+}\
+target_attr \
+static void transform128_inverse_batch_##engine(pxl_t ** supports, int nb, int rows, int cols,\
+        projection_t (*prj)[ROZOFS_SAFE_MAX_STORCLI], int *offsets, int *k_offsets) {\
+    transform128_inverse_body(supports,nb,rows,cols,prj,offsets,k_offsets,step);\
+}
+
+TRANSFORM128_INSTANTIATE(generic,,xor128_run_generic,inverse128_step_generic)
+TRANSFORM128_INSTANTIATE(sse,,xor128_run_sse,inverse128_step_sse)
+TRANSFORM128_INSTANTIATE(avx2,__attribute__((target("avx2"))),xor128_run_avx2,inverse128_step_vex)
+TRANSFORM128_INSTANTIATE(avx512,__attribute__((target("avx2,avx512f"))),xor128_run_avx512,inverse128_step_vex)
+
+/*
+**____________________________________________________________________________
+*/
+/*
+** Engine table
+*/
+typedef struct _transform128_engine_ops_t {
+  char * name;
+  void (*forward)(bin_t * support, int rows, int cols, int np, projection_t * projections);
+  void (*forward_one_proj)(bin_t * support, int rows, int cols, uint8_t proj_id, projection_t * projections);
+  void (*inverse_prepared)(pxl_t * support, int rows, int cols, projection_t * projections, int *offsets, int *k_offsets);
+  void (*inverse_batch)(pxl_t ** supports, int nb, int rows, int cols, projection_t (*prj)[ROZOFS_SAFE_MAX_STORCLI], int *offsets, int *k_offsets);
+} transform128_engine_ops_t;
+
+static transform128_engine_ops_t transform128_engine_ops[TRANSFORM128_ENGINE_MAX] = {
+  {"generic", transform128_forward_generic, transform128_forward_one_proj_generic, transform128_inverse_prepared_generic, transform128_inverse_batch_generic},
+  {"sse",     transform128_forward_sse,     transform128_forward_one_proj_sse,     transform128_inverse_prepared_sse, transform128_inverse_batch_sse},
+  {"avx2",    transform128_forward_avx2,    transform128_forward_one_proj_avx2,    transform128_inverse_prepared_avx2, transform128_inverse_batch_avx2},
+  {"avx512",  transform128_forward_avx512,  transform128_forward_one_proj_avx512,  transform128_inverse_prepared_avx512, transform128_inverse_batch_avx512},
+};
+
+static transform128_engine_ops_t * transform128_ops = NULL;
+static transform128_engine_e       transform128_engine = TRANSFORM128_ENGINE_GENERIC;
+/*
+**____________________________________________________________________________
+*/
+/**
+*  Get the name of an engine
+
+  @param engine: the engine
+  
+  @retval the engine name
+*/
+char * transform128_engine2String(transform128_engine_e engine) {
+  if (engine >= TRANSFORM128_ENGINE_MAX) return "?";
+  return transform128_engine_ops[engine].name;
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+*  Check whether the CPU supports an engine
+
+  @param engine: the engine to check
+  
+  @retval 1 when supported, 0 else
+*/
+int transform128_engine_supported(transform128_engine_e engine) {
+
+  __builtin_cpu_init();
+  
+  switch(engine) {
+    case TRANSFORM128_ENGINE_GENERIC: return 1;
+    case TRANSFORM128_ENGINE_SSE:     return __builtin_cpu_supports("sse2")?1:0;
+    case TRANSFORM128_ENGINE_AVX2:    return __builtin_cpu_supports("avx2")?1:0;
+    case TRANSFORM128_ENGINE_AVX512:  return (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("avx512f"))?1:0;
+    default: return 0;
+  }
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+*  Force the engine used by the 128 bits Mojette transform
+
+  @param engine: the engine to use
+  
+  @retval 0 on success, -1 when the CPU does not support that engine
+*/
+int transform128_engine_set(transform128_engine_e engine) {
+
+  if (!transform128_engine_supported(engine)) {
+    errno = ENOTSUP;
+    return -1;
+  }
+  transform128_engine = engine;
+  transform128_ops    = &transform128_engine_ops[engine];
+  return 0;
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+*  Select the widest engine supported by the CPU (CPUID based)
+
+  @retval the selected engine
+*/
+transform128_engine_e transform128_engine_init() {
+  int engine;
+  
+  for (engine = TRANSFORM128_ENGINE_MAX-1; engine > TRANSFORM128_ENGINE_GENERIC; engine--) {
+    if (transform128_engine_supported(engine)) break;
+  }
+  transform128_engine_set(engine);
+  return transform128_engine;
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+*  Get the engine currently used by the 128 bits Mojette transform
+
+  @retval the current engine
+*/
+transform128_engine_e transform128_engine_get() {
+  if (transform128_ops == NULL) transform128_engine_init();
+  return transform128_engine;
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+* Perform a Mojette transform inverse in 128 bits mode to decode a buffer
+
+  @param support: pointer to the decoded buffer
+  @param rows: number of rows
+  @param cols: number of colunms in the buffer
+  @param np: number of projections involved in the inverse procedure
+  @param projections: pointer to the projections contexts
+  
+*/
+void transform128_inverse (pxl_t * support, int rows, int cols, int np,
+        projection_t * projections) {
+    int offsets[ROZOFS_SAFE_MAX_STORCLI];
+    int k_offsets[ROZOFS_SAFE_MAX_STORCLI];
+
+    if (transform128_ops == NULL) transform128_engine_init();
+    transform128_inverse_prepare(rows,np,projections,offsets,k_offsets);
+    transform128_ops->inverse_prepared(support,rows,cols/2,projections,offsets,k_offsets);
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+* Perform a Mojette transform inverse in 128 bits mode to decode a buffer.
+  The projections are first copied in a local buffer to avoid corruption of 
+  the next projection in sequence.
 
+  @param support: pointer to the decoded buffer
+  @param rows: number of rows
+  @param cols: number of colunms in the buffer
+  @param np: number of projections involved in the inverse procedure
+  @param projections: pointer to the projections contexts
+  @param max_prj_sz_intf: max projections size in bytes (without header&footer)
+  
+*/
 void transform128_inverse_copy (pxl_t * support, int rows, int cols, int np,
         projection_t * projections,int max_prj_sz_intf) {
-    int s_minus, s_plus, s, i, rdv, k, l;
-    //double tmp;
-    int *k_offsets, *offsets;
-    int transform_buf_offset[1024];
-    int transform_buf_k_offsets[1024];    
-    k_offsets = transform_buf_k_offsets;
-    offsets = transform_buf_offset;
-        
-    char buff_all_bins[1024*18];
-    int bufsz = 0;
+    int i;
+    char buff_all_bins[TRANSFORM128_COPY_BUF_SZ];
     int max_prj_sz;
+    char *buff_all_bins_p;
     
     max_prj_sz = max_prj_sz_intf+512/*+256*/;
-    char *buff_all_bins_p;
-
-    cols = (cols)/2;
+    if ((np*max_prj_sz + 64) > TRANSFORM128_COPY_BUF_SZ) {
+      severe("projections too big for the inverse buffer %d*%d",np,max_prj_sz);
+      return;
+    }
     
     buff_all_bins_p = buff_all_bins;
     buff_all_bins_p +=64;
@@ -211,86 +610,9 @@ void transform128_inverse_copy (pxl_t * support, int rows, int cols, int np,
         memcpy(dst,src,projections[i].size*16);
 	projections[i].bins = (bin_t *)buff_all_bins_p;
 	buff_all_bins_p += max_prj_sz;
-	bufsz += max_prj_sz;
-
     }    
-    /*
-    ** sort the projection in the increasing order of angle p
-    */ 
-    qsort((void *) projections, np, sizeof (projection_t), compare_slope_inline);
-    for (i = 0; i < np; i++) {
-        offsets[i] =
-                projections[i].angle.p <
-                0 ? (rows - 1) * projections[i].angle.p : 0;
-
-    }
-    
-    // compute s_minus, s_plus, and finally s
-    s_minus = s_plus = s = 0;
-    for (i = 1; i < rows - 1; i++) {
-        s_minus += max_inline(0, -projections[i].angle.p);
-        s_plus += max_inline(0, projections[i].angle.p);
-    }
-    s = s_minus - s_plus;
-
-    // compute the rendez-vous row rdv
-    rdv = rows - 1;
-
-    // Determine the initial image column offset for each projection
-    k_offsets[rdv] =
-            max_inline(max_inline(0, -projections[rdv].angle.p) + s_minus,
-            max_inline(0, projections[rdv].angle.p) + s_plus);
-    for (i = rdv + 1; i < rows; i++) {
-        k_offsets[i] = k_offsets[i - 1] + projections[i - 1].angle.p;
-    }
-    for (i = rdv - 1; i >= 0; i--) {
-        k_offsets[i] = k_offsets[i + 1] + projections[i + 1].angle.p;
-    }
-
-    // Reconstruct
-    // While all projections aren't needed (avoid if statement in general case)
-    for (k = -max_inline(k_offsets[0], k_offsets[rows - 1]); k < 0; k++) {
-        for (l = 0; l <= rdv; l++) {
-            if (k + k_offsets[l] >= 0) {
-                projection_t *p = projections + l;
-                __m128 bin = write128_1_ret(&support[2*SUP_IDX],&projections[l].bins[2*BIN_SET]);
-                for (i = 0; i < rows; i++) {
-		    if (i==l) continue;
-                    projection_t *updated = projections + i;
-                    xor128_1(&updated->bins[2*BIN_UPDATE],bin);
-                }
-            }
-        }
-    }
-    // scan the reconstruction path while every projections are used
-    for (k = 0; k < cols - max_inline(k_offsets[0], k_offsets[rows - 1]); k++) {
-        for (l = 0; l <= rdv; l++) {
-            projection_t *p = projections + l;
-            __m128 bin = write128_1_ret(&support[2*SUP_IDX],&projections[l].bins[2*BIN_SET]);
-            for (i = 0; i < rows; i++) {
-		if (i==l) continue;
-                projection_t *updated = projections + i;
-                xor128_1(&updated->bins[2*BIN_UPDATE],bin);
-            }
-        }
-    }
-    // finish the work
-    for (k = cols - max_inline(k_offsets[0], k_offsets[rows - 1]); k < cols; k++) {
-        for (l = 0; l <= rdv; l++) {
-            if (k + k_offsets[l] < cols) {
-                projection_t *p = projections + l;
-                __m128 bin = write128_1_ret(&support[2*SUP_IDX],&projections[l].bins[2*BIN_SET]);
-                for (i = 0; i < rows; i++) {
-		    if (i==l) continue;
-                    projection_t *updated = projections + i;
-                    xor128_1(&updated->bins[2*BIN_UPDATE],bin);
-                }
-            }
-        }
-    }
+    transform128_inverse(support,rows,cols,np,projections);
 }
-
-
 /*
 **____________________________________________________________________________
 */
@@ -306,108 +628,275 @@ void transform128_inverse_copy (pxl_t * support, int rows, int cols, int np,
 */
 void transform128_forward(bin_t * support, int rows, int cols, int np,
         projection_t * projections) {
-    int *offsets;
-    int i, l, k;
-    int transform_buf_offset[1024];
+    if (transform128_ops == NULL) transform128_engine_init();
+    transform128_ops->forward(support,rows,cols,np,projections);
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+*   perform a Mojette forward transform on 128 bits for one projection only
     
-    cols = (cols)/2;
+    @param support: pointer to the buffer to encode
+    @param rows: numbers of rows in which the buffer is divided
+    @param cols: numbers of colunms
+    @param proj_id: index of the projection to generate
+    @param projections: projection contexts
+*/
+void transform128_forward_one_proj(bin_t * support, int rows, int cols,
+        uint8_t proj_id, projection_t * projections) {
+    if (transform128_ops == NULL) transform128_engine_init();
+    transform128_ops->forward_one_proj(support,rows,cols,proj_id,projections);
+}
 
-    offsets = transform_buf_offset;
-    for (i = 0; i < np; i++) {
-        offsets[i] =
-                projections[i].angle.p <
-                0 ? (rows - 1) * projections[i].angle.p : 0;
-	/*
-	** always add 3 extra bins to avoid issue related to the usage 128 bits bins
-	*/
-        memset(projections[i].bins, 0, (projections[i].size) * 2*sizeof (bin_t));
-    }
-    for (i = 0; i < np; i++) {
-        projection_t *p = projections + i;
-        pxl_t *ppix = support;
-        pxl_t *ppix_ref = support;
-        int row_size = cols*2;
-        int support_idx = 0;
-        bin_t *pbin; // = p->bins - offsets[i];
-	int last_pbin_idx = p->size*2;
-
-        for (l = 0; l < rows; l++) {
-            pbin = p->bins + 2*(l * p->angle.p - offsets[i]);
-            support_idx = 2*(l * p->angle.p - offsets[i]);
-	    int loop = last_pbin_idx - support_idx;
-            loop = loop/2;
-	    if (loop > cols) loop=cols;
-            for (k = loop / 8; k > 0; k--) {
-                xor128_1_ptr(&pbin[0],&ppix[2*0]);
-                xor128_1_ptr(&pbin[2],&ppix[2*1]);
-                xor128_1_ptr(&pbin[4],&ppix[2*2]);
-                xor128_1_ptr(&pbin[6],&ppix[2*3]);
-                xor128_1_ptr(&pbin[8],&ppix[2*4]);
-                xor128_1_ptr(&pbin[10],&ppix[2*5]);
-                xor128_1_ptr(&pbin[12],&ppix[2*6]);
-                xor128_1_ptr(&pbin[14],&ppix[2*7]);
-//		support_idx +=8*2;
-                pbin += 8*2;
-                ppix += 8*2;
-            }
-            for (k = loop % 8; k > 0; k--) {
-                xor128_1_ptr(&pbin[0],&ppix[2*0]);
-//		support_idx +=1*2;
-                pbin += 1*2;
-                ppix += 1*2;
-            }
-	    ppix = ppix_ref+(l+1)*row_size;
-        }
-    }            
+
+/*
+**____________________________________________________________________________
+**
+**   Precompiled inverse programs
+**
+** For a given layout and block size, the sort of the projections and the
+** offsets of the reconstruction path only depend on the set of projection
+** ids used for the rebuild. They are computed once for every possible set
+** at start up, and the inverse of a block is then a lookup in a table
+** indexed by the bitmap of the received projection ids.
+**____________________________________________________________________________
+*/
+static trans_lk_table_t * transform128_inverse_prog_table[LAYOUT_MAX][ROZOFS_BSIZE_NB];
+/*
+**____________________________________________________________________________
+*/
+/**
+*  Build the inverse program of a set of projections
+
+  @param layout: layout of the file
+  @param bsize: block size enumeration
+  @param key: bitmap of the projection ids of the set
+  
+  @retval the inverse program
+*/
+static transform128_inverse_prog_t * transform128_inverse_prog_build(uint8_t layout, uint32_t bsize, int key) {
+  transform128_inverse_prog_t * prog;
+  projection_t projections[ROZOFS_SAFE_MAX_STORCLI];
+  int ids[ROZOFS_SAFE_MAX_STORCLI];
+  uint8_t rozofs_inverse = rozofs_get_rozofs_inverse(layout);
+  uint8_t rozofs_forward = rozofs_get_rozofs_forward(layout);
+  int prj_id;
+  int np = 0;
+  int slot;
+  
+  prog = xmalloc(sizeof(transform128_inverse_prog_t));
+  memset(prog,0,sizeof(transform128_inverse_prog_t));
+  prog->rows = rozofs_inverse;
+  prog->cols = ROZOFS_BSIZE_BYTES(bsize) / rozofs_inverse / (2*sizeof (pxl_t));
+  
+  for (prj_id = 0; prj_id < rozofs_forward; prj_id++) {
+    if ((key & (1<<prj_id)) == 0) continue;
+    projections[np].angle.p = rozofs_get_angles_p(layout,prj_id);
+    projections[np].angle.q = rozofs_get_angles_q(layout,prj_id);
+    projections[np].size    = rozofs_get_128bits_psizes(layout,bsize,prj_id);
+    /*
+    ** the bins pointer is only used to find back the projection id after the sort
+    */
+    ids[np] = prj_id;
+    projections[np].bins = (bin_t*) &ids[np];
+    np++;
+  }
+  transform128_inverse_prepare(prog->rows,np,projections,prog->offsets,prog->k_offsets);
+
+  for (slot = 0; slot < np; slot++) {
+    prj_id = *(int*)projections[slot].bins;
+    prog->slot[prj_id]  = slot;
+    prog->p[slot]       = projections[slot].angle.p;
+    prog->q[slot]       = projections[slot].angle.q;
+    prog->size[slot]    = projections[slot].size;
+  }
+  return prog;
 }
+/*
+**____________________________________________________________________________
+*/
+/**
+*  Build the inverse programs of every projection set for every layout and
+   block size. rozofs_layout_initialize() must have been called before.
+*/
+void transform128_inverse_prog_init() {
+  uint8_t  layout;
+  uint32_t bsize;
+  int      key;
+  int      nb_prog = 0;
+  
+  if (transform128_ops == NULL) transform128_engine_init();
 
-void transform128_forward_one_proj(bin_t * support, int rows, int cols,
-        uint8_t proj_id, projection_t * projections) {
-    int offset;
-    int l, k;
-    cols = (cols)/2;
+  for (layout = 0; layout < LAYOUT_MAX; layout++) {
+  
+    uint8_t rozofs_inverse = rozofs_get_rozofs_inverse(layout);
+    uint8_t rozofs_forward = rozofs_get_rozofs_forward(layout);
+    int     min = (1<<rozofs_inverse)-1;
+    int     max = min << (rozofs_forward-rozofs_inverse);
+    
+    for (bsize = ROZOFS_BSIZE_MIN; bsize <= ROZOFS_BSIZE_MAX; bsize++) {
+    
+      trans_lk_table_t * table;
+
+      if (transform128_inverse_prog_table[layout][bsize] != NULL) continue;
+      
+      table = xmalloc(sizeof(trans_lk_table_t)+(max-min+1)*sizeof(void*));
+      memset(table,0,sizeof(trans_lk_table_t)+(max-min+1)*sizeof(void*));
+      table->min = min;
+      table->max = max;
+
+      for (key = min; key <= max; key++) {
+        if (__builtin_popcount(key) != rozofs_inverse) continue;
+        table->data[key-min] = transform128_inverse_prog_build(layout,bsize,key);
+        nb_prog++;
+      }
+      transform128_inverse_prog_table[layout][bsize] = table;
+    }
+  }
+  DEBUG("%d Mojette inverse programs built",nb_prog);
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+*  Get the inverse program of a set of projections
 
-    offset = projections[proj_id].angle.p < 0 ? (rows - 1) *
-            projections[proj_id].angle.p : 0;
-     
-     memset(projections[proj_id].bins, 0, (projections[proj_id].size) * 2*sizeof (bin_t));
+  @param layout: layout of the file
+  @param bsize: block size enumeration
+  @param key: bitmap of the projection ids of the set
+  
+  @retval the inverse program or NULL when the set does not permit the rebuild
+*/
+transform128_inverse_prog_t * transform128_inverse_prog_get(uint8_t layout, uint32_t bsize, int key) {
+  trans_lk_table_t * table;
+  
+  if ((layout >= LAYOUT_MAX) || (bsize > ROZOFS_BSIZE_MAX)) return NULL;
+  
+  table = transform128_inverse_prog_table[layout][bsize];
+  if (table == NULL) return NULL;
+  if ((key < table->min) || (key > table->max)) return NULL;
+  return (transform128_inverse_prog_t *) table->data[key-table->min];
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+* Perform a Mojette transform inverse in 128 bits mode with a precompiled 
+  program. The projections are copied in a local buffer before the rebuild.
 
+  @param prog: the inverse program of the projection set
+  @param support: pointer to the decoded buffer
+  @param projections: pointer to the projections (bins and projection id) in any order
+  @param max_prj_sz_intf: max projections size in bytes (without header&footer)
+  
+  @retval 0 on success, -1 when the projections are too big for the buffer
+*/
+int transform128_inverse_prog_run(transform128_inverse_prog_t * prog, pxl_t * support,
+                                   projection_opt_t * projections, int max_prj_sz_intf) {
+    projection_t prj[ROZOFS_SAFE_MAX_STORCLI];
+    char buff_all_bins[TRANSFORM128_COPY_BUF_SZ];
+    char *buff_all_bins_p;
+    int max_prj_sz;
+    int i;
+    
+    max_prj_sz = max_prj_sz_intf+512;
+    if ((prog->rows*max_prj_sz + 64) > TRANSFORM128_COPY_BUF_SZ) {
+      severe("projections too big for the inverse buffer %d*%d",prog->rows,max_prj_sz);
+      errno = EFBIG;
+      return -1;
+    }
+    buff_all_bins_p = buff_all_bins;
+    buff_all_bins_p +=64;
+    uint64_t aligned128 = (uint64_t)(buff_all_bins_p);
+    aligned128 = ((aligned128>>5)<<5);
+    buff_all_bins_p = (char*)aligned128;
+    
+    for (i = 0; i < prog->rows; i++) {
+      int slot = prog->slot[projections[i].projection_id];
+      prj[slot].angle.p = prog->p[slot];
+      prj[slot].angle.q = prog->q[slot];
+      prj[slot].size    = prog->size[slot];
+      memcpy(buff_all_bins_p,projections[i].bins,prog->size[slot]*16);
+      prj[slot].bins = (bin_t *)buff_all_bins_p;
+      buff_all_bins_p += max_prj_sz;
+    }
+    if (transform128_ops == NULL) transform128_engine_init();
+    transform128_ops->inverse_prepared(support,prog->rows,prog->cols,prj,prog->offsets,prog->k_offsets);
+    return 0;
+}
 
-    projection_t *p = projections + proj_id;
-    pxl_t *ppix = support;
-    int support_idx = 0;
-    pxl_t *ppix_ref = support;
-    int row_size = cols*2;
-    bin_t *pbin; // = p->bins - offset;
-    int last_pbin_idx = p->size*2;
 
-    for (l = 0; l < rows; l++) {
-        pbin = p->bins + 2*(l * p->angle.p - offset);
-        support_idx = 2*(l * p->angle.p - offset);
-	int loop = last_pbin_idx - support_idx;
-        loop = loop/2;
-	if (loop > cols) loop=cols;
-        for (k = loop / 8; k > 0; k--) {
-            xor128_1_ptr(&pbin[0],&ppix[2*0]);
-            xor128_1_ptr(&pbin[2],&ppix[2*1]);
-            xor128_1_ptr(&pbin[4],&ppix[2*2]);
-            xor128_1_ptr(&pbin[6],&ppix[2*3]);
-            xor128_1_ptr(&pbin[8],&ppix[2*4]);
-            xor128_1_ptr(&pbin[10],&ppix[2*5]);
-            xor128_1_ptr(&pbin[12],&ppix[2*6]);
-            xor128_1_ptr(&pbin[14],&ppix[2*7]);
-//		support_idx +=8*2;
-            pbin += 8*2;
-            ppix += 8*2;
-        }
-        for (k = loop % 8; k > 0; k--) {
-            xor128_1_ptr(&pbin[0],&ppix[2*0]);
-//		support_idx +=1*2;
-            pbin += 1*2;
-            ppix += 1*2;
+/*
+**____________________________________________________________________________
+*/
+/**
+* Perform a Mojette transform inverse in 128 bits mode on a batch of blocks
+  rebuilt from the same projection set, with a precompiled program. The blocks
+  are decoded together by passes of at most TRANSFORM128_INVERSE_BATCH_MAX blocks.
+
+  @param prog: the inverse program of the projection set
+  @param supports: pointer to the decoded buffer of each block
+  @param projections: projections (bins and projection id) of each block in any order
+  @param nb: number of blocks
+  @param max_prj_sz_intf: max projections size in bytes (without header&footer)
+  
+  @retval number of passes, -1 when the projections are too big for the buffer
+*/
+int transform128_inverse_prog_run_batch(transform128_inverse_prog_t * prog, pxl_t ** supports,
+                                        projection_opt_t (*projections)[ROZOFS_SAFE_MAX_STORCLI], 
+                                        int nb, int max_prj_sz_intf) {
+    projection_t prj[TRANSFORM128_INVERSE_BATCH_MAX][ROZOFS_SAFE_MAX_STORCLI];
+    char *buff_all_bins_p;
+    int max_prj_sz;
+    int per_pass;
+    int done = 0;
+    int passes = 0;
+    int count;
+    int i,b;
+    
+    if (transform128_ops == NULL) transform128_engine_init();
+
+    max_prj_sz = max_prj_sz_intf+512;
+    per_pass = (TRANSFORM128_BATCH_BUF_SZ-64) / (prog->rows*max_prj_sz);
+    if (per_pass > TRANSFORM128_INVERSE_BATCH_MAX) per_pass = TRANSFORM128_INVERSE_BATCH_MAX;
+    if (per_pass == 0) {
+      severe("projections too big for the inverse buffer %d*%d",prog->rows,max_prj_sz);
+      errno = EFBIG;
+      return -1;
+    }
+    if (transform128_batch_buf == NULL) {
+      transform128_batch_buf = xmalloc(TRANSFORM128_BATCH_BUF_SZ);
+    }
+    
+    while (done < nb) {
+    
+      count = nb - done;
+      if (count > per_pass) count = per_pass;
+      
+      buff_all_bins_p = transform128_batch_buf;
+      buff_all_bins_p +=64;
+      uint64_t aligned128 = (uint64_t)(buff_all_bins_p);
+      aligned128 = ((aligned128>>5)<<5);
+      buff_all_bins_p = (char*)aligned128;
+      
+      for (b = 0; b < count; b++) {
+        projection_opt_t * opt = projections[done+b];
+        for (i = 0; i < prog->rows; i++) {
+          int slot = prog->slot[opt[i].projection_id];
+          prj[b][slot].angle.p = prog->p[slot];
+          prj[b][slot].angle.q = prog->q[slot];
+          prj[b][slot].size    = prog->size[slot];
+          memcpy(buff_all_bins_p,opt[i].bins,prog->size[slot]*16);
+          prj[b][slot].bins = (bin_t *)buff_all_bins_p;
+          buff_all_bins_p += max_prj_sz;
         }
-	ppix = ppix_ref+(l+1)*row_size;
+      }
+      transform128_ops->inverse_batch(&supports[done],count,prog->rows,prog->cols,prj,prog->offsets,prog->k_offsets);
+      done += count;
+      passes++;
     }
+    return passes;
 }
 
 
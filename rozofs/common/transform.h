@@ -198,6 +198,57 @@ static inline void transform_inverse_inline(pxl_t * support, int rows, int cols,
 #endif
 }
 
+/*
+**____________________________________________________________________________
+*/
+/*
+** Engines of the 128 bits Mojette transform. The widest one supported by
+** the CPU is selected at the first call (CPUID).
+*/
+typedef enum _transform128_engine_e {
+  TRANSFORM128_ENGINE_GENERIC = 0, /**< plain C on 64 bits words */
+  TRANSFORM128_ENGINE_SSE,         /**< 128 bits SSE2            */
+  TRANSFORM128_ENGINE_AVX2,        /**< 256 bits AVX2            */
+  TRANSFORM128_ENGINE_AVX512,      /**< 512 bits AVX-512F        */
+  TRANSFORM128_ENGINE_MAX
+} transform128_engine_e;
+
+/**
+*  Select the widest engine supported by the CPU
+
+  @retval the selected engine
+*/
+transform128_engine_e transform128_engine_init();
+/**
+*  Get the engine currently in use
+
+  @retval the current engine
+*/
+transform128_engine_e transform128_engine_get();
+/**
+*  Force the engine to use
+
+  @param engine: the engine to use
+  
+  @retval 0 on success, -1 when the CPU does not support that engine
+*/
+int transform128_engine_set(transform128_engine_e engine);
+/**
+*  Check whether the CPU supports an engine
+
+  @param engine: the engine to check
+  
+  @retval 1 when supported, 0 else
+*/
+int transform128_engine_supported(transform128_engine_e engine);
+/**
+*  Get the name of an engine
+
+  @param engine: the engine
+  
+  @retval the engine name
+*/
+char * transform128_engine2String(transform128_engine_e engine);
 /*
 **____________________________________________________________________________
 */
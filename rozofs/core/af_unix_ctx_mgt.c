@@ -187,6 +187,7 @@ void af_inet_tcp_short_debug_show_man(char * pt) {
   pt += sprintf(pt," - Max segment size (sender and receiver)\n"); 
   pt += sprintf(pt," - Round trip time\n"); 
   pt += sprintf(pt," - Receive and send queue size of the socket\n"); 
+  pt += sprintf(pt," - Messages per send and per receive system call\n"); 
 }
 
 void af_tcp_display_address(char *pChar, af_unix_ctx_generic_t *sock_p,int src)
@@ -230,8 +231,8 @@ void af_inet_tcp_short_debug_show(uint32_t tcpRef, void *bufRef) {
     struct tcp_info * p;
     af_unix_ctx_generic_t *sock_p;
     ruc_obj_desc_t *pnext;
-    buffer += sprintf(buffer, "  State      | Avail.|  sock  |   rto   | snd_mss | rcv_mss |   rtt   |  Recv-Q |  Send-Q |      IP:port source    |   IP:port destination  |  SNDBUF |  RCVBUF |\n");
-    buffer += sprintf(buffer, "-------------+-------+--------+---------+---------+---------+---------+---------+---------+------------------------+------------------------+---------+---------+\n");
+    buffer += sprintf(buffer, "  State      | Avail.|  sock  |   rto   | snd_mss | rcv_mss |   rtt   |  Recv-Q |  Send-Q |      IP:port source    |   IP:port destination  |  SNDBUF |  RCVBUF | msg/snd | msg/rcv |\n");
+    buffer += sprintf(buffer, "-------------+-------+--------+---------+---------+---------+---------+---------+---------+------------------------+------------------------+---------+---------+---------+---------+\n");
 
     pnext = (ruc_obj_desc_t*) NULL;
     while ((sock_p = (af_unix_ctx_generic_t*) ruc_objGetNext((ruc_obj_desc_t*) & af_unix_context_activeListHead,
@@ -274,8 +275,15 @@ void af_inet_tcp_short_debug_show(uint32_t tcpRef, void *bufRef) {
 	    }
 	    buffer += sprintf(buffer, " %7d |",sendsize);
 	    buffer += sprintf(buffer, " %7d |",rcvsize);
-	    buffer += sprintf(buffer, "\n");	
-       }
+	}
+	/*
+	** messages per send and receive system call
+	*/
+	buffer += sprintf(buffer, " %7.2f |",(sock_p->stats.totalXmitSyscall==0)?0.0:
+	                  (double)sock_p->stats.totalXmitSuccess/sock_p->stats.totalXmitSyscall);
+	buffer += sprintf(buffer, " %7.2f |",(sock_p->stats.totalRecvSyscall==0)?0.0:
+	                  (double)sock_p->stats.totalRecvSuccess/sock_p->stats.totalRecvSyscall);
+	buffer += sprintf(buffer, "\n");	
 
     }
     uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
@@ -379,6 +387,8 @@ void af_unix_debug_show_one(char *pChar, af_unix_ctx_generic_t *sock_p) {
   pChar += sprintf(pChar, "    totalXmitSuccess   : %16llu\n", (unsigned long long int) stats_p->totalXmitSuccess);
   pChar += sprintf(pChar, "    totalXmitCongested : %16llu\n", (unsigned long long int) stats_p->totalXmitCongested);
   pChar += sprintf(pChar, "    totalXmitError     : %16llu\n", (unsigned long long int) stats_p->totalXmitError);
+  pChar += sprintf(pChar, "    totalXmitSyscall   : %16llu (%.2f msg/call)\n", (unsigned long long int) stats_p->totalXmitSyscall,
+                  (stats_p->totalXmitSyscall==0)?0.0:(double)stats_p->totalXmitSuccess/stats_p->totalXmitSyscall);
 
   /*
    ** xmit side
@@ -392,6 +402,9 @@ void af_unix_debug_show_one(char *pChar, af_unix_ctx_generic_t *sock_p) {
   pChar += sprintf(pChar, "    totalRecvError     : %16llu\n", (unsigned long long int) stats_p->totalRecvError);
   pChar += sprintf(pChar, "    totalRecvPartial   : %16llu\n", (unsigned long long int) stats_p->partialRecv);
   pChar += sprintf(pChar, "    totalRecvEmpty     : %16llu\n", (unsigned long long int) stats_p->emptyRecv);
+  pChar += sprintf(pChar, "    totalRecvSyscall   : %16llu (%.2f msg/call)\n", (unsigned long long int) stats_p->totalRecvSyscall,
+                  (stats_p->totalRecvSyscall==0)?0.0:(double)stats_p->totalRecvSuccess/stats_p->totalRecvSyscall);
+  pChar += sprintf(pChar, "    recvStaged         : %16u\n", sock_p->recv.stage_len);
 }
 ruc_obj_desc_t * next_display_af_unix_ctx = NULL;
 /*__________________________________________________________________________
@@ -721,6 +734,12 @@ void af_unix_ctxInit(af_unix_ctx_generic_t *p, uint8_t creation) {
     recv_p->nb2read = 0;
     recv_p->bufRefCurrent = NULL;
     recv_p->state = RECV_IDLE;
+    /*
+     ** the staging area of the vectored receive is kept when the context is reused
+     */
+    if (creation) recv_p->stage = NULL;
+    recv_p->stage_off = 0;
+    recv_p->stage_len = 0;
     /*
      ** clear the rpc part of the stream receiver
      */
@@ -694,6 +694,11 @@ void af_unix_sock_stream_disconnect_internal(af_unix_ctx_generic_t *socket_p)
      ruc_buf_freeBuffer(recv_p->bufRefCurrent);
      recv_p->bufRefCurrent = NULL;
   }
+  /*
+  ** drop the bytes of the vectored receive that have not yet been processed
+  */
+  recv_p->stage_off = 0;
+  recv_p->stage_len = 0;
   recv_p->state = RECV_DEAD;
 }
 /*
@@ -186,6 +186,7 @@ typedef struct rozofs_socket_stats_t
    uint64_t totalXmitSuccess;   /**< total number of messages submitted with success  */
    uint64_t totalXmitCongested; /**< total number of messages submitted for with EWOULDBLOCK is returned  */
    uint64_t totalXmitError;     /**< total number of messages submitted with an error  */
+   uint64_t totalXmitSyscall;   /**< total number of send/sendmsg system calls */
 
    /*
    ** xmit side
@@ -199,12 +200,20 @@ typedef struct rozofs_socket_stats_t
    uint64_t totalRecvError;     /**< total number of messages submitted with an error  */
    uint64_t partialRecv;     /**< total of partial receive  */
    uint64_t emptyRecv;        /**< total of empty receive  */
+   uint64_t totalRecvSyscall; /**< total number of recv/recvmsg system calls */
 } rozofs_socket_stats_t;
 
 #define AF_UNIX_CONGESTION_DEFAULT_THRESHOLD 2  /**< number of loop before restarting to send after
 eoc */
 #define AF_UNIX_XMIT_CREDIT_DEFAULT 4
 #define AF_UNIX_RECV_CREDIT_DEFAULT 4
+/*
+** Vectored stream I/O (socket_vectored_io): size of the area that receives
+** the bytes read beyond the current message, and max number of queued
+** buffers sent in one sendmsg
+*/
+#define AF_UNIX_RECV_STAGE_SIZE  (32*1024)
+#define AF_UNIX_XMIT_IOV_MAX     16
 /**
 * transmitter generic Context
 */
@@ -268,6 +277,12 @@ typedef struct _com_recv_template_t
   uint32_t        bufSize;         /**< length of buffer (xmit and received)        */
   uint8_t       buffer_header[ROZOFS_MAX_HEADER_SIZE]; /**< array used for receiving the header of a message */
   /*
+  ** vectored receive
+  */
+  char         *stage;             /**< bytes read beyond the current message (AF_UNIX_RECV_STAGE_SIZE) */
+  uint32_t      stage_off;         /**< offset of the first staged byte not yet consumed */
+  uint32_t      stage_len;         /**< number of staged bytes not yet consumed */
+  /*
   **  dedicated RPC parameters
   */
   com_rpc_recv_template_t rpc;    /**< just to address the case of the rpc reception with multiple records */
@@ -813,6 +828,7 @@ void af_unix_sock_stream_disconnect_internal(af_unix_ctx_generic_t *socket_p);
 *  Socket stream receive prototypes
 */
 uint32_t af_unix_recv_stream_sock_recv(af_unix_ctx_generic_t  *sock_p, void *buf,int len, int flags,int *len_read);
+uint32_t af_unix_recv_stream_sock_recvmsg(af_unix_ctx_generic_t  *sock_p, struct iovec *iov,int iovcnt, int flags,int *len_read);
 uint32_t af_unix_recv_stream_generic_cbk(void * socket_pointer,int socketId);
 uint32_t af_unix_recv_rpc_stream_generic_cbk(void * socket_pointer,int socketId);
 
@@ -820,6 +836,7 @@ uint32_t af_unix_recv_rpc_stream_generic_cbk(void * socket_pointer,int socketId)
 *  Socket stream transmit prototypes
 */
 uint32_t af_unix_send_stream_generic(int fd,char *pMsg,int lgth,int *len_sent_p);
+uint32_t af_unix_send_stream_generic_vec(int fd,struct iovec *iov,int iovcnt,int *len_sent_p);
 void af_unix_send_stream_fsm(af_unix_ctx_generic_t *socket_p,com_xmit_template_t *xmit_p);
 
 /*
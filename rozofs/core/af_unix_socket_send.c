@@ -185,7 +185,7 @@ void af_unix_send_fsm(af_unix_ctx_generic_t *socket_p,com_xmit_template_t *xmit_
           xmit_p->eoc_flag       = 0;
           xmit_p->eoc_threshold  = AF_UNIX_CONGESTION_DEFAULT_THRESHOLD;
           xmit_p->state = XMIT_CONGESTED;
-	  FD_SET(socket_p->socketRef,&rucWrFdSetCongested);
+	  ruc_sockCtrl_set_xmit_congested(socket_p->socketRef);
           return ;
 
           case RUC_DISC:
@@ -268,7 +268,7 @@ void af_unix_send_fsm(af_unix_ctx_generic_t *socket_p,com_xmit_template_t *xmit_
           xmit_p->eoc_flag       = 0;
           xmit_p->eoc_threshold  = AF_UNIX_CONGESTION_DEFAULT_THRESHOLD;
           xmit_p->state = XMIT_CONGESTED;
-	  FD_SET(socket_p->socketRef,&rucWrFdSetCongested);
+	  ruc_sockCtrl_set_xmit_congested(socket_p->socketRef);
           return ;
 
           case RUC_DISC:
@@ -369,12 +369,12 @@ void af_unix_send_fsm(af_unix_ctx_generic_t *socket_p,com_xmit_template_t *xmit_
            xmit_p->eoc_flag  = 1;
            xmit_p->congested_flag = 0;
            xmit_p->state = XMIT_CHECK_XMITQ;
-	   FD_CLR(socket_p->socketRef,&rucWrFdSetCongested);
+	   ruc_sockCtrl_clear_xmit_congested(socket_p->socketRef);
            break;
         }
 	else
 	{
-	  FD_SET(socket_p->socketRef,&rucWrFdSetCongested);	
+	  ruc_sockCtrl_set_xmit_congested(socket_p->socketRef);	
 	}
         return;
 
@@ -31,6 +31,8 @@
 #include <sys/un.h>
 #include "af_unix_socket_generic_api.h"
 #include <rozofs/common/log.h>
+#include <rozofs/common/common_config.h>
+#include "ruc_sockCtl_api.h"
 extern uint64_t af_unix_rcv_buffered;
 
 /*__________________________________________________________________________
@@ -46,11 +48,13 @@ void            af_unix_socket_no_disconnect_log(void) {
 
 
 /**
-*  Intaernal API for reading data from an AF_UNIX sock_stream socket
+*  Intaernal API for reading data from an AF_UNIX sock_stream socket in several
+   areas. The requested length is the length of the first area, the next
+   ones receive what the socket holds beyond.
 
  @param sock_p: pointer to the socket context
- @param buf : pointer to the receive buffer
- @param len : len to read
+ @param iov : areas to fill
+ @param iovcnt : number of areas
  @param flags: flags as defined for recv() and recvfrom()
  @param len_read : pointer where the function will write the length that has been extracted from the socket
 
@@ -59,10 +63,16 @@ void            af_unix_socket_no_disconnect_log(void) {
  @retval RUC_PARTIAL: just a part of the requested data have been read
  @retval RUC_DISC: an error has been encountered while read the socket (mainly a closed on on goinging closing socket)
  */
-uint32_t af_unix_recv_stream_sock_recv(af_unix_ctx_generic_t  *sock_p, void *buf,int len, int flags,int *len_read)
+uint32_t af_unix_recv_stream_sock_recvmsg(af_unix_ctx_generic_t  *sock_p, struct iovec *iov,int iovcnt, int flags,int *len_read)
 {
    int bytesRcvd;
    int eintr_count = 0;
+   int len = iov[0].iov_len;
+   struct msghdr msg;
+
+   memset(&msg,0,sizeof(msg));
+   msg.msg_iov    = iov;
+   msg.msg_iovlen = iovcnt;
 
    while(1)
    {
@@ -70,7 +80,8 @@ uint32_t af_unix_recv_stream_sock_recv(af_unix_ctx_generic_t  *sock_p, void *buf
      ** attempt to read from the socket
      */
      af_unix_rcv_buffered+=1;
-     bytesRcvd = recv(sock_p->socketRef,buf,len,flags);
+     sock_p->stats.totalRecvSyscall++;
+     bytesRcvd = recvmsg(sock_p->socketRef,&msg,flags);
      if (bytesRcvd == 0)
      {
        /*
@@ -85,7 +96,7 @@ uint32_t af_unix_recv_stream_sock_recv(af_unix_ctx_generic_t  *sock_p, void *buf
        ** check if the all the requested data have been read
        */
        *len_read = bytesRcvd;
-       if (bytesRcvd == len) return RUC_OK;
+       if (bytesRcvd >= len) return RUC_OK;
        /*
        ** just a partial read
        */
@@ -111,7 +122,7 @@ uint32_t af_unix_recv_stream_sock_recv(af_unix_ctx_generic_t  *sock_p, void *buf
          /*
          ** here we consider it as a error
          */
-         warning("af_unix_recv_stream_sock_recv :too many EINTR %d",eintr_count);
+         warning("af_unix_recv_stream_sock_recvmsg :too many EINTR %d",eintr_count);
          sock_p->stats.totalRecvError++;
          return RUC_DISC;
 
@@ -132,7 +143,7 @@ uint32_t af_unix_recv_stream_sock_recv(af_unix_ctx_generic_t  *sock_p, void *buf
 	 ** this process.
          */
 	 if ((errno!=ECONNRESET) || (af_unix_socket_log_remote_disconnection)) {
-           warning("af_unix_recv_stream_sock_recv %s",strerror(errno));
+           warning("af_unix_recv_stream_sock_recvmsg %s",strerror(errno));
 	 }  
          sock_p->stats.totalRecvError++;
          return RUC_DISC;
@@ -140,6 +151,90 @@ uint32_t af_unix_recv_stream_sock_recv(af_unix_ctx_generic_t  *sock_p, void *buf
    }
    return RUC_DISC;
 }
+/**
+*  Intaernal API for reading data from an AF_UNIX sock_stream socket
+
+ @param sock_p: pointer to the socket context
+ @param buf : pointer to the receive buffer
+ @param len : len to read
+ @param flags: flags as defined for recv() and recvfrom()
+ @param len_read : pointer where the function will write the length that has been extracted from the socket
+
+ @retval RUC_OK: the requested length has been read
+ @retval RUC_WOULDBLOCK : the socket is empty, no data have be read
+ @retval RUC_PARTIAL: just a part of the requested data have been read
+ @retval RUC_DISC: an error has been encountered while read the socket (mainly a closed on on goinging closing socket)
+ */
+uint32_t af_unix_recv_stream_sock_recv(af_unix_ctx_generic_t  *sock_p, void *buf,int len, int flags,int *len_read)
+{
+   struct iovec iov;
+
+   iov.iov_base = buf;
+   iov.iov_len  = len;
+   return af_unix_recv_stream_sock_recvmsg(sock_p,&iov,1,flags,len_read);
+}
+/**
+*  Read data of a stream socket through the staging area of the receiver.
+   
+   The bytes that a previous read got beyond its requested length are
+   given first. When there is none and socket_vectored_io is set, the socket
+   is read in the requested area and in the staging area at once, so that
+   one system call gets the next headers and messages already sent by the
+   peer.
+
+ @param sock_p: pointer to the socket context
+ @param buf : pointer to the receive buffer
+ @param len : len to read
+ @param len_read : pointer where the function will write the length that has been read
+
+ @retval RUC_OK: the requested length has been read
+ @retval RUC_WOULDBLOCK : the socket is empty, no data have be read
+ @retval RUC_PARTIAL: just a part of the requested data have been read
+ @retval RUC_DISC: an error has been encountered while read the socket
+ */
+static inline uint32_t af_unix_recv_stream_stage_recv(af_unix_ctx_generic_t  *sock_p, void *buf,int len,int *len_read)
+{
+   com_recv_template_t     *recv_p = &sock_p->recv;
+   struct iovec             iov[2];
+   uint32_t                 status;
+   int                      count;
+
+   if (recv_p->stage_len != 0)
+   {
+     count = (len < recv_p->stage_len) ? len : recv_p->stage_len;
+     memcpy(buf,recv_p->stage+recv_p->stage_off,count);
+     recv_p->stage_off += count;
+     recv_p->stage_len -= count;
+     *len_read = count;
+     if (count == len) return RUC_OK;
+     return RUC_PARTIAL;
+   }
+
+   if (common_config.socket_vectored_io == 0)
+   {
+     return af_unix_recv_stream_sock_recv(sock_p,buf,len,0,len_read);
+   }
+   if (recv_p->stage == NULL)
+   {
+     recv_p->stage = malloc(AF_UNIX_RECV_STAGE_SIZE);
+     if (recv_p->stage == NULL) return af_unix_recv_stream_sock_recv(sock_p,buf,len,0,len_read);
+   }
+   iov[0].iov_base = buf;
+   iov[0].iov_len  = len;
+   iov[1].iov_base = recv_p->stage;
+   iov[1].iov_len  = AF_UNIX_RECV_STAGE_SIZE;
+   status = af_unix_recv_stream_sock_recvmsg(sock_p,iov,2,0,len_read);
+   if ((status == RUC_OK) && (*len_read > len))
+   {
+     /*
+     ** keep the bytes read beyond the requested length for the next reads
+     */
+     recv_p->stage_off = 0;
+     recv_p->stage_len = *len_read - len;
+     *len_read = len;
+   }
+   return status;
+}
 
 
 /**
@@ -170,7 +265,7 @@ uint32_t af_unix_recv_stream_generic_cbk(void * socket_pointer,int socketId)
   recv_p = &sock_p->recv;
   recv_credit = recv_p->recv_credit_conf;
 
-  while(recv_credit != 0)
+  while((recv_credit != 0) || (recv_p->stage_len != 0))
   {
     switch (recv_p->state)
     {
@@ -193,8 +288,8 @@ uint32_t af_unix_recv_stream_generic_cbk(void * socket_pointer,int socketId)
         ** attempt to receive the full header to figure out what kind of receive buffer
         ** Must be allocated
         */
-        status = af_unix_recv_stream_sock_recv(sock_p,recv_p->buffer_header+recv_p->nbread,
-                                               recv_p->nb2read- recv_p->nbread ,0,&len_read);
+        status = af_unix_recv_stream_stage_recv(sock_p,recv_p->buffer_header+recv_p->nbread,
+                                               recv_p->nb2read- recv_p->nbread ,&len_read);
         switch(status)
         {
           case RUC_OK:
@@ -313,6 +408,10 @@ uint32_t af_unix_recv_stream_generic_cbk(void * socket_pointer,int socketId)
           */
           sock_p->stats.totalRecvOutoFBuf++;
           recv_p->state = RECV_ALLOC_BUF;
+          /*
+          ** the bytes already read have to be processed once a buffer is released
+          */
+          if (recv_p->stage_len != 0) ruc_sockCtrl_set_rcv_pending(sock_p->socketRef);
           return TRUE;
         }
         /*
@@ -345,8 +444,8 @@ uint32_t af_unix_recv_stream_generic_cbk(void * socket_pointer,int socketId)
         ** Must be allocated
         */
         payload_p = (uint8_t*)ruc_buf_getPayload(recv_p->bufRefCurrent);
-        status = af_unix_recv_stream_sock_recv(sock_p,payload_p+recv_p->nbread,
-                                               recv_p->nb2read- recv_p->nbread ,0,&len_read);
+        status = af_unix_recv_stream_stage_recv(sock_p,payload_p+recv_p->nbread,
+                                               recv_p->nb2read- recv_p->nbread ,&len_read);
         switch(status)
         {
           case RUC_OK:
@@ -367,7 +466,7 @@ uint32_t af_unix_recv_stream_generic_cbk(void * socket_pointer,int socketId)
            recv_p->bufRefCurrent = NULL;
            (sock_p->userRcvCallBack)(sock_p->userRef,sock_p->index,bufref);
            recv_p->state = RECV_IDLE;
-           recv_credit--;
+           if (recv_credit != 0) recv_credit--;
            break;
 
           case RUC_WOULDBLOCK:
@@ -452,7 +551,7 @@ uint32_t af_unix_recv_rpc_stream_generic_cbk(void * socket_pointer,int socketId)
   recv_credit = recv_p->recv_credit_conf;
   rpc = &recv_p->rpc;
 
-  while(recv_credit != 0)
+  while((recv_credit != 0) || (recv_p->stage_len != 0))
   {
     switch (recv_p->state)
     {
@@ -480,8 +579,8 @@ uint32_t af_unix_recv_rpc_stream_generic_cbk(void * socket_pointer,int socketId)
         ** attempt to receive the full header to figure out what kind of receive buffer
         ** Must be allocated
         */
-        status = af_unix_recv_stream_sock_recv(sock_p,recv_p->buffer_header+recv_p->nbread,
-                                               recv_p->nb2read- recv_p->nbread ,0,&len_read);
+        status = af_unix_recv_stream_stage_recv(sock_p,recv_p->buffer_header+recv_p->nbread,
+                                               recv_p->nb2read- recv_p->nbread ,&len_read);
         switch(status)
         {
           case RUC_OK:
@@ -642,6 +741,10 @@ uint32_t af_unix_recv_rpc_stream_generic_cbk(void * socket_pointer,int socketId)
           */
           sock_p->stats.totalRecvOutoFBuf++;
           recv_p->state = RECV_ALLOC_BUF;
+          /*
+          ** the bytes already read have to be processed once a buffer is released
+          */
+          if (recv_p->stage_len != 0) ruc_sockCtrl_set_rcv_pending(sock_p->socketRef);
           return TRUE;
         }
         /*
@@ -677,8 +780,8 @@ uint32_t af_unix_recv_rpc_stream_generic_cbk(void * socket_pointer,int socketId)
         ** Must be allocated
         */
         payload_p = (uint8_t*)ruc_buf_getPayload(recv_p->bufRefCurrent);
-        status = af_unix_recv_stream_sock_recv(sock_p,payload_p+rpc->in_wr_offset+recv_p->nbread,
-                                               recv_p->nb2read- recv_p->nbread ,0,&len_read);
+        status = af_unix_recv_stream_stage_recv(sock_p,payload_p+rpc->in_wr_offset+recv_p->nbread,
+                                               recv_p->nb2read- recv_p->nbread ,&len_read);
         switch(status)
         {
           case RUC_OK:
@@ -712,7 +815,7 @@ uint32_t af_unix_recv_rpc_stream_generic_cbk(void * socket_pointer,int socketId)
              *record_len_p = htonl((rpc->in_tot_len) | 0x80000000);                          
              (sock_p->userRcvCallBack)(sock_p->userRef,sock_p->index,bufref);
              recv_p->state = RECV_IDLE;
-             recv_credit--;
+             if (recv_credit != 0) recv_credit--;
              break;
            }
            /*
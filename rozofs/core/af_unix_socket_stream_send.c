@@ -32,6 +32,7 @@
 #include "ruc_common.h"
 #include "af_unix_socket_generic.h"
 #include "socketCtrl.h"
+#include <rozofs/common/common_config.h>
 
 
 
@@ -55,11 +56,42 @@
 **--------------------------------------------
 */
 uint32_t af_unix_send_stream_generic(int fd,char *pMsg,int lgth,int *len_sent_p)
+{
+  struct iovec iov;
+
+  iov.iov_base = pMsg;
+  iov.iov_len  = lgth;
+  return af_unix_send_stream_generic_vec(fd,&iov,1,len_sent_p);
+}
+/**
+ Send several areas to a destination AF_UNIX socket in one system call.
+ The message is the first area, the next ones are the messages queued
+ behind it.
+
+
+  @param fd : source socket
+  @param iov: areas to send
+  @param iovcnt : number of areas
+  @param len_sent_p : contains the effective length
+
+@retval RUC_OK : the first area has been sent (and may be some of the next ones)
+@retval RUC_PARTIAL : the first area has been partially sent
+@retval RUC_WOULDBLOCK : congested (not sent)
+@retval RUC_DISC : bad destination
+**
+**--------------------------------------------
+*/
+uint32_t af_unix_send_stream_generic_vec(int fd,struct iovec *iov,int iovcnt,int *len_sent_p)
 {
   int                     ret;
+  int                     lgth = iov[0].iov_len;
+  struct msghdr           msg;
 
   *len_sent_p = 0;
-  ret=send(fd,pMsg,(int)lgth,0);
+  memset(&msg,0,sizeof(msg));
+  msg.msg_iov    = iov;
+  msg.msg_iovlen = iovcnt;
+  ret=sendmsg(fd,&msg,0);
   if (ret == 0)
   {
      /*
@@ -70,7 +102,7 @@ uint32_t af_unix_send_stream_generic(int fd,char *pMsg,int lgth,int *len_sent_p)
   if (ret > 0)
   {
      *len_sent_p = ret;
-     if (ret == lgth) return RUC_OK;
+     if (ret >= lgth) return RUC_OK;
      return RUC_PARTIAL;
   }
   /*
@@ -111,6 +143,98 @@ uint32_t af_unix_send_stream_generic(int fd,char *pMsg,int lgth,int *len_sent_p)
 
 
 
+ /*
+**__________________________________________________________________________
+*/
+/**
+  Release the current xmit buffer once it has been fully sent
+
+  @param socket_p : pointer to the socket context
+  @param xmit_p : pointer to the transmitter
+*/
+static void af_unix_send_stream_buf_done(af_unix_ctx_generic_t *socket_p,com_xmit_template_t *xmit_p)
+{
+  int inuse;
+
+  xmit_p->xmit_credit++;
+  inuse = ruc_buf_inuse_decrement(xmit_p->bufRefCurrent);
+  if (inuse < 0)
+  {
+    /*
+    ** inuse MUST never be negative so EXIT !!!!!
+    */
+    fatal("Inuse is negative %d",inuse);
+  }
+  if (socket_p->userXmitDoneCallBack != NULL)
+  {
+     /*
+     ** caution: in that case it is up to the application that provides the callback to release
+     ** the xmit buffer
+     */
+     if (ruc_buf_get_opaque_ref(xmit_p->bufRefCurrent) == socket_p) 
+     {
+       (socket_p->userXmitDoneCallBack)(socket_p->userRef,socket_p->index,xmit_p->bufRefCurrent);
+     }
+     else 
+     {
+       if (inuse == 1) 
+       {
+         /*
+         ** need an obj remove since that buffer might still queue somewhere : typically
+         ** in the xmit list of a load balacner entry.
+         */
+         ruc_objRemove((ruc_obj_desc_t*)xmit_p->bufRefCurrent);
+         ruc_buf_freeBuffer(xmit_p->bufRefCurrent);	
+       }        
+     }  
+  }
+  else
+  {
+    if (inuse == 1) 
+    {
+      ruc_objRemove((ruc_obj_desc_t*)xmit_p->bufRefCurrent);
+      ruc_buf_freeBuffer(xmit_p->bufRefCurrent);
+    }
+  }
+  xmit_p->bufRefCurrent = NULL;
+  xmit_p->nbWrite  = 0;
+  xmit_p->nb2Write = 0;
+  socket_p->stats.totalXmitSuccess++;
+}
+ /*
+**__________________________________________________________________________
+*/
+/**
+  Add to the areas to send the buffers that wait in the xmit queue behind
+  the current one. The buffers stay in the queue: only the buffers at the
+  head of the queue are taken, so the ones that are sent are dequeued in
+  the same order.
+
+  @param xmit_p : pointer to the transmitter
+  @param iov : areas to send, the first one being the current buffer
+
+  @retval number of areas to send
+*/
+static inline int af_unix_send_stream_gather(com_xmit_template_t *xmit_p,struct iovec *iov)
+{
+  ruc_obj_desc_t *pnext = NULL;
+  ruc_obj_desc_t *elem;
+  int             iovcnt = 1;
+
+  while (iovcnt < AF_UNIX_XMIT_IOV_MAX)
+  {
+    elem = ruc_objGetNext(&xmit_p->xmitList[0],&pnext);
+    if (elem == NULL) break;
+    /*
+    ** a request for a buffer must be processed by com_xmit_pendingQueue_get()
+    */
+    if (elem->usrEvtCode != UMA_XMIT_TYPE_BUFFER) break;
+    iov[iovcnt].iov_base = ruc_buf_getPayload(elem);
+    iov[iovcnt].iov_len  = ruc_buf_getPayloadLen(elem);
+    iovcnt++;
+  }
+  return iovcnt;
+}
  /*
 **__________________________________________________________________________
 */
@@ -122,6 +246,14 @@ void af_unix_send_stream_fsm(af_unix_ctx_generic_t *socket_p,com_xmit_template_t
   int inuse;
   uint64_t cycles_before;
   uint64_t cycles_after;
+  struct iovec iov[AF_UNIX_XMIT_IOV_MAX];
+  int iovcnt;
+  void *sent_tb[AF_UNIX_XMIT_IOV_MAX];
+  int nb_sent;
+  void *next_p;
+  int extra;
+  int len;
+  int i;
 
   while(1)
   {
@@ -164,8 +296,16 @@ void af_unix_send_stream_fsm(af_unix_ctx_generic_t *socket_p,com_xmit_template_t
         socket_p->stats.totalXmitAttempts++;
         socket_p->stats.totalXmitAttemptsCycles++;
         pbuf = (char *)ruc_buf_getPayload(xmit_p->bufRefCurrent);
+        iov[0].iov_base = pbuf+xmit_p->nbWrite;
+        iov[0].iov_len  = xmit_p->nb2Write - xmit_p->nbWrite;
+        iovcnt = 1;
+        /*
+        ** send the buffers of the xmit queue in the same system call
+        */
+        if (common_config.socket_vectored_io) iovcnt = af_unix_send_stream_gather(xmit_p,iov);
         cycles_before = ruc_rdtsc();
-        ret  = af_unix_send_stream_generic(socket_p->socketRef,pbuf+xmit_p->nbWrite,xmit_p->nb2Write - xmit_p->nbWrite, &write_len);
+        socket_p->stats.totalXmitSyscall++;
+        ret  = af_unix_send_stream_generic_vec(socket_p->socketRef,iov,iovcnt, &write_len);
         cycles_after = ruc_rdtsc();
         socket_p->stats.totalXmitCycles+= (cycles_after - cycles_before);
         
@@ -176,55 +316,44 @@ void af_unix_send_stream_fsm(af_unix_ctx_generic_t *socket_p,com_xmit_template_t
 	  ** update speculative scheduler
 	  */
 	  ruc_sockCtrl_speculative_scheduler_insert(socket_p->connectionId);
+          socket_p->stats.totalXmitBytes += write_len;
           /*
-          ** release the buffer that has been sent
+          ** dequeue the queued buffers that have been sent with the current
+          ** one before calling any application callback
           */
-          xmit_p->xmit_credit++;
-          inuse = ruc_buf_inuse_decrement(xmit_p->bufRefCurrent);
-          if (inuse < 0)
+          nb_sent = 0;
+          next_p  = NULL;
+          extra   = write_len - iov[0].iov_len;
+          while (extra > 0)
           {
-            /*
-	    ** inuse MUST never be negative so EXIT !!!!!
-	    */
-            fatal("Inuse is negative %d",inuse);
+            next_p = com_xmit_pendingQueue_get(xmit_p,0);
+            ruc_buf_inuse_increment(next_p);
+            len = ruc_buf_getPayloadLen(next_p);
+            if (extra < len) break;
+            sent_tb[nb_sent++] = next_p;
+            next_p = NULL;
+            extra -= len;
           }
-          if (socket_p->userXmitDoneCallBack != NULL)
+          /*
+          ** release the buffers that have been sent
+          */
+          af_unix_send_stream_buf_done(socket_p,xmit_p);
+          for (i = 0; i < nb_sent; i++)
           {
-             /*
-             ** caution: in that case it is up to the application that provides the callback to release
-             ** the xmit buffer
-             */
-	         if (ruc_buf_get_opaque_ref(xmit_p->bufRefCurrent) == socket_p) 
-             {
-                   (socket_p->userXmitDoneCallBack)(socket_p->userRef,socket_p->index,xmit_p->bufRefCurrent);
-	         }
-	         else 
-             {
-                if (inuse == 1) 
-                {
-                  /*
-                  ** need an obj remove since that buffer might still queue somewhere : typically
-                  ** in the xmit list of a load balacner entry.
-                  */
-                  ruc_objRemove((ruc_obj_desc_t*)xmit_p->bufRefCurrent);
-                  ruc_buf_freeBuffer(xmit_p->bufRefCurrent);	
-                }        
-	         }  
+            xmit_p->bufRefCurrent = sent_tb[i];
+            af_unix_send_stream_buf_done(socket_p,xmit_p);
           }
-          else
+          xmit_p->state = XMIT_CHECK_XMITQ;
+          if (next_p != NULL)
           {
-            if (inuse == 1) 
-            {
-              ruc_objRemove((ruc_obj_desc_t*)xmit_p->bufRefCurrent);
-              ruc_buf_freeBuffer(xmit_p->bufRefCurrent);
-            }
+            /*
+            ** a queued buffer has been partially sent: it becomes the current one
+            */
+            xmit_p->bufRefCurrent = next_p;
+            xmit_p->nbWrite  = extra;
+            xmit_p->nb2Write = len;
+            xmit_p->state = XMIT_IN_PRG;
           }
-          xmit_p->bufRefCurrent = NULL;
-          xmit_p->nbWrite  = 0;
-          xmit_p->nb2Write = 0;
-          socket_p->stats.totalXmitSuccess++;
-          socket_p->stats.totalXmitBytes += write_len;
-          xmit_p->state = XMIT_CHECK_XMITQ;
           break;
 
           case RUC_PARTIAL:
@@ -244,7 +373,7 @@ void af_unix_send_stream_fsm(af_unix_ctx_generic_t *socket_p,com_xmit_template_t
           xmit_p->eoc_flag       = 0;
           xmit_p->eoc_threshold  = AF_UNIX_CONGESTION_DEFAULT_THRESHOLD;
           xmit_p->state = XMIT_CONGESTED;
-	  FD_SET(socket_p->socketRef,&rucWrFdSetCongested);
+	  ruc_sockCtrl_set_xmit_congested(socket_p->socketRef);
 
           return ;
 
@@ -327,11 +456,11 @@ void af_unix_send_stream_fsm(af_unix_ctx_generic_t *socket_p,com_xmit_template_t
           ** controller
           */
           xmit_p->xmit_req_flag = 1;
-	  FD_SET(socket_p->socketRef,&rucWrFdSetCongested);
+	  ruc_sockCtrl_set_xmit_congested(socket_p->socketRef);
           return;
         }
 #endif
-	FD_CLR(socket_p->socketRef,&rucWrFdSetCongested);
+	ruc_sockCtrl_clear_xmit_congested(socket_p->socketRef);
 
         /*
         ** check if there is a pending buffer (case found if there was a previous congestion
@@ -375,13 +504,13 @@ void af_unix_send_stream_fsm(af_unix_ctx_generic_t *socket_p,com_xmit_template_t
            xmit_p->eoc_flag  = 1;
            xmit_p->congested_flag = 0;
            xmit_p->state = XMIT_IN_PRG;
-	   FD_CLR(socket_p->socketRef,&rucWrFdSetCongested);
+	   ruc_sockCtrl_clear_xmit_congested(socket_p->socketRef);
            break;
         }
 #if 0
 	else
 	{
-	  FD_SET(socket_p->socketRef,&rucWrFdSetCongested);
+	  ruc_sockCtrl_set_xmit_congested(socket_p->socketRef);
 	}
 #endif
         return;
@@ -30,9 +30,6 @@
 #include "com_tx_timer.h"
 #include <rozofs/common/log.h>
 
-#define COM_TX_TIMER_MAX_DATE 0xFFFFFFFF
-
-
 /*
 **   G L O B A L    D A T A 
 */
@@ -43,161 +40,154 @@
 
 com_tx_tmr_var_t com_tx_tmr={FALSE}; 
 
-#define MILLISECLONG(time) (((unsigned long long)time.tv_sec * 1000000 + time.tv_usec)/1000)
-
 
 /************************/
 /* internal functions   */
 /************************/
 
-uint32_t  com_tx_time()
+/*----------------------------------------------
+**  com_tx_tmr_tick
+**----------------------------------------------
+**
+**  It returns the current tick of the wheel
+**  from the monotonic clock
+**
+**  OUT : current tick
+**
+**-----------------------------------------------
+*/
+static inline uint32_t com_tx_tmr_tick()
 {
-  struct timeval       timeDay;
-  unsigned long long mylonglong;  
-  uint32_t  mylong;
+  struct timespec ts;
+  uint64_t ms;
 
-  gettimeofday(&timeDay,(struct timezone *)0);  
-  mylonglong = MILLISECLONG(timeDay);
-  /*
-  ** put the limit to 2 minutes
-  */
-  mylong = (uint32_t) mylonglong;
-  mylong &= COM_TX_TIMER_MAX_DATE;
-
-  return (uint32_t) mylong;
+  clock_gettime(CLOCK_MONOTONIC,&ts);
+  ms = (uint64_t)ts.tv_sec*1000 + ts.tv_nsec/1000000;
+  return (uint32_t)(ms / com_tx_tmr.period_ms);
 }
 
 /*----------------------------------------------
-**  com_tx_tmr_periodic
+**  com_tx_tmr_link
 **----------------------------------------------
 **
-**  It perform the processing of a limited number 
-**  of queued elements
+**  It queues a timer cell in the wheel slot
+**  corresponding to its time out date
 **    
-**  IN : not significant
+**  IN : p_refTim : timer cell whose date_s is set
 **
 **  OUT : none
 **
 **-----------------------------------------------
 */
-void com_tx_tmr_processSlot(ruc_obj_desc_t* pTmrQueue) ;
-
-void com_tx_tmr_periodic(void *ns) 
+static inline void com_tx_tmr_link(com_tx_tmr_cell_t *p_refTim)
 {
-  
-  int i;
-  
-  for ( i = 0; i < COM_TX_TMR_SLOT_MAX; i++)
-  {
-     com_tx_tmr_processSlot(&com_tx_tmr.queue[i]);
-  }
+  uint32_t diff;
+  uint32_t date;
+  int      level;
 
+  date = p_refTim->date_s;
+  diff = p_refTim->date_s - com_tx_tmr.cur_tick;
+  /*
+  ** date already reached: queue it in the current slot
+  */
+  if (diff > (uint32_t)0x7FFFFFFF) {
+    date = com_tx_tmr.cur_tick;
+    diff = 0;
+  }
+  for (level = 0; level < COM_TX_TMR_LEVEL_NB; level++) {
+    if ((diff >> (COM_TX_TMR_WHEEL_BITS*(level+1))) == 0) break;
+  }
+  if (level == COM_TX_TMR_LEVEL_NB) {
+    /*
+    ** beyond the wheel: queue it in the farthest slot of the upper level,
+    ** it is queued again when this slot is cascaded
+    */
+    level = COM_TX_TMR_LEVEL_NB-1;
+    date  = com_tx_tmr.cur_tick + ((1U<<(COM_TX_TMR_WHEEL_BITS*COM_TX_TMR_LEVEL_NB))-1);
+  }
+  ruc_objInsertTail(&com_tx_tmr.wheel[level][(date>>(COM_TX_TMR_WHEEL_BITS*level)) & COM_TX_TMR_WHEEL_MASK],
+                    (ruc_obj_desc_t*)p_refTim);
 }
 
 /*----------------------------------------------
-**  com_tx_tmr_processSlot
+**  com_tx_tmr_advance
 **----------------------------------------------
 **
-**  It performs  
-**  
+**  It moves the wheel forward up to the given
+**  tick and calls the time out function of the
+**  expired timers. When the credit is exhausted
+**  the wheel stays on the current slot that
+**  is processed again at the next period.
 **    
-**  IN : 
+**  IN : now_tick : tick up to which the wheel is moved forward
 **
-**  OUT : none
+**  OUT : number of expired timers
 **
 **-----------------------------------------------
 */
-void com_tx_tmr_processSlot(ruc_obj_desc_t* pTmrQueue) 
+uint32_t com_tx_tmr_advance(uint32_t now_tick)
 {
-   int32_t credit;
-   com_tx_tmr_cell_t * p_refTim;
-   uint32_t  cur_date_s;
-   uint8_t  expired = FALSE;
+  ruc_obj_desc_t    * pTmrQueue;
+  com_tx_tmr_cell_t * p_refTim;
+  uint32_t            expired = 0;
+  int32_t             credit;
+  int                 level;
+  uint32_t            idx;
 
+  credit = com_tx_tmr.credit * COM_TX_TMR_SLOT_MAX;
+
+  while (1)
+  {
     /*
-    ** processing credit and date initialization
+    ** call the time-out function of the timers of the current slot
     */
-    credit     = com_tx_tmr.credit;
-    cur_date_s = com_tx_time();
+    pTmrQueue = &com_tx_tmr.wheel[0][com_tx_tmr.cur_tick & COM_TX_TMR_WHEEL_MASK];
+    while ((p_refTim=(com_tx_tmr_cell_t *)ruc_objGetFirst(pTmrQueue)) != (com_tx_tmr_cell_t *)NULL)
+    {
+      if (credit <= 0) return expired;
+      ruc_objRemove((ruc_obj_desc_t *)p_refTim);
+      (*(p_refTim->p_callBack))(p_refTim->cBParam);
+      credit--;
+      expired++;
+      com_tx_tmr.nb_expired++;
+    }
+    if ((int32_t)(now_tick - com_tx_tmr.cur_tick) <= 0) return expired;
 
     /*
-    ** process elements while there is still credit,
-    ** and while time-out date is passed,
-    ** and while there are still some elements
+    ** next tick: cascade the upper levels when the lower one wraps
     */
-
-    while ( 
-           ((p_refTim=(com_tx_tmr_cell_t *)ruc_objGetFirst(pTmrQueue)) !=
-                    (com_tx_tmr_cell_t *)NULL)
-            && (credit > 0) 
-          ) {
-        /*
-        ** evaluate delay up to time out.
-        ** if time out not yet passed, stop read queue
-        */
-	expired = FALSE;
-	while (1)
-	{	
-	  if (cur_date_s > p_refTim->date_s)
-	  {
-	    /*
-	    ** it is possible that the counter has wrapped
-	    */
-	    if ((COM_TX_TIMER_MAX_DATE - cur_date_s + p_refTim->date_s) < p_refTim->delay)
-	    {
-	      /*
-	      ** nothing to do
-	      */
-
-	      break;
-	    }
-	    expired = TRUE;
-	    break;
-	  }
-	  if (cur_date_s == p_refTim->date_s)
-	  {
-	    expired = TRUE;
-	    break;
-	  }
-	  if (cur_date_s < p_refTim->date_s)
-	  {
-	    /*
-	    ** no expiration but look at the delay request since
-	    ** if somebody has changed the data we can be out of
-	    ** sync
-	    */
-	    if ((p_refTim->date_s - cur_date_s) > p_refTim->delay)
-	    {
-	       /*
-	       ** readjust the expiration date
-	       */
-	       p_refTim->date_s = cur_date_s + p_refTim->delay;
-	    }
-	  }
-	  break; 
-	}
-	if (!expired)
-	{
-	  /*
-	  ** not expiration leaves the loop
-	  */
-	  return;
-	}
-
-        /*
-        ** timer cell dequeing from its current queue
-        */
+    com_tx_tmr.cur_tick++;
+    for (level = 1; level < COM_TX_TMR_LEVEL_NB; level++)
+    {
+      if ((com_tx_tmr.cur_tick & ((1U<<(COM_TX_TMR_WHEEL_BITS*level))-1)) != 0) break;
+      idx = (com_tx_tmr.cur_tick>>(COM_TX_TMR_WHEEL_BITS*level)) & COM_TX_TMR_WHEEL_MASK;
+      pTmrQueue = &com_tx_tmr.wheel[level][idx];
+      while ((p_refTim=(com_tx_tmr_cell_t *)ruc_objGetFirst(pTmrQueue)) != (com_tx_tmr_cell_t *)NULL)
+      {
         ruc_objRemove((ruc_obj_desc_t *)p_refTim);
-	/*
-	** call the time-out function
-	*/
-        (*(p_refTim->p_callBack))(p_refTim->cBParam);
-
-        credit--;
-
+        com_tx_tmr_link(p_refTim);
+        com_tx_tmr.nb_cascaded++;
+      }
     }
- 
-    return;
+  }
+}
+
+/*----------------------------------------------
+**  com_tx_tmr_periodic
+**----------------------------------------------
+**
+**  It moves the wheel forward up to the
+**  current time
+**    
+**  IN : not significant
+**
+**  OUT : none
+**
+**-----------------------------------------------
+*/
+void com_tx_tmr_periodic(void *ns) 
+{
+  com_tx_tmr_advance(com_tx_tmr_tick());
 }
 
 
@@ -214,7 +204,7 @@ void com_tx_tmr_processSlot(ruc_obj_desc_t* pTmrQueue)
 **  charging timer service starting request
 **    
 **  IN : p_refTim   : reference of the timer cell to use
-**       date_s     : requested time out date, in seconds
+**       date_s     : requested delay, in milliseconds
 **       p_callBack : client call back to call at time out
 **       cBParam    : client parameter to provide at time out
 **
@@ -229,7 +219,7 @@ uint32_t  com_tx_tmr_start (uint8_t   tmr_slot,
                         void *cBParam
 			)
 {
-     uint32_t ret;       
+     uint32_t ticks;
      
      if (tmr_slot >= COM_TX_TMR_SLOT_MAX)
      {
@@ -245,21 +235,18 @@ uint32_t  com_tx_tmr_start (uint8_t   tmr_slot,
     ruc_objRemove((ruc_obj_desc_t *)p_refTim);
 
     /*
-    ** initialize context
+    ** initialize context: the time out occurs on the first tick
+    ** following the requested delay
     */
-    p_refTim->date_s = date_s + com_tx_time();
-    p_refTim->date_s &= COM_TX_TIMER_MAX_DATE;
+    ticks = (date_s + com_tx_tmr.period_ms - 1) / com_tx_tmr.period_ms;
+    if (ticks == 0) ticks = 1;
+    p_refTim->date_s = com_tx_tmr.cur_tick + ticks;
     p_refTim->delay = date_s;
     
     p_refTim->p_callBack = p_callBack;
     p_refTim->cBParam = cBParam;
 
-
-    ret=ruc_objInsertTail(&com_tx_tmr.queue[tmr_slot],(ruc_obj_desc_t*)p_refTim);
-    if(ret!=RUC_OK){
-        severe( "Pb while inserting cell in queue, ret=%u", ret );
-        return(RUC_NOK);
-    }
+    com_tx_tmr_link(p_refTim);
     return(RUC_OK);
 }
 
@@ -306,7 +293,7 @@ int com_tx_tmr_init(uint32_t period_ms,
                     uint32_t credit)
 {
 
-    int i;
+    int i,j;
     
     /**************************/
     /* configuration variable */
@@ -341,12 +328,16 @@ int com_tx_tmr_init(uint32_t period_ms,
 
 
     /*
-    **  queue initialization
+    **  wheel initialization
     */
-    for (i = 0; i < COM_TX_TMR_SLOT_MAX; i++)
+    for (i = 0; i < COM_TX_TMR_LEVEL_NB; i++)
     {
-      ruc_listHdrInit(&com_tx_tmr.queue[i]);
+      for (j = 0; j < COM_TX_TMR_WHEEL_SIZE; j++)
+      {
+        ruc_listHdrInit(&com_tx_tmr.wheel[i][j]);
+      }
     }
+    com_tx_tmr.cur_tick = com_tx_tmr_tick();
 
     /*
     ** charging timer periodic launching
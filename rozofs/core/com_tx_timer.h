@@ -30,6 +30,19 @@
 
 
 
+/*
+** The timers are kept in a hierarchical timing wheel whose tick is the
+** period of the service. A timer is queued in the level 0 when it expires
+** within COM_TX_TMR_WHEEL_SIZE ticks, in the level 1 when it expires within
+** COM_TX_TMR_WHEEL_SIZE^2 ticks, and so on. When the level 0 wraps, the
+** current slot of the level 1 is cascaded in the lower level.
+** Start, stop and expiration are done without any list scanning.
+*/
+#define COM_TX_TMR_WHEEL_BITS     6
+#define COM_TX_TMR_WHEEL_SIZE     (1<<COM_TX_TMR_WHEEL_BITS)
+#define COM_TX_TMR_WHEEL_MASK     (COM_TX_TMR_WHEEL_SIZE-1)
+#define COM_TX_TMR_LEVEL_NB       4
+
 /****************************/
 /* charging timer variables  */
 /****************************/
@@ -42,7 +55,10 @@ typedef struct _com_tx_tmr_var_t {
     uint32_t         credit;                         /* nb of element processed   */
                                                    /* at each look up           */             
  /* working variables */
-    ruc_obj_desc_t queue[COM_TX_TMR_SLOT_MAX];	   /* queue                     */
+    uint32_t         cur_tick;                       /* current tick of the wheel */
+    ruc_obj_desc_t   wheel[COM_TX_TMR_LEVEL_NB][COM_TX_TMR_WHEEL_SIZE];
+    uint64_t         nb_expired;                     /* statistics                */
+    uint64_t         nb_cascaded;
     struct timer_cell * p_periodic_timCell;        /* periodic timer cell       */	 
 } com_tx_tmr_var_t;
 
@@ -54,6 +70,13 @@ typedef struct _com_tx_tmr_var_t {
 
 extern void com_tx_tmr_periodic(void *ns);
 
+/*
+**  IN : now_tick : tick up to which the wheel is moved forward
+**
+**  OUT : number of expired timers
+*/
+extern uint32_t com_tx_tmr_advance(uint32_t now_tick);
+
 extern com_tx_tmr_var_t com_tx_tmr;
 
 #endif
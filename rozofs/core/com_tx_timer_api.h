@@ -22,7 +22,8 @@
 #include "ruc_timer_api.h"
 
 /*
-** there is one timer slot per timr type
+** there is one timer slot per timr type. The slot is only kept for
+** compatibility: every timer is ordered by its date in the same wheel
 */
 #define  COM_TX_TMR_SLOT0         0
 #define  COM_TX_TMR_SLOT1         1
@@ -46,7 +47,7 @@ typedef void (*com_tx_tmr_callBack_t)(void*) ; /* call back type */
 
 typedef struct _com_tx_tmr_cell_t {
     ruc_obj_desc_t         listHead;    /* header used by list service for queing */
-    uint32_t                 date_s;      /* time out date in system milliseconds */
+    uint32_t                 date_s;      /* time out date in ticks of the wheel */
     uint32_t                 delay;      /* delay requested in ms      */
     com_tx_tmr_callBack_t p_callBack;  /* call back to be used at time out */
     void                 *cBParam;     /* parameter to be provided at time out */
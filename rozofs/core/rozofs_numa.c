@@ -16,6 +16,9 @@
   <http://www.gnu.org/licenses/>.
  */
 #include <numa.h>
+#include <numaif.h>
+#include <errno.h>
+#include <string.h>
 #include "rozofs_numa.h"
 #include <rozofs/common/common_config.h>
 #include <rozofs/common/log.h>
@@ -88,3 +91,29 @@ void rozofs_numa_allocate_node(int instance)
    numa_set_preferred(bit);
    info("rozofs_numa_allocate_node(%d): set on node %d", instance,bit);
 }
+/**
+*  case of NUMA: bind a memory area on the node allocated to the process
+*  before its pages are touched
+
+   @param addr: start of the memory area (page aligned)
+   @param len: length of the memory area
+   @param strict: whether the pages must be taken from that node only
+   
+   @retval the node the area is bound to or -1 when not bound
+*/
+int rozofs_numa_bind_memory(void * addr, size_t len, int strict)
+{
+   unsigned long nodemask;
+
+   /*
+   ** no node allocated to the process
+   */
+   if ((bit < 0) || (bit >= (int)(8*sizeof(nodemask)))) return -1;
+
+   nodemask = 1UL << bit;
+   if (mbind(addr, len, strict?MPOL_BIND:MPOL_PREFERRED, &nodemask, 8*sizeof(nodemask), 0) != 0) {
+     warning("rozofs_numa_bind_memory(%p,%llu) node %d %s", addr, (unsigned long long)len, bit, strerror(errno));
+     return -1;
+   }
+   return bit;
+}
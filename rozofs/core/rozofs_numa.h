@@ -26,5 +26,16 @@
    @param instance: instance number of the process
 */
 void rozofs_numa_allocate_node(int instance);
+/**
+*  case of NUMA: bind a memory area on the node allocated to the process
+*  before its pages are touched
+
+   @param addr: start of the memory area (page aligned)
+   @param len: length of the memory area
+   @param strict: whether the pages must be taken from that node only
+   
+   @retval the node the area is bound to or -1 when not bound
+*/
+int rozofs_numa_bind_memory(void * addr, size_t len, int strict);
 
 #endif
@@ -0,0 +1,335 @@
+/*
+ Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+ This file is part of Rozofs.
+
+ Rozofs is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published
+ by the Free Software Foundation, version 2.
+
+ Rozofs is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see
+ <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <malloc.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <rozofs/common/log.h>
+#include <rozofs/core/ruc_common.h>
+#include <rozofs/core/ruc_sockCtl_api.h>
+#include <rozofs/core/rozofs_string.h>
+#include "rozofs_ring.h"
+
+/*__________________________________________________________________________
+*/
+/**
+*  Initialize a ring
+*
+* @param r         the ring to initialize
+* @param nb_msg    minimum number of messages the ring can hold (rounded to a power of 2)
+* @param msg_size  size of a message
+* @param efd       eventfd to wake up the consumer
+*
+* @retval 0 on success -1 in case of error
+*/
+int rozofs_ring_init(rozofs_ring_t * r, uint32_t nb_msg, uint32_t msg_size, int efd) {
+  uint32_t size = 1;
+
+  while (size < nb_msg) size <<= 1;
+
+  memset(r,0,sizeof(rozofs_ring_t));
+  r->mask     = size - 1;
+  r->msg_size = msg_size;
+  r->efd      = efd;
+  r->data     = memalign(ROZOFS_RING_CACHE_LINE, size * msg_size);
+  if (r->data == NULL) {
+    severe("rozofs_ring_init out of memory %u x %u", size, msg_size);
+    return -1;
+  }
+  return 0;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Release the memory of a ring (the eventfd is not closed)
+*
+* @param r         the ring
+*/
+void rozofs_ring_release(rozofs_ring_t * r) {
+  if (r->data != NULL) free(r->data);
+  r->data = NULL;
+}
+
+/*
+**__________________________________________________________________________
+**   S O C K E T   C O N T R O L L E R   C A L L B A C K S
+**__________________________________________________________________________
+*/
+static uint32_t rozofs_thread_channel_rcvReadysock(void * ch, int socketId) {
+  return TRUE;
+}
+static uint32_t rozofs_thread_channel_xmitReadysock(void * ch, int socketId) {
+  return FALSE;
+}
+static uint32_t rozofs_thread_channel_xmitEvtsock(void * ch, int socketId) {
+  return TRUE;
+}
+/*
+** The eventfd is readable: clear it before reading the rings, so that a
+** response put after the last read of a ring triggers a new event
+*/
+static uint32_t rozofs_thread_channel_rcvMsgsock(void * ch, int socketId) {
+  rozofs_thread_channel_t * p = (rozofs_thread_channel_t *) ch;
+
+  p->wakeup_count++;
+  rozofs_ring_clear(socketId);
+  rozofs_thread_channel_poll(p);
+  return TRUE;
+}
+static ruc_sockCallBack_t rozofs_thread_channel_callBack_sock = {
+  rozofs_thread_channel_rcvReadysock,
+  rozofs_thread_channel_rcvMsgsock,
+  rozofs_thread_channel_xmitReadysock,
+  rozofs_thread_channel_xmitEvtsock
+};
+
+/*__________________________________________________________________________
+*/
+/**
+*  Create a channel between the main thread and a pool of threads
+*
+* @param name        name of the channel (for the socket controller and debug)
+* @param nb_threads  number of threads
+* @param msg_size    size of the requests and responses
+* @param depth       maximum number of requests pending in the channel
+* @param callback    processing of a response in the main thread
+*
+* @retval the channel or NULL in case of error
+*/
+rozofs_thread_channel_t * rozofs_thread_channel_create(char * name, int nb_threads, uint32_t msg_size,
+                                                       uint32_t depth, rozofs_thread_channel_cbk_t callback) {
+  rozofs_thread_channel_t * ch;
+  int                       i;
+
+  ch = malloc(sizeof(rozofs_thread_channel_t));
+  if (ch == NULL) goto error;
+  memset(ch,0,sizeof(rozofs_thread_channel_t));
+
+  snprintf(ch->name, sizeof(ch->name), "%s", name);
+  ch->nb_threads   = nb_threads;
+  ch->msg_size     = msg_size;
+  ch->callback     = callback;
+  ch->last         = nb_threads - 1;
+  ch->response_efd = -1;
+
+  ch->request     = memalign(ROZOFS_RING_CACHE_LINE, nb_threads * sizeof(rozofs_ring_t));
+  ch->response    = memalign(ROZOFS_RING_CACHE_LINE, nb_threads * sizeof(rozofs_ring_t));
+  ch->request_efd = malloc(nb_threads * sizeof(int));
+  ch->pending     = malloc(nb_threads * sizeof(uint32_t));
+  ch->msg         = malloc(msg_size);
+  if ((ch->request == NULL) || (ch->response == NULL) || (ch->request_efd == NULL)
+  ||  (ch->pending == NULL) || (ch->msg == NULL)) goto error;
+  memset(ch->request, 0, nb_threads * sizeof(rozofs_ring_t));
+  memset(ch->response, 0, nb_threads * sizeof(rozofs_ring_t));
+  memset(ch->pending, 0, nb_threads * sizeof(uint32_t));
+  for (i=0; i<nb_threads; i++) ch->request_efd[i] = -1;
+
+  /*
+  ** The main thread is woken up through the socket controller
+  */
+  ch->response_efd = eventfd(0, EFD_NONBLOCK);
+  if (ch->response_efd < 0) goto error;
+
+  for (i=0; i<nb_threads; i++) {
+
+    /*
+    ** A thread blocks on its eventfd when it has no request
+    */
+    ch->request_efd[i] = eventfd(0, 0);
+    if (ch->request_efd[i] < 0) goto error;
+
+    /*
+    ** Every request may be given to the same thread
+    */
+    if (rozofs_ring_init(&ch->request[i], depth, msg_size, ch->request_efd[i]) != 0) goto error;
+    if (rozofs_ring_init(&ch->response[i], depth, msg_size, ch->response_efd) != 0) goto error;
+  }
+
+  if (ruc_sockctl_connect(ch->response_efd, ch->name, 16, ch, &rozofs_thread_channel_callBack_sock) == NULL) {
+    severe("rozofs_thread_channel_create(%s) ruc_sockctl_connect", name);
+    goto error;
+  }
+  return ch;
+
+error:
+  severe("rozofs_thread_channel_create(%s) %s", name, strerror(errno));
+  if (ch == NULL) return NULL;
+  for (i=0; (ch->request_efd != NULL) && (i<nb_threads); i++) {
+    if (ch->request_efd[i] >= 0) close(ch->request_efd[i]);
+    if (ch->request  != NULL) rozofs_ring_release(&ch->request[i]);
+    if (ch->response != NULL) rozofs_ring_release(&ch->response[i]);
+  }
+  if (ch->response_efd >= 0) close(ch->response_efd);
+  if (ch->request)     free(ch->request);
+  if (ch->response)    free(ch->response);
+  if (ch->request_efd) free(ch->request_efd);
+  if (ch->pending)     free(ch->pending);
+  if (ch->msg)         free(ch->msg);
+  free(ch);
+  return NULL;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Send a request to the thread with the least pending responses.
+*  Called by the main thread.
+*
+* @param ch          the channel
+* @param msg         the request
+* @param nb_resp     number of responses the request will trigger
+*
+* @retval the index of the thread on success -1 when no ring has room
+*/
+int rozofs_thread_channel_send(rozofs_thread_channel_t * ch, void * msg, int nb_resp) {
+  int idx = ch->last;
+  int best = -1;
+  int i;
+
+  /*
+  ** Start after the last used thread to share the requests between
+  ** the idle threads
+  */
+  for (i=0; i<ch->nb_threads; i++) {
+    idx++;
+    if (idx >= ch->nb_threads) idx = 0;
+    if ((best == -1) || (ch->pending[idx] < ch->pending[best])) best = idx;
+    if (ch->pending[best] == 0) break;
+  }
+
+  if (rozofs_ring_put(&ch->request[best], msg) != 0) {
+    /*
+    ** Rings are sized for every pending request, so this should not occur
+    */
+    for (best=0; best<ch->nb_threads; best++) {
+      if (rozofs_ring_put(&ch->request[best], msg) == 0) break;
+    }
+    if (best == ch->nb_threads) {
+      errno = ENOBUFS;
+      return -1;
+    }
+  }
+  ch->pending[best] += nb_resp;
+  ch->last = best;
+  ch->send_count++;
+  return best;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Send a request to a given thread, for requests that must be processed
+*  by the thread owning their data. Called by the main thread.
+*
+* @param ch          the channel
+* @param thread_idx  index of the thread
+* @param msg         the request
+* @param nb_resp     number of responses the request will trigger
+*
+* @retval 0 on success -1 when the ring of the thread is full
+*/
+int rozofs_thread_channel_send_to(rozofs_thread_channel_t * ch, int thread_idx, void * msg, int nb_resp) {
+
+  if (rozofs_ring_put(&ch->request[thread_idx], msg) != 0) {
+    errno = ENOBUFS;
+    return -1;
+  }
+  ch->pending[thread_idx] += nb_resp;
+  ch->send_count++;
+  return 0;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Process the responses pending in the channel. Called by the main thread.
+*
+* @param ch          the channel
+*
+* @retval the number of processed responses
+*/
+int rozofs_thread_channel_poll(rozofs_thread_channel_t * ch) {
+  int i;
+  int count = 0;
+
+  for (i=0; i<ch->nb_threads; i++) {
+    while (rozofs_ring_get(&ch->response[i], ch->msg)) {
+      if (ch->pending[i] > 0) ch->pending[i]--;
+      count++;
+      ch->callback(ch->msg);
+    }
+  }
+  ch->recv_count += count;
+  return count;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Send back a response. Called by a thread of the pool.
+*
+* @param ch          the channel
+* @param thread_idx  index of the calling thread
+* @param msg         the response
+*/
+void rozofs_thread_channel_reply(rozofs_thread_channel_t * ch, int thread_idx, void * msg) {
+
+  /*
+  ** The ring is sized for every pending request, but let the main thread
+  ** read it in case
+  */
+  while (rozofs_ring_put(&ch->response[thread_idx], msg) != 0) {
+    sched_yield();
+  }
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Display the channel statistics
+*
+* @param ch          the channel
+* @param pChar       where to write
+*
+* @retval the end of the written string
+*/
+char * rozofs_thread_channel_display(rozofs_thread_channel_t * ch, char * pChar) {
+  int i;
+
+  pChar += rozofs_string_append(pChar,"ring channel ");
+  pChar += rozofs_string_append(pChar,ch->name);
+  pChar += rozofs_string_append(pChar," : sent ");
+  pChar += rozofs_u64_append(pChar,ch->send_count);
+  pChar += rozofs_string_append(pChar," received ");
+  pChar += rozofs_u64_append(pChar,ch->recv_count);
+  pChar += rozofs_string_append(pChar," main thread wake up ");
+  pChar += rozofs_u64_append(pChar,ch->wakeup_count);
+  pChar += rozofs_eol(pChar);
+  pChar += rozofs_string_append(pChar,"  thread | pending |   queued   |  wake up   |  full  \n");
+  for (i=0; i<ch->nb_threads; i++) {
+    pChar += rozofs_string_append(pChar,"  ");
+    pChar += rozofs_u32_padded_append(pChar,6,rozofs_right_alignment,i);
+    pChar += rozofs_string_append(pChar," |");
+    pChar += rozofs_u32_padded_append(pChar,8,rozofs_right_alignment,ch->pending[i]);
+    pChar += rozofs_string_append(pChar," |");
+    pChar += rozofs_u32_padded_append(pChar,11,rozofs_right_alignment,rozofs_ring_count(&ch->request[i]));
+    pChar += rozofs_string_append(pChar," |");
+    pChar += rozofs_u64_padded_append(pChar,11,rozofs_right_alignment,ch->request[i].notify_count);
+    pChar += rozofs_string_append(pChar," |");
+    pChar += rozofs_u64_padded_append(pChar,7,rozofs_right_alignment,ch->request[i].full_count);
+    pChar += rozofs_eol(pChar);
+  }
+  return pChar;
+}
@@ -0,0 +1,304 @@
+/*
+ Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+ This file is part of Rozofs.
+
+ Rozofs is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published
+ by the Free Software Foundation, version 2.
+
+ Rozofs is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see
+ <http://www.gnu.org/licenses/>.
+ */
+#ifndef ROZOFS_RING_H
+#define ROZOFS_RING_H
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+/*
+** Lock-free single producer / single consumer ring of fixed size messages.
+**
+** The producer wakes up the consumer through an eventfd, but only when the
+** consumer had emptied the ring before the message was put, so that a busy
+** consumer costs no system call. The consumer must check the ring before
+** waiting on the eventfd, and check it again after having cleared the
+** eventfd when it does not block on it.
+**
+** Several rings may share the same eventfd when they have the same consumer.
+*/
+
+#define ROZOFS_RING_CACHE_LINE  64
+
+typedef struct _rozofs_ring_t {
+  uint32_t   head __attribute__((aligned(ROZOFS_RING_CACHE_LINE))); /**< next message to read (consumer) */
+  uint32_t   tail __attribute__((aligned(ROZOFS_RING_CACHE_LINE))); /**< next message to write (producer) */
+  uint64_t   notify_count;  /**< number of consumer wake up (producer) */
+  uint64_t   full_count;    /**< number of put on a full ring (producer) */
+  uint32_t   mask __attribute__((aligned(ROZOFS_RING_CACHE_LINE)));
+  uint32_t   msg_size;
+  int        efd;           /**< eventfd to wake up the consumer */
+  char     * data;
+} rozofs_ring_t;
+
+/*__________________________________________________________________________
+*/
+/**
+*  Initialize a ring
+*
+* @param r         the ring to initialize
+* @param nb_msg    minimum number of messages the ring can hold (rounded to a power of 2)
+* @param msg_size  size of a message
+* @param efd       eventfd to wake up the consumer
+*
+* @retval 0 on success -1 in case of error
+*/
+int rozofs_ring_init(rozofs_ring_t * r, uint32_t nb_msg, uint32_t msg_size, int efd);
+/*__________________________________________________________________________
+*/
+/**
+*  Release the memory of a ring (the eventfd is not closed)
+*
+* @param r         the ring
+*/
+void rozofs_ring_release(rozofs_ring_t * r);
+
+/*__________________________________________________________________________
+*/
+/**
+*  Put a message in a ring. Called by the producer only.
+*
+* @param r         the ring
+* @param msg       the message to copy in the ring
+*
+* @retval 0 on success -1 when the ring is full
+*/
+static inline int rozofs_ring_put(rozofs_ring_t * r, void * msg) {
+  uint32_t tail = r->tail;
+  uint32_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+  uint64_t one  = 1;
+
+  if ((tail - head) > r->mask) {
+    r->full_count++;
+    return -1;
+  }
+  memcpy(r->data + (tail & r->mask) * r->msg_size, msg, r->msg_size);
+  __atomic_store_n(&r->tail, tail+1, __ATOMIC_RELEASE);
+
+  /*
+  ** Wake up the consumer when it has read every previous message.
+  ** The fence pairs with the one of rozofs_ring_get on an empty ring.
+  */
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&r->head, __ATOMIC_RELAXED) == tail) {
+    r->notify_count++;
+    if (write(r->efd, &one, sizeof(one)) < 0) {
+      /* the counter can only be saturated: the consumer is already awake */
+    }
+  }
+  return 0;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Get a message from a ring. Called by the consumer only.
+*
+* @param r         the ring
+* @param msg       where to copy the message
+*
+* @retval 1 when a message is returned, 0 when the ring is empty
+*/
+static inline int rozofs_ring_get(rozofs_ring_t * r, void * msg) {
+  uint32_t head = r->head;
+  uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+
+  if (head == tail) {
+    /*
+    ** Make sure the producer sees the ring empty or we see its message
+    */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    if (head == tail) return 0;
+  }
+  memcpy(msg, r->data + (head & r->mask) * r->msg_size, r->msg_size);
+  __atomic_store_n(&r->head, head+1, __ATOMIC_RELEASE);
+  return 1;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Number of messages in a ring
+*
+* @param r         the ring
+*/
+static inline uint32_t rozofs_ring_count(rozofs_ring_t * r) {
+  return __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) - __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Wait for the wake up of the consumer of a ring on a blocking eventfd
+*
+* @param efd       the eventfd
+*/
+static inline void rozofs_ring_wait(int efd) {
+  uint64_t count;
+  while (read(efd, &count, sizeof(count)) < 0) {
+    if (errno != EINTR) break;
+  }
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Clear a non blocking eventfd after a wake up
+*
+* @param efd       the eventfd
+*/
+static inline void rozofs_ring_clear(int efd) {
+  uint64_t count;
+  if (read(efd, &count, sizeof(count)) < 0) {
+    /* EAGAIN: nothing to clear */
+  }
+}
+
+
+/*
+** Bidirectional exchange between the main thread of a process and a pool
+** of helper threads: one request ring per thread written by the main
+** thread, and one response ring per thread read by the main thread.
+** The requests are given to the thread with the least pending responses.
+** The response rings share an eventfd attached to the socket controller.
+*/
+
+/*
+** Processing of a response in the main thread
+*/
+typedef void (*rozofs_thread_channel_cbk_t)(void * msg);
+
+typedef struct _rozofs_thread_channel_t {
+  char                        name[32];
+  int                         nb_threads;
+  uint32_t                    msg_size;
+  rozofs_ring_t             * request;       /**< one request ring per thread */
+  rozofs_ring_t             * response;      /**< one response ring per thread */
+  int                       * request_efd;   /**< eventfd waking up each thread */
+  int                         response_efd;  /**< eventfd waking up the main thread */
+  uint32_t                  * pending;       /**< responses expected from each thread */
+  int                         last;          /**< last thread a request was given to */
+  rozofs_thread_channel_cbk_t callback;
+  char                      * msg;           /**< buffer for reading a response */
+  uint64_t                    send_count;
+  uint64_t                    recv_count;
+  uint64_t                    wakeup_count;  /**< number of wake up of the main thread */
+} rozofs_thread_channel_t;
+
+/*__________________________________________________________________________
+*/
+/**
+*  Create a channel between the main thread and a pool of threads
+*
+* @param name        name of the channel (for the socket controller and debug)
+* @param nb_threads  number of threads
+* @param msg_size    size of the requests and responses
+* @param depth       maximum number of requests pending in the channel
+* @param callback    processing of a response in the main thread
+*
+* @retval the channel or NULL in case of error
+*/
+rozofs_thread_channel_t * rozofs_thread_channel_create(char * name, int nb_threads, uint32_t msg_size,
+                                                       uint32_t depth, rozofs_thread_channel_cbk_t callback);
+/*__________________________________________________________________________
+*/
+/**
+*  Send a request to the thread with the least pending responses.
+*  Called by the main thread.
+*
+* @param ch          the channel
+* @param msg         the request
+* @param nb_resp     number of responses the request will trigger
+*
+* @retval the index of the thread on success -1 when no ring has room
+*/
+int rozofs_thread_channel_send(rozofs_thread_channel_t * ch, void * msg, int nb_resp);
+/*__________________________________________________________________________
+*/
+/**
+*  Send a request to a given thread, for requests that must be processed
+*  by the thread owning their data. Called by the main thread.
+*
+* @param ch          the channel
+* @param thread_idx  index of the thread
+* @param msg         the request
+* @param nb_resp     number of responses the request will trigger
+*
+* @retval 0 on success -1 when the ring of the thread is full
+*/
+int rozofs_thread_channel_send_to(rozofs_thread_channel_t * ch, int thread_idx, void * msg, int nb_resp);
+/*__________________________________________________________________________
+*/
+/**
+*  Process the responses pending in the channel. Called by the main thread.
+*
+* @param ch          the channel
+*
+* @retval the number of processed responses
+*/
+int rozofs_thread_channel_poll(rozofs_thread_channel_t * ch);
+/*__________________________________________________________________________
+*/
+/**
+*  Send back a response. Called by a thread of the pool.
+*
+* @param ch          the channel
+* @param thread_idx  index of the calling thread
+* @param msg         the response
+*/
+void rozofs_thread_channel_reply(rozofs_thread_channel_t * ch, int thread_idx, void * msg);
+/*__________________________________________________________________________
+*/
+/**
+*  Read a request without blocking. Called by a thread of the pool.
+*
+* @param ch          the channel
+* @param thread_idx  index of the calling thread
+* @param msg         where to copy the request
+*
+* @retval 1 when a request is returned, 0 when there is none
+*/
+static inline int rozofs_thread_channel_try_receive(rozofs_thread_channel_t * ch, int thread_idx, void * msg) {
+  return rozofs_ring_get(&ch->request[thread_idx], msg);
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Wait for a request. Called by a thread of the pool.
+*
+* @param ch          the channel
+* @param thread_idx  index of the calling thread
+* @param msg         where to copy the request
+*/
+static inline void rozofs_thread_channel_receive(rozofs_thread_channel_t * ch, int thread_idx, void * msg) {
+  while (rozofs_ring_get(&ch->request[thread_idx], msg) == 0) {
+    rozofs_ring_wait(ch->request_efd[thread_idx]);
+  }
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Display the channel statistics
+*
+* @param ch          the channel
+* @param pChar       where to write
+*
+* @retval the end of the written string
+*/
+char * rozofs_thread_channel_display(rozofs_thread_channel_t * ch, char * pChar);
+
+#endif
@@ -24,10 +24,13 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 #include <sys/ipc.h>
 #include <sys/shm.h>
+#include <sys/mman.h>
 #include <errno.h>
 #include <rozofs/common/log.h>
+#include <rozofs/common/common_config.h>
 
 #include "ruc_common.h"
 #include "ruc_buffer.h"
@@ -35,6 +38,7 @@
 #include "ruc_buffer_api.h"
 #include "ruc_trace_api.h"
 #include "rozofs_share_memory.h"
+#include "rozofs_numa.h"
 
 
 uint32_t ruc_buffer_trace = FALSE;
@@ -50,6 +54,165 @@ void ruc_buf_set_trace(uint32_t flag)
   ruc_buffer_trace = flag;
 }
 
+/*
+** Payload areas of the buffer pools that are not simply malloc'ed
+*/
+#define RUC_BUF_MAX_AREA  128
+
+typedef struct _ruc_buf_area_t {
+  void          * ptr;
+  size_t          size;
+  ruc_buf_mem_e   mem;
+  int             node;   /**< NUMA node the area is bound to or -1 */
+} ruc_buf_area_t;
+
+static ruc_buf_area_t ruc_buf_area[RUC_BUF_MAX_AREA];
+ruc_buf_mem_stats_t   ruc_buf_mem_stats;
+
+/*
+**__________________________________________________________
+* Record a payload area
+*
+* @retval 0 on success -1 when the table is full
+*/
+static int ruc_buf_area_record(void * ptr, size_t size, ruc_buf_mem_e mem, int node) {
+  int idx;
+
+  for (idx=0; idx<RUC_BUF_MAX_AREA; idx++) {
+    if (ruc_buf_area[idx].ptr != NULL) continue;
+    ruc_buf_area[idx].ptr  = ptr;
+    ruc_buf_area[idx].size = size;
+    ruc_buf_area[idx].mem  = mem;
+    ruc_buf_area[idx].node = node;
+    if (node >= 0) ruc_buf_mem_stats.numa_count++;
+    return 0;
+  }
+  return -1;
+}
+/*
+**__________________________________________________________
+* Find a recorded payload area (a free entry when ptr is NULL)
+*/
+static ruc_buf_area_t * ruc_buf_area_lookup(void * ptr) {
+  int idx;
+
+  for (idx=0; idx<RUC_BUF_MAX_AREA; idx++) {
+    if (ruc_buf_area[idx].ptr == ptr) return &ruc_buf_area[idx];
+  }
+  return NULL;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Allocate the payload area of a buffer pool. Large areas are rounded to
+*  huge pages, taken on explicit huge pages when buffer_hugepage is
+*  configured, and bound to the NUMA node of the process.
+*
+* @param size      requested size
+*
+* @retval the payload area or NULL when out of memory
+*/
+void * ruc_buf_payload_alloc(size_t size) {
+  void          * ptr = MAP_FAILED;
+  ruc_buf_mem_e   mem;
+  int             node;
+
+  /*
+  ** Small areas, or no more room to record a large one
+  */
+  if ((size <= ROZOFS_HUGE_PAGE_SIZE) || (ruc_buf_area_lookup(NULL) == NULL)) {
+    goto malloc_area;
+  }
+  size = ((size + ROZOFS_HUGE_PAGE_SIZE - 1) / ROZOFS_HUGE_PAGE_SIZE) * ROZOFS_HUGE_PAGE_SIZE;
+
+  mem = RUC_BUF_MEM_HUGETLB;
+  if (common_config.buffer_hugepage) {
+    ptr = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+    if (ptr == MAP_FAILED) {
+      /*
+      ** Not enough huge pages reserved: use transparent huge pages
+      */
+      warning("ruc_buf_payload_alloc no huge page for %llu bytes %s", (unsigned long long)size, strerror(errno));
+      ruc_buf_mem_stats.fallback_count++;
+      ruc_buf_mem_stats.fallback_bytes += size;
+    }
+  }
+  if (ptr == MAP_FAILED) {
+    mem = RUC_BUF_MEM_THP;
+    ptr = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) return NULL;
+#ifdef MADV_HUGEPAGE
+    madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+  }
+  else {
+    ruc_buf_mem_stats.hugetlb_count++;
+    ruc_buf_mem_stats.hugetlb_bytes += size;
+  }
+
+  /*
+  ** Bind the pages to the node before they are touched. Explicit huge pages
+  ** are reserved on any node, so a strict binding could fail on page fault
+  */
+  node = rozofs_numa_bind_memory(ptr, size, (mem!=RUC_BUF_MEM_HUGETLB));
+  memset(ptr,0,size);
+  ruc_buf_area_record(ptr, size, mem, node);
+  return ptr;
+
+malloc_area:
+  if (posix_memalign(&ptr,4096,size)) return NULL;
+  memset(ptr,0,size);
+  return ptr;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Release the payload area of a buffer pool
+*
+* @param ptr       the payload area
+*/
+void ruc_buf_payload_free(void * ptr) {
+  ruc_buf_area_t * area;
+
+  if (ptr == NULL) return;
+  area = ruc_buf_area_lookup(ptr);
+  if (area == NULL) {
+    free(ptr);
+    return;
+  }
+  switch (area->mem) {
+    case RUC_BUF_MEM_SHM:
+    case RUC_BUF_MEM_SHM_HUGETLB:
+      shmdt(ptr);
+      break;
+    default:
+      munmap(ptr, area->size);
+      break;
+  }
+  memset(area,0,sizeof(ruc_buf_area_t));
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Get the kind of memory of a payload area
+*
+* @param ptr       the payload area
+* @param node      returns the NUMA node the area is bound to or -1
+*
+* @retval the memory kind
+*/
+ruc_buf_mem_e ruc_buf_payload_mem(void * ptr, int * node) {
+  ruc_buf_area_t * area = NULL;
+
+  if (ptr != NULL) area = ruc_buf_area_lookup(ptr);
+  if (area == NULL) {
+    *node = -1;
+    return RUC_BUF_MEM_MALLOC;
+  }
+  *node = area->node;
+  return area->mem;
+}
+
 
 /*
 **__________________________________________________________
@@ -129,7 +292,25 @@ void * ruc_buf_poolCreate_shared(uint32_t nbBuf, uint32_t bufsize, key_t key/*,r
   int page_count = size/MB_2;
   if (size%MB_2 != 0) page_count+=1;
   int allocated_size = page_count*MB_2;
-  if ((shmid = shmget(key, allocated_size, IPC_CREAT/*|SHM_HUGETLB */| 0666 )) < 0) {
+  ruc_buf_mem_e mem = RUC_BUF_MEM_SHM;
+  shmid = -1;
+  if (common_config.buffer_hugepage) {
+    shmid = shmget(key, allocated_size, IPC_CREAT|SHM_HUGETLB| 0666 );
+    if (shmid < 0) {
+      /*
+      ** Not enough huge pages reserved: use standard pages
+      */
+      warning("ruc_buf_poolCreate_shared no huge page for %d bytes %s",allocated_size,strerror(errno));
+      ruc_buf_mem_stats.fallback_count++;
+      ruc_buf_mem_stats.fallback_bytes += allocated_size;
+    }
+    else {
+      mem = RUC_BUF_MEM_SHM_HUGETLB;
+      ruc_buf_mem_stats.hugetlb_count++;
+      ruc_buf_mem_stats.hugetlb_bytes += allocated_size;
+    }
+  }
+  if ((shmid < 0) && ((shmid = shmget(key, allocated_size, IPC_CREAT| 0666 )) < 0)) {
       fatal("ruc_buf_poolCreate_shared :shmget %s %d",strerror(errno),allocated_size);
       return (ruc_obj_desc_t*)NULL;
   }
@@ -145,6 +326,12 @@ void * ruc_buf_poolCreate_shared(uint32_t nbBuf, uint32_t bufsize, key_t key/*,r
     ruc_listDelete_shared((ruc_obj_desc_t*)poolRef);
     return (ruc_obj_desc_t*)NULL;
   }
+  /*
+  ** The policy of a shared memory segment applies to every process that
+  ** attaches it
+  */
+  ruc_buf_area_record(pusrData, allocated_size, mem,
+                      rozofs_numa_bind_memory(pusrData, allocated_size, (mem!=RUC_BUF_MEM_SHM_HUGETLB)));
    /*
    ** store the pointer address on the head
    */
@@ -45,6 +45,59 @@ extern uint32_t ruc_buffer_trace ;
 
 void * ruc_buf_poolCreate_shared(uint32_t nbBuf,uint32_t bufsize,key_t key);
 
+/*
+** Memory backing the payload of a buffer pool
+*/
+typedef enum _ruc_buf_mem_e {
+  RUC_BUF_MEM_MALLOC=0,     /**< posix_memalign (small pools)            */
+  RUC_BUF_MEM_THP,          /**< mmap with transparent huge pages advice  */
+  RUC_BUF_MEM_HUGETLB,      /**< mmap on explicit 2MB huge pages          */
+  RUC_BUF_MEM_SHM,          /**< shared memory                            */
+  RUC_BUF_MEM_SHM_HUGETLB,  /**< shared memory on explicit 2MB huge pages */
+} ruc_buf_mem_e;
+
+typedef struct _ruc_buf_mem_stats_t {
+  uint64_t  hugetlb_count;   /**< areas on explicit huge pages               */
+  uint64_t  hugetlb_bytes;
+  uint64_t  fallback_count;  /**< areas that could not get explicit huge pages */
+  uint64_t  fallback_bytes;
+  uint64_t  numa_count;      /**< areas bound to the NUMA node of the process */
+} ruc_buf_mem_stats_t;
+
+extern ruc_buf_mem_stats_t ruc_buf_mem_stats;
+
+/*__________________________________________________________________________
+*/
+/**
+*  Allocate the payload area of a buffer pool. Large areas are rounded to
+*  huge pages, taken on explicit huge pages when buffer_hugepage is
+*  configured, and bound to the NUMA node of the process.
+*
+* @param size      requested size
+*
+* @retval the payload area or NULL when out of memory
+*/
+void * ruc_buf_payload_alloc(size_t size);
+/*__________________________________________________________________________
+*/
+/**
+*  Release the payload area of a buffer pool
+*
+* @param ptr       the payload area
+*/
+void ruc_buf_payload_free(void * ptr);
+/*__________________________________________________________________________
+*/
+/**
+*  Get the kind of memory of a payload area
+*
+* @param ptr       the payload area
+* @param node      returns the NUMA node the area is bound to or -1
+*
+* @retval the memory kind
+*/
+ruc_buf_mem_e ruc_buf_payload_mem(void * ptr, int * node);
+
 // 64BITS uint32_t ruc_buf_poolCreate(uint32_t nbBuf,uint32_t bufsize);
 static inline void * ruc_buf_poolCreate(uint32_t nbBuf,uint32_t bufsize);
 // 64BITS uint32_t ruc_buf_poolDelete(uint32_t poolRef);
@@ -128,7 +181,6 @@ static inline void * ruc_buf_poolCreate(uint32_t nbBuf,uint32_t bufsize)
   char *pusrData;
   char *pBufCur;
   ruc_buf_t  *p;
-  int huge_page = 0;
 
   
    RUC_BUF_TRC("buf_poolCreate",nbBuf,bufsize,-1,-1);
@@ -185,22 +237,10 @@ static inline void * ruc_buf_poolCreate(uint32_t nbBuf,uint32_t bufsize)
     }
   }
   /*
-  ** check for hugepage
+  ** allocate the payload on huge pages when large enough
   */
-  size_t alloc_size = bufsize*nbBuf;
-#if 1
-  if (alloc_size > ROZOFS_HUGE_PAGE_SIZE)
-  {
-     int count = alloc_size/ROZOFS_HUGE_PAGE_SIZE;
-     if (alloc_size%ROZOFS_HUGE_PAGE_SIZE)
-     {
-       count+=1;
-     }
-     alloc_size = ROZOFS_HUGE_PAGE_SIZE*count;
-     huge_page = 1;  
-  }
-#endif
-   if (posix_memalign((void**)&pusrData,4096,alloc_size))
+   pusrData = ruc_buf_payload_alloc((size_t)bufsize*nbBuf);
+   if (pusrData == NULL)
    {
      /*
      **  out of memory, free the pool
@@ -209,12 +249,6 @@ static inline void * ruc_buf_poolCreate(uint32_t nbBuf,uint32_t bufsize)
      ruc_listDelete((ruc_obj_desc_t*)poolRef);
      return NULL;
    }
-    if (huge_page) {
-#ifdef MADV_HUGEPAGE
-        madvise(pusrData, alloc_size, MADV_HUGEPAGE);
-#endif
-    }
-    memset(pusrData,0,alloc_size);
    /*
    ** store the pointer address on the head
    */
@@ -268,7 +302,7 @@ static inline uint32_t ruc_buf_poolDelete(void * poolRef)
    /*
    **  free the usrData part of the pool
    */
-   free ((char*)p->ptr);
+   ruc_buf_payload_free(p->ptr);
    /*
    **  free the buffer list
    */
@@ -320,6 +354,30 @@ static inline void *ruc_buf_get_pool_base_data(void * poolRef)
   }
   return p->ptr;
 }
+/**
+*  that service returns the length of the user data array of a pool
+
+  @param poolRef : pointer to the pool 
+  
+  @retval 0 if it is not a pool
+  @retval <>0 : length of the user data array
+*/
+static inline uint32_t ruc_buf_get_pool_data_len(void * poolRef)
+{
+  ruc_buf_t *p;
+
+  p = (ruc_buf_t*)poolRef;
+
+  if (p->type != BUF_POOL_HEAD)
+  {
+    /*
+    **  not a buffer pool reference
+    */
+    RUC_WARNING(p->type);
+    return 0;
+  }
+  return p->len;
+}
 
 
 // 64BITS uint32_t ruc_buf_getBuffer(uint32_t poolRef)
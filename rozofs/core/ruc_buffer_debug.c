@@ -19,6 +19,7 @@
 #include <errno.h>
 #include <rozofs/core/ruc_buffer_debug.h>
 #include <rozofs/common/log.h> 
+#include <rozofs/common/common_config.h>
 
 #define RUC_BUFFER_DEBUG_2ND_ENTRIES_NB   16
 #define RUC_BUFFER_DEBUG_1RST_ENTRIES_NB  16
@@ -40,13 +41,35 @@ static int                      ruc_registered_buffer_pool_entries=0;
 * @param displayName  Name of the buffer pool (for display)
 * @param p            Where to format the output 
 */
+static char * ruc_buf_mem_name[] = {"malloc", "thp", "hugetlb", "shm", "shm-huge"};
+
 static inline char * ruc_buf_poolDisplay(ruc_buf_t* poolRef, char * displayName, char * p)
 {
-  p += sprintf(p, "%20s - user data addr/len %16p /%9d - nb buff %3d/%3d size %6d\n",displayName,
+  int node;
+  ruc_buf_mem_e mem = ruc_buf_payload_mem(poolRef->ptr, &node);
+
+  p += sprintf(p, "%20s - user data addr/len %16p /%9d - nb buff %3d/%3d size %6d - %-8s node %2d\n",displayName,
                poolRef->ptr, poolRef->len,
-               poolRef->usrLen, poolRef->bufCount, poolRef->len/poolRef->bufCount);
+               poolRef->usrLen, poolRef->bufCount, poolRef->len/poolRef->bufCount,
+               ruc_buf_mem_name[mem], node);
   return p;	       
 }
+/*
+**__________________________________________________________
+* Format the huge page status of the buffer pools
+* @param p            Where to format the output 
+*/
+static inline char * ruc_buf_memDisplay(char * p)
+{
+  p += sprintf(p, "huge pages %s - hugetlb %llu areas/%llu MB - fallback %llu areas/%llu MB - numa bound %llu areas\n",
+               common_config.buffer_hugepage?"configured":"not configured",
+               (unsigned long long)ruc_buf_mem_stats.hugetlb_count,
+               (unsigned long long)(ruc_buf_mem_stats.hugetlb_bytes/(1024*1024)),
+               (unsigned long long)ruc_buf_mem_stats.fallback_count,
+               (unsigned long long)(ruc_buf_mem_stats.fallback_bytes/(1024*1024)),
+               (unsigned long long)ruc_buf_mem_stats.numa_count);
+  return p;
+}
 
 /*
 **__________________________________________________________
@@ -183,7 +206,7 @@ void show_ruc_buffer_debug(char * argv[], uint32_t tcpRef, void *bufRef) {
     return;
   }
 
-  
+  pChar = ruc_buf_memDisplay(pChar);
   for (idx1=0; idx1<RUC_BUFFER_DEBUG_1RST_ENTRIES_NB; idx1++) {
   
     if (ruc_registered_buffer_pool[idx1] == NULL) break;
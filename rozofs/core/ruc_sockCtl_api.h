@@ -154,6 +154,14 @@ static inline void ruc_sockCtrl_attach_applicative_poller(ruc_scheduler_t callba
   @param int fd : file descriptor to clear
 */
 void ruc_sockCtrl_clear_rcv_bit(int fd);
+/**
+* Request a call of the receive callback of a socket on the next loop of the
+  socket controller, even when no data is pending in the socket. Used by the
+  receivers that keep bytes already read from the socket.
+
+  @param int fd : file descriptor of the socket
+*/
+void ruc_sockCtrl_set_rcv_pending(int fd);
  /*
  **_______________________________________________________________
  */
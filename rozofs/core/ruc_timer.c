@@ -57,6 +57,15 @@ static uint	timer_slot_size_mask;	        /* size -1 */
 static uint	timer_slot_size_2n;	        /* size in 2^n */
 static uint	timer_system_tick;		/* value of the system tick */
 static uint	ruc_timer_modulo;		/* for periodic timer       */
+static uint64_t	timer_hand_ticks;		/* ticks since the start    */
+
+/*
+** The slot table is a hierarchical timing wheel: a cell is chained in the
+** level 0 when it expires within timer_slot_size ticks, in the level 1 when
+** it expires within timer_slot_size^2 ticks... When a level wraps, the
+** current slot of the upper level is cascaded in the lower levels.
+*/
+#define RUC_TIMER_LEVEL_NB  3
 
 			/* Current hand clock position */
 
@@ -78,6 +87,7 @@ struct timer_cell 	 *rucTmr_p_cell_new = P_NIL;
 
 static void timer_insert (struct timer_cell  *p_cell, 
 		   ulong to_val);
+static void timer_link (struct timer_cell  *p_cell);
 
 
 
@@ -166,6 +176,7 @@ void  ruc_timer_init (TIMER_TICK_VALUE_E timer_application_tick,
                /* Timer cell initialization */
         ruc_timer_modulo 		        = 0;  /* for periodic timer only */
         timer_x_hand_clock                      = 0;
+        timer_hand_ticks                        = 0;
         timer_slot_size                         = timer_slot_size1;
         timer_slot_size_mask                    = timer_slot_size - 1;
 	
@@ -185,10 +196,11 @@ void  ruc_timer_init (TIMER_TICK_VALUE_E timer_application_tick,
 
 
         if ((p_timer_slot = (struct timer_head *)malloc (
-			   	(timer_slot_size * sizeof (struct timer_head)))) == P_NIL) {
+			   	(RUC_TIMER_LEVEL_NB * timer_slot_size * sizeof (struct timer_head)))) == P_NIL) {
                 printf( "\n timer init error : malloc \n");
+                return;
         }
-	memset((char*)p_timer_slot,0,(size_t)(timer_slot_size * sizeof (struct timer_head)));
+	memset((char*)p_timer_slot,0,(size_t)(RUC_TIMER_LEVEL_NB * timer_slot_size * sizeof (struct timer_head)));
 
 
 }
@@ -507,7 +519,6 @@ static void timer_insert (struct timer_cell  *p_cell, /* address of the cell */
    
 {
 	ulong delta;
-	ulong nb;
 #if 0
     printf ("!! timer_insert to_val=%d\n",(int)to_val);
 #endif
@@ -518,21 +529,49 @@ static void timer_insert (struct timer_cell  *p_cell, /* address of the cell */
         if (delta == 0)
           delta = 1;
 
-	if (delta > timer_slot_size) {
-		 /*
-		       	'delta' is beyond the nb of slots :
-		       	Chain the cell in the slot given by modulo timer_slot_size ,
-		       	and add in cell nb of
-	       	*/
-		Cell_x_head = (timer_x_hand_clock + ( delta & (timer_slot_size_mask)));
-		nb = (delta >> timer_slot_size_2n) ; /*  modulo #  */
-
-	} else {
-	        Cell_x_head = (timer_x_hand_clock  + delta) ;
-		nb = 0 ;
+	Cell_to_tick = timer_hand_ticks + delta;
+	timer_link (p_cell);
+}
+
+/*--------------------------------------------------------------------------*
+					 F U N C T I O N   H E A D E R
+
+Name            timer_link - chains a cell in the slot of the wheel level
+				corresponding to its time-out tick.
+
+Usage           timer_link (struct timer_cell  *p_cell);
+
+Return value    void
+
+Related
+functions		called by timer_insert() and by timer_process()
+		       	when a slot of an upper level is cascaded.
+
+*--------------------------------------------------------------------------*/
+
+static void timer_link (struct timer_cell  *p_cell) /* address of the cell */
+{
+	uint64_t diff;
+	uint64_t tick;
+	uint     level;
+
+	tick = Cell_to_tick;
+	diff = (tick > timer_hand_ticks) ? (tick - timer_hand_ticks) : 0;
+
+	for (level = 0; level < RUC_TIMER_LEVEL_NB; level++) {
+		if ((diff >> (timer_slot_size_2n*(level+1))) == 0) break;
 	}
-	Cell_x_head &= timer_slot_size_mask ;
-	Cell_to_mod_nb	= nb;   /* update modulo nb */
+	if (level == RUC_TIMER_LEVEL_NB) {
+		/*
+			'diff' is beyond the wheel :
+			Chain the cell in the farthest slot of the upper level,
+			it is chained again when this slot is cascaded
+		*/
+		level = RUC_TIMER_LEVEL_NB - 1;
+		tick  = timer_hand_ticks + (1ULL << (timer_slot_size_2n*RUC_TIMER_LEVEL_NB)) - 1;
+	}
+	Cell_x_head = level * timer_slot_size
+	            + ((tick >> (timer_slot_size_2n*level)) & timer_slot_size_mask);
 
 	/* Insert the cell into the top of the thread */
 
@@ -577,6 +616,8 @@ void ruc_timer_process ()
     /* local variable definition */
 
     struct timer_cell 	 *  p_cell;   	/* temporary timer cell pointer */
+    uint                    level;
+    uint                    x_head;
 
     
 	/* Lock the shared data */
@@ -596,10 +637,28 @@ void ruc_timer_process ()
         rucTmr_p_cell_new = P_NIL;
 
 	
-	if (++timer_x_hand_clock == timer_slot_size) 
+	timer_hand_ticks++;
+	timer_x_hand_clock = timer_hand_ticks & timer_slot_size_mask;
+
+        /*
+        ** When a level wraps, chain again the cells of the current
+        ** slot of the upper level in the lower levels
+        */
+        for (level = 1; level < RUC_TIMER_LEVEL_NB; level++)
         {
-	    timer_x_hand_clock = 0;
-	}
+          if ((timer_hand_ticks & ((1ULL << (timer_slot_size_2n*level)) - 1)) != 0) break;
+          x_head = level * timer_slot_size
+                 + ((timer_hand_ticks >> (timer_slot_size_2n*level)) & timer_slot_size_mask);
+          p_cell = Head_first (x_head);
+          Head_first (x_head) = P_NIL;
+          while (p_cell != P_NIL)
+          {
+            rucTmr_p_cell_new = Cell_next;
+            timer_link (p_cell);
+            p_cell = rucTmr_p_cell_new;
+          }
+          rucTmr_p_cell_new = P_NIL;
+        }
 #if 0
 
     printf ("!! timer_process timer_x_hand_clock=%d\n",timer_x_hand_clock);
@@ -625,10 +684,10 @@ void ruc_timer_process ()
             {
 	      rucTmr_p_cell_new = Cell_next;
 #if 0
-              printf("pfirst 0x%x p_cell: %x pnext: 0x%x pprev: 0x%x nb = %d\n",Head_first (timer_x_hand_clock),p_cell,p_cell->p_next,p_cell->p_prior,p_cell->to_mod_nb);
+              printf("pfirst 0x%x p_cell: %x pnext: 0x%x pprev: 0x%x tick = %llu\n",Head_first (timer_x_hand_clock),p_cell,p_cell->p_next,p_cell->p_prior,(unsigned long long)p_cell->to_tick);
 #endif
 		
-	      if (Cell_to_mod_nb== 0) 
+	      if (Cell_to_tick <= timer_hand_ticks) 
               {    
 		/* 
                 ** This timer will expire during the current tick
@@ -686,24 +745,6 @@ void ruc_timer_process ()
                  */
                  rucTmr_curCellProcess = P_NIL;
 		    
-	      }
-	      else
-	      {
-		Cell_to_mod_nb--;
-#if 0
-	    	/* 
-                ** Insert the cell into the top of the thread 
-                */
-	        Cell_next	= Head_first (Cell_x_head);
-		Cell_prior	= P_NIL;
-
-		if (Head_first (Cell_x_head) != P_NIL) 
-                {
-		  Prior (Head_first (Cell_x_head)) = (struct timer_cell  *)p_cell;
-		}
-		Head_first (Cell_x_head) = (struct timer_cell  *)p_cell;
-#endif
-
 	      }
 		
               /* Next cell */
@@ -179,7 +179,7 @@ struct timer_event{
 struct timer_cell {
      struct timer_cell  *p_next;    	/* pointer to next cell */
      struct timer_cell  *p_prior;	/* pointer to prior cell */
-     unsigned int 	 to_mod_nb;    /* modulo nb when the time-out will fail */
+     uint64_t 	 to_tick;      /* tick when the time-out will fail */
      unsigned int 	 x_timer_head;	/* index in the timer_head table */
      int		period_flag;    /* ON if the timer is periodic */
   void (*p_fct_api) (void);       /* pointer to the application API */
@@ -199,7 +199,7 @@ struct timer_cell {
 
 #define Cell_next	    ((struct timer_cell  *)p_cell) -> p_next
 #define Cell_prior	    ((struct timer_cell  *)p_cell) -> p_prior
-#define Cell_to_mod_nb      ((struct timer_cell  *)p_cell) -> to_mod_nb
+#define Cell_to_tick        ((struct timer_cell  *)p_cell) -> to_tick
 #define Cell_x_head	    ((struct timer_cell  *)p_cell) -> x_timer_head
 #define Cell_period_flag    ((struct timer_cell  *)p_cell) -> period_flag
 #define Cell_app_id	    ((struct timer_cell  *)p_cell) -> app_id
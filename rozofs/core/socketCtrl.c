@@ -25,7 +25,9 @@
 #include <sys/time.h>
 #include <sys/socket.h>
 #include <sys/resource.h>
+#include <sys/epoll.h>
 #include <rozofs/common/log.h>
+#include <rozofs/common/common_config.h>
 
 #include "ruc_list.h"
 #include "socketCtrl.h"
@@ -115,6 +117,27 @@ int ruc_sockCtrl_max_poll_ctx = 0;
 ruc_obj_desc_t *ruc_sockctl_poll_pnextCur;
 uint64_t ruc_sockCtrl_poll_period = 0;   /**< period in microseconds */ 
 uint64_t ruc_sockCtrl_nr_socket_stats[ROZO_FD_SETSIZE];
+/*
+** epoll engine: the sockets with an unconditional receive stay registered
+** in epoll, so only the conditional sockets are walked on each loop
+*/
+#define RUC_SOCKCTL_EPOLL_EVENTS 512
+int      ruc_sockCtrl_epoll_fd = -1;
+uint32_t ruc_sockCtrl_epoll_mask[ROZO_FD_SETSIZE];  /**< events registered in epoll per socket (0: not registered) */
+struct epoll_event ruc_sockCtrl_epoll_events[RUC_SOCKCTL_EPOLL_EVENTS];
+int      ruc_sockCtrl_epoll_count = 0;              /**< number of events returned by the last epoll_wait */
+uint64_t ruc_sockCtrl_epoll_ctl_count = 0;
+/*
+** sockets whose receive callback must be called on the next loop although
+** their socket may be empty (bytes already read and kept by the receiver).
+** While some are pending, the wait for events is limited to 1 ms.
+*/
+#define RUC_SOCKCTL_RCV_PENDING_TMO_US 1000
+rozo_fd_set  sockCtrl_rcv_pending;
+int      ruc_sockCtrl_rcv_pending_count = 0;
+int      socket_rcv_pending_count = 0;
+int      socket_rcv_pending_table[ROZO_FD_SETSIZE];
+uint64_t ruc_sockCtrl_rcv_pending_calls = 0;
 
 
 static char    myBuf[UMA_DBG_MAX_SEND_SIZE];
@@ -237,6 +260,95 @@ void ruc_sockCtrl_remove_socket(int *sock_table_p,int nb_sockets,int socket_id)
    }
 }
 
+/*
+**____________________________________________________________________________
+*/
+/**
+*  Set the events a socket waits for in the epoll engine
+
+   @param fd : socket identifier
+   @param events : EPOLLIN and/or EPOLLOUT, 0 to unregister the socket
+*/
+static void ruc_sockCtrl_epoll_set(int fd, uint32_t events)
+{
+   struct epoll_event ev;
+   int                ret;
+   uint32_t           cur = ruc_sockCtrl_epoll_mask[fd];
+
+   if (cur == events) return;
+
+   ruc_sockCtrl_epoll_ctl_count++;
+   ruc_sockCtrl_epoll_mask[fd] = events;
+   if (events == 0)
+   {
+     /*
+     ** the socket may already be closed
+     */
+     epoll_ctl(ruc_sockCtrl_epoll_fd,EPOLL_CTL_DEL,fd,&ev);
+     return;
+   }
+
+   memset(&ev,0,sizeof(ev));
+   ev.events  = events;
+   ev.data.fd = fd;
+   ret = epoll_ctl(ruc_sockCtrl_epoll_fd,(cur==0)?EPOLL_CTL_ADD:EPOLL_CTL_MOD,fd,&ev);
+   if (ret == 0) return;
+   /*
+   ** a closed socket has been removed from epoll, or a socket identifier
+   ** has been reused before its disconnection
+   */
+   if (errno == ENOENT) ret = epoll_ctl(ruc_sockCtrl_epoll_fd,EPOLL_CTL_ADD,fd,&ev);
+   else if (errno == EEXIST) ret = epoll_ctl(ruc_sockCtrl_epoll_fd,EPOLL_CTL_MOD,fd,&ev);
+   if (ret < 0)
+   {
+     severe("epoll_ctl(%d,%x) %s",fd,events,strerror(errno));
+     ruc_sockCtrl_epoll_mask[fd] = 0;
+   }
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+* update the events a socket with unconditional receive waits for in
+* the epoll engine
+ 
+  @param fd : socket identifier
+*/
+void ruc_sockCtrl_epoll_update(int fd)
+{
+   ruc_sockObj_t *p;
+   uint32_t       events;
+
+   if ((fd < 0) || (fd >= ROZO_FD_SETSIZE)) return;
+   p = socket_ctx_table[fd];
+   /*
+   ** conditional sockets are updated on each loop
+   */
+   if ((p == NULL) || (p->priority < RUC_SOCKCTL_MAXPRIO)) return;
+
+   events = EPOLLIN;
+   if (FD_ISSET(fd,&rucWrFdSetCongested)) events |= EPOLLOUT;
+   ruc_sockCtrl_epoll_set(fd,events);
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+*  Remove a socket from the epoll engine and from the pending events
+
+   @param fd : socket identifier
+*/
+static void ruc_sockCtrl_epoll_remove(int fd)
+{
+   int i;
+
+   ruc_sockCtrl_epoll_set(fd,0);
+   for (i = 0; i < ruc_sockCtrl_epoll_count; i++)
+   {
+     if (ruc_sockCtrl_epoll_events[i].data.fd == fd) ruc_sockCtrl_epoll_events[i].data.fd = -1;
+   }
+}
+
 /*
 **   D E B U G 
 */
@@ -285,7 +397,18 @@ void ruc_sockCtrl_debug_show(uint32_t tcpRef, void * bufRef) {
   uint32_t          average;
 
   p = ruc_sockCtrl_pFirstCtx;
+  pChar += sprintf(pChar,"socket controller engine : %s\n",(ruc_sockCtrl_epoll_fd<0)?"select":"epoll");
+  if (ruc_sockCtrl_epoll_fd >= 0) {
+    pChar += rozofs_string_append(pChar,"epoll_ctl calls          : ");
+    pChar += rozofs_u64_append(pChar ,ruc_sockCtrl_epoll_ctl_count);
+    *pChar++ = '\n';
+    ruc_sockCtrl_epoll_ctl_count = 0;
+  }
   pChar += sprintf(pChar,"speculative scheduler    :%s\n",(ruc_sockCtrl_speculative_sched_enable==0)?" Disabled":" Enabled");
+  pChar += rozofs_string_append(pChar,"receive pending calls    : ");
+  pChar += rozofs_u64_append(pChar ,ruc_sockCtrl_rcv_pending_calls);
+  *pChar++ = '\n';
+  ruc_sockCtrl_rcv_pending_calls = 0;
   pChar += rozofs_string_append(pChar,"conditional sockets      : ");
   pChar += rozofs_u32_append(pChar ,ruc_sockCtrl_max_nr_select);
   *pChar++ = '\n';
@@ -510,6 +633,8 @@ void ruc_sockCtrl_conf(char * argv[], uint32_t tcpRef, void * bufRef) {
     uma_dbg_send(tcpRef, bufRef, TRUE, myBuf);
     return;
   }
+  pChar +=sprintf(pChar,"socket controller engine                 : %s\n",
+          (ruc_sockCtrl_epoll_fd<0)?"select":"epoll");
   pChar +=sprintf(pChar,"speculative scheduler                    : %s\n",
           (ruc_sockCtrl_speculative_sched_enable==1)?" Enable":" Disable");
   pChar +=sprintf(pChar,"max number of socket controller contexts : %u\n",ruc_sockCtrl_maxConnection);
@@ -689,6 +814,8 @@ uint32_t ruc_sockctl_init(uint32_t maxConnection)
   */
   memset(&rucRdFdSet,0,sizeof(rucRdFdSet));
   memset(&sockCtrl_speculative,0,sizeof(sockCtrl_speculative));
+  memset(&sockCtrl_rcv_pending,0,sizeof(sockCtrl_rcv_pending));
+  ruc_sockCtrl_rcv_pending_count = 0;
   memset(&rucWrFdSet,0,sizeof(rucWrFdSet));   
   memset(&rucRdFdSetUnconditional,0,sizeof(rucRdFdSetUnconditional));   
   memset(&rucWrFdSetCongested,0,sizeof(rucWrFdSetCongested));   
@@ -701,6 +828,16 @@ uint32_t ruc_sockctl_init(uint32_t maxConnection)
   ruc_sockctl_poll_pnextCur = NULL;
   ruc_sockCtrl_poll_period = RUC_SOCKCTL_POLLFREQ; /** period of 40 ms */
   memset(ruc_sockCtrl_nr_socket_stats,0,sizeof(uint64_t)*ROZO_FD_SETSIZE);
+  memset(ruc_sockCtrl_epoll_mask,0,sizeof(uint32_t)*ROZO_FD_SETSIZE);
+  /*
+  ** select the engine
+  */
+  if (common_config.sockctrl_epoll) {
+    ruc_sockCtrl_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (ruc_sockCtrl_epoll_fd < 0) {
+      severe("epoll_create1 %s. Using select engine.",strerror(errno));
+    }
+  }
   /*
   ** create the connection distributor
   */
@@ -864,6 +1001,10 @@ void * ruc_sockctl_connect(int socketId,
   */
   socket_ctx_table[pelem->socketId] = pelem;
   /*
+  ** the receive is unconditional: register the socket in epoll once for all
+  */
+  if (ruc_sockCtrl_epoll_fd >= 0) ruc_sockCtrl_epoll_update(pelem->socketId);
+  /*
   ** set the socket ready for receiving by default
   */ 
   return (pelem);
@@ -927,12 +1068,15 @@ uint32_t ruc_sockctl_disconnect(void * connectionId)
      */
      FD_CLR(p->socketId,&rucRdFdSet);     
      FD_CLR(p->socketId,&sockCtrl_speculative);     
+     FD_CLR(p->socketId,&sockCtrl_rcv_pending);     
      FD_CLR(p->socketId,&rucWrFdSet);
      FD_CLR(p->socketId,&rucRdFdSetUnconditional);
      FD_CLR(p->socketId,&rucWrFdSetCongested);
 
      ruc_sockCtrl_remove_socket(socket_recv_table,socket_recv_count,p->socketId);
      ruc_sockCtrl_remove_socket(socket_xmit_table,socket_xmit_count,p->socketId);
+     ruc_sockCtrl_remove_socket(socket_rcv_pending_table,socket_rcv_pending_count,p->socketId);
+     if (ruc_sockCtrl_epoll_fd >= 0) ruc_sockCtrl_epoll_remove(p->socketId);
      socket_ctx_table[p->socketId] = NULL;
      socket_predictive_ctx_table[p->socketId] = NULL;
      socket_predictive_ctx_table_count[p->socketId] = 0; 
@@ -1134,6 +1278,60 @@ static inline void ruc_sockCtl_checkRcvAndXmitBits(int nbrSelect)
   ruc_time_receive += (cycles_after - cycles_before);
   ruc_count_receive++;
 }
+/*
+**____________________________________________________________________________
+*/
+/**
+* Request a call of the receive callback of a socket on the next loop of the
+  socket controller, even when no data is pending in the socket. Used by the
+  receivers that keep bytes already read from the socket.
+
+  @param int fd : file descriptor of the socket
+*/
+void ruc_sockCtrl_set_rcv_pending(int fd)
+{
+  if (fd < 0) return;
+  if (FD_ISSET(fd,&sockCtrl_rcv_pending)) return;
+  FD_SET(fd,&sockCtrl_rcv_pending);
+  ruc_sockCtrl_rcv_pending_count++;
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+*  Call the receive callback of the sockets that have requested it. A socket
+   whose receiver is not ready stays pending.
+*/
+static inline void ruc_sockCtl_rcv_pending_dispatch()
+{
+  int i;
+  ruc_sockObj_t *p;
+  int socketId;
+
+  if (ruc_sockCtrl_rcv_pending_count == 0) return;
+
+  socket_rcv_pending_count = ruc_sockCtrl_build_sock_table((uint64_t *)&sockCtrl_rcv_pending,socket_rcv_pending_table,
+                                                           ruc_sockCtrl_rcv_pending_count);
+  memset(&sockCtrl_rcv_pending,0,sizeof(sockCtrl_rcv_pending));
+  ruc_sockCtrl_rcv_pending_count = 0;
+
+  for (i = 0; i <socket_rcv_pending_count ; i++)
+  {
+    socketId = socket_rcv_pending_table[i];
+    if (socketId == -1) continue;
+    p = socket_ctx_table[socketId];
+    if (p == NULL) continue;
+    if ((*((p->callBack)->isRcvReadyFunc))(p->objRef,p->socketId) != TRUE)
+    {
+      ruc_sockCtrl_set_rcv_pending(socketId);
+      continue;
+    }
+    ruc_sockCtrl_rcv_pending_calls++;
+    p->rcvCount++;
+    (*((p->callBack)->msgInFunc))(p->objRef,p->socketId);
+  }
+  socket_rcv_pending_count = 0;
+}
 
 /*
 **____________________________________________________________________________
@@ -1426,6 +1624,205 @@ static inline void ruc_sockCtl_prepareRcvAndXmitBits()
   ruc_count_prepare++;
   
 }
+/*
+**____________________________________________________________________________
+*/
+/**
+*  epoll engine: ask the conditional sockets whether they are ready to
+*  receive or to transmit and update their epoll registration accordingly.
+*  The sockets with an unconditional receive are not walked.
+*/
+static inline void ruc_sockCtl_epoll_prepare()
+{
+
+  int i;
+  ruc_sockObj_t *p;
+  uint32_t events;
+  int polling_cnt = 2;
+  
+  uint64_t time_before,time_after;
+  ruc_sockCtrl_nb_socket_conditional = 0;
+
+  time_before = rdtsc();
+
+  for (i = 0; i <RUC_SOCKCTL_MAXPRIO ; i++)
+  {
+    ruc_sockctl_pnextCur = (ruc_obj_desc_t*)NULL;
+    ruc_sockctl_prioIdxCur = RUC_SOCKCTL_MAXPRIO-1-i;
+
+    while ((p = (ruc_sockObj_t*)
+              ruc_objGetNext((ruc_obj_desc_t*)&ruc_sockCtl_tabPrio[RUC_SOCKCTL_MAXPRIO-1-i],
+                             &ruc_sockctl_pnextCur))!=(ruc_sockObj_t*)NULL) 
+    {
+      ruc_sockCtrl_nb_socket_conditional++;
+#if APP_POLLING
+      if ((polling_cnt!=0)&& (ruc_applicative_poller != NULL))
+      {
+        polling_cnt -=1;
+	ruc_applicative_poller_count++;
+	uint64_t cycles_start = rdtsc();  	
+	(*ruc_applicative_poller)(0);
+        ruc_applicative_poller_cycles += (rdtsc() - cycles_start);
+      }
+#endif
+      events = 0;
+      if ((*((p->callBack)->isRcvReadyFunc))(p->objRef,p->socketId) == TRUE)  events |= EPOLLIN;
+      if ((*((p->callBack)->isXmitReadyFunc))(p->objRef,p->socketId) == TRUE) events |= EPOLLOUT;
+      ruc_sockCtrl_epoll_set(p->socketId,events);
+    }
+  }
+  time_after = rdtsc();
+  ruc_time_prepare += (time_after - time_before);
+  ruc_count_prepare++;
+  
+}
+/*
+**____________________________________________________________________________
+*/
+/**
+*  epoll engine: process the events returned by epoll_wait by decreasing
+*  priority. The sockets with an unconditional receive come first.
+
+   @param nbEvents : number of events returned by epoll_wait
+*/
+static inline void ruc_sockCtl_epoll_dispatch(int nbEvents)
+{
+
+  int i,prio;
+  ruc_sockObj_t *p;
+  ruc_sockCallBack_t *pcallBack;
+  int socketId;
+  uint32_t events;
+  int speculative_count = 0;
+  struct timeval     timeDay;
+  unsigned long long timeBefore, timeAfter;
+  uint64_t  ruc_applicative_poller_ticker = rozofs_ticker_microseconds;
+  uint64_t cycles_before;
+
+  timeBefore = 0;
+  timeAfter  = 0;
+  ruc_sockCtrl_epoll_count = nbEvents;
+
+  if (ruc_applicative_poller != NULL)
+  {
+	ruc_applicative_poller_count++;
+	uint64_t cycles_start = rdtsc();  	
+	(*ruc_applicative_poller)(0);
+        ruc_applicative_poller_cycles += (rdtsc() - cycles_start);
+  }
+  ruc_applicative_poller_ticker +=1;
+
+  cycles_before = rdtsc();
+  /*
+  ** case of the speculative scheduler
+  */
+  if (ruc_sockCtrl_speculative_sched_enable)
+  {
+    speculative_count= ruc_sockCtrl_speculative_count;
+    if (speculative_count > 0)
+    {
+      speculative_count = ruc_sockCtrl_build_sock_table((uint64_t *)&sockCtrl_speculative,socket_speculative_table,speculative_count);
+    }
+    if (ruc_sockCtrl_max_speculative < speculative_count) ruc_sockCtrl_max_speculative = speculative_count;
+  }
+  ruc_time_receive += (rdtsc() - cycles_before);
+  ruc_count_receive++;
+
+  for (prio = RUC_SOCKCTL_MAXPRIO; prio >= 0; prio--)
+  {
+    for (i = 0; i < nbEvents; i++)
+    {
+      socketId = ruc_sockCtrl_epoll_events[i].data.fd;
+      if (socketId == -1) continue;
+      p = socket_ctx_table[socketId];
+      if (p == NULL) 
+      {
+        ruc_sockCtrl_epoll_events[i].data.fd = -1;
+        continue;
+      }
+      if (((p->priority < RUC_SOCKCTL_MAXPRIO)?p->priority:RUC_SOCKCTL_MAXPRIO) != prio) continue;
+      /*
+      ** the event is consumed
+      */
+      ruc_sockCtrl_epoll_events[i].data.fd = -1;
+      events = ruc_sockCtrl_epoll_events[i].events;
+      pcallBack = p->callBack;
+
+      if ((ruc_sockCtrl_epoll_mask[socketId] & EPOLLIN) && (events & (EPOLLIN|EPOLLHUP|EPOLLERR)))
+      {
+        p->rcvCount++;
+#ifdef ROZO_MES
+        gettimeofday(&timeDay,(struct timezone *)0);  
+        timeBefore = MICROLONG(timeDay);
+#endif
+        (*(pcallBack->msgInFunc))(p->objRef,p->socketId);
+#ifdef ROZO_MES
+        gettimeofday(&timeDay,(struct timezone *)0);  
+        timeAfter = MICROLONG(timeDay);
+        p->lastTime = (uint32_t)(timeAfter - timeBefore);
+        p->cumulatedTime += p->lastTime;
+        p->nbTimes ++;        
+#endif
+        if ((ruc_applicative_poller != NULL) && (ruc_applicative_poller_ticker < timeAfter))
+        {
+	  ruc_applicative_poller_count++;
+	  uint64_t cycles_start = rdtsc();  	
+	  (*ruc_applicative_poller)(0);
+          ruc_applicative_poller_cycles += (rdtsc() - cycles_start);  
+	  ruc_applicative_poller_ticker = timeAfter+1;
+        }
+        /*
+        ** the socket may have been disconnected by the callback
+        */
+        if (socket_ctx_table[socketId] != p) continue;
+      }
+
+      if ((ruc_sockCtrl_epoll_mask[socketId] & EPOLLOUT) && (events & (EPOLLOUT|EPOLLHUP|EPOLLERR)))
+      {
+        p->xmitCount++;
+#ifdef ROZO_MES
+        gettimeofday(&timeDay,(struct timezone *)0);  
+        timeBefore = MICROLONG(timeDay);
+#endif
+        (*(pcallBack->xmitEvtFunc))(p->objRef,p->socketId);
+#ifdef ROZO_MES
+        gettimeofday(&timeDay,(struct timezone *)0);  
+        timeAfter = MICROLONG(timeDay);
+        p->lastTime = (uint32_t)(timeAfter - timeBefore);
+        p->cumulatedTime += p->lastTime;
+        p->nbTimes ++;
+#endif
+      }
+    }
+  }
+  ruc_sockCtrl_epoll_count = 0;
+
+  /*
+  ** speculative scheduler
+  */
+  for (i = 0; i <speculative_count ; i++)
+  {
+    socketId = socket_speculative_table[i];
+    if (socketId == -1) continue;
+    p = socket_predictive_ctx_table[socketId];
+    if (p == NULL) 
+    {
+      continue;
+    }
+    p->rcvCount++;
+    pcallBack = p->callBack;
+
+    gettimeofday(&timeDay,(struct timezone *)0);  
+    timeBefore = MICROLONG(timeDay);
+
+    (*(pcallBack->msgInFunc))(p->objRef,p->socketId);
+    gettimeofday(&timeDay,(struct timezone *)0);  
+    timeAfter = MICROLONG(timeDay);
+    p->lastTime = (uint32_t)(timeAfter - timeBefore);
+    p->cumulatedTime += p->lastTime;
+    p->nbTimes ++;         
+  }
+}
 
 /*
 **____________________________________________________________________________
@@ -1612,9 +2009,10 @@ void ruc_sockCtrl_selectWait()
     while (1)
     {
       /*
-      **  compute rucRdFdSet and rucWrFdSet
+      **  compute rucRdFdSet and rucWrFdSet, or the epoll registrations
       */
-      ruc_sockCtl_prepareRcvAndXmitBits();
+      if (ruc_sockCtrl_epoll_fd >= 0) ruc_sockCtl_epoll_prepare();
+      else                            ruc_sockCtl_prepareRcvAndXmitBits();
 //      cycles_before = rdtsc();     
       gettimeofday(&timeDay,(struct timezone *)0);  
 //      cycles_after = rdtsc();  
@@ -1629,8 +2027,18 @@ void ruc_sockCtrl_selectWait()
       /*
       ** wait for event 
       */	  
-      if((nbrSelect=select(ruc_max_curr_socket+1,(fd_set *)&rucRdFdSet,
-                                                 (fd_set *)&rucWrFdSet,NULL, NULL)) == 0)
+      if (ruc_sockCtrl_epoll_fd >= 0) 
+      {
+        nbrSelect = epoll_wait(ruc_sockCtrl_epoll_fd,ruc_sockCtrl_epoll_events,RUC_SOCKCTL_EPOLL_EVENTS,
+                               (ruc_sockCtrl_rcv_pending_count==0)?-1:RUC_SOCKCTL_RCV_PENDING_TMO_US/1000);
+      }
+      else
+      {
+        struct timeval pending_tmo = {0, RUC_SOCKCTL_RCV_PENDING_TMO_US};
+        nbrSelect = select(ruc_max_curr_socket+1,(fd_set *)&rucRdFdSet,(fd_set *)&rucWrFdSet,NULL,
+                           (ruc_sockCtrl_rcv_pending_count==0)?NULL:&pending_tmo);
+      }
+      if (nbrSelect == 0)
       {
 	/*
 	** udpate time after select
@@ -1640,6 +2048,10 @@ void ruc_sockCtrl_selectWait()
         rozofs_ticker_microseconds = timeAfter;
         rozofs_ticker_seconds = timeDay.tv_sec;
 	looptimeStart  = timeAfter;
+	/*
+	** time-out on receivers that keep some bytes
+	*/
+	ruc_sockCtl_rcv_pending_dispatch();
       }
       else
       {
@@ -1661,7 +2073,9 @@ void ruc_sockCtrl_selectWait()
 	if (ruc_sockCtrl_max_nr_select < nbrSelect) ruc_sockCtrl_max_nr_select = nbrSelect;
         ruc_sockCtrl_nr_socket_stats[nbrSelect]++;
 	
-	ruc_sockCtl_checkRcvAndXmitBits_opt(nbrSelect);
+	if (ruc_sockCtrl_epoll_fd >= 0) ruc_sockCtl_epoll_dispatch(nbrSelect);
+	else                            ruc_sockCtl_checkRcvAndXmitBits_opt(nbrSelect);
+	ruc_sockCtl_rcv_pending_dispatch();
 	/*
 	**  insert the first element of each priority list at the
 	**  tail of its priority list.
@@ -1696,6 +2110,16 @@ void ruc_sockCtrl_selectWait()
 */
 void ruc_sockCtrl_clear_rcv_bit(int fd)
 {
+  int i;
+
   if (fd < 0) return;
   FD_CLR(fd,&rucRdFdSet);
+  /*
+  ** epoll engine: drop the receive event of the socket when not yet processed
+  */
+  for (i = 0; i < ruc_sockCtrl_epoll_count; i++)
+  {
+    if (ruc_sockCtrl_epoll_events[i].data.fd != fd) continue;
+    ruc_sockCtrl_epoll_events[i].events &= ~(EPOLLIN|EPOLLHUP|EPOLLERR);
+  }
 }
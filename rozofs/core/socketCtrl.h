@@ -32,6 +32,41 @@
 //extern fd_set  rucWrFdSet;   
 extern rozo_fd_set  rucWrFdSetCongested;
 /*
+** epoll file descriptor when the epoll engine is used, -1 for select
+*/
+extern int          ruc_sockCtrl_epoll_fd;
+
+/**
+* update the events a socket with unconditional receive waits for in
+* the epoll engine
+ 
+  @param fd : socket identifier
+*/
+void ruc_sockCtrl_epoll_update(int fd);
+
+/**
+* a socket is congested: wait for it to become writable
+
+  @param fd : socket identifier
+*/
+static inline void ruc_sockCtrl_set_xmit_congested(int fd)
+{
+  if (FD_ISSET(fd,&rucWrFdSetCongested)) return;
+  FD_SET(fd,&rucWrFdSetCongested);
+  if (ruc_sockCtrl_epoll_fd >= 0) ruc_sockCtrl_epoll_update(fd);
+}
+/**
+* end of congestion of a socket
+
+  @param fd : socket identifier
+*/
+static inline void ruc_sockCtrl_clear_xmit_congested(int fd)
+{
+  if (!FD_ISSET(fd,&rucWrFdSetCongested)) return;
+  FD_CLR(fd,&rucWrFdSetCongested);
+  if (ruc_sockCtrl_epoll_fd >= 0) ruc_sockCtrl_epoll_update(fd);
+}
+/*
 **  private API
 */
 
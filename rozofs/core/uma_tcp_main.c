@@ -300,10 +300,10 @@ uint32_t uma_tcp_xmitEvt(void * opaque,int socketId)
 
   if (p->eocCounter != 0) {
         p->eocCounter--;
-	FD_SET(socketId,&rucWrFdSetCongested);
+	ruc_sockCtrl_set_xmit_congested(socketId);
   	return TRUE;
   }
-  FD_CLR(socketId,&rucWrFdSetCongested);
+  ruc_sockCtrl_clear_xmit_congested(socketId);
 
   /*
   ** call the FSM when the end of congestion counter is null
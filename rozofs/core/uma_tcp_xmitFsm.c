@@ -681,7 +681,7 @@ void ruc_relci_privateSend(uma_tcp_t *pObj)
           */
 	  pObj->xmitWouldBlock = FALSE;
           pObj->congested = TRUE;
-	  FD_SET(pObj->socketRef,&rucWrFdSetCongested);
+	  ruc_sockCtrl_set_xmit_congested(pObj->socketRef);
           FSM_SET(pfsm,STATE_CONGESTED);
 	FSM_TRANS_END
 
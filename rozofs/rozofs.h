@@ -504,6 +504,32 @@ typedef struct encode_t
   int nb_level;         /**< number of levels */
 } encode_t;
 /**
+* precompiled inverse program of a set of projections (see mojette_transform128.c)
+*/
+typedef struct _transform128_inverse_prog_t
+{
+  int     rows;                                /**< number of rows (rozofs_inverse)              */
+  int     cols;                                /**< number of 128 bits columns                   */
+  uint8_t slot[ROZOFS_SAFE_MAX_STORCLI];       /**< rank of each projection id after the sort    */
+  int     p[ROZOFS_SAFE_MAX_STORCLI];          /**< angle p of each sorted projection            */
+  int     q[ROZOFS_SAFE_MAX_STORCLI];          /**< angle q of each sorted projection            */
+  int     size[ROZOFS_SAFE_MAX_STORCLI];       /**< size in 128 bits bins of each projection     */
+  int     offsets[ROZOFS_SAFE_MAX_STORCLI];    /**< bins offset of each sorted projection        */
+  int     k_offsets[ROZOFS_SAFE_MAX_STORCLI];  /**< column offset of the reconstruction path     */
+} transform128_inverse_prog_t;
+
+void transform128_inverse_prog_init();
+transform128_inverse_prog_t * transform128_inverse_prog_get(uint8_t layout, uint32_t bsize, int key);
+int transform128_inverse_prog_run(transform128_inverse_prog_t * prog, pxl_t * support,
+                                  projection_opt_t * projections, int max_prj_sz_intf);
+/*
+** max number of blocks decoded in the same pass by the batched inverse
+*/
+#define TRANSFORM128_INVERSE_BATCH_MAX 4
+int transform128_inverse_prog_run_batch(transform128_inverse_prog_t * prog, pxl_t ** supports,
+                                        projection_opt_t (*projections)[ROZOFS_SAFE_MAX_STORCLI], 
+                                        int nb, int max_prj_sz_intf);
+/**
 *  end of Mojette Optimized data structure
 */
 
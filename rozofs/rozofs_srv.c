@@ -30,21 +30,28 @@
 static int prj_sz_2048_layout0_128bits[] = {  64, 64, 64};
 static int prj_sz_4096_layout0_128bits[] = {  128, 128, 128};
 static int prj_sz_8192_layout0_128bits[] = {  256, 256, 256};
+static int prj_sz_16384_layout0_128bits[] = {  512, 512, 512};
+static int prj_sz_32768_layout0_128bits[] = {  1024, 1024, 1024};
 
 static int prj_sz_2048_layout1_128bits[] = {  32, 34, 34, 32, 33, 32};
 static int prj_sz_4096_layout1_128bits[] = {  64, 66, 66, 64, 65, 64};
 static int prj_sz_8192_layout1_128bits[] = {  128, 130, 130, 128, 129, 128};
+static int prj_sz_16384_layout1_128bits[] = {  256, 258, 258, 256, 257, 256};
+static int prj_sz_32768_layout1_128bits[] = {  512, 514, 514, 512, 513, 512};
 
 static int prj_sz_2048_layout2_128bits[] = {  16, 21, 24, 25, 24, 21, 16, 20, 22, 22, 20, 16};
 static int prj_sz_4096_layout2_128bits[] = {  32, 37, 40, 41, 40, 37, 32, 36, 38, 38, 36, 32};
 static int prj_sz_8192_layout2_128bits[] = {  64, 69, 72, 73, 72, 69, 64, 68, 70, 70, 68, 64};
+static int prj_sz_16384_layout2_128bits[] = {  128, 133, 136, 137, 136, 133, 128, 132, 134, 134, 132, 128};
+static int prj_sz_32768_layout2_128bits[] = {  256, 261, 264, 265, 264, 261, 256, 260, 262, 262, 260, 256};
 
 static int *layout0_128bits_tb[] =
 {
   prj_sz_2048_layout0_128bits,
   prj_sz_4096_layout0_128bits,
   prj_sz_8192_layout0_128bits,
-  
+  prj_sz_16384_layout0_128bits,
+  prj_sz_32768_layout0_128bits,
 };
 
 static int *layout1_128bits_tb[] =
@@ -52,7 +59,8 @@ static int *layout1_128bits_tb[] =
   prj_sz_2048_layout1_128bits,
   prj_sz_4096_layout1_128bits,
   prj_sz_8192_layout1_128bits,
-  
+  prj_sz_16384_layout1_128bits,
+  prj_sz_32768_layout1_128bits,
 };
 
 static int *layout2_128bits_tb[] =
@@ -60,7 +68,8 @@ static int *layout2_128bits_tb[] =
   prj_sz_2048_layout2_128bits,
   prj_sz_4096_layout2_128bits,
   prj_sz_8192_layout2_128bits,
-  
+  prj_sz_16384_layout2_128bits,
+  prj_sz_32768_layout2_128bits,
 };
 rozofs_conf_layout_t rozofs_conf_layout_table[LAYOUT_MAX]={{0}};
 
@@ -148,16 +157,6 @@ void rozofs_layout_initialize() {
 		/*
 		** compute the effective size
 		*/
-		if (bsize > ROZOFS_BSIZE_8K)
-		{
-		  /*
-		  ** value greater than 8K are not supported with optimized Mojette
-		  */
-		  p->sizes[bsize].rozofs_eff_psizes[i] = 0;
-		  p->sizes[bsize].rozofs_eff_psizes_max = 0;
-		  continue;		
-		}
-
 		p->sizes[bsize].rozofs_eff_psizes[i] = cur_prj_sz_tb[i];
                 if (p->sizes[bsize].rozofs_eff_psizes[i] > p->sizes[bsize].rozofs_eff_psizes_max) 
 		    p->sizes[bsize].rozofs_eff_psizes_max = p->sizes[bsize].rozofs_eff_psizes[i];
@@ -643,6 +643,35 @@ struct epgw_readdir2_ret_t {
 };
 typedef struct epgw_readdir2_ret_t epgw_readdir2_ret_t;
 
+struct dirlistplus_t {
+	uint8_t eof;
+	uint64_t cookie;
+	struct {
+		u_int value_len;
+		char *value_val;
+	} value;
+	struct {
+		u_int attrs_len;
+		ep_mattr_t *attrs_val;
+	} attrs;
+};
+typedef struct dirlistplus_t dirlistplus_t;
+
+struct ep_readdirplus_ret_t {
+	ep_status_t status;
+	union {
+		dirlistplus_t reply;
+		int error;
+	} ep_readdirplus_ret_t_u;
+};
+typedef struct ep_readdirplus_ret_t ep_readdirplus_ret_t;
+
+struct epgw_readdirplus_ret_t {
+	struct ep_gateway_t hdr;
+	ep_readdirplus_ret_t status_gw;
+};
+typedef struct epgw_readdirplus_ret_t epgw_readdirplus_ret_t;
+
 struct ep_rename_arg_t {
 	uint32_t eid;
 	ep_uuid_t pfid;
@@ -952,6 +981,63 @@ struct epgw_conf_stor_arg_t {
 	ep_path_t path;
 };
 typedef struct epgw_conf_stor_arg_t epgw_conf_stor_arg_t;
+#define EP_BATCH_MAX 16
+
+enum ep_batch_op_t {
+	EP_BATCH_LOOKUP = 0,
+	EP_BATCH_GETATTR = 1,
+};
+typedef enum ep_batch_op_t ep_batch_op_t;
+
+struct ep_batch_op_arg_t {
+	ep_batch_op_t op;
+	union {
+		ep_lookup_arg_t lookup;
+		ep_mfile_arg_t getattr;
+	} ep_batch_op_arg_t_u;
+};
+typedef struct ep_batch_op_arg_t ep_batch_op_arg_t;
+
+struct epgw_batch_arg_t {
+	struct ep_gateway_t hdr;
+	struct {
+		u_int ops_len;
+		ep_batch_op_arg_t *ops_val;
+	} ops;
+};
+typedef struct epgw_batch_arg_t epgw_batch_arg_t;
+
+struct ep_batch_res_t {
+	ep_mattr_ret_t status_gw;
+	ep_mattr_ret_t parent_attr;
+};
+typedef struct ep_batch_res_t ep_batch_res_t;
+
+struct ep_batch_t {
+	uint64_t free_quota;
+	uint32_t bsize;
+	uint8_t layout;
+	struct {
+		u_int res_len;
+		ep_batch_res_t *res_val;
+	} res;
+};
+typedef struct ep_batch_t ep_batch_t;
+
+struct ep_batch_ret_t {
+	ep_status_t status;
+	union {
+		ep_batch_t batch;
+		int error;
+	} ep_batch_ret_t_u;
+};
+typedef struct ep_batch_ret_t ep_batch_ret_t;
+
+struct epgw_batch_ret_t {
+	struct ep_gateway_t hdr;
+	ep_batch_ret_t status_gw;
+};
+typedef struct epgw_batch_ret_t epgw_batch_ret_t;
 
 #define EXPORT_PROGRAM 0x20000001
 #define EXPORT_VERSION 1
@@ -1068,6 +1154,12 @@ extern  epgw_getxattr_raw_ret_t * ep_getxattr_raw_1_svc(epgw_getxattr_arg_t *, s
 #define EP_READDIR2 37
 extern  epgw_readdir2_ret_t * ep_readdir2_1(epgw_readdir_arg_t *, CLIENT *);
 extern  epgw_readdir2_ret_t * ep_readdir2_1_svc(epgw_readdir_arg_t *, struct svc_req *);
+#define EP_BATCH 38
+extern  epgw_batch_ret_t * ep_batch_1(epgw_batch_arg_t *, CLIENT *);
+extern  epgw_batch_ret_t * ep_batch_1_svc(epgw_batch_arg_t *, struct svc_req *);
+#define EP_READDIRPLUS 39
+extern  epgw_readdirplus_ret_t * ep_readdirplus_1(epgw_readdir_arg_t *, CLIENT *);
+extern  epgw_readdirplus_ret_t * ep_readdirplus_1_svc(epgw_readdir_arg_t *, struct svc_req *);
 extern int export_program_1_freeresult (SVCXPRT *, xdrproc_t, caddr_t);
 
 #else /* K&R C */
@@ -1182,6 +1274,12 @@ extern  epgw_getxattr_raw_ret_t * ep_getxattr_raw_1_svc();
 #define EP_READDIR2 37
 extern  epgw_readdir2_ret_t * ep_readdir2_1();
 extern  epgw_readdir2_ret_t * ep_readdir2_1_svc();
+#define EP_BATCH 38
+extern  epgw_batch_ret_t * ep_batch_1();
+extern  epgw_batch_ret_t * ep_batch_1_svc();
+#define EP_READDIRPLUS 39
+extern  epgw_readdirplus_ret_t * ep_readdirplus_1();
+extern  epgw_readdirplus_ret_t * ep_readdirplus_1_svc();
 extern int export_program_1_freeresult ();
 #endif /* K&R C */
 
@@ -1277,6 +1375,9 @@ extern  bool_t xdr_epgw_readdir2_nodata_ret_t (XDR *, epgw_readdir2_nodata_ret_t
 extern  bool_t xdr_dirlist2_t (XDR *, dirlist2_t*);
 extern  bool_t xdr_ep_readdir2_ret_t (XDR *, ep_readdir2_ret_t*);
 extern  bool_t xdr_epgw_readdir2_ret_t (XDR *, epgw_readdir2_ret_t*);
+extern  bool_t xdr_dirlistplus_t (XDR *, dirlistplus_t*);
+extern  bool_t xdr_ep_readdirplus_ret_t (XDR *, ep_readdirplus_ret_t*);
+extern  bool_t xdr_epgw_readdirplus_ret_t (XDR *, epgw_readdirplus_ret_t*);
 extern  bool_t xdr_ep_rename_arg_t (XDR *, ep_rename_arg_t*);
 extern  bool_t xdr_epgw_rename_arg_t (XDR *, epgw_rename_arg_t*);
 extern  bool_t xdr_epgw_rename_ret_t (XDR *, epgw_rename_ret_t*);
@@ -1316,6 +1417,13 @@ extern  bool_t xdr_ep_gw_gateway_configuration_ret_t (XDR *, ep_gw_gateway_confi
 extern  bool_t xdr_epgw_mount_msite_host_arg_t (XDR *, epgw_mount_msite_host_arg_t*);
 extern  bool_t xdr_epgw_mount_arg_t (XDR *, epgw_mount_arg_t*);
 extern  bool_t xdr_epgw_conf_stor_arg_t (XDR *, epgw_conf_stor_arg_t*);
+extern  bool_t xdr_ep_batch_op_t (XDR *, ep_batch_op_t*);
+extern  bool_t xdr_ep_batch_op_arg_t (XDR *, ep_batch_op_arg_t*);
+extern  bool_t xdr_epgw_batch_arg_t (XDR *, epgw_batch_arg_t*);
+extern  bool_t xdr_ep_batch_res_t (XDR *, ep_batch_res_t*);
+extern  bool_t xdr_ep_batch_t (XDR *, ep_batch_t*);
+extern  bool_t xdr_ep_batch_ret_t (XDR *, ep_batch_ret_t*);
+extern  bool_t xdr_epgw_batch_ret_t (XDR *, epgw_batch_ret_t*);
 
 #else /* K&R C */
 extern bool_t xdr_ep_uuid_t ();
@@ -1407,6 +1515,9 @@ extern bool_t xdr_epgw_readdir2_nodata_ret_t ();
 extern bool_t xdr_dirlist2_t ();
 extern bool_t xdr_ep_readdir2_ret_t ();
 extern bool_t xdr_epgw_readdir2_ret_t ();
+extern bool_t xdr_dirlistplus_t ();
+extern bool_t xdr_ep_readdirplus_ret_t ();
+extern bool_t xdr_epgw_readdirplus_ret_t ();
 extern bool_t xdr_ep_rename_arg_t ();
 extern bool_t xdr_epgw_rename_arg_t ();
 extern bool_t xdr_epgw_rename_ret_t ();
@@ -1446,6 +1557,13 @@ extern bool_t xdr_ep_gw_gateway_configuration_ret_t ();
 extern bool_t xdr_epgw_mount_msite_host_arg_t ();
 extern bool_t xdr_epgw_mount_arg_t ();
 extern bool_t xdr_epgw_conf_stor_arg_t ();
+extern bool_t xdr_ep_batch_op_t ();
+extern bool_t xdr_ep_batch_op_arg_t ();
+extern bool_t xdr_epgw_batch_arg_t ();
+extern bool_t xdr_ep_batch_res_t ();
+extern bool_t xdr_ep_batch_t ();
+extern bool_t xdr_ep_batch_ret_t ();
+extern bool_t xdr_epgw_batch_ret_t ();
 
 #endif /* K&R C */
 
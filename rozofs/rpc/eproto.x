@@ -571,6 +571,30 @@ struct  epgw_readdir2_ret_t
   ep_readdir2_ret_t    status_gw;
 };
 
+/*
+** readdir2 dirents followed by the attributes of the listed entries,
+** in the order of the dirents, "." and ".." excepted. The fid of the
+** attributes is null when they could not be read.
+*/
+struct dirlistplus_t {
+	uint8_t eof;
+        uint64_t cookie;	
+	opaque          value<>;
+	ep_mattr_t      attrs<>;
+};
+
+union ep_readdirplus_ret_t switch (ep_status_t status) {
+    case EP_SUCCESS:    dirlistplus_t       reply;
+    case EP_FAILURE:    int             error;
+    default:            void;
+};
+
+struct  epgw_readdirplus_ret_t 
+{
+  struct ep_gateway_t hdr;
+  ep_readdirplus_ret_t    status_gw;
+};
+
 
 struct ep_rename_arg_t {
     uint32_t    eid;
@@ -824,6 +848,52 @@ struct  epgw_conf_stor_arg_t
   ep_path_t          path;
 };
 
+/*
+ * Compound request: several lookup and getattr in one message
+ */
+%#define EP_BATCH_MAX    16
+
+enum ep_batch_op_t {
+    EP_BATCH_LOOKUP  = 0,
+    EP_BATCH_GETATTR = 1
+};
+
+union ep_batch_op_arg_t switch (ep_batch_op_t op) {
+    case EP_BATCH_LOOKUP:   ep_lookup_arg_t  lookup;
+    case EP_BATCH_GETATTR:  ep_mfile_arg_t   getattr;
+    default:                void;
+};
+
+struct  epgw_batch_arg_t 
+{
+  struct ep_gateway_t hdr;
+  ep_batch_op_arg_t   ops<EP_BATCH_MAX>;
+};
+
+struct ep_batch_res_t {
+    ep_mattr_ret_t    status_gw;
+    ep_mattr_ret_t    parent_attr;
+};
+
+struct ep_batch_t {
+    uint64_t          free_quota;
+    uint32_t          bsize; /* Block size. From enum ROZOFS_BSIZE_E */
+    uint8_t           layout;
+    ep_batch_res_t    res<EP_BATCH_MAX>;
+};
+
+union ep_batch_ret_t switch (ep_status_t status) {
+    case EP_SUCCESS:    ep_batch_t  batch;
+    case EP_FAILURE:    int         error;
+    default:            void;
+};
+
+struct epgw_batch_ret_t
+{
+  struct ep_gateway_t hdr;
+  ep_batch_ret_t      status_gw;
+};
+
 
 
 program EXPORT_PROGRAM {
@@ -940,6 +1010,12 @@ program EXPORT_PROGRAM {
         epgw_readdir2_ret_t
         EP_READDIR2(epgw_readdir_arg_t)            = 37;
 
+        epgw_batch_ret_t
+        EP_BATCH(epgw_batch_arg_t)                 = 38;
+
+        epgw_readdirplus_ret_t
+        EP_READDIRPLUS(epgw_readdir_arg_t)         = 39;
+
 	
     } = 1;
 } = 0x20000001;
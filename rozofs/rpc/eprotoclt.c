@@ -7,6 +7,7 @@
 #include "eproto.h"
 #include <rozofs/rozofs.h>
 #define ROZOFS_VERSION_STRING_LENGTH 32
+#define EP_BATCH_MAX 16
 
 /* Default timeout can be changed using clnt_control() */
 static struct timeval TIMEOUT = { 25, 0 };
@@ -565,3 +566,33 @@ ep_readdir2_1(epgw_readdir_arg_t *argp, CLIENT *clnt)
 	}
 	return (&clnt_res);
 }
+
+epgw_batch_ret_t *
+ep_batch_1(epgw_batch_arg_t *argp, CLIENT *clnt)
+{
+	static epgw_batch_ret_t clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, EP_BATCH,
+		(xdrproc_t) xdr_epgw_batch_arg_t, (caddr_t) argp,
+		(xdrproc_t) xdr_epgw_batch_ret_t, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+epgw_readdirplus_ret_t *
+ep_readdirplus_1(epgw_readdir_arg_t *argp, CLIENT *clnt)
+{
+	static epgw_readdirplus_ret_t clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, EP_READDIRPLUS,
+		(xdrproc_t) xdr_epgw_readdir_arg_t, (caddr_t) argp,
+		(xdrproc_t) xdr_epgw_readdirplus_ret_t, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
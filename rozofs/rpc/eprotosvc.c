@@ -17,6 +17,7 @@
 #endif
 #include <rozofs/rozofs.h>
 #define ROZOFS_VERSION_STRING_LENGTH 32
+#define EP_BATCH_MAX 16
 
 void
 export_program_1(struct svc_req *rqstp, register SVCXPRT *transp)
@@ -57,6 +58,8 @@ export_program_1(struct svc_req *rqstp, register SVCXPRT *transp)
 		epgw_cluster_arg_t ep_list_cluster2_1_arg;
 		epgw_getxattr_arg_t ep_getxattr_raw_1_arg;
 		epgw_readdir_arg_t ep_readdir2_1_arg;
+		epgw_batch_arg_t ep_batch_1_arg;
+		epgw_readdir_arg_t ep_readdirplus_1_arg;
 	} argument;
 	char *result;
 	xdrproc_t _xdr_argument, _xdr_result;
@@ -285,6 +288,18 @@ export_program_1(struct svc_req *rqstp, register SVCXPRT *transp)
 		local = (char *(*)(char *, struct svc_req *)) ep_readdir2_1_svc;
 		break;
 
+	case EP_BATCH:
+		_xdr_argument = (xdrproc_t) xdr_epgw_batch_arg_t;
+		_xdr_result = (xdrproc_t) xdr_epgw_batch_ret_t;
+		local = (char *(*)(char *, struct svc_req *)) ep_batch_1_svc;
+		break;
+
+	case EP_READDIRPLUS:
+		_xdr_argument = (xdrproc_t) xdr_epgw_readdir_arg_t;
+		_xdr_result = (xdrproc_t) xdr_epgw_readdirplus_ret_t;
+		local = (char *(*)(char *, struct svc_req *)) ep_readdirplus_1_svc;
+		break;
+
 	default:
 		svcerr_noproc (transp);
 		return;
@@ -1389,6 +1389,57 @@ xdr_epgw_readdir2_ret_t (XDR *xdrs, epgw_readdir2_ret_t *objp)
 	return TRUE;
 }
 
+bool_t
+xdr_dirlistplus_t (XDR *xdrs, dirlistplus_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_uint8_t (xdrs, &objp->eof))
+		 return FALSE;
+	 if (!xdr_uint64_t (xdrs, &objp->cookie))
+		 return FALSE;
+	 if (!xdr_bytes (xdrs, (char **)&objp->value.value_val, (u_int *) &objp->value.value_len, ~0))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->attrs.attrs_val, (u_int *) &objp->attrs.attrs_len, ~0,
+		sizeof (ep_mattr_t), (xdrproc_t) xdr_ep_mattr_t))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_ep_readdirplus_ret_t (XDR *xdrs, ep_readdirplus_ret_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_ep_status_t (xdrs, &objp->status))
+		 return FALSE;
+	switch (objp->status) {
+	case EP_SUCCESS:
+		 if (!xdr_dirlistplus_t (xdrs, &objp->ep_readdirplus_ret_t_u.reply))
+			 return FALSE;
+		break;
+	case EP_FAILURE:
+		 if (!xdr_int (xdrs, &objp->ep_readdirplus_ret_t_u.error))
+			 return FALSE;
+		break;
+	default:
+		break;
+	}
+	return TRUE;
+}
+
+bool_t
+xdr_epgw_readdirplus_ret_t (XDR *xdrs, epgw_readdirplus_ret_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_ep_gateway_t (xdrs, &objp->hdr))
+		 return FALSE;
+	 if (!xdr_ep_readdirplus_ret_t (xdrs, &objp->status_gw))
+		 return FALSE;
+	return TRUE;
+}
+
 bool_t
 xdr_ep_rename_arg_t (XDR *xdrs, ep_rename_arg_t *objp)
 {
@@ -1983,3 +2034,112 @@ xdr_epgw_conf_stor_arg_t (XDR *xdrs, epgw_conf_stor_arg_t *objp)
 		 return FALSE;
 	return TRUE;
 }
+#define EP_BATCH_MAX 16
+
+bool_t
+xdr_ep_batch_op_t (XDR *xdrs, ep_batch_op_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_enum (xdrs, (enum_t *) objp))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_ep_batch_op_arg_t (XDR *xdrs, ep_batch_op_arg_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_ep_batch_op_t (xdrs, &objp->op))
+		 return FALSE;
+	switch (objp->op) {
+	case EP_BATCH_LOOKUP:
+		 if (!xdr_ep_lookup_arg_t (xdrs, &objp->ep_batch_op_arg_t_u.lookup))
+			 return FALSE;
+		break;
+	case EP_BATCH_GETATTR:
+		 if (!xdr_ep_mfile_arg_t (xdrs, &objp->ep_batch_op_arg_t_u.getattr))
+			 return FALSE;
+		break;
+	default:
+		break;
+	}
+	return TRUE;
+}
+
+bool_t
+xdr_epgw_batch_arg_t (XDR *xdrs, epgw_batch_arg_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_ep_gateway_t (xdrs, &objp->hdr))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->ops.ops_val, (u_int *) &objp->ops.ops_len, EP_BATCH_MAX,
+		sizeof (ep_batch_op_arg_t), (xdrproc_t) xdr_ep_batch_op_arg_t))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_ep_batch_res_t (XDR *xdrs, ep_batch_res_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_ep_mattr_ret_t (xdrs, &objp->status_gw))
+		 return FALSE;
+	 if (!xdr_ep_mattr_ret_t (xdrs, &objp->parent_attr))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_ep_batch_t (XDR *xdrs, ep_batch_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_uint64_t (xdrs, &objp->free_quota))
+		 return FALSE;
+	 if (!xdr_uint32_t (xdrs, &objp->bsize))
+		 return FALSE;
+	 if (!xdr_uint8_t (xdrs, &objp->layout))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->res.res_val, (u_int *) &objp->res.res_len, EP_BATCH_MAX,
+		sizeof (ep_batch_res_t), (xdrproc_t) xdr_ep_batch_res_t))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_ep_batch_ret_t (XDR *xdrs, ep_batch_ret_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_ep_status_t (xdrs, &objp->status))
+		 return FALSE;
+	switch (objp->status) {
+	case EP_SUCCESS:
+		 if (!xdr_ep_batch_t (xdrs, &objp->ep_batch_ret_t_u.batch))
+			 return FALSE;
+		break;
+	case EP_FAILURE:
+		 if (!xdr_int (xdrs, &objp->ep_batch_ret_t_u.error))
+			 return FALSE;
+		break;
+	default:
+		break;
+	}
+	return TRUE;
+}
+
+bool_t
+xdr_epgw_batch_ret_t (XDR *xdrs, epgw_batch_ret_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_ep_gateway_t (xdrs, &objp->hdr))
+		 return FALSE;
+	 if (!xdr_ep_batch_ret_t (xdrs, &objp->status_gw))
+		 return FALSE;
+	return TRUE;
+}
@@ -111,6 +111,8 @@ struct export_one_profiler_t {
   uint64_t quota_get[2];
   uint64_t quota_set[2];
   uint64_t quota_setinfo[2];
+  uint64_t ep_batch[2];
+  uint64_t ep_readdirplus[2];
 };
 typedef struct export_one_profiler_t export_one_profiler_t;
 
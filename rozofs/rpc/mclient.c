@@ -28,6 +28,23 @@
 
 uint16_t mproto_service_port = 0;
 
+/*_________________________________________________________________
+** Call a mproto procedure with a result owned by the caller
+**
+** The rpcgen stubs return a static result, which can not be used by
+** several threads calling their own mclients at the same time.
+**
+** @retval the RPC status of the call
+*/
+static inline enum clnt_stat mclient_call(CLIENT *clnt, u_long proc,
+                                          xdrproc_t xdr_args, void * args,
+                                          xdrproc_t xdr_res, void * res, int res_size) {
+    struct timeval TIMEOUT = { 25, 0 };
+
+    memset(res, 0, res_size);
+    return clnt_call(clnt, proc, xdr_args, (caddr_t) args, xdr_res, (caddr_t) res, TIMEOUT);
+}
+
 /*_________________________________________________________________
 ** try to connect a mclient
 ** 
@@ -124,6 +141,7 @@ out:
 int mclient_remove2(mclient_t * clt, fid_t fid,uint8_t spare) {
     int status = -1;
     mp_status_ret_t *ret = 0;
+    mp_status_ret_t res;
     mp_remove2_arg_t args;
     DEBUG_FUNCTION;
 
@@ -132,10 +150,14 @@ int mclient_remove2(mclient_t * clt, fid_t fid,uint8_t spare) {
     args.spare = spare;
     memcpy(args.fid, fid, sizeof (fid_t));
 
-    if (!(clt->rpcclt.client) || !(ret = mp_remove2_1(&args, clt->rpcclt.client))) {
+    if (!(clt->rpcclt.client)
+    ||  (mclient_call(clt->rpcclt.client, MP_REMOVE2,
+                      (xdrproc_t) xdr_mp_remove2_arg_t, &args,
+                      (xdrproc_t) xdr_mp_status_ret_t, &res, sizeof(res)) != RPC_SUCCESS)) {
         errno = EPROTO;
         goto out;
     }
+    ret = &res;
     if (ret->status != 0) {
         errno = ret->mp_status_ret_t_u.error;
         goto out;
@@ -146,6 +168,52 @@ out:
         xdr_free((xdrproc_t) xdr_mp_status_ret_t, (char *) ret);
     return status;
 }
+int mclient_remove_batch(mclient_t * clt, uint8_t spare, int nb, fid_t * fids, int * errors) {
+    int status = -1;
+    mp_remove_batch_ret_t *ret = 0;
+    mp_remove_batch_ret_t res;
+    mp_remove_batch_arg_t args;
+    enum clnt_stat rpc_status;
+    int idx;
+    DEBUG_FUNCTION;
+
+    args.cid   = clt->cid;
+    args.sid   = clt->sid;
+    args.spare = spare;
+    args.fids.fids_len = nb;
+    args.fids.fids_val = (mp_uuid_t *) fids;
+
+    if (!(clt->rpcclt.client)) {
+        errno = EPROTO;
+        goto out;
+    }
+    rpc_status = mclient_call(clt->rpcclt.client, MP_REMOVE_BATCH,
+                              (xdrproc_t) xdr_mp_remove_batch_arg_t, &args,
+                              (xdrproc_t) xdr_mp_remove_batch_ret_t, &res, sizeof(res));
+    if (rpc_status != RPC_SUCCESS) {
+        /* The storaged does not know MP_REMOVE_BATCH */
+        if (rpc_status == RPC_PROCUNAVAIL) errno = EOPNOTSUPP;
+        else                               errno = EPROTO;
+        goto out;
+    }
+    ret = &res;
+    if (ret->status != 0) {
+        errno = ret->mp_remove_batch_ret_t_u.error;
+        goto out;
+    }
+    if (ret->mp_remove_batch_ret_t_u.errors.errors_len != nb) {
+        errno = EPROTO;
+        goto out;
+    }
+    for (idx = 0; idx < nb; idx++) {
+        errors[idx] = ret->mp_remove_batch_ret_t_u.errors.errors_val[idx];
+    }
+    status = 0;
+out:
+    if (ret)
+        xdr_free((xdrproc_t) xdr_mp_remove_batch_ret_t, (char *) ret);
+    return status;
+}
 int mclient_ports(mclient_t * mclt, int * single, mp_io_address_t * io_address_p) {
     int status = -1;
     mp_ports_ret_t *ret = 0;
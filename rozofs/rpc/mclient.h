@@ -136,6 +136,19 @@ int mclient_stat(mclient_t *clt, sstat_t *st);
 
 int mclient_remove(mclient_t * clt, fid_t fid);
 int mclient_remove2(mclient_t * clt, fid_t fid, uint8_t spare);
+/*_________________________________________________________________
+** Remove a batch of files from a storage
+** 
+** @param  clt      The mclient of the storage
+** @param  spare    Whether the files are spare or nominal ones
+** @param  nb       Number of files (at most MP_REMOVE_BATCH_MAX)
+** @param  fids     The FIDs of the files
+** @param  errors   Returns the errno of each file removal (0 on success)
+**
+** @retval          0 when the storage answered / -1 on error (errno is set,
+**                  EOPNOTSUPP when the storaged does not know MP_REMOVE_BATCH)
+*/
+int mclient_remove_batch(mclient_t * clt, uint8_t spare, int nb, fid_t * fids, int * errors);
 
 int mclient_ports(mclient_t * mclt, int * single, mp_io_address_t * io_address_p);
 
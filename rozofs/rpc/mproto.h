@@ -45,6 +45,30 @@ struct mp_remove_arg_t {
 	mp_uuid_t fid;
 };
 typedef struct mp_remove_arg_t mp_remove_arg_t;
+#define MP_REMOVE_BATCH_MAX 256
+
+struct mp_remove_batch_arg_t {
+	uint16_t cid;
+	uint8_t sid;
+	uint8_t spare;
+	struct {
+		u_int fids_len;
+		mp_uuid_t *fids_val;
+	} fids;
+};
+typedef struct mp_remove_batch_arg_t mp_remove_batch_arg_t;
+
+struct mp_remove_batch_ret_t {
+	mp_status_t status;
+	union {
+		struct {
+			u_int errors_len;
+			int *errors_val;
+		} errors;
+		int error;
+	} mp_remove_batch_ret_t_u;
+};
+typedef struct mp_remove_batch_ret_t mp_remove_batch_ret_t;
 
 struct mp_stat_arg_t {
 	uint16_t cid;
@@ -134,6 +158,46 @@ struct mp_list_bins_files_arg_t {
 	uint64_t cookie;
 };
 typedef struct mp_list_bins_files_arg_t mp_list_bins_files_arg_t;
+#define MP_DIRTY_MAX_ENTRIES 100
+
+struct mp_dirty_entry_t {
+	mp_uuid_t fid;
+	uint32_t block_start;
+	uint32_t block_end;
+	uint8_t layout;
+	uint8_t bsize;
+	uint8_t dist_set[ROZOFS_SAFE_MAX];
+};
+typedef struct mp_dirty_entry_t mp_dirty_entry_t;
+
+struct dirty_list_t {
+	struct {
+		u_int entries_len;
+		mp_dirty_entry_t *entries_val;
+	} entries;
+	uint8_t eof;
+	uint8_t overflow;
+	uint64_t cookie;
+};
+typedef struct dirty_list_t dirty_list_t;
+
+struct mp_list_dirty_ret_t {
+	mp_status_t status;
+	union {
+		dirty_list_t reply;
+		int error;
+	} mp_list_dirty_ret_t_u;
+};
+typedef struct mp_list_dirty_ret_t mp_list_dirty_ret_t;
+
+struct mp_list_dirty_arg_t {
+	uint16_t cid;
+	uint8_t sid;
+	uint8_t dirty_sid;
+	uint8_t clear;
+	uint64_t cookie;
+};
+typedef struct mp_list_dirty_arg_t mp_list_dirty_arg_t;
 
 #define MONITOR_PROGRAM 0x20000003
 #define MONITOR_VERSION 1
@@ -157,6 +221,12 @@ extern  mp_list_bins_files_ret_t * mp_list_bins_files_1_svc(mp_list_bins_files_a
 #define MP_REMOVE2 5
 extern  mp_status_ret_t * mp_remove2_1(mp_remove2_arg_t *, CLIENT *);
 extern  mp_status_ret_t * mp_remove2_1_svc(mp_remove2_arg_t *, struct svc_req *);
+#define MP_LIST_DIRTY 6
+extern  mp_list_dirty_ret_t * mp_list_dirty_1(mp_list_dirty_arg_t *, CLIENT *);
+extern  mp_list_dirty_ret_t * mp_list_dirty_1_svc(mp_list_dirty_arg_t *, struct svc_req *);
+#define MP_REMOVE_BATCH 7
+extern  mp_remove_batch_ret_t * mp_remove_batch_1(mp_remove_batch_arg_t *, CLIENT *);
+extern  mp_remove_batch_ret_t * mp_remove_batch_1_svc(mp_remove_batch_arg_t *, struct svc_req *);
 extern int monitor_program_1_freeresult (SVCXPRT *, xdrproc_t, caddr_t);
 
 #else /* K&R C */
@@ -178,6 +248,12 @@ extern  mp_list_bins_files_ret_t * mp_list_bins_files_1_svc();
 #define MP_REMOVE2 5
 extern  mp_status_ret_t * mp_remove2_1();
 extern  mp_status_ret_t * mp_remove2_1_svc();
+#define MP_LIST_DIRTY 6
+extern  mp_list_dirty_ret_t * mp_list_dirty_1();
+extern  mp_list_dirty_ret_t * mp_list_dirty_1_svc();
+#define MP_REMOVE_BATCH 7
+extern  mp_remove_batch_ret_t * mp_remove_batch_1();
+extern  mp_remove_batch_ret_t * mp_remove_batch_1_svc();
 extern int monitor_program_1_freeresult ();
 #endif /* K&R C */
 
@@ -189,6 +265,8 @@ extern  bool_t xdr_mp_status_t (XDR *, mp_status_t*);
 extern  bool_t xdr_mp_status_ret_t (XDR *, mp_status_ret_t*);
 extern  bool_t xdr_mp_remove2_arg_t (XDR *, mp_remove2_arg_t*);
 extern  bool_t xdr_mp_remove_arg_t (XDR *, mp_remove_arg_t*);
+extern  bool_t xdr_mp_remove_batch_arg_t (XDR *, mp_remove_batch_arg_t*);
+extern  bool_t xdr_mp_remove_batch_ret_t (XDR *, mp_remove_batch_ret_t*);
 extern  bool_t xdr_mp_stat_arg_t (XDR *, mp_stat_arg_t*);
 extern  bool_t xdr_mp_sstat_t (XDR *, mp_sstat_t*);
 extern  bool_t xdr_mp_stat_ret_t (XDR *, mp_stat_ret_t*);
@@ -201,6 +279,10 @@ extern  bool_t xdr_mp_child_t (XDR *, mp_child_t*);
 extern  bool_t xdr_bins_files_list_t (XDR *, bins_files_list_t*);
 extern  bool_t xdr_mp_list_bins_files_ret_t (XDR *, mp_list_bins_files_ret_t*);
 extern  bool_t xdr_mp_list_bins_files_arg_t (XDR *, mp_list_bins_files_arg_t*);
+extern  bool_t xdr_mp_dirty_entry_t (XDR *, mp_dirty_entry_t*);
+extern  bool_t xdr_dirty_list_t (XDR *, dirty_list_t*);
+extern  bool_t xdr_mp_list_dirty_ret_t (XDR *, mp_list_dirty_ret_t*);
+extern  bool_t xdr_mp_list_dirty_arg_t (XDR *, mp_list_dirty_arg_t*);
 
 #else /* K&R C */
 extern bool_t xdr_mp_uuid_t ();
@@ -208,6 +290,8 @@ extern bool_t xdr_mp_status_t ();
 extern bool_t xdr_mp_status_ret_t ();
 extern bool_t xdr_mp_remove2_arg_t ();
 extern bool_t xdr_mp_remove_arg_t ();
+extern bool_t xdr_mp_remove_batch_arg_t ();
+extern bool_t xdr_mp_remove_batch_ret_t ();
 extern bool_t xdr_mp_stat_arg_t ();
 extern bool_t xdr_mp_sstat_t ();
 extern bool_t xdr_mp_stat_ret_t ();
@@ -220,6 +304,10 @@ extern bool_t xdr_mp_child_t ();
 extern bool_t xdr_bins_files_list_t ();
 extern bool_t xdr_mp_list_bins_files_ret_t ();
 extern bool_t xdr_mp_list_bins_files_arg_t ();
+extern bool_t xdr_mp_dirty_entry_t ();
+extern bool_t xdr_dirty_list_t ();
+extern bool_t xdr_mp_list_dirty_ret_t ();
+extern bool_t xdr_mp_list_dirty_arg_t ();
 
 #endif /* K&R C */
 
@@ -43,6 +43,21 @@ struct mp_remove_arg_t {
     mp_uuid_t   fid;
 };
 
+const MP_REMOVE_BATCH_MAX = 256;
+
+struct mp_remove_batch_arg_t {
+    uint16_t    cid;
+    uint8_t     sid;
+    uint8_t     spare;
+    mp_uuid_t   fids<MP_REMOVE_BATCH_MAX>;
+};
+
+union mp_remove_batch_ret_t switch (mp_status_t status) {
+    case MP_SUCCESS:    int     errors<MP_REMOVE_BATCH_MAX>;
+    case MP_FAILURE:    int     error;
+    default:            void;
+};
+
 struct mp_stat_arg_t {
     uint16_t    cid;
     uint8_t     sid;
@@ -116,6 +131,38 @@ struct mp_list_bins_files_arg_t {
     uint64_t   cookie;
 };
 
+const MP_DIRTY_MAX_ENTRIES = 100;
+
+struct mp_dirty_entry_t { 
+    mp_uuid_t       fid;
+    uint32_t        block_start;
+    uint32_t        block_end;
+    uint8_t         layout;
+    uint8_t         bsize;
+    uint8_t         dist_set[ROZOFS_SAFE_MAX];    
+};
+
+struct dirty_list_t {
+    mp_dirty_entry_t entries<MP_DIRTY_MAX_ENTRIES>;
+    uint8_t          eof;
+    uint8_t          overflow;
+    uint64_t         cookie;
+};
+
+union mp_list_dirty_ret_t switch (mp_status_t status) {
+    case MP_SUCCESS:    dirty_list_t            reply;
+    case MP_FAILURE:    int                     error;
+    default:            void;
+};
+
+struct mp_list_dirty_arg_t {
+    uint16_t   cid;
+    uint8_t    sid;
+    uint8_t    dirty_sid;
+    uint8_t    clear;
+    uint64_t   cookie;
+};
+
 program MONITOR_PROGRAM {
     version MONITOR_VERSION {
         void
@@ -136,5 +183,11 @@ program MONITOR_PROGRAM {
         mp_status_ret_t
         MP_REMOVE2(mp_remove2_arg_t)                    = 5;
 
+        mp_list_dirty_ret_t
+        MP_LIST_DIRTY(mp_list_dirty_arg_t)              = 6;
+
+        mp_remove_batch_ret_t
+        MP_REMOVE_BATCH(mp_remove_batch_arg_t)          = 7;
+
     }=1;
 } = 0x20000003;
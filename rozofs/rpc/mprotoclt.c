@@ -99,3 +99,33 @@ mp_remove2_1(mp_remove2_arg_t *argp, CLIENT *clnt)
 	}
 	return (&clnt_res);
 }
+
+mp_list_dirty_ret_t *
+mp_list_dirty_1(mp_list_dirty_arg_t *argp, CLIENT *clnt)
+{
+	static mp_list_dirty_ret_t clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MP_LIST_DIRTY,
+		(xdrproc_t) xdr_mp_list_dirty_arg_t, (caddr_t) argp,
+		(xdrproc_t) xdr_mp_list_dirty_ret_t, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
+
+mp_remove_batch_ret_t *
+mp_remove_batch_1(mp_remove_batch_arg_t *argp, CLIENT *clnt)
+{
+	static mp_remove_batch_ret_t clnt_res;
+
+	memset((char *)&clnt_res, 0, sizeof(clnt_res));
+	if (clnt_call (clnt, MP_REMOVE_BATCH,
+		(xdrproc_t) xdr_mp_remove_batch_arg_t, (caddr_t) argp,
+		(xdrproc_t) xdr_mp_remove_batch_ret_t, (caddr_t) &clnt_res,
+		TIMEOUT) != RPC_SUCCESS) {
+		return (NULL);
+	}
+	return (&clnt_res);
+}
@@ -25,6 +25,8 @@ monitor_program_1(struct svc_req *rqstp, register SVCXPRT *transp)
 		mp_remove_arg_t mp_remove_1_arg;
 		mp_list_bins_files_arg_t mp_list_bins_files_1_arg;
 		mp_remove2_arg_t mp_remove2_1_arg;
+		mp_list_dirty_arg_t mp_list_dirty_1_arg;
+		mp_remove_batch_arg_t mp_remove_batch_1_arg;
 	} argument;
 	char *result;
 	xdrproc_t _xdr_argument, _xdr_result;
@@ -67,6 +69,18 @@ monitor_program_1(struct svc_req *rqstp, register SVCXPRT *transp)
 		local = (char *(*)(char *, struct svc_req *)) mp_remove2_1_svc;
 		break;
 
+	case MP_LIST_DIRTY:
+		_xdr_argument = (xdrproc_t) xdr_mp_list_dirty_arg_t;
+		_xdr_result = (xdrproc_t) xdr_mp_list_dirty_ret_t;
+		local = (char *(*)(char *, struct svc_req *)) mp_list_dirty_1_svc;
+		break;
+
+	case MP_REMOVE_BATCH:
+		_xdr_argument = (xdrproc_t) xdr_mp_remove_batch_arg_t;
+		_xdr_result = (xdrproc_t) xdr_mp_remove_batch_ret_t;
+		local = (char *(*)(char *, struct svc_req *)) mp_remove_batch_1_svc;
+		break;
+
 	default:
 		svcerr_noproc (transp);
 		return;
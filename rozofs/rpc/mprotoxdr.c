@@ -75,6 +75,46 @@ xdr_mp_remove_arg_t (XDR *xdrs, mp_remove_arg_t *objp)
 	return TRUE;
 }
 
+bool_t
+xdr_mp_remove_batch_arg_t (XDR *xdrs, mp_remove_batch_arg_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_uint16_t (xdrs, &objp->cid))
+		 return FALSE;
+	 if (!xdr_uint8_t (xdrs, &objp->sid))
+		 return FALSE;
+	 if (!xdr_uint8_t (xdrs, &objp->spare))
+		 return FALSE;
+	 if (!xdr_array (xdrs, (char **)&objp->fids.fids_val, (u_int *) &objp->fids.fids_len, MP_REMOVE_BATCH_MAX,
+		sizeof (mp_uuid_t), (xdrproc_t) xdr_mp_uuid_t))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_mp_remove_batch_ret_t (XDR *xdrs, mp_remove_batch_ret_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_mp_status_t (xdrs, &objp->status))
+		 return FALSE;
+	switch (objp->status) {
+	case MP_SUCCESS:
+		 if (!xdr_array (xdrs, (char **)&objp->mp_remove_batch_ret_t_u.errors.errors_val, (u_int *) &objp->mp_remove_batch_ret_t_u.errors.errors_len, MP_REMOVE_BATCH_MAX,
+			sizeof (int), (xdrproc_t) xdr_int))
+			 return FALSE;
+		break;
+	case MP_FAILURE:
+		 if (!xdr_int (xdrs, &objp->mp_remove_batch_ret_t_u.error))
+			 return FALSE;
+		break;
+	default:
+		break;
+	}
+	return TRUE;
+}
+
 bool_t
 xdr_mp_stat_arg_t (XDR *xdrs, mp_stat_arg_t *objp)
 {
@@ -272,3 +312,82 @@ xdr_mp_list_bins_files_arg_t (XDR *xdrs, mp_list_bins_files_arg_t *objp)
 		 return FALSE;
 	return TRUE;
 }
+
+bool_t
+xdr_mp_dirty_entry_t (XDR *xdrs, mp_dirty_entry_t *objp)
+{
+	//register int32_t *buf;
+
+	//int i;
+	 if (!xdr_mp_uuid_t (xdrs, objp->fid))
+		 return FALSE;
+	 if (!xdr_uint32_t (xdrs, &objp->block_start))
+		 return FALSE;
+	 if (!xdr_uint32_t (xdrs, &objp->block_end))
+		 return FALSE;
+	 if (!xdr_uint8_t (xdrs, &objp->layout))
+		 return FALSE;
+	 if (!xdr_uint8_t (xdrs, &objp->bsize))
+		 return FALSE;
+	 if (!xdr_vector (xdrs, (char *)objp->dist_set, ROZOFS_SAFE_MAX,
+		sizeof (uint8_t), (xdrproc_t) xdr_uint8_t))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_dirty_list_t (XDR *xdrs, dirty_list_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_array (xdrs, (char **)&objp->entries.entries_val, (u_int *) &objp->entries.entries_len, MP_DIRTY_MAX_ENTRIES,
+		sizeof (mp_dirty_entry_t), (xdrproc_t) xdr_mp_dirty_entry_t))
+		 return FALSE;
+	 if (!xdr_uint8_t (xdrs, &objp->eof))
+		 return FALSE;
+	 if (!xdr_uint8_t (xdrs, &objp->overflow))
+		 return FALSE;
+	 if (!xdr_uint64_t (xdrs, &objp->cookie))
+		 return FALSE;
+	return TRUE;
+}
+
+bool_t
+xdr_mp_list_dirty_ret_t (XDR *xdrs, mp_list_dirty_ret_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_mp_status_t (xdrs, &objp->status))
+		 return FALSE;
+	switch (objp->status) {
+	case MP_SUCCESS:
+		 if (!xdr_dirty_list_t (xdrs, &objp->mp_list_dirty_ret_t_u.reply))
+			 return FALSE;
+		break;
+	case MP_FAILURE:
+		 if (!xdr_int (xdrs, &objp->mp_list_dirty_ret_t_u.error))
+			 return FALSE;
+		break;
+	default:
+		break;
+	}
+	return TRUE;
+}
+
+bool_t
+xdr_mp_list_dirty_arg_t (XDR *xdrs, mp_list_dirty_arg_t *objp)
+{
+	//register int32_t *buf;
+
+	 if (!xdr_uint16_t (xdrs, &objp->cid))
+		 return FALSE;
+	 if (!xdr_uint8_t (xdrs, &objp->sid))
+		 return FALSE;
+	 if (!xdr_uint8_t (xdrs, &objp->dirty_sid))
+		 return FALSE;
+	 if (!xdr_uint8_t (xdrs, &objp->clear))
+		 return FALSE;
+	 if (!xdr_uint64_t (xdrs, &objp->cookie))
+		 return FALSE;
+	return TRUE;
+}
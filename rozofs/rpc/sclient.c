@@ -58,6 +58,24 @@ void sclient_release(sclient_t * clt) {
         rpcclt_release(&clt->rpcclt);
 }
 
+/*
+** Same as the rpcgen client stubs but the result is given by the caller
+** instead of being static, so that the threads of a rebuild process can
+** each call their own storio connections at the same time.
+*/
+static inline void * sclient_call(CLIENT *clnt, u_long proc,
+                                  xdrproc_t xdr_args, void * args,
+                                  xdrproc_t xdr_res, void * res, int res_size) {
+    struct timeval TIMEOUT = { 25, 0 };
+
+    memset(res, 0, res_size);
+    if (clnt_call(clnt, proc, xdr_args, (caddr_t) args,
+                  xdr_res, (caddr_t) res, TIMEOUT) != RPC_SUCCESS) {
+        return NULL;
+    }
+    return res;
+}
+
 sp_write_ret_t * rbs_write(sp_write_arg_t *argp, CLIENT *clnt) {
 	static sp_write_ret_t clnt_res;
         struct timeval TIMEOUT = { 25, 0 };
@@ -83,6 +101,7 @@ int sclient_write_rbs(sclient_t * clt, cid_t cid, sid_t sid, uint8_t layout, uin
         uint32_t nb_proj, const bin_t * bins, uint32_t rebuild_ref) {
     int status = -1;
     sp_write_ret_t *ret = 0;
+    sp_write_ret_t res;
     sp_write_arg_t args;
     int            xerrno=0;
 
@@ -116,7 +135,9 @@ reloop:
     args.bins.bins_val = (char *) bins;
 
     if (!(clt->rpcclt.client) ||
-            !(ret = sp_write_1(&args, clt->rpcclt.client))) {
+            !(ret = sclient_call(clt->rpcclt.client, SP_WRITE,
+                                 (xdrproc_t) xdr_sp_write_arg_t, &args,
+                                 (xdrproc_t) xdr_sp_write_ret_t, &res, sizeof(res)))) {
         clt->status = 0;
         warning("sclient_write failed: no response from storage server"
                 " (%s, %u, %u)", clt->host, clt->port, sid);
@@ -148,6 +169,7 @@ int sclient_read_rbs(sclient_t * clt, cid_t cid, sid_t sid, uint8_t layout, uint
         uint32_t nb_proj, uint32_t * nb_proj_recv, bin_t * bins) {
     int status = -1;
     sp_read_ret_t *ret = 0;
+    sp_read_ret_t res;
     sp_read_arg_t args;
     uint16_t rozofs_max_psize_in_msg = rozofs_get_max_psize_in_msg(layout,bsize);
     int            xerrno=0;
@@ -168,7 +190,9 @@ int sclient_read_rbs(sclient_t * clt, cid_t cid, sid_t sid, uint8_t layout, uint
     args.nb_proj = nb_proj;
 
     if (!(clt->rpcclt.client) ||
-            !(ret = sp_read_1(&args, clt->rpcclt.client))) {
+            !(ret = sclient_call(clt->rpcclt.client, SP_READ,
+                                 (xdrproc_t) xdr_sp_read_arg_t, &args,
+                                 (xdrproc_t) xdr_sp_read_ret_t, &res, sizeof(res)))) {
         clt->status = 0;
         warning("sclient_read_rbs failed: storage read failed "
                 "(no response from storage server: %s)", clt->host);
@@ -237,6 +261,7 @@ int sclient_remove_chunk_rbs(sclient_t * clt, cid_t cid, sid_t sid, uint8_t layo
 			      fid_t fid, int chunk, uint32_t ref) {
     int status = -1;
     sp_status_ret_t *ret = 0;
+    sp_status_ret_t res;
     sp_remove_chunk_arg_t args;
     int            xerrno=0;
 
@@ -254,7 +279,9 @@ int sclient_remove_chunk_rbs(sclient_t * clt, cid_t cid, sid_t sid, uint8_t layo
     args.rebuild_ref = ref;
 
     if (!(clt->rpcclt.client) ||
-            !(ret = sp_remove_chunk_1(&args, clt->rpcclt.client))) {
+            !(ret = sclient_call(clt->rpcclt.client, SP_REMOVE_CHUNK,
+                                 (xdrproc_t) xdr_sp_remove_chunk_arg_t, &args,
+                                 (xdrproc_t) xdr_sp_status_ret_t, &res, sizeof(res)))) {
         clt->status = 0;
         warning("sclient_remove_chunk_rbs failed: storage remove failed "
                 "(no response from storage server: %s)", clt->host);
@@ -281,6 +308,7 @@ uint32_t sclient_rebuild_start_rbs(sclient_t * clt, cid_t cid, sid_t sid, fid_t
 				   uint64_t block_start, uint64_t block_stop) {
     uint32_t                ref = 0;
     sp_rebuild_start_ret_t *ret = 0;
+    sp_rebuild_start_ret_t  res;
     sp_rebuild_start_arg_t  args;
     int            xerrno=0;
 
@@ -297,7 +325,9 @@ uint32_t sclient_rebuild_start_rbs(sclient_t * clt, cid_t cid, sid_t sid, fid_t
     memcpy(args.fid, fid, sizeof (fid_t));
 
     if (!(clt->rpcclt.client) ||
-            !(ret = sp_rebuild_start_1(&args, clt->rpcclt.client))) {
+            !(ret = sclient_call(clt->rpcclt.client, SP_REBUILD_START,
+                                 (xdrproc_t) xdr_sp_rebuild_start_arg_t, &args,
+                                 (xdrproc_t) xdr_sp_rebuild_start_ret_t, &res, sizeof(res)))) {
         clt->status = 0;
         warning("sclient_rebuild_start_rbs failed:"
                 "(no response from storage server: %s)", clt->host);
@@ -324,6 +354,7 @@ out:
 int sclient_rebuild_stop_rbs(sclient_t * clt, cid_t cid, sid_t sid, fid_t fid, uint32_t ref, sp_status_t result) {
     int status = -1;
     sp_rebuild_stop_ret_t *ret = 0;
+    sp_rebuild_stop_ret_t res;
     sp_rebuild_stop_arg_t args;
     int            xerrno=0;
 
@@ -337,7 +368,9 @@ int sclient_rebuild_stop_rbs(sclient_t * clt, cid_t cid, sid_t sid, fid_t fid, u
     memcpy(args.fid, fid, sizeof (fid_t));
 
     if (!(clt->rpcclt.client) ||
-            !(ret = sp_rebuild_stop_1(&args, clt->rpcclt.client))) {
+            !(ret = sclient_call(clt->rpcclt.client, SP_REBUILD_STOP,
+                                 (xdrproc_t) xdr_sp_rebuild_stop_arg_t, &args,
+                                 (xdrproc_t) xdr_sp_rebuild_stop_ret_t, &res, sizeof(res)))) {
         clt->status = 0;
         warning("sclient_rebuild_stop_rbs failed:"
                 "(no response from storage server: %s)", clt->host);
@@ -41,6 +41,8 @@ struct spp_profiler_t {
     uint64_t    ports[2];
     uint64_t    remove[2];
     uint64_t    list_bins_files[2];
+    uint64_t    list_dirty[2];
+    uint64_t    remove_batch[2];
     uint16_t    nb_io_processes;
     /* io process(es) only */
     uint64_t    read[3];
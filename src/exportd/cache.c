@@ -903,7 +903,7 @@ void lv2_cache_initialize(lv2_cache_t *cache) {
     cache->miss = 0;
     cache->lru_del = 0;
     list_init(&cache->entries);
-    htable_initialize(&cache->htable, LV2_BUKETS, lv2_hash, lv2_cmp);
+    htable_initialize_oa(&cache->htable, LV2_BUKETS, 0, lv2_hash, lv2_cmp);
     
     /* 
     ** Lock service initalize 
@@ -2473,10 +2473,8 @@ get_next_collidx:
  * @retval -1 on failure
  */
 
-#define ROZOFS_READDIR_MAX_BYTES (64*1024-4096)
-#define MAX_DIR_ENTRIES_VERS2 (128+64)
-
-int list_mdirentries2(void *root_idx_bitmap_p,int dir_fd, fid_t fid_parent_in, char *buf_readdir_in, uint64_t *cookie, uint8_t * eof,ext_mattr_t *parent) {
+int list_mdirentries2(void *root_idx_bitmap_p,int dir_fd, fid_t fid_parent_in, char *buf_readdir_in, uint64_t *cookie, uint8_t * eof,ext_mattr_t *parent,
+                      fid_t *fid_tb, int max_entries, int max_bytes) {
     int root_idx = 0;
     int cached = 0;
     dirent_list_cookie_t dirent_cookie;
@@ -2564,7 +2562,7 @@ int list_mdirentries2(void *root_idx_bitmap_p,int dir_fd, fid_t fid_parent_in, c
      **  the last dirent root file index has been reached
      **___________________________________________________________
      */
-    while ((read_file < MAX_DIR_ENTRIES_VERS2) && ((int)(buf_readdir_p -buf_readdir_in) < ROZOFS_READDIR_MAX_BYTES)) {
+    while ((read_file < max_entries) && ((int)(buf_readdir_p -buf_readdir_in) < max_bytes)) {
         while (root_idx < DIRENT_ROOT_FILE_IDX_MAX) {
 
 	   /*
@@ -2785,7 +2783,7 @@ get_next_collidx:
         while (
 	       (hash_entry_idx < MDIRENTS_ENTRIES_COUNT) 
 	       && 
-	       ((read_file < MAX_DIR_ENTRIES_VERS2) &&((int)(buf_readdir_p -buf_readdir_in) < ROZOFS_READDIR_MAX_BYTES))
+	       ((read_file < max_entries) &&((int)(buf_readdir_p -buf_readdir_in) < max_bytes))
 	       ) {
             next_hash_entry_idx = DIRENT_CACHE_GETNEXT_ALLOCATED_HASH_ENTRY_IDX(&sect0_p->hash_bitmap, hash_entry_idx);
             if (next_hash_entry_idx < 0) {
@@ -2897,6 +2895,7 @@ get_next_collidx:
 		*/
 		inode_p = (rozofs_inode_t*) name_entry_p->fid;
 		buf_readdir_p = rozofs_fuse_add_dirent(buf_readdir_p,inode_p->fid[1],name_entry_p->name,name_entry_p->len,dirent_cookie.val64);
+		if (fid_tb != NULL) memcpy(fid_tb[read_file],name_entry_p->fid,sizeof(fid_t));
 	    }
             /*
              ** increment the number of file and try to get the next one
@@ -2909,7 +2908,7 @@ get_next_collidx:
         /*
          ** Check if the amount of file has been read
          */
-        if ((read_file >= MAX_DIR_ENTRIES_VERS2) || ((int)(buf_readdir_p -buf_readdir_in) >= ROZOFS_READDIR_MAX_BYTES)) {
+        if ((read_file >= max_entries) || ((int)(buf_readdir_p -buf_readdir_in) >= max_bytes)) {
             /*
              ** We are done
              */
@@ -1578,6 +1578,42 @@ epgw_readdir2_ret_t * ep_readdir2_1_svc(epgw_readdir_arg_t * arg,
     ret.status_gw.ep_readdir2_ret_t_u.error = ENOTSUP;
     return &ret;
 }
+/*
+**______________________________________________________________________________
+*/
+/**
+*   exportd batch of lookup/getattr: only supported by the non blocking service
+
+    @param args : the operations
+    
+    @retval: EP_FAILURE :ENOTSUP
+*/
+epgw_batch_ret_t * ep_batch_1_svc(epgw_batch_arg_t * arg,
+        struct svc_req * req) {
+    static epgw_batch_ret_t ret;
+
+    ret.status_gw.status = EP_FAILURE;
+    ret.status_gw.ep_batch_ret_t_u.error = ENOTSUP;
+    return &ret;
+}
+/*
+**______________________________________________________________________________
+*/
+/**
+*   exportd readdirplus: only supported by the non blocking service
+
+    @param args : fid of the directory
+    
+    @retval: EP_FAILURE :ENOTSUP
+*/
+epgw_readdirplus_ret_t * ep_readdirplus_1_svc(epgw_readdir_arg_t * arg,
+        struct svc_req * req) {
+    static epgw_readdirplus_ret_t ret;
+
+    ret.status_gw.status = EP_FAILURE;
+    ret.status_gw.ep_readdirplus_ret_t_u.error = ENOTSUP;
+    return &ret;
+}
 
 /* not used anymore
 ep_io_ret_t *ep_read_1_svc(ep_io_arg_t * arg, struct svc_req * req) {
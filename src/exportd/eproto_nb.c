@@ -31,10 +31,12 @@
 #include <rozofs/rpc/epproto.h>
 #include <rozofs/rpc/eproto.h>
 #include "eproto_nb.h"
+#include "export_shard.h"
 #include <rozofs/rpc/sproto.h>
 #include <rozofs/core/af_unix_socket_generic.h>
 
 #include "export.h"
+#include "mdirent.h"
 #include "volume.h"
 #include "exportd.h"
 #include "rozofs_ip4_flt.h"
@@ -1055,6 +1057,100 @@ out:
 **______________________________________________________________________________
 */
 /**
+*   exportd get attributes: processing in the shard thread of the FID
+
+    @param msg : shard message holding the arguments and the response
+*/
+static void ep_getattr_1_svc_shard(export_shard_msg_t * msg) {
+    epgw_mfile_arg_t * arg = (epgw_mfile_arg_t*)msg->arg; 
+    epgw_mattr_ret_t * ret = &msg->ret.mattr;
+    export_t *exp;
+    int rc;
+
+    ret->parent_attr.status = EP_EMPTY;
+    ret->hdr.eid = arg->arg_gw.eid ;  
+
+    if (!(exp = exports_lookup_export(arg->arg_gw.eid)))
+        goto error;
+    rc = export_getattr_th(exp, (unsigned char *) arg->arg_gw.fid,
+                           (mattr_t *) & ret->status_gw.ep_mattr_ret_t_u.attrs);
+    if (rc > 0) {
+        msg->status = EXPORT_SHARD_DEFERRED;
+        return;
+    }
+    if (rc != 0)
+        goto error;
+    ret->status_gw.status = EP_SUCCESS;
+    ret->bsize = exp->bsize;
+    ret->layout = exp->layout;
+    return;
+error:
+    ret->status_gw.status = EP_FAILURE;
+    ret->status_gw.ep_mattr_ret_t_u.error = errno;
+}
+/*
+**______________________________________________________________________________
+*/
+/**
+*   exportd get attributes: reply in the main thread once the shard thread
+    of the FID has processed the request
+
+    @param msg : shard message holding the arguments and the response
+*/
+static void ep_getattr_1_svc_shard_reply(export_shard_msg_t * msg) {
+    epgw_mfile_arg_t * arg = (epgw_mfile_arg_t*)msg->arg; 
+    rozorpc_srv_ctx_t *req_ctx_p = msg->req_ctx_p;
+    export_one_profiler_t * prof;
+    export_t *exp;
+    struct timeval tv;
+
+    if (msg->status == EXPORT_SHARD_DEFERRED) {
+      export_shard_lock_all();
+      ep_getattr_1_svc_nb(arg, req_ctx_p);
+      export_shard_unlock_all();
+      return;
+    }
+    /*
+    ** the exports may have been reloaded since the shard thread processing
+    */
+    if ((msg->ret.mattr.status_gw.status == EP_SUCCESS) 
+    &&  ((exp = exports_lookup_export(arg->arg_gw.eid)) != NULL)) {
+      msg->ret.mattr.free_quota = exportd_get_free_quota(exp);
+    }
+    /*
+    ** account the request from its dispatch to the shard thread
+    */
+    if (arg->arg_gw.eid <= EXPGW_EXPORTD_MAX_IDX) {
+      prof = export_profiler[arg->arg_gw.eid];
+      if (prof != NULL) {
+        gettimeofday(&tv,(struct timezone *)0);
+        prof->ep_getattr[P_COUNT]++;
+        prof->ep_getattr[P_ELAPSE] += (MICROLONG(tv) - msg->tic);
+      }
+    }
+    EXPORTS_SEND_REPLY_WITH_RET(req_ctx_p,&msg->ret.mattr);
+}
+/*
+**______________________________________________________________________________
+*/
+/**
+*   exportd get attributes: give the request to the shard thread of the FID
+
+    @param args : fid of the object 
+    
+    @retval 0 when a shard thread processes the request
+    @retval -1 when the request must be processed by ep_getattr_1_svc_nb()
+*/
+int ep_getattr_1_svc_post(void * pt, rozorpc_srv_ctx_t *req_ctx_p) {
+    epgw_mfile_arg_t * arg = (epgw_mfile_arg_t*)pt; 
+
+    return export_shard_post((unsigned char *) arg->arg_gw.fid, pt, req_ctx_p,
+                             ep_getattr_1_svc_shard, ep_getattr_1_svc_shard_reply);
+}
+/*
+**______________________________________________________________________________
+*/
+/**
 *   exportd set attributes
 
     @param args : fid of the object and attributes to set
@@ -1235,6 +1331,100 @@ out:
     STOP_PROFILING(ep_mknod);
     return ;
 }
+/*
+**______________________________________________________________________________
+*/
+/**
+*   exportd compound request: several lookup and getattr processed in
+    one pass, the response of each operation being in the same order as the
+    operations of the request
+
+    @param args : list of operations
+    
+    @retval: EP_SUCCESS :attributes of the object (and of the parent for
+                         lookup) or error code of every operation
+    @retval: EP_FAILURE :error code when no operation has been processed (errno)
+*/
+void ep_batch_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p) {
+    static epgw_batch_ret_t ret;
+    static ep_batch_res_t   res[EP_BATCH_MAX];
+    epgw_batch_arg_t * arg = (epgw_batch_arg_t*)pt; 
+    ep_batch_op_arg_t * op;
+    ep_batch_res_t * r;
+    export_t *exp = NULL;
+    uint32_t eid;
+    int idx;
+    int rc;
+    DEBUG_FUNCTION;
+
+    // Set profiler export index
+    export_profiler_eid = arg->hdr.eid;
+
+    START_PROFILING(ep_batch);
+
+    ret.hdr.eid = arg->hdr.eid;
+    if (arg->ops.ops_len > EP_BATCH_MAX) {
+        errno = EINVAL;
+        goto error;
+    }
+    if (!(exp = exports_lookup_export(arg->hdr.eid)))
+        goto error;
+
+    for (idx = 0; idx < arg->ops.ops_len; idx++) {
+        op = &arg->ops.ops_val[idx];
+        r  = &res[idx];
+        r->parent_attr.status = EP_EMPTY;
+        /*
+        ** Every operation must be on the export of the request
+        */
+        switch (op->op) {
+          case EP_BATCH_LOOKUP:  eid = op->ep_batch_op_arg_t_u.lookup.eid;  break;
+          case EP_BATCH_GETATTR: eid = op->ep_batch_op_arg_t_u.getattr.eid; break;
+          default:               eid = (uint32_t) -1;                        break;
+        }
+        if (eid != arg->hdr.eid) {
+            r->status_gw.status = EP_FAILURE;
+            r->status_gw.ep_mattr_ret_t_u.error = EINVAL;
+            continue;
+        }
+
+        switch (op->op) {
+
+          case EP_BATCH_LOOKUP:
+            rc = export_lookup(exp, (unsigned char *) op->ep_batch_op_arg_t_u.lookup.parent,
+                               op->ep_batch_op_arg_t_u.lookup.name,
+                               (mattr_t *) & r->status_gw.ep_mattr_ret_t_u.attrs,
+                               (mattr_t *) & r->parent_attr.ep_mattr_ret_t_u.attrs);
+            break;
+
+          default:
+            rc = export_getattr(exp, (unsigned char *) op->ep_batch_op_arg_t_u.getattr.fid,
+                                (mattr_t *) & r->status_gw.ep_mattr_ret_t_u.attrs);
+            break;
+        }
+        if (rc != 0) {
+            r->status_gw.status = EP_FAILURE;
+            r->status_gw.ep_mattr_ret_t_u.error = errno;
+            continue;
+        }
+        r->status_gw.status = EP_SUCCESS;
+        if (op->op == EP_BATCH_LOOKUP) r->parent_attr.status = EP_SUCCESS;
+    }
+    ret.status_gw.status = EP_SUCCESS;
+    ret.status_gw.ep_batch_ret_t_u.batch.free_quota = exportd_get_free_quota(exp);
+    ret.status_gw.ep_batch_ret_t_u.batch.bsize  = exp->bsize;
+    ret.status_gw.ep_batch_ret_t_u.batch.layout = exp->layout;
+    ret.status_gw.ep_batch_ret_t_u.batch.res.res_len = arg->ops.ops_len;
+    ret.status_gw.ep_batch_ret_t_u.batch.res.res_val = res;
+    goto out;
+error:
+    ret.status_gw.status = EP_FAILURE;
+    ret.status_gw.ep_batch_ret_t_u.error = errno;
+out:
+    EXPORTS_SEND_REPLY(req_ctx_p);
+    STOP_PROFILING(ep_batch);
+    return ;
+}
 
 /*
 **______________________________________________________________________________
@@ -1617,6 +1807,60 @@ out:
     STOP_PROFILING(ep_readdir);
     return ;
 }
+/*
+**______________________________________________________________________________
+*/
+/**
+*   exportd readdirplus: list the content of a directory with the attributes
+    of the entries
+
+    @param args : fid of the directory
+    
+    @retval: EP_SUCCESS :dirents, attributes of the entries and cookie for next readdir
+    @retval: EP_FAILURE :error code associated with the operation (errno)
+*/
+void ep_readdirplus_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p) {
+    static epgw_readdirplus_ret_t ret;
+    static char       dirents[ROZOFS_READDIRPLUS_MAX_BYTES+4096];
+    static ep_mattr_t attrs[MAX_DIR_ENTRIES_PLUS];
+    epgw_readdir_arg_t * arg = (epgw_readdir_arg_t*)pt;
+    export_t *exp;
+    int len;
+    int nb_attrs;
+    DEBUG_FUNCTION;
+
+    // Set profiler export index
+    export_profiler_eid = arg->arg_gw.eid;
+
+    START_PROFILING(ep_readdirplus);
+
+    ret.status_gw.ep_readdirplus_ret_t_u.reply.eof = 0;
+
+    if (!(exp = exports_lookup_export(arg->arg_gw.eid)))
+        goto error;
+
+    len = export_readdirplus(exp, (unsigned char *) arg->arg_gw.fid, &arg->arg_gw.cookie,
+                             dirents, (uint8_t *) & ret.status_gw.ep_readdirplus_ret_t_u.reply.eof,
+                             (mattr_t *) attrs, &nb_attrs);
+    if (len < 0)
+        goto error;
+
+    ret.status_gw.ep_readdirplus_ret_t_u.reply.cookie = arg->arg_gw.cookie;
+    ret.status_gw.ep_readdirplus_ret_t_u.reply.value.value_len = len;
+    ret.status_gw.ep_readdirplus_ret_t_u.reply.value.value_val = dirents;
+    ret.status_gw.ep_readdirplus_ret_t_u.reply.attrs.attrs_len = nb_attrs;
+    ret.status_gw.ep_readdirplus_ret_t_u.reply.attrs.attrs_val = attrs;
+
+    ret.status_gw.status = EP_SUCCESS;
+    goto out;
+error:
+    ret.status_gw.status = EP_FAILURE;
+    ret.status_gw.ep_readdirplus_ret_t_u.error = errno;
+out:
+    EXPORTS_SEND_REPLY(req_ctx_p);
+    STOP_PROFILING(ep_readdirplus);
+    return ;
+}
 
 /* not used anymore
 ep_io_ret_t *ep_read_1_svc_nb(ep_io_arg_t * arg; void * pt, rozorpc_srv_ctx_t *req_ctx_p) {
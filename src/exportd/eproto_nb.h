@@ -43,10 +43,13 @@ void ep_umount_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
 void ep_statfs_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
 void ep_lookup_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
 void ep_getattr_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
+int ep_getattr_1_svc_post(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
 void ep_setattr_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
 void ep_readlink_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
 void ep_link_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
 void ep_mknod_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
+void ep_batch_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
+void ep_readdirplus_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
 void ep_mkdir_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
 void ep_unlink_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
 void ep_rmdir_1_svc_nb(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
@@ -21,6 +21,7 @@
 #include <rozofs/rpc/rozofs_rpc_util.h>
 #include "eproto_nb.h"
 #include "eprotosvc_nb.h"
+#include "export_shard.h"
 
 
 
@@ -229,6 +230,20 @@ void expnb_req_rcv_cbk(void *userRef,uint32_t  socket_ctx_idx, void *recv_buf)
 	     size = sizeof(epgw_readdir_arg_t);
 	     break;
 
+     case EP_READDIRPLUS:
+	     rozorpc_srv_ctx_p->arg_decoder = (xdrproc_t) xdr_epgw_readdir_arg_t;
+	     rozorpc_srv_ctx_p->xdr_result = (xdrproc_t) xdr_epgw_readdirplus_ret_t;
+	     local =  ep_readdirplus_1_svc_nb;
+	     size = sizeof(epgw_readdir_arg_t);
+	     break;
+
+     case EP_BATCH:
+	     rozorpc_srv_ctx_p->arg_decoder = (xdrproc_t) xdr_epgw_batch_arg_t;
+	     rozorpc_srv_ctx_p->xdr_result = (xdrproc_t) xdr_epgw_batch_ret_t;
+	     local =  ep_batch_1_svc_nb;
+	     size = sizeof(epgw_batch_arg_t);
+	     break;
+
      case EP_READ_BLOCK:
 	     rozorpc_srv_ctx_p->arg_decoder = (xdrproc_t) xdr_epgw_io_arg_t;
 	     rozorpc_srv_ctx_p->xdr_result = (xdrproc_t) xdr_epgw_read_block_ret_t;
@@ -389,7 +404,13 @@ void expnb_req_rcv_cbk(void *userRef,uint32_t  socket_ctx_idx, void *recv_buf)
     }  
     
     /*
-    ** call the user call-back
+    ** the getattr requests go to the shard thread of their FID
+    */
+    if ((hdr.proc == EP_GETATTR) && (ep_getattr_1_svc_post(arguments, rozorpc_srv_ctx_p) == 0)) return;
+    /*
+    ** call the user call-back with every metadata shard locked
     */
+    export_shard_lock_all();
     (*local)(arguments, rozorpc_srv_ctx_p);    
+    export_shard_unlock_all();
 }
@@ -77,6 +77,19 @@ static inline uint32_t lv2_hash(void *key) {
     return hash;
 }
 
+/*
+**__________________________________________________________________
+*/
+/**
+*   Hash value of a FID in the attribute cache. The multi-thread services
+    use the lock and the LRU list of index hash % ROZOFS_HTABLE_MAX_LOCK
+
+    @param fid: the FID
+*/
+uint32_t lv2_cache_hash(fid_t fid) {
+    return lv2_hash(fid);
+}
+
 static inline int lv2_cmp(void *k1, void *k2) {
     rozofs_inode_t fake_inode1;
     rozofs_inode_t fake_inode2;  
@@ -147,7 +160,8 @@ void lv2_cache_initialize(lv2_cache_t *cache) {
     cache->lru_del = 0;
     list_init(&cache->lru);
     list_init(&cache->flock_list);
-    htable_initialize(&cache->htable, LV2_BUKETS, lv2_hash, lv2_cmp);
+    cache->per_lock_lru = 0;
+    htable_initialize_oa(&cache->htable, LV2_BUKETS, ROZOFS_HTABLE_MAX_LOCK, lv2_hash, lv2_cmp);
     for (i = 0; i < EXPORT_LV2_MAX_LOCK; i++)
     {
       list_init(&cache->lru_th[i]);
@@ -172,6 +186,7 @@ void lv2_cache_initialize(lv2_cache_t *cache) {
 */
 void lv2_cache_release(lv2_cache_t *cache) {
     list_t *p, *q;
+    int     i;
 
     list_for_each_forward_safe(p, q, &cache->lru) {
         lv2_entry_t *entry = list_entry(p, lv2_entry_t, list);
@@ -183,6 +198,44 @@ void lv2_cache_release(lv2_cache_t *cache) {
         htable_del(&cache->htable, entry->attributes.s.attrs.fid);
 	lv2_cache_unlink(cache,entry);
     }
+    for (i = 0; i < EXPORT_LV2_MAX_LOCK; i++) {
+      list_for_each_forward_safe(p, q, &cache->lru_th[i]) {
+          lv2_entry_t *entry = list_entry(p, lv2_entry_t, list);
+          htable_del(&cache->htable, entry->attributes.s.attrs.fid);
+	  lv2_cache_unlink(cache,entry);
+      }
+      list_for_each_forward_safe(p, q, &cache->flock_list_th[i]) {
+          lv2_entry_t *entry = list_entry(p, lv2_entry_t, list);
+          htable_del(&cache->htable, entry->attributes.s.attrs.fid);
+	  lv2_cache_unlink(cache,entry);
+      }
+    }
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*   Move the entries of the global LRU and file lock lists to the lists of
+    the lock of their hash value. Called once by the main thread before
+    the metadata shard threads are started.
+
+    @param: pointer to the cache context
+    
+    @retval none
+*/
+void lv2_cache_split_lru(lv2_cache_t *cache) {
+    list_t *p, *q;
+
+    /*
+    ** Going from the tail to the head keeps the LRU order in each list
+    */
+    cache->per_lock_lru = 1;
+    list_for_each_backward_safe(p, q, &cache->lru) {
+        lv2_cache_update_lru(cache,list_entry(p, lv2_entry_t, list));
+    }
+    list_for_each_backward_safe(p, q, &cache->flock_list) {
+        lv2_cache_update_lru(cache,list_entry(p, lv2_entry_t, list));
+    }
 }
 /*
 **__________________________________________________________________
@@ -320,6 +373,7 @@ int exp_meta_get_xattr_block(export_tracking_table_t *trk_tb_p,lv2_entry_t *entr
 lv2_entry_t *lv2_cache_put(export_tracking_table_t *trk_tb_p,lv2_cache_t *cache, fid_t fid) {
     lv2_entry_t *entry;
     int count=0;
+    list_t *lru_list;
     rozofs_inode_t *fake_inode,*fake_inode_attr;
    
     fake_inode = (rozofs_inode_t*)fid;
@@ -376,10 +430,12 @@ lv2_entry_t *lv2_cache_put(export_tracking_table_t *trk_tb_p,lv2_cache_t *cache,
     ** Try to remove older entries
     */
     count = 0;
-    while ((cache->size >= cache->max) && (!list_empty(&cache->lru))){ 
+    if (cache->per_lock_lru) lru_list = &cache->lru_th[lv2_hash(fid)%cache->htable.lock_size];
+    else                     lru_list = &cache->lru;
+    while ((cache->size >= cache->max) && (!list_empty(lru_list))){ 
       lv2_entry_t *lru;
 		
-	  lru = list_entry(cache->lru.prev, lv2_entry_t, list);  
+	  lru = list_entry(lru_list->prev, lv2_entry_t, list);  
  	  if (lru->nb_locks != 0) {
 	    severe("lv2 with %d locks in lru",lru->nb_locks);
  	  }
@@ -433,6 +489,7 @@ out:
 lv2_entry_t *lv2_cache_put_forced(lv2_cache_t *cache, fid_t fid,ext_mattr_t *attr_p) {
     lv2_entry_t *entry;
     int count=0;
+    list_t *lru_list;
 
     // maybe already cached.
     if ((entry = htable_get(&cache->htable, fid)) != 0) {
@@ -464,10 +521,12 @@ lv2_entry_t *lv2_cache_put_forced(lv2_cache_t *cache, fid_t fid,ext_mattr_t *att
     ** Try to remove older entries
     */
     count = 0;
-    while ((cache->size >= cache->max) && (!list_empty(&cache->lru))){ 
+    if (cache->per_lock_lru) lru_list = &cache->lru_th[lv2_hash(fid)%cache->htable.lock_size];
+    else                     lru_list = &cache->lru;
+    while ((cache->size >= cache->max) && (!list_empty(lru_list))){ 
       lv2_entry_t *lru;
 		
-	  lru = list_entry(cache->lru.prev, lv2_entry_t, list);  
+	  lru = list_entry(lru_list->prev, lv2_entry_t, list);  
  	  if (lru->nb_locks != 0) {
 	    severe("lv2 with %d locks in lru",lru->nb_locks);
  	  }
@@ -1364,23 +1423,26 @@ void exp_release_attributes_tracking_context(export_tracking_table_t *tab_p)
  *___________________________________________________________________
  */
 static inline void lv2_cache_update_lru_th(lv2_cache_t *cache, lv2_entry_t *entry,uint32_t hash) {
+    /*
+    ** The entry is on a list of the same lock, be it inserted by the 
+    ** main thread or by a shard thread
+    */
+    pthread_rwlock_wrlock(&cache->htable.lock[hash%cache->htable.lock_size]);
     list_remove(&entry->list);
     if (entry->nb_locks == 0) {
-        pthread_rwlock_wrlock(&cache->htable.lock[hash%cache->htable.lock_size]);
         list_push_front(&cache->lru_th[hash%cache->htable.lock_size], &entry->list);
-        pthread_rwlock_unlock(&cache->htable.lock[hash%cache->htable.lock_size]);
     }
     else {
-        pthread_rwlock_wrlock(&cache->htable.lock[hash%cache->htable.lock_size]);
         list_push_front(&cache->flock_list_th[hash%cache->htable.lock_size], &entry->list);    
-        pthread_rwlock_unlock(&cache->htable.lock[hash%cache->htable.lock_size]);
     }
+    pthread_rwlock_unlock(&cache->htable.lock[hash%cache->htable.lock_size]);
 }
 /*
 **__________________________________________________________________
 */
 /**
-*   Remove an entry from the attribute cache
+*   Remove an entry from the attribute cache. The file locks of the entry
+    are left to the caller.
 
     @param cache: pointer to the cache context
     @param entry: pointer to entry to remove
@@ -1390,7 +1452,6 @@ static inline void lv2_cache_update_lru_th(lv2_cache_t *cache, lv2_entry_t *entr
 */
 static inline void lv2_cache_unlink_th(lv2_cache_t *cache,lv2_entry_t *entry,uint32_t hash) {
 
-  file_lock_remove_fid_locks(&entry->file_lock);
   mattr_release(&entry->attributes.s.attrs);
   /*
   ** check the presence of the extended attribute block and free it
@@ -1408,9 +1469,58 @@ static inline void lv2_cache_unlink_th(lv2_cache_t *cache,lv2_entry_t *entry,uin
   pthread_rwlock_wrlock(&cache->htable.lock[hash%cache->htable.lock_size]);  
   list_remove(&entry->list);
   pthread_rwlock_unlock(&cache->htable.lock[hash%cache->htable.lock_size]);  
+  /*
+  ** remove from the move_list
+  */
+  list_remove(&entry->move_list);  
 
   free(entry);
-  cache->size--;  
+  __atomic_fetch_sub(&cache->size,1,__ATOMIC_RELAXED);
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*   Remove up to 3 older entries from the LRU list of a lock. The lock is
+    released before removing an entry from the hash table, that takes the
+    same lock.
+
+    @param cache: pointer to the cache context
+    @param hash: hash value giving the lock
+    
+    @retval none
+*/
+static inline void lv2_cache_evict_th(lv2_cache_t *cache,uint32_t hash) {
+  list_t      *lru_list = &cache->lru_th[hash%cache->htable.lock_size];
+  lv2_entry_t *lru;
+  uint32_t     lru_hash;
+  int          count;
+
+  for (count = 0; count < 3; count++) {
+    pthread_rwlock_wrlock(&cache->htable.lock[hash%cache->htable.lock_size]);
+    if (list_empty(lru_list)) {
+      pthread_rwlock_unlock(&cache->htable.lock[hash%cache->htable.lock_size]);
+      break;
+    }
+    lru = list_entry(lru_list->prev, lv2_entry_t, list);
+    /*
+    ** Entries locked in the cache by the main thread are kept, and so are
+    ** the entries that carry file locks, since the file lock lists are
+    ** only handled by the main thread
+    */
+    if ((lru->locked_in_cache) || (lru->nb_locks != 0) || (!list_empty(&lru->file_lock))) {
+      pthread_rwlock_unlock(&cache->htable.lock[hash%cache->htable.lock_size]);
+      break;
+    }
+    list_remove(&lru->list);
+    list_init(&lru->list);
+    pthread_rwlock_unlock(&cache->htable.lock[hash%cache->htable.lock_size]);
+
+    lru_hash = lv2_hash(lru->attributes.s.attrs.fid);
+    htable_del_th(&cache->htable, lru->attributes.s.attrs.fid, lru_hash);
+    lv2_cache_unlink_th(cache,lru,lru_hash);
+    __atomic_fetch_add(&cache->lru_del,1,__ATOMIC_RELAXED);
+  }
 }
 /*
 **__________________________________________________________________
@@ -1432,10 +1542,10 @@ lv2_entry_t *lv2_cache_get_th(lv2_cache_t *cache, fid_t fid,uint32_t hash)
     if ((entry = htable_get_th(&cache->htable, fid,hash)) != 0) {
         // Update the lru
         lv2_cache_update_lru_th(cache,entry,hash); 
-	cache->hit++;
+	__atomic_fetch_add(&cache->hit,1,__ATOMIC_RELAXED);
     }
     else {
-      cache->miss++;
+      __atomic_fetch_add(&cache->miss,1,__ATOMIC_RELAXED);
     }
     return entry;
 }
@@ -1458,7 +1568,6 @@ lv2_entry_t *lv2_cache_get_th(lv2_cache_t *cache, fid_t fid,uint32_t hash)
 lv2_entry_t *lv2_cache_put_th(export_tracking_table_t *trk_tb_p,lv2_cache_t *cache, fid_t fid,uint32_t hash) 
 {
     lv2_entry_t *entry;
-    int count=0;
     rozofs_inode_t *fake_inode,*fake_inode_attr;
    
     fake_inode = (rozofs_inode_t*)fid;
@@ -1506,37 +1615,21 @@ lv2_entry_t *lv2_cache_put_th(export_tracking_table_t *trk_tb_p,lv2_cache_t *cac
     list_init(&entry->file_lock);
     entry->nb_locks = 0;
     list_init(&entry->list);
+    /*
+    ** init of the move list
+    */
+    list_init(&entry->move_list);
 
     /*
     ** Try to remove older entries
     */
-    count = 0;
-    if (cache->size >= cache->max)
-    {
-        pthread_rwlock_wrlock(&cache->htable.lock[hash%cache->htable.lock_size]);
-	while(!list_empty(&cache->lru_th[hash%cache->htable.lock_size]))
-	{
-          lv2_entry_t *lru;
-
-	  lru = list_entry(cache->lru_th[hash%cache->htable.lock_size].prev, lv2_entry_t, list);  
- 	  if (lru->nb_locks != 0) {
-	    severe("lv2 with %d locks in lru",lru->nb_locks);
- 	  }	
-	  htable_del(&cache->htable, lru->attributes.s.attrs.fid);
-	  lv2_cache_unlink(cache,lru);
-	  cache->lru_del++;
-	  count++;
-	  if (count >= 3) break;	
-	
-	}
-        pthread_rwlock_unlock(&cache->htable.lock[hash%cache->htable.lock_size]);
-    }
+    if (__atomic_load_n(&cache->size,__ATOMIC_RELAXED) >= cache->max) lv2_cache_evict_th(cache,hash);
     /*
     ** Insert the new entry
     */
     lv2_cache_update_lru_th(cache,entry,hash);
     htable_put_th(&cache->htable, entry->attributes.s.attrs.fid, entry,hash);
-    cache->size++;    
+    __atomic_fetch_add(&cache->size,1,__ATOMIC_RELAXED);
 
     goto out;
 error:
@@ -1565,7 +1658,6 @@ out:
 
 lv2_entry_t *lv2_cache_put_forced_th(lv2_cache_t *cache, fid_t fid,ext_mattr_t *attr_p) {
     lv2_entry_t *entry;
-    int count=0;
     uint32_t hash = lv2_hash(fid);
 
     // maybe already cached.
@@ -1590,37 +1682,21 @@ lv2_entry_t *lv2_cache_put_forced_th(lv2_cache_t *cache, fid_t fid,ext_mattr_t *
     list_init(&entry->file_lock);
     entry->nb_locks = 0;
     list_init(&entry->list);
+    /*
+    ** init of the move list
+    */
+    list_init(&entry->move_list);
 
     /*
     ** Try to remove older entries
     */
-    count = 0;
-    if (cache->size >= cache->max)
-    {
-        pthread_rwlock_wrlock(&cache->htable.lock[hash%cache->htable.lock_size]);
-	while(!list_empty(&cache->lru_th[hash%cache->htable.lock_size]))
-	{
-          lv2_entry_t *lru;
-
-	  lru = list_entry(cache->lru_th[hash%cache->htable.lock_size].prev, lv2_entry_t, list);  
- 	  if (lru->nb_locks != 0) {
-	    severe("lv2 with %d locks in lru",lru->nb_locks);
- 	  }	
-	  htable_del(&cache->htable, lru->attributes.s.attrs.fid);
-	  lv2_cache_unlink(cache,lru);
-	  cache->lru_del++;
-	  count++;
-	  if (count >= 3) break;	
-	
-	}
-        pthread_rwlock_unlock(&cache->htable.lock[hash%cache->htable.lock_size]);
-    }
+    if (__atomic_load_n(&cache->size,__ATOMIC_RELAXED) >= cache->max) lv2_cache_evict_th(cache,hash);
     /*
     ** Insert the new entry
     */
     lv2_cache_update_lru_th(cache,entry,hash);
     htable_put_th(&cache->htable, entry->attributes.s.attrs.fid, entry,hash);
-    cache->size++;    
+    __atomic_fetch_add(&cache->size,1,__ATOMIC_RELAXED);
 out:
     return entry;
 }
@@ -1644,7 +1720,7 @@ lv2_entry_t *export_lookup_fid_th(export_tracking_table_t *trk_tb_p,lv2_cache_t
     uint32_t slice;
     uint32_t hash = lv2_hash(fid);
     
-    cache->hash_stats[hash%EXPORT_LV2_MAX_LOCK]++;
+    __atomic_fetch_add(&cache->hash_stats[hash%EXPORT_LV2_MAX_LOCK],1,__ATOMIC_RELAXED);
 
     /*
     ** get the slice of the fid :extracted from the upper part 
@@ -1697,6 +1773,7 @@ void lv2_cache_del_th(lv2_cache_t *cache, fid_t fid)
     lv2_entry_t *entry = 0;
     uint32_t hash = lv2_hash(fid);
     if ((entry = htable_del_th(&cache->htable, fid,hash)) != 0) {
+        file_lock_remove_fid_locks(&entry->file_lock);
 	lv2_cache_unlink_th(cache,entry,hash);
     }
 }
@@ -104,8 +104,11 @@ typedef struct lv2_cache {
     list_t     lru;     ///< LRU 
     list_t     flock_list;
     /*
-    ** case of multi-threads
+    ** case of multi-threads: once per_lock_lru is set, an entry is on the
+    ** LRU (or the file lock list) of the lock of its hash value, whatever
+    ** the thread that inserted it
     */
+    int        per_lock_lru;
     list_t     lru_th[EXPORT_LV2_MAX_LOCK];     ///< LRU 
     list_t     flock_list_th[EXPORT_LV2_MAX_LOCK];
     uint64_t   hash_stats[EXPORT_LV2_MAX_LOCK];
@@ -196,6 +199,19 @@ void lv2_cache_initialize(lv2_cache_t *cache);
     @retval none
 */
 void lv2_cache_release(lv2_cache_t *cache);
+/*
+**__________________________________________________________________
+*/
+/**
+*   Move the entries of the global LRU and file lock lists to the lists of
+    the lock of their hash value. Called once by the main thread before
+    the metadata shard threads are started.
+
+    @param: pointer to the cache context
+    
+    @retval none
+*/
+void lv2_cache_split_lru(lv2_cache_t *cache);
 
 /*
 **__________________________________________________________________
@@ -240,6 +256,16 @@ lv2_entry_t *lv2_cache_put_th(export_tracking_table_t *trk_tb_p,lv2_cache_t *cac
 
 lv2_entry_t *lv2_cache_put_forced(lv2_cache_t *cache, fid_t fid,ext_mattr_t *attr_p);
 lv2_entry_t *lv2_cache_put_forced_th(lv2_cache_t *cache, fid_t fid,ext_mattr_t *attr_p);
+/*
+**__________________________________________________________________
+*/
+/**
+*   Hash value of a FID in the attribute cache. The multi-thread services
+    use the lock and the LRU list of index hash % ROZOFS_HTABLE_MAX_LOCK
+
+    @param fid: the FID
+*/
+uint32_t lv2_cache_hash(fid_t fid);
 
 /** Format statistics information about the lv2 cache
  *
@@ -259,12 +285,24 @@ char * lv2_cache_display(lv2_cache_t *cache, char * pChar) ;
  *___________________________________________________________________
  */
 static inline void lv2_cache_update_lru(lv2_cache_t *cache, lv2_entry_t *entry) {
+    uint32_t lock;
+
     list_remove(&entry->list);
+    if (cache->per_lock_lru == 0) {
+        if (entry->nb_locks == 0) {
+            list_push_front(&cache->lru, &entry->list);
+        }
+        else {
+            list_push_front(&cache->flock_list, &entry->list);    
+        }
+        return;
+    }
+    lock = lv2_cache_hash(entry->attributes.s.attrs.fid) % cache->htable.lock_size;
     if (entry->nb_locks == 0) {
-        list_push_front(&cache->lru, &entry->list);
+        list_push_front(&cache->lru_th[lock], &entry->list);
     }
     else {
-        list_push_front(&cache->flock_list, &entry->list);    
+        list_push_front(&cache->flock_list_th[lock], &entry->list);    
     }
 }
 /*
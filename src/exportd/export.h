@@ -331,6 +331,21 @@ int export_lookup(export_t *e, fid_t pfid, char *name, mattr_t * attrs, mattr_t
  */
 int export_getattr(export_t *e, fid_t fid, mattr_t * attrs);
 
+/** get attributes of a managed file from a metadata shard thread
+ *
+ * Only the multi-thread services of the attribute cache are used, so the
+ * caller must own the shard lock of the FID, and the FID must be in a local
+ * slice. A file with a pending move is left to the main thread.
+ *
+ * @param e: the export managing the file
+ * @param fid: the id of the file
+ * @param attrs: attributes to fill.
+ *
+ * @return: 0 on success, 1 when the main thread must process the request,
+ *          -1 otherwise (errno is set)
+ */
+int export_getattr_th(export_t *e, fid_t fid, mattr_t * attrs);
+
 /** set attributes of a managed file
  *
  * @param e: the export managing the file
@@ -526,6 +541,21 @@ int export_readdir(export_t * e, fid_t fid, uint64_t * cookie, child_t **childre
 
 int export_readdir2(export_t * e, fid_t fid, uint64_t * cookie,
         char *buf_readdir, uint8_t * eof);
+
+/** read a directory with the attributes of its entries (readdirplus)
+ *
+ * @param e: the export managing the file
+ * @param fid: the id of the directory
+ * @param cookie: index mdirentries where we must begin to list the mdirentries
+ * @param buf_readdir: buffer where the fuse dirents are written
+ * @param eof: pointer that indicates if we list all the entries or not
+ * @param attrs: table of MAX_DIR_ENTRIES_PLUS attributes of the entries
+ * @param nb_attrs: number of attributes filled
+ *
+ * @return: size of the dirents on success -1 otherwise (errno is set)
+ */
+int export_readdirplus(export_t * e, fid_t fid, uint64_t * cookie,
+        char *buf_readdir, uint8_t * eof, mattr_t *attrs, int *nb_attrs);
 	
 /** retrieve an extended attribute value.
  *
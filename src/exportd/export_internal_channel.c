@@ -36,6 +36,7 @@
 #include "export_internal_channel.h"
 #include <rozofs/rpc/gwproto.h>
 #include "export_expgateway_conf.h"
+#include "export_shard.h"
 
 
 
@@ -464,7 +465,12 @@ uint32_t expgwc_internal_channel_recv_cbk(void * not_significant,int socketId)
       break;
 
     case EXPORT_LOAD_CONF:
+      /*
+      ** the shard threads use the exports being reloaded
+      */
+      export_shard_lock_all();
       ret = export_reload_nb();
+      export_shard_unlock_all();
       export_reload_conf_status.done   = 1;
       export_reload_conf_status.status = ret;
       break;
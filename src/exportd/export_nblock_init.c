@@ -70,6 +70,7 @@
 #include "geo_replica_ctx.h"
 #include "rozofs_quota_api.h"
 #include "export_quota_thread_api.h"
+#include "export_shard.h"
 
 DECLARE_PROFILING(epp_profiler_t);
 
@@ -158,6 +159,8 @@ char * show_profiler_one(char * pChar, uint32_t eid) {
     SHOW_PROFILER_PROBE(ep_getxattr);
     SHOW_PROFILER_PROBE(ep_removexattr);
     SHOW_PROFILER_PROBE(ep_listxattr);
+    SHOW_PROFILER_PROBE(ep_batch);
+    SHOW_PROFILER_PROBE(ep_readdirplus);
 
     if (short_display == 0) {
       SHOW_PROFILER_PROBE(export_lv1_resolve_entry);
@@ -773,7 +776,9 @@ void show_vfstat_eid(char * argv[], uint32_t tcpRef, void *bufRef) {
   @retval none
 */
 void show_lv2_attribute_cache(char * argv[], uint32_t tcpRef, void *bufRef) {
+  export_shard_lock_all();
   lv2_cache_display( &cache, uma_dbg_get_buffer());
+  export_shard_unlock_all();
   uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
 }
 /*
@@ -789,7 +794,9 @@ void show_lv2_attribute_cache(char * argv[], uint32_t tcpRef, void *bufRef) {
   @retval none
 */
 void show_flock(char * argv[], uint32_t tcpRef, void *bufRef) {
+  export_shard_lock_all();
   display_file_lock(uma_dbg_get_buffer());
+  export_shard_unlock_all();
   uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
 }
 /*
@@ -1095,6 +1102,7 @@ int expgwc_start_nb_blocking_th(void *args) {
 	    epgw_setattr_arg_t ep_setattr_1_arg;
 	    epgw_mfile_arg_t ep_readlink_1_arg;
 	    epgw_mknod_arg_t ep_mknod_1_arg;
+	    epgw_batch_arg_t ep_batch_1_arg;
 	    epgw_mkdir_arg_t ep_mkdir_1_arg;
 	    epgw_unlink_arg_t ep_unlink_1_arg;
 	    epgw_rmdir_arg_t ep_rmdir_1_arg;
@@ -1251,6 +1259,15 @@ int expgwc_start_nb_blocking_th(void *args) {
       severe("attributes writeback thread is unavailable: %s",strerror(errno));
     } 
     uma_dbg_addTopic("attr_thread",show_attr_thread);
+    /*
+    ** start the metadata shard threads: there can not be more pending
+    ** requests than receive buffers
+    */
+    ret = export_shard_init(common_config.export_shard_threads, common_config.export_buf_cnt);
+    if (ret < 0)
+    {
+      severe("metadata shard threads are unavailable: %s",strerror(errno));
+    } 
     
     /*
     ** Wait for end of initialization on blocking exportd 
@@ -0,0 +1,291 @@
+/*
+ Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+ This file is part of Rozofs.
+
+ Rozofs is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published
+ by the Free Software Foundation, version 2.
+
+ Rozofs is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see
+ <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include <rozofs/rozofs.h>
+#include <rozofs/common/log.h>
+#include <rozofs/core/uma_dbg_api.h>
+#include <rozofs/core/rozofs_string.h>
+#include <rozofs/core/rozofs_ring.h>
+#include "exp_cache.h"
+#include "export_shard.h"
+
+int                       export_shard_nb = 0;
+export_shard_t            export_shard_tb[EXPORT_SHARD_MAX];
+rozofs_thread_channel_t * export_shard_channel = NULL;
+uint64_t                  export_shard_not_posted = 0; /**< requests the main thread had to process */
+
+/*__________________________________________________________________________
+*/
+/**
+*  Shard of a FID
+*
+* @param fid    the FID
+*
+* @retval the shard index
+*/
+uint32_t export_shard_of_fid(fid_t fid) {
+  return lv2_cache_hash(fid) % export_shard_nb;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Lock a set of shards in increasing index order. Called by the main thread.
+*
+* @param mask   bitmap of the shards to lock
+*/
+void export_shard_lock_set(uint32_t mask) {
+  int idx;
+
+  for (idx = 0; idx < export_shard_nb; idx++) {
+    if ((mask & (1U << idx)) == 0) continue;
+    pthread_mutex_lock(&export_shard_tb[idx].lock);
+    export_shard_tb[idx].locked++;
+  }
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Unlock a set of shards locked by export_shard_lock_set()
+*
+* @param mask   bitmap of the shards to unlock
+*/
+void export_shard_unlock_set(uint32_t mask) {
+  int idx;
+
+  for (idx = export_shard_nb - 1; idx >= 0; idx--) {
+    if ((mask & (1U << idx)) == 0) continue;
+    pthread_mutex_unlock(&export_shard_tb[idx].lock);
+  }
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Shard thread: process the requests on the FIDs of the shard
+*
+* @param arg    the shard context
+*/
+static void * export_shard_thread(void * arg) {
+  export_shard_t     * shard = arg;
+  export_shard_msg_t   msg;
+  uint64_t             t0, t1;
+  char                 name[32];
+
+  sprintf(name, "Shard#%d", shard->idx);
+  uma_dbg_thread_add_self(name);
+
+  while (1) {
+    rozofs_thread_channel_receive(export_shard_channel, shard->idx, &msg);
+
+    t0 = rdtsc();
+    pthread_mutex_lock(&shard->lock);
+    t1 = rdtsc();
+    (*msg.process)(&msg);
+    pthread_mutex_unlock(&shard->lock);
+
+    shard->wait_cycles += (t1 - t0);
+    shard->busy_cycles += (rdtsc() - t1);
+    shard->processed++;
+    if (msg.status == EXPORT_SHARD_DEFERRED) shard->deferred++;
+
+    rozofs_thread_channel_reply(export_shard_channel, shard->idx, &msg);
+  }
+  return NULL;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Processing of a shard thread response in the main thread
+*
+* @param msg    the response
+*/
+static void export_shard_response(void * msg) {
+  export_shard_msg_t * p = msg;
+
+  (*p->reply)(p);
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Give a request on a FID to the thread of its shard. Called by the main
+*  thread.
+*
+* @param fid        the FID the request is about
+* @param arg        decoded arguments of the request
+* @param req_ctx_p  RPC context of the request
+* @param process    processing of the request in the shard thread
+* @param reply      processing of the response in the main thread
+*
+* @retval 0 when the request is given to a shard thread
+* @retval -1 when the main thread must process the request
+*/
+int export_shard_post(fid_t fid, void * arg, rozorpc_srv_ctx_t * req_ctx_p,
+                      export_shard_process_t process, export_shard_reply_t reply) {
+  rozofs_inode_t     * inode_p = (rozofs_inode_t *) fid;
+  export_shard_msg_t   msg;
+  struct timeval       tv;
+  uint32_t             slice;
+
+  if (export_shard_nb == 0) return -1;
+
+  /*
+  ** The mover FIDs and the remote slices use the services of the main thread
+  */
+  if ((inode_p->s.key == ROZOFS_REG_S_MOVER) || (inode_p->s.key == ROZOFS_REG_D_MOVER)) goto not_posted;
+  exp_trck_get_slice(fid, &slice);
+  if (!exp_trck_is_local_slice(slice)) goto not_posted;
+
+  gettimeofday(&tv, NULL);
+  msg.req_ctx_p = req_ctx_p;
+  msg.arg       = arg;
+  msg.process   = process;
+  msg.reply     = reply;
+  msg.tic       = MICROLONG(tv);
+  msg.shard     = export_shard_of_fid(fid);
+  msg.status    = EXPORT_SHARD_DONE;
+
+  if (rozofs_thread_channel_send_to(export_shard_channel, msg.shard, &msg, 1) == 0) return 0;
+
+not_posted:
+  export_shard_not_posted++;
+  return -1;
+}
+/*__________________________________________________________________________
+*/
+static char * show_shard_help(char * pChar) {
+  pChar += sprintf(pChar,"usage:\n");
+  pChar += sprintf(pChar,"shard       : display the metadata shard statistics\n");
+  pChar += sprintf(pChar,"shard reset : display then reset the metadata shard statistics\n");
+  return pChar;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  rozodiag display of the load of the metadata shards
+*/
+static void show_shard(char * argv[], uint32_t tcpRef, void *bufRef) {
+  char           * pChar = uma_dbg_get_buffer();
+  export_shard_t * shard;
+  int              idx;
+  int              reset = 0;
+
+  if (argv[1] != NULL) {
+    if (strcmp(argv[1],"reset") != 0) {
+      show_shard_help(pChar);
+      uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
+      return;
+    }
+    reset = 1;
+  }
+
+  pChar += sprintf(pChar,"metadata shards : %d\n", export_shard_nb);
+  pChar += sprintf(pChar,"main thread     : %llu requests on the shard FIDs\n",
+                   (unsigned long long) export_shard_not_posted);
+  pChar += sprintf(pChar,"| shard |  requests  |  deferred  | main locks | avg busy cycles | avg wait cycles |\n");
+  pChar += sprintf(pChar,"+-------+------------+------------+------------+-----------------+-----------------+\n");
+  for (idx = 0; idx < export_shard_nb; idx++) {
+    shard = &export_shard_tb[idx];
+    pChar += sprintf(pChar,"| %5d | %10llu | %10llu | %10llu | %15llu | %15llu |\n",
+                     idx,
+                     (unsigned long long) shard->processed,
+                     (unsigned long long) shard->deferred,
+                     (unsigned long long) shard->locked,
+                     (unsigned long long) ((shard->processed == 0) ? 0 : shard->busy_cycles / shard->processed),
+                     (unsigned long long) ((shard->processed == 0) ? 0 : shard->wait_cycles / shard->processed));
+  }
+  if (export_shard_channel != NULL) {
+    pChar = rozofs_thread_channel_display(export_shard_channel, pChar);
+  }
+
+  if (reset) {
+    export_shard_not_posted = 0;
+    for (idx = 0; idx < export_shard_nb; idx++) {
+      shard = &export_shard_tb[idx];
+      shard->processed   = 0;
+      shard->deferred    = 0;
+      shard->locked      = 0;
+      shard->busy_cycles = 0;
+      shard->wait_cycles = 0;
+    }
+    pChar += sprintf(pChar,"Reset Done\n");
+  }
+  uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Create the shards and their threads
+*
+* @param nb_threads  requested number of shards (rounded down to a divider of
+*                    EXPORT_SHARD_MAX), 0 to process every request in the
+*                    main thread
+* @param depth       maximum number of requests pending in a shard
+*
+* @retval 0 on success -1 on error
+*/
+int export_shard_init(int nb_threads, int depth) {
+  export_shard_t * shard;
+  int              idx;
+  int              err;
+
+  uma_dbg_addTopic_option("shard", show_shard, UMA_DBG_OPTION_RESET);
+
+  if (nb_threads <= 0) return 0;
+  if (nb_threads > EXPORT_SHARD_MAX) nb_threads = EXPORT_SHARD_MAX;
+  /*
+  ** A shard must own whole locks of the attribute cache
+  */
+  while ((EXPORT_SHARD_MAX % nb_threads) != 0) nb_threads--;
+
+  export_shard_channel = rozofs_thread_channel_create("export_shard", nb_threads,
+                                                      sizeof(export_shard_msg_t),
+                                                      depth, export_shard_response);
+  if (export_shard_channel == NULL) {
+    severe("metadata shard rings can not be created. Every request is processed by the main thread.");
+    return -1;
+  }
+
+  /*
+  ** The shard threads evict from the LRU of the locks of their shard
+  */
+  lv2_cache_split_lru(&cache);
+
+  memset(export_shard_tb, 0, sizeof(export_shard_tb));
+  for (idx = 0; idx < nb_threads; idx++) {
+    shard = &export_shard_tb[idx];
+    shard->idx = idx;
+    pthread_mutex_init(&shard->lock, NULL);
+  }
+  export_shard_nb = nb_threads;
+  for (idx = 0; idx < nb_threads; idx++) {
+    shard = &export_shard_tb[idx];
+    err = pthread_create(&shard->thrdId, NULL, export_shard_thread, shard);
+    if (err != 0) {
+      fatal("metadata shard thread: pthread_create(%d) %s", idx, strerror(err));
+      return -1;
+    }
+  }
+  info("%d metadata shard threads started", nb_threads);
+  return 0;
+}
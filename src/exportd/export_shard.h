@@ -0,0 +1,159 @@
+/*
+ Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+ This file is part of Rozofs.
+
+ Rozofs is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published
+ by the Free Software Foundation, version 2.
+
+ Rozofs is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see
+ <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXPORT_SHARD_H
+#define EXPORT_SHARD_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include <rozofs/rozofs.h>
+#include <rozofs/common/htable.h>
+#include <rozofs/rpc/eproto.h>
+#include <rozofs/core/rozofs_rpc_non_blocking_generic_srv.h>
+
+/*
+** Metadata shards of an exportd slave.
+**
+** The FIDs are spread over the shards by the hash of the attribute cache,
+** and the number of shards divides the number of locks of the attribute
+** cache, so that a shard owns its own locks and LRU lists in the cache.
+** Each shard has a thread that processes the requests on its FIDs with the
+** shard lock held. The other requests run in the main thread with every
+** shard lock held, taken in increasing index order, so that the operations
+** on several FIDs such as rename and link never deadlock with the shard
+** threads.
+*/
+#define EXPORT_SHARD_MAX  ROZOFS_HTABLE_MAX_LOCK
+
+typedef enum _export_shard_status_e {
+  EXPORT_SHARD_DONE = 0,      /**< the response is ready to be sent */
+  EXPORT_SHARD_DEFERRED       /**< the main thread must process the request */
+} export_shard_status_e;
+
+struct _export_shard_msg_t;
+/*
+** Processing of a request in a shard thread
+*/
+typedef void (*export_shard_process_t)(struct _export_shard_msg_t * msg);
+/*
+** Processing of the response in the main thread
+*/
+typedef void (*export_shard_reply_t)(struct _export_shard_msg_t * msg);
+
+typedef struct _export_shard_msg_t {
+  rozorpc_srv_ctx_t      * req_ctx_p;   /**< RPC context of the request */
+  void                   * arg;         /**< decoded arguments */
+  export_shard_process_t   process;     /**< called in the shard thread */
+  export_shard_reply_t     reply;       /**< called in the main thread */
+  uint64_t                 tic;         /**< time of the dispatch in us */
+  int                      shard;       /**< index of the shard */
+  int                      status;      /**< see export_shard_status_e */
+  union {
+    epgw_mattr_ret_t       mattr;
+  } ret;
+} export_shard_msg_t;
+
+typedef struct _export_shard_t {
+  pthread_mutex_t lock;
+  pthread_t       thrdId;
+  int             idx;
+  uint64_t        processed;    /**< requests processed by the shard thread */
+  uint64_t        deferred;     /**< requests given back to the main thread */
+  uint64_t        busy_cycles;  /**< cycles spent in the requests */
+  uint64_t        wait_cycles;  /**< cycles spent waiting for the shard lock */
+  uint64_t        locked;       /**< main thread requests that locked the shard */
+} export_shard_t;
+
+extern int export_shard_nb;   /**< number of shards, 0 when disabled */
+
+/*__________________________________________________________________________
+*/
+/**
+*  Shard of a FID
+*
+* @param fid    the FID
+*
+* @retval the shard index
+*/
+uint32_t export_shard_of_fid(fid_t fid);
+/*__________________________________________________________________________
+*/
+/**
+*  Lock a set of shards in increasing index order. Called by the main thread.
+*
+* @param mask   bitmap of the shards to lock
+*/
+void export_shard_lock_set(uint32_t mask);
+/*__________________________________________________________________________
+*/
+/**
+*  Unlock a set of shards locked by export_shard_lock_set()
+*
+* @param mask   bitmap of the shards to unlock
+*/
+void export_shard_unlock_set(uint32_t mask);
+/*__________________________________________________________________________
+*/
+/**
+*  Lock every shard before processing a request in the main thread
+*/
+static inline void export_shard_lock_all(void) {
+  if (export_shard_nb == 0) return;
+  export_shard_lock_set((1U << export_shard_nb) - 1);
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Unlock every shard after processing a request in the main thread
+*/
+static inline void export_shard_unlock_all(void) {
+  if (export_shard_nb == 0) return;
+  export_shard_unlock_set((1U << export_shard_nb) - 1);
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Give a request on a FID to the thread of its shard. Called by the main
+*  thread.
+*
+* @param fid        the FID the request is about
+* @param arg        decoded arguments of the request
+* @param req_ctx_p  RPC context of the request
+* @param process    processing of the request in the shard thread
+* @param reply      processing of the response in the main thread
+*
+* @retval 0 when the request is given to a shard thread
+* @retval -1 when the main thread must process the request
+*/
+int export_shard_post(fid_t fid, void * arg, rozorpc_srv_ctx_t * req_ctx_p,
+                      export_shard_process_t process, export_shard_reply_t reply);
+/*__________________________________________________________________________
+*/
+/**
+*  Create the shards and their threads
+*
+* @param nb_threads  requested number of shards (rounded down to a divider of
+*                    EXPORT_SHARD_MAX), 0 to process every request in the
+*                    main thread
+* @param depth       maximum number of requests pending in a shard
+*
+* @retval 0 on success -1 on error
+*/
+int export_shard_init(int nb_threads, int depth);
+
+#endif
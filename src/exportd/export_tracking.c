@@ -83,8 +83,20 @@ int export_limit_rm_files;
 
 
 
+/*
+** Batches of bins files to remove from one storage
+*/
+typedef struct _export_rm_batch_t {
+    int          nb[2];                          /**< number of files of the nominal and spare batches */
+    rmfentry_t * entry[2][MP_REMOVE_BATCH_MAX];  /**< trash entries of the files */
+    uint8_t      idx[2][MP_REMOVE_BATCH_MAX];    /**< index of the storage in the distribution */
+    int          running;                        /**< a thread is sending the batches */
+    pthread_t    thread;
+} export_rm_batch_t;
+
 typedef struct cnxentry {
     mclient_t *cnx;
+    export_rm_batch_t *batch;
     list_t list;
 } cnxentry_t;
 
@@ -1841,6 +1853,54 @@ out:
 /*
 **__________________________________________________________________
 */
+/** get attributes of a managed file from a metadata shard thread
+ *
+ * Only the multi-thread services of the attribute cache are used, so the
+ * caller must own the shard lock of the FID, and the FID must be in a local
+ * slice. A file with a pending move is left to the main thread.
+ *
+ * @param e: the export managing the file
+ * @param fid: the id of the file
+ * @param attrs: attributes to fill.
+ *
+ * @return: 0 on success, 1 when the main thread must process the request,
+ *          -1 otherwise (errno is set)
+ */
+int export_getattr_th(export_t *e, fid_t fid, mattr_t *attrs) {
+    lv2_entry_t *lv2 = 0;
+
+    if (!(lv2 = export_lookup_fid_th(e->trk_tb_p,e->lv2_cache, fid))) {
+      return -1;
+    }
+    /*
+    ** the validation of a move updates the i-node and the trash
+    */
+    if (rozofs_mover_is_pending(lv2)) return 1;
+    rozofs_mover_invalidate(lv2);
+
+    memcpy(attrs, &lv2->attributes.s.attrs, sizeof (mattr_t));
+    memcpy(attrs->fid,fid,sizeof(fid_t));
+    if (test_no_extended_attr(lv2)) rozofs_clear_xattr_flag(&attrs->mode);
+    /*
+    ** check if the file has the delete pending bit asserted: if it is the
+    ** case the file MUST be in READ only mode
+    */
+    if (exp_metadata_inode_is_del_pending(fid))
+    {
+       attrs->mode &=~(S_IWUSR|S_IWGRP|S_IWOTH);
+    }
+    /*
+    ** clear the delete pending bit of the i-node if it is not a directory
+    */
+    if (!S_ISDIR(lv2->attributes.s.attrs.mode))
+    {
+      exp_metadata_inode_del_deassert(attrs->fid);
+    }
+    return 0;
+}
+/*
+**__________________________________________________________________
+*/
 /** set attributes of a managed file
  *
  * @param e: the export managing the file
@@ -4085,6 +4145,7 @@ static int init_storages_cnx(volume_t *volume, list_t *list) {
 
               cnxentry_t *cnx_entry = (cnxentry_t *) xmalloc(sizeof (cnxentry_t));
               cnx_entry->cnx = mclt;
+              cnx_entry->batch = NULL;
 
               // Add to the list
               list_push_back(list, &cnx_entry->list);
@@ -4104,7 +4165,7 @@ out:
 /*
 **______________________________________________________________________________
 */
-static mclient_t * lookup_cnx(list_t *list, cid_t cid, sid_t sid) {
+static cnxentry_t * lookup_cnx(list_t *list, cid_t cid, sid_t sid) {
 
     list_t *p;
     DEBUG_FUNCTION;
@@ -4113,7 +4174,7 @@ static mclient_t * lookup_cnx(list_t *list, cid_t cid, sid_t sid) {
         cnxentry_t *cnx_entry = list_entry(p, cnxentry_t, list);
 
         if ((sid == cnx_entry->cnx->sid) && (cid == cnx_entry->cnx->cid)) {
-            return cnx_entry->cnx;
+            return cnx_entry;
             break;
         }
     }
@@ -4136,6 +4197,8 @@ static void release_storages_cnx(list_t *list) {
         mclient_release(cnx_entry->cnx);
         if (cnx_entry->cnx != NULL)
             free(cnx_entry->cnx);
+        if (cnx_entry->batch != NULL)
+            xfree(cnx_entry->batch);
         list_remove(p);
         if (cnx_entry != NULL)
             free(cnx_entry);
@@ -4354,22 +4417,183 @@ char *export_rm_bins_stats(char *pChar)
 /*
 **_______________________________________________________________________________
 */
+/**
+*  Send the batches of bins files to remove to one storage
+
+   Run by a thread per storage, so that the batches are in flight toward
+   every storage in parallel. The mclient calls use results owned by the
+   caller, not the static results of the rpcgen stubs. A storaged that
+   does not know MP_REMOVE_BATCH gets the files one by one.
+
+   @param arg : the connexion entry of the storage
+*/
+/*
+** Time when each storage answered that it does not know MP_REMOVE_BATCH.
+** The batches are not tried again toward it before EXPORT_RM_BATCH_RETRY_DELAY.
+*/
+#define EXPORT_RM_BATCH_RETRY_DELAY  600
+static time_t export_rm_batch_unsupported[ROZOFS_CLUSTERS_MAX+1][SID_MAX+1];
+
+static void * export_rm_batch_thread(void * arg) {
+  cnxentry_t        * cnx_entry = (cnxentry_t *) arg;
+  mclient_t         * stor = cnx_entry->cnx;
+  export_rm_batch_t * batch = cnx_entry->batch;
+  time_t            * unsupported = &export_rm_batch_unsupported[stor->cid][stor->sid];
+  fid_t               fids[MP_REMOVE_BATCH_MAX];
+  int                 errors[MP_REMOVE_BATCH_MAX];
+  int                 spare;
+  int                 j;
+  int                 ret;
+
+  for (spare = 0; spare < 2; spare++) {
+
+    if (batch->nb[spare] == 0) continue;
+
+    for (j = 0; j < batch->nb[spare]; j++) {
+      memcpy(fids[j], batch->entry[spare][j]->fid, sizeof(fid_t));
+    }
+
+    if ((*unsupported) && ((time(NULL) - *unsupported) < EXPORT_RM_BATCH_RETRY_DELAY)) {
+      ret   = -1;
+      errno = EOPNOTSUPP;
+    }
+    else {
+      ret = mclient_remove_batch(stor, spare, batch->nb[spare], fids, errors);
+    }
+
+    if ((ret != 0) && (errno != EOPNOTSUPP)) {
+      warning("mclient_remove_batch failed (cid: %u; sid: %u): %s",
+              stor->cid, stor->sid, strerror(errno));
+      /*
+      ** Say this storage is down not to use it again 
+      ** during this run; this would fill up the log file.
+      */
+      stor->status = 0; 
+      for (j = 0; j < batch->nb[spare]; j++) {
+        errors[j] = EAGAIN;
+      }
+    }
+    else if (ret != 0) {
+      *unsupported = time(NULL);
+      /*
+      ** Remove the files one by one
+      */
+      for (j = 0; j < batch->nb[spare]; j++) {
+        errors[j] = EAGAIN;
+	if (stor->status == 0) continue;
+        if (mclient_remove2(stor, fids[j], spare) != 0) {
+          warning("mclient_remove failed (cid: %u; sid: %u): %s",
+                  stor->cid, stor->sid, strerror(errno));
+	  /*
+	  ** Say this storage is down not to use it again 
+	  ** during this run; this would fill up the log file.
+	  */
+	  stor->status = 0; 
+	  continue;
+	}
+	errors[j] = 0;
+      }
+    }
+
+    // Update the distribution of the files whose bins file is deleted
+    for (j = 0; j < batch->nb[spare]; j++) {
+      if (errors[j] == 0) {
+        batch->entry[spare][j]->current_dist_set[batch->idx[spare][j]] = 0;
+      }
+    }
+    batch->nb[spare] = 0;
+  }
+  return NULL;
+}
+/*
+**_______________________________________________________________________________
+*/
+/**
+*  Send the pending batches to every storage in parallel, then release
+   the trash entries whose bins files are all deleted
+
+   @param e           : the export
+   @param connexions  : the connexions toward the storages
+   @param pending     : the entries that have been put in the batches
+   @param failed      : receives the entries that are not completely deleted
+   @param safe        : number of bins files per file
+*/
+static void export_rm_batch_flush(export_t * e, list_t * connexions, list_t * pending, list_t * failed, uint8_t safe) {
+  list_t            * p, * n;
+  cnxentry_t        * cnx_entry;
+  export_rm_batch_t * batch;
+  rmfentry_t        * entry;
+  int                 i;
+
+  list_for_each_forward(p, connexions) {
+
+    cnx_entry = list_entry(p, cnxentry_t, list);
+    batch     = cnx_entry->batch;
+    if ((batch == NULL) || ((batch->nb[0] + batch->nb[1]) == 0)) continue;
+
+    if ((errno = pthread_create(&batch->thread, NULL, export_rm_batch_thread, cnx_entry)) != 0) {
+      severe("can't create remove batch pthread: %s", strerror(errno));
+      export_rm_batch_thread(cnx_entry);
+      continue;
+    }
+    batch->running = 1;
+  }
+
+  list_for_each_forward(p, connexions) {
+
+    cnx_entry = list_entry(p, cnxentry_t, list);
+    batch     = cnx_entry->batch;
+    if ((batch == NULL) || (batch->running == 0)) continue;
+
+    pthread_join(batch->thread, NULL);
+    batch->running = 0;
+  }
+
+  list_for_each_forward_safe(p, n, pending) {
+
+    entry = list_entry(p,rmfentry_t,list);
+    list_remove(&entry->list);
+
+    for (i = 0; i < safe; i++) {
+      if (entry->current_dist_set[i] != 0) break;
+    }
+
+    if (i == safe) {
+      /*
+      ** remove the entry from the trash file
+      */
+      export_rm_bins_done_count++;
+      export_rmbins_remove_from_tracking_file(e,entry); 
+      xfree(entry);
+    }
+    else {
+      /*
+      ** Put this entry in the failed list
+      */
+      list_push_back(failed, &entry->list);
+    }
+  }
+}
+/*
+**_______________________________________________________________________________
+*/
 
 static inline int export_rm_bucket(export_t * e, list_t * connexions, int bucket_idx, uint8_t safe, uint8_t forward) {
-  int          sid_count = 0;
   int          i = 0;
   list_t       todo;
   list_t       failed;
+  list_t       pending;
   rmfentry_t * entry;
-//  cid_t        cid;
   list_t      * p, *n;
   time_t        now;
+  int           full;
 
   /*
   ** Initialize the working lists
   */
   list_init(&todo);
   list_init(&failed);
+  list_init(&pending);
 
   /* 
   ** Move the whole bucket list to the working list
@@ -4393,9 +4617,6 @@ static inline int export_rm_bucket(export_t * e, list_t * connexions, int bucket
     entry = list_entry(p,rmfentry_t,list);
     list_remove(&entry->list);
 
-    // Nb. of bins files removed for this file
-    sid_count = 0;
-    
     // Not yet time to delete this file
     if ((entry->time) && (entry->time >= now)) {
       /*
@@ -4405,17 +4626,21 @@ static inline int export_rm_bucket(export_t * e, list_t * connexions, int bucket
       continue;
     }
     
+    full = 0;
+    
     // For each storage associated with this file
     for (i = 0; i < safe; i++) {
 
-      mclient_t* stor = NULL;
+      cnxentry_t        * cnx_entry = NULL;
+      mclient_t         * stor = NULL;
+      export_rm_batch_t * batch;
+      int                 spare;
 
       if (0 == entry->current_dist_set[i]) {
-        sid_count++;
         continue; // The bins file has already been deleted for this server
       }
 
-      if ((stor = lookup_cnx(connexions, entry->cid, entry->current_dist_set[i])) == NULL) {
+      if ((cnx_entry = lookup_cnx(connexions, entry->cid, entry->current_dist_set[i])) == NULL) {
         char   text[512];
 	char * p = text;
 
@@ -4434,51 +4659,38 @@ static inline int export_rm_bucket(export_t * e, list_t * connexions, int bucket
 	/*
 	** Invalid cid/sid
 	*/
-	sid_count++;
+	entry->current_dist_set[i] = 0;
         continue;// lookup_cnx failed !!! 
       }
+      stor = cnx_entry->cnx;
 
       if (0 == stor->status) {
         continue; // This storage is down
       }
 
-      // Send remove request
-      int spare;
-      if (i<forward) spare = 0;
-      else                  spare = 1;
-      if (mclient_remove2(stor, entry->fid,spare) != 0) {
-        warning("mclient_remove failed (cid: %u; sid: %u): %s",
-                stor->cid, stor->sid, strerror(errno));
-	/*
-	** Say this storage is down not to use it again 
-	** during this run; this would fill up the log file.
-	*/
-	stor->status = 0; 
-        continue; // Go to the next storage
+      // Put the file in the remove batch of this storage
+      if (cnx_entry->batch == NULL) {
+        cnx_entry->batch = xmalloc(sizeof(export_rm_batch_t));
+	memset(cnx_entry->batch, 0, sizeof(export_rm_batch_t));
       }
-
-      // The bins file has been deleted successfully
-      // Update distribution and nb. of bins file deleted
-      entry->current_dist_set[i] = 0;
-      sid_count++;
+      batch = cnx_entry->batch;
+      if (i<forward) spare = 0;
+      else           spare = 1;
+      batch->entry[spare][batch->nb[spare]] = entry;
+      batch->idx[spare][batch->nb[spare]]   = i;
+      batch->nb[spare]++;
+      if (batch->nb[spare] == MP_REMOVE_BATCH_MAX) full = 1;
     }
+    list_push_back(&pending, &entry->list);
 
     // Update the nb. of files that have been tested to be deleted.
     processed_files++; 
 
-    if (sid_count == safe) {
-      /*
-      ** remove the entry from the trash file
-      */
-      export_rm_bins_done_count++;
-      export_rmbins_remove_from_tracking_file(e,entry); 
-      xfree(entry);
-    }
-    else {
-      /*
-      ** Put this entry in the failed list
-      */
-      list_push_back(&failed, &entry->list);
+    /*
+    ** One batch is full. Send the batches of every storage
+    */
+    if (full) {
+      export_rm_batch_flush(e, connexions, &pending, &failed, safe);
     }
 
     /*
@@ -4489,6 +4701,8 @@ static inline int export_rm_bucket(export_t * e, list_t * connexions, int bucket
   
 out:
 
+  export_rm_batch_flush(e, connexions, &pending, &failed, safe);
+
   /*
   ** Bucket totaly processed successfully
   */
@@ -5835,8 +6049,8 @@ out:
  *
  * @return: 0 on success -1 otherwise (errno is set)
  */
-int export_readdir2(export_t * e, fid_t fid, uint64_t * cookie,
-        char *buf_readdir, uint8_t * eof) {
+static int export_readdir_dirents(export_t * e, fid_t fid, uint64_t * cookie,
+        char *buf_readdir, uint8_t * eof, fid_t *fid_tb, int max_entries, int max_bytes) {
     int status = -1;
     lv2_entry_t *parent = NULL;
     int fdp = -1;
@@ -5865,7 +6079,8 @@ int export_readdir2(export_t * e, fid_t fid, uint64_t * cookie,
     ** set global variables associated with the export
     */
     fdp = export_open_parent_directory(e,fid);
-    status =list_mdirentries2(parent->dirent_root_idx_p,fdp, fid, buf_readdir, cookie, eof,&parent->attributes);
+    status =list_mdirentries2(parent->dirent_root_idx_p,fdp, fid, buf_readdir, cookie, eof,&parent->attributes,
+                              fid_tb, max_entries, max_bytes);
 out:
     if (parent != NULL) export_dir_flush_root_idx_bitmap(e,fid,parent->dirent_root_idx_p);
 
@@ -5873,6 +6088,59 @@ out:
     STOP_PROFILING(export_readdir);
     return status;
 }
+
+int export_readdir2(export_t * e, fid_t fid, uint64_t * cookie,
+        char *buf_readdir, uint8_t * eof) {
+    return export_readdir_dirents(e, fid, cookie, buf_readdir, eof,
+                                  NULL, MAX_DIR_ENTRIES_VERS2, ROZOFS_READDIR_MAX_BYTES);
+}
+/*
+**______________________________________________________________________________
+*/
+/** read a directory with the attributes of its entries (readdirplus)
+ *
+ * @param e: the export managing the file
+ * @param fid: the id of the directory
+ * @param cookie: index mdirentries where we must begin to list the mdirentries
+ * @param buf_readdir: buffer where the fuse dirents are written
+ * @param eof: pointer that indicates if we list all the entries or not
+ * @param attrs: table of MAX_DIR_ENTRIES_PLUS attributes filled in the order
+ *               of the dirents, "." and ".." excepted. The fid is cleared
+ *               when the attributes of an entry can not be read.
+ * @param nb_attrs: number of attributes filled
+ *
+ * @return: size of the dirents on success -1 otherwise (errno is set)
+ */
+int export_readdirplus(export_t * e, fid_t fid, uint64_t * cookie,
+        char *buf_readdir, uint8_t * eof, mattr_t *attrs, int *nb_attrs) {
+    static fid_t fid_tb[MAX_DIR_ENTRIES_PLUS];
+    fid_t        null_fid = {0};
+    int          len;
+    int          nb;
+    int          idx;
+
+    *nb_attrs = 0;
+    memset(fid_tb, 0, sizeof(fid_tb));
+    len = export_readdir_dirents(e, fid, cookie, buf_readdir, eof,
+                                 fid_tb, MAX_DIR_ENTRIES_PLUS, ROZOFS_READDIRPLUS_MAX_BYTES);
+    if (len < 0) return len;
+    /*
+    ** count the listed entries: the fid table is filled in order
+    */
+    for (nb = 0; nb < MAX_DIR_ENTRIES_PLUS; nb++) {
+      if (memcmp(fid_tb[nb], null_fid, sizeof(fid_t)) == 0) break;
+    }
+    /*
+    ** the attributes come from the lv2 cache, as for a getattr
+    */
+    for (idx = 0; idx < nb; idx++) {
+      if (export_getattr(e, fid_tb[idx], &attrs[idx]) != 0) {
+        memset(&attrs[idx], 0, sizeof(mattr_t));
+      }
+    }
+    *nb_attrs = nb;
+    return len;
+}
 /*
 **______________________________________________________________________________
 */
@@ -3573,7 +3573,34 @@ int del_mdirentry(void *root_idx_bitmap_p,int dirfd, fid_t fid_parent, char * na
 int list_mdirentries(void *root_idx_bitmap_p,int dir_fd, fid_t fid_parent, child_t ** children,
         uint64_t *cookie, uint8_t * eof);
 
-int list_mdirentries2(void *root_idx_bitmap_p,int dir_fd, fid_t fid_parent_in, char *buf_readdir_in, uint64_t *cookie, uint8_t * eof,ext_mattr_t *parent);
+/*
+** Limits of one readdir2 response
+*/
+#define ROZOFS_READDIR_MAX_BYTES (64*1024-4096)
+#define MAX_DIR_ENTRIES_VERS2 (128+64)
+/*
+** Limits of one readdirplus response: the attributes of the entries
+** must fit with the dirents in the 64K receive buffer of the client
+*/
+#define ROZOFS_READDIRPLUS_MAX_BYTES (24*1024)
+#define MAX_DIR_ENTRIES_PLUS 128
+
+/** @ingroup DIRENT_HIGH_LVL_API
+ * API for list mdirentries of one directory in the fuse dirent format
+ *
+ * @param buf_readdir_in: buffer where the fuse dirents are written
+ * @param cookie: index mdirentries where we must begin to list the mdirentries
+ * @param *eof: pointer that indicates if we list all the entries or not
+ * @param parent: attributes of the directory
+ * @param fid_tb: when not NULL, fids of the listed entries ("." and ".." excepted)
+ * @param max_entries: maximum number of entries to list
+ * @param max_bytes: size of the dirents after which the listing stops
+ *
+ * @retval size of the dirents on success
+ * @retval -1 on failure
+ */
+int list_mdirentries2(void *root_idx_bitmap_p,int dir_fd, fid_t fid_parent_in, char *buf_readdir_in, uint64_t *cookie, uint8_t * eof,ext_mattr_t *parent,
+                      fid_t *fid_tb, int max_entries, int max_bytes);
 /*
  *___________________________________________________________________
  DIRENT CACHE  API
@@ -84,6 +84,33 @@ static inline void rozofs_mover_invalidate (lv2_entry_t *lv2)
 {
   lv2->access_cpt = 1;
 }
+/*
+**__________________________________________________________________
+*/
+/**
+*  Check whether a regular file has a move waiting for its validation,
+   that is to say whether rozofs_mover_check_for_validation() has
+   something to do
+
+   @param lv2: level 2 cache entry associated with the file
+
+  @retval 1 when a move is pending
+  @retval 0 otherwise
+   
+*/
+static inline int rozofs_mover_is_pending (lv2_entry_t *lv2) 
+{
+  rozofs_mover_children_t mover_idx;
+  rozofs_mover_sids_t    *dist_mv_p;
+
+  if (!S_ISREG(lv2->attributes.s.attrs.mode)) return 0;
+
+  mover_idx.u32 = lv2->attributes.s.attrs.children;
+  if (mover_idx.fid_st_idx.mover_idx == mover_idx.fid_st_idx.primary_idx) return 0;
+
+  dist_mv_p = (rozofs_mover_sids_t*)&lv2->attributes.s.attrs.sids;
+  return (dist_mv_p->dist_t.mover_cid != 0);
+}
 
 /*
 **__________________________________________________________________
@@ -85,6 +85,20 @@ typedef struct _rozo_buf_rw_status_t {
 
 
 
+/*
+** Write behind: the sections of the file buffer that must be flushed
+** while the maximum number of writes is already pending are queued
+** in extents of the file, and sent in order as the pending writes complete.
+*/
+#define ROZOFS_MAX_WB_EXTENTS     8   /**< number of write behind extents per open file */
+
+typedef struct _rozofs_wb_extent_t {
+    char     *buffer;      /**< buffer of exportclt.bufsize bytes (allocated on first use) */
+    uint32_t  data_off;    /**< offset of the data in the buffer */
+    uint32_t  len;         /**< length of the data */
+    uint64_t  off;         /**< offset of the data in the file */
+} rozofs_wb_extent_t;
+
 typedef struct file {
     ruc_obj_desc_t pending_rd_list;  /**< used to queue the FUSE contextr for which a read is requested  */
     ruc_obj_desc_t pending_wr_list;  /**< used to queue the FUSE context waiting for flush completed  */
@@ -134,6 +148,11 @@ typedef struct file {
     uint64_t         off_wr_end;      /**< geo replication :write offset end  */
     int              pending_read_count; 
     int              open_flags;     /**< flags given at opening time */
+    int              wb_first;       /**< index of the oldest queued write behind extent */
+    int              wb_count;       /**< number of queued write behind extents */
+    uint64_t         wb_queued;      /**< number of bytes in the queued extents */
+    uint64_t         wb_inflight;    /**< number of bytes of the pending write requests */
+    rozofs_wb_extent_t wb[ROZOFS_MAX_WB_EXTENTS];
 #if 0
     char *buffer;
     int buf_write_wait;
@@ -256,6 +275,11 @@ static inline file_t * rozofs_file_working_var_init(void * ientry, fid_t fid)
     file->write_block_pending = 0;
     file->file2create = 0;
     file->pending_read_count = 0;
+    file->wb_first = 0;
+    file->wb_count = 0;
+    file->wb_queued = 0;
+    file->wb_inflight = 0;
+    memset(file->wb,0,sizeof(file->wb));
     rozofs_geo_write_reset(file);
 
     rozofs_opened_file++;
@@ -324,6 +348,12 @@ static inline int file_close(file_t * f) {
      ** Release all memory allocated
      */
      xfree(f->buffer);
+     {
+       int i;
+       for (i = 0; i < ROZOFS_MAX_WB_EXTENTS; i++) {
+         if (f->wb[i].buffer != NULL) xfree(f->wb[i].buffer);
+       }
+     }
      f->chekWord = 0;
      xfree(f);
      rozofs_opened_file--;
@@ -20,6 +20,7 @@
 #include <rozofs/rpc/storcli_proto.h>
 
 #include "rozofs_fuse_api.h"
+#include "rozofs_batch.h"
 #include "rozofs_modeblock_cache.h"
 #include "rozofs_rw_load_balancing.h"
 
@@ -125,6 +126,10 @@ uint64_t rozofs_max_getattr_duplicate = 0;
 	} 
       }	     
     }  
+    /*
+    ** Queue the getattr in an EP_BATCH sent at the end of the fuse reading
+    */
+    if (rozofs_batch_getattr(arg.arg_gw.eid,ie->fid,buffer_p) == 0) return;
 
 #if 1
     ret = rozofs_expgateway_send_routing_common(arg.arg_gw.eid,ie->fid,EXPORT_PROGRAM, EXPORT_VERSION,
@@ -173,39 +178,127 @@ out:
 }
 
 /**
-*  Call back function call upon a success rpc, timeout or any other rpc failure
+*  End of a getattr: reply to fuse with the response of the exportd
+*  (single EP_GETATTR or operation of an EP_BATCH)
 *
- @param this : pointer to the transaction context
  @param param: pointer to the associated rozofs_fuse_context
+ @param ret  : decoded response of the exportd, NULL when the transaction failed
+ @param error: errno of the failed transaction (ret is NULL)
  
  @return none
  */
-void rozofs_ll_getattr_cbk(void *this,void *param) 
+void rozofs_ll_getattr_end(void *param,epgw_mattr_ret_t *ret,int error) 
 {
    fuse_ino_t ino;
    struct stat stbuf;
    fuse_req_t req; 
+   int status = 0;
+   ientry_t *ie = 0;
+   mattr_t  attr;
+   int trc_idx;
+   errno = 0;
+   
+   RESTORE_FUSE_PARAM(param,req);
+   RESTORE_FUSE_PARAM(param,ino);
+   RESTORE_FUSE_PARAM(param,trc_idx);
+
+    if (ret == NULL)
+    {
+       /*
+       ** something wrong happened
+       */
+       status = -1;
+       errno = error;  
+       /*
+       ** In case of fast reconnect mode let's respond with the previously knows 
+       ** parameters instead of failing
+       */
+       if ((common_config.client_fast_reconnect)&&(errno==ETIME)) {
+         ie = get_ientry_by_inode(ino);
+	 if ((ie != NULL) && (ie->attrs.mtime != 0)) { 
+ 	   mattr_to_stat(&ie->attrs, &stbuf, exportclt.bsize);
+	   stbuf.st_ino = ino; 
+	   rz_fuse_reply_attr(req, &stbuf, rozofs_tmr_get_attr(rozofs_is_directory_inode(ino)));
+	   errno = EAGAIN;	   
+	   goto out; 
+	 }            
+       }       
+       goto error; 
+    }
+ 
+    if (ret->status_gw.status == EP_FAILURE) {
+        errno = ret->status_gw.ep_mattr_ret_t_u.error;
+        goto error;
+    }
+    
+    /*
+    ** Update eid free quota
+    */
+    eid_set_free_quota(ret->free_quota);
+        
+    memcpy(&attr, &ret->status_gw.ep_mattr_ret_t_u.attrs, sizeof (mattr_t));
+    /*
+    ** end of the the decoding part
+    */
+    /*
+    ** store the decoded information in the array that will be
+    ** returned to the caller
+    */
+    mattr_to_stat(&attr, &stbuf, exportclt.bsize);
+    stbuf.st_ino = ino;
+    /*
+    ** get the ientry associated with the fuse_inode
+    */
+
+    if (!(ie = get_ientry_by_inode(ino))) {
+        errno = ENOENT;
+        goto error;
+    }
+    /*
+    ** update the attributes in the ientry
+    */
+    rozofs_ientry_update(ie,&attr);  
+    stbuf.st_size = ie->attrs.size;
+    /*
+    ** update the getattr pending count
+    */
+    //if (ie->pending_getattr_cnt>=0) ie->pending_getattr_cnt--;
+    rz_fuse_reply_attr(req, &stbuf, rozofs_tmr_get_attr(rozofs_is_directory_inode(ino)));
+    goto out;
+error:
+    fuse_reply_err(req, errno);
+out:
+    rozofs_trc_rsp_attr(srv_rozofs_ll_getattr,ino,(ie==NULL)?NULL:ie->attrs.fid,status,(ie==NULL)?-1:ie->attrs.size,trc_idx);
+    STOP_PROFILING_NB(param,rozofs_ll_getattr);
+    rozofs_fuse_release_saved_context(param);
+    
+    return;
+}
+
+/**
+*  Call back function call upon a success rpc, timeout or any other rpc failure
+*
+ @param this : pointer to the transaction context
+ @param param: pointer to the associated rozofs_fuse_context
+ 
+ @return none
+ */
+void rozofs_ll_getattr_cbk(void *this,void *param) 
+{
    epgw_mattr_ret_t ret ;
    int status;
-   ientry_t *ie = 0;
    xdrproc_t decode_proc = (xdrproc_t)xdr_epgw_mattr_ret_t;
    
    uint8_t  *payload;
    void     *recv_buf = NULL;   
    XDR       xdrs;    
    int      bufsize;
-   mattr_t  attr;
    struct rpc_msg  rpc_reply;
    rpc_reply.acpted_rply.ar_results.proc = NULL;
    rozofs_fuse_save_ctx_t *fuse_ctx_p;
-   int trc_idx;
    errno = 0;
     
    GET_FUSE_CTX_P(fuse_ctx_p,param);    
-   
-   RESTORE_FUSE_PARAM(param,req);
-   RESTORE_FUSE_PARAM(param,ino);
-   RESTORE_FUSE_PARAM(param,trc_idx);
     /*
     ** get the pointer to the transaction context:
     ** it is required to get the information related to the receive buffer
@@ -221,20 +314,6 @@ void rozofs_ll_getattr_cbk(void *this,void *param)
        ** something wrong happened
        */
        errno = rozofs_tx_get_errno(this);  
-       /*
-       ** In case of fast reconnect mode let's respond with the previously knows 
-       ** parameters instead of failing
-       */
-       if ((common_config.client_fast_reconnect)&&(errno==ETIME)) {
-         ie = get_ientry_by_inode(ino);
-	 if ((ie != NULL) && (ie->attrs.mtime != 0)) { 
- 	   mattr_to_stat(&ie->attrs, &stbuf, exportclt.bsize);
-	   stbuf.st_ino = ino; 
-	   rz_fuse_reply_attr(req, &stbuf, rozofs_tmr_get_attr(rozofs_is_directory_inode(ino)));
-	   errno = EAGAIN;	   
-	   goto out; 
-	 }            
-       }       
        goto error; 
     }
     /*
@@ -314,55 +393,12 @@ void rozofs_ll_getattr_cbk(void *this,void *param)
          
     }
 
- 
-    if (ret.status_gw.status == EP_FAILURE) {
-        errno = ret.status_gw.ep_mattr_ret_t_u.error;
-        xdr_free((xdrproc_t) decode_proc, (char *) &ret);    
-        goto error;
-    }
-    
-    /*
-    ** Update eid free quota
-    */
-    eid_set_free_quota(ret.free_quota);
-        
-    memcpy(&attr, &ret.status_gw.ep_mattr_ret_t_u.attrs, sizeof (mattr_t));
-
+    rozofs_ll_getattr_end(param,&ret,0);
     xdr_free((xdrproc_t) decode_proc, (char *) &ret);    
-    /*
-    ** end of the the decoding part
-    */
-    /*
-    ** store the decoded information in the array that will be
-    ** returned to the caller
-    */
-    mattr_to_stat(&attr, &stbuf, exportclt.bsize);
-    stbuf.st_ino = ino;
-    /*
-    ** get the ientry associated with the fuse_inode
-    */
-
-    if (!(ie = get_ientry_by_inode(ino))) {
-        errno = ENOENT;
-        goto error;
-    }
-    /*
-    ** update the attributes in the ientry
-    */
-    rozofs_ientry_update(ie,&attr);  
-    stbuf.st_size = ie->attrs.size;
-    /*
-    ** update the getattr pending count
-    */
-    //if (ie->pending_getattr_cnt>=0) ie->pending_getattr_cnt--;
-    rz_fuse_reply_attr(req, &stbuf, rozofs_tmr_get_attr(rozofs_is_directory_inode(ino)));
     goto out;
 error:
-    fuse_reply_err(req, errno);
+    rozofs_ll_getattr_end(param,NULL,errno);
 out:
-    rozofs_trc_rsp_attr(srv_rozofs_ll_getattr,ino,(ie==NULL)?NULL:ie->attrs.fid,status,(ie==NULL)?-1:ie->attrs.size,trc_idx);
-    STOP_PROFILING_NB(param,rozofs_ll_getattr);
-    rozofs_fuse_release_saved_context(param);
     if (rozofs_tx_ctx_p != NULL) rozofs_tx_free_from_ptr(rozofs_tx_ctx_p);    
     if (recv_buf != NULL) ruc_buf_freeBuffer(recv_buf);   
     
@@ -0,0 +1,544 @@
+/*
+  Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+  This file is part of Rozofs.
+
+  Rozofs is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation, version 2.
+
+  Rozofs is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see
+  <http://www.gnu.org/licenses/>.
+ */
+
+#include <rozofs/rpc/eproto.h>
+#include <rozofs/core/uma_dbg_api.h>
+
+#include "rozofs_fuse_api.h"
+#include "rozofs_batch.h"
+
+void rozofs_ll_lookup_cbk(void *this,void *param);
+void rozofs_ll_getattr_cbk(void *this,void *param);
+
+/*
+** Batch of lookup and getattr requests toward one destination
+*/
+typedef struct _rozofs_batch_t {
+  int                 idx;                    /**< index in rozofs_batch_tb */
+  int                 lbg_id;                 /**< destination of the batch */
+  uint32_t            eid;                    /**< export of the requests */
+  int                 size;                   /**< estimated size of the encoded operations */
+  int                 nb;                     /**< number of operations */
+  ep_batch_op_arg_t   ops[EP_BATCH_MAX];      /**< operations */
+  void              * param[EP_BATCH_MAX];    /**< fuse context of each operation */
+} rozofs_batch_t;
+
+static rozofs_batch_t   rozofs_batch_tb[ROZOFS_BATCH_CTX_MAX];
+static int              rozofs_batch_free_tb[ROZOFS_BATCH_CTX_MAX];
+static int              rozofs_batch_free_nb = 0;
+static rozofs_batch_t * rozofs_batch_filling[ROZOFS_BATCH_DEST_MAX];
+static int              rozofs_batch_filling_nb = 0;
+/*
+** Set when the exportd does not support EP_BATCH
+*/
+static int              rozofs_batch_unsupported = 0;
+
+static uint64_t         rozofs_batch_stats_sent = 0;      /**< EP_BATCH requests sent */
+static uint64_t         rozofs_batch_stats_ops = 0;       /**< operations sent in EP_BATCH requests */
+static uint64_t         rozofs_batch_stats_single = 0;    /**< queued operations sent alone */
+static uint64_t         rozofs_batch_stats_no_ctx = 0;    /**< operations not queued by lack of batch context */
+static uint64_t         rozofs_batch_stats_resent = 0;    /**< operations resent alone after an EP_BATCH failure */
+
+/*
+** Room left in the transmit buffer for the RPC and EP_BATCH headers
+*/
+#define ROZOFS_BATCH_HDR_SIZE  128
+/*
+** XDR size of an operation without its name
+*/
+#define ROZOFS_BATCH_OP_SIZE   (3*sizeof(uint32_t)+sizeof(ep_uuid_t))
+
+/*
+**__________________________________________________________________
+*/
+/**
+*  Release a batch context
+*/
+static inline void rozofs_batch_release(rozofs_batch_t * batch) {
+  rozofs_batch_free_tb[rozofs_batch_free_nb++] = batch->idx;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Process the response to one operation
+*
+ @param op   : the operation
+ @param param: fuse context of the operation
+ @param ret  : decoded response, NULL when the transaction failed
+ @param error: errno of the failed transaction
+ */
+static inline void rozofs_batch_end(ep_batch_op_arg_t * op,void * param,epgw_mattr_ret_t * ret,int error) {
+  if (op->op == EP_BATCH_LOOKUP) {
+    rozofs_ll_lookup_end(param,ret,error);
+    return;
+  }
+  rozofs_ll_getattr_end(param,ret,error);
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Send one operation of a batch in a regular EP_LOOKUP or EP_GETATTR
+*
+ @param batch : the batch
+ @param idx   : index of the operation in the batch
+ */
+static void rozofs_batch_send_single(rozofs_batch_t * batch,int idx) {
+  ep_batch_op_arg_t * op = &batch->ops[idx];
+  epgw_lookup_arg_t   lookup;
+  epgw_mfile_arg_t    getattr;
+  int                 ret;
+
+  if (op->op == EP_BATCH_LOOKUP) {
+    memset(&lookup.hdr,0,sizeof(lookup.hdr));
+    memcpy(&lookup.arg_gw,&op->ep_batch_op_arg_t_u.lookup,sizeof(ep_lookup_arg_t));
+    ret = rozofs_expgateway_send_routing_common(lookup.arg_gw.eid,(unsigned char*)lookup.arg_gw.parent,
+                                                EXPORT_PROGRAM, EXPORT_VERSION,
+                                                EP_LOOKUP,(xdrproc_t) xdr_epgw_lookup_arg_t,(void *)&lookup,
+                                                rozofs_ll_lookup_cbk,batch->param[idx]);
+  }
+  else {
+    memset(&getattr.hdr,0,sizeof(getattr.hdr));
+    memcpy(&getattr.arg_gw,&op->ep_batch_op_arg_t_u.getattr,sizeof(ep_mfile_arg_t));
+    ret = rozofs_expgateway_send_routing_common(getattr.arg_gw.eid,(unsigned char*)getattr.arg_gw.fid,
+                                                EXPORT_PROGRAM, EXPORT_VERSION,
+                                                EP_GETATTR,(xdrproc_t) xdr_epgw_mfile_arg_t,(void *)&getattr,
+                                                rozofs_ll_getattr_cbk,batch->param[idx]);
+  }
+  if (ret < 0) rozofs_batch_end(op,batch->param[idx],NULL,errno);
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Call back function of an EP_BATCH
+*
+ @param this : pointer to the transaction context
+ @param param: fuse context of the first operation of the batch
+ */
+static void rozofs_batch_cbk(void *this,void *param) {
+   rozofs_fuse_save_ctx_t *fuse_ctx_p;
+   rozofs_tx_ctx_t   *rozofs_tx_ctx_p = (rozofs_tx_ctx_t*)this;
+   rozofs_batch_t    *batch;
+   epgw_batch_ret_t   ret;
+   epgw_mattr_ret_t   mattr;
+   ep_batch_t        *res;
+   struct rpc_msg     rpc_reply;
+   xdrproc_t          decode_proc = (xdrproc_t)xdr_epgw_batch_ret_t;
+   uint8_t           *payload;
+   void              *recv_buf = NULL;
+   XDR                xdrs;
+   int                bufsize;
+   int                decoded = 0;
+   int                error;
+   int                idx;
+
+   GET_FUSE_CTX_P(fuse_ctx_p,param);
+   batch = fuse_ctx_p->batch_p;
+   rpc_reply.acpted_rply.ar_results.proc = NULL;
+    /*
+    ** get the status of the transaction -> 0 OK, -1 error (need to get errno for source cause
+    */
+    if (rozofs_tx_get_status(this) < 0)
+    {
+       errno = rozofs_tx_get_errno(this);
+       goto error;
+    }
+    recv_buf = rozofs_tx_get_recvBuf(this);
+    if (recv_buf == NULL)
+    {
+       errno = EFAULT;
+       goto error;
+    }
+    payload  = (uint8_t*) ruc_buf_getPayload(recv_buf);
+    payload += sizeof(uint32_t); /* skip length*/
+    /*
+    ** The response may come in a large receive buffer
+    */
+    bufsize = ruc_buf_getMaxPayloadLen(recv_buf);
+    bufsize -= sizeof(uint32_t); /* skip length*/
+    xdrmem_create(&xdrs,(char*)payload,bufsize,XDR_DECODE);
+    if (rozofs_xdr_replymsg(&xdrs,&rpc_reply) != TRUE)
+    {
+     TX_STATS(ROZOFS_TX_DECODING_ERROR);
+     errno = EPROTO;
+     goto error;
+    }
+    /*
+    ** An exportd that does not know EP_BATCH answers PROC_UNAVAIL:
+    ** stop batching and resend every operation alone
+    */
+    if ((rpc_reply.rm_reply.rp_stat == MSG_ACCEPTED) 
+    &&  (rpc_reply.acpted_rply.ar_stat == PROC_UNAVAIL)) {
+      goto unsupported;
+    }
+    memset(&ret,0, sizeof(ret));
+    decoded = 1;
+    if (decode_proc(&xdrs,&ret) == FALSE)
+    {
+       TX_STATS(ROZOFS_TX_DECODING_ERROR);
+       errno = EPROTO;
+       goto error;
+    }
+    /*
+    **  This gateway do not support the required eid 
+    */    
+    if (ret.status_gw.status == EP_FAILURE_EID_NOT_SUPPORTED) {    
+
+        /*
+        ** Do not try to select this server again for the eid
+        ** but directly send to the exportd
+        */
+        expgw_routing_expgw_for_eid(&fuse_ctx_p->expgw_routing_ctx, ret.hdr.eid, EXPGW_DOES_NOT_SUPPORT_EID);       
+
+        xdr_free((xdrproc_t) decode_proc, (char *) &ret);    
+        decoded = 0;
+
+        /* 
+        ** Attempt to re-send the batch to the exportd and wait being
+        ** called back again. One will use the same buffer, just changing
+        ** the xid.
+        */
+        if (rozofs_expgateway_resend_routing_common(rozofs_tx_ctx_p, NULL,param) == 0)
+        {
+          /*
+          ** do not forget to release the received buffer
+          */
+          ruc_buf_freeBuffer(recv_buf);
+          return;
+        }           
+        /*
+        ** Not able to resend the request
+        */
+        errno = EPROTO; /* What else ? */
+        goto error;
+    }
+    /*
+    ** The non blocking dispatcher of an exportd that does not know 
+    ** EP_BATCH answers ENOSYS, that EP_BATCH itself never returns
+    */
+    if ((ret.status_gw.status == EP_FAILURE) && (ret.status_gw.ep_batch_ret_t_u.error == ENOSYS)) {
+      goto unsupported;
+    }
+    /*
+    ** Failure of the whole batch
+    */
+    if (ret.status_gw.status != EP_SUCCESS) {
+      memset(&mattr,0,sizeof(mattr));
+      mattr.hdr = ret.hdr;
+      mattr.status_gw.status = EP_FAILURE;
+      mattr.status_gw.ep_mattr_ret_t_u.error = ret.status_gw.ep_batch_ret_t_u.error;
+      mattr.parent_attr.status = EP_EMPTY;
+      for (idx = 0; idx < batch->nb; idx++) {
+        rozofs_batch_end(&batch->ops[idx],batch->param[idx],&mattr,0);
+      }
+      goto out;
+    }
+    res = &ret.status_gw.ep_batch_ret_t_u.batch;
+    if (res->res.res_len != batch->nb) {
+      errno = EPROTO;
+      goto error;
+    }
+    /*
+    ** Give each operation its response as if it had been sent alone
+    */
+    for (idx = 0; idx < batch->nb; idx++) {
+      mattr.hdr         = ret.hdr;
+      mattr.free_quota  = res->free_quota;
+      mattr.bsize       = res->bsize;
+      mattr.layout      = res->layout;
+      mattr.status_gw   = res->res.res_val[idx].status_gw;
+      mattr.parent_attr = res->res.res_val[idx].parent_attr;
+      rozofs_batch_end(&batch->ops[idx],batch->param[idx],&mattr,0);
+    }
+    goto out;
+
+unsupported:
+    /*
+    ** Stop batching and resend every operation alone
+    */
+    if (rozofs_batch_unsupported == 0) {
+      warning("exportd does not support EP_BATCH, lookup and getattr are no more batched");
+    }
+    rozofs_batch_unsupported = 1;
+    /*
+    ** The routing context of the first operation is re-used for its new transaction
+    */
+    expgw_routing_release_buffer(&fuse_ctx_p->expgw_routing_ctx);
+    for (idx = 0; idx < batch->nb; idx++) {
+      rozofs_batch_send_single(batch,idx);
+    }
+    rozofs_batch_stats_resent += batch->nb;
+    goto out;
+
+error:
+    error = errno;
+    for (idx = 0; idx < batch->nb; idx++) {
+      rozofs_batch_end(&batch->ops[idx],batch->param[idx],NULL,error);
+    }
+out:
+    if (decoded) xdr_free((xdrproc_t) decode_proc, (char *) &ret);
+    rozofs_batch_release(batch);
+    if (rozofs_tx_ctx_p != NULL) rozofs_tx_free_from_ptr(rozofs_tx_ctx_p);
+    if (recv_buf != NULL) ruc_buf_freeBuffer(recv_buf);
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Send a batch. The transaction is owned by the fuse context of the first
+*  operation.
+*
+ @param batch : the batch
+ */
+static void rozofs_batch_send(rozofs_batch_t * batch) {
+  rozofs_fuse_save_ctx_t *fuse_ctx_p;
+  epgw_batch_arg_t        arg;
+  uint32_t              * fid;
+  int                     error;
+  int                     idx;
+
+  if (batch->nb == 1) {
+    rozofs_batch_stats_single++;
+    rozofs_batch_send_single(batch,0);
+    rozofs_batch_release(batch);
+    return;
+  }
+
+  memset(&arg.hdr,0,sizeof(arg.hdr));
+  arg.hdr.eid = batch->eid;
+  arg.ops.ops_len = batch->nb;
+  arg.ops.ops_val = batch->ops;
+
+  if (batch->ops[0].op == EP_BATCH_LOOKUP) fid = batch->ops[0].ep_batch_op_arg_t_u.lookup.parent;
+  else                                     fid = batch->ops[0].ep_batch_op_arg_t_u.getattr.fid;
+
+  GET_FUSE_CTX_P(fuse_ctx_p,batch->param[0]);
+  fuse_ctx_p->batch_p = batch;
+
+  if (rozofs_expgateway_send_routing_common(batch->eid,(unsigned char*)fid,EXPORT_PROGRAM, EXPORT_VERSION,
+                                            EP_BATCH,(xdrproc_t) xdr_epgw_batch_arg_t,(void *)&arg,
+                                            rozofs_batch_cbk,batch->param[0]) < 0) {
+    error = errno;
+    for (idx = 0; idx < batch->nb; idx++) {
+      rozofs_batch_end(&batch->ops[idx],batch->param[idx],NULL,error);
+    }
+    rozofs_batch_release(batch);
+    return;
+  }
+  rozofs_batch_stats_sent++;
+  rozofs_batch_stats_ops += batch->nb;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Get the batch being filled for the destination of a FID, that has room
+*  for an operation
+*
+ @param eid    : export identifier
+ @param fid    : fid used for routing the operation
+ @param size   : estimated XDR size of the operation
+
+ @retval the batch or NULL when the operation must be sent alone
+ */
+static rozofs_batch_t * rozofs_batch_get(uint32_t eid,fid_t fid,int size) {
+  expgw_tx_routing_ctx_t routing_ctx;
+  rozofs_batch_t       * batch;
+  int                    idx;
+  int                    max;
+
+  max = common_config.client_batch_max;
+  if (max > EP_BATCH_MAX) max = EP_BATCH_MAX;
+  if ((max < 2) || (rozofs_batch_unsupported)) return NULL;
+
+  if (expgw_get_export_routing_lbg_info(eid,fid,&routing_ctx) != 0) return NULL;
+
+  for (idx = 0; idx < rozofs_batch_filling_nb; idx++) {
+    batch = rozofs_batch_filling[idx];
+    if ((batch->lbg_id != routing_ctx.lbg_id[0]) || (batch->eid != eid)) continue;
+    if ((batch->nb < max)
+    &&  ((batch->size + size) <= (rozofs_tx_get_small_buffer_size() - ROZOFS_BATCH_HDR_SIZE))) {
+      return batch;
+    }
+    /*
+    ** This batch is full: send it and start a new one
+    */
+    rozofs_batch_filling[idx] = rozofs_batch_filling[--rozofs_batch_filling_nb];
+    rozofs_batch_send(batch);
+    break;
+  }
+
+  if ((rozofs_batch_free_nb == 0) || (rozofs_batch_filling_nb == ROZOFS_BATCH_DEST_MAX)) {
+    rozofs_batch_stats_no_ctx++;
+    return NULL;
+  }
+  batch = &rozofs_batch_tb[rozofs_batch_free_tb[--rozofs_batch_free_nb]];
+  batch->lbg_id = routing_ctx.lbg_id[0];
+  batch->eid    = eid;
+  batch->size   = 0;
+  batch->nb     = 0;
+  rozofs_batch_filling[rozofs_batch_filling_nb++] = batch;
+  return batch;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Queue a lookup in the batch of its destination. The name to look for
+*  is the one saved in the fuse context.
+*
+ @param eid    : export identifier
+ @param parent : fid of the parent directory
+ @param param  : fuse context of the lookup
+
+ @retval 0 when the lookup is queued
+ @retval -1 when the caller must send the lookup itself
+ */
+int rozofs_batch_lookup(uint32_t eid,fid_t parent,void *param) {
+  rozofs_fuse_save_ctx_t *fuse_ctx_p;
+  rozofs_batch_t         *batch;
+  ep_lookup_arg_t        *op;
+  int                     size;
+
+  GET_FUSE_CTX_P(fuse_ctx_p,param);
+  size = ROZOFS_BATCH_OP_SIZE + ((strlen(fuse_ctx_p->name) + 3) & ~3);
+
+  batch = rozofs_batch_get(eid,parent,size);
+  if (batch == NULL) return -1;
+
+  batch->ops[batch->nb].op = EP_BATCH_LOOKUP;
+  op = &batch->ops[batch->nb].ep_batch_op_arg_t_u.lookup;
+  op->eid  = eid;
+  memcpy(op->parent,parent,sizeof(fid_t));
+  op->name = fuse_ctx_p->name;
+  batch->param[batch->nb] = param;
+  batch->nb++;
+  batch->size += size;
+  return 0;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Queue a getattr in the batch of its destination
+*
+ @param eid    : export identifier
+ @param fid    : fid of the object
+ @param param  : fuse context of the getattr
+
+ @retval 0 when the getattr is queued
+ @retval -1 when the caller must send the getattr itself
+ */
+int rozofs_batch_getattr(uint32_t eid,fid_t fid,void *param) {
+  rozofs_batch_t         *batch;
+  ep_mfile_arg_t         *op;
+
+  batch = rozofs_batch_get(eid,fid,ROZOFS_BATCH_OP_SIZE);
+  if (batch == NULL) return -1;
+
+  batch->ops[batch->nb].op = EP_BATCH_GETATTR;
+  op = &batch->ops[batch->nb].ep_batch_op_arg_t_u.getattr;
+  op->eid  = eid;
+  memcpy(op->fid,fid,sizeof(fid_t));
+  batch->param[batch->nb] = param;
+  batch->nb++;
+  batch->size += ROZOFS_BATCH_OP_SIZE;
+  return 0;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Send the batches being filled. Called at the end of each reading of
+*  the fuse requests.
+*/
+void rozofs_batch_flush(void) {
+
+  while (rozofs_batch_filling_nb > 0) {
+    rozofs_batch_send(rozofs_batch_filling[--rozofs_batch_filling_nb]);
+  }
+}
+/*
+**__________________________________________________________________
+*/
+static char * show_batch_help(char * pChar) {
+  pChar += sprintf(pChar,"usage:\n");
+  pChar += sprintf(pChar,"batch       : display the lookup/getattr batching statistics\n");
+  pChar += sprintf(pChar,"batch reset : display then reset the lookup/getattr batching statistics\n");
+  return pChar;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  rozodiag display of the lookup/getattr batching
+*/
+static void show_batch(char * argv[], uint32_t tcpRef, void *bufRef) {
+  char * pChar = uma_dbg_get_buffer();
+  int    reset = 0;
+
+  if (argv[1] != NULL) {
+    if (strcmp(argv[1],"reset") != 0) {
+      show_batch_help(pChar);
+      uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
+      return;
+    }
+    reset = 1;
+  }
+
+  pChar += sprintf(pChar,"batch max       : %d%s\n", common_config.client_batch_max,
+                   rozofs_batch_unsupported ? " (not supported by the exportd)" : "");
+  pChar += sprintf(pChar,"batch contexts  : %d/%d\n", rozofs_batch_free_nb, ROZOFS_BATCH_CTX_MAX);
+  pChar += sprintf(pChar,"EP_BATCH sent   : %llu\n", (unsigned long long) rozofs_batch_stats_sent);
+  pChar += sprintf(pChar,"batched ops     : %llu (%llu per EP_BATCH)\n",
+                   (unsigned long long) rozofs_batch_stats_ops,
+                   (unsigned long long) ((rozofs_batch_stats_sent == 0) ? 0 : rozofs_batch_stats_ops / rozofs_batch_stats_sent));
+  pChar += sprintf(pChar,"single ops      : %llu\n", (unsigned long long) rozofs_batch_stats_single);
+  pChar += sprintf(pChar,"no context      : %llu\n", (unsigned long long) rozofs_batch_stats_no_ctx);
+  pChar += sprintf(pChar,"resent ops      : %llu\n", (unsigned long long) rozofs_batch_stats_resent);
+
+  if (reset) {
+    rozofs_batch_stats_sent   = 0;
+    rozofs_batch_stats_ops    = 0;
+    rozofs_batch_stats_single = 0;
+    rozofs_batch_stats_no_ctx = 0;
+    rozofs_batch_stats_resent = 0;
+    pChar += sprintf(pChar,"Reset Done\n");
+  }
+  uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Init of the batch contexts and of the rozodiag batch topic
+*/
+void rozofs_batch_init(void) {
+  int idx;
+
+  memset(rozofs_batch_tb,0,sizeof(rozofs_batch_tb));
+  for (idx = 0; idx < ROZOFS_BATCH_CTX_MAX; idx++) {
+    rozofs_batch_tb[idx].idx = idx;
+    rozofs_batch_free_tb[idx] = ROZOFS_BATCH_CTX_MAX - 1 - idx;
+  }
+  rozofs_batch_free_nb    = ROZOFS_BATCH_CTX_MAX;
+  rozofs_batch_filling_nb = 0;
+  uma_dbg_addTopic_option("batch", show_batch, UMA_DBG_OPTION_RESET);
+}
@@ -0,0 +1,105 @@
+/*
+  Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+  This file is part of Rozofs.
+
+  Rozofs is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation, version 2.
+
+  Rozofs is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see
+  <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROZOFS_BATCH_H
+#define ROZOFS_BATCH_H
+
+#include <rozofs/rozofs.h>
+#include <rozofs/rpc/eproto.h>
+
+/*
+** Batching of the lookup and getattr requests toward the exportd.
+**
+** The lookup and getattr requests read from fuse in one socket controller
+** loop are queued per destination instead of being sent one by one, and the
+** queues are sent as EP_BATCH requests at the end of the loop. A queue with
+** a single request is sent as a regular EP_LOOKUP or EP_GETATTR.
+*/
+#define ROZOFS_BATCH_CTX_MAX   64   /**< batches sent and not yet answered */
+#define ROZOFS_BATCH_DEST_MAX   4   /**< destinations of the batches being filled */
+
+/*
+**__________________________________________________________________
+*/
+/**
+*  End of a lookup: reply to fuse with the response of the exportd
+*  (single EP_LOOKUP or operation of an EP_BATCH)
+*
+ @param param: pointer to the associated rozofs_fuse_context
+ @param ret  : decoded response of the exportd, NULL when the transaction failed
+ @param error: errno of the failed transaction (ret is NULL)
+ */
+void rozofs_ll_lookup_end(void *param,epgw_mattr_ret_t *ret,int error);
+/*
+**__________________________________________________________________
+*/
+/**
+*  End of a getattr: reply to fuse with the response of the exportd
+*  (single EP_GETATTR or operation of an EP_BATCH)
+*
+ @param param: pointer to the associated rozofs_fuse_context
+ @param ret  : decoded response of the exportd, NULL when the transaction failed
+ @param error: errno of the failed transaction (ret is NULL)
+ */
+void rozofs_ll_getattr_end(void *param,epgw_mattr_ret_t *ret,int error);
+/*
+**__________________________________________________________________
+*/
+/**
+*  Queue a lookup in the batch of its destination. The name to look for
+*  is the one saved in the fuse context.
+*
+ @param eid    : export identifier
+ @param parent : fid of the parent directory
+ @param param  : fuse context of the lookup
+
+ @retval 0 when the lookup is queued
+ @retval -1 when the caller must send the lookup itself
+ */
+int rozofs_batch_lookup(uint32_t eid,fid_t parent,void *param);
+/*
+**__________________________________________________________________
+*/
+/**
+*  Queue a getattr in the batch of its destination
+*
+ @param eid    : export identifier
+ @param fid    : fid of the object
+ @param param  : fuse context of the getattr
+
+ @retval 0 when the getattr is queued
+ @retval -1 when the caller must send the getattr itself
+ */
+int rozofs_batch_getattr(uint32_t eid,fid_t fid,void *param);
+/*
+**__________________________________________________________________
+*/
+/**
+*  Send the batches being filled. Called at the end of each reading of
+*  the fuse requests.
+*/
+void rozofs_batch_flush(void);
+/*
+**__________________________________________________________________
+*/
+/**
+*  Init of the batch contexts and of the rozodiag batch topic
+*/
+void rozofs_batch_init(void);
+
+#endif
@@ -861,6 +861,11 @@ void rozofs_ll_setlk_nb(fuse_req_t req,
                                         f->lock_type, sleep);
     f->lock_trc_idx = lock_trc_idx; 
     
+    /*
+    ** Send the write behind extents, they are older than the buffer
+    */
+    if (f->wb_count != 0) rozofs_wb_drain(f);
+    
     /*
     ** Flush the buffer if some data is pending
     */
@@ -929,6 +934,7 @@ void rozofs_ll_setlk_after_flush(void *this,void *param)
 
    file = (file_t *) (unsigned long)  fi->fh;   
    file->buf_write_pending--;
+   rozofs_wb_write_done(file,param);
    if (file->buf_write_pending < 0)
    {
      severe("buf_write_pending mismatch, %d",file->buf_write_pending);
@@ -23,6 +23,8 @@
 #include "rozofs_fuse.h"
 #include "rozofs_fuse_api.h"
 #include "rozofs_sharedmem.h"
+#include "rozofs_batch.h"
+#include "rozofs_readdirplus.h"
 
 rozofs_fuse_ctx_t  *rozofs_fuse_ctx_p = NULL;  /**< pointer to the rozofs_fuse saved contexts   */
 uint64_t rozofs_write_merge_stats_tab[RZ_FUSE_WRITE_MAX]; /**< read/write merge stats table */
@@ -411,10 +413,7 @@ uint32_t rozofs_fuse_rcvReadysock(void * rozofs_fuse_ctx_p,int socketId)
 **__________________________________________________________________________
 */
 /**
-  Application callBack:
-
-   Called from the socket controller when there is a message pending on the
-   socket associated with the context provide in input arguments.
+   Read the requests pending on the fuse socket
 
 
     
@@ -425,7 +424,7 @@ uint32_t rozofs_fuse_rcvReadysock(void * rozofs_fuse_ctx_p,int socketId)
   @retval : FALSE-> xmit  ready event not expected
 */
 
-uint32_t rozofs_fuse_rcvMsgsock(void * rozofs_fuse_ctx_p,int socketId)
+static uint32_t rozofs_fuse_rcvMsgsock_loop(void * rozofs_fuse_ctx_p,int socketId)
 {
     rozofs_fuse_ctx_t  *ctx_p;
     int k;
@@ -480,6 +479,33 @@ uint32_t rozofs_fuse_rcvMsgsock(void * rozofs_fuse_ctx_p,int socketId)
     
     return TRUE;
 }
+/*
+**__________________________________________________________________________
+*/
+/**
+  Application callBack:
+
+   Called from the socket controller when there is a message pending on the
+   socket associated with the context provide in input arguments.
+   
+   The lookup and getattr requests read from fuse are queued in batches
+   that are sent once every pending request has been read.
+
+  @param rozofs_fuse_ctx_p: pointer to the af unix socket
+  @param socketId: reference of the socket (not used)
+ 
+   @retval : TRUE-> xmit ready event expected
+  @retval : FALSE-> xmit  ready event not expected
+*/
+
+uint32_t rozofs_fuse_rcvMsgsock(void * rozofs_fuse_ctx_p,int socketId)
+{
+    uint32_t ret;
+
+    ret = rozofs_fuse_rcvMsgsock_loop(rozofs_fuse_ctx_p,socketId);
+    rozofs_batch_flush();
+    return ret;
+}
 
 
 
@@ -1102,6 +1128,8 @@ int rozofs_fuse_init(struct fuse_chan *ch,struct fuse_session *se,int rozofs_fus
   for(i = 0; i < 3;i++) fuse_profile[i] = 0;
   
   uma_dbg_addTopic("fuse", rozofs_fuse_show);
+  rozofs_batch_init();
+  rozofs_rdplus_init();
   return status;
   
 }
@@ -124,6 +124,7 @@ typedef struct _rozofs_fuse_save_ctx_t
    int       trc_idx;                    /**< trace index */
    int       lkup_cpt;
    rozofs_fuse_lookup_entry_t lookup_tb[ROZOFS_MAX_PENDING_LKUP];
+   void     *batch_p;                    /**< EP_BATCH owning the transaction of the context */
    /*
    ** Parameters specific to the exportd gateway management
    */
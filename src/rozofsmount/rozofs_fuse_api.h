@@ -605,6 +605,7 @@ static inline void *_rozofs_fuse_alloc_saved_context(char *name )
   ruc_listEltInit(&fuse_save_ctx_p->link);
   ruc_listHdrInit(&fuse_save_ctx_p->link_req);
   fuse_save_ctx_p->lkup_cpt = 0;
+  fuse_save_ctx_p->batch_p  = NULL;
   /*save the reference of the buffer */
   
 //  STOP_PROFILING_FUSE();
@@ -200,19 +200,27 @@ void *rozofs_fuse_thread(void *arg) {
   
   while(1) {
   
-    /*
-    ** read the north disk socket
-    */
-    bytesRcvd = recvfrom(af_unix_fuse_socket_ref,
-			 &msg,sizeof(msg), 
-			 0,(struct sockaddr *)NULL,NULL);
-    if (bytesRcvd == -1) {
-      fatal("Disk Thread %d recvfrom %s !!\n",ctx_p->thread_idx,strerror(errno));
-      exit(0);
+    if (rozofs_fuse_channel != NULL) {
+      /*
+      ** read the request ring of the thread
+      */
+      rozofs_thread_channel_receive(rozofs_fuse_channel, ctx_p->thread_idx, &msg);
     }
-    if (bytesRcvd != sizeof(msg)) {
-      fatal("Disk Thread %d socket is dead (%d/%d) %s !!\n",ctx_p->thread_idx,bytesRcvd,(int)sizeof(msg),strerror(errno));
-      exit(0);    
+    else {
+      /*
+      ** read the north disk socket
+      */
+      bytesRcvd = recvfrom(af_unix_fuse_socket_ref,
+			   &msg,sizeof(msg), 
+			   0,(struct sockaddr *)NULL,NULL);
+      if (bytesRcvd == -1) {
+	fatal("Disk Thread %d recvfrom %s !!\n",ctx_p->thread_idx,strerror(errno));
+	exit(0);
+      }
+      if (bytesRcvd != sizeof(msg)) {
+	fatal("Disk Thread %d socket is dead (%d/%d) %s !!\n",ctx_p->thread_idx,bytesRcvd,(int)sizeof(msg),strerror(errno));
+	exit(0);    
+      }
     }
     
     switch (msg.opcode) {
@@ -249,17 +257,20 @@ int rozofs_fuse_thread_create(char * hostname, int nb_threads, int instance_id)
    memset(rozofs_fuse_thread_ctx_tb,0,sizeof(rozofs_fuse_thread_ctx_tb));
    /*
    ** create the common socket to receive requests on
+   ** unless the requests are given through rings
    */
    char * pChar = socketName;
-   pChar += rozofs_string_append(pChar,ROZOFS_SOCK_FAMILY_FUSE_NORTH);
-   *pChar++ = '_';
-   pChar += rozofs_u32_append(pChar,instance_id);
-   *pChar++ = '_';  
-   pChar += rozofs_string_append(pChar,hostname);
-   af_unix_fuse_socket_ref = af_unix_fuse_sock_create_internal(socketName,1024*32);
-   if (af_unix_fuse_socket_ref < 0) {
-      fatal("af_unix_fuse_thread_create af_unix_fuse_sock_create_internal(%s) %s",socketName,strerror(errno));
-      return -1;   
+   if (rozofs_fuse_channel == NULL) {
+     pChar += rozofs_string_append(pChar,ROZOFS_SOCK_FAMILY_FUSE_NORTH);
+     *pChar++ = '_';
+     pChar += rozofs_u32_append(pChar,instance_id);
+     *pChar++ = '_';  
+     pChar += rozofs_string_append(pChar,hostname);
+     af_unix_fuse_socket_ref = af_unix_fuse_sock_create_internal(socketName,1024*32);
+     if (af_unix_fuse_socket_ref < 0) {
+	fatal("af_unix_fuse_thread_create af_unix_fuse_sock_create_internal(%s) %s",socketName,strerror(errno));
+	return -1;   
+     }
    }
    /*
    ** Now create the threads
@@ -271,19 +282,22 @@ int rozofs_fuse_thread_create(char * hostname, int nb_threads, int instance_id)
      /*
      ** create the thread specific socket to send the response from 
      */
-     pChar = socketName;
-     pChar += rozofs_string_append(pChar,ROZOFS_SOCK_FAMILY_FUSE_NORTH);
-     *pChar++ = '_';
-     pChar += rozofs_u32_append(pChar,instance_id);
-     *pChar++ = '_';  
-     pChar += rozofs_string_append(pChar,hostname);
-     *pChar++ = '_'; 
-     pChar += rozofs_u32_append(pChar,i);
-     thread_ctx_p->sendSocket = af_unix_fuse_sock_create_internal(socketName,1024*32);
-     if (thread_ctx_p->sendSocket < 0) {
-	fatal("af_unix_fuse_thread_create af_unix_fuse_sock_create_internal(%s) %s",socketName, strerror(errno));
-	return -1;   
-     }   
+     thread_ctx_p->sendSocket = -1;
+     if (rozofs_fuse_channel == NULL) {
+       pChar = socketName;
+       pChar += rozofs_string_append(pChar,ROZOFS_SOCK_FAMILY_FUSE_NORTH);
+       *pChar++ = '_';
+       pChar += rozofs_u32_append(pChar,instance_id);
+       *pChar++ = '_';  
+       pChar += rozofs_string_append(pChar,hostname);
+       *pChar++ = '_'; 
+       pChar += rozofs_u32_append(pChar,i);
+       thread_ctx_p->sendSocket = af_unix_fuse_sock_create_internal(socketName,1024*32);
+       if (thread_ctx_p->sendSocket < 0) {
+	  fatal("af_unix_fuse_thread_create af_unix_fuse_sock_create_internal(%s) %s",socketName, strerror(errno));
+	  return -1;   
+       }   
+     }
    
      err = pthread_attr_init(&attr);
      if (err != 0) {
@@ -27,6 +27,7 @@
 #include <rozofs/common/profile.h>
 #include <rozofs/core/af_unix_socket_generic_api.h>
 #include <rozofs/core/ruc_buffer_debug.h>
+#include <rozofs/common/common_config.h>
 #include "rozofs_fuse_api.h"
 #include "rozofs_sharedmem.h"
 #include "rozofs_fuse_thread_intf.h"
@@ -35,6 +36,7 @@
 int        af_unix_fuse_south_socket_ref = -1;
 int        af_unix_fuse_thread_count=0;
 int        af_unix_fuse_pending_req_count = 0;
+rozofs_thread_channel_t * rozofs_fuse_channel = NULL;
 
 struct  sockaddr_un rozofs_fuse_south_socket_name;
 struct  sockaddr_un rozofs_fuse_north_socket_name;
@@ -161,6 +163,9 @@ void fuse_thread_debug(char * argv[], uint32_t tcpRef, void *bufRef) {
     *pChar++= '\n';
     *pChar = 0;
   }
+  if (rozofs_fuse_channel != NULL) {
+    pChar = rozofs_thread_channel_display(rozofs_fuse_channel, pChar);
+  }
 
   if (doreset) {
     for (i=0; i<af_unix_fuse_thread_count; i++) {
@@ -444,6 +449,11 @@ void rozofs_fuse_th_send_response (rozofs_fuse_thread_ctx_t *thread_ctx_p, rozof
   msg->status = status;
   msg->timeResp = tic;
   
+  if (rozofs_fuse_channel != NULL) {
+    rozofs_thread_channel_reply(rozofs_fuse_channel, thread_ctx_p->thread_idx, msg);
+    return;
+  }
+  
   /*
   ** send back the response
   */  
@@ -486,6 +496,18 @@ int rozofs_thread_fuse_reply_buf(fuse_req_t req,
   msg.bufRef           = bufRef;
   
   /* Send the buffer to its destination */
+  if (rozofs_fuse_channel != NULL) {
+    if (rozofs_thread_channel_send(rozofs_fuse_channel, &msg, 1) < 0) {
+      /*
+      ** No room in the rings: reply from the main thread
+      */
+      fuse_reply_buf(req, payload, size);
+      af_unix_fuse_response(&msg);
+      return 0;
+    }
+    af_unix_fuse_pending_req_count++;
+    return 0;
+  }
   ret = sendto(af_unix_fuse_south_socket_ref,&msg, sizeof(msg),0,(struct sockaddr*)&rozofs_fuse_north_socket_name,sizeof(rozofs_fuse_north_socket_name));
   if (ret <= 0) {
      fatal("rozofs_fuse_thread_intf_send  sendto(%s) %s", rozofs_fuse_north_socket_name.sun_path, strerror(errno));
@@ -574,8 +596,25 @@ int af_unix_fuse_response_socket_create(char *socketname)
 */
 void af_unix_fuse_scheduler_entry_point(uint64_t current_time)
 {
+  if (rozofs_fuse_channel != NULL) {
+    rozofs_thread_channel_poll(rozofs_fuse_channel);
+    return;
+  }
   af_unix_fuse_rcvMsgsock(NULL,af_unix_fuse_south_socket_ref);
 }
+/*__________________________________________________________________________
+*/
+/**
+*   Processing of a response read from the fuse thread rings
+*
+   @param msg : the fuse thread response
+*/
+static void rozofs_fuse_channel_response(void * msg)
+{
+  af_unix_fuse_pending_req_count--;
+  if (af_unix_fuse_pending_req_count < 0) af_unix_fuse_pending_req_count = 0;
+  af_unix_fuse_response((rozofs_fuse_thread_msg_t *) msg);
+}
 
 /*__________________________________________________________________________
 * Initialize the disk thread interface
@@ -594,14 +633,29 @@ int rozofs_fuse_thread_intf_create(char * hostname, int instance_id, int nb_thre
   */
   fuse_set_socket_name_with_hostname(&rozofs_fuse_south_socket_name,ROZOFS_SOCK_FAMILY_FUSE_SOUTH,hostname, instance_id);
     
+  /*
+  ** Exchange with the fuse threads through rings when configured.
+  ** There can not be more pending replies than shared buffers.
+  */
+  if (common_config.thread_ring) {
+    rozofs_fuse_channel = rozofs_thread_channel_create("fuse_ring", nb_threads, 
+                                                       sizeof(rozofs_fuse_thread_msg_t),
+                                                       rozofs_max_storcli_tx, rozofs_fuse_channel_response);
+    if (rozofs_fuse_channel == NULL) {
+      warning("Fuse thread rings can not be created. Using AF_UNIX sockets.");
+    }
+  }
+  
   /*
   ** hostname is required for the case when several storaged run on the same server
   ** as is the case of test on one server only
   */   
-  af_unix_fuse_south_socket_ref = af_unix_fuse_response_socket_create(rozofs_fuse_south_socket_name.sun_path);
-  if (af_unix_fuse_south_socket_ref < 0) {
-    fatal("storio_create_fuse_thread_intf af_unix_sock_create(%s) %s",rozofs_fuse_south_socket_name.sun_path, strerror(errno));
-    return -1;
+  if (rozofs_fuse_channel == NULL) {
+    af_unix_fuse_south_socket_ref = af_unix_fuse_response_socket_create(rozofs_fuse_south_socket_name.sun_path);
+    if (af_unix_fuse_south_socket_ref < 0) {
+      fatal("storio_create_fuse_thread_intf af_unix_sock_create(%s) %s",rozofs_fuse_south_socket_name.sun_path, strerror(errno));
+      return -1;
+    }
   }
  /*
   ** init of the AF_UNIX sockaddr associated with the north socket (socket used for disk request receive)
@@ -27,6 +27,7 @@
 #include <rozofs/common/log.h>
 #include <rozofs/core/af_unix_socket_generic.h>
 #include <rozofs/core/rozofs_socket_family.h>
+#include <rozofs/core/rozofs_ring.h>
 #include "rozofs_fuse_api.h"
 #include "rozofs_sharedmem.h"
 
@@ -52,6 +53,10 @@ typedef struct _rozofs_fuse_thread_ctx_t
 } rozofs_fuse_thread_ctx_t;
 
 extern rozofs_fuse_thread_ctx_t rozofs_fuse_thread_ctx_tb[];
+/*
+** Rings between the main thread and the fuse threads (NULL when AF_UNIX sockets are used)
+*/
+extern rozofs_thread_channel_t * rozofs_fuse_channel;
 
 /**
 * Message sent/received in the af_unix disk sockets
@@ -205,7 +205,7 @@ void rzkpi_cache_initialize(rzkpi_lv2_cache_t *cache) {
     cache->miss = 0;
     cache->lru_del = 0;
     list_init(&cache->lru);
-    htable_initialize(&cache->htable,RZKPI_LV2_BUKETS , lv2_hash, lv2_cmp);
+    htable_initialize_oa(&cache->htable,RZKPI_LV2_BUKETS, 0, lv2_hash, lv2_cmp);
     memset(cache->hash_stats,0,sizeof(uint64_t)*RZKPI_LV2_MAX_LOCK);
 
 }
@@ -20,6 +20,7 @@
 
 #include "rozofs_fuse_api.h"
 #include "rozofs_kpi.h"
+#include "rozofs_readdirplus.h"
 DECLARE_PROFILING(mpp_profiler_t);
 
 /*
@@ -900,6 +901,7 @@ void rozofs_ll_unlink_nb(fuse_req_t req, fuse_ino_t parent, const char *name) {
     START_PROFILING_NB(buffer_p,rozofs_ll_unlink);
 
     DEBUG("unlink (%lu,%s)\n", (unsigned long int) parent, name);
+    rozofs_rdplus_invalidate(parent,name);
 
     if (!(ie = get_ientry_by_inode(parent))) {
         errno = ENOENT;
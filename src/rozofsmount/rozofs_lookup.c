@@ -19,6 +19,8 @@
 #include <rozofs/rpc/eproto.h>
 
 #include "rozofs_fuse_api.h"
+#include "rozofs_batch.h"
+#include "rozofs_readdirplus.h"
 #include <rozofs/core/rozofs_string.h>
 
 DECLARE_PROFILING(mpp_profiler_t);
@@ -375,6 +377,10 @@ void rozofs_ll_lookup_nb(fuse_req_t req, fuse_ino_t parent, const char *name)
       }     
     }    
     /*
+    ** The entry may have been listed by a recent readdirplus
+    */
+    if ((nie = rozofs_rdplus_lookup(parent,name,&stbuf)) != NULL) goto success;
+    /*
     ** Queue the request and attempt to check if there is already the same
     ** request queued
     */
@@ -441,6 +447,10 @@ void rozofs_ll_lookup_nb(fuse_req_t req, fuse_ino_t parent, const char *name)
       }      
     }  
 #endif         
+    /*
+    ** Queue the lookup in an EP_BATCH sent at the end of the fuse reading
+    */
+    if (rozofs_batch_lookup(arg.arg_gw.eid,ie->fid,buffer_p) == 0) return;
     
 #if 1
     ret = rozofs_expgateway_send_routing_common(arg.arg_gw.eid,ie->fid,EXPORT_PROGRAM, EXPORT_VERSION,
@@ -539,31 +549,26 @@ success:
 }
 
 /**
-*  Call back function call upon a success rpc, timeout or any other rpc failure
+*  End of a lookup: reply to fuse with the response of the exportd
+*  (single EP_LOOKUP or operation of an EP_BATCH)
 *
- @param this : pointer to the transaction context
  @param param: pointer to the associated rozofs_fuse_context
+ @param ret  : decoded response of the exportd, NULL when the transaction failed
+ @param error: errno of the failed transaction (ret is NULL)
  
  @return none
  */
 
-void rozofs_ll_lookup_cbk(void *this,void *param) 
+void rozofs_ll_lookup_end(void *param,epgw_mattr_ret_t *ret,int error) 
 {
    struct fuse_entry_param fep;
    ientry_t *nie = 0;
    struct stat stbuf;
    fuse_req_t req; 
-   epgw_mattr_ret_t ret ;
-   struct rpc_msg  rpc_reply;
    char *name;
    
-   int status;
-   uint8_t  *payload;
-   void     *recv_buf = NULL;   
-   XDR       xdrs;    
-   int      bufsize;
+   int status = 0;
    mattr_t  attrs;
-   xdrproc_t decode_proc = (xdrproc_t)xdr_epgw_mattr_ret_t;
    rozofs_fuse_save_ctx_t *fuse_ctx_p;
    int trc_idx;
    errno = 0;
@@ -579,26 +584,18 @@ void rozofs_ll_lookup_cbk(void *this,void *param)
    */
    ruc_objRemove(param);  
     
-   rpc_reply.acpted_rply.ar_results.proc = NULL;
    RESTORE_FUSE_PARAM(param,req);
    RESTORE_FUSE_PARAM(param,trc_idx);
    RESTORE_FUSE_PARAM(param,ino);
    RESTORE_FUSE_STRUCT_PTR(param,name);
-    /*
-    ** get the pointer to the transaction context:
-    ** it is required to get the information related to the receive buffer
-    */
-    rozofs_tx_ctx_t      *rozofs_tx_ctx_p = (rozofs_tx_ctx_t*)this;     
-    /*    
-    ** get the status of the transaction -> 0 OK, -1 error (need to get errno for source cause
-    */
-    status = rozofs_tx_get_status(this);
-    if (status < 0)
+
+    if (ret == NULL)
     {
        /*
        ** something wrong happened
        */
-       errno = rozofs_tx_get_errno(this); 
+       status = -1;
+       errno = error; 
        /*
        ** In case of fast reconnect mode let's respond with the previously knows 
        ** parameters instead of failing
@@ -616,86 +613,9 @@ void rozofs_ll_lookup_cbk(void *this,void *param)
        }        
        goto error; 
     }
-    /*
-    ** get the pointer to the receive buffer payload
-    */
-    recv_buf = rozofs_tx_get_recvBuf(this);
-    if (recv_buf == NULL)
-    {
-       /*
-       ** something wrong happened
-       */
-       errno = EFAULT;  
-       goto error;         
-    }
-    payload  = (uint8_t*) ruc_buf_getPayload(recv_buf);
-    payload += sizeof(uint32_t); /* skip length*/
-    /*
-    ** OK now decode the received message
-    */
-    bufsize = rozofs_tx_get_small_buffer_size();
-    bufsize -= sizeof(uint32_t); /* skip length*/
-    xdrmem_create(&xdrs,(char*)payload,bufsize,XDR_DECODE);
-    /*
-    ** decode the rpc part
-    */
-    if (rozofs_xdr_replymsg(&xdrs,&rpc_reply) != TRUE)
-    {
-     TX_STATS(ROZOFS_TX_DECODING_ERROR);
-     errno = EPROTO;
-     goto error;
-    }
-    /*
-    ** ok now call the procedure to encode the message
-    */
-    memset(&ret,0, sizeof(ret));                    
-    if (decode_proc(&xdrs,&ret) == FALSE)
-    {
-       TX_STATS(ROZOFS_TX_DECODING_ERROR);
-       errno = EPROTO;
-       xdr_free((xdrproc_t) decode_proc, (char *) &ret);
-       goto error;
-    }   
-    
-    /*
-    **  This gateway do not support the required eid 
-    */    
-    if (ret.status_gw.status == EP_FAILURE_EID_NOT_SUPPORTED) {    
-
-        /*
-        ** Do not try to select this server again for the eid
-        ** but directly send to the exportd
-        */
-        expgw_routing_expgw_for_eid(&fuse_ctx_p->expgw_routing_ctx, ret.hdr.eid, EXPGW_DOES_NOT_SUPPORT_EID);       
-
-        xdr_free((xdrproc_t) decode_proc, (char *) &ret);    
-
-        /* 
-        ** Attempt to re-send the request to the exportd and wait being
-        ** called back again. One will use the same buffer, just changing
-        ** the xid.
-        */
-        status = rozofs_expgateway_resend_routing_common(rozofs_tx_ctx_p, NULL,param); 
-        if (status == 0)
-        {
-          /*
-          ** do not forget to release the received buffer
-          */
-          ruc_buf_freeBuffer(recv_buf);
-          recv_buf = NULL;
-          return;
-        }           
-        /*
-        ** Not able to resend the request
-        */
-        errno = EPROTO; /* What else ? */
-        goto error;
-         
-    }
         
-    if (ret.status_gw.status == EP_FAILURE) {
-        errno = ret.status_gw.ep_mattr_ret_t_u.error;
-        xdr_free((xdrproc_t) decode_proc, (char *) &ret);   
+    if (ret->status_gw.status == EP_FAILURE) {
+        errno = ret->status_gw.ep_mattr_ret_t_u.error;
 	
 	/*
 	** Case of non existent entry. 
@@ -733,14 +653,13 @@ void rozofs_ll_lookup_cbk(void *this,void *param)
     /*
     ** Update eid free quota
     */
-    eid_set_free_quota(ret.free_quota);
+    eid_set_free_quota(ret->free_quota);
     
-    memcpy(&attrs, &ret.status_gw.ep_mattr_ret_t_u.attrs, sizeof (mattr_t));
+    memcpy(&attrs, &ret->status_gw.ep_mattr_ret_t_u.attrs, sizeof (mattr_t));
     /*
     ** get the parent attributes
     */
-    memcpy(&pattrs, &ret.parent_attr.ep_mattr_ret_t_u.attrs, sizeof (mattr_t));
-    xdr_free((xdrproc_t) decode_proc, (char *) &ret);    
+    memcpy(&pattrs, &ret->parent_attr.ep_mattr_ret_t_u.attrs, sizeof (mattr_t));
  
     if (!(nie = get_ientry_by_fid(attrs.fid))) {
         nie = alloc_ientry(attrs.fid);
@@ -842,11 +761,143 @@ error:
     }
 out:
     /*
-    ** release the transaction context and the fuse context
+    ** release the fuse context
     */
     rozofs_trc_rsp_attr(srv_rozofs_ll_lookup,(nie==NULL)?0:nie->inode,(nie==NULL)?NULL:nie->attrs.fid,status,(nie==NULL)?-1:nie->attrs.size,trc_idx);
     STOP_PROFILING_NB(param,rozofs_ll_lookup);
     rozofs_fuse_release_saved_context(param);
+    
+    return;
+}
+
+/**
+*  Call back function call upon a success rpc, timeout or any other rpc failure
+*
+ @param this : pointer to the transaction context
+ @param param: pointer to the associated rozofs_fuse_context
+ 
+ @return none
+ */
+
+void rozofs_ll_lookup_cbk(void *this,void *param) 
+{
+   epgw_mattr_ret_t ret ;
+   struct rpc_msg  rpc_reply;
+   
+   int status;
+   uint8_t  *payload;
+   void     *recv_buf = NULL;   
+   XDR       xdrs;    
+   int      bufsize;
+   xdrproc_t decode_proc = (xdrproc_t)xdr_epgw_mattr_ret_t;
+   rozofs_fuse_save_ctx_t *fuse_ctx_p;
+   errno = 0;
+   
+   GET_FUSE_CTX_P(fuse_ctx_p,param);  
+    
+   rpc_reply.acpted_rply.ar_results.proc = NULL;
+    /*
+    ** get the pointer to the transaction context:
+    ** it is required to get the information related to the receive buffer
+    */
+    rozofs_tx_ctx_t      *rozofs_tx_ctx_p = (rozofs_tx_ctx_t*)this;     
+    /*    
+    ** get the status of the transaction -> 0 OK, -1 error (need to get errno for source cause
+    */
+    status = rozofs_tx_get_status(this);
+    if (status < 0)
+    {
+       /*
+       ** something wrong happened
+       */
+       errno = rozofs_tx_get_errno(this); 
+       goto error; 
+    }
+    /*
+    ** get the pointer to the receive buffer payload
+    */
+    recv_buf = rozofs_tx_get_recvBuf(this);
+    if (recv_buf == NULL)
+    {
+       /*
+       ** something wrong happened
+       */
+       errno = EFAULT;  
+       goto error;         
+    }
+    payload  = (uint8_t*) ruc_buf_getPayload(recv_buf);
+    payload += sizeof(uint32_t); /* skip length*/
+    /*
+    ** OK now decode the received message
+    */
+    bufsize = rozofs_tx_get_small_buffer_size();
+    bufsize -= sizeof(uint32_t); /* skip length*/
+    xdrmem_create(&xdrs,(char*)payload,bufsize,XDR_DECODE);
+    /*
+    ** decode the rpc part
+    */
+    if (rozofs_xdr_replymsg(&xdrs,&rpc_reply) != TRUE)
+    {
+     TX_STATS(ROZOFS_TX_DECODING_ERROR);
+     errno = EPROTO;
+     goto error;
+    }
+    /*
+    ** ok now call the procedure to encode the message
+    */
+    memset(&ret,0, sizeof(ret));                    
+    if (decode_proc(&xdrs,&ret) == FALSE)
+    {
+       TX_STATS(ROZOFS_TX_DECODING_ERROR);
+       errno = EPROTO;
+       xdr_free((xdrproc_t) decode_proc, (char *) &ret);
+       goto error;
+    }   
+    
+    /*
+    **  This gateway do not support the required eid 
+    */    
+    if (ret.status_gw.status == EP_FAILURE_EID_NOT_SUPPORTED) {    
+
+        /*
+        ** Do not try to select this server again for the eid
+        ** but directly send to the exportd
+        */
+        expgw_routing_expgw_for_eid(&fuse_ctx_p->expgw_routing_ctx, ret.hdr.eid, EXPGW_DOES_NOT_SUPPORT_EID);       
+
+        xdr_free((xdrproc_t) decode_proc, (char *) &ret);    
+
+        /* 
+        ** Attempt to re-send the request to the exportd and wait being
+        ** called back again. One will use the same buffer, just changing
+        ** the xid.
+        */
+        status = rozofs_expgateway_resend_routing_common(rozofs_tx_ctx_p, NULL,param); 
+        if (status == 0)
+        {
+          /*
+          ** do not forget to release the received buffer
+          */
+          ruc_buf_freeBuffer(recv_buf);
+          recv_buf = NULL;
+          return;
+        }           
+        /*
+        ** Not able to resend the request
+        */
+        errno = EPROTO; /* What else ? */
+        goto error;
+         
+    }
+    rozofs_ll_lookup_end(param,&ret,0);
+    xdr_free((xdrproc_t) decode_proc, (char *) &ret);    
+    goto out;
+error:
+    rozofs_ll_lookup_end(param,NULL,errno);
+out:
+    /*
+    ** release the transaction context
+    */
     if (rozofs_tx_ctx_p != NULL) rozofs_tx_free_from_ptr(rozofs_tx_ctx_p);    
     if (recv_buf != NULL) ruc_buf_freeBuffer(recv_buf);   
     
@@ -19,12 +19,14 @@
 #include <rozofs/rpc/eproto.h>
 
 #include "rozofs_fuse_api.h"
+#include "rozofs_readdirplus.h"
 
 DECLARE_PROFILING(mpp_profiler_t);
 
 static int old_rozofs_readdir_flag = 0;
 
 void rozofs_ll_readdir_cbk(void *this,void *param);
+int rozofs_ll_readdir2_from_export(ientry_t * ie,dir_t * dir_p, fuse_req_t req, fuse_ino_t ino, size_t size, off_t off, struct fuse_file_info *fi,int trc_idx);
 
 typedef enum {
   ROZOFS_READIR_FROM_SCRATCH,
@@ -689,6 +691,199 @@ out:
     return;
 }
 
+/*
+**__________________________________________________________________
+*/
+/**
+*  Save the attributes of the entries of an EP_READDIRPLUS response
+*
+ @param ino   : inode of the directory
+ @param db    : dirents of the response
+ @param attrs : attributes of the entries in the order of the dirents, "." and ".." excepted
+ @param nb    : number of attributes
+ */
+static void rozofs_readdirplus_store(fuse_ino_t ino,dirbuf_t *db,ep_mattr_t *attrs,int nb)
+{
+     char *buf = db->p;
+     int nbytes = db->size;
+     int idx = 0;
+     fid_t null_fid = {0};
+
+     while ((nbytes >= FUSE_NAME_OFFSET) && (idx < nb)) {
+	     struct rozofs_fuse_dirent *dirent = (struct rozofs_fuse_dirent *) buf;
+	     size_t reclen = FUSE_DIRENT_SIZE(dirent);
+
+	     buf += reclen;
+	     nbytes -= reclen;
+	     if ((dirent->namelen == 1) && (dirent->name[0] == '.')) continue;
+	     if ((dirent->namelen == 2) && (dirent->name[0] == '.') && (dirent->name[1] == '.')) continue;
+	     /*
+	     ** the fid is null when the exportd could not read the attributes
+	     */
+	     if (memcmp(attrs[idx].fid,null_fid,sizeof(fid_t)) != 0) {
+	       rozofs_rdplus_store(ino,dirent->name,dirent->namelen,(mattr_t *)&attrs[idx]);
+	     }
+	     idx++;
+     }
+}
+/**
+*  Call back function of an EP_READDIRPLUS
+*
+ @param this : pointer to the transaction context
+ @param param: pointer to the associated rozofs_fuse_context
+ 
+ @return none
+ */
+void rozofs_ll_readdirplus_cbk(void *this,void *param)
+{
+   fuse_req_t req; 
+   epgw_readdirplus_ret_t ret ;
+   
+   int status;
+   uint8_t  *payload;
+   void     *recv_buf = NULL;   
+   XDR       xdrs;    
+   int      bufsize;
+   struct rpc_msg  rpc_reply;
+   xdrproc_t decode_proc = (xdrproc_t) xdr_epgw_readdirplus_ret_t;
+   rpc_reply.acpted_rply.ar_results.proc = NULL;
+   fuse_ino_t   ino;
+   size_t       size;
+   off_t        off;
+   ientry_t    *ie = 0;
+    dirbuf_t   *db=NULL;
+    int trc_idx;
+    struct fuse_file_info *fi ;
+    dir_t *dir_p = NULL;
+    
+    errno = 0;
+                
+    RESTORE_FUSE_PARAM(param,req);
+    RESTORE_FUSE_PARAM(param,ino);
+    RESTORE_FUSE_PARAM(param,size);
+    RESTORE_FUSE_PARAM(param,off);    
+    RESTORE_FUSE_PARAM(param,trc_idx);    
+    RESTORE_FUSE_PARAM(param,fi);
+
+    dir_p = (dir_t*)fi->fh;
+    dir_p->readdir_pending = 0;
+    db = &dir_p->db;
+    if (db->p == NULL)
+    {
+      db->p = xmalloc(1024*64);
+    }
+    db->size = 0;    
+    rozofs_tx_ctx_t      *rozofs_tx_ctx_p = (rozofs_tx_ctx_t*)this;     
+    /*    
+    ** get the status of the transaction -> 0 OK, -1 error (need to get errno for source cause
+    */
+    status = rozofs_tx_get_status(this);
+    if (status < 0)
+    {
+       errno = rozofs_tx_get_errno(this); 
+       goto error; 
+    }
+    recv_buf = rozofs_tx_get_recvBuf(this);
+    if (recv_buf == NULL)
+    {
+       errno = EFAULT;  
+       goto error;         
+    }
+
+    // Get ientry
+    if (!(ie = get_ientry_by_inode(ino))) {
+        errno = ENOENT;
+        goto error;
+    }
+    
+    payload  = (uint8_t*) ruc_buf_getPayload(recv_buf);
+    payload += sizeof(uint32_t); /* skip length*/
+    bufsize = (int) ruc_buf_getPayloadLen(recv_buf);
+    bufsize-= sizeof(uint32_t); /* skip length*/
+    xdrmem_create(&xdrs,(char*)payload,bufsize,XDR_DECODE);
+    if (rozofs_xdr_replymsg(&xdrs,&rpc_reply) != TRUE)
+    {
+     TX_STATS(ROZOFS_TX_DECODING_ERROR);
+     errno = EPROTO;
+     goto error;
+    }
+    /*
+    ** the dirents are decoded in the dir buffer, the attributes are allocated
+    */
+    memset(&ret,0, sizeof(ret));    
+    ret.status_gw.ep_readdirplus_ret_t_u.reply.value.value_val = db->p;
+    
+    if (decode_proc(&xdrs,&ret) == FALSE)
+    {
+       TX_STATS(ROZOFS_TX_DECODING_ERROR);
+       errno = EPROTO;
+       ret.status_gw.ep_readdirplus_ret_t_u.reply.value.value_val = NULL;
+       xdr_free(decode_proc, (char *) &ret);
+       goto error;
+    }   
+    if (ret.status_gw.status == EP_FAILURE) {
+        errno = ret.status_gw.ep_readdirplus_ret_t_u.error;
+        ret.status_gw.ep_readdirplus_ret_t_u.reply.value.value_val = NULL;
+        xdr_free(decode_proc, (char *) &ret);    
+        goto error;
+    }
+            
+    db->eof    = ret.status_gw.ep_readdirplus_ret_t_u.reply.eof;
+    db->cookie = ret.status_gw.ep_readdirplus_ret_t_u.reply.cookie;
+    ret.status_gw.ep_readdirplus_ret_t_u.reply.value.value_val = NULL;
+    db->size = ret.status_gw.ep_readdirplus_ret_t_u.reply.value.value_len;
+    rozofs_readdirplus_store(ie->inode,db,
+                             ret.status_gw.ep_readdirplus_ret_t_u.reply.attrs.attrs_val,
+                             ret.status_gw.ep_readdirplus_ret_t_u.reply.attrs.attrs_len);
+    xdr_free(decode_proc, (char *) &ret);
+    db->last_cookie_buf = off;
+    db->cookie_offset_buf = 0;
+    status = rozofs_parse_dirfile( req,db,(uint64_t) off,(int) size);
+    if (status < 0) goto error;
+
+    goto out;
+    
+error:
+    if ((errno == ENOSYS) && (ie != NULL))
+    {
+       /*
+       ** the exportd does not know EP_READDIRPLUS: revert to EP_READDIR2
+       */
+       struct fuse_file_info file_info;
+       /*
+       ** need to copy the file_info before releasing the fuse context
+       */
+       memcpy(&file_info,fi,sizeof(struct fuse_file_info));
+       if (rozofs_rdplus_unsupported == 0) {
+         warning("exportd does not support EP_READDIRPLUS, directories are read without attributes");
+       }
+       rozofs_rdplus_unsupported = 1;
+       rozofs_trc_rsp(srv_rozofs_ll_readdir,ino,NULL,status,trc_idx);
+       STOP_PROFILING_NB(param,rozofs_ll_readdir);  
+       rozofs_fuse_release_saved_context(param);     
+       if (rozofs_tx_ctx_p != NULL) rozofs_tx_free_from_ptr(rozofs_tx_ctx_p);    
+       if (recv_buf != NULL) ruc_buf_freeBuffer(recv_buf);  
+
+       status = rozofs_ll_readdir2_from_export(ie, dir_p,req, ino, size, off,&file_info,trc_idx);
+       if (status == 0) return;
+       fuse_reply_err(req, errno);
+       rozofs_trc_rsp(srv_rozofs_ll_readdir,ino,NULL,1,trc_idx);
+       return;
+    }
+    fuse_reply_err(req, errno);
+out:
+    /*
+    ** release the transaction context and the fuse context
+    */
+    rozofs_trc_rsp(srv_rozofs_ll_readdir,ino,NULL,status,trc_idx);
+    STOP_PROFILING_NB(param,rozofs_ll_readdir);
+    rozofs_fuse_release_saved_context(param);     
+    if (rozofs_tx_ctx_p != NULL) rozofs_tx_free_from_ptr(rozofs_tx_ctx_p);    
+    if (recv_buf != NULL) ruc_buf_freeBuffer(recv_buf);   
+   
+    return;
+}
+
 /*
 **__________________________________________________________________
 */
@@ -718,8 +913,14 @@ int rozofs_ll_readdir2_send_to_export(fid_t fid, uint64_t cookie,void	 *buffer_p
     arg.arg_gw.cookie = cookie;
     
     /*
-    ** now initiates the transaction towards the remote end
+    ** now initiates the transaction towards the remote end. The attributes
+    ** of the entries are asked for when readdirplus is enabled
     */
+    if (rozofs_rdplus_enabled()) {
+      return rozofs_expgateway_send_routing_common(arg.arg_gw.eid,(unsigned char*)arg.arg_gw.fid,EXPORT_PROGRAM, EXPORT_VERSION,
+                              EP_READDIRPLUS,(xdrproc_t) xdr_epgw_readdir_arg_t,(void *)&arg,
+                              rozofs_ll_readdirplus_cbk,buffer_p); 
+    }
     ret = rozofs_expgateway_send_routing_common(arg.arg_gw.eid,(unsigned char*)arg.arg_gw.fid,EXPORT_PROGRAM, EXPORT_VERSION,
                               EP_READDIR2,(xdrproc_t) xdr_epgw_readdir_arg_t,(void *)&arg,
                               rozofs_ll_readdir2_cbk,buffer_p); 
@@ -0,0 +1,289 @@
+/*
+  Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+  This file is part of Rozofs.
+
+  Rozofs is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation, version 2.
+
+  Rozofs is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see
+  <http://www.gnu.org/licenses/>.
+ */
+
+#include <rozofs/common/xmalloc.h>
+#include <rozofs/core/uma_dbg_api.h>
+
+#include "rozofs_fuse_api.h"
+#include "rozofs_readdirplus.h"
+
+/*
+** Entry of the prefetch table
+*/
+typedef struct _rozofs_rdplus_entry_t {
+  fuse_ino_t  parent;     /**< inode of the directory, 0 when free */
+  uint64_t    timestamp;  /**< time of the readdirplus in us */
+  char      * name;       /**< name of the entry */
+  mattr_t     attrs;      /**< attributes of the entry */
+} rozofs_rdplus_entry_t;
+
+static rozofs_rdplus_entry_t * rozofs_rdplus_tb = NULL;
+static uint32_t                rozofs_rdplus_size = 0;
+int                            rozofs_rdplus_unsupported = 0;
+
+static uint64_t rozofs_rdplus_stats_stored = 0;    /**< entries saved from the responses */
+static uint64_t rozofs_rdplus_stats_refresh = 0;   /**< known ientries refreshed */
+static uint64_t rozofs_rdplus_stats_hit = 0;       /**< lookups answered locally */
+static uint64_t rozofs_rdplus_stats_old = 0;       /**< entries found but too old */
+static uint64_t rozofs_rdplus_stats_replaced = 0;  /**< valid entries overwritten */
+
+/*
+**__________________________________________________________________
+*/
+/**
+*  Inode of a directory as registered in the ientry table
+*/
+static inline fuse_ino_t rozofs_rdplus_dir_inode(fuse_ino_t ino) {
+  rozofs_inode_t fake_id;
+
+  fake_id.fid[1] = ino;
+  if (ROZOFS_DIR_FID == fake_id.s.key) fake_id.s.key = ROZOFS_DIR;
+  return fake_id.fid[1];
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Slot of a parent and a name in the prefetch table
+*/
+static inline rozofs_rdplus_entry_t * rozofs_rdplus_slot(fuse_ino_t parent,const char *name,int len) {
+  uint32_t  hash = 0;
+  uint8_t * c;
+  int       i;
+
+  c = (uint8_t *) &parent;
+  for (i = 0; i < sizeof(fuse_ino_t); c++,i++)
+    hash = *c + (hash << 6) + (hash << 16) - hash;
+  c = (uint8_t *) name;
+  for (i = 0; i < len; c++,i++)
+    hash = *c + (hash << 6) + (hash << 16) - hash;
+  return &rozofs_rdplus_tb[hash % rozofs_rdplus_size];
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Delay during which a prefetched entry answers a lookup
+*/
+static inline uint64_t rozofs_rdplus_delay_us(mattr_t *attrs) {
+  int      dir = S_ISDIR(attrs->mode);
+  uint64_t attr_us  = rozofs_tmr_get_attr_us(dir);
+  uint64_t entry_us = (uint64_t) (rozofs_tmr_get_entry(dir)*1000000);
+
+  return (attr_us < entry_us) ? attr_us : entry_us;
+}
+/*
+**__________________________________________________________________
+*/
+static inline void rozofs_rdplus_free(rozofs_rdplus_entry_t * p) {
+  if (p->name != NULL) xfree(p->name);
+  p->name   = NULL;
+  p->parent = 0;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Whether the readdir requests are sent as EP_READDIRPLUS
+*/
+int rozofs_rdplus_enabled(void) {
+  return ((rozofs_rdplus_tb != NULL) && (rozofs_rdplus_unsupported == 0));
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Save the attributes of a listed entry
+*
+ @param parent : inode of the directory
+ @param name   : name of the entry (not null terminated)
+ @param len    : length of the name
+ @param attrs  : attributes of the entry
+ */
+void rozofs_rdplus_store(fuse_ino_t parent,char *name,int len,mattr_t *attrs) {
+  rozofs_rdplus_entry_t * p;
+  rozofs_inode_t        * inode_p = (rozofs_inode_t *) attrs->fid;
+  ientry_t              * ie;
+  uint64_t                now;
+
+  if (rozofs_rdplus_tb == NULL) return;
+  /*
+  ** the objects being deleted are always asked to the exportd
+  */
+  if (inode_p->s.del) return;
+
+  now = rozofs_get_ticker_us();
+  /*
+  ** refresh the attributes of a known i-node
+  */
+  ie = get_ientry_by_fid(attrs->fid);
+  if (ie != NULL) {
+    rozofs_ientry_update(ie,attrs);
+    rozofs_rdplus_stats_refresh++;
+  }
+
+  parent = rozofs_rdplus_dir_inode(parent);
+  p = rozofs_rdplus_slot(parent,name,len);
+  if (p->parent != 0) {
+    if ((p->timestamp + rozofs_rdplus_delay_us(&p->attrs)) > now) rozofs_rdplus_stats_replaced++;
+    rozofs_rdplus_free(p);
+  }
+  p->name = xmalloc(len+1);
+  memcpy(p->name,name,len);
+  p->name[len] = 0;
+  p->parent    = parent;
+  p->timestamp = now;
+  memcpy(&p->attrs,attrs,sizeof(mattr_t));
+  rozofs_rdplus_stats_stored++;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Look for a lookup answer in the prefetched entries
+*
+ @param parent : inode of the directory
+ @param name   : name to look for
+ @param stbuf  : filled with the attributes of the entry on success
+
+ @retval the ientry of the entry, NULL when not found or too old
+ */
+ientry_t * rozofs_rdplus_lookup(fuse_ino_t parent,const char *name,struct stat *stbuf) {
+  rozofs_rdplus_entry_t * p;
+  ientry_t              * ie;
+  ientry_t              * pie;
+
+  if (rozofs_rdplus_tb == NULL) return NULL;
+
+  parent = rozofs_rdplus_dir_inode(parent);
+  p = rozofs_rdplus_slot(parent,name,strlen(name));
+  if ((p->parent != parent) || (strcmp(p->name,name) != 0)) return NULL;
+
+  if ((p->timestamp + rozofs_rdplus_delay_us(&p->attrs)) <= rozofs_get_ticker_us()) {
+    rozofs_rdplus_stats_old++;
+    rozofs_rdplus_free(p);
+    return NULL;
+  }
+
+  if (!(ie = get_ientry_by_fid(p->attrs.fid))) {
+    ie = alloc_ientry(p->attrs.fid);
+    rozofs_ientry_update(ie,&p->attrs);
+    ie->timestamp = p->timestamp;
+  }
+  else if (ie->timestamp < p->timestamp) {
+    rozofs_ientry_update(ie,&p->attrs);
+    ie->timestamp = p->timestamp;
+  }
+  pie = get_ientry_by_inode(parent);
+  if (pie != NULL) ientry_update_parent(ie,pie->fid);
+
+  mattr_to_stat(&ie->attrs,stbuf,exportclt.bsize);
+  /*
+  ** the kernel keeps the entry from now on
+  */
+  rozofs_rdplus_free(p);
+  rozofs_rdplus_stats_hit++;
+  return ie;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Forget a prefetched entry that is removed or renamed
+*
+ @param parent : inode of the directory
+ @param name   : name of the entry
+ */
+void rozofs_rdplus_invalidate(fuse_ino_t parent,const char *name) {
+  rozofs_rdplus_entry_t * p;
+
+  if (rozofs_rdplus_tb == NULL) return;
+
+  parent = rozofs_rdplus_dir_inode(parent);
+  p = rozofs_rdplus_slot(parent,name,strlen(name));
+  if ((p->parent != parent) || (strcmp(p->name,name) != 0)) return;
+  rozofs_rdplus_free(p);
+}
+/*
+**__________________________________________________________________
+*/
+static char * show_readdirplus_help(char * pChar) {
+  pChar += sprintf(pChar,"usage:\n");
+  pChar += sprintf(pChar,"readdirplus       : display the readdirplus prefetch statistics\n");
+  pChar += sprintf(pChar,"readdirplus reset : display then reset the readdirplus prefetch statistics\n");
+  return pChar;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  rozodiag display of the readdirplus attribute prefetch
+*/
+static void show_readdirplus(char * argv[], uint32_t tcpRef, void *bufRef) {
+  char * pChar = uma_dbg_get_buffer();
+  int    reset = 0;
+
+  if (argv[1] != NULL) {
+    if (strcmp(argv[1],"reset") != 0) {
+      show_readdirplus_help(pChar);
+      uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
+      return;
+    }
+    reset = 1;
+  }
+
+  pChar += sprintf(pChar,"table size      : %u%s\n", rozofs_rdplus_size,
+                   rozofs_rdplus_unsupported ? " (not supported by the exportd)" : "");
+  pChar += sprintf(pChar,"stored entries  : %llu\n", (unsigned long long) rozofs_rdplus_stats_stored);
+  pChar += sprintf(pChar,"replaced        : %llu\n", (unsigned long long) rozofs_rdplus_stats_replaced);
+  pChar += sprintf(pChar,"refreshed ie    : %llu\n", (unsigned long long) rozofs_rdplus_stats_refresh);
+  pChar += sprintf(pChar,"lookup hits     : %llu\n", (unsigned long long) rozofs_rdplus_stats_hit);
+  pChar += sprintf(pChar,"too old         : %llu\n", (unsigned long long) rozofs_rdplus_stats_old);
+
+  if (reset) {
+    rozofs_rdplus_stats_stored   = 0;
+    rozofs_rdplus_stats_replaced = 0;
+    rozofs_rdplus_stats_refresh  = 0;
+    rozofs_rdplus_stats_hit      = 0;
+    rozofs_rdplus_stats_old      = 0;
+    pChar += sprintf(pChar,"Reset Done\n");
+  }
+  uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Allocate the prefetch table (common_config.client_readdirplus_cache
+*  entries) and register the rozodiag readdirplus topic
+*/
+void rozofs_rdplus_init(void) {
+
+  uma_dbg_addTopic_option("readdirplus", show_readdirplus, UMA_DBG_OPTION_RESET);
+
+  rozofs_rdplus_size = common_config.client_readdirplus_cache;
+  if (rozofs_rdplus_size == 0) return;
+
+  rozofs_rdplus_tb = malloc(rozofs_rdplus_size*sizeof(rozofs_rdplus_entry_t));
+  if (rozofs_rdplus_tb == NULL) {
+    severe("readdirplus prefetch table of %u entries can not be allocated",rozofs_rdplus_size);
+    rozofs_rdplus_size = 0;
+    return;
+  }
+  memset(rozofs_rdplus_tb,0,rozofs_rdplus_size*sizeof(rozofs_rdplus_entry_t));
+}
@@ -0,0 +1,90 @@
+/*
+  Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+  This file is part of Rozofs.
+
+  Rozofs is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation, version 2.
+
+  Rozofs is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see
+  <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROZOFS_READDIRPLUS_H
+#define ROZOFS_READDIRPLUS_H
+
+#include <rozofs/rozofs.h>
+
+#include "rozofsmount.h"
+
+/*
+** Attribute prefetch of the readdirplus.
+**
+** The EP_READDIRPLUS responses give the attributes of the listed entries.
+** They refresh the ientries already known, and the entries are kept in a
+** table indexed by parent and name, so that the lookup that follows the
+** readdir (ls -l, find) is answered without asking the exportd. An entry of
+** the table is used by one lookup only, and only within the attribute and
+** entry cache delays.
+*/
+
+extern int rozofs_rdplus_unsupported;   /**< the exportd does not know EP_READDIRPLUS */
+
+/*
+**__________________________________________________________________
+*/
+/**
+*  Whether the readdir requests are sent as EP_READDIRPLUS
+*/
+int rozofs_rdplus_enabled(void);
+/*
+**__________________________________________________________________
+*/
+/**
+*  Save the attributes of a listed entry
+*
+ @param parent : inode of the directory
+ @param name   : name of the entry (not null terminated)
+ @param len    : length of the name
+ @param attrs  : attributes of the entry
+ */
+void rozofs_rdplus_store(fuse_ino_t parent,char *name,int len,mattr_t *attrs);
+/*
+**__________________________________________________________________
+*/
+/**
+*  Look for a lookup answer in the prefetched entries
+*
+ @param parent : inode of the directory
+ @param name   : name to look for
+ @param stbuf  : filled with the attributes of the entry on success
+
+ @retval the ientry of the entry, NULL when not found or too old
+ */
+ientry_t * rozofs_rdplus_lookup(fuse_ino_t parent,const char *name,struct stat *stbuf);
+/*
+**__________________________________________________________________
+*/
+/**
+*  Forget a prefetched entry that is removed or renamed
+*
+ @param parent : inode of the directory
+ @param name   : name of the entry
+ */
+void rozofs_rdplus_invalidate(fuse_ino_t parent,const char *name);
+/*
+**__________________________________________________________________
+*/
+/**
+*  Allocate the prefetch table (common_config.client_readdirplus_cache
+*  entries) and register the rozodiag readdirplus topic
+*/
+void rozofs_rdplus_init(void);
+
+#endif
@@ -19,6 +19,7 @@
 #include <rozofs/rpc/eproto.h>
 
 #include "rozofs_fuse_api.h"
+#include "rozofs_readdirplus.h"
 
 DECLARE_PROFILING(mpp_profiler_t);
 
@@ -69,6 +70,8 @@ void rozofs_ll_rename_nb(fuse_req_t req, fuse_ino_t parent, const char *name,
 
     DEBUG("rename (%lu,%s,%lu,%s)\n", (unsigned long int) parent, name,
             (unsigned long int) newparent, newname);
+    rozofs_rdplus_invalidate(parent,name);
+    rozofs_rdplus_invalidate(newparent,newname);
 
     if (strlen(name) > ROZOFS_FILENAME_MAX ||
             strlen(newname) > ROZOFS_FILENAME_MAX) {
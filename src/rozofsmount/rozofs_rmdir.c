@@ -19,6 +19,7 @@
 #include <rozofs/rpc/eproto.h>
 
 #include "rozofs_fuse_api.h"
+#include "rozofs_readdirplus.h"
 
 DECLARE_PROFILING(mpp_profiler_t);
 
@@ -47,6 +48,7 @@ void rozofs_ll_rmdir_nb(fuse_req_t req, fuse_ino_t parent, const char *name) {
     
     int trc_idx = rozofs_trc_req_name(srv_rozofs_ll_rmdir,parent,(char*)name);
     DEBUG("rmdir (%lu,%s)\n", (unsigned long int) parent, name);
+    rozofs_rdplus_invalidate(parent,name);
  
     /*
     ** allocate a context for saving the fuse parameters
@@ -61,11 +61,16 @@ uint64_t    rozofs_aligned_write_end[2];
 }
 
 int ROZOFS_MAX_WRITE_PENDING = 1;
+uint64_t rozofs_write_behind_budget = 0; /**< max dirty bytes per open file before the writer is blocked (0: no write behind) */
 typedef struct _WRITE_FLUSH_STAT_T {
   uint64_t non_synchroneous;
   uint64_t synchroneous;
   uint64_t synchroneous_success;
   uint64_t synchroneous_error;
+  uint64_t write_behind_queued;
+  uint64_t write_behind_sent;
+  uint64_t write_behind_dropped;
+  uint64_t write_behind_over_budget;
 } WRITE_FLUSH_STAT_T;
 
 static WRITE_FLUSH_STAT_T write_flush_stat;
@@ -124,10 +129,15 @@ static void display_write_flush_stat(char * argv[], uint32_t tcpRef, void *bufRe
     return;
   }
   pChar += sprintf(pChar,"Write pending maximum value is %d\n",ROZOFS_MAX_WRITE_PENDING);
+  pChar += sprintf(pChar,"Write behind budget is %llu KiB\n",(long long unsigned int)(rozofs_write_behind_budget/1024));
   SHOW_STAT_WRITE_FLUSH(non_synchroneous);
   SHOW_STAT_WRITE_FLUSH(synchroneous);
   SHOW_STAT_WRITE_FLUSH(synchroneous_success);
   SHOW_STAT_WRITE_FLUSH(synchroneous_error);    
+  SHOW_STAT_WRITE_FLUSH(write_behind_queued);
+  SHOW_STAT_WRITE_FLUSH(write_behind_sent);
+  SHOW_STAT_WRITE_FLUSH(write_behind_dropped);
+  SHOW_STAT_WRITE_FLUSH(write_behind_over_budget);
   uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());  
 }  
 
@@ -177,8 +187,9 @@ static void bugwatch_proc(char * argv[], uint32_t tcpRef, void *bufRef){
 /**
    Initialize write synch stat service
 */
-void init_write_flush_stat(int max_write_pending){
+void init_write_flush_stat(int max_write_pending, int write_behind_kb){
   ROZOFS_MAX_WRITE_PENDING = max_write_pending;
+  rozofs_write_behind_budget = (uint64_t)write_behind_kb * 1024;
   reset_write_flush_stat();
   uma_dbg_addTopic_option("write_flush", display_write_flush_stat,UMA_DBG_OPTION_RESET);  
   uma_dbg_addTopic("bugwatch", bugwatch_proc);  
@@ -233,6 +244,141 @@ static inline int write_section_empty(file_t *p)
    return (p->write_from == p->write_pos)?1:0;
 }
 
+/*
+**__________________________________________________________________
+*/
+/**
+*  Send the oldest write behind extent of a file to the storcli.
+   The extent is released even when the write can not be sent: the
+   error is then reported on the next operations on the file.
+
+  @param p : pointer to the file structure
+  
+  @retval 0 on success
+  @retval < 0 --> error while attempting to initiate a write request towards storcli 
+*/
+static int rozofs_wb_send_first(file_t *p)
+{
+  struct fuse_file_info  file_info;
+  struct fuse_file_info  *fi = &file_info;
+  rozofs_wb_extent_t *ext = &p->wb[p->wb_first];
+  ientry_t *ie = p->ie;
+  fuse_req_t req = NULL;
+  int deferred_fuse_write_response = 0;
+  size_t size = ext->len;
+  off_t off = ext->off;
+  void *buffer_p;
+  int trc_idx;
+  int ret = -1;
+
+  p->wb_first = (p->wb_first + 1) % ROZOFS_MAX_WB_EXTENTS;
+  p->wb_count--;
+  p->wb_queued -= ext->len;
+  if ((p->wb_count == 0) && (p->buf_write_wait == 0) && (ie->write_pending == p)) {
+    ie->write_pending = NULL;
+  }
+
+  buffer_p = _rozofs_fuse_alloc_saved_context("rozofs_wb_send_first");
+  if (buffer_p == NULL) {
+    severe("out of fuse saved context");
+    errno = ENOMEM;
+    goto error;
+  }
+  memset(fi,0,sizeof(struct fuse_file_info));
+  fi->fh = (unsigned long) p;
+  trc_idx = rozofs_trc_req_io(srv_rozofs_ll_write,(fuse_ino_t)p,p->fid,size,off);
+  SAVE_FUSE_PARAM(buffer_p,req);
+  SAVE_FUSE_PARAM(buffer_p,size);
+  SAVE_FUSE_PARAM(buffer_p,off);
+  SAVE_FUSE_PARAM(buffer_p,trc_idx);
+  SAVE_FUSE_PARAM(buffer_p,deferred_fuse_write_response);
+  SAVE_FUSE_STRUCT(buffer_p,fi,sizeof( struct fuse_file_info)); 
+  SAVE_FUSE_CALLBACK(buffer_p,rozofs_ll_write_cbk);
+
+  ret = write_buf_nb(buffer_p,p,ext->off,ext->buffer+ext->data_off,ext->len);
+  if (ret < 0) {
+    rozofs_trc_rsp(srv_rozofs_ll_write,(fuse_ino_t)p,p->fid,1,trc_idx);
+    rozofs_fuse_release_saved_context(buffer_p);
+    goto error;
+  }
+  write_flush_stat.write_behind_sent++;
+  return 0;
+
+error:
+  write_flush_stat.write_behind_dropped++;
+  p->wr_error = errno;
+  return ret;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Send every queued write behind extent of a file to the storcli.
+   Must be called before any write of the file buffer, and before
+   waiting for the end of the pending writes.
+
+  @param p : pointer to the file structure
+  
+  @retval 0 on success
+  @retval < 0 --> error while attempting to initiate a write request towards storcli 
+*/
+int rozofs_wb_drain(file_t *p)
+{
+  int ret = 0;
+
+  while (p->wb_count != 0) {
+    if (rozofs_wb_send_first(p) < 0) ret = -1;
+  }
+  return ret;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Send the queued write behind extents of a file while the maximum
+   number of pending writes is not reached. Called on write completion.
+
+  @param p : pointer to the file structure
+  
+  @retval none
+*/
+static void rozofs_wb_flush_next(file_t *p)
+{
+  ientry_t *ie = p->ie;
+
+  /*
+  ** A write has failed: the queued data will never be written
+  */
+  if (p->wr_error != 0) {
+    write_flush_stat.write_behind_dropped += p->wb_count;
+    p->wb_count  = 0;
+    p->wb_queued = 0;
+    if ((p->buf_write_wait == 0) && (ie->write_pending == p)) ie->write_pending = NULL;
+    return;
+  }
+  while ((p->wb_count != 0) && (p->buf_write_pending < ROZOFS_MAX_WRITE_PENDING)) {
+    rozofs_wb_send_first(p);
+  }
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Account for the end of a write request of a file
+
+  @param p : pointer to the file structure
+  @param param : fuse context of the write request
+  
+  @retval none
+*/
+void rozofs_wb_write_done(file_t *p, void *param)
+{
+  uint32_t buf_flush_len;
+
+  RESTORE_FUSE_PARAM(param,buf_flush_len);
+  if (p->wb_inflight > buf_flush_len) p->wb_inflight -= buf_flush_len;
+  else                                p->wb_inflight = 0;
+}
 /*
 **__________________________________________________________________
 */
@@ -249,6 +395,11 @@ int buf_flush(void *fuse_ctx_p,file_t *p)
 {
 //  if (p->buf_write_wait == 0) return 0;
   
+  /*
+  ** The data queued for write behind are older
+  */
+  if (p->wb_count != 0) rozofs_wb_drain(p);
+
   uint64_t flush_off = p->write_from;
   uint32_t flush_len = (uint32_t)(p->write_pos - p->write_from);
   uint32_t flush_off_buf = (uint32_t)(p->write_from - p->read_from);
@@ -276,6 +427,74 @@ int buf_flush(void *fuse_ctx_p,file_t *p)
   return 0;
 
 
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  flush the content of the buffer on a write, or queue it for a write
+   behind when the maximum number of writes is already pending and the
+   dirty budget of the file is not exceeded. The file buffer is then
+   given to the queued extent.
+
+  @param fuse_ctx_p: pointer to the fuse transaction context
+  @param p : pointer to the file structure that contains buffer information
+  
+  @retval 0 a write request has been sent with the fuse context
+  @retval 1 the data has been queued: the fuse context has not been used
+  @retval < 0 --> error while attempting to initiate a write request towards storcli 
+*/
+static int buf_flush_behind(void *fuse_ctx_p,file_t *p)
+{
+  rozofs_wb_extent_t *ext;
+  ientry_t *ie = p->ie;
+  uint32_t  len = (uint32_t)(p->write_pos - p->write_from);
+  char     *buffer;
+
+  if ((rozofs_write_behind_budget == 0) || (p->buf_write_pending < ROZOFS_MAX_WRITE_PENDING)) {
+    return buf_flush(fuse_ctx_p,p);
+  }
+  if ((p->wb_count >= ROZOFS_MAX_WB_EXTENTS)
+  ||  ((p->wb_inflight + p->wb_queued + len) > rozofs_write_behind_budget)) {
+    write_flush_stat.write_behind_over_budget++;
+    return buf_flush(fuse_ctx_p,p);
+  }
+
+  ext = &p->wb[(p->wb_first + p->wb_count) % ROZOFS_MAX_WB_EXTENTS];
+  if (ext->buffer == NULL) {
+    ext->buffer = memalign(4096,p->export->bufsize);
+    if (ext->buffer == NULL) return buf_flush(fuse_ctx_p,p);
+    xmalloc_stats_insert(malloc_usable_size(ext->buffer));
+  }
+  /*
+  ** stats
+  */
+  rozofs_fuse_read_write_stats_buf.flush_buf_cpt++;
+  write_flush_stat.write_behind_queued++;
+
+  ext->off      = p->write_from;
+  ext->len      = len;
+  ext->data_off = (uint32_t)(p->write_from - p->read_from);
+  /*
+  ** Push the data in the cache
+  */
+  rozofs_mbcache_insert(p->fid,ext->off,len,(uint8_t*)(p->buffer+ext->data_off));  
+  /*
+  ** The extent takes the file buffer and gives its own
+  */
+  buffer      = ext->buffer;
+  ext->buffer = p->buffer;
+  p->buffer   = buffer;
+  p->read_from = p->read_pos = 0;
+
+  p->wb_count++;
+  p->wb_queued += len;
+  p->buf_write_wait = 0;
+  /*
+  ** A read or write from an other file descriptor must flush the extents
+  */
+  ie->write_pending = p;
+  return 1;
 }
 /*
 **__________________________________________________________________
@@ -291,6 +510,11 @@ void check_last_write_pending(file_t *file) {
   fuse_end_tx_recv_pf_t   callback;
   void                  * pending_fuse_ctx_p;
   
+  /*
+  ** Send the write behind extents that are waiting for a pending write to complete
+  */
+  if (file->wb_count != 0) rozofs_wb_flush_next(file);
+  
   /*
   ** Check if there some request (flush or release waiting fro the last write to take place
   */
@@ -762,7 +986,7 @@ void buf_file_write_nb(ientry_t * ie,
       {
         if (len < ROZOFS_MAX_FILE_BUF_SZ)
 	{
-	  ret = buf_flush(fuse_ctx_p,p);
+	  ret = buf_flush_behind(fuse_ctx_p,p);
 	}
 	else
 	{
@@ -776,9 +1000,9 @@ void buf_file_write_nb(ientry_t * ie,
           break;                  
         }
         /*
-        ** write is in progress
+        ** write is in progress, unless the data has been queued for write behind
         */
-        status_p->status = BUF_STATUS_WR_IN_PRG;
+        status_p->status = (ret == 1)?BUF_STATUS_DONE:BUF_STATUS_WR_IN_PRG;
         status_p->errcode = 0;            
       }
       else
@@ -874,7 +1098,7 @@ void buf_file_write_nb(ientry_t * ie,
             
       p->write_pos  = off2end; 
       p->buf_write_wait = 1;
-      ret = buf_flush(fuse_ctx_p,p);
+      ret = buf_flush_behind(fuse_ctx_p,p);
       if (ret < 0)
       {
         status_p->status = BUF_STATUS_FAILURE;
@@ -882,9 +1106,9 @@ void buf_file_write_nb(ientry_t * ie,
         break;                  
       }      
      /*
-      ** write in progress
+      ** write in progress, unless the data has been queued for write behind
       */
-      status_p->status = BUF_STATUS_WR_IN_PRG;
+      status_p->status = (ret == 1)?BUF_STATUS_DONE:BUF_STATUS_WR_IN_PRG;
       status_p->errcode = 0;
       /*
       ** copy the buffer
@@ -1062,6 +1286,7 @@ static int64_t write_buf_nb(void *buffer_p,file_t * f, uint64_t off, const char
     uint32_t buf_flush_len = len;
     SAVE_FUSE_PARAM(buffer_p,buf_flush_offset);
     SAVE_FUSE_PARAM(buffer_p,buf_flush_len);
+    f->wb_inflight += len;
 
     return ret;    
 error:
@@ -1260,7 +1485,8 @@ void rozofs_ll_write_nb(fuse_req_t req, fuse_ino_t ino, const char *buf,
     ** A write toward the STORCLI is pending 
     ** so we must keep the the fuse context until the STORCLI response
     */
-    if (file->buf_write_pending <= ROZOFS_MAX_WRITE_PENDING) {
+    if (((rozofs_write_behind_budget == 0) && (file->buf_write_pending <= ROZOFS_MAX_WRITE_PENDING))
+    ||  ((rozofs_write_behind_budget != 0) && ((file->wb_inflight + file->wb_queued) <= rozofs_write_behind_budget))) {
       deferred_fuse_write_response = 0;
       SAVE_FUSE_PARAM(buffer_p,deferred_fuse_write_response);
       rozofs_trc_rsp(srv_rozofs_ll_write,(fuse_ino_t)file,file->fid,(errno==0)?0:1,trc_idx);
@@ -1270,7 +1496,7 @@ void rozofs_ll_write_nb(fuse_req_t req, fuse_ino_t ino, const char *buf,
       goto out;
     }        
     /*
-    ** Maximum number of write pending is reached. 
+    ** Maximum number of write pending, or write behind budget, is reached. 
     ** Let's differ the FUSE response until the STORCLI response
     */
     write_flush_stat.synchroneous++;
@@ -1331,6 +1557,7 @@ void rozofs_ll_write_cbk(void *this,void *param)
        
    file = (file_t *) (unsigned long)  fi->fh;   
    file->buf_write_pending--;
+   rozofs_wb_write_done(file,param);
    if (file->buf_write_pending < 0)
    {
      severe("buf_write_pending mismatch, %d",file->buf_write_pending);
@@ -1553,6 +1780,14 @@ void rozofs_ll_flush_nb(fuse_req_t req, fuse_ino_t ino,
       goto error;    
     }
 
+    /*
+    ** write behind extents are queued: send them with the buffer and
+    ** wait for the end of all the running write transactions
+    */
+    if (f->wb_count != 0)
+    {
+      if (rozofs_asynchronous_flush(fi) == 0) goto error;
+    }
 
     /*
     ** check if there some pendinag data to write in the buffer
@@ -1650,6 +1885,16 @@ int rozofs_asynchronous_flush(struct fuse_file_info *fi) {
     return 0;
   }
 
+  /*
+  ** send the write behind extents
+  */
+  if (f->wb_count != 0) {
+    if (rozofs_wb_drain(f) < 0) {
+      errno = f->wr_error;
+      return 0;
+    }
+  }
+
   /*
   ** check that there is actually some pending data to write in the buffer
   */
@@ -1720,6 +1965,7 @@ void rozofs_asynchronous_flush_cbk(void *this,void *param)
 
    file = (file_t *) (unsigned long)  fi->fh;   
    file->buf_write_pending--;
+   rozofs_wb_write_done(file,param);
    if (file->buf_write_pending < 0)
    {
      severe("buf_write_pending mismatch, %d",file->buf_write_pending);
@@ -1868,6 +2114,7 @@ void rozofs_ll_flush_cbk(void *this,void *param)
 
    file = (file_t *) (unsigned long)  fi->fh;   
    file->buf_write_pending--;
+   rozofs_wb_write_done(file,param);
    if (file->buf_write_pending < 0)
    {
      severe("buf_write_pending mismatch, %d",file->buf_write_pending);
@@ -2116,6 +2363,15 @@ void rozofs_ll_release_nb(fuse_req_t req, fuse_ino_t ino,
      if (rozofs_bugwatch) severe("BUGROZOFSWATCH release(%p) , buf_write_wait=%d, buf_write_pending=%d,",
                                    f,f->buf_write_wait,f->buf_write_pending);
 
+    /*
+    ** write behind extents are queued: send them with the buffer and
+    ** wait for the end of all the running write transactions
+    */
+    if (f->wb_count != 0)
+    {
+      if (rozofs_asynchronous_flush(fi) == 0) goto error;
+    }
+
     /*
     ** check if there some pendinag data to write in the buffer
     */
@@ -2218,6 +2474,7 @@ void rozofs_ll_release_cbk(void *this,void *param)
 
    file = (file_t *) (unsigned long)  fi->fh;   
    file->buf_write_pending--;
+   rozofs_wb_write_done(file,param);
    if (file->buf_write_pending < 0)
    {
      severe("buf_write_pending mismatch, %d",file->buf_write_pending);
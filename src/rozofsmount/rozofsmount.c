@@ -208,6 +208,7 @@ static void usage() {
     fprintf(stderr, "    -o rozofsnbstorcli=N\tdefine the number of storcli process(es) to use (default: 1)\n");
     fprintf(stderr, "    -o rozofsshaper=N\t\tdefine the storcli shaper configuration (default: 1)\n");
     fprintf(stderr, "    -o rozofsrotate=N\t\tdefine the modulo on read distribution rotation (default: 0)\n");
+    fprintf(stderr, "    -o rozofswritebehind=N\tdefine the max KiB of written data not yet acknowledged per open file (default: 0: no write behind)\n");
     fprintf(stderr, "    -o posixlock\t\tDeprecated.\n");
     fprintf(stderr, "    -o bsdlock\t\t\tDeprecated.\n");
     fprintf(stderr, "    -o nolock\t\t\tTo dectivate BSD as well as POSIX locks.\n");
@@ -268,6 +269,7 @@ static struct fuse_opt rozofs_opts[] = {
     MYFS_OPT("rozofsmode=%u", fs_mode, 0),
     MYFS_OPT("rozofsshaper=%u", shaper, 0),
     MYFS_OPT("rozofsrotate=%u", rotate, 0),
+    MYFS_OPT("rozofswritebehind=%u", write_behind, 0),
     MYFS_OPT("posixlock", posix_file_lock, 1),
     MYFS_OPT("bsdlock", bsd_file_lock, 1),
     MYFS_OPT("nolock", no_file_lock, 1),
@@ -422,6 +424,7 @@ void show_start_config(char * argv[], uint32_t tcpRef, void *bufRef) {
   DISPLAY_UINT32_CONFIG(symlink_timeout);
   DISPLAY_UINT32_CONFIG(shaper);  
   DISPLAY_UINT32_CONFIG(rotate);  
+  DISPLAY_UINT32_CONFIG(write_behind);  
   DISPLAY_UINT32_CONFIG(no_file_lock);  
   DISPLAY_UINT32_CONFIG(noXattr); 
   DISPLAY_UINT32_CONFIG(no0trunc);
@@ -1685,7 +1688,7 @@ int fuseloop(struct fuse_args *args, int fg) {
 
     /* Initialize list and htables for inode_entries */
     list_init(&inode_entries);
-    htable_initialize(&htable_inode, INODE_HSIZE, fuse_ino_hash, fuse_ino_cmp);
+    htable_initialize_oa(&htable_inode, INODE_HSIZE, 0, fuse_ino_hash, fuse_ino_cmp);
 //    htable_initialize(&htable_fid, PATH_HSIZE, fid_hash, fid_cmp);
 
     /* Put the root inode entry*/
@@ -1867,7 +1870,7 @@ int fuseloop(struct fuse_args *args, int fg) {
     ** Initialize the number of write pending per fd
     ** and reset statistics
     */
-    init_write_flush_stat(conf.max_write_pending);
+    init_write_flush_stat(conf.max_write_pending,conf.write_behind);
 
     /**
     * init of the mode block cache
@@ -2134,6 +2137,7 @@ int main(int argc, char *argv[]) {
     conf.nbstorcli = 0;
     conf.shaper = 0; // Default traffic shaper value
     conf.rotate = 0;
+    conf.write_behind = 0;
     conf.posix_file_lock = 0; // No posix file lock until explicitly activated  man 2 fcntl)
     conf.bsd_file_lock = 0;   // No BSD file lock until explicitly activated    man 2 flock)
     conf.no_file_lock = 0;   // To disable locks 
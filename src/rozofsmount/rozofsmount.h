@@ -90,6 +90,7 @@ typedef struct rozofsmnt_conf {
     unsigned bsd_file_lock;  
     unsigned no_file_lock;  
     unsigned max_write_pending ; /**< Maximum number pending write */
+    unsigned write_behind; /**< max KiB of data written but not yet acknowledged per open file (0: no write behind) */
     unsigned quota; /* ignored */    
     unsigned noXattr;
     int site;
@@ -645,7 +646,30 @@ void rozofs_ll_setlk_nb(fuse_req_t req, fuse_ino_t ino,
 void rozofs_ll_flock_nb(fuse_req_t req, fuse_ino_t ino,
 		struct fuse_file_info *fi, int op);
 
-void init_write_flush_stat(int max_write_pending);
+void init_write_flush_stat(int max_write_pending, int write_behind_kb);
+
+/*
+**__________________________________________________________________
+*/
+/**
+ *  Send every queued write behind extent of a file to the storcli
+
+ @param p : pointer to the file structure
+
+ @retval 0 on success
+ @retval < 0 --> error while attempting to initiate a write request towards storcli
+ */
+int rozofs_wb_drain(file_t *p);
+/*
+**__________________________________________________________________
+*/
+/**
+ *  Account for the end of a write request of a file
+
+ @param p : pointer to the file structure
+ @param param : fuse context of the write request
+ */
+void rozofs_wb_write_done(file_t *p, void *param);
 
 void rozofs_ll_opendir_nb(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info *fi);
 void rozofs_ll_releasedir_nb(fuse_req_t req, fuse_ino_t ino,struct fuse_file_info *fi);
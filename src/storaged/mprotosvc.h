@@ -63,5 +63,9 @@ void mp_subthread_remove2(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
 
 void mp_subthread_remove(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
 
-void mp_subthread_list_bins_files(void * pt, rozorpc_srv_ctx_t *req_ctx_p);			      
+void mp_subthread_list_bins_files(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
+
+void mp_subthread_list_dirty(void * pt, rozorpc_srv_ctx_t *req_ctx_p);
+
+void mp_subthread_remove_batch(void * pt, rozorpc_srv_ctx_t *req_ctx_p);			      
 #endif
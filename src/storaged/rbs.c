@@ -31,6 +31,7 @@
 
 #include <rozofs/common/list.h>
 #include <rozofs/common/htable.h>
+#include <rozofs/common/xmalloc.h>
 #include <rozofs/rozofs.h>
 #include <rozofs/rozofs_srv.h>
 #include <rozofs/rpc/rpcclt.h>
@@ -280,6 +281,40 @@ void rbs_release_cluster_list(list_t * cluster_entries) {
         xfree(clu);
     }
 }
+/** Copy one cluster of a list of cluster(s) without its connections, so 
+ *  that each rebuild thread gets its own connections to the storages
+ *
+ * @param cluster_entries: list of cluster(s) to copy from.
+ * @param copy_entries: initialized list that receives the copy.
+ * @param cid: unique id of the cluster to copy.
+ */
+void rbs_copy_cluster_list(list_t * cluster_entries, list_t * copy_entries, cid_t cid) {
+    list_t *p, *q;
+
+    list_for_each_forward(p, cluster_entries) {
+
+        rb_cluster_t *clu = list_entry(p, rb_cluster_t, list);
+
+        if (clu->cid != cid) continue;
+
+        rb_cluster_t *cluster = (rb_cluster_t *) xmalloc(sizeof (rb_cluster_t));
+        cluster->cid = clu->cid;
+        list_init(&cluster->storages);
+
+        list_for_each_forward(q, &clu->storages) {
+
+            rb_stor_t *rb_stor = list_entry(q, rb_stor_t, list);
+
+            rb_stor_t *stor = (rb_stor_t *) xmalloc(sizeof (rb_stor_t));
+            memset(stor, 0, sizeof (rb_stor_t));
+            strcpy(stor->host, rb_stor->host);
+            stor->sid = rb_stor->sid;
+            stor->mclient.rpcclt.sock = -1;
+            list_push_back(&cluster->storages, &stor->list);
+        }
+        list_push_back(copy_entries, &cluster->list);
+    }
+}
 
 
 
@@ -253,6 +253,14 @@ int rbs_get_rb_entry_cnts(rb_entry_t * rb_entry,
  * @param cluster_entries: list of cluster(s).
  */
 void rbs_release_cluster_list(list_t * cluster_entries);
+/** Copy one cluster of a list of cluster(s) without its connections, so 
+ *  that each rebuild thread gets its own connections to the storages
+ *
+ * @param cluster_entries: list of cluster(s) to copy from.
+ * @param copy_entries: initialized list that receives the copy.
+ * @param cid: unique id of the cluster to copy.
+ */
+void rbs_copy_cluster_list(list_t * cluster_entries, list_t * copy_entries, cid_t cid);
 /** Remove every file in a directory 
  *
  */
@@ -36,8 +36,6 @@
 #include "rbs.h"
 #include "rbs_sclient.h"
 
-uint64_t totalReadSize = 0;
-
 
 /** Get one storage connection for a given SID and given random value
  *
@@ -206,6 +204,55 @@ out:
         xdr_free((xdrproc_t) xdr_mp_list_bins_files_ret_t, (char *) ret);
     return status;
 }
+int rbs_get_dirty_list(mclient_t * mclt, cid_t cid, sid_t sid,
+        sid_t dirty_sid, uint8_t clear, uint64_t * cookie,
+        mp_dirty_entry_t * entries, int * nb, 
+        uint8_t * overflow, uint8_t * eof) {
+
+    int status = -1;
+    mp_list_dirty_arg_t arg;
+    mp_list_dirty_ret_t *ret = 0;
+    dirty_list_t *reply;
+
+    DEBUG_FUNCTION;
+
+    *nb = 0;
+
+    // Args of request
+    arg.cid = cid;
+    arg.sid = sid;
+    arg.dirty_sid = dirty_sid;
+    arg.clear = clear;
+    arg.cookie = *cookie;
+
+    // Send request to storage server
+    ret = mp_list_dirty_1(&arg, mclt->rpcclt.client);
+    if (ret == 0) {
+        errno = EPROTO;
+        goto out;
+    }
+    if (ret->status == MP_FAILURE) {
+        errno = ret->mp_list_dirty_ret_t_u.error;
+        goto out;
+    }
+    reply = &ret->mp_list_dirty_ret_t_u.reply;
+
+    // Copy the journal entries
+    *nb = reply->entries.entries_len;
+    if (*nb > MP_DIRTY_MAX_ENTRIES) *nb = MP_DIRTY_MAX_ENTRIES;
+    if (*nb) memcpy(entries, reply->entries.entries_val, *nb * sizeof(mp_dirty_entry_t));
+
+    // Update index that represents where you are in the list
+    *eof = reply->eof;
+    *overflow = reply->overflow;
+    *cookie = reply->cookie;
+
+    status = 0;
+out:
+    if (ret)
+        xdr_free((xdrproc_t) xdr_mp_list_dirty_ret_t, (char *) ret);
+    return status;
+}
 
 int rbs_read_proj(sclient_t *storage, cid_t cid, sid_t sid, uint8_t stor_idx,
         uint8_t layout, uint32_t bsize, sid_t dist_set[ROZOFS_SAFE_MAX], fid_t fid,
@@ -256,8 +303,6 @@ int rbs_read_proj(sclient_t *storage, cid_t cid, sid_t sid, uint8_t stor_idx,
     proj_ctx_p->nbBlocks = *nb_blocks_read;
     
     *size_read += (proj_ctx_p->nbBlocks * rozofs_max_psize_in_msg);
-
-    totalReadSize += (proj_ctx_p->nbBlocks * rozofs_max_psize_in_msg);
     status = 0;
 out:
     return status;
@@ -270,7 +315,7 @@ typedef struct rbs_blocks_recv_ctx {
     uint8_t count; /**< number of response with the same nb. of blocks */
 } rbs_blocks_recv_ctx_t;
 
-rbs_blocks_recv_ctx_t rbs_blocks_recv_tb[ROZOFS_SAFE_MAX];
+static __thread rbs_blocks_recv_ctx_t rbs_blocks_recv_tb[ROZOFS_SAFE_MAX];
 
 static int rbs_read_proj_set(sclient_t **storages, int local_idx, uint8_t layout, uint32_t bsize, cid_t cid,
         sid_t dist_set[ROZOFS_SAFE_MAX], fid_t fid, bid_t first_block_idx,
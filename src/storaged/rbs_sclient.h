@@ -90,6 +90,27 @@ int rbs_get_rb_entry_list(mclient_t * mclt, cid_t cid, sid_t sid,
         uint64_t * cookie,
         bins_file_rebuild_t ** children, uint8_t * eof);
 
+/** Send a request to a storage server for read or clear its journal of
+ *  the chunks written while a storage was unreachable
+ *
+ * @param *mclt: mproto connection to storage server
+ * @param cid: the unique cluster ID of storage to contacted
+ * @param sid: the unique storage ID of storage to contacted
+ * @param dirty_sid: the unique storage ID of storage to rebuild
+ * @param clear: 1 to remove the journal once the rebuild is done
+ * @param cookie: index indication
+ * @param entries: table of MP_DIRTY_MAX_ENTRIES entries to fill
+ * @param nb: number of entries read
+ * @param overflow: the journal has overflown, a full rebuild is required
+ * @param eof: end of list indication
+ *
+ * @return: 0 on success -1 otherwise (errno is set)
+ */
+int rbs_get_dirty_list(mclient_t * mclt, cid_t cid, sid_t sid,
+        sid_t dirty_sid, uint8_t clear, uint64_t * cookie,
+        mp_dirty_entry_t * entries, int * nb, 
+        uint8_t * overflow, uint8_t * eof);
+
 int rbs_read_blocks(sclient_t **storages, int local_idx, uint8_t layout, uint32_t bsize, cid_t cid,
         sid_t dist_set[ROZOFS_SAFE_MAX], fid_t fid, bid_t first_block_idx,
         uint32_t nb_blocks_2_read, uint32_t * nb_blocks_read, int retry_nb,
@@ -77,15 +77,15 @@ typedef struct rbs_timestamp_ctx {
 
 
 /**
- * Local variables
+ * Local variables (one set per rebuild thread)
  */
-extern rbs_timestamp_ctx_t rbs_timestamp_tb[];
-extern uint8_t rbs_timestamp_next_free_idx;
+extern __thread rbs_timestamp_ctx_t rbs_timestamp_tb[];
+extern __thread uint8_t rbs_timestamp_next_free_idx;
 
-extern projection_t rbs_projections[];
-extern angle_t rbs_angles[];
-extern uint16_t rbs_psizes[];
-extern uint8_t rbs_prj_idx_table[];
+extern __thread projection_t rbs_projections[];
+extern __thread angle_t rbs_angles[];
+extern __thread uint16_t rbs_psizes[];
+extern __thread uint8_t rbs_prj_idx_table[];
 
 /** 
   Apply the transform (to generate only one projection) to a buffer starting
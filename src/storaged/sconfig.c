@@ -54,9 +54,11 @@
 #define SDEV_TOTAL      "device-total"
 #define SDEV_MAPPER     "device-mapper"
 #define SDEV_RED        "device-redundancy"
+#define SDIRECT_IO      "direct-io"
 
 int storage_config_initialize(storage_config_t *s, cid_t cid, sid_t sid,
-        const char *root, int dev, int dev_mapper, int dev_red, const char * spare_mark) {
+        const char *root, int dev, int dev_mapper, int dev_red, const char * spare_mark,
+	int direct_io) {
     DEBUG_FUNCTION;
 
     s->sid = sid;
@@ -65,6 +67,7 @@ int storage_config_initialize(storage_config_t *s, cid_t cid, sid_t sid,
     s->device.total      = dev;
     s->device.mapper     = dev_mapper; 
     s->device.redundancy = dev_red;
+    s->direct_io         = direct_io;
     if (spare_mark == NULL) {
       /*
       ** Spare device have an empty "rozofs_spare" file
@@ -222,6 +225,7 @@ int sconfig_read(sconfig_t *config, const char *fname, int cluster_id) {
 #endif
         const char *root = 0;
         const char *spare_mark = NULL;
+        int         direct_io;
         
 	char       rootPath[PATH_MAX];
 
@@ -354,9 +358,16 @@ int sconfig_read(sconfig_t *config, const char *fname, int cluster_id) {
           spare_mark = NULL;
         }
 
+        /*
+        ** Whether the bins files are accessed with O_DIRECT
+        */
+        if (config_setting_lookup_bool(ms, SDIRECT_IO, &direct_io) == CONFIG_FALSE) {
+          direct_io = 0;
+        }
+
         new = xmalloc(sizeof (storage_config_t));
         if (storage_config_initialize(new, (cid_t) cid, (sid_t) sid,
-                root, devices, mapper, redundancy,spare_mark) != 0) {
+                root, devices, mapper, redundancy,spare_mark,direct_io) != 0) {
             if (new)
                 free(new);
             goto out;
@@ -43,6 +43,7 @@ typedef struct storage_config {
     ** else      : look for "rozofs_spare" file containing string <spare_mark>"
     */    
     char                  * spare_mark;  
+    int                     direct_io; // Whether bins files are accessed with O_DIRECT
     list_t list;
 } storage_config_t;
 
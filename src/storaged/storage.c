@@ -1283,6 +1283,7 @@ int storage_initialize(storage_t *st,
     st->mapper_redundancy = mapper_redundancy;
     st->share             = NULL;
     st->next_device       = 0;
+    st->direct_io         = 0;
     
     if (spare_mark == NULL) {
       /*
@@ -1310,6 +1311,7 @@ int storage_initialize(storage_t *st,
     for (dev=0; dev<device_number; dev++) {
       st->device_ctx[dev].status = storage_device_status_init;
       st->device_ctx[dev].failure = 0;
+      st->device_ctx[dev].direct_io_refused = 0;
     }
 
     memset(&st->device_errors , 0,sizeof(st->device_errors));        
@@ -1511,27 +1513,364 @@ int storage_restore_chunk(storage_t * st, uint8_t * device,fid_t fid, uint8_t sp
     if (result == 0) return -1;   
     return 0;
 }
-int storage_write_chunk(storage_t * st, storio_device_mapping_t * fidCtx, uint8_t layout, uint32_t bsize, sid_t * dist_set,
-        uint8_t spare, fid_t fid, uint8_t chunk, bid_t bid, uint32_t nb_proj, uint8_t version,
-        uint64_t *file_size, const bin_t * bins, int * is_fid_faulty) {
-    int status = -1;
-    char path[FILENAME_MAX];
-    int fd = -1;
-    size_t nb_write = 0;
-    size_t length_to_write = 0;
-    off_t bins_file_offset = 0;
-    uint16_t rozofs_msg_psize;
-    uint16_t rozofs_disk_psize;
-    struct stat sb;
+/*
+**__________________________________________________________________
+**
+** O_DIRECT access to the bins files
+**
+** The projections are stored with their exact size on disk, so the
+** records are not aligned. An O_DIRECT access is done on the extent
+** aligned on ROZOFS_ST_DIRECT_IO_ALIGN that contains the records,
+** through a bounce buffer owned by the calling thread.
+** An unaligned write reads the partial first and last blocks of the 
+** extent, copies the records in between and writes the whole extent
+** back. Writes of a same file may run in parallel, so the O_DIRECT 
+** writes of a file are serialized on a lock to keep the neighbour 
+** records of a shared block. Every layout and block size is written 
+** with O_DIRECT. Only the devices whose file system refuses O_DIRECT 
+** use the page cache.
+**__________________________________________________________________
+*/
+#define STORAGE_DIRECT_ALIGN_DOWN(x) ((x) & ~((off_t)ROZOFS_ST_DIRECT_IO_ALIGN-1))
+#define STORAGE_DIRECT_ALIGN_UP(x)   STORAGE_DIRECT_ALIGN_DOWN((x)+ROZOFS_ST_DIRECT_IO_ALIGN-1)
+
+static __thread char * storage_direct_buf    = NULL;
+static __thread size_t storage_direct_buf_sz = 0;
+
+#define STORAGE_DIRECT_WRITE_LOCK_NB 64
+static pthread_mutex_t storage_direct_write_lock[STORAGE_DIRECT_WRITE_LOCK_NB] = {
+  [0 ... STORAGE_DIRECT_WRITE_LOCK_NB-1] = PTHREAD_MUTEX_INITIALIZER
+};
+/*
+**__________________________________________________________________
+*/
+/**
+*  Get the aligned bounce buffer of the current thread
+
+   @param size: the required size
+   
+   @retval the buffer or NULL on allocation failure
+*/
+static inline char * storage_direct_buffer(size_t size) {
+
+    if (size <= storage_direct_buf_sz) return storage_direct_buf;
+    
+    if (storage_direct_buf != NULL) free(storage_direct_buf);
+    storage_direct_buf_sz = 0;
+    if (posix_memalign((void**)&storage_direct_buf, ROZOFS_ST_DIRECT_IO_ALIGN, size) != 0) {
+      storage_direct_buf = NULL;
+      errno = ENOMEM;
+      return NULL;
+    }
+    storage_direct_buf_sz = size;
+    return storage_direct_buf;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Stop using O_DIRECT on a device whose file system refuses it
+
+   @param st: the storage
+   @param dev: the device
+*/
+static inline void storage_direct_io_refused(storage_t * st, int dev) {
+
+    if (st->device_ctx[dev].direct_io_refused) return;
+    st->device_ctx[dev].direct_io_refused = 1;
+    warning("O_DIRECT refused on cid %d sid %d device %d. Buffered I/O is used",st->cid,st->sid,dev);
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Open a bins file with O_DIRECT when configured for the storage
+*  and accepted by the device file system
+
+   @param io: the chunk read/write context (path is set)
+   @param dev: the device of the chunk
+   @param flags: open flags
+   @param mode: open mode
+   
+   @retval the file descriptor or -1 (errno is set)
+*/
+static inline int storage_open_bins_file(storage_chunk_io_t * io, int dev, int flags, mode_t mode) {
+
+    io->direct = 0;
+    if ((io->st->direct_io) && (dev < STORAGE_MAX_DEVICE_NB) 
+    &&  (io->st->device_ctx[dev].direct_io_refused == 0)) {
+      io->fd = open(io->path, flags | O_DIRECT, mode);
+      if (io->fd >= 0) {
+        io->direct = 1;
+	return io->fd;
+      }
+      if (errno != EINVAL) return -1;
+      storage_direct_io_refused(io->st, dev);
+    }
+    io->fd = open(io->path, flags, mode);
+    return io->fd;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Back to buffered I/O on the file of a chunk read/write context
+
+   @param io: the chunk read/write context
+*/
+static inline void storage_direct_io_off(storage_chunk_io_t * io) {
+    int flags;
+    
+    flags = fcntl(io->fd, F_GETFL);
+    if (flags != -1) fcntl(io->fd, F_SETFL, flags & ~O_DIRECT);
+    io->direct = 0;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Back to buffered I/O on a device when an O_DIRECT access is refused
+
+   @param io: the chunk read/write context
+*/
+static inline void storage_direct_io_fallback(storage_chunk_io_t * io) {
+    
+    storage_direct_io_refused(io->st, io->fidCtx->device[io->chunk]);
+    storage_direct_io_off(io);
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Copy between the bounce buffer and the bins of the message
+
+   @param io: the chunk read/write context
+   @param buf: the bounce buffer at the offset of the access
+   @param len: the length to copy
+   @param to_bins: 1 to copy from buf to the bins, 0 for the reverse
+*/
+static inline void storage_direct_copy(storage_chunk_io_t * io, char * buf, size_t len, int to_bins) {
+    int    i;
+    size_t sz;
+
+    if (io->nb_vect == 0) {
+      if (to_bins) memcpy(io->bins, buf, len);
+      else         memcpy(buf, io->bins, len);
+      return;
+    }
+    for (i=0; (i<io->nb_vect) && (len>0); i++) {
+      sz = io->vector[i].iov_len;
+      if (sz > len) sz = len;
+      if (to_bins) memcpy(io->vector[i].iov_base, buf, sz);
+      else         memcpy(buf, io->vector[i].iov_base, sz);
+      buf += sz;
+      len -= sz;
+    }
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  O_DIRECT read of a chunk
+
+   @param io: the chunk read context
+   
+   @retval the number of bytes read or -1 (errno is set)
+*/
+static ssize_t storage_direct_read(storage_chunk_io_t * io) {
+    off_t    a_off = STORAGE_DIRECT_ALIGN_DOWN(io->offset);
+    size_t   a_len = STORAGE_DIRECT_ALIGN_UP(io->offset+io->length) - a_off;
+    size_t   skip  = io->offset - a_off;
+    char   * buf;
+    ssize_t  nb;
+    
+    buf = storage_direct_buffer(a_len);
+    if (buf == NULL) return -1;
+    
+    nb = pread(io->fd, buf, a_len, a_off);
+    if (nb < 0) return -1;
+    
+    /*
+    ** Nothing is returned after the end of file
+    */
+    if (nb <= skip) return 0;
+    nb -= skip;
+    if (nb > io->length) nb = io->length;
+    
+    storage_direct_copy(io, buf+skip, nb, 1);
+    return nb;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Read an aligned block of a file opened with O_DIRECT. 
+*  What is after the end of file is zeroed.
+
+   @param fd: the file descriptor
+   @param buf: the aligned buffer to read the block in
+   @param off: the aligned offset of the block
+   @param size: the size of the file
+   
+   @retval 0 on success or -1 (errno is set)
+*/
+static inline int storage_direct_read_block(int fd, char * buf, off_t off, off_t size) {
+    ssize_t nb = 0;
+    
+    if (off < size) {
+      nb = pread(fd, buf, ROZOFS_ST_DIRECT_IO_ALIGN, off);
+      if (nb < 0) return -1;
+    }
+    if (nb < ROZOFS_ST_DIRECT_IO_ALIGN) memset(buf+nb, 0, ROZOFS_ST_DIRECT_IO_ALIGN-nb);
+    return 0;
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  O_DIRECT write of a chunk. When the offset or the length is not 
+*  aligned, the partial blocks at both ends are read first.
+
+   @param io: the chunk write context
+   
+   @retval the number of bytes written or -1 (errno is set)
+*/
+static ssize_t storage_direct_write(storage_chunk_io_t * io) {
+    off_t             end   = io->offset+io->length;
+    off_t             a_off = STORAGE_DIRECT_ALIGN_DOWN(io->offset);
+    off_t             a_end = STORAGE_DIRECT_ALIGN_UP(end);
+    size_t            a_len = a_end - a_off;
+    size_t            skip  = io->offset - a_off;
+    pthread_mutex_t * lock;
+    struct stat       stats;
+    char            * buf;
+    ssize_t           nb = -1;
+    
+    buf = storage_direct_buffer(a_len);
+    if (buf == NULL) return -1;
+
+    lock = &storage_direct_write_lock[((uintptr_t)io->fidCtx/sizeof(storio_device_mapping_t))%STORAGE_DIRECT_WRITE_LOCK_NB];
+    pthread_mutex_lock(lock);
+    
+    stats.st_size = end;
+    if ((a_off != io->offset) || (a_end != end)) {
+      if (fstat(io->fd, &stats) < 0) goto out;
+      if (a_off != io->offset) {
+        if (storage_direct_read_block(io->fd, buf, a_off, stats.st_size) < 0) goto out;
+      }
+      if ((a_end != end) && ((a_end - ROZOFS_ST_DIRECT_IO_ALIGN != a_off) || (a_off == io->offset))) {
+        if (storage_direct_read_block(io->fd, buf + a_len - ROZOFS_ST_DIRECT_IO_ALIGN, 
+	                              a_end - ROZOFS_ST_DIRECT_IO_ALIGN, stats.st_size) < 0) goto out;
+      }
+    }
+    
+    storage_direct_copy(io, buf+skip, io->length, 0);
+    nb = pwrite(io->fd, buf, a_len, a_off);
+    if (nb < 0) goto out;
+    
+    /*
+    ** Do not extend the file with the padding of the last block
+    */
+    if (a_end > stats.st_size) {
+      if (ftruncate(io->fd, (end > stats.st_size) ? end : stats.st_size) < 0) {
+        nb = -1;
+	goto out;
+      }
+    }
+    
+    if (nb <= skip) nb = 0;
+    else {
+      nb -= skip;
+      if (nb > io->length) nb = io->length;
+    }
+    
+out:
+    pthread_mutex_unlock(lock);
+    return nb;
+}
+/*
+**__________________________________________________________________
+*/
+ssize_t storage_chunk_io_read(storage_chunk_io_t * io) {
+    ssize_t nb;
+    
+    if (io->direct) {
+      nb = storage_direct_read(io);
+      if ((nb >= 0) || (errno != EINVAL)) return nb;
+      storage_direct_io_fallback(io);
+    }
+    
+    if (io->nb_vect == 0) {    
+      return pread(io->fd, io->bins, io->length, io->offset);       
+    }
+    return preadv(io->fd, io->vector, io->nb_vect, io->offset);      
+}
+/*
+**__________________________________________________________________
+*/
+ssize_t storage_chunk_io_write(storage_chunk_io_t * io) {
+    ssize_t nb;
+    
+    if (io->direct) {
+      nb = storage_direct_write(io);
+      if ((nb >= 0) || (errno != EINVAL)) return nb;
+      storage_direct_io_fallback(io);
+    }
+    
+    if (io->nb_vect == 0) {    
+      return pwrite(io->fd, io->bins, io->length, io->offset);       
+    }
+    return pwritev(io->fd, io->vector, io->nb_vect, io->offset);      
+}
+/*
+**__________________________________________________________________
+*/
+/**
+*  Release the resources of a chunk write
+
+   @param io: the chunk write context
+*/
+static inline void storage_write_chunk_release(storage_chunk_io_t * io) {
+
+    if (io->fd != -1) {
+      close(io->fd);
+      io->fd = -1;
+    }  
+
+    /*
+    ** Update device array in FID cache from header file
+    */    
+    if (io->map_result == MAP_COPY2CACHE) {
+      memcpy(io->fidCtx->device,io->file_hdr.v0.device,ROZOFS_STORAGE_MAX_CHUNK_PER_FILE);    
+    }
+}
+/*
+**__________________________________________________________________
+*/
+int storage_write_chunk_prepare(storage_chunk_io_t * io, storage_t * st, storio_device_mapping_t * fidCtx, 
+        uint8_t layout, uint32_t bsize, sid_t * dist_set,
+        uint8_t spare, fid_t fid, uint8_t chunk, bid_t bid, uint32_t nb_proj, 
+        const bin_t * bins, int * is_fid_faulty) {
     int open_flags;
     int    device_id_is_given;
-    rozofs_stor_bins_file_hdr_t file_hdr;
-    storage_dev_map_distribution_write_ret_e map_result = MAP_FAILURE;
     uint8_t * device = fidCtx->device;
 
     // No specific fault on this FID detected
     *is_fid_faulty = 0; 
 
+    io->st         = st;
+    io->fidCtx     = fidCtx;
+    io->fid        = fid;
+    io->chunk      = chunk;
+    io->bid        = bid;
+    io->nb_proj    = nb_proj;
+    io->bins       = (bin_t *) bins;
+    io->fd         = -1;
+    io->nb_vect    = 0;
+    io->direct     = 0;
+    io->map_result = MAP_FAILURE;
+    io->status     = -1;
+
     dbg("%d/%d Write chunk %d : ", st->cid, st->sid, chunk);
    
 open:    
@@ -1548,16 +1887,16 @@ open:
     }        
  
     // Build the chunk file name 
-    map_result = storage_dev_map_distribution_write(st, device, chunk, bsize, 
-                                        	    fid, layout, dist_set, 
-						    spare, path, 0, &file_hdr);
-    if (map_result == MAP_FAILURE) {
+    io->map_result = storage_dev_map_distribution_write(st, device, chunk, bsize, 
+                                        	        fid, layout, dist_set, 
+						        spare, io->path, 0, &io->file_hdr);
+    if (io->map_result == MAP_FAILURE) {
       goto out;      
     }  
 
     // Open bins file
-    fd = open(path, open_flags, ROZOFS_ST_BINS_FILE_MODE);
-    if (fd < 0) {
+    storage_open_bins_file(io, device[chunk], open_flags, ROZOFS_ST_BINS_FILE_MODE);
+    if (io->fd < 0) {
     
         // Something definitively wrong on device
         if (errno != ENOENT) {
@@ -1587,12 +1926,12 @@ open:
     ** and the projection size on disk 
     */
     storage_get_projection_size(spare, st->sid, layout, bsize, dist_set,
-                                &rozofs_msg_psize, &rozofs_disk_psize); 
+                                &io->msg_psize, &io->disk_psize); 
 	       
     // Compute the offset and length to write
     
-    bins_file_offset = bid * rozofs_disk_psize;
-    length_to_write  = nb_proj * rozofs_disk_psize;
+    io->offset = bid * io->disk_psize;
+    io->length = nb_proj * io->disk_psize;
 
     //dbg("write %s bid %d nb %d",path,bid,nb_proj);
 
@@ -1601,52 +1940,61 @@ open:
     /*
     ** Writting the projection as received directly on disk
     */
-    if (rozofs_msg_psize == rozofs_disk_psize) {
+    if (io->msg_psize == io->disk_psize) {
     
       /*
       ** generate the crc32c for each projection block
       */
-      storio_gen_crc32((char*)bins,nb_proj,rozofs_disk_psize,crc32);
-
-      errno = 0;
-      nb_write = pwrite(fd, bins, length_to_write, bins_file_offset);
+      storio_gen_crc32((char*)bins,nb_proj,io->disk_psize,crc32);
+      return STORAGE_CHUNK_IO_SUBMIT;
     }
 
     /*
     ** Writing the projections on a different size on disk
     */
-    else {
-      struct iovec       vector[ROZOFS_MAX_BLOCK_PER_MSG*2]; 
-      int                i;
-      char *             pMsg;
-      
-      if (nb_proj > (ROZOFS_MAX_BLOCK_PER_MSG*2)) {  
-        severe("storage_write more blocks than possible %d vs max %d",
-	        nb_proj,ROZOFS_MAX_BLOCK_PER_MSG*2);
-        errno = ESPIPE;	
-        goto out;
-      }
-      pMsg  = (char *) bins;
-      for (i=0; i< nb_proj; i++) {
-        vector[i].iov_base = pMsg;
-        vector[i].iov_len  = rozofs_disk_psize;
-	pMsg += rozofs_msg_psize;
-      }
-      
-      /*
-      ** generate the crc32c for each projection block
-      */
-      
-      storio_gen_crc32_vect(vector,nb_proj,rozofs_disk_psize,crc32);
-      
-      errno = 0;      
-      nb_write = pwritev(fd, vector, nb_proj, bins_file_offset);      
-    } 
+    int                i;
+    char *             pMsg;
+
+    if (nb_proj > (ROZOFS_MAX_BLOCK_PER_MSG*2)) {  
+      severe("storage_write more blocks than possible %d vs max %d",
+	      nb_proj,ROZOFS_MAX_BLOCK_PER_MSG*2);
+      errno = ESPIPE;	
+      goto out;
+    }
+    pMsg  = (char *) bins;
+    for (i=0; i< nb_proj; i++) {
+      io->vector[i].iov_base = pMsg;
+      io->vector[i].iov_len  = io->disk_psize;
+      pMsg += io->msg_psize;
+    }
+    io->nb_vect = nb_proj;
+
+    /*
+    ** generate the crc32c for each projection block
+    */
 
-    if (nb_write != length_to_write) {
+    storio_gen_crc32_vect(io->vector,nb_proj,io->disk_psize,crc32);
+    return STORAGE_CHUNK_IO_SUBMIT;
+
+out:
+    storage_write_chunk_release(io);
+    return STORAGE_CHUNK_IO_ERROR;
+}
+/*
+**__________________________________________________________________
+*/
+int storage_write_chunk_complete(storage_chunk_io_t * io, ssize_t nb_write, 
+                                 uint64_t *file_size, int * is_fid_faulty) {
+    struct stat sb;
+    uint8_t   * device = io->fidCtx->device;
+
+    io->status = -1;
+
+    if (nb_write != io->length) {
 	
+        if (nb_write != -1) errno = 0;
         if (errno==0) errno = ENOSPC;
-	storio_fid_error(fid, device[chunk], chunk, bid, nb_proj,"write");
+	storio_fid_error(io->fid, device[io->chunk], io->chunk, io->bid, io->nb_proj,"write");
         
 	/*
 	** Only few bytes written since no space left on device 
@@ -1655,13 +2003,13 @@ open:
 	  errno = ENOSPC;
 	  goto out;
         }
-	storage_error_on_device(st,device[chunk]);
+	storage_error_on_device(io->st,device[io->chunk]);
 	// A fault probably localized to this FID is detected   
 	*is_fid_faulty = 1;  
         severe("pwrite(%s) size %llu expecting %llu offset %llu : %s",
-	        path, (unsigned long long)nb_write,
-	        (unsigned long long)length_to_write, 
-		(unsigned long long)bins_file_offset, 
+	        io->path, (unsigned long long)nb_write,
+	        (unsigned long long)io->length, 
+		(unsigned long long)io->offset, 
 		strerror(errno));
         goto out;
     }
@@ -1672,7 +2020,7 @@ open:
 //    storio_cache_insert(fid,bid,nb_proj,buf_ts_storage_write,0);
     
     // Stat file for return the size of bins file after the write operation
-    if (fstat(fd, &sb) == -1) {
+    if (fstat(io->fd, &sb) == -1) {
         severe("fstat failed: %s", strerror(errno));
         goto out;
     }
@@ -1681,19 +2029,26 @@ open:
 
 
     // Write is successful
-    status = nb_proj * rozofs_msg_psize;
+    io->status = io->nb_proj * io->msg_psize;
 
 out:
-    if (fd != -1) close(fd);
+    storage_write_chunk_release(io);
+    return io->status;
+}
+int storage_write_chunk(storage_t * st, storio_device_mapping_t * fidCtx, uint8_t layout, uint32_t bsize, sid_t * dist_set,
+        uint8_t spare, fid_t fid, uint8_t chunk, bid_t bid, uint32_t nb_proj, uint8_t version,
+        uint64_t *file_size, const bin_t * bins, int * is_fid_faulty) {
+    storage_chunk_io_t io;
+    ssize_t            nb_write;
 
-    /*
-    ** Update device array in FID cache from header file
-    */    
-    if (map_result == MAP_COPY2CACHE) {
-      memcpy(device,file_hdr.v0.device,ROZOFS_STORAGE_MAX_CHUNK_PER_FILE);    
+    if (storage_write_chunk_prepare(&io, st, fidCtx, layout, bsize, dist_set, spare, fid, 
+                                    chunk, bid, nb_proj, bins, is_fid_faulty) != STORAGE_CHUNK_IO_SUBMIT) {
+      return -1;
     }
-        
-    return status;
+    
+    errno = 0;
+    nb_write = storage_chunk_io_write(&io);
+    return storage_write_chunk_complete(&io, nb_write, file_size, is_fid_faulty);
 }
 int storage_write_repair_chunk(storage_t * st, uint8_t * device, uint8_t layout, uint32_t bsize, sid_t * dist_set,
         uint8_t spare, fid_t fid, uint8_t chunk, bid_t bid, uint32_t nb_proj, uint64_t * bitmap, uint8_t version,
@@ -1817,30 +2172,34 @@ uint64_t buf_ts_storcli_read[STORIO_CACHE_BCOUNT];
 char storage_bufall[4096];
 uint8_t storage_read_optim[4096];
 
-int storage_read_chunk(storage_t * st, storio_device_mapping_t * fidCtx, uint8_t layout, uint32_t bsize, sid_t * dist_set,
+int storage_read_chunk_prepare(storage_chunk_io_t * io, storage_t * st, storio_device_mapping_t * fidCtx, 
+        uint8_t layout, uint32_t bsize, sid_t * dist_set,
         uint8_t spare, fid_t fid, uint8_t chunk, bid_t bid, uint32_t nb_proj,
-        bin_t * bins, size_t * len_read, uint64_t *file_size,int * is_fid_faulty) {
+        bin_t * bins, size_t * len_read, int * is_fid_faulty) {
 
-    int status = -1;
-    char path[FILENAME_MAX];
-    int fd = -1;
-    size_t nb_read = 0;
-    size_t length_to_read = 0;
-    off_t bins_file_offset = 0;
-    uint16_t rozofs_msg_psize;
-    uint16_t rozofs_disk_psize;
     int    device_id_is_given = 1;
     int                       storage_slice;
-    struct iovec vector[ROZOFS_MAX_BLOCK_PER_MSG*2];
-    uint64_t    crc32_errors[3]; 
     uint8_t * device = fidCtx->device;
-    int result;
     
     dbg("%d/%d Read chunk %d : ", st->cid, st->sid, chunk);
 
     // No specific fault on this FID detected
     *is_fid_faulty = 0;  
-    path[0]=0;
+    io->path[0]    = 0;
+    io->st         = st;
+    io->fidCtx     = fidCtx;
+    io->fid        = fid;
+    io->layout     = layout;
+    io->bsize      = bsize;
+    io->chunk      = chunk;
+    io->bid        = bid;
+    io->nb_proj    = nb_proj;
+    io->bins       = bins;
+    io->fd         = -1;
+    io->nb_vect    = 0;
+    io->direct     = 0;
+    io->map_result = MAP_FAILURE;
+    io->status     = -1;
     
     /*
     ** When device array is not given, one has to read the header file on disk
@@ -1854,7 +2213,7 @@ int storage_read_chunk(storage_t * st, storio_device_mapping_t * fidCtx, uint8_t
     ** and the projection size on disk
     */
     storage_get_projection_size(spare, st->sid, layout, bsize, dist_set,
-                                &rozofs_msg_psize, &rozofs_disk_psize); 
+                                &io->msg_psize, &io->disk_psize); 
 
 
 retry:
@@ -1880,7 +2239,7 @@ retry:
       if (read_hdr_res == STORAGE_READ_HDR_ERRORS) {
 	*is_fid_faulty = 1; 
 	errno = EIO;
-	goto out;
+	return STORAGE_CHUNK_IO_ERROR;
       }
       
       /*
@@ -1888,7 +2247,7 @@ retry:
       */      
       if (read_hdr_res == STORAGE_READ_HDR_NOT_FOUND) {
         errno = ENOENT;
-        goto out;  
+	return STORAGE_CHUNK_IO_ERROR;
       } 
       
       /*
@@ -1903,7 +2262,7 @@ retry:
 	fidCtx->recycle_cpt = rozofs_get_recycle_from_fid(file_hdr.v0.fid);
 	memcpy(device,file_hdr.v0.device,ROZOFS_STORAGE_MAX_CHUNK_PER_FILE);
         errno = ENOENT;
-        goto out;  
+	return STORAGE_CHUNK_IO_ERROR;
       } 
       
       /*
@@ -1926,33 +2285,33 @@ retry:
     */				     
     if (device[chunk] == ROZOFS_EOF_CHUNK) {
       *len_read = 0;
-      status = nb_proj * rozofs_msg_psize;
-      goto out;
+      io->status = nb_proj * io->msg_psize;
+      return STORAGE_CHUNK_IO_DONE;
     }
 
     /*
     ** We are trying to read inside a whole. Return 0 on the requested size
     */      
     if(device[chunk] == ROZOFS_EMPTY_CHUNK) {
-      *len_read = nb_proj * rozofs_msg_psize;
+      *len_read = nb_proj * io->msg_psize;
       memset(bins,0,* len_read);
-      status = *len_read;
-      goto out;
+      io->status = *len_read;
+      return STORAGE_CHUNK_IO_DONE;
     }
     
   
     storage_slice = rozofs_storage_fid_slice(fid);
-    storage_build_chunk_full_path(path, st->root, device[chunk], spare, storage_slice, fid,chunk);
+    storage_build_chunk_full_path(io->path, st->root, device[chunk], spare, storage_slice, fid,chunk);
 
     // Open bins file
-    fd = open(path, ROZOFS_ST_NO_CREATE_FILE_FLAG, ROZOFS_ST_BINS_FILE_MODE_RO);
-    if (fd < 0) {
+    storage_open_bins_file(io, device[chunk], ROZOFS_ST_NO_CREATE_FILE_FLAG, ROZOFS_ST_BINS_FILE_MODE_RO);
+    if (io->fd < 0) {
     
         // Something definitively wrong on device
         if (errno != ENOENT) {
           storio_fid_error(fid, device[chunk], chunk, bid, nb_proj,"open read"); 		
 	  storage_error_on_device(st,device[chunk]); 
-	  goto out;
+	  return STORAGE_CHUNK_IO_ERROR;
 	}
 	
         // If device id was not given as input, the file path has been deduced from 
@@ -1962,7 +2321,7 @@ retry:
 	  errno = EIO; // Data file is missing !!!
 	  *is_fid_faulty = 1;
 	  storage_error_on_device(st,device[chunk]); 
-	  goto out;
+	  return STORAGE_CHUNK_IO_ERROR;
 	}
 	
 	// The device id was given as input so the file did exist some day,
@@ -1975,45 +2334,57 @@ retry:
 	       
     // Compute the offset and length to write
     
-    bins_file_offset = bid * rozofs_disk_psize;
-    length_to_read   = nb_proj * rozofs_disk_psize;
+    io->offset = bid * io->disk_psize;
+    io->length = nb_proj * io->disk_psize;
 
     //dbg("read %s bid %d nb %d",path,bid,nb_proj);
     
     /*
     ** Reading the projection directly as they will be sent in message
     */
-    if (rozofs_msg_psize == rozofs_disk_psize) {    
-      // Read nb_proj * (projection + header)
-      nb_read = pread(fd, bins, length_to_read, bins_file_offset);       
+    if (io->msg_psize == io->disk_psize) {    
+      return STORAGE_CHUNK_IO_SUBMIT;
     }
+    
     /*
     ** Projections are smaller on disk than in message
     */
-    else {
-      int          i;
-      char *       pMsg;
-      
-      if (nb_proj > ROZOFS_MAX_BLOCK_PER_MSG*2) {  
-        severe("storage_read more blocks than possible %d vs max %d",
-	        nb_proj,ROZOFS_MAX_BLOCK_PER_MSG*2);
-        errno = ESPIPE;			
-        goto out;
-      }
-      pMsg  = (char *) bins;
-      for (i=0; i< nb_proj; i++) {
-        vector[i].iov_base = pMsg;
-        vector[i].iov_len  = rozofs_disk_psize;
-	pMsg += rozofs_msg_psize;
-      }
-      nb_read = preadv(fd, vector, nb_proj, bins_file_offset);      
-    } 
+    int          i;
+    char *       pMsg;
+
+    if (nb_proj > ROZOFS_MAX_BLOCK_PER_MSG*2) {  
+      severe("storage_read more blocks than possible %d vs max %d",
+	      nb_proj,ROZOFS_MAX_BLOCK_PER_MSG*2);
+      errno = ESPIPE;			
+      close(io->fd);
+      io->fd = -1;
+      return STORAGE_CHUNK_IO_ERROR;
+    }
+    pMsg  = (char *) bins;
+    for (i=0; i< nb_proj; i++) {
+      io->vector[i].iov_base = pMsg;
+      io->vector[i].iov_len  = io->disk_psize;
+      pMsg += io->msg_psize;
+    }
+    io->nb_vect = nb_proj;
+    return STORAGE_CHUNK_IO_SUBMIT;
+}
+/*
+**__________________________________________________________________
+*/
+int storage_read_chunk_complete(storage_chunk_io_t * io, ssize_t nb_read, 
+                                size_t * len_read, uint64_t *file_size, int * is_fid_faulty) {
+    uint64_t    crc32_errors[3]; 
+    uint8_t   * device = io->fidCtx->device;
+    int result;
+
+    io->status = -1;
     
     // Check error
     if (nb_read == -1) {
-        storio_fid_error(fid, device[chunk], chunk, bid, nb_proj,"read"); 			
+        storio_fid_error(io->fid, device[io->chunk], io->chunk, io->bid, io->nb_proj,"read"); 			
         severe("pread failed: %s", strerror(errno));
-	storage_error_on_device(st,device[chunk]);  
+	storage_error_on_device(io->st,device[io->chunk]);  
 	// A fault probably localized to this FID is detected   
 	*is_fid_faulty = 1;   		
         goto out;
@@ -2026,58 +2397,78 @@ retry:
     ** written correctly on disk and is so incorrect.
     ** Let's generate a CRC32 error to trigger a block repair
     */
-    if ((nb_read % rozofs_disk_psize) != 0) {
+    if ((nb_read % io->disk_psize) != 0) {
         char fid_str[37];
-        rozofs_uuid_unparse(fid, fid_str);
+        rozofs_uuid_unparse(io->fid, fid_str);
         severe("storage_read failed (FID: %s layout %d bsize %d chunk %d bid %d): read inconsistent length %d not modulo of %d",
-	       fid_str,layout,bsize,chunk, (int) bid,(int)nb_read,rozofs_disk_psize);
-	nb_read = (nb_read / rozofs_disk_psize);
+	       fid_str,io->layout,io->bsize,io->chunk, (int) io->bid,(int)nb_read,io->disk_psize);
+	nb_read = (nb_read / io->disk_psize);
 	nb_read += 1;
-	nb_read *= rozofs_disk_psize;
+	nb_read *= io->disk_psize;
     }
 
     int nb_proj_effective;
-    nb_proj_effective = nb_read /rozofs_disk_psize ;
+    nb_proj_effective = nb_read /io->disk_psize ;
 
     /*
     ** check the crc32c for each projection block
     */
-    uint32_t crc32 = fid2crc32((uint32_t *)fid)+bid;
+    uint32_t crc32 = fid2crc32((uint32_t *)io->fid)+io->bid;
     memset(crc32_errors,0,sizeof(crc32_errors));
     
-    if (rozofs_msg_psize == rozofs_disk_psize) {        
-      result = storio_check_crc32((char*)bins,
+    if (io->nb_vect == 0) {        
+      result = storio_check_crc32((char*)io->bins,
                         	  nb_proj_effective,
-                		  rozofs_disk_psize,
-				  &st->crc_error,
+                		  io->disk_psize,
+				  &io->st->crc_error,
 				  crc32,
 				  crc32_errors);
     }
     else {
-      result = storio_check_crc32_vect(vector,
+      result = storio_check_crc32_vect(io->vector,
                         	       nb_proj_effective,
-                		       rozofs_disk_psize,
-				       &st->crc_error,
+                		       io->disk_psize,
+				       &io->st->crc_error,
 				       crc32,
 				       crc32_errors);      
     }
     if (result!=0) { 
       errno = 0;
-      storio_fid_error(fid, device[chunk], chunk, bid, result,"read crc32"); 		     
+      storio_fid_error(io->fid, device[io->chunk], io->chunk, io->bid, result,"read crc32"); 		     
       //if (result>1) storage_error_on_device(st,device[chunk]); 
     }	  
 
     // Update the length read
-    *len_read = (nb_read/rozofs_disk_psize)*rozofs_msg_psize;
+    *len_read = (nb_read/io->disk_psize)*io->msg_psize;
 
     *file_size = 0;
 
     // Read is successful
-    status = nb_proj * rozofs_msg_psize;
+    io->status = io->nb_proj * io->msg_psize;
 
 out:
-    if (fd != -1) close(fd);
-    return status;
+    if (io->fd != -1) close(io->fd);
+    io->fd = -1;
+    return io->status;
+}
+/*
+**__________________________________________________________________
+*/
+int storage_read_chunk(storage_t * st, storio_device_mapping_t * fidCtx, uint8_t layout, uint32_t bsize, sid_t * dist_set,
+        uint8_t spare, fid_t fid, uint8_t chunk, bid_t bid, uint32_t nb_proj,
+        bin_t * bins, size_t * len_read, uint64_t *file_size,int * is_fid_faulty) {
+    storage_chunk_io_t io;
+    ssize_t            nb_read;
+    int                ret;
+
+    ret = storage_read_chunk_prepare(&io, st, fidCtx, layout, bsize, dist_set, spare, fid, 
+                                     chunk, bid, nb_proj, bins, len_read, is_fid_faulty);
+    if (ret == STORAGE_CHUNK_IO_ERROR) return -1;
+    if (ret == STORAGE_CHUNK_IO_DONE)  return io.status;
+    
+    // Read nb_proj * (projection + header)
+    nb_read = storage_chunk_io_read(&io);
+    return storage_read_chunk_complete(&io, nb_read, len_read, file_size, is_fid_faulty);
 }
     
 int storage_resize(storage_t * st, storio_device_mapping_t * fidCtx, uint8_t layout, uint32_t bsize, sid_t * dist_set,
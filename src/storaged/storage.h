@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <sys/uio.h>
 
 #include <rozofs/rozofs.h>
 #include <rozofs/rozofs_srv.h>
@@ -81,6 +82,9 @@ static inline int rozofs_scan_mark_file(char * name, int * cid, int * sid, int *
 #define ROZOFS_ST_BINS_FILE_MODE_RW S_IFREG | S_IRUSR | S_IWUSR
 #define ROZOFS_ST_BINS_FILE_MODE_RO S_IFREG | S_IRUSR
 
+/** Alignment of offset, length and memory of the O_DIRECT bins file accesses */
+#define ROZOFS_ST_DIRECT_IO_ALIGN 4096
+
 /** Default mode to use for create subdirectories */
 #define ROZOFS_ST_DIR_MODE S_IRUSR | S_IWUSR | S_IXUSR
 
@@ -243,6 +247,7 @@ typedef struct _storage_device_ctx_t {
   uint64_t                    monitor_run;
   uint64_t                    monitor_no_activity;
   uint64_t                    last_activity_time;
+  uint8_t                     direct_io_refused; // The file system refuses O_DIRECT
 } storage_device_ctx_t;
 
 
@@ -266,6 +271,7 @@ typedef struct storage {
     storage_device_errors_t      device_errors;  // To monitor errors on device
     storage_device_ctx_t         device_ctx[STORAGE_MAX_DEVICE_NB]; 
     storage_share_t            * share; // share memory between storaged and storio          
+    int                          direct_io; // Whether bins files are accessed with O_DIRECT
 } storage_t;
 
 /*_____________________________________________________________
@@ -782,6 +788,110 @@ int storage_initialize(storage_t *st, cid_t cid, sid_t sid, const char *root,
  */
 void storage_release(storage_t * st);
 
+/*
+** Result of the preparation of a chunk read or write
+*/
+#define STORAGE_CHUNK_IO_ERROR   -1 /**< failure, errno is set */
+#define STORAGE_CHUNK_IO_DONE     0 /**< nothing to read from disk (EOF or hole) */
+#define STORAGE_CHUNK_IO_SUBMIT   1 /**< the disk access described in the context has to be done */
+
+/*
+** Context of a chunk read or write. It enables to split the disk
+** access from the preparation and the completion of the request,
+** in order to run the disk access asynchronously (io_uring).
+*/
+typedef struct _storage_chunk_io_t {
+  storage_t               * st;
+  storio_device_mapping_t * fidCtx;
+  uint8_t                 * fid;
+  uint8_t                   layout;
+  uint32_t                  bsize;
+  uint8_t                   chunk;
+  bid_t                     bid;
+  uint32_t                  nb_proj;
+  bin_t                   * bins;
+  uint16_t                  msg_psize;  /**< projection size in the message */
+  uint16_t                  disk_psize; /**< projection size on disk */
+  int                       fd;
+  off_t                     offset;     /**< offset of the access in the chunk file */
+  size_t                    length;     /**< length of the access */
+  int                       nb_vect;    /**< 0 when the bins are contiguous on disk and in message */
+  struct iovec              vector[ROZOFS_MAX_BLOCK_PER_MSG*2];
+  int                       status;     /**< returned value of the chunk read/write */
+  int                       map_result;
+  int                       direct;     /**< whether the file is opened with O_DIRECT */
+  rozofs_stor_bins_file_hdr_t file_hdr;
+  char                      path[FILENAME_MAX];
+} storage_chunk_io_t;
+
+/** Prepare the write of nb_proj projections in a chunk: open the chunk file
+ *  and generate the CRC32 of the projections. The write itself is described
+ *  by fd, offset, length and vector in the context.
+ *
+ * @param io: the chunk write context to fill
+ * Other parameters are those of storage_write_chunk
+ *
+ * @return: STORAGE_CHUNK_IO_SUBMIT or STORAGE_CHUNK_IO_ERROR (errno is set)
+ */
+int storage_write_chunk_prepare(storage_chunk_io_t * io, storage_t * st, storio_device_mapping_t * fidCtx, 
+        uint8_t layout, uint32_t bsize, sid_t * dist_set,
+        uint8_t spare, fid_t fid, uint8_t chunk, bid_t bid, uint32_t nb_proj, 
+        const bin_t * bins, int * is_fid_faulty);
+/** Complete the write of a chunk once the disk access is done
+ *
+ * @param io: the chunk write context
+ * @param nb_write: the number of bytes written or -1 (errno is set)
+ * @param *file_size: size of file after the write operation.
+ * @param *is_fid_faulty: returns whether a fault is localized in the file
+ *
+ * @return: the length written on success, -1 otherwise (errno is set)
+ */
+int storage_write_chunk_complete(storage_chunk_io_t * io, ssize_t nb_write, 
+                                 uint64_t *file_size, int * is_fid_faulty);
+/** Prepare the read of nb_proj projections in a chunk: locate and open the 
+ *  chunk file. The read itself is described by fd, offset, length and vector 
+ *  in the context.
+ *
+ * @param io: the chunk read context to fill
+ * Other parameters are those of storage_read_chunk
+ *
+ * @return: STORAGE_CHUNK_IO_SUBMIT, STORAGE_CHUNK_IO_DONE (io->status is the
+ *          result of the read) or STORAGE_CHUNK_IO_ERROR (errno is set)
+ */
+int storage_read_chunk_prepare(storage_chunk_io_t * io, storage_t * st, storio_device_mapping_t * fidCtx, 
+        uint8_t layout, uint32_t bsize, sid_t * dist_set,
+        uint8_t spare, fid_t fid, uint8_t chunk, bid_t bid, uint32_t nb_proj,
+        bin_t * bins, size_t * len_read, int * is_fid_faulty);
+/** Run synchronously the disk access of a prepared chunk read. 
+ *  O_DIRECT accesses go through an aligned bounce buffer.
+ *
+ * @param io: the chunk read context
+ *
+ * @return: the number of bytes read or -1 (errno is set)
+ */
+ssize_t storage_chunk_io_read(storage_chunk_io_t * io);
+/** Run synchronously the disk access of a prepared chunk write. 
+ *  O_DIRECT accesses go through an aligned bounce buffer, the unaligned
+ *  head and tail being read from disk first.
+ *
+ * @param io: the chunk write context
+ *
+ * @return: the number of bytes written or -1 (errno is set)
+ */
+ssize_t storage_chunk_io_write(storage_chunk_io_t * io);
+/** Complete the read of a chunk once the disk access is done: check the CRC32
+ *
+ * @param io: the chunk read context
+ * @param nb_read: the number of bytes read or -1 (errno is set)
+ * @param *len_read: the length read.
+ * @param *file_size: size of file after the read operation.
+ * @param *is_fid_faulty: returns whether a fault is localized in the file
+ *
+ * @return: the length read on success, -1 otherwise (errno is set)
+ */
+int storage_read_chunk_complete(storage_chunk_io_t * io, ssize_t nb_read, 
+                                size_t * len_read, uint64_t *file_size, int * is_fid_faulty);
+
 /** Write nb_proj projections
  *
  * @param st: the storage to use.
@@ -1061,6 +1171,30 @@ static inline int storage_write_repair(storage_t * st, uint8_t * device, uint8_t
 int storage_read_chunk(storage_t * st, storio_device_mapping_t * fidCtx, uint8_t layout, uint32_t bsize, sid_t * dist_set,
         uint8_t spare, fid_t fid, uint8_t chunk, bid_t bid, uint32_t nb_proj,
         bin_t * bins, size_t * len_read, uint64_t *file_size,int * is_fid_faulty) ;
+/** Pad with 0 the end of a single chunk read
+ *
+ *  When this chunk is not the last one and we have read less than requested
+ *  one has to pad with 0 the missing data (whole in file)
+ *
+ * @param fidCtx: FID context that contains the array of devices allocated for the 128 chunks
+ * @param chunk: the chunk that has been read
+ * @param *bins: the bins read
+ * @param *len_read: the length read, updated when padding occurs
+ * @param requested: the requested length
+ */
+static inline void storage_read_chunk_pad(storio_device_mapping_t * fidCtx, int chunk, 
+                                          char * bins, size_t * len_read, int requested) {
+      if (*len_read < requested) {
+        chunk++;
+        if (chunk<ROZOFS_STORAGE_MAX_CHUNK_PER_FILE) {          
+          if (fidCtx->device[chunk] != ROZOFS_EOF_CHUNK) {
+	    bins += *len_read;
+	    memset(bins,0,requested-*len_read);
+	    *len_read = requested;
+	  }  
+        }
+      }	      
+}
 static inline int storage_read(storage_t * st, storio_device_mapping_t * fidCtx, uint8_t layout, uint32_t bsize, sid_t * dist_set,
         uint8_t spare, fid_t fid, bid_t input_bid, uint32_t input_nb_proj,
         bin_t * bins, size_t * len_read, uint64_t *file_size,int * is_fid_faulty) {
@@ -1092,20 +1226,7 @@ static inline int storage_read(storage_t * st, storio_device_mapping_t * fidCtx,
         dbg("read error len %d errno %s",*len_read,strerror(errno));			     
         return -1;
       }
-      /*
-      ** When this chunk is not the last one and we have read less than requested
-      ** one has to pad with 0 the missing data (whole in file)
-      */
-      if (*len_read < ret1) {
-        chunk++;
-        if (chunk<ROZOFS_STORAGE_MAX_CHUNK_PER_FILE) {          
-          if (fidCtx->device[chunk] != ROZOFS_EOF_CHUNK) {
-	    pBins += *len_read;
-	    memset(pBins,0,ret1-*len_read);
-	    *len_read = ret1;
-	  }  
-        }
-      }	      
+      storage_read_chunk_pad(fidCtx, chunk, pBins, len_read, ret1);
       dbg("read success len %d",*len_read);			           	
       return 0;				  
     }  
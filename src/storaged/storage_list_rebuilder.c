@@ -70,12 +70,7 @@ static int sid        = -1;     /* Sid to rebuild within the cluster id */
 static int rebuildRef = -1;     /* Rebuild process reference */
 static int instance   = -1;     /* List rebuilder instance within the rebuild process */
 static int throughput = 0;      /* Rebuild throughput limitation in MB/s */
-
-/*
-** For enforcing throughput limitation
-*/
-extern uint64_t totalReadSize;
-static uint64_t startTime     = 0;
+static char * rebuild_dir = NULL; /* Rebuild directory when not the local one */
 
 
 char        rebuild_directory_path[FILENAME_MAX]; 
@@ -84,7 +79,6 @@ char        statFilename[FILENAME_MAX];
  
 static rbs_storage_config_t storage_config;
 
-uint8_t prj_id_present[ROZOFS_SAFE_MAX];
 int         quiet=0;
 
 
@@ -144,6 +138,11 @@ typedef struct rbs_error_t {
 
 static RBS_ERROR_T rbs_error = {0};
 
+/*
+** The counters are incremented by every rebuild thread
+*/
+#define RBS_ERROR_INC(x) __atomic_fetch_add(&rbs_error.x,1,__ATOMIC_RELAXED)
+
 #define RBS_DISPLAY_ERROR(x) {if (rbs_error.x) REBUILD_MSG("%20s = %llu", #x, (long long unsigned int) rbs_error.x);}
 
 void display_rbs_errors() {
@@ -200,49 +199,301 @@ static inline uint64_t get_us(uint64_t from) {
 }
 /*-----------------------------------------------------------------------------
 **
-** Enforce the requested throughput
+** Token bucket enforcing the throughput limitation of the whole process
+**
+** The bucket is credited with <throughput> bytes per micro second, up to
+** RBS_TOKEN_BUCKET_BURST_US of credit, and debited by every read of every
+** rebuild thread. Only the thread that puts the bucket in debt waits for its
+** own debt to be paid back, while the other threads go on with their reads.
 **
 **----------------------------------------------------------------------------
 */
-static inline void enforce_throughput() {
-  uint64_t   delay;
-  uint64_t   enforcement_delay;
-  
+#define RBS_TOKEN_BUCKET_BURST_US  100000
+
+static pthread_mutex_t rbs_token_bucket_lock = PTHREAD_MUTEX_INITIALIZER;
+static int64_t         rbs_token_bucket      = 0;
+static uint64_t        rbs_token_bucket_us   = 0;
+
+static void rbs_token_bucket_init() {
+  rbs_token_bucket    = (int64_t)RBS_TOKEN_BUCKET_BURST_US * throughput;
+  rbs_token_bucket_us = get_us(0);
+}
+
+static void rbs_token_bucket_take(uint64_t size) {
+  uint64_t   now;
+  int64_t    debt = 0;
+  int64_t    burst;
+
   /*
   ** No throughput limitation
   */
-  if (throughput == 0) return;
+  if ((throughput == 0) || (size == 0)) return;
+
+  burst = (int64_t)RBS_TOKEN_BUCKET_BURST_US * throughput;
+
+  pthread_mutex_lock(&rbs_token_bucket_lock);
 
   /*
-  ** Nothing yet read
-  */
-  if (totalReadSize == 0) return;
-  
-  /*
-  ** Compute delay from the start time
+  ** Credit the time elapsed since the last update
   */
-  delay = get_us(startTime);
-  
+  now = get_us(0);
+  if (now > rbs_token_bucket_us) {
+    rbs_token_bucket += (now - rbs_token_bucket_us) * throughput;
+    if (rbs_token_bucket > burst) rbs_token_bucket = burst;
+  }
+  rbs_token_bucket_us = now;
+
   /*
-  ** Compute the time credit for the size read 
+  ** Debit what has been read
   */
-  enforcement_delay = totalReadSize / throughput;
-  
+  rbs_token_bucket -= size;
+  if (rbs_token_bucket < 0) {
+    debt = -rbs_token_bucket;
+  }
+
+  pthread_mutex_unlock(&rbs_token_bucket_lock);
+
   /*
-  ** Check we are not ready too fast.
+  ** Wait for the debt to be paid back.
   ** If we are less than 10ms too fast just go ahead...
   */
-  if (enforcement_delay >= (delay + 10000L)) {
-    usleep(enforcement_delay-delay);
+  if (debt >= (10000L * throughput)) {
+    usleep(debt / throughput);
   }
 }
 /*-----------------------------------------------------------------------------
 **
+** Rebuild engine
+**
+** The main thread reads the job list and gives each FID to one of the
+** rebuild_fid_parallel rebuild threads. Each rebuild thread has its own
+** connections to the storages of the cluster, so that many reads are in 
+** flight on the storios, and regenerates the missing projections itself. 
+** When rebuild_write_queue is set, the regenerated projections are queued 
+** to a writer thread that has its own connection to the rebuilt storio, 
+** while the rebuild thread reads and decodes the next block range.
+** The results go back to the main thread, which is the only one to update 
+** the job list and statistics files, so a rebuild resumes as before.
+**
+**----------------------------------------------------------------------------
+*/
+typedef enum _rbs_job_state_e {
+  RBS_JOB_IDLE,
+  RBS_JOB_TODO,
+  RBS_JOB_DONE
+} RBS_JOB_STATE_E;
+
+/*
+** A block range waiting for being written on the rebuilt storio
+*/
+typedef struct _rbs_write_req_t {
+  uint8_t       layout;
+  uint32_t      bsize;
+  uint8_t       spare;
+  sid_t         dist_set[ROZOFS_SAFE_MAX];
+  fid_t         fid;
+  uint32_t      bid;
+  uint32_t      nb_proj;
+  bin_t       * bins;         /* Freed by the writer thread */
+  uint32_t      rebuild_ref;
+} rbs_write_req_t;
+
+typedef struct _rbs_writer_t {
+  pthread_t         thread;
+  pthread_mutex_t   lock;
+  pthread_cond_t    cond;
+  list_t            cluster_entries; /* Only connected to the rebuilt storage */
+  sclient_t       * storage;
+  rbs_write_req_t * queue;           /* Circular queue of rebuild_write_queue requests */
+  int               size;
+  int               head;
+  int               count;
+  int               error;           /* errno of the first failed write */
+  uint32_t          error_bid;       /* first block of the first failed write */
+  int               stop;
+} rbs_writer_t;
+
+typedef struct _rbs_thread_t {
+  int                           idx;
+  pthread_t                     thread;
+  list_t                        cluster_entries;
+  int                           available;  /* Number of storages connected */
+  int                           async_write;
+  rbs_writer_t                  writer;
+  
+  RBS_JOB_STATE_E               state;
+  uint64_t                      offset;      /* Entry offset in the job list */
+  int                           entry_size;
+  rozofs_rebuild_entry_file_t   file_entry;
+  rozofs_rebuild_entry_file_t   file_entry_saved;
+  int                           restored;    /* The entry could be processed */
+  int                           spare;
+  int                           ret;
+  uint32_t                      block_start;
+  uint64_t                      size_written;
+  uint64_t                      size_read;
+} rbs_thread_t;
+
+static rbs_thread_t  * rbs_threads    = NULL;
+static int             rbs_threads_nb = 0;
+static int             rbs_threads_stop = 0;
+static pthread_mutex_t rbs_job_lock   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  rbs_job_todo   = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  rbs_job_done   = PTHREAD_COND_INITIALIZER;
+/*-----------------------------------------------------------------------------
+**
+** Writer thread of a rebuild thread
+**
+**----------------------------------------------------------------------------
+*/
+static void * rbs_writer_thread(void * arg) {
+  rbs_writer_t    * w = arg;
+  rbs_write_req_t * req;
+  int               ret;
+  int               error = 0;
+  int               failed;
+
+  pthread_mutex_lock(&w->lock);
+  
+  while (1) {
+  
+    while ((w->count == 0) && (w->stop == 0)) {
+      pthread_cond_wait(&w->cond, &w->lock);
+    }
+    if (w->count == 0) break;
+    
+    req = &w->queue[w->head];
+    failed = w->error;
+    pthread_mutex_unlock(&w->lock);
+
+    /*
+    ** Once a write has failed, the following ones are dropped
+    ** until the rebuild thread gets the error
+    */
+    ret = 0;
+    if (failed == 0) {
+      ret = sclient_write_rbs(w->storage, storage_config.cid, storage_config.sid,
+	                      req->layout, req->bsize, req->spare,
+			      req->dist_set, req->fid,
+			      req->bid, req->nb_proj,
+			      req->bins,
+			      req->rebuild_ref);
+      if (ret < 0) error = errno;			      
+    }
+    free(req->bins);
+    req->bins = NULL;
+    
+    pthread_mutex_lock(&w->lock);
+    if ((ret < 0) && (w->error == 0)) {
+      w->error     = error;
+      w->error_bid = req->bid;
+    }
+    w->head = (w->head + 1) % w->size;
+    w->count--;
+    pthread_cond_broadcast(&w->cond);
+  }
+  
+  pthread_mutex_unlock(&w->lock);
+  return NULL;
+}
+/*-----------------------------------------------------------------------------
+**
+** Write regenerated projections on the rebuilt storio
+**
+** When the rebuild thread has a writer, the bins are given to it and *bins
+** is reset, else they are written synchronously. 
+**
+** @retval 0 on success, -1 on a write error (errno is set)
+**
+**----------------------------------------------------------------------------
+*/
+static int rbs_write_proj(rbs_thread_t * th, sclient_t * storage, 
+                          uint8_t layout, uint32_t bsize, uint8_t spare, 
+                          sid_t dist_set[ROZOFS_SAFE_MAX], fid_t fid, 
+			  uint32_t bid, uint32_t nb_proj, 
+			  bin_t ** bins, uint32_t rebuild_ref) {
+  rbs_writer_t    * w = &th->writer;
+  rbs_write_req_t * req;
+
+  if (th->async_write == 0) {
+    return sclient_write_rbs(storage, storage_config.cid, storage_config.sid,
+	                     layout, bsize, spare, dist_set, fid, bid, nb_proj,
+			     *bins, rebuild_ref);
+  }
+  
+  pthread_mutex_lock(&w->lock);
+  
+  while ((w->count == w->size) && (w->error == 0)) {
+    pthread_cond_wait(&w->cond, &w->lock);
+  }
+  if (w->error) {
+    pthread_mutex_unlock(&w->lock);
+    errno = w->error;
+    return -1;
+  }
+  
+  req = &w->queue[(w->head + w->count) % w->size];
+  req->layout      = layout;
+  req->bsize       = bsize;
+  req->spare       = spare;
+  memcpy(req->dist_set, dist_set, sizeof (sid_t) * ROZOFS_SAFE_MAX);
+  memcpy(req->fid, fid, sizeof (fid_t));
+  req->bid         = bid;
+  req->nb_proj     = nb_proj;
+  req->bins        = *bins;
+  req->rebuild_ref = rebuild_ref;
+  *bins = NULL;
+  
+  w->count++;
+  pthread_cond_broadcast(&w->cond);
+  pthread_mutex_unlock(&w->lock);
+  return 0;
+}
+/*-----------------------------------------------------------------------------
+**
+** Wait for every queued projection to be written
+**
+** @param th          The rebuild thread
+** @param failed_bid  When not NULL, lowered to the first block of the 
+**                    failed write if any
+**
+** @retval 0 on success, -1 when a queued write has failed (errno is set)
+**
+**----------------------------------------------------------------------------
+*/
+static int rbs_write_drain(rbs_thread_t * th, uint32_t * failed_bid) {
+  rbs_writer_t * w = &th->writer;
+  int            error;
+
+  if (th->async_write == 0) return 0;
+  
+  pthread_mutex_lock(&w->lock);
+  
+  while (w->count != 0) {
+    pthread_cond_wait(&w->cond, &w->lock);
+  }
+  error = w->error;
+  if ((error) && (failed_bid) && (w->error_bid < *failed_bid)) {
+    *failed_bid = w->error_bid;
+  }
+  w->error = 0;
+  
+  pthread_mutex_unlock(&w->lock);
+  
+  if (error) {
+    errno = error;
+    return -1;
+  }
+  return 0;
+}
+/*-----------------------------------------------------------------------------
+**
 ** Spare ile rebuilding
 **
 **----------------------------------------------------------------------------
 */
-RBS_EXE_CODE_E rbs_restore_one_spare_entry(rbs_storage_config_t * st, 
+RBS_EXE_CODE_E rbs_restore_one_spare_entry(rbs_thread_t    * th,
+                                           rbs_storage_config_t * st, 
                                            uint8_t           layout,
                                 	   int               local_idx, 
 			        	   int               relocate,
@@ -259,6 +510,7 @@ RBS_EXE_CODE_E rbs_restore_one_spare_entry(rbs_storage_config_t * st,
     rbs_storcli_ctx_t working_ctx;
     int block_idx = 0;
     uint8_t rbs_prj_idx_table[ROZOFS_SAFE_MAX];
+    uint8_t prj_id_present[ROZOFS_SAFE_MAX];
     int     count;
     rbs_inverse_block_t * pBlock;
     int prj_count;
@@ -308,11 +560,11 @@ RBS_EXE_CODE_E rbs_restore_one_spare_entry(rbs_storage_config_t * st,
       if (rebuild_ref == 0) {
 	remove_file = 0;
 	if (errno == EAGAIN) {
-	  rbs_error.spare_start_again++;
+	  RBS_ERROR_INC(spare_start_again);
 	  *error = rozofs_rbs_error_file_to_much_running_rebuild;
 	}  
 	else {
-	  rbs_error.spare_start++;
+	  RBS_ERROR_INC(spare_start);
 	  *error = rozofs_rbs_error_rebuild_start_failed;
         }	  
 	goto out;
@@ -341,23 +593,24 @@ RBS_EXE_CODE_E rbs_restore_one_spare_entry(rbs_storage_config_t * st,
 	    requested_blocks = (block_end-*block_start+1);
 	  }
 
-          /*
-	  ** Enforce throughput limitation
-	  */
-          enforce_throughput();
-
           // Read every available bins
+          uint64_t size_read_before = *size_read;
 	  ret = rbs_read_all_available_proj(re->storages, spare_idx, layout, bsize, st->cid,
                                 	    re->dist_set_current, re->fid, *block_start,
                                 	    requested_blocks, &nb_blocks_read_distant,
                                 	    &working_ctx,
 					    size_read);
 
+          /*
+	  ** Enforce throughput limitation
+	  */
+          rbs_token_bucket_take(*size_read - size_read_before);
+
 	  // Reading at least inverse projection has failed				  
           if (ret != 0) {
               remove_file = 0;// Better keep the file	
               errno = EIO;
- 	      rbs_error.spare_read++;
+ 	      RBS_ERROR_INC(spare_read);
 	      *error = rozofs_rbs_error_read_error;		      
               goto out;
           }
@@ -370,7 +623,7 @@ RBS_EXE_CODE_E rbs_restore_one_spare_entry(rbs_storage_config_t * st,
 	     ** File has been deleted
 	     */
 	     errno = ENOENT;
-	     rbs_error.spare_read_enoent++;
+	     RBS_ERROR_INC(spare_read_enoent);
 	     status = RBS_EXE_ENOENT;
 	     //rozofs_fid2string(re->fid,fidString);
 	     //warning("@rozofs_uuid@%s has no projection available",fidString); 
@@ -391,7 +644,7 @@ RBS_EXE_CODE_E rbs_restore_one_spare_entry(rbs_storage_config_t * st,
 	      if (count < 0) {
                   remove_file = 0;// Better keep the file	    
         	  errno = EIO;
-		  rbs_error.spare_read_no_enough++;
+		  RBS_ERROR_INC(spare_read_no_enough);
 	          *error = rozofs_rbs_error_not_enough_projection_read;	  
         	  goto out;	      
 	      }
@@ -409,21 +662,21 @@ RBS_EXE_CODE_E rbs_restore_one_spare_entry(rbs_storage_config_t * st,
                  memset(pforward,0,rozofs_msg_psize);
 		 
         	 // Store the projection localy	
-        	 ret = sclient_write_rbs(re->storages[spare_idx], st->cid, st->sid,
-	                        	 layout, bsize, 1 /* Spare */,
-					 re->dist_set_current, re->fid,
-					 *block_start+block_idx, 1,
-					 (const bin_t *)pforward,
-					 rebuild_ref);
+        	 ret = rbs_write_proj(th, re->storages[spare_idx],
+	                              layout, bsize, 1 /* Spare */,
+				      re->dist_set_current, re->fid,
+				      *block_start+block_idx, 1,
+				      (bin_t **)&pforward,
+				      rebuild_ref);
         	 remove_file = 0;	// This file must exist   
         	 if (ret < 0) {
 		   if (errno == EAGAIN) {
-		     rbs_error.spare_write_broken++;
+		     RBS_ERROR_INC(spare_write_broken);
 		     status = RBS_EXE_BROKEN;
 		     *error = rozofs_rbs_error_rebuild_broken;
 		   }
 		   else {
-		     rbs_error.spare_write_empty++;
+		     RBS_ERROR_INC(spare_write_empty);
 		     *error = rozofs_rbs_error_write_failed;		     
 		   }
                    goto out;
@@ -508,21 +761,21 @@ RBS_EXE_CODE_E rbs_restore_one_spare_entry(rbs_storage_config_t * st,
               rozofs_bins_foot_p->timestamp          = pBlock->timestamp;	
 
               // Store the projection localy	
-              ret = sclient_write_rbs(re->storages[spare_idx], st->cid, st->sid,
-	                              layout, bsize, 1 /* Spare */,
-				      re->dist_set_current, re->fid,
-				      *block_start+block_idx, 1,
-				      (const bin_t *)rozofs_bins_hdr_p,
-				      rebuild_ref);
+              ret = rbs_write_proj(th, re->storages[spare_idx],
+	                           layout, bsize, 1 /* Spare */,
+				   re->dist_set_current, re->fid,
+				   *block_start+block_idx, 1,
+				   (bin_t **)&pforward,
+				   rebuild_ref);
               remove_file = 0;// This file must exist		   
               if (ret < 0) {
 		if (errno == EAGAIN) {
-		  rbs_error.spare_write_broken++;
+		  RBS_ERROR_INC(spare_write_broken);
 		  status = RBS_EXE_BROKEN;
 		  *error = rozofs_rbs_error_rebuild_broken;		  
 		}
 		else {
-		  rbs_error.spare_write_proj++;
+		  RBS_ERROR_INC(spare_write_proj);
         	  severe("sclient_write_rbs failed %s", strerror(errno));
 		  *error = rozofs_rbs_error_write_failed;		  		  		  
 		}
@@ -534,6 +787,22 @@ RBS_EXE_CODE_E rbs_restore_one_spare_entry(rbs_storage_config_t * st,
 	  *block_start += nb_blocks_read_distant;
 
       }	
+
+      /*
+      ** Wait for the queued projections of the chunk being written
+      */
+      if (rbs_write_drain(th, NULL) < 0) {
+	if (errno == EAGAIN) {
+	  RBS_ERROR_INC(spare_write_broken);
+	  status = RBS_EXE_BROKEN;
+	  *error = rozofs_rbs_error_rebuild_broken;		  
+	}
+	else {
+	  RBS_ERROR_INC(spare_write_proj);
+	  *error = rozofs_rbs_error_write_failed;		  		  		  
+	}
+        goto out;	      
+      }	
       
       if (remove_file) {
 	ret = sclient_remove_chunk_rbs(re->storages[local_idx], st->cid, st->sid, layout, 
@@ -562,6 +831,11 @@ RBS_EXE_CODE_E rbs_restore_one_spare_entry(rbs_storage_config_t * st,
 out:
 
     *block_start = chunk * block_per_chunk;    
+
+    /*
+    ** Nothing may be written after the rebuild stop
+    */
+    rbs_write_drain(th, NULL);
     
     if (rebuild_ref != 0) {
       sclient_rebuild_stop_rbs(re->storages[local_idx], st->cid, st->sid, re->fid, 
@@ -611,7 +885,8 @@ out:
         memset(&working_ctx, 0, sizeof (working_ctx));
 	
 
-RBS_EXE_CODE_E rbs_restore_one_rb_entry(rbs_storage_config_t * st, 
+RBS_EXE_CODE_E rbs_restore_one_rb_entry(rbs_thread_t    * th,
+                                        rbs_storage_config_t * st, 
                                         uint8_t           layout,
                         		int               local_idx, 
 					int               relocate,
@@ -647,11 +922,11 @@ RBS_EXE_CODE_E rbs_restore_one_rb_entry(rbs_storage_config_t * st,
 					    *block_start, block_end);
     if (rebuild_ref == 0) {
       if (errno == EAGAIN) {
-        rbs_error.nom_start_again++;
+        RBS_ERROR_INC(nom_start_again);
 	*error = rozofs_rbs_error_file_to_much_running_rebuild;
       }
       else {
-        rbs_error.nom_start++;
+        RBS_ERROR_INC(nom_start);
 	*error = rozofs_rbs_error_rebuild_start_failed;	
       }
       goto out;
@@ -667,20 +942,21 @@ RBS_EXE_CODE_E rbs_restore_one_rb_entry(rbs_storage_config_t * st,
 	  requested_blocks = (block_end-*block_start+1);
 	}
 
-        /*
-	** Enforce throughput limitation
-	*/
-        enforce_throughput();
-
         // Try to read blocks on others storages
+        uint64_t size_read_before = *size_read;
         ret = rbs_read_blocks(re->storages, local_idx, layout, bsize, st->cid,
                 	      re->dist_set_current, re->fid, *block_start,
                 	      requested_blocks, &nb_blocks_read_distant, retries,
                 	      &working_ctx,
 			      size_read);
 
+        /*
+	** Enforce throughput limitation
+	*/
+        rbs_token_bucket_take(*size_read - size_read_before);
+
         if (ret != 0) {
-	  rbs_error.nom_read++;
+	  RBS_ERROR_INC(nom_read);
 	  *error = rozofs_rbs_error_read_error;	
 	  goto out;
 	}
@@ -688,7 +964,7 @@ RBS_EXE_CODE_E rbs_restore_one_rb_entry(rbs_storage_config_t * st,
         if (nb_blocks_read_distant == -1) { // File deleted
 	   //char fidString[64];
 	   status = RBS_EXE_ENOENT;
-	   rbs_error.nom_read_enoent++;
+	   RBS_ERROR_INC(nom_read_enoent);
 	   //rozofs_fid2string(re->fid,fidString);
 	   //warning("@rozofs_uuid@%s has no projection available",fidString);
 	   goto out;
@@ -719,7 +995,7 @@ RBS_EXE_CODE_E rbs_restore_one_rb_entry(rbs_storage_config_t * st,
                 			     working_ctx.data_read_p);
         if (ret != 0) {
             severe("rbs_transform_forward_one_proj failed: %s",strerror(errno));
-	    rbs_error.nom_transform++;
+	    RBS_ERROR_INC(nom_transform);
 	    *error = rozofs_rbs_error_transform_error;
             goto out;
         }
@@ -740,31 +1016,45 @@ RBS_EXE_CODE_E rbs_restore_one_rb_entry(rbs_storage_config_t * st,
 #endif
 	
         // Store the projection localy	
-        ret = sclient_write_rbs(re->storages[local_idx], st->cid, st->sid,
-	                        layout, bsize, 0 /* Not spare */,
-				re->dist_set_current, re->fid,
-				*block_start, nb_blocks_read_distant,
-				working_ctx.prj_ctx[proj_id_to_rebuild].bins,
-				rebuild_ref);
-	if (ret < 0) {
-	  if (errno == EAGAIN) {
-	    rbs_error.nom_write_broken++;
-	    status = RBS_EXE_BROKEN;
-	    *error = rozofs_rbs_error_rebuild_broken;
-	  }
-	  else {
-	    rbs_error.nom_write++;
-	    *error = rozofs_rbs_error_write_failed;	    
-            severe("sclient_write_rbs failed: %s", strerror(errno));
-	  }
-          goto out;
-        }
+        ret = rbs_write_proj(th, re->storages[local_idx],
+	                     layout, bsize, 0 /* Not spare */,
+			     re->dist_set_current, re->fid,
+			     *block_start, nb_blocks_read_distant,
+			     &working_ctx.prj_ctx[proj_id_to_rebuild].bins,
+			     rebuild_ref);
+	if (ret < 0) goto write_error;
 	*size_written += (nb_blocks_read_distant * (rozofs_disk_psize+3) * 8);
 				
 	*block_start += nb_blocks_read_distant;	             
     }
+    
+    /*
+    ** Wait for the queued projections being written
+    */
+    if (rbs_write_drain(th, block_start) < 0) goto write_error;
+    
     status = RBS_EXE_SUCCESS;
+    goto out;
+    
+write_error:
+    if (errno == EAGAIN) {
+      RBS_ERROR_INC(nom_write_broken);
+      status = RBS_EXE_BROKEN;
+      *error = rozofs_rbs_error_rebuild_broken;
+    }
+    else {
+      RBS_ERROR_INC(nom_write);
+      *error = rozofs_rbs_error_write_failed;	    
+      severe("sclient_write_rbs failed: %s", strerror(errno));
+    }
+        
 out:
+    /*
+    ** Nothing may be written after the rebuild stop. The rebuild resumes 
+    ** from the first block range whose write has failed.
+    */
+    rbs_write_drain(th, block_start);
+    
     if (rebuild_ref != 0) {
       sclient_rebuild_stop_rbs(re->storages[local_idx], st->cid, st->sid, re->fid, rebuild_ref, 
                                (status==0)?SP_SUCCESS:SP_FAILURE);
@@ -840,6 +1130,431 @@ int check_fid_deleted_from_export(fid_t fid) {
 }
 /*-----------------------------------------------------------------------------
 **
+** Rebuild the FID given to a rebuild thread
+**
+**----------------------------------------------------------------------------
+*/
+static void rbs_thread_rebuild(rbs_thread_t * th) {
+  rozofs_rebuild_entry_file_t * file_entry = &th->file_entry;
+  rb_entry_t re;
+  uint8_t    rozofs_safe,rozofs_forward,rozofs_inverse; 
+  uint8_t    prj;
+  int        local_index;    
+
+  th->restored     = 0;
+  th->size_written = 0;
+  th->size_read    = 0;
+  th->block_start  = file_entry->block_start;
+
+  rozofs_inverse = rozofs_get_rozofs_inverse(file_entry->layout);  
+  rozofs_safe    = rozofs_get_rozofs_safe(file_entry->layout);
+  rozofs_forward = rozofs_get_rozofs_forward(file_entry->layout);
+
+  if (th->available<rozofs_inverse) {
+    /*
+    ** Not possible to rebuild any thing
+    */
+    file_entry->error = rozofs_rbs_error_not_enough_storages_up;
+    return;
+  }
+
+  memcpy(re.fid,file_entry->fid, sizeof(re.fid));
+  memcpy(re.dist_set_current,file_entry->dist_set_current, sizeof(re.dist_set_current));
+  re.bsize  = file_entry->bsize;
+  re.layout = file_entry->layout;
+
+  // Get storage connections for this entry
+  local_index = rbs_get_rb_entry_cnts(&re, 
+                            &th->cluster_entries, 
+                            storage_config.cid, 
+			    storage_config.sid,
+                            rozofs_inverse);
+  if (local_index == -1) {
+    if      (errno==EINVAL) file_entry->error = rozofs_rbs_error_no_such_cluster;
+    else if (errno==EPROTO) file_entry->error = rozofs_rbs_error_not_enough_storages_up;
+    else {                  
+      file_entry->error = rozofs_rbs_error_unknown;
+      severe( "rbs_get_rb_entry_cnts failed cid/sid %d/%d %s", 
+	          storage_config.cid,
+			  storage_config.sid,
+			  strerror(errno));
+    }                            
+    return;
+  }
+
+  // Compute the proj_id to rebuild
+  // Check if the storage to rebuild is
+  // a spare for this entry
+  for (prj = 0; prj < rozofs_safe; prj++) {
+      if (re.dist_set_current[prj] == storage_config.sid)  break;
+  }  
+  if (prj >= rozofs_forward) th->spare = 1;
+  else                       th->spare = 0;
+
+  // Restore this entry
+  if (th->spare == 1) {
+    th->ret = rbs_restore_one_spare_entry(th, &storage_config,
+	                                  file_entry->layout, local_index, file_entry->relocate,
+                                          &th->block_start, file_entry->block_end, 
+					  &re, prj,
+					  &th->size_written,
+					  &th->size_read,
+					  &file_entry->error);     
+  }
+  else {
+    th->ret = rbs_restore_one_rb_entry(th, &storage_config, 
+	                               file_entry->layout, local_index, file_entry->relocate,
+                                       &th->block_start, file_entry->block_end, 
+				       &re, prj, 
+				       &th->size_written,
+				       &th->size_read,
+				       &file_entry->error);
+  } 
+  th->restored = 1;
+}
+/*-----------------------------------------------------------------------------
+**
+** Rebuild thread
+**
+**----------------------------------------------------------------------------
+*/
+static void * rbs_thread(void * arg) {
+  rbs_thread_t * th = arg;
+  
+  pthread_mutex_lock(&rbs_job_lock);
+  
+  while (1) {
+  
+    while ((th->state != RBS_JOB_TODO) && (rbs_threads_stop == 0)) {
+      pthread_cond_wait(&rbs_job_todo, &rbs_job_lock);
+    }
+    if (th->state != RBS_JOB_TODO) break;
+    
+    pthread_mutex_unlock(&rbs_job_lock);
+    
+    rbs_thread_rebuild(th);
+    
+    pthread_mutex_lock(&rbs_job_lock);
+    th->state = RBS_JOB_DONE;
+    pthread_cond_signal(&rbs_job_done);
+  }
+  
+  pthread_mutex_unlock(&rbs_job_lock);
+  return NULL;
+}
+/*-----------------------------------------------------------------------------
+**
+** Start the writer thread of a rebuild thread with its own connection
+** to the rebuilt storage
+**
+** @retval 0 on success / -1 when the projections are to be written synchronously
+**
+**----------------------------------------------------------------------------
+*/
+static int rbs_writer_start(rbs_thread_t * th, list_t * cluster_entries) {
+  rbs_writer_t * w = &th->writer;
+  list_t       * p, * q;
+  int            ret;
+
+  memset(w, 0, sizeof(rbs_writer_t));
+  list_init(&w->cluster_entries);
+  
+  if (common_config.rebuild_write_queue == 0) return -1;
+  
+  rbs_copy_cluster_list(cluster_entries, &w->cluster_entries, storage_config.cid);
+
+  list_for_each_forward(p, &w->cluster_entries) {
+  
+    rb_cluster_t *clu = list_entry(p, rb_cluster_t, list);
+    
+    list_for_each_forward(q, &clu->storages) {
+    
+      rb_stor_t *rb_stor = list_entry(q, rb_stor_t, list);
+      
+      if (rb_stor->sid != storage_config.sid) continue;
+      
+      if (rbs_stor_cnt_initialize(rb_stor, storage_config.cid) != 0) {
+        severe("rbs_stor_cnt_initialize cid/sid %d/%d failed: %s",
+               storage_config.cid, rb_stor->sid, strerror(errno));
+      }
+      if (rb_stor->sclients_nb != 0) {
+        w->storage = &rb_stor->sclients[th->idx % rb_stor->sclients_nb];
+      }		       
+    }
+  }
+  if (w->storage == NULL) return -1;
+  
+  w->size  = common_config.rebuild_write_queue;
+  w->queue = xmalloc(w->size * sizeof(rbs_write_req_t));
+  memset(w->queue, 0, w->size * sizeof(rbs_write_req_t));
+  pthread_mutex_init(&w->lock, NULL);
+  pthread_cond_init(&w->cond, NULL);
+
+  ret = pthread_create(&w->thread, NULL, rbs_writer_thread, w);
+  if (ret != 0) {
+    severe("pthread_create %s", strerror(ret));
+    xfree(w->queue);
+    w->queue = NULL;
+    return -1;
+  }
+  return 0;
+}
+/*-----------------------------------------------------------------------------
+**
+** Stop the writer thread of a rebuild thread and release its connections
+**
+**----------------------------------------------------------------------------
+*/
+static void rbs_thread_release(rbs_thread_t * th) {
+
+  if (th->async_write) {
+    pthread_mutex_lock(&th->writer.lock);
+    th->writer.stop = 1;
+    pthread_cond_broadcast(&th->writer.cond);
+    pthread_mutex_unlock(&th->writer.lock);
+    pthread_join(th->writer.thread, NULL);
+    xfree(th->writer.queue);
+    th->async_write = 0;
+  }
+  rbs_release_cluster_list(&th->writer.cluster_entries);
+  rbs_release_cluster_list(&th->cluster_entries);
+}
+/*-----------------------------------------------------------------------------
+**
+** Start the rebuild threads, each one with its own connections to the
+** storages of the cluster
+**
+** @param cluster_entries   The cluster description got from the export
+**
+** @retval the number of rebuild threads
+**
+**----------------------------------------------------------------------------
+*/
+static int rbs_threads_start(list_t * cluster_entries) {
+  rbs_thread_t * th;
+  int            idx;
+  int            failed;
+  int            ret;
+  
+  rbs_threads_stop = 0;
+  rbs_threads      = xmalloc(common_config.rebuild_fid_parallel * sizeof(rbs_thread_t));
+  memset(rbs_threads, 0, common_config.rebuild_fid_parallel * sizeof(rbs_thread_t));
+  
+  for (idx=0; idx < common_config.rebuild_fid_parallel; idx++) {
+  
+    th = &rbs_threads[rbs_threads_nb];
+    th->idx   = idx;
+    th->state = RBS_JOB_IDLE;
+    list_init(&th->cluster_entries);
+    
+    // Get connections for this given cluster  
+    rbs_copy_cluster_list(cluster_entries, &th->cluster_entries, storage_config.cid);
+    rbs_init_cluster_cnts(&th->cluster_entries, storage_config.cid, storage_config.sid,
+                          &failed, &th->available);
+			  
+    th->async_write = (rbs_writer_start(th, cluster_entries) == 0);
+			  
+    ret = pthread_create(&th->thread, NULL, rbs_thread, th);
+    if (ret != 0) {
+      severe("pthread_create %s", strerror(ret));
+      rbs_thread_release(th);
+      break;
+    }
+    rbs_threads_nb++;
+  }  
+  return rbs_threads_nb;  
+}
+/*-----------------------------------------------------------------------------
+**
+** Stop the rebuild threads and release their connections
+**
+**----------------------------------------------------------------------------
+*/
+static void rbs_threads_stop_all() {
+  rbs_thread_t * th;
+  int            idx;
+
+  pthread_mutex_lock(&rbs_job_lock);
+  rbs_threads_stop = 1;
+  pthread_cond_broadcast(&rbs_job_todo);
+  pthread_mutex_unlock(&rbs_job_lock);
+  
+  for (idx=0; idx < rbs_threads_nb; idx++) {
+    th = &rbs_threads[idx];
+    pthread_join(th->thread, NULL);
+    rbs_thread_release(th);
+  }
+  xfree(rbs_threads);
+  rbs_threads    = NULL;
+  rbs_threads_nb = 0;
+}
+/*-----------------------------------------------------------------------------
+**
+** Process the result of a rebuild thread: update the job list entry and
+** the statistics
+**
+** @param th          The rebuild thread that is done
+** @param fdlist      Job list file
+** @param fdstat      Statistics file
+** @param statistics  Statistics of this job list
+**
+** @retval 1 when the entry is rebuilt / 0 else
+**
+**----------------------------------------------------------------------------
+*/
+static int rbs_job_complete(rbs_thread_t * th, int fdlist, int fdstat, 
+                            ROZOFS_RBS_COUNTERS_T * statistics,
+			    int nbSuccess, int nbJobs) {
+  rozofs_rebuild_entry_file_t * file_entry = &th->file_entry;
+  int                           ret = th->ret;
+  int                           success = 0;
+  
+  if (th->restored == 0) return 0;
+  
+  /*
+  ** In case the rebuild failed, check with the export whether 
+  ** the FID still exists
+  */
+  if (ret == RBS_EXE_FAILED) {
+    if (check_fid_deleted_from_export(file_entry->fid)) {   
+      ret = RBS_EXE_ENOENT;
+    }  
+  }
+  /* 
+  ** Rebuild is successfull
+  */
+  switch(ret) {
+
+    case RBS_EXE_SUCCESS:
+    case RBS_EXE_ENOENT:	
+
+      if (ret == RBS_EXE_ENOENT) {
+	file_entry->error = rozofs_rbs_error_file_deleted;
+	statistics->deleted++;
+      }  
+      else {                      
+	file_entry->error = rozofs_rbs_error_none;
+      }
+      success = 1;
+      // Update counters in header file 
+      statistics->done_files++;
+      if (th->spare == 1) {
+        statistics->written_spare += th->size_written;
+	statistics->read_spare    += th->size_read;
+      }
+      statistics->written += th->size_written;
+      statistics->read    += th->size_read;       
+
+      if (pwrite(fdstat, statistics, sizeof(*statistics), 0)!= sizeof(*statistics)) {
+        severe("pwrite %s %s",statFilename,strerror(errno));
+      }
+
+      if (((nbSuccess+1) % (16*1024)) == 0) {
+        REBUILD_MSG("  ~ %s %d/%d",fid_list,nbSuccess+1,nbJobs);
+      } 
+      /*
+      ** This file has been rebuilt so remove it from the job list
+      */
+      file_entry->todo = 0;
+      break;
+
+
+    /*
+    ** Rebuild is failed, nevetherless some pieces of the file may have
+    ** been successfully rebuilt and needs not to be rebuilt again on a
+    ** next trial
+    */
+    default:
+      severe("Unexpected return code %d.",ret);	  
+    case RBS_EXE_FAILED:
+    case RBS_EXE_BROKEN:
+      /*
+      ** In case of file relocation, the new data chunk file has been removed 
+      ** and the previous data chunk file location has been restored
+      ** when the rebuild has failed. So we are back to the starting point of
+      ** the rebuilt and there has been no improvment...
+      ** When no relocation was requested, the block_start has increased up to 
+      ** where the rebuild has failed. These part before block_start is rebuilt 
+      ** and needs not to be redone although the glocal rebuild has failed. 
+      */
+      if (!file_entry->relocate) {
+        file_entry->block_start = th->block_start;
+      }
+      break;  
+  }
+
+  /*
+  ** Update input job file if any change
+  */
+  if (memcmp(&th->file_entry_saved, file_entry, th->entry_size) != 0) {
+    if (pwrite(fdlist, file_entry, th->entry_size, th->offset)!=th->entry_size) {
+      severe("pwrite size %lu offset %llu %s",(unsigned long int)th->entry_size, 
+             (unsigned long long int) th->offset, strerror(errno));
+    }
+  }
+  return success;
+}
+/*-----------------------------------------------------------------------------
+**
+** Process the results of the rebuild threads that are done
+**
+** @param all         Whether to wait for every rebuild thread to be done
+**                    or only for one rebuild thread to be free
+** @param fdlist      Job list file
+** @param fdstat      Statistics file
+** @param statistics  Statistics of this job list
+** @param nbSuccess   Number of entries rebuilt
+** @param nbJobs      Number of entries given to the rebuild threads
+**
+** @retval a free rebuild thread
+**
+**----------------------------------------------------------------------------
+*/
+static rbs_thread_t * rbs_job_wait(int all, int fdlist, int fdstat, 
+                                   ROZOFS_RBS_COUNTERS_T * statistics,
+			           int * nbSuccess, int nbJobs) {
+  rbs_thread_t * th;
+  rbs_thread_t * free_th;
+  int            busy;
+  int            idx;
+
+  pthread_mutex_lock(&rbs_job_lock);
+  
+  while (1) {
+  
+    free_th = NULL;
+    busy    = 0;
+    
+    for (idx=0; idx < rbs_threads_nb; idx++) {
+    
+      th = &rbs_threads[idx];
+
+      if (th->state == RBS_JOB_DONE) {
+        pthread_mutex_unlock(&rbs_job_lock);
+	*nbSuccess += rbs_job_complete(th, fdlist, fdstat, statistics, *nbSuccess, nbJobs);
+        pthread_mutex_lock(&rbs_job_lock);
+	th->state = RBS_JOB_IDLE;
+      }
+      
+      if (th->state == RBS_JOB_IDLE) {
+        if (free_th == NULL) free_th = th;
+      }
+      else {
+        busy++;
+      }
+    }
+    
+    if ((all == 0) && (free_th != NULL)) break;
+    if ((all != 0) && (busy == 0)) break;
+    
+    pthread_cond_wait(&rbs_job_done, &rbs_job_lock);
+  }
+  
+  pthread_mutex_unlock(&rbs_job_lock);
+  return free_th;
+}
+/*-----------------------------------------------------------------------------
+**
 ** Rebuild a list of FID 
 **
 ** @param   fid_list        File containing the list of FID to rebuild
@@ -859,18 +1574,11 @@ int storaged_rebuild_list(char * fid_list, char * statFilename) {
   uint64_t   next_offset;
   ROZOFS_RBS_COUNTERS_T         statistics;
   rozofs_rebuild_entry_file_t   file_entry;
-  rozofs_rebuild_entry_file_t   file_entry_saved;
   int        ret;
-  uint8_t    rozofs_safe,rozofs_forward,rozofs_inverse; 
-  uint8_t    prj;
-  int        spare;
+  uint8_t    rozofs_safe; 
   char     * pExport_hostname = NULL;
-  int        local_index=-1;    
-  rb_entry_t re;
   fid_t      null_fid={0};
-  int        failed,available;  
-  uint64_t   size_written = 0;
-  uint64_t   size_read    = 0;
+  rbs_thread_t * th;
         
   fdlist = open(fid_list,O_RDWR);
   if (fdlist < 0) {
@@ -916,8 +1624,13 @@ int storaged_rebuild_list(char * fid_list, char * statFilename) {
       goto error;
   }
     
-  // Get connections for this given cluster  
-  rbs_init_cluster_cnts(&cluster_entries, storage_config.cid, storage_config.sid,&failed,&available);
+  // Start the rebuild threads with their own connections to this cluster 
+  if (rbs_threads_start(&cluster_entries) == 0) {
+      severe("No rebuild thread could be started");
+      rbs_release_cluster_list(&cluster_entries);
+      goto error;
+  }
+  rbs_release_cluster_list(&cluster_entries);
   
   REBUILD_MSG("   -> %s rebuild start",fid_list);
   
@@ -935,9 +1648,6 @@ int storaged_rebuild_list(char * fid_list, char * statFilename) {
       break;
     } 
            
-    /*
-    ** Check that enough servers are available
-    */
     int entry_size = rbs_entry_size_from_layout(file_entry.layout);
     next_offset = offset + entry_size; 
     if (file_entry.todo == 0) continue;
@@ -946,200 +1656,45 @@ int storaged_rebuild_list(char * fid_list, char * statFilename) {
       continue;
     }
  
+    if (sigusr_received) {
+      break;
+    }    
+
+    /*
+    ** Get a free rebuild thread, processing the results of the ones 
+    ** that are done
+    */
+    th = rbs_job_wait(0, fdlist, fdstat, &statistics, &nbSuccess, nbJobs);
 
-    rozofs_inverse = rozofs_get_rozofs_inverse(file_entry.layout);  
     rozofs_safe    = rozofs_get_rozofs_safe(file_entry.layout);
-    rozofs_forward = rozofs_get_rozofs_forward(file_entry.layout);
 
     nbJobs++;
-    
-    if (available<rozofs_inverse) {
-      /*
-      ** Not possible to rebuild any thing
-      */
-      file_entry.error = rozofs_rbs_error_not_enough_storages_up;
-      continue;
-    }
 
    // Padd end of distibution with 0. Just in case...
     memset(&file_entry.dist_set_current[rozofs_safe],0,ROZOFS_SAFE_MAX-rozofs_safe); 
-    memcpy(&file_entry_saved,&file_entry,entry_size);
-
-    memcpy(re.fid,file_entry.fid, sizeof(re.fid));
-    memcpy(re.dist_set_current,file_entry.dist_set_current, sizeof(re.dist_set_current));
-    re.bsize  = file_entry.bsize;
-    re.layout = file_entry.layout;
-  
-
-    if (sigusr_received) {
-      goto error;
-    }    
-#if 0
-  {
-    char fid_string[128];
-    int i;
-    rozofs_uuid_unparse(file_entry.fid,fid_string);  
-    printf("rebuilding FID %s layout %d bsize %d from %llu to %llu dist %d",
-          fid_string,file_entry.layout, file_entry.bsize,
-         (long long unsigned int) file_entry.block_start, 
-	 (long long unsigned int) file_entry.block_end,
-	 file_entry.dist_set_current[0]);
-   for (i=1;i<rozofs_safe;i++) printf("-%d", file_entry.dist_set_current[i]);
-   printf("\n");
-  }  
-#endif
+    memcpy(&th->file_entry,&file_entry,entry_size);
+    memcpy(&th->file_entry_saved,&file_entry,entry_size);
+    th->offset     = offset;
+    th->entry_size = entry_size;
     
-
-    // Get storage connections for this entry
-    local_index = rbs_get_rb_entry_cnts(&re, 
-                              &cluster_entries, 
-                              storage_config.cid, 
-			      storage_config.sid,
-                              rozofs_inverse);
-    if (local_index == -1) {
-      if      (errno==EINVAL) file_entry.error = rozofs_rbs_error_no_such_cluster;
-      else if (errno==EPROTO) file_entry.error = rozofs_rbs_error_not_enough_storages_up;
-      else {                  
-        file_entry.error = rozofs_rbs_error_unknown;
-        severe( "rbs_get_rb_entry_cnts failed cid/sid %d/%d %s", 
-	            storage_config.cid,
-			    storage_config.sid,
-			    strerror(errno));
-      }                            
-      continue; // Try with the next
-    }
-    
-    // Compute the proj_id to rebuild
-    // Check if the storage to rebuild is
-    // a spare for this entry
-    for (prj = 0; prj < rozofs_safe; prj++) {
-        if (re.dist_set_current[prj] == storage_config.sid)  break;
-    }  
-    if (prj >= rozofs_forward) spare = 1;
-    else                       spare = 0;
-
-
-    int retry = 0; 
-    while (retry < 1) { /* reloop 3 times immediatly on broken rebuild */
-      
-      retry++; 
-     
-      size_written = 0;
-      size_read    = 0;
-      
-      // Restore this entry
-      uint32_t block_start = file_entry.block_start;
-      if (spare == 1) {
-	ret = rbs_restore_one_spare_entry(&storage_config,
-	                                  file_entry.layout, local_index, file_entry.relocate,
-                                          &block_start, file_entry.block_end, 
-					  &re, prj,
-					  &size_written,
-					  &size_read,
-					  &file_entry.error);     
-      }
-      else {
-	ret = rbs_restore_one_rb_entry(&storage_config, 
-	                               file_entry.layout, local_index, file_entry.relocate,
-                                       &block_start, file_entry.block_end, 
-				       &re, prj, 
-				       &size_written,
-				       &size_read,
-				       &file_entry.error);
-      } 
-	  
-      /*
-      ** In case the rebuild failed, check with the export whether 
-      ** the FID still exists
-      */
-      if (ret == RBS_EXE_FAILED) {
-        if (check_fid_deleted_from_export(file_entry.fid)) {   
-	  //char fidString[64];
-	  //rozofs_fid2string(re.fid,fidString);
-	  //warning("@rozofs_uuid@%s does no more exist",fidString); 	
-	  ret = RBS_EXE_ENOENT;
-	}  
-      }
-      /* 
-      ** Rebuild is successfull
-      */
-      switch(ret) {
-      
-	case RBS_EXE_SUCCESS:
-	case RBS_EXE_ENOENT:	
-	
-	  if (ret == RBS_EXE_ENOENT) {
-	    file_entry.error = rozofs_rbs_error_file_deleted;
-	    statistics.deleted++;
-	  }  
-	  else {                      
-	    file_entry.error = rozofs_rbs_error_none;
-	  }
-	  nbSuccess++;
-	  // Update counters in header file 
-	  statistics.done_files++;
-	  if (spare == 1) {
-            statistics.written_spare += size_written;
-	    statistics.read_spare    += size_read;
-	  }
-	  statistics.written += size_written;
-	  statistics.read    += size_read;       
-
-	  if (pwrite(fdstat, &statistics, sizeof(statistics), 0)!= sizeof(statistics)) {
-            severe("pwrite %s %s",statFilename,strerror(errno));
-	  }
-
-	  if ((nbSuccess % (16*1024)) == 0) {
-            REBUILD_MSG("  ~ %s %d/%d",fid_list,nbSuccess,nbJobs);
-	  } 
-	  /*
-	  ** This file has been rebuilt so remove it from the job list
-	  */
-	  file_entry.todo = 0;
-          break;
-
-
-	/*
-	** Rebuild is failed, nevetherless some pieces of the file may have
-	** been successfully rebuilt and needs not to be rebuilt again on a
-	** next trial
-	*/
-	default:
-	  severe("Unexpected return code %d.",ret);	  
-	case RBS_EXE_FAILED:
-	case RBS_EXE_BROKEN:
-	  /*
-	  ** In case of file relocation, the new data chunk file has been removed 
-	  ** and the previous data chunk file location has been restored
-	  ** when the rebuild has failed. So we are back to the starting point of
-	  ** the rebuilt and there has been no improvment...
-	  ** When no relocation was requested, the block_start has increased up to 
-	  ** where the rebuild has failed. These part before block_start is rebuilt 
-	  ** and needs not to be redone although the glocal rebuild has failed. 
-	  */
-	  if (!file_entry.relocate) {
-            file_entry.block_start = block_start;
-	  }
-	  break;  
-      }
-
-      /*
-      ** Update input job file if any change
-      */
-      if (memcmp(&file_entry_saved,&file_entry, entry_size) != 0) {
-	if (pwrite(fdlist, &file_entry, entry_size, offset)!=entry_size) {
-	  severe("pwrite size %lu offset %llu %s",(unsigned long int)entry_size, 
-        	 (unsigned long long int) offset-entry_size, strerror(errno));
-	}
-      }
-      
-      if (ret != RBS_EXE_BROKEN) break;
-      /* reloop 3 times immediatly on broken rebuild */
-    } 
+    pthread_mutex_lock(&rbs_job_lock);
+    th->state = RBS_JOB_TODO;
+    pthread_cond_broadcast(&rbs_job_todo);
+    pthread_mutex_unlock(&rbs_job_lock);
     
     /* Next file to rebuild */     
   }
   
+  /*
+  ** Wait for the files in flight
+  */
+  rbs_job_wait(1, fdlist, fdstat, &statistics, &nbSuccess, nbJobs);
+  rbs_threads_stop_all();
+  
+  if (sigusr_received) {
+    goto error;
+  }    
+  
   if (nbSuccess == nbJobs) {
     close(fdlist);
     unlink(fid_list);
@@ -1213,6 +1768,7 @@ void usage(char * fmt, ...) {
     printf("   -i, --instance\trebuild instance number.\n");    
     printf("   -q, --quiet \tDo not print.\n");    
     printf("   -t, --throughput\tThroughput limitation in MB/s.\n");    
+    printf("   -D, --dir\trebuild directory when not the default one.\n");    
 
     if (fmt) exit(EXIT_FAILURE);
     exit(EXIT_SUCCESS); 
@@ -1242,6 +1798,7 @@ int main(int argc, char *argv[]) {
         { "quiet", no_argument, 0, 'q'},
         { "instance", required_argument, 0, 'i'},	
         { "throughput", required_argument, 0, 't'},	
+        { "dir", required_argument, 0, 'D'},	
         { 0, 0, 0, 0}
     };
 
@@ -1254,7 +1811,7 @@ int main(int argc, char *argv[]) {
     while (1) {
 
       int option_index = 0;
-      c = getopt_long(argc, argv, "hH:c:s:r:i:q:f:t:", long_options, &option_index);
+      c = getopt_long(argc, argv, "hH:c:s:r:i:q:f:t:D:", long_options, &option_index);
 
       if (c == -1)
           break;
@@ -1310,6 +1867,10 @@ int main(int argc, char *argv[]) {
 	  }
 	  break;
 	  
+	case 'D':  				  
+	  rebuild_dir = optarg;
+	  break;
+	  
 	case 'q':
 	  quiet = 1;
 	  break;
@@ -1348,7 +1909,12 @@ int main(int argc, char *argv[]) {
     /*
     ** Read storage configuration file
     */
-    dir = get_rebuild_sid_directory_name(rebuildRef,cid,sid,ftype);
+    if (rebuild_dir != NULL) {
+      dir = rebuild_dir;
+    }
+    else {
+      dir = get_rebuild_sid_directory_name(rebuildRef,cid,sid,ftype);
+    }  
     if (rbs_read_storage_config_file(dir, &storage_config) == NULL) {
       usage("No storage conf file in %s",dir);
     }		
@@ -1363,10 +1929,9 @@ int main(int argc, char *argv[]) {
 
 
     /*
-    ** Gt start time to insure throughput the throughput limitation
+    ** Fill the token bucket that insures the throughput limitation
     */ 
-    totalReadSize = 0;
-    startTime     = get_us(0); 
+    rbs_token_bucket_init();
   	
     // Start rebuild storage   
     if (storaged_rebuild_list(fid_list,statFilename) != 0) goto error;    
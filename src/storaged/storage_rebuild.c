@@ -198,10 +198,23 @@ typedef struct _rbs_parameter_t {
   int      chunk;  // Chunk to rebuild when FID is given 
   rbs_file_type_e filetype; // spare/nominal/all 
   int      throughput; // spare/nominal/all 
+  int      multinode;  // Run the list rebuild processes on the other nodes of the cluster
+  int      dirty;      // Only rebuild the chunks journaled by the other storages
 } rbs_parameter_t;
 
 rbs_parameter_t parameter;
 /*
+** Nodes running the list rebuild processes in multi-node mode
+*/
+#define RBS_MAX_NODES  64
+typedef struct _rbs_node_t {
+  char     host[ROZOFS_HOSTNAME_MAX];
+  int      instances;  /* Number of list rebuild processes sent to this node */
+} rbs_node_t;
+
+static rbs_node_t rbs_nodes[RBS_MAX_NODES];
+static int        rbs_nodes_nb = 0;
+/*
 **____________________________________________________
 ** Create or re-create the monitoring file for this rebuild process
 */
@@ -271,6 +284,15 @@ static inline char * format_status_file(char * pJSON) {
     pt += rozofs_u32_padded_append(pt, 2, rozofs_zero, seconds);  
     JSON_string("delay", delay);
 
+    if (parameter.multinode) {
+      JSON_open_array("nodes");
+        for (i=0; i<rbs_nodes_nb; i++) {
+          char node_string[ROZOFS_HOSTNAME_MAX+32];
+          snprintf(node_string,sizeof(node_string),"%s (%d processes)", rbs_nodes[i].host, rbs_nodes[i].instances);
+          JSON_string_element(node_string);
+        }
+      JSON_close_array;
+    }
 
     JSON_open_array("storages");
       for (i=0; i<nb_rbs_entry; i++) {
@@ -445,6 +467,8 @@ void rbs_conf_init(rbs_parameter_t * par) {
   par->chunk                = -1;
   par->filetype             = rbs_file_type_all;
   par->throughput           = 0;
+  par->multinode            = 0;
+  par->dirty                = 0;
   
   
   par->storaged_geosite = rozofs_get_local_site();
@@ -495,6 +519,8 @@ void usage(char * fmt, ...) {
     printf("       --nominal             \tTo rebuild only nominal files on node or sid rebuild.\n");
     printf("   -g, --geosite             \tTo force site number in case of geo-replication\n");
     printf("   -R, --relocate            \tTo rebuild a device by relocating files\n");
+    printf("   -m, --multinode           \tTo run the rebuild processes on the other nodes of the cluster\n");
+    printf("       --dirty               \tTo only rebuild the chunks written while the sid was unreachable.\n");
     printf("   -l, --loop                \tNumber of reloop in case of error (default %d)\n",DEFAULT_REBUILD_RELOOP);
     printf("   -q, --quiet               \tDo not display messages\n");
     printf("   -C, --clear               \tClear the status of the device after it has been set OOS\n");
@@ -626,6 +652,16 @@ void parse_command(int argc, char *argv[], rbs_parameter_t * par) {
       continue;
     } 
 
+    if (IS_ARG(-m) || IS_ARG(--multinode)) {
+      par->multinode = 1;     
+      continue;
+    } 
+
+    if (IS_ARG(--dirty)) {
+      par->dirty = 1;     
+      continue;
+    } 
+
     if (IS_ARG(-C) || IS_ARG(--clear)) {
       par->clear = 1;     
       continue;
@@ -1895,6 +1931,285 @@ void periodic_stat_update(int * fd) {
   rbs_monitor_file_update();
 }
   
+/*
+**____________________________________________________
+** Multi-node rebuild
+**
+** The list rebuild processes are run on the other storage nodes of the 
+** cluster through ssh. They read the projections from the storages, 
+** regenerate the missing ones and write them on the storage to rebuild,
+** so that the reading and decoding load does not go through this node.
+** The job list and statistics files are copied to the node before the 
+** process starts and copied back when it ends, so a paused or failed 
+** rebuild resumes from this node as before.
+**____________________________________________________
+*/
+/*
+**____________________________________________________
+** Append the ssh or scp command with the configured options
+*/
+static inline char * rbs_ssh_append(char * pChar, int scp) {
+
+  if (scp) pChar += sprintf(pChar,"scp -q ");
+  else     pChar += sprintf(pChar,"ssh ");
+  
+  if (common_config.ssh_port) {
+    pChar += sprintf(pChar, scp ? "-P %d " : "-p %d ", common_config.ssh_port);
+  }		   
+  if (strcmp(common_config.ssh_param,"")!=0) {
+    pChar += sprintf(pChar,"%s ",common_config.ssh_param);
+  }	
+  return pChar;
+}
+/*
+**____________________________________________________
+** Get the storage nodes of a cluster but the one of the storage to rebuild
+**
+** @param cid   the cluster identifier
+** @param sid   the storage identifier to rebuild
+**
+** @retval the number of nodes
+*/
+static int rbs_multinode_get_nodes(int cid, int sid) {
+  list_t     clusters;
+  list_t   * p, * q;
+  uint8_t    vlayout;
+  uint16_t   vid;
+  char     * local_host = NULL;
+  char     * pChar;
+  int        i;
+  
+  rbs_nodes_nb = 0;
+  list_init(&clusters);
+  
+  if (rbs_get_cluster2_list(&rpcclt_export, parameter.rbs_export_hostname, 
+                            parameter.storaged_geosite, cid, &clusters,
+			    &vlayout, &vid) == NULL) {
+    severe("rbs_get_cluster2_list failed exportd %s cid %d %s", 
+	   parameter.rbs_export_hostname, cid, strerror(errno));
+    return 0;
+  }
+  
+  /*
+  ** Find the node of the storage to rebuild
+  */
+  list_for_each_forward(p, &clusters) {
+    rb_cluster_t *clu = list_entry(p, rb_cluster_t, list);
+    list_for_each_forward(q, &clu->storages) {
+      rb_stor_t *rb_stor = list_entry(q, rb_stor_t, list);
+      if (rb_stor->sid == sid) local_host = rb_stor->host;
+    }
+  }  	
+  
+  list_for_each_forward(p, &clusters) {
+    rb_cluster_t *clu = list_entry(p, rb_cluster_t, list);
+    list_for_each_forward(q, &clu->storages) {
+      rb_stor_t *rb_stor = list_entry(q, rb_stor_t, list);
+      
+      if (rbs_nodes_nb >= RBS_MAX_NODES) break;
+      if ((local_host != NULL) && (strcmp(rb_stor->host,local_host)==0)) continue;
+
+      /*
+      ** Only keep the 1rst address of the node
+      */
+      strcpy(rbs_nodes[rbs_nodes_nb].host, rb_stor->host);
+      pChar = strchr(rbs_nodes[rbs_nodes_nb].host,'/');
+      if (pChar) *pChar = 0;
+      
+      for (i=0; i < rbs_nodes_nb; i++) {
+        if (strcmp(rbs_nodes[i].host,rbs_nodes[rbs_nodes_nb].host)==0) break;
+      }
+      if (i < rbs_nodes_nb) continue;
+      
+      rbs_nodes[rbs_nodes_nb].instances = 0;
+      rbs_nodes_nb++;
+    }
+  }  	
+  rbs_release_cluster_list(&clusters);
+  return rbs_nodes_nb;
+}
+/*
+**____________________________________________________
+** Get the statistics of a list rebuild process running on another node
+*/
+static void rbs_multinode_stat_update(rbs_node_t * node, char * dirName, int instance) {
+  char   cmd[FILENAME_MAX*4];
+  char * pChar = cmd;
+  
+  int    pid = getpid();
+  
+  /*
+  ** The local file is only overwritten when the copy succeeds.
+  ** Both the rebuild process and the process driving the remote list 
+  ** rebuild call this, so the temporary file name includes the caller pid.
+  ** The local file is rewritten in place since the rebuild process keeps
+  ** it open.
+  */
+  pChar = rbs_ssh_append(pChar,0);
+  pChar += sprintf(pChar,"%s@%s cat %s/stat%d > %s/stat%d.node%d 2>/dev/null && cat %s/stat%d.node%d > %s/stat%d; rm -f %s/stat%d.node%d", 
+                   common_config.ssh_user, node->host, dirName, instance, 
+		   dirName, instance, pid, dirName, instance, pid, 
+		   dirName, instance, dirName, instance, pid);
+  if (system(cmd) != 0) {}		   
+}
+/*
+**____________________________________________________
+** SIGUSR1 handler of the processes that drive a remote list rebuild
+*/
+static int rbs_multinode_sigusr = 0;
+static void rbs_multinode_catch_sigusr(int sig) {
+  rbs_multinode_sigusr = 1;
+}
+/*
+**____________________________________________________
+** Run a list rebuild process on another node and get back its job list
+** and statistics files. Called in a sub process of the rebuild.
+**
+** @param node       the node to run the list rebuild process on
+** @param cid        the cluster identifier
+** @param sid        the storage identifier to rebuild
+** @param ftype      the kind of files to rebuild
+** @param instance   the instance of the list rebuild process
+** @param dirName    the rebuild directory
+**
+** @retval the exit status of the list rebuild process
+*/
+static int rbs_multinode_list_rebuild(rbs_node_t * node, int cid, int sid, rbs_file_type_e ftype, 
+                                      int instance, char * dirName) {
+  char   cmd[FILENAME_MAX*4];
+  char   fname[FILENAME_MAX];
+  char   fname_node[FILENAME_MAX];
+  char * pChar;
+  pid_t  pid;
+  int    status = 0;
+  int    forwarded = 0;
+  struct sigaction sa;
+  
+  /*
+  ** The pause is forwarded by the rebuild process to this process only, 
+  ** and by this process to the remote list rebuild process
+  */
+  if (setpgid(0,0) < 0) {
+    severe("setpgid %s", strerror(errno));
+  }
+  /*
+  ** No SA_RESTART, so that waitpid is interrupted by the pause
+  */
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = rbs_multinode_catch_sigusr;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGUSR1, &sa, NULL);
+
+  /*
+  ** Copy the storage configuration, the job list and the statistics on the node
+  */
+  pChar = rbs_ssh_append(cmd,0);
+  pChar += sprintf(pChar,"%s@%s mkdir -p %s", common_config.ssh_user, node->host, dirName);
+  if (system(cmd) != 0) {
+    severe("%s failed", cmd);
+    return 1;
+  }
+  
+  pChar = rbs_ssh_append(cmd,1);
+  pChar += sprintf(pChar,"%s/storage.conf %s/job%d %s/stat%d %s@%s:%s/", 
+                   dirName, dirName, instance, dirName, instance,
+		   common_config.ssh_user, node->host, dirName);
+  if (system(cmd) != 0) {
+    severe("%s failed", cmd);
+    return 1;
+  }
+  
+  /*
+  ** Run the list rebuild process on the node
+  */
+  pChar = rbs_ssh_append(cmd,0);
+  pChar += sprintf(pChar,"%s@%s storage_list_rebuilder -c %d -s %d -r %d -i %d -f %s -D %s --quiet",
+                   common_config.ssh_user, node->host, 
+		   cid, sid, parameter.rebuildRef, instance, rbs_file_type2string(ftype), dirName);
+  if (parameter.throughput) {
+    pChar += sprintf(pChar," -t %d", parameter.throughput);
+  }
+  info("%s", cmd);
+  
+  pid = fork();
+  if (pid == 0) {
+    signal(SIGUSR1, SIG_IGN);
+    execl("/bin/sh", "sh", "-c", cmd, (char *) NULL);
+    exit(errno);
+  }
+  if (pid < 0) {
+    severe("fork %s", strerror(errno));
+    return 1;
+  }
+  
+  while (1) {
+    
+    /*
+    ** Pause the remote list rebuild process
+    */
+    if ((rbs_multinode_sigusr) && (forwarded == 0)) {
+      forwarded = 1;
+      pChar = rbs_ssh_append(cmd,0);
+      pChar += sprintf(pChar,"%s@%s pkill -USR1 -f \"\\\"storage_list_rebuilder -c %d -s %d -r %d -i %d \\\"\"",
+                       common_config.ssh_user, node->host, 
+		       cid, sid, parameter.rebuildRef, instance);
+      if (system(cmd) != 0) {
+        severe("%s failed", cmd);
+      }
+    }
+    
+    if (waitpid(pid,&status,0) == pid) break;
+  
+    if (errno != EINTR) {
+      severe("waitpid %s", strerror(errno));
+      status = 1 << 8;
+      break;
+    }
+  }
+  status = WEXITSTATUS(status);
+
+  /*
+  ** Get back the statistics 
+  */
+  rbs_multinode_stat_update(node, dirName, instance);
+  
+  /*
+  ** Get back the job list that remains when not completed. 
+  ** ssh fails with 255 when the process could not even run.
+  */
+  sprintf(fname,"%s/job%d", dirName, instance);
+  if (status == 0) {
+    unlink(fname);
+  }
+  else if (status != 255) {
+    sprintf(fname_node,"%s/job%d.node", dirName, instance);
+    pChar = rbs_ssh_append(cmd,1);
+    pChar += sprintf(pChar,"%s@%s:%s/job%d %s", 
+                     common_config.ssh_user, node->host, dirName, instance, fname_node);
+    if (system(cmd) == 0) {
+      if (rename(fname_node, fname) < 0) {
+        severe("rename(%s,%s) %s", fname_node, fname, strerror(errno));
+      }	
+    }
+    else {
+      /*
+      ** The whole list will be redone
+      */
+      severe("%s failed", cmd);
+      unlink(fname_node);
+    }
+  }
+  
+  /*
+  ** Clean up the node
+  */
+  pChar = rbs_ssh_append(cmd,0);
+  pChar += sprintf(pChar,"%s@%s rm -f %s/job%d %s/stat%d", 
+                   common_config.ssh_user, node->host, dirName, instance, dirName, instance);
+  if (system(cmd) != 0) {}
+  
+  return status;
+}
 /** Rebuild list just produced 
  *
  */
@@ -1914,6 +2229,8 @@ int rbs_do_list_rebuild(int cid, int sid, rbs_file_type_e ftype) {
   struct stat     buf;
   int             idx;
   char          * argv[32];
+  int             node[MAXIMUM_PARALLEL_REBUILD_PER_SID];
+  pid_t           node_pid[MAXIMUM_PARALLEL_REBUILD_PER_SID];
   
   sigemptyset (&mask);
   sigaddset (&mask, SIGCHLD); 
@@ -1929,12 +2246,28 @@ int rbs_do_list_rebuild(int cid, int sid, rbs_file_type_e ftype) {
   
   failure = 0;
   success = 0;
+
+  /*
+  ** In multi-node mode, the list rebuild processes are shared by the 
+  ** other nodes of the cluster, else they all run locally
+  */
+  if (parameter.multinode) {
+    if (rbs_multinode_get_nodes(cid,sid) == 0) {
+      info("No other node in cluster %d to rebuild sid %d. Rebuild locally.", cid, sid);
+    }
+  }
+  else {
+    rbs_nodes_nb = 0;
+  }    
   	  
   /*
   ** Loop on distibution sub directories
   */
   for (instance=0; instance<parameter.parallel; instance++) {
 
+    node[instance]     = -1;
+    node_pid[instance] = 0;
+
     char * pChar = fname;
     pChar += rozofs_string_append(pChar,dirName);
     pChar += rozofs_string_append(pChar,"/stat");
@@ -1972,7 +2305,18 @@ int rbs_do_list_rebuild(int cid, int sid, rbs_file_type_e ftype) {
       continue;	  
     }
 
+    if (rbs_nodes_nb) {
+      node[instance] = instance % rbs_nodes_nb;
+      rbs_nodes[node[instance]].instances++;
+    }
+
     pid = fork();  
+    if ((pid == 0) && (node[instance] >= 0)) {
+      exit(rbs_multinode_list_rebuild(&rbs_nodes[node[instance]], cid, sid, ftype, instance, dirName));
+    }
+    if (pid > 0) {
+      node_pid[instance] = pid;
+    }    
     if (pid == 0) {    
       pChar = cmd;
       pChar += rozofs_string_append(pChar,"storage_list_rebuilder -c ");
@@ -2030,6 +2374,10 @@ int rbs_do_list_rebuild(int cid, int sid, rbs_file_type_e ftype) {
 	
       status = WEXITSTATUS(status);
 
+      for (instance=0; instance<parameter.parallel; instance++) {
+        if (node_pid[instance] == pid) node_pid[instance] = 0;
+      }
+
       if (status != 0) failure++;
       else             success++;
 	  
@@ -2037,11 +2385,25 @@ int rbs_do_list_rebuild(int cid, int sid, rbs_file_type_e ftype) {
     }
      
 	 
+    /*
+    ** Get the statistics of the list rebuild processes running on other nodes
+    */
+    for (instance=0; instance<parameter.parallel; instance++) {
+      if ((node[instance] >= 0) && (node_pid[instance] != 0)) {
+        rbs_multinode_stat_update(&rbs_nodes[node[instance]], dirName, instance);
+      }
+    }
+     
     periodic_stat_update(fd);
     
     // Rebuild is paused. Forward signal to every child
     if (sigusr_received) {
        kill(0,SIGUSR1);
+       for (instance=0; instance<parameter.parallel; instance++) {
+         if ((node[instance] >= 0) && (node_pid[instance] != 0)) {
+           kill(node_pid[instance],SIGUSR1);
+         }
+       }	 
     }
   }
   
@@ -2308,6 +2670,198 @@ out:
     rbs_release_cluster_list(&cluster_entries);
     return status;
 }
+/*
+** What to do with the dirty chunk journals
+*/
+#define RBS_DIRTY_BUILD   0   /**< build the job list from the journals */
+#define RBS_DIRTY_CLEAR   1   /**< remove the frozen journals after a successfull rebuild */
+#define RBS_DIRTY_FREEZE  2   /**< freeze the journals before a full rebuild */
+/*
+**____________________________________________________
+** Build the job list of a nominal sid from the dirty chunk journals
+** that the other storages of the cluster have recorded while this sid
+** was unreachable.
+**
+** @param idx   index of the storage to rebuild in rbs_stor_configs
+** @param mode  RBS_DIRTY_BUILD to build the job list, RBS_DIRTY_CLEAR to 
+**              just remove the frozen journals, RBS_DIRTY_FREEZE to just 
+**              freeze the journals
+**
+** @retval 0 on success. -1 when the journals can not be used and the
+**         list has to be requested to the export
+*/
+static int rbs_build_job_list_from_dirty(int idx, int mode) {
+  rbs_stor_config_t * stor_confs = &rbs_stor_configs[idx];
+  uint8_t             cid = stor_confs->cid;
+  uint8_t             sid = stor_confs->sid;
+  int                 status = -1;
+  int                 failed,available;
+  list_t            * p, * q;
+  char              * dir;
+  char                filename[FILENAME_MAX];
+  char              * pChar;
+  int                 cfgfd[MAXIMUM_PARALLEL_REBUILD_PER_SID];
+  int                 current_file_index = 0;
+  uint64_t            count = 0;
+  int                 i;
+  int                 time_start = time(NULL);
+
+  for (i=0; i < MAXIMUM_PARALLEL_REBUILD_PER_SID; i++) cfgfd[i] = -1;
+
+  // Get the list of storages for this cluster ID
+  list_init(&cluster_entries);
+  pExport_host = rbs_get_cluster_list(&rpcclt_export, parameter.rbs_export_hostname, 
+                                      parameter.storaged_geosite, cid, &cluster_entries);
+  if (pExport_host == NULL) {					
+    severe("rbs_get_cluster_list failed (cid: %u) : %s", cid, strerror(errno));
+    goto out;
+  }
+  rbs_init_cluster_cnts(&cluster_entries, cid, sid,&failed,&available);
+
+  if (mode == RBS_DIRTY_BUILD) {
+    // Initialize the storage to rebuild
+    if (rbs_initialize(cid, sid, stor_confs->root, 
+                       stor_confs->device.total, stor_confs->device.mapper, stor_confs->device.redundancy) != 0) {
+      severe("can't init. storage to rebuild (cid:%u;sid:%u;path:%s)",
+              cid, sid, stor_confs->root);
+      goto out;
+    }
+    strcpy(storage_config.export_hostname,parameter.rbs_export_hostname);
+    storage_config.site   = parameter.storaged_geosite;
+    storage_config.ftype  = stor_confs->ftype;    
+    storage_config.cid    = cid;
+    storage_config.sid    = sid;
+    stor_confs->status    = RBS_STATUS_PROCESSING_LIST;
+    rbs_write_storage_config_file(parameter.rebuildRef, &storage_config);
+
+    /*
+    ** Create the job files
+    */
+    dir = get_rebuild_sid_directory_name(parameter.rebuildRef,cid,sid,stor_confs->ftype);
+    for (i=0; i < parameter.parallel; i++) {
+      pChar = filename;
+      pChar += rozofs_string_append(pChar,dir);
+      pChar += rozofs_string_append(pChar,"/job");
+      pChar += rozofs_u32_append(pChar,i);
+
+      cfgfd[i] = open(filename,O_CREAT | O_TRUNC | O_WRONLY, 0640);
+      if (cfgfd[i] == -1) {
+        severe("Can not open file %s %s", filename, strerror(errno));
+        goto out;
+      }
+    }
+  }
+
+  /*
+  ** Read the journal of every other storage of the cluster
+  */
+  list_for_each_forward(p, &cluster_entries) {
+
+    rb_cluster_t *clu = list_entry(p, rb_cluster_t, list);
+    if (clu->cid != cid) continue;
+
+    list_for_each_forward(q, &clu->storages) {
+
+      rb_stor_t        * rb_stor = list_entry(q, rb_stor_t, list);
+      mp_dirty_entry_t   entries[MP_DIRTY_MAX_ENTRIES];
+      uint64_t           cookie = 0;
+      uint8_t            eof = 0;
+      uint8_t            overflow = 0;
+      int                nb;
+
+      if (rb_stor->sid == sid) continue;
+
+      /*
+      ** The journal of an unreachable storage is unknown
+      */
+      if (rb_stor->mclient.rpcclt.client == NULL) {
+        if (mode != RBS_DIRTY_BUILD) continue;
+        REBUILD_MSG("cid %d sid %d : sid %d unreachable. Journals can not be used.", cid, sid, rb_stor->sid);
+        goto out;
+      }
+
+      while (!eof) {
+
+        if (rbs_get_dirty_list(&rb_stor->mclient, cid, rb_stor->sid, sid, (mode == RBS_DIRTY_CLEAR),
+                               &cookie, entries, &nb, &overflow, &eof) != 0) {
+          severe("rbs_get_dirty_list cid %d sid %d from sid %d %s", cid, sid, rb_stor->sid, strerror(errno));
+          if (mode != RBS_DIRTY_BUILD) break;
+          goto out;
+        }
+        /*
+        ** The 1rst read has frozen the journal
+        */
+        if (mode == RBS_DIRTY_FREEZE) break;
+        if (overflow) {
+          REBUILD_MSG("cid %d sid %d : journal of sid %d has overflown.", cid, sid, rb_stor->sid);
+          goto out;
+        }
+
+        for (i=0; i < nb; i++) {
+          rozofs_rebuild_entry_file_t file_entry;
+          int                         entry_size = rbs_entry_size_from_layout(entries[i].layout);
+
+          memcpy(file_entry.fid, entries[i].fid, sizeof (fid_t));
+          file_entry.block_start = entries[i].block_start;
+          file_entry.block_end   = entries[i].block_end;
+          file_entry.layout      = entries[i].layout;
+          file_entry.bsize       = entries[i].bsize;
+          file_entry.todo        = 1;
+          file_entry.relocate    = 0;
+          file_entry.error       = rozofs_rbs_error_none;
+          memcpy(file_entry.dist_set_current, entries[i].dist_set, sizeof (sid_t) * ROZOFS_SAFE_MAX);
+
+          if (write(cfgfd[current_file_index],&file_entry,entry_size) != entry_size) {
+            severe("can not write file cid%d sid%d %d %s",cid,sid,current_file_index,strerror(errno));
+            goto out;
+          }
+          count++;
+          current_file_index++;
+          if (current_file_index >= parameter.parallel) current_file_index = 0; 
+        }
+      }
+    }
+  }
+
+  if (mode == RBS_DIRTY_BUILD) {
+    rbs_write_count_file(cid,sid,stor_confs->ftype,count); 
+    REBUILD_MSG("cid %d sid %d : %llu chunk ranges to rebuild from the journals.", 
+                cid, sid, (unsigned long long int)count);
+    rbs_monitor[idx].list_building_sec = time(NULL) - time_start;
+    rbs_monitor[idx].nb_files          = count;    
+  }
+  status = 0;
+
+out:
+  for (i=0; i < MAXIMUM_PARALLEL_REBUILD_PER_SID; i++) {
+    if (cfgfd[i] != -1) close(cfgfd[i]);
+  }
+  rbs_release_cluster_list(&cluster_entries);
+  return status;
+}
+/*
+**____________________________________________________
+** Build the job lists from the dirty chunk journals of the other storages
+**
+** Only the nominal files are rebuilt from the journals, since the
+** spare files of the rebuilt sid have been rewritten on other spares.
+**
+** @retval 0 on success. -1 when one journal can not be used
+*/
+static int rbs_build_job_list_from_dirties(void) {
+  int idx;
+
+  for (idx=0; idx < nb_rbs_entry; idx++) {
+    if (rbs_stor_configs[idx].ftype == rbs_file_type_spare) {
+      rbs_stor_configs[idx].status = RBS_STATUS_PROCESSING_LIST;
+      rbs_write_count_file(rbs_stor_configs[idx].cid,rbs_stor_configs[idx].sid,rbs_file_type_spare,0);
+      rbs_monitor[idx].nb_files = 0;
+      continue;
+    }
+    if (rbs_build_job_list_from_dirty(idx,RBS_DIRTY_BUILD) != 0) return -1;
+  }
+  return 0;
+}
 int rbs_build_job_lists_one_fid(rbs_stor_config_t *stor_confs) {
     int status = -1;
     int failed,available;
@@ -2823,6 +3377,12 @@ static inline int rebuild_storage_thread(rbs_stor_config_t *stor_confs) {
             rbs_monitor_update("running","No file to rebuild (Check ssh cnx with export).");
             stor_confs[rbs_index].status = RBS_STATUS_SUCCESS;
             /*
+            ** The journals of the other storages are no more needed
+            */
+            if ((parameter.type == rbs_rebuild_type_storage) && (ftype != rbs_file_type_spare)) {
+              rbs_build_job_list_from_dirty(rbs_index,RBS_DIRTY_CLEAR);
+            }
+            /*
             ** Remove cid/sid directory 
             */
             //clean_dir(get_rebuild_sid_directory_name(parameter.rebuildRef,cid,sid,ftype));  
@@ -2855,6 +3415,12 @@ static inline int rebuild_storage_thread(rbs_stor_config_t *stor_confs) {
 
 	    stor_confs[rbs_index].status = RBS_STATUS_SUCCESS;
 	    /*
+	    ** The journals of the other storages are no more needed
+	    */
+	    if ((parameter.type == rbs_rebuild_type_storage) && (ftype != rbs_file_type_spare)) {
+	      rbs_build_job_list_from_dirty(rbs_index,RBS_DIRTY_CLEAR);
+	    }
+	    /*
 	    ** Remove cid/sid directory 
 	    */
 	    //clean_dir(get_rebuild_sid_directory_name(parameter.rebuildRef,cid,sid,ftype));  
@@ -3271,8 +3837,27 @@ static int prepare_list_of_storage_to_rebuild() {
   }
   else {
     /*
-    ** Ask the export for the list of jobs
+    ** Build the list of jobs from the journals of the other storages
+    ** when possible, else ask the export for the list of jobs
     */
+    if ((parameter.dirty) && (rbs_build_job_list_from_dirties() == 0)) {
+      return 0;
+    }
+    if (parameter.dirty) {
+      REBUILD_MSG("Journals can not be used. Full rebuild.");
+      parameter.dirty = 0;
+    }
+    /*
+    ** A full rebuild of the sid covers what is journaled until now.
+    ** Freeze the journals, so that they are removed once the rebuild
+    ** succeeds, while the later writes are journaled for a next rebuild.
+    */
+    if (parameter.type == rbs_rebuild_type_storage) {
+      for (idx=0; idx< nb_rbs_entry; idx++) {
+        if (rbs_stor_configs[idx].ftype == rbs_file_type_spare) continue;
+        rbs_build_job_list_from_dirty(idx,RBS_DIRTY_FREEZE);
+      }
+    }
     rbs_build_job_list_from_export(); 
   }          		
   return 0;
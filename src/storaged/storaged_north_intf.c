@@ -109,6 +109,20 @@ void mproto_sub_thread(rozorpc_srv_ctx_t *rozorpc_srv_ctx_p, rozofs_rpc_call_hdr
       local = mp_subthread_remove2;
       size = sizeof(mp_remove2_arg_t);
       break;
+
+    case MP_LIST_DIRTY:
+      rozorpc_srv_ctx_p->arg_decoder = (xdrproc_t) xdr_mp_list_dirty_arg_t;
+      rozorpc_srv_ctx_p->xdr_result  = (xdrproc_t) xdr_mp_list_dirty_ret_t;
+      local = mp_subthread_list_dirty;
+      size = sizeof(mp_list_dirty_arg_t);
+      break;
+
+    case MP_REMOVE_BATCH:
+      rozorpc_srv_ctx_p->arg_decoder = (xdrproc_t) xdr_mp_remove_batch_arg_t;
+      rozorpc_srv_ctx_p->xdr_result  = (xdrproc_t) xdr_mp_remove_batch_ret_t;
+      local = mp_subthread_remove_batch;
+      size = sizeof(mp_remove_batch_arg_t);
+      break;
     
 
     default:
@@ -340,6 +354,8 @@ void storaged_req_rcv_cbk(void *userRef,uint32_t  socket_ctx_idx, void *recv_buf
 	  case MP_REMOVE2:
 	  case MP_REMOVE:
 	  case MP_LIST_BINS_FILES:
+	  case MP_LIST_DIRTY:
+	  case MP_REMOVE_BATCH:
 	    mproto_sub_thread(rozorpc_srv_ctx_p, &hdr);
 	    break;
 	    
@@ -35,6 +35,7 @@
 #include <rozofs/rpc/rozofs_rpc_util.h>
 
 #include "storaged_sub_thread_intf.h"
+#include "storio_dirty.h"
 
 
 int storaged_sub_thread_socket_req = -1;
@@ -331,6 +332,125 @@ out:
   thread_ctx_p->stat.list_bins_time +=(timeAfter-timeBefore);  
   storaged_sub_thread_intf_send_response(thread_ctx_p,msg,0);
 }    
+/*__________________________________________________________________________
+*/
+/**
+*  Perform the removal of a batch of files
+
+  @param thread_ctx_p: pointer to the thread context
+  @param msg         : address of the message received
+  
+  @retval: none
+*/
+static inline void storaged_sub_thread_remove_batch(storaged_sub_thread_ctx_t *thread_ctx_p,storaged_sub_thread_msg_t * msg) {
+  struct timeval                 timeDay;
+  unsigned long long             timeBefore, timeAfter;
+  rozorpc_srv_ctx_t            * rpcCtx;
+  mp_remove_batch_arg_t        * args;  
+  mp_remove_batch_ret_t          ret;
+  int                            errors[MP_REMOVE_BATCH_MAX];
+  int                            idx;
+      
+  gettimeofday(&timeDay,(struct timezone *)0);  
+  timeBefore = MICROLONG(timeDay);  
+
+  memset(&ret, 0, sizeof(mp_remove_batch_ret_t));
+  ret.status = MP_SUCCESS;          
+ 
+   /*
+  ** update statistics
+  */
+  thread_ctx_p->stat.remove_batch_count++; 
+  
+  rpcCtx = msg->rpcCtx;
+  args   = (mp_remove_batch_arg_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
+
+  /*
+  ** Remove every file. One error code per file is returned
+  */
+  for (idx=0; idx < args->fids.fids_len; idx++) {
+    errors[idx] = 0;
+    if (storage_rm2_file(msg->st, (unsigned char *) args->fids.fids_val[idx], args->spare) != 0) {
+      errors[idx] = errno;
+      if (errors[idx] == 0) errors[idx] = EIO;
+      thread_ctx_p->stat.remove_batch_errors++ ;   
+    }    
+  }
+  thread_ctx_p->stat.remove_batch_files += args->fids.fids_len;
+  ret.mp_remove_batch_ret_t_u.errors.errors_len = args->fids.fids_len;
+  ret.mp_remove_batch_ret_t_u.errors.errors_val = errors;
+  
+  storaged_sub_thread_encode_rpc_response(rpcCtx,(char*)&ret);  
+
+  gettimeofday(&timeDay,(struct timezone *)0);  
+  timeAfter = MICROLONG(timeDay);
+  thread_ctx_p->stat.remove_batch_time +=(timeAfter-timeBefore);  
+  storaged_sub_thread_intf_send_response(thread_ctx_p,msg,0);
+}    
+/*__________________________________________________________________________
+*/
+/**
+*  Read or clear the dirty chunk journal of a storage to rebuild
+
+  @param thread_ctx_p: pointer to the thread context
+  @param msg         : address of the message received
+  
+  @retval: none
+*/
+static inline void storaged_sub_thread_list_dirty(storaged_sub_thread_ctx_t *thread_ctx_p,storaged_sub_thread_msg_t * msg) {
+  struct timeval                  timeDay;
+  unsigned long long timeBefore,  timeAfter;
+  rozorpc_srv_ctx_t             * rpcCtx;
+  mp_list_dirty_arg_t           * args;  
+  mp_list_dirty_ret_t             ret;
+  mp_dirty_entry_t                entries[MP_DIRTY_MAX_ENTRIES];
+  int                             nb = 0;
+      
+  gettimeofday(&timeDay,(struct timezone *)0);  
+  timeBefore = MICROLONG(timeDay);  
+
+  memset(&ret, 0, sizeof(mp_list_dirty_ret_t));
+  ret.status = MP_FAILURE;          
+ 
+   /*
+  ** update statistics
+  */
+  thread_ctx_p->stat.list_dirty_count++; 
+  
+  rpcCtx = msg->rpcCtx;
+  args   = (mp_list_dirty_arg_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
+
+  if (args->clear) {
+    if (storio_dirty_clear(msg->st, args->dirty_sid) != 0) {
+      ret.mp_list_dirty_ret_t_u.error = errno;
+      thread_ctx_p->stat.list_dirty_errors++ ;   
+      goto out;  
+    }
+    ret.mp_list_dirty_ret_t_u.reply.eof = 1;
+  }
+  else {
+    if (storio_dirty_list(msg->st, args->dirty_sid, &args->cookie,
+                          entries, MP_DIRTY_MAX_ENTRIES, &nb,
+        		  &ret.mp_list_dirty_ret_t_u.reply.overflow,
+        		  &ret.mp_list_dirty_ret_t_u.reply.eof) != 0) {
+      ret.mp_list_dirty_ret_t_u.error = errno;
+      thread_ctx_p->stat.list_dirty_errors++ ;   
+      goto out;   
+    }  
+    ret.mp_list_dirty_ret_t_u.reply.entries.entries_len = nb;
+    ret.mp_list_dirty_ret_t_u.reply.entries.entries_val = entries;
+  }
+  ret.status = MP_SUCCESS;
+  ret.mp_list_dirty_ret_t_u.reply.cookie = args->cookie;
+		    
+out:
+  storaged_sub_thread_encode_rpc_response(rpcCtx,(char*)&ret);
+
+  gettimeofday(&timeDay,(struct timezone *)0);  
+  timeAfter = MICROLONG(timeDay);
+  thread_ctx_p->stat.list_dirty_time +=(timeAfter-timeBefore);  
+  storaged_sub_thread_intf_send_response(thread_ctx_p,msg,0);
+}    
    
 /*
 **_________________________________________________
@@ -408,6 +528,12 @@ void *storaged_sub_thread(void *arg) {
       case MP_LIST_BINS_FILES:
         storaged_sub_thread_list_bins(ctx_p,&msg);
         break;		
+      case MP_LIST_DIRTY:
+        storaged_sub_thread_list_dirty(ctx_p,&msg);
+        break;		
+      case MP_REMOVE_BATCH:
+        storaged_sub_thread_remove_batch(ctx_p,&msg);
+        break;		
        	
       default:
         fatal(" unexpected opcode : %d\n",msg.opcode);
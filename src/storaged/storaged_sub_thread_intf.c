@@ -141,6 +141,19 @@ void storaged_sub_thread_debug(char * argv[], uint32_t tcpRef, void *bufRef) {
   display_line_val_and_sum("   errors", list_bins_errors);
   display_line_val_and_sum("   Cumulative Time (us)",list_bins_time);
   display_line_div_and_sum("   Average Time (us)",list_bins_time,list_bins_count);
+
+  display_line_topic("List dirty");  
+  display_line_val_and_sum("   number", list_dirty_count);
+  display_line_val_and_sum("   errors", list_dirty_errors);
+  display_line_val_and_sum("   Cumulative Time (us)",list_dirty_time);
+  display_line_div_and_sum("   Average Time (us)",list_dirty_time,list_dirty_count);
+
+  display_line_topic("Remove batch");  
+  display_line_val_and_sum("   number", remove_batch_count);
+  display_line_val_and_sum("   files", remove_batch_files);
+  display_line_val_and_sum("   errors", remove_batch_errors);
+  display_line_val_and_sum("   Cumulative Time (us)",remove_batch_time);
+  display_line_div_and_sum("   Average Time (us)",remove_batch_time,remove_batch_count);
   
   display_line_topic("");  
   pChar += sprintf(pChar,"\n");
@@ -278,6 +291,12 @@ void storaged_sub_thread_read_response(storaged_sub_thread_msg_t *msg)
     case MP_LIST_BINS_FILES:
        STOP_PROFILING(list_bins_files);
        break; 
+    case MP_LIST_DIRTY:
+       STOP_PROFILING(list_dirty);
+       break; 
+    case MP_REMOVE_BATCH:
+       STOP_PROFILING(remove_batch);
+       break; 
     default:
       severe("Unexpected opcode %d", opcode);
   }
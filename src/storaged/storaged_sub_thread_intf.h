@@ -43,6 +43,15 @@ typedef struct _storaged_sub_thread_stat_t {
   uint64_t            list_bins_count;
   uint64_t            list_bins_errors;
   uint64_t            list_bins_time;
+
+  uint64_t            list_dirty_count;
+  uint64_t            list_dirty_errors;
+  uint64_t            list_dirty_time;
+
+  uint64_t            remove_batch_count;
+  uint64_t            remove_batch_files;
+  uint64_t            remove_batch_errors;
+  uint64_t            remove_batch_time;
   
 } storaged_sub_thread_stat_t;
 /*
@@ -151,6 +151,7 @@ static int storaged_initialize() {
                     sc->cid, sc->sid, sc->root);
             goto out;
         }
+        storaged_storages[storaged_nrstorages-1].direct_io = sc->direct_io;
     }
 
     status = 0;
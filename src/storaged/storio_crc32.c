@@ -40,6 +40,7 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <stdint.h>
+#include <immintrin.h>
 
 #include <rozofs/rozofs.h>
 #include <rozofs/common/log.h>
@@ -328,6 +329,139 @@ static uint32_t crc32c_hw(uint32_t crc, const void *buf, size_t len)
     return (uint32_t)crc0 ^ 0xffffffff;
 }
 
+/*
+**__________________________________________________________________
+**
+** 3-way folded hardware CRC-32C
+**
+** The buffer is cut in 3 streams of the same length that are computed
+** in parallel with crc32q, so that the 3 cycles latency of the
+** instruction is hidden. The stream length is adapted to the buffer
+** length, so that every projection size benefits from it, and the 3
+** partial CRCs are combined with a carry-less multiplication:
+**   shift(crc,n bytes) = crc32q(0, clmul(crc, x^(8n-33) mod P))
+**__________________________________________________________________
+*/
+int crc32c_pclmul_supported = 0;
+
+/* Max length of a stream in quadwords */
+#define CRC32C_FOLD_MAX_QW   1024
+/* Min length of a stream in quadwords for the folding to be worth it */
+#define CRC32C_FOLD_MIN_QW   8
+
+/* 
+** x^(64*n-33) mod P constants to shift a crc by n quadwords 
+** of zeros, for n up to 2 streams 
+*/
+static uint32_t crc32c_fold_k[2*CRC32C_FOLD_MAX_QW+1];
+
+/* Build the shift constants of the folding */
+static void crc32c_init_fold(void)
+{
+    uint32_t k = 0x80000000; /* x^0 */
+    int      n,bit;
+
+    /* x^31 */
+    for (bit = 0; bit < 31; bit++) k = k & 1 ? (k >> 1) ^ POLY : k >> 1;
+    crc32c_fold_k[1] = k;
+    for (n = 2; n <= 2*CRC32C_FOLD_MAX_QW; n++) {
+        for (bit = 0; bit < 64; bit++) k = k & 1 ? (k >> 1) ^ POLY : k >> 1;
+        crc32c_fold_k[n] = k;
+    }
+}
+
+/* Shift a crc by the nb of quadwords of zeros k stands for */
+static inline __attribute__((always_inline,target("sse4.2,pclmul")))
+uint32_t crc32c_fold_shift(uint32_t crc, uint32_t k)
+{
+    __m128i prod = _mm_clmulepi64_si128(_mm_cvtsi32_si128(crc),_mm_cvtsi32_si128(k),0x00);
+    return (uint32_t)_mm_crc32_u64(0,_mm_cvtsi128_si64(prod));
+}
+
+/* Compute the crc of the trailing bytes of a buffer */
+static inline __attribute__((always_inline,target("sse4.2")))
+uint64_t crc32c_hw_tail(uint64_t crc0, const unsigned char *next, size_t len)
+{
+    while (len >= 8) {
+        crc0 = _mm_crc32_u64(crc0,*(uint64_t *)next);
+        next += 8;
+        len  -= 8;
+    }
+    while (len) {
+        crc0 = _mm_crc32_u8((uint32_t)crc0,*next);
+        next++;
+        len--;
+    }
+    return crc0;
+}
+
+/* Compute CRC-32C with 3 folded streams */
+static __attribute__((target("sse4.2,pclmul")))
+uint32_t crc32c_hw_fold(uint32_t crc, const void *buf, size_t len)
+{
+    const unsigned char *next = buf;
+    uint64_t crc0, crc1, crc2;
+    size_t   qw, i;
+    const uint64_t *p0, *p1, *p2;
+
+    crc0 = crc ^ 0xffffffff;
+
+    /* bring the data pointer to an eight-byte boundary */
+    while (len && ((uintptr_t)next & 7) != 0) {
+        crc0 = _mm_crc32_u8((uint32_t)crc0,*next);
+        next++;
+        len--;
+    }
+
+    while (len >= 3*8*CRC32C_FOLD_MIN_QW) {
+        qw = len / 24;
+        if (qw > CRC32C_FOLD_MAX_QW) qw = CRC32C_FOLD_MAX_QW;
+        p0 = (const uint64_t *) next;
+        p1 = p0 + qw;
+        p2 = p1 + qw;
+        crc1 = 0;
+        crc2 = 0;
+        for (i = 0; i < qw; i++) {
+            crc0 = _mm_crc32_u64(crc0,p0[i]);
+            crc1 = _mm_crc32_u64(crc1,p1[i]);
+            crc2 = _mm_crc32_u64(crc2,p2[i]);
+        }
+        crc0 = crc32c_fold_shift(crc0,crc32c_fold_k[2*qw])
+             ^ crc32c_fold_shift(crc1,crc32c_fold_k[qw])
+             ^ crc2;
+        next += 24*qw;
+        len  -= 24*qw;
+    }
+    crc0 = crc32c_hw_tail(crc0,next,len);
+    return (uint32_t)crc0 ^ 0xffffffff;
+}
+
+/* Compute the CRC-32C of 3 buffers of the same length in one pass */
+static __attribute__((target("sse4.2")))
+void crc32c_hw_x3(uint32_t *crc, char **buf, size_t len)
+{
+    uint64_t crc0 = crc[0] ^ 0xffffffff;
+    uint64_t crc1 = crc[1] ^ 0xffffffff;
+    uint64_t crc2 = crc[2] ^ 0xffffffff;
+    const uint64_t *p0 = (const uint64_t *) buf[0];
+    const uint64_t *p1 = (const uint64_t *) buf[1];
+    const uint64_t *p2 = (const uint64_t *) buf[2];
+    size_t qw = len / 8;
+    size_t i;
+
+    for (i = 0; i < qw; i++) {
+        crc0 = _mm_crc32_u64(crc0,p0[i]);
+        crc1 = _mm_crc32_u64(crc1,p1[i]);
+        crc2 = _mm_crc32_u64(crc2,p2[i]);
+    }
+    crc0 = crc32c_hw_tail(crc0,(const unsigned char *)(p0+qw),len & 7);
+    crc1 = crc32c_hw_tail(crc1,(const unsigned char *)(p1+qw),len & 7);
+    crc2 = crc32c_hw_tail(crc2,(const unsigned char *)(p2+qw),len & 7);
+    crc[0] = (uint32_t)crc0 ^ 0xffffffff;
+    crc[1] = (uint32_t)crc1 ^ 0xffffffff;
+    crc[2] = (uint32_t)crc2 ^ 0xffffffff;
+}
+
 /*
 **__________________________________________________________________
 */
@@ -353,11 +487,47 @@ uint64_t storio_crc_error= 0;
         (have) = (ecx >> 20) & 1; \
     } while (0)
 
+/* Check for PCLMULQDQ, which is needed to combine the folded streams */
+#define PCLMUL(have) \
+    do { \
+        uint32_t eax, ecx; \
+        eax = 1; \
+        __asm__("cpuid" \
+                : "=c"(ecx) \
+                : "a"(eax) \
+                : "%ebx", "%edx"); \
+        (have) = (ecx >> 1) & 1; \
+    } while (0)
+
 /* Compute a CRC-32C.  If the crc32 instruction is available, use the hardware
    version.  Otherwise, use the software version. */
 uint32_t crc32c(uint32_t crc, const void *buf, size_t len)
 {
-    return (crc32c_hw_supported==1) ? crc32c_hw(crc, buf, len) : crc32c_sw(crc, buf, len);
+    if (crc32c_hw_supported==0) return crc32c_sw(crc, buf, len);
+    if (crc32c_pclmul_supported) return crc32c_hw_fold(crc, buf, len);
+    return crc32c_hw(crc, buf, len);
+}
+/*
+**__________________________________________________________________
+*/
+/*
+**  Compute the CRC-32C of a set of buffers of the same length.
+    The buffers are computed 3 by 3 in a single pass when the 
+    hardware supports it.
+    
+    @param crc: the initial CRC of each buffer, and the returned CRCs
+    @param buf: the buffers
+    @param nb: number of buffers
+    @param len: length of each buffer
+*/
+static inline void crc32c_multi(uint32_t *crc, char **buf, int nb, size_t len)
+{
+    int i = 0;
+
+    if (crc32c_hw_supported) {
+      for (; i+3 <= nb; i+=3) crc32c_hw_x3(&crc[i],&buf[i],len);
+    }
+    for (; i < nb; i++) crc[i] = crc32c(crc[i],buf[i],len);
 }
 
 /*
@@ -454,6 +624,123 @@ int storio_check_header_crc32(rozofs_stor_bins_file_hdr_t * hdr, uint64_t *crc_e
 **__________________________________________________________________
 */
 /*
+** Number of projections which CRC are computed in the same pass
+*/
+#define STORIO_CRC32_PASS 3
+/*
+**__________________________________________________________________
+*/
+/*
+**  Generate a CRC32 on a group of projections. THe cRC32 is stored in 
+    the filler field of each projection header.
+    
+    @param buf: the projections of the group
+    @param idx: the index of each projection in the request
+    @param nb : number of projections in the group
+    @param prj_size: size of a projection including the prj header
+    @param initial_crc: Value to intializae the CRC to    
+*/
+static inline void storio_gen_crc32_group(char ** buf, int * idx, int nb, uint16_t prj_size, uint32_t initial_crc)
+{
+   uint32_t crc[STORIO_CRC32_PASS];
+   int j;
+   
+   for (j = 0; j < nb; j++) {
+     ((rozofs_stor_bins_hdr_t*)(buf[j]))->s.filler = 0;
+     crc[j] = initial_crc + idx[j];
+   }
+   crc32c_multi(crc,buf,nb,prj_size);
+   for (j = 0; j < nb; j++) {
+     if (crc[j] == 0) crc[j] = 1;
+     ((rozofs_stor_bins_hdr_t*)(buf[j]))->s.filler = crc[j];
+   }
+}
+/*
+**__________________________________________________________________
+*/
+/*
+**  Check the  CRC32 on a group of projections. THe cRC32 is stored in 
+    the filler field of each projection header.
+    In case of error the projection id is se to 0xff in the header
+    
+    @param buf: the projections of the group
+    @param cur_crc: the CRC read in each projection header
+    @param idx: the index of each projection in the request
+    @param nb : number of projections in the group
+    @param prj_size: size of a projection including the prj header
+    @param crc_errorcnt_p: pointer to the crc error counter of the storage (cid/sid).
+    @param initial_crc: Value to intializae the CRC to    
+    @param errors: a returned bitmask of the blocks in error   
+    
+    @retval the number of CRC32 error detected
+*/
+static inline int storio_check_crc32_group(char    ** buf,
+                                           uint32_t * cur_crc,
+                                           int      * idx,
+                                           int        nb,
+                                           uint16_t   prj_size,
+                                           uint64_t * crc_error_cnt_p, 
+                                           uint32_t   initial_crc, 
+                                           uint64_t * errors)
+{
+   uint32_t crc[STORIO_CRC32_PASS];
+   int j;
+   int result = 0;
+   
+   /*
+   **  compute the crc
+   */
+   for (j = 0; j < nb; j++) {
+     ((rozofs_stor_bins_hdr_t*)(buf[j]))->s.filler = 0;
+     crc[j] = initial_crc + idx[j];
+   }
+   crc32c_multi(crc,buf,nb,prj_size);
+   
+   for (j = 0; j < nb; j++) {
+      if (crc[j]==0) crc[j] = 1;      
+      /*
+      ** control with the one stored in the header
+      */
+      if (cur_crc[j] != crc[j])
+      {
+        /*
+	** data corruption
+	*/
+	((rozofs_stor_bins_hdr_t*)(buf[j]))->s.projection_id = 0xff;
+	/*
+	** increment the global counter and the storage counter
+	*/
+	__atomic_fetch_add(&storio_crc_error,1,__ATOMIC_SEQ_CST);
+	__atomic_fetch_add(crc_error_cnt_p,1,__ATOMIC_SEQ_CST);
+	errors[idx[j]/64] |= (1ULL<<(idx[j]%64));
+	result++;
+      }
+   }
+   return result;
+}
+/*
+**__________________________________________________________________
+*/
+/*
+**  Update the statistics of the number of errors per read
+    
+    @param result: the number of CRC32 error detected
+*/
+static inline void storio_crc32_error_per_read_update(int result)
+{
+  if (result) {
+    if (result<STORIO_MAX_CRC32_ERROR_PER_READ_COUNT) {
+      storio_crc32_error_per_read[result]++;
+    }  
+    else {
+      storio_crc32_error_per_read[STORIO_MAX_CRC32_ERROR_PER_READ_COUNT-1]++;
+    }
+  }
+}
+/*
+**__________________________________________________________________
+*/
+/*
 **  Generate a CRC32 on each projection. THe cRC32 is stored in the
     filler field of each projection header.
     
@@ -464,24 +751,23 @@ int storio_check_header_crc32(rozofs_stor_bins_file_hdr_t * hdr, uint64_t *crc_e
 */
 void storio_gen_crc32(char *bins,int nb_proj,uint16_t prj_size, uint32_t initial_crc)
 {
-   size_t crc_size = prj_size;
-   uint32_t crc = 0;
-   int i;
-   char *buf=bins;
+   char * buf[STORIO_CRC32_PASS];
+   int    idx[STORIO_CRC32_PASS];
+   int    i;
+   int    nb = 0;
  
    if (crc32c_generate_enable == 0) return;
 
    for (i = 0; i < nb_proj ; i++)
    {
-      crc = initial_crc + i;
-      ((rozofs_stor_bins_hdr_t*)(buf))->s.filler = 0;
-      if (crc32c_generate_enable) {
-        crc = crc32c(crc,buf,crc_size);
-        if (crc == 0) crc = 1;
-        ((rozofs_stor_bins_hdr_t*)(buf))->s.filler = crc;
-      }	
-      buf+=prj_size;   
+      buf[nb]   = bins + i*prj_size;
+      idx[nb++] = i;
+      if (nb == STORIO_CRC32_PASS) {
+        storio_gen_crc32_group(buf,idx,nb,prj_size,initial_crc);
+        nb = 0;
+      }
    }
+   if (nb) storio_gen_crc32_group(buf,idx,nb,prj_size,initial_crc);
 }
 
 /*
@@ -508,69 +794,34 @@ int storio_check_crc32(char     * bins,
 		       uint32_t   initial_crc, 
 		       uint64_t * errors)
 {
-   size_t crc_size = prj_size;
-   uint32_t crc = 0;
-   uint32_t cur_crc;
-   int i;
-   char *buf=bins;
-   int result = 0;
-#if 0
-   uint64_t encode_cycles_start;
-   uint64_t encode_cycles_stop;
-#endif   
+   char   * buf[STORIO_CRC32_PASS];
+   uint32_t cur_crc[STORIO_CRC32_PASS];
+   int      idx[STORIO_CRC32_PASS];
+   int      i;
+   int      nb = 0;
+   int      result = 0;
+
    if (crc32c_check_enable == 0) return 0;
-#if 0
-   encode_cycles_start = rdtsc();
-#endif   
+
    for (i = 0; i < nb_proj ; i++)
    {
+      buf[nb] = bins + i*prj_size;
       /*
       ** check if crc has been generated on write
       */
-      cur_crc = ((rozofs_stor_bins_hdr_t*)(buf))->s.filler;
-
-      if (cur_crc == 0) continue;
-      /*
-      **  compute the crc
-      */
-      ((rozofs_stor_bins_hdr_t*)(buf))->s.filler = 0;
-      crc = initial_crc + i;
-      crc = crc32c(crc,buf,crc_size);
-      if (crc==0) crc = 1;      
-
-      /*
-      ** control with the one stored in the header
-      */
-      if (cur_crc != crc)
-      {
-        /*
-	** data corruption
-	*/
-	((rozofs_stor_bins_hdr_t*)(buf))->s.projection_id = 0xff;
-	/*
-	** increment the global counter and the storage counter
-	*/
-	__atomic_fetch_add(&storio_crc_error,1,__ATOMIC_SEQ_CST);
-	__atomic_fetch_add(crc_error_cnt_p,1,__ATOMIC_SEQ_CST);
-	errors[i/64] |= (1ULL<<(i%64));
-	result++;
+      cur_crc[nb] = ((rozofs_stor_bins_hdr_t*)(buf[nb]))->s.filler;
+      if (cur_crc[nb] == 0) continue;
+      
+      idx[nb++] = i;
+      if (nb == STORIO_CRC32_PASS) {
+        result += storio_check_crc32_group(buf,cur_crc,idx,nb,prj_size,crc_error_cnt_p,initial_crc,errors);
+        nb = 0;
       }
-      buf+=prj_size;   
    }
-#if 0
-   encode_cycles_stop = rdtsc();
-        severe("FDL(%d) encode cycles %llu length %d count %d\n",crc32c_hw_supported,
-	       (unsigned long long int)(encode_cycles_stop - encode_cycles_start),prj_size,nb_proj);
-#endif
-  if (result) {
-    if (result<STORIO_MAX_CRC32_ERROR_PER_READ_COUNT) {
-      storio_crc32_error_per_read[result]++;
-    }  
-    else {
-      storio_crc32_error_per_read[STORIO_MAX_CRC32_ERROR_PER_READ_COUNT-1]++;
-    }
-  }
-  return result;
+   if (nb) result += storio_check_crc32_group(buf,cur_crc,idx,nb,prj_size,crc_error_cnt_p,initial_crc,errors);
+   
+   storio_crc32_error_per_read_update(result);
+   return result;
 }
 
 /*
@@ -587,23 +838,28 @@ int storio_check_crc32(char     * bins,
 */
 void storio_gen_crc32_vect(struct iovec *vector,int nb_proj,uint16_t prj_size, uint32_t initial_crc)
 {
-   size_t crc_size = prj_size;
-   uint32_t crc = 0;
-   int i;
-   char *buf;
-
+   char * buf[STORIO_CRC32_PASS];
+   int    idx[STORIO_CRC32_PASS];
+   int    i;
+   int    nb = 0;
+
+   if (crc32c_generate_enable == 0) {
+     for (i = 0; i < nb_proj ; i++) {
+       ((rozofs_stor_bins_hdr_t*)(vector[i].iov_base))->s.filler = 0;
+     }
+     return;
+   }
 
    for (i = 0; i < nb_proj ; i++)
    {
-      crc = initial_crc + i;
-      buf = vector[i].iov_base;
-      ((rozofs_stor_bins_hdr_t*)(buf))->s.filler = 0;
-      if (crc32c_generate_enable) {
-        crc = crc32c(crc,buf,crc_size);
-        if (crc==0) crc = 1;
-        ((rozofs_stor_bins_hdr_t*)(buf))->s.filler = crc;
-      }	
+      buf[nb]   = vector[i].iov_base;
+      idx[nb++] = i;
+      if (nb == STORIO_CRC32_PASS) {
+        storio_gen_crc32_group(buf,idx,nb,prj_size,initial_crc);
+        nb = 0;
+      }
    }
+   if (nb) storio_gen_crc32_group(buf,idx,nb,prj_size,initial_crc);
 }
 
 /*
@@ -630,56 +886,33 @@ int  storio_check_crc32_vect(struct iovec * vector,
 			     uint32_t       initial_crc, 
 			     uint64_t     * errors)
 {
-   size_t crc_size = prj_size;
-   uint32_t crc = 0;
-   uint32_t cur_crc;
-   int i;
-   char *buf;
-   int  result=0;
+   char   * buf[STORIO_CRC32_PASS];
+   uint32_t cur_crc[STORIO_CRC32_PASS];
+   int      idx[STORIO_CRC32_PASS];
+   int      i;
+   int      nb = 0;
+   int      result = 0;
 
    if (crc32c_check_enable == 0) return 0;
       
    for (i = 0; i < nb_proj ; i++)
    {
+      buf[nb] = vector[i].iov_base;
       /*
       ** check if crc has been generated on write
       */
-      buf = vector[i].iov_base;
-      cur_crc = ((rozofs_stor_bins_hdr_t*)(buf))->s.filler;
-      if (cur_crc == 0) continue;
-      /*
-      **  compute the crc
-      */
-      ((rozofs_stor_bins_hdr_t*)(buf))->s.filler = 0;
-      crc = initial_crc + i;
-      crc = crc32c(crc,buf,crc_size);
-      if (crc==0) crc = 1;      
-      /*
-      ** control with the one stored in the header
-      */    
-      if (cur_crc != crc)
-      {
-        /*
-	** data corruption
-	*/
-	((rozofs_stor_bins_hdr_t*)(buf))->s.projection_id = 0xff;
-	/*
-	** increment the global counter and the storage counter
-	*/
-	__atomic_fetch_add(&storio_crc_error,1,__ATOMIC_SEQ_CST);
-	__atomic_fetch_add(crc_error_cnt_p,1,__ATOMIC_SEQ_CST);
-        errors[i/64] |= (1ULL<<(i%64));
-	result++;	
+      cur_crc[nb] = ((rozofs_stor_bins_hdr_t*)(buf[nb]))->s.filler;
+      if (cur_crc[nb] == 0) continue;
+      
+      idx[nb++] = i;
+      if (nb == STORIO_CRC32_PASS) {
+        result += storio_check_crc32_group(buf,cur_crc,idx,nb,prj_size,crc_error_cnt_p,initial_crc,errors);
+        nb = 0;
       }
    }
-   if (result) {
-     if (result<STORIO_MAX_CRC32_ERROR_PER_READ_COUNT) {
-       storio_crc32_error_per_read[result]++;
-     }  
-     else {
-       storio_crc32_error_per_read[STORIO_MAX_CRC32_ERROR_PER_READ_COUNT-1]++;
-     }
-   }
+   if (nb) result += storio_check_crc32_group(buf,cur_crc,idx,nb,prj_size,crc_error_cnt_p,initial_crc,errors);
+
+   storio_crc32_error_per_read_update(result);
    return result;
 }
 /*
@@ -745,6 +978,9 @@ static void show_data_integrity(char * argv[], uint32_t tcpRef, void *bufRef)
      if (crc32c_hw_supported==0) {
        pChar += rozofs_string_append(pChar,"SOFTWARE\n");
      }
+     else if (crc32c_pclmul_supported) {
+       pChar += rozofs_string_append(pChar,"HARDWARE 3-way folded\n");       
+     }
      else {
        pChar += rozofs_string_append(pChar,"HARDWARE\n");       
      }       
@@ -781,9 +1017,17 @@ void crc32c_init(int generate_enable,int check_enable,int hw_forced)
     int sse42;
 
 
+    int pclmul;
+
+
     SSE42(sse42);
     if (sse42== 1) crc32c_hw_supported = 1;
     if (hw_forced) crc32c_hw_supported = 1;
+    PCLMUL(pclmul);
+    if ((crc32c_hw_supported) && (pclmul == 1)) {
+      crc32c_init_fold();
+      crc32c_pclmul_supported = 1;
+    }
     pthread_once(&crc32c_once_hw, crc32c_init_hw);
     crc32c_check_enable = 0;
     crc32c_generate_enable = generate_enable;
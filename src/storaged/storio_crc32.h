@@ -26,6 +26,7 @@
 #include "storage.h"
 
 extern int crc32c_hw_spported ;
+extern int crc32c_pclmul_supported; /**< 1 when the 3-way folded hardware CRC is used */
 extern int crc32c_generate_enable;  /**< assert to 1 for CRC generation  */
 extern int crc32c_check_enable;  /**< assert to 1 for CRC generation  */
 extern uint64_t storio_crc_error;
@@ -0,0 +1,505 @@
+/*
+  Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+  This file is part of Rozofs.
+
+  Rozofs is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation, version 2.
+
+  Rozofs is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see
+  <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <rozofs/rozofs.h>
+#include <rozofs/rozofs_srv.h>
+#include <rozofs/common/log.h>
+#include <rozofs/common/common_config.h>
+#include <rozofs/core/uma_dbg_api.h>
+#include <rozofs/core/rozofs_string.h>
+
+#include "storage.h"
+#include "storio_dirty.h"
+
+/*
+** Last journaled block range of a chunk
+*/
+typedef struct _storio_dirty_cache_t {
+  storage_t * st;
+  fid_t       fid;
+  sid_t       dirty_sid;
+  uint32_t    chunk;
+  uint32_t    block_start;
+  uint32_t    block_end;
+  time_t      ts;
+} storio_dirty_cache_t;
+
+#define STORIO_DIRTY_CACHE_SIZE   256
+/*
+** A cached range is not trusted longer than this delay (sec), so that
+** a range is journaled again once the journal has been frozen by a rebuild
+*/
+#define STORIO_DIRTY_CACHE_DELAY  10
+
+static __thread storio_dirty_cache_t storio_dirty_cache[STORIO_DIRTY_CACHE_SIZE];
+
+static uint64_t storio_dirty_stats_recorded = 0;   /**< entries appended to the journals */
+static uint64_t storio_dirty_stats_cached = 0;     /**< writes already covered by the cache */
+static uint64_t storio_dirty_stats_overflow = 0;   /**< writes lost because of a full journal */
+static uint64_t storio_dirty_stats_errors = 0;     /**< journal access errors */
+
+/*__________________________________________________________________________
+*/
+/**
+*  Name of the journal of a storage to rebuild
+*
+* @param path      where to format the name
+* @param st        the local storage
+* @param dirty_sid the storage to rebuild
+* @param ext       NULL for the journal, else the extension of the name
+*
+* @retval the end of the formated string
+*/
+static inline char * storio_dirty_path(char * path, storage_t * st, sid_t dirty_sid, char * ext) {
+  char * pChar = path;
+
+  pChar += rozofs_string_append(pChar,st->root);
+  pChar += rozofs_string_append(pChar,"/"STORIO_DIRTY_DIR"/");
+  pChar += rozofs_u32_append(pChar,dirty_sid);
+  if (ext != NULL) {
+    pChar += rozofs_string_append(pChar,ext);
+  }
+  return pChar;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Open and lock the journal of a storage to rebuild
+*
+*  The journal may be renamed by a freeze between the open and the lock.
+*  The journal is then open again, so that nothing is appended to a file
+*  that has been frozen.
+*
+* @param path      the name of the journal
+* @param flags     open flags
+*
+* @retval the file descriptor or -1 (errno is set)
+*/
+static int storio_dirty_open_locked(char * path, int flags) {
+  struct stat fd_stat;
+  struct stat path_stat;
+  int         fd;
+
+  while (1) {
+    fd = open(path, flags, ROZOFS_ST_BINS_FILE_MODE);
+    if (fd < 0) return -1;
+    if (flock(fd, LOCK_EX) < 0) {
+      close(fd);
+      return -1;
+    }
+    if ((fstat(fd, &fd_stat) == 0) && (stat(path, &path_stat) == 0)
+    &&  (fd_stat.st_dev == path_stat.st_dev) && (fd_stat.st_ino == path_stat.st_ino)) {
+      return fd;
+    }
+    close(fd);
+  }
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Append a file to another one and remove it
+*
+* @param src       the file to append
+* @param dst       the file to append to
+*
+* @retval 0 on success -1 on error (errno is set)
+*/
+static int storio_dirty_move_entries(char * src, char * dst) {
+  rozofs_rebuild_entry_file_t tab[64];
+  int                         fd_in;
+  int                         fd_out;
+  int                         size;
+
+  fd_in = open(src, O_RDONLY);
+  if (fd_in < 0) {
+    if (errno == ENOENT) return 0;
+    severe("open(%s) %s",src,strerror(errno));
+    return -1;
+  }
+  fd_out = open(dst, O_WRONLY | O_APPEND | O_CREAT, ROZOFS_ST_BINS_FILE_MODE);
+  if (fd_out < 0) {
+    severe("open(%s) %s",dst,strerror(errno));
+    close(fd_in);
+    return -1;
+  }
+
+  while ((size = read(fd_in, tab, sizeof(tab))) > 0) {
+    if (write(fd_out, tab, size) != size) {
+      severe("write(%s) %s",dst,strerror(errno));
+      close(fd_in);
+      close(fd_out);
+      return -1;
+    }
+  }
+  close(fd_in);
+  close(fd_out);
+  unlink(src);
+  return 0;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Append an entry to the journal of a storage to rebuild
+*
+* @param st        the local storage
+* @param dirty_sid the storage to rebuild
+* @param entry     the entry to append
+*/
+static void storio_dirty_append(storage_t * st, sid_t dirty_sid, rozofs_rebuild_entry_file_t * entry) {
+  char        path[FILENAME_MAX];
+  struct stat buf;
+  uint64_t    max;
+  int         fd;
+
+  storio_dirty_path(path, st, dirty_sid, NULL);
+  fd = storio_dirty_open_locked(path, O_WRONLY | O_APPEND | O_CREAT);
+  if ((fd < 0) && (errno == ENOENT)) {
+    char dir[FILENAME_MAX];
+    char * pChar = dir;
+    pChar += rozofs_string_append(pChar,st->root);
+    pChar += rozofs_string_append(pChar,"/"STORIO_DIRTY_DIR);
+    if (storage_create_dir(dir) == 0) {
+      fd = storio_dirty_open_locked(path, O_WRONLY | O_APPEND | O_CREAT);
+    }
+  }
+  if (fd < 0) {
+    __atomic_fetch_add(&storio_dirty_stats_errors,1,__ATOMIC_SEQ_CST);
+    severe("open(%s) %s",path,strerror(errno));
+    return;
+  }
+
+  if (fstat(fd,&buf) < 0) {
+    __atomic_fetch_add(&storio_dirty_stats_errors,1,__ATOMIC_SEQ_CST);
+    severe("fstat(%s) %s",path,strerror(errno));
+    close(fd);
+    return;
+  }
+
+  /*
+  ** The journal is full. A null FID entry tells it has overflown.
+  */
+  max = (uint64_t)common_config.storio_dirty_journal * 1024 * 1024;
+  if (buf.st_size >= max) {
+    __atomic_fetch_add(&storio_dirty_stats_overflow,1,__ATOMIC_SEQ_CST);
+    close(fd);
+    return;
+  }
+  if ((buf.st_size + 2*sizeof(rozofs_rebuild_entry_file_t)) > max) {
+    memset(entry->fid, 0, sizeof(fid_t));
+    __atomic_fetch_add(&storio_dirty_stats_overflow,1,__ATOMIC_SEQ_CST);
+    warning("%s is full",path);
+  }
+
+  if (write(fd, entry, sizeof(rozofs_rebuild_entry_file_t)) != sizeof(rozofs_rebuild_entry_file_t)) {
+    __atomic_fetch_add(&storio_dirty_stats_errors,1,__ATOMIC_SEQ_CST);
+    severe("write(%s) %s",path,strerror(errno));
+  }
+  else {
+    __atomic_fetch_add(&storio_dirty_stats_recorded,1,__ATOMIC_SEQ_CST);
+  }
+  close(fd);
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Record in the journal of a nominal storage a spare write
+*
+* @param st        the storage that received the spare write
+* @param layout    the layout of the file
+* @param bsize     the block size of the file
+* @param dist_set  the distribution of the file
+* @param prj_id    the projection index, i.e the index of the nominal storage
+* @param fid       the FID of the file
+* @param bid       the first block written
+* @param nb_blocks the number of blocks written
+*/
+void storio_dirty_record(storage_t * st, uint8_t layout, uint8_t bsize, sid_t * dist_set,
+                         uint8_t prj_id, fid_t fid, bid_t bid, uint32_t nb_blocks) {
+  storio_dirty_cache_t      * p;
+  rozofs_rebuild_entry_file_t entry;
+  sid_t                       dirty_sid;
+  uint32_t                    chunk;
+  uint32_t                    block_end;
+  uint32_t                    hash = 0;
+  uint8_t                   * c;
+  time_t                      now;
+  int                         i;
+
+  if (common_config.storio_dirty_journal == 0) return;
+  if (prj_id >= rozofs_get_rozofs_forward(layout)) return;
+  if (nb_blocks == 0) return;
+
+  dirty_sid = dist_set[prj_id];
+  chunk     = bid / ROZOFS_STORAGE_NB_BLOCK_PER_CHUNK(bsize);
+  block_end = bid + nb_blocks - 1;
+  now       = time(NULL);
+
+  c = (uint8_t *) fid;
+  for (i = 0; i < sizeof(fid_t); c++,i++)
+    hash = *c + (hash << 6) + (hash << 16) - hash;
+  hash = (hash + chunk + dirty_sid) % STORIO_DIRTY_CACHE_SIZE;
+  p = &storio_dirty_cache[hash];
+
+  /*
+  ** Same chunk of the same file for the same storage
+  */
+  if ((p->st == st) && (p->dirty_sid == dirty_sid) && (p->chunk == chunk)
+  &&  ((now - p->ts) < STORIO_DIRTY_CACHE_DELAY)
+  &&  (memcmp(p->fid, fid, sizeof(fid_t)) == 0)) {
+
+    if ((bid >= p->block_start) && (block_end <= p->block_end)) {
+      __atomic_fetch_add(&storio_dirty_stats_cached,1,__ATOMIC_SEQ_CST);
+      return;
+    }
+    /*
+    ** Journal the union of the ranges
+    */
+    if (p->block_start < bid)       bid       = p->block_start;
+    if (p->block_end   > block_end) block_end = p->block_end;
+  }
+  else {
+    p->st        = st;
+    p->dirty_sid = dirty_sid;
+    p->chunk     = chunk;
+    memcpy(p->fid, fid, sizeof(fid_t));
+  }
+  p->block_start = bid;
+  p->block_end   = block_end;
+  p->ts          = now;
+
+  memset(&entry, 0, sizeof(entry));
+  memcpy(entry.fid, fid, sizeof(fid_t));
+  entry.block_start = bid;
+  entry.block_end   = block_end;
+  entry.layout      = layout;
+  entry.bsize       = bsize;
+  entry.todo        = 1;
+  entry.relocate    = 0;
+  entry.error       = rozofs_rbs_error_none;
+  memcpy(entry.dist_set_current, dist_set, sizeof(sid_t) * ROZOFS_SAFE_MAX);
+
+  storio_dirty_append(st, dirty_sid, &entry);
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Freeze the journal of a storage to rebuild
+*
+*  The journal is renamed <sid>.rebuild with the journal lock held, so
+*  the storio goes on journaling in a new file. When a frozen journal 
+*  remains from a previous rebuild that failed, the journal is renamed
+*  <sid>.freeze instead, and then appended to the frozen journal.
+*
+* @param st        the local storage
+* @param dirty_sid the storage to rebuild
+*
+* @retval 0 on success -1 on error (errno is set)
+*/
+static int storio_dirty_freeze(storage_t * st, sid_t dirty_sid) {
+  char   path[FILENAME_MAX];
+  char   frozen[FILENAME_MAX];
+  char   freezing[FILENAME_MAX];
+  char * target;
+  int    fd;
+
+  storio_dirty_path(path, st, dirty_sid, NULL);
+  storio_dirty_path(frozen, st, dirty_sid, STORIO_DIRTY_FROZEN_EXT);
+  storio_dirty_path(freezing, st, dirty_sid, STORIO_DIRTY_FREEZING_EXT);
+
+  /*
+  ** A previous freeze has been interrupted
+  */
+  if (storio_dirty_move_entries(freezing, frozen) != 0) return -1;
+
+  fd = storio_dirty_open_locked(path, O_RDONLY);
+  if (fd < 0) {
+    if (errno == ENOENT) return 0;
+    severe("open(%s) %s",path,strerror(errno));
+    return -1;
+  }
+  target = frozen;
+  if (access(frozen, F_OK) == 0) target = freezing;
+  if (rename(path, target) != 0) {
+    severe("rename(%s,%s) %s",path,target,strerror(errno));
+    close(fd);
+    return -1;
+  }
+  close(fd);
+
+  if (target == frozen) return 0;
+  return storio_dirty_move_entries(freezing, frozen);
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Read the journal of a storage to rebuild
+*
+*  On the 1rst call (null cookie), the current journal is frozen in a
+*  <sid>.rebuild file, that is read on the next calls, while the storio
+*  goes on journaling in a new file.
+*
+* @param st        the local storage
+* @param dirty_sid the storage to rebuild
+* @param cookie    where to read from in the frozen journal. Updated.
+* @param entries   the table to fill
+* @param max       the size of the table
+* @param nb        returns the number of entries read
+* @param overflow  set to 1 when the journal has overflown
+* @param eof       set to 1 when the end of the journal is reached
+*
+* @retval 0 on success -1 on error (errno is set)
+*/
+int storio_dirty_list(storage_t * st, sid_t dirty_sid, uint64_t * cookie,
+                      mp_dirty_entry_t * entries, int max, int * nb,
+		      uint8_t * overflow, uint8_t * eof) {
+  char                        frozen[FILENAME_MAX];
+  rozofs_rebuild_entry_file_t tab[MP_DIRTY_MAX_ENTRIES];
+  fid_t                       fid_null;
+  int                         fd;
+  int                         size;
+  int                         idx;
+
+  *nb       = 0;
+  *overflow = 0;
+  *eof      = 1;
+  if (max > MP_DIRTY_MAX_ENTRIES) max = MP_DIRTY_MAX_ENTRIES;
+
+  if (*cookie == 0) {
+    if (storio_dirty_freeze(st, dirty_sid) != 0) return -1;
+  }
+
+  storio_dirty_path(frozen, st, dirty_sid, STORIO_DIRTY_FROZEN_EXT);
+  fd = open(frozen, O_RDONLY);
+  if (fd < 0) {
+    if (errno == ENOENT) return 0;
+    severe("open(%s) %s",frozen,strerror(errno));
+    return -1;
+  }
+
+  size = pread(fd, tab, max * sizeof(rozofs_rebuild_entry_file_t), *cookie);
+  close(fd);
+  if (size < 0) {
+    severe("pread(%s) %s",frozen,strerror(errno));
+    return -1;
+  }
+
+  memset(fid_null, 0, sizeof(fid_t));
+  for (idx=0; idx < size / sizeof(rozofs_rebuild_entry_file_t); idx++) {
+
+    if (memcmp(tab[idx].fid, fid_null, sizeof(fid_t)) == 0) {
+      *overflow = 1;
+      continue;
+    }
+    memcpy(entries[*nb].fid, tab[idx].fid, sizeof(fid_t));
+    entries[*nb].block_start = tab[idx].block_start;
+    entries[*nb].block_end   = tab[idx].block_end;
+    entries[*nb].layout      = tab[idx].layout;
+    entries[*nb].bsize       = tab[idx].bsize;
+    memcpy(entries[*nb].dist_set, tab[idx].dist_set_current, sizeof(sid_t) * ROZOFS_SAFE_MAX);
+    *nb += 1;
+  }
+
+  *cookie += idx * sizeof(rozofs_rebuild_entry_file_t);
+  if (idx == max) *eof = 0;
+  return 0;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Remove the frozen journal of a storage once it is rebuilt
+*
+* @param st        the local storage
+* @param dirty_sid the rebuilt storage
+*
+* @retval 0 on success -1 on error (errno is set)
+*/
+int storio_dirty_clear(storage_t * st, sid_t dirty_sid) {
+  char frozen[FILENAME_MAX];
+
+  storio_dirty_path(frozen, st, dirty_sid, STORIO_DIRTY_FROZEN_EXT);
+  if ((unlink(frozen) < 0) && (errno != ENOENT)) {
+    severe("unlink(%s) %s",frozen,strerror(errno));
+    return -1;
+  }
+  return 0;
+}
+/*_______________________________________________________________________
+* Dirty journal debug help
+*/
+static char * storio_dirty_debug_help(char * pChar) {
+  pChar += rozofs_string_append(pChar,"usage:\ndirty reset       : reset dirty chunk journal counters\n");
+  return pChar;
+}
+/*_______________________________________________________________________
+* Dirty journal debug function
+*/
+static void storio_dirty_debug(char * argv[], uint32_t tcpRef, void *bufRef) {
+  char * p = uma_dbg_get_buffer();
+
+  if (argv[1] != NULL) {
+    if (strcmp(argv[1],"reset")!=0) {
+      p = storio_dirty_debug_help(p);
+      uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
+      return;
+    }
+  }
+
+  if (common_config.storio_dirty_journal == 0) {
+    p += rozofs_string_append(p,"dirty chunk journal is disabled\n");
+    uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
+    return;
+  }
+
+  p += rozofs_string_append(p,"max size (MB) = ");
+  p += rozofs_u32_append(p,common_config.storio_dirty_journal);
+  p += rozofs_string_append(p,"\nrecorded      = ");
+  p += rozofs_u64_append(p,storio_dirty_stats_recorded);
+  p += rozofs_string_append(p,"\ncached        = ");
+  p += rozofs_u64_append(p,storio_dirty_stats_cached);
+  p += rozofs_string_append(p,"\noverflow      = ");
+  p += rozofs_u64_append(p,storio_dirty_stats_overflow);
+  p += rozofs_string_append(p,"\nerrors        = ");
+  p += rozofs_u64_append(p,storio_dirty_stats_errors);
+  p += rozofs_string_append(p,"\n");
+
+  if (argv[1] != NULL) {
+    storio_dirty_stats_recorded = 0;
+    storio_dirty_stats_cached   = 0;
+    storio_dirty_stats_overflow = 0;
+    storio_dirty_stats_errors   = 0;
+    p += rozofs_string_append(p,"Reset Done\n");
+  }
+  uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Register the rozodiag dirty topic of the storio
+*/
+void storio_dirty_init(void) {
+  uma_dbg_addTopic_option("dirty", storio_dirty_debug, UMA_DBG_OPTION_RESET);
+}
@@ -0,0 +1,108 @@
+/*
+ Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+ This file is part of Rozofs.
+
+ Rozofs is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published
+ by the Free Software Foundation, version 2.
+
+ Rozofs is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see
+ <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef STORIO_DIRTY_H
+#define STORIO_DIRTY_H
+
+#include <stdint.h>
+#include <rozofs/rozofs.h>
+#include <rozofs/rpc/mproto.h>
+
+#include "storage.h"
+
+/*
+** Dirty chunk journal.
+**
+** A storcli writes a projection on a spare storage only when the
+** nominal storage of this projection is unreachable. So when a storio
+** receives a spare write (out of any rebuild), the nominal storage
+** dist_set[proj_id] misses these blocks. The storio appends the FID and
+** the block range to the journal of this nominal storage, a file
+** <root>/dirty/<sid> of the local storage. These files are read back by
+** the storaged (MP_LIST_DIRTY), so that storage_rebuild --dirty only
+** rebuilds the ranges written while the storage was unreachable.
+**
+** Each journal entry is a rebuild job entry. Consecutive writes in the
+** same chunk are journaled once thanks to a small per disk thread cache.
+** A journal does not grow beyond storio_dirty_journal MB. When full, a
+** null FID entry is appended and the journal is said to overflow : a
+** full rebuild is then required.
+*/
+#define STORIO_DIRTY_DIR          "dirty"
+#define STORIO_DIRTY_FROZEN_EXT   ".rebuild"
+#define STORIO_DIRTY_FREEZING_EXT ".freeze"
+
+/*__________________________________________________________________________
+*/
+/**
+*  Record in the journal of a nominal storage a spare write
+*
+* @param st        the storage that received the spare write
+* @param layout    the layout of the file
+* @param bsize     the block size of the file
+* @param dist_set  the distribution of the file
+* @param prj_id    the projection index, i.e the index of the nominal storage
+* @param fid       the FID of the file
+* @param bid       the first block written
+* @param nb_blocks the number of blocks written
+*/
+void storio_dirty_record(storage_t * st, uint8_t layout, uint8_t bsize, sid_t * dist_set,
+                         uint8_t prj_id, fid_t fid, bid_t bid, uint32_t nb_blocks);
+/*__________________________________________________________________________
+*/
+/**
+*  Read the journal of a storage to rebuild
+*
+*  On the 1rst call (null cookie), the current journal is frozen in a
+*  <sid>.rebuild file, that is read on the next calls, while the storio
+*  goes on journaling in a new file.
+*
+* @param st        the local storage
+* @param dirty_sid the storage to rebuild
+* @param cookie    where to read from in the frozen journal. Updated.
+* @param entries   the table to fill
+* @param max       the size of the table
+* @param nb        returns the number of entries read
+* @param overflow  set to 1 when the journal has overflown
+* @param eof       set to 1 when the end of the journal is reached
+*
+* @retval 0 on success -1 on error (errno is set)
+*/
+int storio_dirty_list(storage_t * st, sid_t dirty_sid, uint64_t * cookie,
+                      mp_dirty_entry_t * entries, int max, int * nb,
+		      uint8_t * overflow, uint8_t * eof);
+/*__________________________________________________________________________
+*/
+/**
+*  Remove the frozen journal of a storage once it is rebuilt
+*
+* @param st        the local storage
+* @param dirty_sid the rebuilt storage
+*
+* @retval 0 on success -1 on error (errno is set)
+*/
+int storio_dirty_clear(storage_t * st, sid_t dirty_sid);
+/*__________________________________________________________________________
+*/
+/**
+*  Register the rozodiag dirty topic of the storio
+*/
+void storio_dirty_init(void);
+
+#endif
@@ -25,6 +25,7 @@
 #include <errno.h>  
 #include <time.h>
 #include <pthread.h> 
+#include <poll.h>
 #include <rozofs/core/ruc_common.h>
 #include <rozofs/core/ruc_list.h>
 #include <rozofs/core/af_unix_socket_generic_api.h>
@@ -33,9 +34,14 @@
 #include <rozofs/core/uma_dbg_api.h>
 #include <rozofs/rpc/rozofs_rpc_util.h>
 #include <rozofs/rpc/sproto.h>
+#include <rozofs/common/common_config.h>
+#include <rozofs/common/xmalloc.h>
 #include "storio_disk_thread_intf.h" 
 #include "storage.h" 
 #include "storio_device_mapping.h" 
+#include "storio_north_intf.h" 
+#include "storio_uring.h" 
+#include "storio_dirty.h" 
 
 int af_unix_disk_socket_ref = -1;
  
@@ -300,25 +306,21 @@ out:
 /*__________________________________________________________________________
 */
 /**
-*  Read data from a file
+*  Check a read request and retrieve the storage and the FID context.
+   On failure the error response is sent back to the main thread.
 
   @param thread_ctx_p: pointer to the thread context
   @param msg         : address of the message received
+  @param st          : returned storage
+  @param fidCtx      : returned FID context
   
-  @retval: none
+  @retval: 0 when the read can be done, -1 when the response has been sent
 */
-static inline void storio_disk_read(rozofs_disk_thread_ctx_t *thread_ctx_p,storio_disk_thread_msg_t * msg) {
-  struct timeval     timeDay;
-  unsigned long long timeBefore, timeAfter;
-  storage_t *st = 0;
+static inline int storio_disk_read_check(rozofs_disk_thread_ctx_t *thread_ctx_p,storio_disk_thread_msg_t * msg,
+                                         storage_t ** st, storio_device_mapping_t ** fidCtx) {
   sp_read_arg_t          * args;
   rozorpc_srv_ctx_t      * rpcCtx;
   sp_read_ret_t            ret;
-  int                      is_fid_faulty;
-  storio_device_mapping_t * fidCtx;
-    
-  gettimeofday(&timeDay,(struct timezone *)0);  
-  timeBefore = MICROLONG(timeDay);
 
   ret.status = SP_FAILURE;      
 	          
@@ -330,66 +332,69 @@ static inline void storio_disk_read(rozofs_disk_thread_ctx_t *thread_ctx_p,stori
   rpcCtx = msg->rpcCtx;
   args   = (sp_read_arg_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
 
-  fidCtx = storio_device_mapping_ctx_retrieve(msg->fidIdx);
-  if (fidCtx == NULL) {
+  *fidCtx = storio_device_mapping_ctx_retrieve(msg->fidIdx);
+  if (*fidCtx == NULL) {
     ret.sp_read_ret_t_u.error = EIO;
     severe("Bad FID ctx index %d",msg->fidIdx); 
     storio_encode_rpc_response(rpcCtx,(char*)&ret);  
     thread_ctx_p->stat.read_error++ ;   
     storio_send_response(thread_ctx_p,msg,-1);
-    return;
+    return -1;
   }  
 
   // Get the storage for the couple (cid;sid)
-  if ((st = storaged_lookup(args->cid, args->sid)) == 0) {
+  if ((*st = storaged_lookup(args->cid, args->sid)) == 0) {
     ret.sp_read_ret_t_u.error = errno;
     storio_encode_rpc_response(rpcCtx,(char*)&ret);  
     thread_ctx_p->stat.read_badCidSid++ ;   
     storio_send_response(thread_ctx_p,msg,-1);
-    return;
+    return -1;
   }
   
   // Check whether this is exactly the same FID
   // This is to handle the case when the read request has been serialized
   // After serialization, the recycling counter may not be the same !!!
-  if (fidCtx->device[0] != ROZOFS_UNKNOWN_CHUNK) {
-    if (rozofs_get_recycle_from_fid(args->fid) != fidCtx->recycle_cpt) {
+  if ((*fidCtx)->device[0] != ROZOFS_UNKNOWN_CHUNK) {
+    if (rozofs_get_recycle_from_fid(args->fid) != (*fidCtx)->recycle_cpt) {
       // This is not the same recycling counter, so not the same file
       ret.sp_read_ret_t_u.error = ENOENT;
       storio_encode_rpc_response(rpcCtx,(char*)&ret); 
       thread_ctx_p->stat.read_nosuchfile++ ;          
       storio_send_response(thread_ctx_p,msg,-1);
-      return;
+      return -1;
     }
   }  
-    
-  /*
-  ** set the pointer to the bins
-  */
-  char *pbuf = ruc_buf_getPayload(rpcCtx->xmitBuf);
-  pbuf += rpcCtx->position;     
-  /*
-  ** clear the length of the bins and set the pointer where data must be returned
-  */  
-  ret.sp_read_ret_t_u.rsp.bins.bins_val = pbuf;
-  ret.sp_read_ret_t_u.rsp.bins.bins_len = 0;
-#if 0 // for future usage with distributed cache 
-  /*
-  ** clear the optimization array
-  */
-  ret.sp_read_ret_t_u.rsp.optim.optim_val = (char*)sp_optim;
-  ret.sp_read_ret_t_u.rsp.optim.optim_len = 0;
-#endif   
+  return 0;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Send back the response of a read request
+
+  @param thread_ctx_p : pointer to the thread context
+  @param msg          : address of the message received
+  @param result       : 0 on success, -1 on error (errno is set)
+  @param len_read     : length of the bins read
+  @param file_size    : size of the file
+  @param is_fid_faulty: whether a fault is localized in the file
+  @param timeBefore   : time stamp of the start of the request processing
+  
+  @retval: none
+*/
+static inline void storio_disk_read_reply(rozofs_disk_thread_ctx_t *thread_ctx_p,storio_disk_thread_msg_t * msg,
+                                          int result, size_t len_read, uint64_t file_size, int is_fid_faulty,
+                                          unsigned long long timeBefore) {
+  struct timeval     timeDay;
+  unsigned long long timeAfter;
+  sp_read_arg_t          * args;
+  rozorpc_srv_ctx_t      * rpcCtx;
+  sp_read_ret_t            ret;
 
+  rpcCtx = msg->rpcCtx;
+  args   = (sp_read_arg_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
 
-  // Lookup for the device id for this FID
-  // Read projections
-  if (storage_read(st, fidCtx, args->layout, args->bsize,(sid_t *) args->dist_set, args->spare,
-            (unsigned char *) args->fid, args->bid, args->nb_proj,
-            (bin_t *) ret.sp_read_ret_t_u.rsp.bins.bins_val,
-            (size_t *) & ret.sp_read_ret_t_u.rsp.bins.bins_len,
-            &ret.sp_read_ret_t_u.rsp.file_size, &is_fid_faulty) != 0) 
-  {
+  if (result != 0) {
+    ret.status = SP_FAILURE;      
     ret.sp_read_ret_t_u.error = errno;
     if (errno == ENOENT)    thread_ctx_p->stat.read_nosuchfile++;
     else if (!args->spare)  thread_ctx_p->stat.read_error++;
@@ -405,10 +410,19 @@ static inline void storio_disk_read(rozofs_disk_thread_ctx_t *thread_ctx_p,stori
     return;
   }  
  
+  /*
+  ** The bins have been read in the xmit buffer
+  */
+  char *pbuf = ruc_buf_getPayload(rpcCtx->xmitBuf);
+  pbuf += rpcCtx->position;     
+
   ret.status = SP_SUCCESS;  
-  msg->size = ret.sp_read_ret_t_u.rsp.bins.bins_len;        
+  ret.sp_read_ret_t_u.rsp.bins.bins_val = pbuf;
+  ret.sp_read_ret_t_u.rsp.bins.bins_len = len_read;
+  ret.sp_read_ret_t_u.rsp.file_size     = file_size;
+  msg->size = len_read;        
   storio_encode_rpc_response(rpcCtx,(char*)&ret);  
-  thread_ctx_p->stat.read_Byte_count += ret.sp_read_ret_t_u.rsp.bins.bins_len;
+  thread_ctx_p->stat.read_Byte_count += len_read;
   storio_send_response(thread_ctx_p,msg,0);
 
   /*
@@ -421,6 +435,57 @@ static inline void storio_disk_read(rozofs_disk_thread_ctx_t *thread_ctx_p,stori
 /*__________________________________________________________________________
 */
 /**
+*  Read data from a file
+
+  @param thread_ctx_p: pointer to the thread context
+  @param msg         : address of the message received
+  
+  @retval: none
+*/
+static inline void storio_disk_read(rozofs_disk_thread_ctx_t *thread_ctx_p,storio_disk_thread_msg_t * msg) {
+  struct timeval     timeDay;
+  unsigned long long timeBefore;
+  storage_t *st = 0;
+  sp_read_arg_t          * args;
+  rozorpc_srv_ctx_t      * rpcCtx;
+  int                      is_fid_faulty = 0;
+  storio_device_mapping_t * fidCtx;
+  size_t                   len_read = 0;
+  uint64_t                 file_size = 0;
+  int                      result;
+    
+  gettimeofday(&timeDay,(struct timezone *)0);  
+  timeBefore = MICROLONG(timeDay);
+
+  if (storio_disk_read_check(thread_ctx_p,msg,&st,&fidCtx) != 0) return;
+
+  rpcCtx = msg->rpcCtx;
+  args   = (sp_read_arg_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
+    
+  /*
+  ** set the pointer to the bins
+  */
+  char *pbuf = ruc_buf_getPayload(rpcCtx->xmitBuf);
+  pbuf += rpcCtx->position;     
+#if 0 // for future usage with distributed cache 
+  /*
+  ** clear the optimization array
+  */
+  ret.sp_read_ret_t_u.rsp.optim.optim_val = (char*)sp_optim;
+  ret.sp_read_ret_t_u.rsp.optim.optim_len = 0;
+#endif   
+
+
+  // Lookup for the device id for this FID
+  // Read projections
+  result = storage_read(st, fidCtx, args->layout, args->bsize,(sid_t *) args->dist_set, args->spare,
+            (unsigned char *) args->fid, args->bid, args->nb_proj,
+            (bin_t *) pbuf, &len_read, &file_size, &is_fid_faulty);
+  storio_disk_read_reply(thread_ctx_p, msg, result, len_read, file_size, is_fid_faulty, timeBefore);
+}
+/*__________________________________________________________________________
+*/
+/**
 *  Resize file from daa length
 
   @param thread_ctx_p: pointer to the thread context
@@ -542,28 +607,22 @@ static inline void storio_disk_resize(rozofs_disk_thread_ctx_t *thread_ctx_p,sto
 /*__________________________________________________________________________
 */
 /**
-*  Write data to a file
+*  Check a write request and retrieve the storage and the FID context.
+   On failure the error response is sent back to the main thread.
 
   @param thread_ctx_p: pointer to the thread context
   @param msg         : address of the message received
+  @param st          : returned storage
+  @param fidCtx      : returned FID context
   
-  @retval: none
+  @retval: 0 when the write can be done, -1 when the response has been sent
 */
-static inline void storio_disk_write(rozofs_disk_thread_ctx_t *thread_ctx_p,storio_disk_thread_msg_t * msg) {
-  struct timeval     timeDay;
-  unsigned long long timeBefore, timeAfter;
-  storage_t *st = 0;
+static inline int storio_disk_write_check(rozofs_disk_thread_ctx_t *thread_ctx_p,storio_disk_thread_msg_t * msg,
+                                          storage_t ** st, storio_device_mapping_t ** fidCtx) {
   sp_write_arg_no_bins_t * args;
   rozorpc_srv_ctx_t      * rpcCtx;
   sp_write_ret_t           ret;
-  uint8_t                  version = 0;
   int                      size;
-  int                      is_fid_faulty;
-  storio_device_mapping_t * fidCtx;
-    
-  
-  gettimeofday(&timeDay,(struct timezone *)0);  
-  timeBefore = MICROLONG(timeDay);
 
   ret.status = SP_FAILURE;          
   
@@ -575,22 +634,15 @@ static inline void storio_disk_write(rozofs_disk_thread_ctx_t *thread_ctx_p,stor
   rpcCtx = msg->rpcCtx;
   args   = (sp_write_arg_no_bins_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
 
-  fidCtx = storio_device_mapping_ctx_retrieve(msg->fidIdx);
-  if (fidCtx == NULL) {
+  *fidCtx = storio_device_mapping_ctx_retrieve(msg->fidIdx);
+  if (*fidCtx == NULL) {
     ret.sp_write_ret_t_u.error = EIO;
     severe("Bad FID ctx index %d",msg->fidIdx); 
     storio_encode_rpc_response(rpcCtx,(char*)&ret);  
     thread_ctx_p->stat.write_error++ ;   
     storio_send_response(thread_ctx_p,msg,-1);
-    return;
+    return -1;
   }  
-    
-  /*
-  ** set the pointer to the bins that are in the xmit buffer
-  ** since received bufer is also used for the response
-  */
-  char *pbuf = ruc_buf_getPayload(rpcCtx->xmitBuf); 
-  pbuf += rpcCtx->position;
 
   /*
   ** Check that the received data length is consistent with the bins length
@@ -603,7 +655,7 @@ static inline void storio_disk_write(rozofs_disk_thread_ctx_t *thread_ctx_p,stor
     storio_encode_rpc_response(rpcCtx,(char*)&ret);  
     thread_ctx_p->stat.write_error++; 
     storio_send_response(thread_ctx_p,msg,-1); 
-    return;   
+    return -1;   
   }
 
   /*
@@ -620,26 +672,47 @@ static inline void storio_disk_write(rozofs_disk_thread_ctx_t *thread_ctx_p,stor
        storio_encode_rpc_response(rpcCtx,(char*)&ret);  
        thread_ctx_p->stat.write_error++; 
        storio_send_response(thread_ctx_p,msg,-1); 
-       return;         
+       return -1;         
      }	        
   } 
   
 
   // Get the storage for the couple (cid;sid)
-  if ((st = storaged_lookup(args->cid, args->sid)) == 0) {
+  if ((*st = storaged_lookup(args->cid, args->sid)) == 0) {
     ret.sp_write_ret_t_u.error = errno;
     storio_encode_rpc_response(rpcCtx,(char*)&ret);  
     thread_ctx_p->stat.write_badCidSid++ ;   
     storio_send_response(thread_ctx_p,msg,-1);
-    return;
+    return -1;
   }
+  return 0;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Send back the response of a write request
+
+  @param thread_ctx_p : pointer to the thread context
+  @param msg          : address of the message received
+  @param size         : written length or -1 on error (errno is set)
+  @param is_fid_faulty: whether a fault is localized in the file
+  @param timeBefore   : time stamp of the start of the request processing
   
-  
-  // Write projections
-  size =  storage_write(st, fidCtx, args->layout, args->bsize, (sid_t *) args->dist_set, args->spare,
-          (unsigned char *) args->fid, args->bid, args->nb_proj, version,
-          &ret.sp_write_ret_t_u.file_size,(bin_t *) pbuf, &is_fid_faulty);
+  @retval: none
+*/
+static inline void storio_disk_write_reply(rozofs_disk_thread_ctx_t *thread_ctx_p,storio_disk_thread_msg_t * msg,
+                                           int size, int is_fid_faulty, unsigned long long timeBefore) {
+  struct timeval     timeDay;
+  unsigned long long timeAfter;
+  sp_write_arg_no_bins_t * args;
+  rozorpc_srv_ctx_t      * rpcCtx;
+  sp_write_ret_t           ret;
+
+  rpcCtx = msg->rpcCtx;
+  args   = (sp_write_arg_no_bins_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
+
   if (size <= 0)  {
+    ret.status = SP_FAILURE;          
     ret.sp_write_ret_t_u.error = errno;
     if (errno == ENOSPC)
       thread_ctx_p->stat.write_nospace++;
@@ -656,6 +729,18 @@ static inline void storio_disk_write(rozofs_disk_thread_ctx_t *thread_ctx_p,stor
     return;
   }
   msg->size = size;   
+
+  /*
+  ** A spare write out of a rebuild means the nominal storage is unreachable.
+  ** It is journaled before the write is acknowledged.
+  */
+  if ((args->spare) && (args->rebuild_ref == 0)) {
+    storage_t * st = storaged_lookup(args->cid, args->sid);
+    if (st != NULL) {
+      storio_dirty_record(st, args->layout, args->bsize, (sid_t *) args->dist_set, args->proj_id,
+                          (unsigned char *) args->fid, args->bid, args->nb_proj);
+    }
+  }
     
   ret.status = SP_SUCCESS;  
   ret.sp_write_ret_t_u.file_size = 0;
@@ -670,6 +755,50 @@ static inline void storio_disk_write(rozofs_disk_thread_ctx_t *thread_ctx_p,stor
   gettimeofday(&timeDay,(struct timezone *)0);  
   timeAfter = MICROLONG(timeDay);
   thread_ctx_p->stat.write_time +=(timeAfter-timeBefore);  
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Write data to a file
+
+  @param thread_ctx_p: pointer to the thread context
+  @param msg         : address of the message received
+  
+  @retval: none
+*/
+static inline void storio_disk_write(rozofs_disk_thread_ctx_t *thread_ctx_p,storio_disk_thread_msg_t * msg) {
+  struct timeval     timeDay;
+  unsigned long long timeBefore;
+  storage_t *st = 0;
+  sp_write_arg_no_bins_t * args;
+  rozorpc_srv_ctx_t      * rpcCtx;
+  uint8_t                  version = 0;
+  int                      size;
+  int                      is_fid_faulty = 0;
+  uint64_t                 file_size = 0;
+  storio_device_mapping_t * fidCtx;
+    
+  
+  gettimeofday(&timeDay,(struct timezone *)0);  
+  timeBefore = MICROLONG(timeDay);
+
+  if (storio_disk_write_check(thread_ctx_p,msg,&st,&fidCtx) != 0) return;
+
+  rpcCtx = msg->rpcCtx;
+  args   = (sp_write_arg_no_bins_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
+    
+  /*
+  ** set the pointer to the bins that are in the xmit buffer
+  ** since received bufer is also used for the response
+  */
+  char *pbuf = ruc_buf_getPayload(rpcCtx->xmitBuf); 
+  pbuf += rpcCtx->position;
+  
+  // Write projections
+  size =  storage_write(st, fidCtx, args->layout, args->bsize, (sid_t *) args->dist_set, args->spare,
+          (unsigned char *) args->fid, args->bid, args->nb_proj, version,
+          &file_size,(bin_t *) pbuf, &is_fid_faulty);
+  storio_disk_write_reply(thread_ctx_p, msg, size, is_fid_faulty, timeBefore);
 } 
 /*__________________________________________________________________________
 */
@@ -1214,124 +1343,933 @@ static inline void storio_disk_remove_chunk(rozofs_disk_thread_ctx_t *thread_ctx
   thread_ctx_p->stat.remove_chunk_time +=(timeAfter-timeBefore);  
 }    
 
+/*__________________________________________________________________________
+*/
+/**
+*  End of a single chunk read: pad the bins and send back the response
+
+  @param thread_ctx_p : pointer to the thread context
+  @param msg          : address of the message received
+  @param io           : the chunk read context
+  @param result       : result of the chunk read
+  @param len_read     : length of the bins read
+  @param is_fid_faulty: whether a fault is localized in the file
+  @param timeBefore   : time stamp of the start of the request processing
+*/
+static inline void storio_disk_chunk_read_end(rozofs_disk_thread_ctx_t *thread_ctx_p,storio_disk_thread_msg_t * msg,
+                                              storage_chunk_io_t * io, int result, size_t len_read, 
+                                              int is_fid_faulty, unsigned long long timeBefore) {
+  rozorpc_srv_ctx_t * rpcCtx = msg->rpcCtx;
+  char              * pbuf;
+
+  if (result == -1) {
+    storio_disk_read_reply(thread_ctx_p, msg, -1, 0, 0, is_fid_faulty, timeBefore);
+    return;
+  }
+  pbuf  = ruc_buf_getPayload(rpcCtx->xmitBuf);
+  pbuf += rpcCtx->position;
+  storage_read_chunk_pad(io->fidCtx, io->chunk, pbuf, &len_read, result);
+  storio_disk_read_reply(thread_ctx_p, msg, 0, len_read, 0, is_fid_faulty, timeBefore);
+}
 /*
-**   D I S K   T H R E A D
+**   M E R G E D   R E Q U E S T S
 */
 
-void *storio_disk_thread(void *arg) {
-  storio_disk_thread_msg_t   msg;
-  rozofs_disk_thread_ctx_t * ctx_p = (rozofs_disk_thread_ctx_t*)arg;
-  int                        bytesRcvd;
-  uint64_t                   newval;
-
-  uma_dbg_thread_add_self("Disk thread");
-
-#if 1
-    {
-      struct sched_param my_priority;
-      int policy=-1;
-      int ret= 0;
-
-     pthread_getschedparam(pthread_self(),&policy,&my_priority);
-          DEBUG("storio main thread Scheduling policy   = %s\n",
-                    (policy == SCHED_OTHER) ? "SCHED_OTHER" :
-                    (policy == SCHED_FIFO)  ? "SCHED_FIFO" :
-                    (policy == SCHED_RR)    ? "SCHED_RR" :
-                    "???");
- #if 1
-      my_priority.sched_priority= 98;
-      policy = SCHED_FIFO;
-      ret = pthread_setschedparam(pthread_self(),policy,&my_priority);
-      if (ret < 0) 
-      {
-	severe("error on sched_setscheduler: %s",strerror(errno));	
-      }
-      pthread_getschedparam(pthread_self(),&policy,&my_priority);
-          DEBUG("RozoFS thread Scheduling policy (prio %d)  = %s\n",my_priority.sched_priority,
-                    (policy == SCHED_OTHER) ? "SCHED_OTHER" :
-                    (policy == SCHED_FIFO)  ? "SCHED_FIFO" :
-                    (policy == SCHED_RR)    ? "SCHED_RR" :
-                    "???");
- #endif        
+/*
+** Context of a message carrying requests merged by the storio scheduler.
+** One per disk thread, allocated on first use.
+*/
+typedef struct _storio_disk_merge_t {
+  storio_disk_thread_msg_t  msg[STORIO_DISK_MERGE_MAX];  /**< one message per merged request */
+  storage_chunk_io_t        io[STORIO_DISK_MERGE_MAX];
+  int                       submit[STORIO_DISK_MERGE_MAX];/**< whether the disk access is to be done */
+  size_t                    len_read[STORIO_DISK_MERGE_MAX];
+  int                       is_fid_faulty[STORIO_DISK_MERGE_MAX];
+  unsigned long long        timeBefore;  /**< time stamp of the start of the message processing */
+  struct iovec              vector[IOV_MAX];
+} storio_disk_merge_t;
+
+static __thread storio_disk_merge_t * storio_disk_merge = NULL;
 
-    }  
-#endif     
+/*__________________________________________________________________________
+*/
+/**
+*  Check and prepare one of the merged requests
 
-  //info("Disk Thread %d Started !!\n",ctx_p->thread_idx);
-  
-  while(1) {
+  @param thread_ctx_p: pointer to the thread context
+  @param m           : merged requests context
+  @param idx         : index of the request in the merged requests
   
-    /*
-    ** read the north disk socket
-    */
-    bytesRcvd = recvfrom(af_unix_disk_socket_ref,
-			 &msg,sizeof(msg), 
-			 0,(struct sockaddr *)NULL,NULL);
-    if (bytesRcvd == -1) {
-      fatal("Disk Thread %d recvfrom %s !!\n",ctx_p->thread_idx,strerror(errno));
-      exit(0);
-    }
-    if (bytesRcvd != sizeof(msg)) {
-      fatal("Disk Thread %d socket is dead (%d/%d) %s !!\n",ctx_p->thread_idx,bytesRcvd,(int)sizeof(msg),strerror(errno));
-      exit(0);    
-    }
-      
-    newval = __atomic_fetch_add(&af_unix_disk_parallel_req,1,__ATOMIC_SEQ_CST);
-    newval++;
-    af_unix_disk_parallel_req_tbl[newval]++;
-        
-    msg.size = 0;
-    
-    switch (msg.opcode) {
+  @retval: 1 when the disk access is to be done, 0 when the response has been sent
+*/
+static inline int storio_disk_merged_prepare(rozofs_disk_thread_ctx_t *thread_ctx_p, storio_disk_merge_t * m, int idx) {
+  storio_disk_thread_msg_t * msg = &m->msg[idx];
+  storage_chunk_io_t       * io  = &m->io[idx];
+  rozorpc_srv_ctx_t        * rpcCtx = msg->rpcCtx;
+  storage_t                * st;
+  storio_device_mapping_t  * fidCtx;
+  char                     * pbuf;
+  int                        block_per_chunk;
+  int                        ret;
+
+  pbuf  = ruc_buf_getPayload(rpcCtx->xmitBuf);
+  pbuf += rpcCtx->position;
+  m->len_read[idx]      = 0;
+  m->is_fid_faulty[idx] = 0;
+
+  /*
+  ** The scheduler only merges requests within a single chunk
+  */
+  if (msg->opcode == STORIO_DISK_THREAD_READ) {
+    sp_read_arg_t * args = (sp_read_arg_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
+
+    if (storio_disk_read_check(thread_ctx_p,msg,&st,&fidCtx) != 0) return 0;
+
+    block_per_chunk = ROZOFS_STORAGE_NB_BLOCK_PER_CHUNK(args->bsize);
+    ret = storage_read_chunk_prepare(io, st, fidCtx, args->layout, args->bsize,(sid_t *) args->dist_set, 
+                                     args->spare, (unsigned char *) args->fid, 
+                                     args->bid / block_per_chunk, args->bid % block_per_chunk, args->nb_proj,
+                                     (bin_t *) pbuf, &m->len_read[idx], &m->is_fid_faulty[idx]);
+    if (ret == STORAGE_CHUNK_IO_ERROR) {
+      storio_disk_chunk_read_end(thread_ctx_p, msg, io, -1, 0, m->is_fid_faulty[idx], m->timeBefore);
+      return 0;
+    }
+    if (ret == STORAGE_CHUNK_IO_DONE) {
+      storio_disk_chunk_read_end(thread_ctx_p, msg, io, io->status, m->len_read[idx], m->is_fid_faulty[idx], m->timeBefore);
+      return 0;
+    }
+  }
+  else {
+    sp_write_arg_no_bins_t * args = (sp_write_arg_no_bins_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
+
+    if (storio_disk_write_check(thread_ctx_p,msg,&st,&fidCtx) != 0) return 0;
+
+    block_per_chunk = ROZOFS_STORAGE_NB_BLOCK_PER_CHUNK(args->bsize);
+    ret = storage_write_chunk_prepare(io, st, fidCtx, args->layout, args->bsize,(sid_t *) args->dist_set, 
+                                      args->spare, (unsigned char *) args->fid, 
+                                      args->bid / block_per_chunk, args->bid % block_per_chunk, args->nb_proj,
+                                      (bin_t *) pbuf, &m->is_fid_faulty[idx]);
+    if (ret != STORAGE_CHUNK_IO_SUBMIT) {
+      storio_disk_write_reply(thread_ctx_p, msg, -1, m->is_fid_faulty[idx], m->timeBefore);
+      return 0;
+    }
+  }
+  return 1;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Complete one of the merged requests once its disk access is done and
+*  send back its response
+
+  @param thread_ctx_p: pointer to the thread context
+  @param m           : merged requests context
+  @param idx         : index of the request in the merged requests
+  @param nb          : number of bytes transfered for this request or -1 (errno is set)
+*/
+static inline void storio_disk_merged_complete(rozofs_disk_thread_ctx_t *thread_ctx_p, storio_disk_merge_t * m, 
+                                               int idx, ssize_t nb) {
+  storio_disk_thread_msg_t * msg = &m->msg[idx];
+  storage_chunk_io_t       * io  = &m->io[idx];
+  uint64_t                   file_size = 0;
+  int                        ret;
+
+  if (msg->opcode == STORIO_DISK_THREAD_READ) {
+    ret = storage_read_chunk_complete(io, nb, &m->len_read[idx], &file_size, &m->is_fid_faulty[idx]);
+    storio_disk_chunk_read_end(thread_ctx_p, msg, io, ret, m->len_read[idx], m->is_fid_faulty[idx], m->timeBefore);
+  }
+  else {
+    ret = storage_write_chunk_complete(io, nb, &file_size, &m->is_fid_faulty[idx]);
+    storio_disk_write_reply(thread_ctx_p, msg, ret, m->is_fid_faulty[idx], m->timeBefore);
+  }
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Add the disk access of a prepared request to the vector of a merged access
+
+  @param m           : merged requests context
+  @param idx         : index of the request in the merged requests
+  @param nb_vect     : number of entries already in the vector
+  
+  @retval: the new number of entries in the vector, or -1 when it does not fit
+*/
+static inline int storio_disk_merged_vector(storio_disk_merge_t * m, int idx, int nb_vect) {
+  storage_chunk_io_t * io = &m->io[idx];
+
+  if (io->nb_vect == 0) {
+    if (nb_vect >= IOV_MAX) return -1;
+    m->vector[nb_vect].iov_base = io->bins;
+    m->vector[nb_vect].iov_len  = io->length;
+    return nb_vect+1;
+  }
+  if ((nb_vect + io->nb_vect) > IOV_MAX) return -1;
+  memcpy(&m->vector[nb_vect], io->vector, io->nb_vect * sizeof(struct iovec));
+  return nb_vect + io->nb_vect;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Process a message carrying contiguous reads or writes of a chunk merged 
+*  by the storio scheduler. Each request is checked, prepared, completed 
+*  and answered on its own, but the disk accesses that follow each other
+*  in the same file are done in a single preadv/pwritev.
+
+  @param thread_ctx_p: pointer to the thread context
+  @param msg         : address of the message received
+*/
+static void storio_disk_merged(rozofs_disk_thread_ctx_t *thread_ctx_p,storio_disk_thread_msg_t * msg) {
+  storio_disk_merge_t * m = storio_disk_merge;
+  struct timeval        timeDay;
+  unsigned long long    timeBefore;
+  int                   write = (msg->opcode == STORIO_DISK_THREAD_WRITE);
+  int                   nb = msg->nb_merged;
+  int                   first, last, idx;
+  int                   nb_vect, next_vect;
+  ssize_t               ret, share;
+  int                   saved_errno;
+
+  if (m == NULL) {
+    m = xmalloc(sizeof(storio_disk_merge_t));
+    storio_disk_merge = m;
+  }
+
+  gettimeofday(&timeDay,(struct timezone *)0);  
+  timeBefore = MICROLONG(timeDay);
+  thread_ctx_p->stat.merged_count++;
+
+  /*
+  ** Build one message per request, each one getting its own response,
+  ** and prepare the disk accesses
+  */
+  m->timeBefore = timeBefore;
+  for (idx=0; idx<nb; idx++) {
+    m->msg[idx]           = *msg;
+    m->msg[idx].rpcCtx    = msg->merged[idx];
+    m->msg[idx].timeStart = msg->merged_tic[idx];
+    m->msg[idx].nb_merged = 0;
+    m->msg[idx].size      = 0;
+    m->submit[idx] = storio_disk_merged_prepare(thread_ctx_p, m, idx);
+  }
+
+  first = 0;
+  while (first < nb) {
+
+    if (m->submit[first] == 0) {
+      first++;
+      continue;
+    }
+
+    /*
+    ** O_DIRECT accesses go through the bounce buffer of the thread
+    */
+    if (m->io[first].direct) {
+      errno = 0;
+      ret = write ? storage_chunk_io_write(&m->io[first]) : storage_chunk_io_read(&m->io[first]);
+      storio_disk_merged_complete(thread_ctx_p, m, first, ret);
+      first++;
+      continue;
+    }
+
+    /*
+    ** Gather the following accesses to the same file at contiguous offsets
+    */
+    nb_vect = storio_disk_merged_vector(m, first, 0);
+    last    = first;
+    while ((last+1) < nb) {
+      storage_chunk_io_t * prev = &m->io[last];
+      storage_chunk_io_t * next = &m->io[last+1];
+
+      if (m->submit[last+1] == 0) break;
+      if (next->direct) break;
+      if ((prev->offset + prev->length) != next->offset) break;
+      if (strcmp(prev->path, next->path) != 0) break;
+      next_vect = storio_disk_merged_vector(m, last+1, nb_vect);
+      if (next_vect < 0) break;
+      nb_vect = next_vect;
+      last++;
+    }
+
+    errno = 0;
+    if (write) ret = pwritev(m->io[first].fd, m->vector, nb_vect, m->io[first].offset);
+    else       ret = preadv(m->io[first].fd, m->vector, nb_vect, m->io[first].offset);
+    saved_errno = errno;
+
+    /*
+    ** Share the transfered bytes between the requests in offset order
+    */
+    for (idx=first; idx<=last; idx++) {
+      if (ret < 0) {
+        share = -1;
+      }
+      else {
+        share = (ret > m->io[idx].length) ? m->io[idx].length : ret;
+	ret  -= share;
+      }
+      errno = saved_errno;
+      storio_disk_merged_complete(thread_ctx_p, m, idx, share);
+    }
+    first = last+1;
+  }
+}
+
+/*
+**   D I S K   T H R E A D
+*/
+/*__________________________________________________________________________
+*/
+/**
+*  Set the real time priority of the current disk thread
+*/
+static void storio_disk_thread_set_priority(void) {
+      struct sched_param my_priority;
+      int policy=-1;
+      int ret= 0;
+
+     pthread_getschedparam(pthread_self(),&policy,&my_priority);
+          DEBUG("storio main thread Scheduling policy   = %s\n",
+                    (policy == SCHED_OTHER) ? "SCHED_OTHER" :
+                    (policy == SCHED_FIFO)  ? "SCHED_FIFO" :
+                    (policy == SCHED_RR)    ? "SCHED_RR" :
+                    "???");
+ #if 1
+      my_priority.sched_priority= 98;
+      policy = SCHED_FIFO;
+      ret = pthread_setschedparam(pthread_self(),policy,&my_priority);
+      if (ret < 0) 
+      {
+	severe("error on sched_setscheduler: %s",strerror(errno));	
+      }
+      pthread_getschedparam(pthread_self(),&policy,&my_priority);
+          DEBUG("RozoFS thread Scheduling policy (prio %d)  = %s\n",my_priority.sched_priority,
+                    (policy == SCHED_OTHER) ? "SCHED_OTHER" :
+                    (policy == SCHED_FIFO)  ? "SCHED_FIFO" :
+                    (policy == SCHED_RR)    ? "SCHED_RR" :
+                    "???");
+ #endif        
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Account for a new request under processing
+*/
+static inline void storio_disk_parallel_req_start(void) {
+  uint64_t newval;
+
+  newval = __atomic_fetch_add(&af_unix_disk_parallel_req,1,__ATOMIC_SEQ_CST);
+  newval++;
+  if (newval >= ROZOFS_MAX_DISK_THREADS) newval = ROZOFS_MAX_DISK_THREADS-1;
+  af_unix_disk_parallel_req_tbl[newval]++;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Account for the end of a request processing
+*/
+static inline void storio_disk_parallel_req_end(void) {
+  __atomic_fetch_sub(&af_unix_disk_parallel_req,1,__ATOMIC_SEQ_CST);
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Process synchronously a request received from the main thread
+
+  @param ctx_p : pointer to the thread context
+  @param msg   : address of the message received
+  
+  @retval: none
+*/
+static inline void storio_disk_process_request(rozofs_disk_thread_ctx_t * ctx_p, storio_disk_thread_msg_t * msg) {
+
+    /*
+    ** Contiguous reads or writes merged by the scheduler
+    */
+    if (msg->nb_merged > 1) {
+      storio_disk_merged(ctx_p,msg);
+      return;
+    }
+
+    switch (msg->opcode) {
     
       case STORIO_DISK_THREAD_READ:
-        storio_disk_read(ctx_p,&msg);
+        storio_disk_read(ctx_p,msg);
         break;
 	
       case STORIO_DISK_THREAD_RESIZE:
-        storio_disk_resize(ctx_p,&msg);
+        storio_disk_resize(ctx_p,msg);
         break;	
 	
       case STORIO_DISK_THREAD_WRITE:
-        storio_disk_write(ctx_p,&msg);
+        storio_disk_write(ctx_p,msg);
         break;
 	
       case STORIO_DISK_THREAD_TRUNCATE:
-        storio_disk_truncate(ctx_p,&msg);
+        storio_disk_truncate(ctx_p,msg);
         break;
 
       case STORIO_DISK_THREAD_WRITE_REPAIR:
-        storio_disk_write_repair(ctx_p,&msg);
+        storio_disk_write_repair(ctx_p,msg);
         break;
 	
       case STORIO_DISK_THREAD_WRITE_REPAIR2:
-        storio_disk_write_repair2(ctx_p,&msg);
+        storio_disk_write_repair2(ctx_p,msg);
         break;
 	
       case STORIO_DISK_THREAD_REMOVE:
-        storio_disk_remove(ctx_p,&msg);
+        storio_disk_remove(ctx_p,msg);
         break;
 	       	
       case STORIO_DISK_THREAD_REMOVE_CHUNK:
-        storio_disk_remove_chunk(ctx_p,&msg);
+        storio_disk_remove_chunk(ctx_p,msg);
         break;
 	
       case STORIO_DISK_REBUILD_START:
-        storio_disk_rebuild_start(ctx_p,&msg);
+        storio_disk_rebuild_start(ctx_p,msg);
         break;
 	
       case STORIO_DISK_REBUILD_STOP:
-        storio_disk_rebuild_stop(ctx_p,&msg);
+        storio_disk_rebuild_stop(ctx_p,msg);
         break;
 
       default:
-        fatal(" unexpected opcode : %d\n",msg.opcode);
+        fatal(" unexpected opcode : %d\n",msg->opcode);
         exit(0);       
     }
-    newval = __atomic_fetch_sub(&af_unix_disk_parallel_req,1,__ATOMIC_SEQ_CST)-1;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Disk thread of the thread per request model: one blocking request
+*  is processed at a time
+*/
+void *storio_disk_thread(void *arg) {
+  storio_disk_thread_msg_t   msg;
+  rozofs_disk_thread_ctx_t * ctx_p = (rozofs_disk_thread_ctx_t*)arg;
+  int                        bytesRcvd;
+
+  uma_dbg_thread_add_self("Disk thread");
+
+  storio_disk_thread_set_priority();
+
+  //info("Disk Thread %d Started !!\n",ctx_p->thread_idx);
+  
+  while(1) {
+  
+    if (storio_disk_channel != NULL) {
+      /*
+      ** read the request ring of the thread
+      */
+      rozofs_thread_channel_receive(storio_disk_channel, ctx_p->thread_idx, &msg);
+    }
+    else {
+      /*
+      ** read the north disk socket
+      */
+      bytesRcvd = recvfrom(af_unix_disk_socket_ref,
+			   &msg,sizeof(msg), 
+			   0,(struct sockaddr *)NULL,NULL);
+      if (bytesRcvd == -1) {
+	fatal("Disk Thread %d recvfrom %s !!\n",ctx_p->thread_idx,strerror(errno));
+	exit(0);
+      }
+      if (bytesRcvd != sizeof(msg)) {
+	fatal("Disk Thread %d socket is dead (%d/%d) %s !!\n",ctx_p->thread_idx,bytesRcvd,(int)sizeof(msg),strerror(errno));
+	exit(0);    
+      }
+    }
+      
+    storio_disk_parallel_req_start();
+        
+    msg.size = 0;
+    storio_disk_process_request(ctx_p,&msg);
+
+    storio_disk_parallel_req_end();
 //    sched_yield();
   }
 }
+#ifdef HAVE_LINUX_IO_URING_H
+/*
+**   I O _ U R I N G   D I S K   T H R E A D
+*/
+
+/*
+** User data of the poll of the north disk socket
+*/
+#define STORIO_DISK_URING_POLL_TAG  ((uint64_t)-1)
+
+/*
+** Context of a read or write request in flight in the ring
+*/
+typedef struct _storio_disk_uring_req_t {
+  storio_disk_thread_msg_t   msg;
+  storage_chunk_io_t         io;
+  unsigned long long         timeBefore;
+  size_t                     len_read;
+  int                        is_fid_faulty;
+  int                        next;   /**< next free request context */
+} storio_disk_uring_req_t;
+
+/*
+** io_uring context of a disk thread
+*/
+typedef struct _storio_disk_uring_t {
+  storio_uring_t             ring;
+  int                        depth;       /**< number of request contexts */
+  storio_disk_uring_req_t  * req;         /**< request contexts */
+  int                        free_idx;    /**< 1rst free request context or -1 */
+  int                        inflight;    /**< number of requests in the ring */
+  int                        poll_armed;  /**< whether a poll of the north socket is in the ring */
+  int                        fixed_done;  /**< whether buffer registration has been tried */
+} storio_disk_uring_t;
+
+/*__________________________________________________________________________
+*/
+/**
+*  Create the io_uring context of a disk thread
+
+  @param depth : number of requests in flight
+  
+  @retval the context or NULL when io_uring is not available (errno is set)
+*/
+static storio_disk_uring_t * storio_disk_uring_create(int depth) {
+  storio_disk_uring_t * u;
+  uint32_t              entries;
+  int                   i;
+
+  u = xmalloc(sizeof(storio_disk_uring_t));
+  memset(u,0,sizeof(storio_disk_uring_t));
+  
+  /*
+  ** Room for every request plus the north socket poll
+  */
+  entries = 1;
+  while (entries < (depth+1)) entries <<= 1;
+  
+  if (storio_uring_init(&u->ring, entries) != 0) {
+    xfree(u);
+    return NULL;
+  }
+  
+  u->depth = depth;
+  u->req   = xmalloc(depth*sizeof(storio_disk_uring_req_t));
+  for (i=0; i<depth; i++) {
+    u->req[i].next = i+1;
+  }
+  u->req[depth-1].next = -1;
+  u->free_idx = 0;
+  return u;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Register the read/write buffer pool in the ring for fixed reads and writes.
+*  The pool is created after the disk threads, so this is done on the first
+*  request, when no request is in flight.
+
+  @param ctx_p : pointer to the thread context
+*/
+static inline void storio_disk_uring_register_pool(rozofs_disk_thread_ctx_t * ctx_p) {
+  storio_disk_uring_t * u = ctx_p->uring;
+  void                * base;
+  
+  if (u->fixed_done) return;
+  if (storage_xmit_buffer_pool_p == NULL) return;
+  u->fixed_done = 1;
+  
+  base = ruc_buf_get_pool_base_data(storage_xmit_buffer_pool_p);
+  if (base == NULL) return;
+  
+  if (storio_uring_register_buffer(&u->ring, base, 
+                                   ruc_buf_get_pool_data_len(storage_xmit_buffer_pool_p)) != 0) {
+    warning("Disk thread %d can not register buffers in io_uring %s",ctx_p->thread_idx,strerror(errno));
+  }  
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Queue the disk access of a chunk read or write in the ring
+
+  @param ctx_p : pointer to the thread context
+  @param req   : the request context
+  @param write : 1 for a write, 0 for a read
+  @param pbuf  : the bins in the xmit buffer
+*/
+static inline void storio_disk_uring_queue(rozofs_disk_thread_ctx_t * ctx_p, 
+                                           storio_disk_uring_req_t * req, 
+                                           int write, char * pbuf) {
+  storio_disk_uring_t * u = ctx_p->uring;
+  struct io_uring_sqe * sqe;
+  int                   nb_vect = req->io.nb_vect;
+
+  /*
+  ** Contiguous bins
+  */
+  if (nb_vect == 0) {
+    req->io.vector[0].iov_base = pbuf;
+    req->io.vector[0].iov_len  = req->io.length;
+    nb_vect = 1;
+  }
+  
+  /*
+  ** There is always room for the request since the ring is sized
+  ** for every request context plus the poll
+  */
+  sqe = storio_uring_get_sqe(&u->ring);
+  storio_uring_prep_rw(&u->ring, sqe, write, req->io.fd, req->io.vector, nb_vect,
+                       req->io.offset, (uint64_t)(req - u->req));
+  
+  u->free_idx = req->next;
+  u->inflight++;
+  if (u->inflight > ctx_p->stat.uring_inflight_max) ctx_p->stat.uring_inflight_max = u->inflight;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Tell whether a read or a write is within a single chunk and so can 
+*  be run through the ring
+
+  @param bsize   : block size
+  @param bid     : first block
+  @param nb_proj : number of blocks
+  @param chunk   : returned chunk number
+  @param cbid    : returned first block in the chunk
+  
+  @retval 1 when within a single chunk, 0 else
+*/
+static inline int storio_disk_uring_single_chunk(uint32_t bsize, bid_t bid, uint32_t nb_proj,
+                                                 int * chunk, bid_t * cbid) {
+  int block_per_chunk = ROZOFS_STORAGE_NB_BLOCK_PER_CHUNK(bsize);
+
+  *chunk = bid/block_per_chunk;
+  if (*chunk >= ROZOFS_STORAGE_MAX_CHUNK_PER_FILE) return 0;
+  *cbid = bid - (*chunk * block_per_chunk);
+  if ((*cbid+nb_proj) > block_per_chunk) return 0;
+  return 1;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  End of a read request run through the ring
+
+  @param ctx_p  : pointer to the thread context
+  @param req    : the request context
+  @param result : result of the chunk read
+*/
+static inline void storio_disk_uring_read_end(rozofs_disk_thread_ctx_t * ctx_p, 
+                                              storio_disk_uring_req_t * req, int result) {
+  storio_disk_chunk_read_end(ctx_p, &req->msg, &req->io, result, req->len_read, 
+                             req->is_fid_faulty, req->timeBefore);
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Start a read request through the ring
+
+  @param ctx_p : pointer to the thread context
+  @param req   : the request context
+  
+  @retval 0 when the read is in the ring, -1 when it has been processed
+*/
+static inline int storio_disk_uring_read(rozofs_disk_thread_ctx_t * ctx_p, storio_disk_uring_req_t * req) {
+  struct timeval            timeDay;
+  storage_t               * st;
+  storio_device_mapping_t * fidCtx;
+  sp_read_arg_t           * args;
+  rozorpc_srv_ctx_t       * rpcCtx = req->msg.rpcCtx;
+  int                       chunk;
+  bid_t                     bid;
+  char                    * pbuf;
+  int                       ret;
+
+  args = (sp_read_arg_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
+  
+  /*
+  ** Reads on 2 chunks are run synchronously
+  */
+  if (!storio_disk_uring_single_chunk(args->bsize, args->bid, args->nb_proj, &chunk, &bid)) {
+    ctx_p->stat.uring_sync_count++;
+    storio_disk_read(ctx_p,&req->msg);
+    return -1;
+  }
+
+  gettimeofday(&timeDay,(struct timezone *)0);  
+  req->timeBefore = MICROLONG(timeDay);
+
+  if (storio_disk_read_check(ctx_p,&req->msg,&st,&fidCtx) != 0) return -1;
+  
+  pbuf  = ruc_buf_getPayload(rpcCtx->xmitBuf);
+  pbuf += rpcCtx->position;     
+  req->len_read      = 0;
+  req->is_fid_faulty = 0;
+  
+  ret = storage_read_chunk_prepare(&req->io, st, fidCtx, args->layout, args->bsize,(sid_t *) args->dist_set, 
+                                   args->spare, (unsigned char *) args->fid, chunk, bid, args->nb_proj,
+                                   (bin_t *) pbuf, &req->len_read, &req->is_fid_faulty);
+  if (ret == STORAGE_CHUNK_IO_ERROR) {
+    storio_disk_uring_read_end(ctx_p, req, -1);
+    return -1;
+  }
+  if (ret == STORAGE_CHUNK_IO_DONE) {
+    storio_disk_uring_read_end(ctx_p, req, req->io.status);
+    return -1;
+  }
+  
+  /*
+  ** O_DIRECT accesses go through the bounce buffer of the thread
+  */
+  if (req->io.direct) {
+    uint64_t file_size;
+    ctx_p->stat.uring_sync_count++;
+    ret = storage_read_chunk_complete(&req->io, storage_chunk_io_read(&req->io), 
+                                      &req->len_read, &file_size, &req->is_fid_faulty);
+    storio_disk_uring_read_end(ctx_p, req, ret);
+    return -1;
+  }
+  
+  ctx_p->stat.uring_read_count++;
+  storio_disk_uring_queue(ctx_p, req, 0, pbuf);
+  return 0;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Start a write request through the ring
+
+  @param ctx_p : pointer to the thread context
+  @param req   : the request context
+  
+  @retval 0 when the write is in the ring, -1 when it has been processed
+*/
+static inline int storio_disk_uring_write(rozofs_disk_thread_ctx_t * ctx_p, storio_disk_uring_req_t * req) {
+  struct timeval            timeDay;
+  storage_t               * st;
+  storio_device_mapping_t * fidCtx;
+  sp_write_arg_no_bins_t  * args;
+  rozorpc_srv_ctx_t       * rpcCtx = req->msg.rpcCtx;
+  int                       chunk;
+  bid_t                     bid;
+  char                    * pbuf;
+
+  args = (sp_write_arg_no_bins_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
+  
+  /*
+  ** Writes on 2 chunks are run synchronously
+  */
+  if (!storio_disk_uring_single_chunk(args->bsize, args->bid, args->nb_proj, &chunk, &bid)) {
+    ctx_p->stat.uring_sync_count++;
+    storio_disk_write(ctx_p,&req->msg);
+    return -1;
+  }
+
+  gettimeofday(&timeDay,(struct timezone *)0);  
+  req->timeBefore = MICROLONG(timeDay);
+
+  if (storio_disk_write_check(ctx_p,&req->msg,&st,&fidCtx) != 0) return -1;
+  
+  pbuf  = ruc_buf_getPayload(rpcCtx->xmitBuf);
+  pbuf += rpcCtx->position;     
+  req->is_fid_faulty = 0;
+  
+  if (storage_write_chunk_prepare(&req->io, st, fidCtx, args->layout, args->bsize,(sid_t *) args->dist_set, 
+                                  args->spare, (unsigned char *) args->fid, chunk, bid, args->nb_proj,
+                                  (bin_t *) pbuf, &req->is_fid_faulty) != STORAGE_CHUNK_IO_SUBMIT) {
+    storio_disk_write_reply(ctx_p, &req->msg, -1, req->is_fid_faulty, req->timeBefore);
+    return -1;
+  }
+  
+  /*
+  ** O_DIRECT accesses go through the bounce buffer of the thread
+  */
+  if (req->io.direct) {
+    uint64_t file_size;
+    int      size;
+    ctx_p->stat.uring_sync_count++;
+    errno = 0;
+    size = storage_write_chunk_complete(&req->io, storage_chunk_io_write(&req->io), 
+                                        &file_size, &req->is_fid_faulty);
+    storio_disk_write_reply(ctx_p, &req->msg, size, req->is_fid_faulty, req->timeBefore);
+    return -1;
+  }
+  
+  ctx_p->stat.uring_write_count++;
+  storio_disk_uring_queue(ctx_p, req, 1, pbuf);
+  return 0;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Completion of a read or write in the ring
+
+  @param ctx_p : pointer to the thread context
+  @param req   : the request context
+  @param res   : result of the disk access (<0 is -errno)
+*/
+static inline void storio_disk_uring_complete(rozofs_disk_thread_ctx_t * ctx_p, 
+                                              storio_disk_uring_req_t * req, int res) {
+  storio_disk_uring_t * u = ctx_p->uring;
+  ssize_t               nb;
+  uint64_t              file_size = 0;
+  int                   ret;
+  
+  if (res < 0) {
+    errno = -res;
+    nb    = -1;
+  }
+  else {
+    errno = 0;
+    nb    = res;
+  }
+  
+  if (req->msg.opcode == STORIO_DISK_THREAD_READ) {
+    ret = storage_read_chunk_complete(&req->io, nb, &req->len_read, &file_size, &req->is_fid_faulty);
+    storio_disk_uring_read_end(ctx_p, req, ret);
+  }
+  else {
+    ret = storage_write_chunk_complete(&req->io, nb, &file_size, &req->is_fid_faulty);
+    storio_disk_write_reply(ctx_p, &req->msg, ret, req->is_fid_faulty, req->timeBefore);
+  }
+  storio_disk_parallel_req_end();
+  
+  /*
+  ** Release the request context
+  */
+  req->next   = u->free_idx;
+  u->free_idx = req - u->req;
+  u->inflight--;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Read the requests pending on the north disk socket while some request 
+*  contexts are free
+
+  @param ctx_p : pointer to the thread context
+*/
+static inline void storio_disk_uring_receive(rozofs_disk_thread_ctx_t * ctx_p) {
+  storio_disk_uring_t     * u = ctx_p->uring;
+  storio_disk_uring_req_t * req;
+  int                       bytesRcvd;
+  int                       ret;
+  
+  storio_disk_uring_register_pool(ctx_p);
+  
+  while (u->free_idx != -1) {
+  
+    req = &u->req[u->free_idx];
+    
+    if (storio_disk_channel != NULL) {
+      if (rozofs_thread_channel_try_receive(storio_disk_channel, ctx_p->thread_idx, &req->msg) == 0) return;
+      bytesRcvd = sizeof(req->msg);
+    }
+    else {
+      bytesRcvd = recvfrom(af_unix_disk_socket_ref,
+			   &req->msg,sizeof(req->msg), 
+			   MSG_DONTWAIT,(struct sockaddr *)NULL,NULL);
+      if (bytesRcvd == -1) {
+	if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) return;
+	fatal("Disk Thread %d recvfrom %s !!\n",ctx_p->thread_idx,strerror(errno));
+	exit(0);
+      }
+    }
+    if (bytesRcvd != sizeof(req->msg)) {
+      fatal("Disk Thread %d socket is dead (%d/%d) %s !!\n",ctx_p->thread_idx,bytesRcvd,(int)sizeof(req->msg),strerror(errno));
+      exit(0);    
+    }
+      
+    storio_disk_parallel_req_start();
+    req->msg.size = 0;
+    
+    /*
+    ** Merged requests are run synchronously
+    */
+    if (req->msg.nb_merged > 1) {
+      ctx_p->stat.uring_sync_count++;
+      storio_disk_process_request(ctx_p,&req->msg);
+      storio_disk_parallel_req_end();
+      continue;
+    }
+    
+    switch (req->msg.opcode) {
+      case STORIO_DISK_THREAD_READ:
+        ret = storio_disk_uring_read(ctx_p,req);
+        break;
+      case STORIO_DISK_THREAD_WRITE:
+        ret = storio_disk_uring_write(ctx_p,req);
+        break;
+      default:
+        storio_disk_process_request(ctx_p,&req->msg);
+        ret = -1;
+        break;
+    }
+    /*
+    ** The request has already been processed
+    */
+    if (ret != 0) storio_disk_parallel_req_end();
+  }
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Disk thread of the io_uring model: the north disk socket is polled
+*  through the ring and many chunk reads and writes are kept in flight
+*/
+void *storio_disk_uring_thread(void *arg) {
+  rozofs_disk_thread_ctx_t * ctx_p = (rozofs_disk_thread_ctx_t*)arg;
+  storio_disk_uring_t      * u = ctx_p->uring;
+  struct io_uring_sqe      * sqe;
+  struct io_uring_cqe      * cqe;
+  uint64_t                   user_data;
+  int                        res;
+
+  uma_dbg_thread_add_self("Disk thread");
+
+  storio_disk_thread_set_priority();
+  
+  while(1) {
+
+    /*
+    ** Poll the north disk socket when a request context is free
+    */
+    if ((u->poll_armed == 0) && (u->free_idx != -1)) {
+      if (storio_disk_channel != NULL) {
+        /*
+	** The thread is only woken up when it has emptied its request ring
+	*/
+        storio_disk_uring_receive(ctx_p);
+      }
+      if (u->free_idx != -1) {
+	sqe = storio_uring_get_sqe(&u->ring);
+	storio_uring_prep_poll(sqe, 
+	                       (storio_disk_channel != NULL) ? storio_disk_channel->request_efd[ctx_p->thread_idx] : af_unix_disk_socket_ref, 
+			       POLLIN, STORIO_DISK_URING_POLL_TAG);
+	u->poll_armed = 1;
+      }
+    }
+    
+    if (storio_uring_submit_and_wait(&u->ring, 1) < 0) {
+      if ((errno == EINTR) || (errno == EAGAIN) || (errno == EBUSY)) continue;
+      fatal("Disk Thread %d io_uring_enter %s !!\n",ctx_p->thread_idx,strerror(errno));
+      exit(0);
+    }
+    
+    while ((cqe = storio_uring_peek_cqe(&u->ring)) != NULL) {
+      user_data = cqe->user_data;
+      res       = cqe->res;
+      storio_uring_cqe_seen(&u->ring);
+      
+      if (user_data == STORIO_DISK_URING_POLL_TAG) {
+        u->poll_armed = 0;
+	if (storio_disk_channel != NULL) {
+	  rozofs_ring_clear(storio_disk_channel->request_efd[ctx_p->thread_idx]);
+	}
+        storio_disk_uring_receive(ctx_p);
+	continue;
+      }
+      storio_disk_uring_complete(ctx_p, &u->req[user_data], res);
+    }
+  }
+}
+#endif
 /*
 ** Create the threads that will handle all the disk requests
 
@@ -1346,6 +2284,9 @@ int storio_disk_thread_create(char * hostname, int nb_threads, int instance_id)
    pthread_attr_t             attr;
    rozofs_disk_thread_ctx_t * thread_ctx_p;
    char                       socketName[128];
+#ifdef HAVE_LINUX_IO_URING_H
+   int                        use_uring;
+#endif
 
    /*
    ** clear the thread table
@@ -1353,18 +2294,49 @@ int storio_disk_thread_create(char * hostname, int nb_threads, int instance_id)
    memset(rozofs_disk_thread_ctx_tb,0,sizeof(rozofs_disk_thread_ctx_tb));
    /*
    ** create the common socket to receive requests on
+   ** unless the requests are given through rings
    */
    char * pChar = socketName;
-   pChar += rozofs_string_append(pChar,ROZOFS_SOCK_FAMILY_DISK_NORTH);
-   *pChar++ = '_';
-   pChar += rozofs_u32_append(pChar,instance_id);
-   *pChar++ = '_';  
-   pChar += rozofs_string_append(pChar,hostname);
-   af_unix_disk_socket_ref = af_unix_disk_sock_create_internal(socketName,1024*32);
-   if (af_unix_disk_socket_ref < 0) {
-      fatal("af_unix_disk_thread_create af_unix_disk_sock_create_internal(%s) %s",socketName,strerror(errno));
-      return -1;   
+   if (storio_disk_channel == NULL) {
+     pChar += rozofs_string_append(pChar,ROZOFS_SOCK_FAMILY_DISK_NORTH);
+     *pChar++ = '_';
+     pChar += rozofs_u32_append(pChar,instance_id);
+     *pChar++ = '_';  
+     pChar += rozofs_string_append(pChar,hostname);
+     af_unix_disk_socket_ref = af_unix_disk_sock_create_internal(socketName,1024*32);
+     if (af_unix_disk_socket_ref < 0) {
+	fatal("af_unix_disk_thread_create af_unix_disk_sock_create_internal(%s) %s",socketName,strerror(errno));
+	return -1;   
+     }
+   }
+   
+#ifdef HAVE_LINUX_IO_URING_H
+   /*
+   ** Create the rings when the io_uring engine is configured.
+   ** Fall back to the thread per request model when not available.
+   */
+   use_uring = common_config.storio_io_uring;
+   thread_ctx_p = rozofs_disk_thread_ctx_tb;
+   for (i = 0; (i < nb_threads) && (use_uring) ; i++,thread_ctx_p++) {
+     thread_ctx_p->uring = storio_disk_uring_create(common_config.storio_io_uring_depth);
+     if (thread_ctx_p->uring != NULL) continue;
+     
+     warning("io_uring not available (%s). Using thread per request disk model.",strerror(errno));
+     use_uring = 0;
+     while (thread_ctx_p > rozofs_disk_thread_ctx_tb) {
+       thread_ctx_p--;
+       storio_uring_release(&thread_ctx_p->uring->ring);
+       xfree(thread_ctx_p->uring->req);
+       xfree(thread_ctx_p->uring);
+       thread_ctx_p->uring = NULL;
+     }
+   }
+#else
+   if (common_config.storio_io_uring) {
+     warning("io_uring not supported by this build. Using thread per request disk model.");
    }
+#endif
+   
    /*
    ** Now create the threads
    */
@@ -1372,22 +2344,25 @@ int storio_disk_thread_create(char * hostname, int nb_threads, int instance_id)
    for (i = 0; i < nb_threads ; i++) {
    
      thread_ctx_p->hostname = hostname;
+     thread_ctx_p->sendSocket = -1;
      /*
      ** create the thread specific socket to send the response from 
      */
-     pChar = socketName;
-     pChar += rozofs_string_append(pChar,ROZOFS_SOCK_FAMILY_DISK_NORTH);
-     *pChar++ = '_';
-     pChar += rozofs_u32_append(pChar,instance_id);
-     *pChar++ = '_';  
-     pChar += rozofs_string_append(pChar,hostname);
-     *pChar++ = '_'; 
-     pChar += rozofs_u32_append(pChar,i);
-     thread_ctx_p->sendSocket = af_unix_disk_sock_create_internal(socketName,1024*32);
-     if (thread_ctx_p->sendSocket < 0) {
-	fatal("af_unix_disk_thread_create af_unix_disk_sock_create_internal(%s) %s",socketName, strerror(errno));
-	return -1;   
-     }   
+     if (storio_disk_channel == NULL) {
+       pChar = socketName;
+       pChar += rozofs_string_append(pChar,ROZOFS_SOCK_FAMILY_DISK_NORTH);
+       *pChar++ = '_';
+       pChar += rozofs_u32_append(pChar,instance_id);
+       *pChar++ = '_';  
+       pChar += rozofs_string_append(pChar,hostname);
+       *pChar++ = '_'; 
+       pChar += rozofs_u32_append(pChar,i);
+       thread_ctx_p->sendSocket = af_unix_disk_sock_create_internal(socketName,1024*32);
+       if (thread_ctx_p->sendSocket < 0) {
+	  fatal("af_unix_disk_thread_create af_unix_disk_sock_create_internal(%s) %s",socketName, strerror(errno));
+	  return -1;   
+       }   
+     }
    
      err = pthread_attr_init(&attr);
      if (err != 0) {
@@ -1396,7 +2371,15 @@ int storio_disk_thread_create(char * hostname, int nb_threads, int instance_id)
      }  
 
      thread_ctx_p->thread_idx = i;
-     err = pthread_create(&thread_ctx_p->thrdId,&attr,storio_disk_thread,thread_ctx_p);
+#ifdef HAVE_LINUX_IO_URING_H
+     if (thread_ctx_p->uring != NULL) {
+       err = pthread_create(&thread_ctx_p->thrdId,&attr,storio_disk_uring_thread,thread_ctx_p);
+     }
+     else
+#endif
+     {
+       err = pthread_create(&thread_ctx_p->thrdId,&attr,storio_disk_thread,thread_ctx_p);
+     }
      if (err != 0) {
        fatal("af_unix_disk_thread_create pthread_create(%d) %s",i, strerror(errno));
        return -1;
@@ -1406,4 +2389,3 @@ int storio_disk_thread_create(char * hostname, int nb_threads, int instance_id)
   }
   return 0;
 }
- 
@@ -25,6 +25,7 @@
 #include <rozofs/rozofs.h>
 #include <rozofs/common/log.h>
 #include <rozofs/common/profile.h>
+#include <rozofs/common/common_config.h>
 #include <rozofs/core/af_unix_socket_generic_api.h>
 #include <rozofs/core/rozofs_rpc_non_blocking_generic_srv.h>
 #include <rozofs/core/ruc_buffer_debug.h>
@@ -36,6 +37,8 @@
 #include "config.h"
 #include "storio_device_mapping.h"
 #include "storio_serialization.h"
+#include "storio_sched.h"
+#include "storio_dirty.h"
 
 DECLARE_PROFILING(spp_profiler_t); 
  
@@ -43,6 +46,7 @@ static int transactionId = 1;
 int        af_unix_disk_south_socket_ref = -1;
 int        af_unix_disk_thread_count=0;
 int        af_unix_disk_pending_req_count = 0;
+rozofs_thread_channel_t * storio_disk_channel = NULL;
 
 #define MAX_PENDING_REQUEST     64
 uint64_t   af_unix_disk_pending_req_tbl[MAX_PENDING_REQUEST];
@@ -295,6 +299,16 @@ void disk_thread_debug(char * argv[], uint32_t tcpRef, void *bufRef) {
     doreset = 1;
   }
   
+  pChar += rozofs_string_append(pChar,"disk thread engine       = ");
+  if ((af_unix_disk_thread_count>0) && (p[0].uring != NULL)) {
+    pChar += rozofs_string_append(pChar,"io_uring\n");
+  }
+  else {
+    pChar += rozofs_string_append(pChar,"thread per request\n");
+  }
+  if (storio_disk_channel != NULL) {
+    pChar = rozofs_thread_channel_display(storio_disk_channel, pChar);
+  }
   pChar += rozofs_string_append(pChar,"current pending requests = ");
   pChar += rozofs_u32_append(pChar,af_unix_disk_pending_req_count);
   pChar += rozofs_string_append(pChar,"\npending requests table   ");  
@@ -415,6 +429,15 @@ void disk_thread_debug(char * argv[], uint32_t tcpRef, void *bufRef) {
     display_line_val("!! error",rebStop_error);  
     display_line_val("   Cumulative Time (us)",rebStop_time);
     display_line_div("   Average Time (us)",rebStop_time,rebStop_count);  
+
+    display_line_topic("io_uring");  
+    display_line_val("   Read",uring_read_count);
+    display_line_val("   Write",uring_write_count);
+    display_line_val("   Synchronous",uring_sync_count);
+    display_line_val("   Max in flight",uring_inflight_max);
+
+    display_line_topic("Scheduler");  
+    display_line_val("   Merged messages",merged_count);
  
     display_line_topic("");  
     *pChar++= '\n';
@@ -548,6 +571,11 @@ void af_unix_disk_response(storio_disk_thread_msg_t *msg)
   opcode = msg->opcode;
   tic    = msg->timeStart; 
 
+  /*
+  ** Let the scheduler send the next requests of the device
+  */
+  storio_sched_response(msg);
+
   switch (opcode) {
   
     case STORIO_DISK_THREAD_READ:
@@ -798,6 +826,11 @@ void storio_send_response (rozofs_disk_thread_ctx_t *thread_ctx_p, storio_disk_t
   
   msg->status = status;
   
+  if (storio_disk_channel != NULL) {
+    rozofs_thread_channel_reply(storio_disk_channel, thread_ctx_p->thread_idx, msg);
+    return;
+  }
+  
   /*
   ** send back the response
   */  
@@ -808,6 +841,56 @@ void storio_send_response (rozofs_disk_thread_ctx_t *thread_ctx_p, storio_disk_t
   }
 }
 
+/*__________________________________________________________________________
+*/
+/**
+*  Post a filled message to the disk threads
+*
+* @param msg        the message to send
+* @param nb_req     number of requests carried by the message
+*
+* @retval 0 on success -1 in case of error
+*  
+*/
+int storio_disk_thread_intf_post(storio_disk_thread_msg_t * msg, int nb_req) 
+{
+  int                         ret;
+ 
+  msg->msg_len          = sizeof(storio_disk_thread_msg_t)-sizeof(msg->msg_len);
+  msg->status           = 0;
+  msg->transaction_id   = transactionId++;
+  msg->size             = 0;
+  
+  /* Send the buffer to its destination */
+  if (storio_disk_channel != NULL) {
+    if (rozofs_thread_channel_send(storio_disk_channel, msg, nb_req) < 0) {
+      /*
+      ** No room in the disk thread rings: the caller either keeps the
+      ** request queued or fails it
+      */
+      return -1;
+    }
+  }
+  else {
+    ret = sendto(af_unix_disk_south_socket_ref,msg, sizeof(*msg),0,(struct sockaddr*)&storio_north_socket_name,sizeof(storio_north_socket_name));
+    if (ret <= 0) {
+      fatal("storio_disk_thread_intf_send  sendto(%s) %s", storio_north_socket_name.sun_path, strerror(errno));
+      exit(0);  
+    }
+  }
+  
+  /*
+  ** One response is expected per request
+  */
+  af_unix_disk_pending_req_count += nb_req;
+  if (af_unix_disk_pending_req_count<MAX_PENDING_REQUEST) {
+    af_unix_disk_pending_req_tbl[af_unix_disk_pending_req_count]++;
+  }
+  else {
+    af_unix_disk_pending_req_tbl[MAX_PENDING_REQUEST-1]++;    
+  }  
+  return 0;
+}
 /*__________________________________________________________________________
 */
 /**
@@ -824,34 +907,24 @@ int storio_disk_thread_intf_send(storio_device_mapping_t      * fidCtx,
                                  rozorpc_srv_ctx_t            * rpcCtx,
 				                 uint64_t       timeStart) 
 {
-  int                         ret;
   storio_disk_thread_msg_t    msg;
+
+  /*
+  ** Reads and writes are queued per device when the scheduler is enabled
+  */
+  if (storio_sched_submit(fidCtx, rpcCtx, timeStart) == 0) {
+    return 0;
+  }
  
   /* Fill the message */
-  msg.msg_len          = sizeof(storio_disk_thread_msg_t)-sizeof(msg.msg_len);
   msg.opcode           = rpcCtx->opcode;
-  msg.status           = 0;
-  msg.transaction_id   = transactionId++;
   msg.fidIdx           = fidCtx->index;
   msg.timeStart        = timeStart;
-  msg.size             = 0;
   msg.rpcCtx           = rpcCtx;
+  msg.schedRef         = -1;
+  msg.nb_merged        = 0;
   
-  /* Send the buffer to its destination */
-  ret = sendto(af_unix_disk_south_socket_ref,&msg, sizeof(msg),0,(struct sockaddr*)&storio_north_socket_name,sizeof(storio_north_socket_name));
-  if (ret <= 0) {
-     fatal("storio_disk_thread_intf_send  sendto(%s) %s", storio_north_socket_name.sun_path, strerror(errno));
-     exit(0);  
-  }
-  
-  af_unix_disk_pending_req_count++;
-  if (af_unix_disk_pending_req_count<MAX_PENDING_REQUEST) {
-    af_unix_disk_pending_req_tbl[af_unix_disk_pending_req_count]++;
-  }
-  else {
-    af_unix_disk_pending_req_tbl[MAX_PENDING_REQUEST-1]++;    
-  }  
-  return 0;
+  return storio_disk_thread_intf_post(&msg, 1);
 }
 
 /*
@@ -931,8 +1004,25 @@ int af_unix_disk_response_socket_create(char *socketname)
 */
 void af_unix_disk_scheduler_entry_point(uint64_t current_time)
 {
+  if (storio_disk_channel != NULL) {
+    rozofs_thread_channel_poll(storio_disk_channel);
+    return;
+  }
   af_unix_disk_rcvMsgsock(NULL,af_unix_disk_south_socket_ref);
 }
+/*__________________________________________________________________________
+*/
+/**
+*   Processing of a disk response read from the disk thread rings
+*
+   @param msg : the disk response
+*/
+static void storio_disk_channel_response(void * msg)
+{
+  af_unix_disk_pending_req_count--;
+  if (af_unix_disk_pending_req_count < 0) af_unix_disk_pending_req_count = 0;
+  af_unix_disk_response((storio_disk_thread_msg_t *) msg);
+}
 
 /*__________________________________________________________________________
 * Initialize the disk thread interface
@@ -951,6 +1041,20 @@ int storio_disk_thread_intf_create(char * hostname, int instance_id, int nb_thre
 
   af_unix_disk_thread_count = nb_threads;
 
+  /*
+  ** Exchange with the disk threads through rings. A ring may have to hold 
+  ** every request since they can all be given to the same thread
+  */
+  if (common_config.thread_ring) {
+    storio_disk_channel = rozofs_thread_channel_create("disk_ring", nb_threads, 
+                                                       sizeof(storio_disk_thread_msg_t),
+                                                       common_config.storio_buf_cnt,
+                                                       storio_disk_channel_response);
+    if (storio_disk_channel == NULL) {
+      warning("Disk thread rings can not be created. Using AF_UNIX sockets.");
+    }
+  }
+
   /*
   ** init of the AF_UNIX sockaddr associated with the south socket (socket used for disk response receive)
   */
@@ -960,10 +1064,12 @@ int storio_disk_thread_intf_create(char * hostname, int instance_id, int nb_thre
   ** hostname is required for the case when several storaged run on the same server
   ** as is the case of test on one server only
   */   
-  af_unix_disk_south_socket_ref = af_unix_disk_response_socket_create(storio_south_socket_name.sun_path);
-  if (af_unix_disk_south_socket_ref < 0) {
-    fatal("storio_create_disk_thread_intf af_unix_sock_create(%s) %s",storio_south_socket_name.sun_path, strerror(errno));
-    return -1;
+  if (storio_disk_channel == NULL) {
+    af_unix_disk_south_socket_ref = af_unix_disk_response_socket_create(storio_south_socket_name.sun_path);
+    if (af_unix_disk_south_socket_ref < 0) {
+      fatal("storio_create_disk_thread_intf af_unix_sock_create(%s) %s",storio_south_socket_name.sun_path, strerror(errno));
+      return -1;
+    }
   }
  /*
   ** init of the AF_UNIX sockaddr associated with the north socket (socket used for disk request receive)
@@ -971,6 +1077,17 @@ int storio_disk_thread_intf_create(char * hostname, int instance_id, int nb_thre
   storio_set_socket_name_with_hostname(&storio_north_socket_name,ROZOFS_SOCK_FAMILY_DISK_NORTH,hostname,instance_id);
   
   uma_dbg_addTopic_option("diskThreads", disk_thread_debug,UMA_DBG_OPTION_RESET); 
+
+  /*
+  ** Per device scheduling of the reads and writes
+  */
+  if (common_config.storio_scheduler) {
+    storio_sched_init(common_config.storio_scheduler_depth, common_config.storio_scheduler_window);
+  }
+  /*
+  ** Journal of the chunks written on spare storages
+  */
+  storio_dirty_init();
   /*
   ** attach the callback on socket controller
   */
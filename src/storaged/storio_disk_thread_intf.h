@@ -30,6 +30,7 @@
 #include <rozofs/core/af_unix_socket_generic.h>
 #include <rozofs/core/rozofs_socket_family.h>
 #include <rozofs/core/rozofs_rpc_non_blocking_generic_srv.h>
+#include <rozofs/core/rozofs_ring.h>
 #include "storage.h"
 #include "storio_device_mapping.h"
 
@@ -80,6 +81,13 @@ typedef struct _rozofs_disk_thread_stat_t {
   uint64_t            rebStop_badCidSid;  
   uint64_t            rebStop_time;
 
+  uint64_t            uring_read_count;   /**< reads run through io_uring */
+  uint64_t            uring_write_count;  /**< writes run through io_uring */
+  uint64_t            uring_sync_count;   /**< reads/writes on 2 chunks or with O_DIRECT run synchronously */
+  uint64_t            uring_inflight_max; /**< max number of requests in flight */
+
+  uint64_t            merged_count;       /**< messages carrying requests merged by the scheduler */
+
 } rozofs_disk_thread_stat_t;
 /*
 ** Disk thread context
@@ -90,10 +98,15 @@ typedef struct _rozofs_disk_thread_ctx_t
   int                          thread_idx;
   char                       * hostname;  
   int                          sendSocket;
+  struct _storio_disk_uring_t * uring; /* io_uring context when this engine is used */
   rozofs_disk_thread_stat_t    stat;
 } rozofs_disk_thread_ctx_t;
 
 extern rozofs_disk_thread_ctx_t rozofs_disk_thread_ctx_tb[];
+/*
+** Rings between the main thread and the disk threads (NULL when AF_UNIX sockets are used)
+*/
+extern rozofs_thread_channel_t * storio_disk_channel;
 
 /**
 * Message sent/received in the af_unix disk sockets
@@ -113,6 +126,11 @@ typedef enum _storio_disk_thread_request_e {
   STORIO_DISK_THREAD_MAX_OPCODE
 } storio_disk_thread_request_e;
 
+/*
+** Maximum number of contiguous requests the scheduler merges in one disk access
+*/
+#define STORIO_DISK_MERGE_MAX  8
+
 typedef struct _storio_disk_thread_msg_t
 {
   uint32_t            msg_len;
@@ -123,6 +141,10 @@ typedef struct _storio_disk_thread_msg_t
   uint64_t            timeStart;
   uint64_t            size;
   rozorpc_srv_ctx_t * rpcCtx;
+  int                 schedRef;   /**< scheduler reference or -1 when not scheduled */
+  int                 nb_merged;  /**< number of merged requests (0 when not merged) */
+  rozorpc_srv_ctx_t * merged[STORIO_DISK_MERGE_MAX];     /**< merged requests in block order */
+  uint64_t            merged_tic[STORIO_DISK_MERGE_MAX]; /**< time stamps of the merged requests */
 } storio_disk_thread_msg_t;
 
 /*__________________________________________________________________________
@@ -150,6 +172,18 @@ int storio_disk_thread_intf_create(char * hostname, int instance_id, int nb_thre
 int storio_disk_thread_intf_send(storio_device_mapping_t      * fidCtx,
                                  rozorpc_srv_ctx_t            * rpcCtx,
 				 uint64_t                       timeStart) ;
+/*__________________________________________________________________________
+*/
+/**
+*  Post a filled message to the disk threads
+*
+* @param msg        the message to send
+* @param nb_req     number of requests carried by the message
+*
+* @retval 0 on success -1 in case of error
+*  
+*/
+int storio_disk_thread_intf_post(storio_disk_thread_msg_t * msg, int nb_req);
 
 /*
 **__________________________________________________________________________
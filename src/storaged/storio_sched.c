@@ -0,0 +1,583 @@
+/*
+  Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+  This file is part of Rozofs.
+
+  Rozofs is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published
+  by the Free Software Foundation, version 2.
+
+  Rozofs is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see
+  <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <rozofs/rozofs.h>
+#include <rozofs/common/log.h>
+#include <rozofs/common/list.h>
+#include <rozofs/common/xmalloc.h>
+#include <rozofs/common/common_config.h>
+#include <rozofs/rpc/sproto.h>
+#include <rozofs/core/ruc_buffer_api.h>
+#include <rozofs/core/ruc_sockCtl_api.h>
+#include <rozofs/core/uma_dbg_api.h>
+#include <rozofs/core/rozofs_string.h>
+
+#include "storage.h"
+#include "storaged.h"
+#include "storio_sched.h"
+
+/*
+** A queued request or, once dispatched, the head of a group of merged requests
+*/
+typedef struct _storio_sched_entry_t {
+  list_t              sorted;     /**< link in the elevator ordered queue of the device */
+  list_t              fifo;       /**< link in the arrival ordered queue of the device */
+  rozorpc_srv_ctx_t * rpcCtx;
+  uint64_t            timeStart;  /**< time stamp when the request has been decoded */
+  uint64_t            queued;     /**< time stamp when the request has been queued */
+  uint32_t            fidIdx;
+  uint8_t             opcode;
+  uint8_t             chunk;
+  uint8_t             layout;
+  uint8_t             bsize;
+  uint8_t             spare;
+  bid_t               bid;        /**< first block in the file */
+  uint32_t            nb_proj;
+  int                 devIdx;     /**< index of the device context */
+  int                 remaining;  /**< responses still expected for a dispatched group */
+  int                 next_free;
+} storio_sched_entry_t;
+
+/*
+** Scheduler context of a device of a storage
+*/
+typedef struct _storio_sched_dev_t {
+  cid_t               cid;
+  sid_t               sid;
+  uint8_t             dev;
+  list_t              sorted;     /**< queued requests in (FID, chunk, block) order */
+  list_t              fifo;       /**< queued requests in arrival order */
+  int                 queued;     /**< number of queued requests */
+  int                 inflight;   /**< number of messages sent to the disk threads */
+  uint32_t            last_fidIdx;/**< position of the elevator */
+  uint8_t             last_chunk;
+  bid_t               last_bid;
+  /* statistics */
+  uint64_t            requests;   /**< number of requests submitted */
+  uint64_t            dispatch;   /**< number of messages sent to the disk threads */
+  uint64_t            merged;     /**< number of requests merged in a previous one */
+  uint64_t            deadline;   /**< number of requests served on deadline */
+  int                 queue_max;  /**< maximum queue length */
+} storio_sched_dev_t;
+
+#define STORIO_SCHED_MAX_DEV  (STORAGES_MAX_BY_STORAGE_NODE*STORAGE_MAX_DEVICE_NB)
+
+static storio_sched_entry_t * storio_sched_entry = NULL;
+static int                    storio_sched_entry_nb = 0;
+static int                    storio_sched_free_idx = -1;
+static storio_sched_dev_t   * storio_sched_dev[STORIO_SCHED_MAX_DEV];
+static int                    storio_sched_depth = 0;
+static uint64_t               storio_sched_window = 0;
+static uint64_t               storio_sched_bypass = 0;
+static int                    storio_sched_stalled = 0;
+
+
+/*_______________________________________________________________________
+* Compare the position of 2 requests
+*
+* @retval <0, 0 or >0 when the 1rst position is before, equal or after the 2nd
+*/
+static inline int storio_sched_compare(uint32_t fidIdx1, uint8_t chunk1, bid_t bid1,
+                                       uint32_t fidIdx2, uint8_t chunk2, bid_t bid2) {
+  if (fidIdx1 != fidIdx2) return (fidIdx1 < fidIdx2) ? -1 : 1;
+  if (chunk1  != chunk2)  return (chunk1  < chunk2)  ? -1 : 1;
+  if (bid1    != bid2)    return (bid1    < bid2)    ? -1 : 1;
+  return 0;
+}
+/*_______________________________________________________________________
+* Tell whether the 2nd request directly follows the 1rst one
+*/
+static inline int storio_sched_contiguous(storio_sched_entry_t * e1, storio_sched_entry_t * e2) {
+  if (e1->fidIdx != e2->fidIdx)  return 0;
+  if (e1->opcode != e2->opcode)  return 0;
+  if (e1->chunk  != e2->chunk)   return 0;
+  if (e1->layout != e2->layout)  return 0;
+  if (e1->bsize  != e2->bsize)   return 0;
+  if (e1->spare  != e2->spare)   return 0;
+  return ((e1->bid + e1->nb_proj) == e2->bid);
+}
+/*_______________________________________________________________________
+* Release a scheduler entry
+*/
+static inline void storio_sched_entry_free(storio_sched_entry_t * e) {
+  e->next_free          = storio_sched_free_idx;
+  storio_sched_free_idx = e - storio_sched_entry;
+}
+/*_______________________________________________________________________
+* Get the scheduler context of a device, allocating it on first use
+*/
+static inline storio_sched_dev_t * storio_sched_dev_get(int devIdx, storage_t * st, uint8_t dev) {
+  storio_sched_dev_t * p = storio_sched_dev[devIdx];
+
+  if (p != NULL) return p;
+
+  p = xmalloc(sizeof(storio_sched_dev_t));
+  memset(p,0,sizeof(storio_sched_dev_t));
+  p->cid = st->cid;
+  p->sid = st->sid;
+  p->dev = dev;
+  list_init(&p->sorted);
+  list_init(&p->fifo);
+  storio_sched_dev[devIdx] = p;
+  return p;
+}
+/*_______________________________________________________________________
+* Insert a request in the queues of its device
+*/
+static inline void storio_sched_enqueue(storio_sched_dev_t * p, storio_sched_entry_t * e) {
+  list_t               * pos;
+  storio_sched_entry_t * q;
+
+  /*
+  ** Requests mostly come in increasing order, so search the
+  ** position from the tail
+  */
+  list_for_each_backward(pos, &p->sorted) {
+    q = list_entry(pos, storio_sched_entry_t, sorted);
+    if (storio_sched_compare(q->fidIdx, q->chunk, q->bid, e->fidIdx, e->chunk, e->bid) <= 0) break;
+  }
+  list_insert(&e->sorted, pos, pos->next);
+  list_push_back(&p->fifo, &e->fifo);
+
+  p->queued++;
+  if (p->queued > p->queue_max) p->queue_max = p->queued;
+}
+/*_______________________________________________________________________
+* Remove a request from the queues of its device
+*/
+static inline void storio_sched_dequeue(storio_sched_dev_t * p, storio_sched_entry_t * e) {
+  list_remove(&e->sorted);
+  list_remove(&e->fifo);
+  p->queued--;
+}
+/*_______________________________________________________________________
+* Choose the next request to serve on a device
+*/
+static inline storio_sched_entry_t * storio_sched_elect(storio_sched_dev_t * p) {
+  list_t               * pos;
+  storio_sched_entry_t * e;
+
+  /*
+  ** The oldest request has waited too long
+  */
+  e = list_first_entry(&p->fifo, storio_sched_entry_t, fifo);
+  if ((rozofs_get_ticker_us() - e->queued) >= storio_sched_window) {
+    p->deadline++;
+    return e;
+  }
+
+  /*
+  ** Next request after the elevator position, or wrap around
+  */
+  list_for_each_forward(pos, &p->sorted) {
+    e = list_entry(pos, storio_sched_entry_t, sorted);
+    if (storio_sched_compare(e->fidIdx, e->chunk, e->bid, p->last_fidIdx, p->last_chunk, p->last_bid) >= 0) {
+      return e;
+    }
+  }
+  return list_first_entry(&p->sorted, storio_sched_entry_t, sorted);
+}
+/*_______________________________________________________________________
+* Send a group of requests to the disk threads
+*
+* @param p     the device context
+* @param group the requests in block order
+* @param nb    number of requests in the group
+*
+* @retval 0 on success, -1 when the disk thread rings are full
+*/
+static inline int storio_sched_post(storio_sched_dev_t * p, storio_sched_entry_t ** group, int nb) {
+  storio_disk_thread_msg_t   msg;
+  storio_sched_entry_t     * head = group[0];
+  storio_sched_entry_t     * last = group[nb-1];
+  int                        i;
+
+  msg.opcode    = head->opcode;
+  msg.fidIdx    = head->fidIdx;
+  msg.timeStart = head->timeStart;
+  msg.rpcCtx    = head->rpcCtx;
+  msg.schedRef  = head - storio_sched_entry;
+  msg.nb_merged = 0;
+  if (nb > 1) {
+    msg.nb_merged = nb;
+    for (i=0; i<nb; i++) {
+      msg.merged[i]     = group[i]->rpcCtx;
+      msg.merged_tic[i] = group[i]->timeStart;
+    }
+  }
+
+  /*
+  ** No room in the disk thread rings. The requests stay queued and
+  ** the next disk response dispatches them again
+  */
+  if (storio_disk_thread_intf_post(&msg, nb) != 0) {
+    storio_sched_stalled = 1;
+    return -1;
+  }
+
+  /*
+  ** The head entry lives until every response of the group is received
+  */
+  head->remaining = nb;
+  for (i=1; i<nb; i++) storio_sched_entry_free(group[i]);
+
+  p->last_fidIdx = last->fidIdx;
+  p->last_chunk  = last->chunk;
+  p->last_bid    = last->bid + last->nb_proj;
+  p->inflight++;
+  p->dispatch++;
+  p->merged += (nb-1);
+  return 0;
+}
+/*_______________________________________________________________________
+* Send the queued requests of a device while the device is not busy
+*/
+static void storio_sched_dispatch(storio_sched_dev_t * p) {
+  storio_sched_entry_t * group[STORIO_DISK_MERGE_MAX];
+  storio_sched_entry_t * e;
+  storio_sched_entry_t * q;
+  storio_sched_entry_t * prev;
+  storio_sched_entry_t * next;
+  int                    nb;
+  int                    i;
+
+  while ((p->inflight < storio_sched_depth) && (p->queued != 0)) {
+
+    e = storio_sched_elect(p);
+
+    /*
+    ** Go back to the first contiguous request before the elected one
+    */
+    nb = 1;
+    q  = e;
+    while ((nb < STORIO_DISK_MERGE_MAX) && (q->sorted.prev != &p->sorted)) {
+      prev = list_entry(q->sorted.prev, storio_sched_entry_t, sorted);
+      if (!storio_sched_contiguous(prev,q)) break;
+      q = prev;
+      nb++;
+    }
+    
+    /*
+    ** Gather the requests up to the elected one and the contiguous ones after it
+    */
+    for (i=0; i<nb; i++) {
+      group[i] = q;
+      q = list_entry(q->sorted.next, storio_sched_entry_t, sorted);
+    }
+    q = e;
+    while ((nb < STORIO_DISK_MERGE_MAX) && (q->sorted.next != &p->sorted)) {
+      next = list_entry(q->sorted.next, storio_sched_entry_t, sorted);
+      if (!storio_sched_contiguous(q,next)) break;
+      q = next;
+      group[nb++] = q;
+    }
+
+    if (storio_sched_post(p, group, nb) != 0) break;
+    for (i=0; i<nb; i++) storio_sched_dequeue(p, group[i]);
+  }
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Submit a disk request to the scheduler
+*
+* @param fidCtx     FID context
+* @param rpcCtx     pointer to the generic rpc context
+* @param timeStart  time stamp when the request has been decoded
+*
+* @retval 0 when the scheduler takes the request,
+*         -1 when the request has to be sent directly to the disk threads
+*/
+int storio_sched_submit(storio_device_mapping_t * fidCtx,
+                        rozorpc_srv_ctx_t       * rpcCtx,
+                        uint64_t                  timeStart) {
+  storio_sched_entry_t   * e;
+  storio_sched_dev_t     * p;
+  storage_t              * st;
+  sp_read_arg_t          * rd;
+  sp_write_arg_no_bins_t * wr;
+  cid_t                    cid;
+  sid_t                    sid;
+  uint8_t                  layout, bsize, spare;
+  bid_t                    bid;
+  uint32_t                 nb_proj;
+  int                      block_per_chunk;
+  int                      chunk;
+  uint8_t                  dev;
+  int                      devIdx;
+
+  if (storio_sched_entry == NULL) return -1;
+
+  switch (rpcCtx->opcode) {
+
+    case STORIO_DISK_THREAD_READ:
+      rd      = (sp_read_arg_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
+      cid     = rd->cid;
+      sid     = rd->sid;
+      layout  = rd->layout;
+      bsize   = rd->bsize;
+      spare   = rd->spare;
+      bid     = rd->bid;
+      nb_proj = rd->nb_proj;
+      break;
+
+    case STORIO_DISK_THREAD_WRITE:
+      wr      = (sp_write_arg_no_bins_t*) ruc_buf_getPayload(rpcCtx->decoded_arg);
+      cid     = wr->cid;
+      sid     = wr->sid;
+      layout  = wr->layout;
+      bsize   = wr->bsize;
+      spare   = wr->spare;
+      bid     = wr->bid;
+      nb_proj = wr->nb_proj;
+      break;
+
+    default:
+      return -1;
+  }
+
+  /*
+  ** Only requests within a single chunk whose device is known are scheduled
+  */
+  block_per_chunk = ROZOFS_STORAGE_NB_BLOCK_PER_CHUNK(bsize);
+  chunk = bid / block_per_chunk;
+  if (chunk >= ROZOFS_STORAGE_MAX_CHUNK_PER_FILE) return -1;
+  if (((bid % block_per_chunk) + nb_proj) > block_per_chunk) return -1;
+  dev = fidCtx->device[chunk];
+  if (dev >= STORAGE_MAX_DEVICE_NB) return -1;
+
+  st = storaged_lookup(cid, sid);
+  if (st == NULL) return -1;
+  devIdx = (st - storaged_storages) * STORAGE_MAX_DEVICE_NB + dev;
+
+  if (storio_sched_free_idx == -1) {
+    storio_sched_bypass++;
+    return -1;
+  }
+  e = &storio_sched_entry[storio_sched_free_idx];
+  storio_sched_free_idx = e->next_free;
+
+  e->rpcCtx    = rpcCtx;
+  e->timeStart = timeStart;
+  e->queued    = rozofs_get_ticker_us();
+  e->fidIdx    = fidCtx->index;
+  e->opcode    = rpcCtx->opcode;
+  e->chunk     = chunk;
+  e->layout    = layout;
+  e->bsize     = bsize;
+  e->spare     = spare;
+  e->bid       = bid;
+  e->nb_proj   = nb_proj;
+  e->devIdx    = devIdx;
+  e->remaining = 0;
+
+  p = storio_sched_dev_get(devIdx, st, dev);
+  p->requests++;
+
+  /*
+  ** Device is not busy
+  */
+  if ((p->inflight < storio_sched_depth) && (p->queued == 0)) {
+    if (storio_sched_post(p, &e, 1) == 0) return 0;
+  }
+
+  storio_sched_enqueue(p, e);
+  storio_sched_dispatch(p);
+  return 0;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Account for a disk response of a scheduled request and dispatch
+*  the next requests of its device
+*
+* @param msg        the disk response
+*/
+void storio_sched_response(storio_disk_thread_msg_t * msg) {
+  storio_sched_entry_t * e;
+  storio_sched_dev_t   * p;
+  int                    idx;
+
+  /*
+  ** Some requests could not be posted because the disk thread rings
+  ** were full. This response made some room
+  */
+  if (storio_sched_stalled) {
+    storio_sched_stalled = 0;
+    for (idx=0; idx<STORIO_SCHED_MAX_DEV; idx++) {
+      p = storio_sched_dev[idx];
+      if ((p == NULL) || (p->queued == 0)) continue;
+      storio_sched_dispatch(p);
+    }
+  }
+
+  if (msg->schedRef < 0) return;
+  if (msg->schedRef >= storio_sched_entry_nb) {
+    severe("Bad scheduler reference %d", msg->schedRef);
+    return;
+  }
+
+  e = &storio_sched_entry[msg->schedRef];
+  e->remaining--;
+  if (e->remaining > 0) return;
+
+  p = storio_sched_dev[e->devIdx];
+  storio_sched_entry_free(e);
+  p->inflight--;
+  storio_sched_dispatch(p);
+}
+/*_______________________________________________________________________
+* Display scheduler debug help
+*/
+static char * storio_sched_debug_help(char * pChar) {
+  pChar += rozofs_string_append(pChar,"usage:\ndiskScheduler reset       : reset scheduler counters\n");
+  return pChar;
+}
+/*_______________________________________________________________________
+* Scheduler debug function
+*/
+static void storio_sched_debug(char * argv[], uint32_t tcpRef, void *bufRef) {
+  char               * p = uma_dbg_get_buffer();
+  storio_sched_dev_t * d;
+  int                  idx;
+  int                  doreset=0;
+  char               * sep = "+-----+-----+-----+------------+------------+------------+------------+-------+-------+-------+-------+\n";
+
+  if (argv[1] != NULL) {
+    if (strcmp(argv[1],"reset")==0) {
+      doreset = 1;
+    }
+    else {
+      p = storio_sched_debug_help(p);
+      uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
+      return;
+    }
+  }
+
+  if (storio_sched_entry == NULL) {
+    p += rozofs_string_append(p,"disk scheduler is disabled\n");
+    uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
+    return;
+  }
+
+  p += rozofs_string_append(p,"depth    = ");
+  p += rozofs_u32_append(p,storio_sched_depth);
+  p += rozofs_string_append(p,"\nwindow   = ");
+  p += rozofs_u64_append(p,storio_sched_window);
+  p += rozofs_string_append(p," us\nbypass   = ");
+  p += rozofs_u64_append(p,storio_sched_bypass);
+  p += rozofs_eol(p);
+
+  p += rozofs_string_append(p, sep);
+  p += rozofs_string_append(p,"| cid | sid | dev |  requests  | dispatches |   merged   |  deadline  | ratio | queue |  max  | run   |\n");
+  p += rozofs_string_append(p, sep);
+
+  for (idx=0; idx<STORIO_SCHED_MAX_DEV; idx++) {
+    d = storio_sched_dev[idx];
+    if (d == NULL) continue;
+
+    *p++ = '|';
+    p += rozofs_u32_padded_append(p,4,rozofs_right_alignment,d->cid);
+    p += rozofs_string_append(p," |");
+    p += rozofs_u32_padded_append(p,4,rozofs_right_alignment,d->sid);
+    p += rozofs_string_append(p," |");
+    p += rozofs_u32_padded_append(p,4,rozofs_right_alignment,d->dev);
+    p += rozofs_string_append(p," |");
+    p += rozofs_u64_padded_append(p,11,rozofs_right_alignment,d->requests);
+    p += rozofs_string_append(p," |");
+    p += rozofs_u64_padded_append(p,11,rozofs_right_alignment,d->dispatch);
+    p += rozofs_string_append(p," |");
+    p += rozofs_u64_padded_append(p,11,rozofs_right_alignment,d->merged);
+    p += rozofs_string_append(p," |");
+    p += rozofs_u64_padded_append(p,11,rozofs_right_alignment,d->deadline);
+    p += rozofs_string_append(p," |");
+    /* average number of requests per disk access in hundredths */
+    if (d->dispatch == 0) {
+      p += rozofs_string_padded_append(p,6,rozofs_right_alignment,"-");
+    }
+    else {
+      uint64_t ratio = (d->requests * 100) / d->dispatch;
+      p += sprintf(p,"%3llu.%2.2llu",
+                   (unsigned long long)(ratio/100), (unsigned long long)(ratio%100));
+    }
+    p += rozofs_string_append(p," |");
+    p += rozofs_u32_padded_append(p,6,rozofs_right_alignment,d->queued);
+    p += rozofs_string_append(p," |");
+    p += rozofs_u32_padded_append(p,6,rozofs_right_alignment,d->queue_max);
+    p += rozofs_string_append(p," |");
+    p += rozofs_u32_padded_append(p,6,rozofs_right_alignment,d->inflight);
+    p += rozofs_string_append(p," |\n");
+
+    if (doreset) {
+      d->requests  = 0;
+      d->dispatch  = 0;
+      d->merged    = 0;
+      d->deadline  = 0;
+      d->queue_max = d->queued;
+    }
+  }
+  p += rozofs_string_append(p, sep);
+
+  if (doreset) {
+    storio_sched_bypass = 0;
+    p += rozofs_string_append(p,"Reset Done\n");
+  }
+  uma_dbg_send(tcpRef,bufRef,TRUE,uma_dbg_get_buffer());
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Initialize the storio scheduler
+*
+* @param depth    number of messages in flight per device
+* @param window   deadline in us after which a queued request is served first
+*
+* @retval 0 on success -1 in case of error
+*/
+int storio_sched_init(int depth, int window) {
+  int idx;
+
+  storio_sched_depth  = depth;
+  storio_sched_window = window;
+
+  /*
+  ** There can not be more requests than decoding buffers
+  */
+  storio_sched_entry_nb = common_config.storio_buf_cnt;
+  storio_sched_entry = xmalloc(storio_sched_entry_nb * sizeof(storio_sched_entry_t));
+  if (storio_sched_entry == NULL) {
+    severe("storio_sched_init out of memory");
+    return -1;
+  }
+  memset(storio_sched_entry, 0, storio_sched_entry_nb * sizeof(storio_sched_entry_t));
+
+  storio_sched_free_idx = -1;
+  for (idx=storio_sched_entry_nb-1; idx>=0; idx--) {
+    list_init(&storio_sched_entry[idx].sorted);
+    list_init(&storio_sched_entry[idx].fifo);
+    storio_sched_entry_free(&storio_sched_entry[idx]);
+  }
+  memset(storio_sched_dev, 0, sizeof(storio_sched_dev));
+
+  uma_dbg_addTopic_option("diskScheduler", storio_sched_debug, UMA_DBG_OPTION_RESET);
+  return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+ This file is part of Rozofs.
+
+ Rozofs is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published
+ by the Free Software Foundation, version 2.
+
+ Rozofs is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see
+ <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef STORIO_SCHED_H
+#define STORIO_SCHED_H
+
+#include <stdint.h>
+#include <rozofs/rozofs.h>
+#include <rozofs/core/rozofs_rpc_non_blocking_generic_srv.h>
+
+#include "storio_disk_thread_intf.h"
+#include "storio_device_mapping.h"
+
+/*
+** The storio scheduler runs in the main thread between the request
+** decoding and the disk threads. Reads and writes that fit in a single
+** chunk are queued per device and sent to the disk threads in elevator
+** order (FID, chunk, block), at most storio_scheduler_depth at a time
+** per device. Contiguous queued requests on the same chunk are merged
+** in one disk thread message. A request waiting for more than
+** storio_scheduler_window microseconds is served first.
+*/
+
+/*__________________________________________________________________________
+*/
+/**
+*  Initialize the storio scheduler
+*
+* @param depth    number of messages in flight per device
+* @param window   deadline in us after which a queued request is served first
+*
+* @retval 0 on success -1 in case of error
+*/
+int storio_sched_init(int depth, int window);
+/*__________________________________________________________________________
+*/
+/**
+*  Submit a disk request to the scheduler
+*
+* @param fidCtx     FID context
+* @param rpcCtx     pointer to the generic rpc context
+* @param timeStart  time stamp when the request has been decoded
+*
+* @retval 0 when the scheduler takes the request,
+*         -1 when the request has to be sent directly to the disk threads
+*/
+int storio_sched_submit(storio_device_mapping_t * fidCtx,
+                        rozorpc_srv_ctx_t       * rpcCtx,
+                        uint64_t                  timeStart);
+/*__________________________________________________________________________
+*/
+/**
+*  Account for a disk response of a scheduled request and dispatch
+*  the next requests of its device
+*
+* @param msg        the disk response
+*/
+void storio_sched_response(storio_disk_thread_msg_t * msg);
+
+#endif
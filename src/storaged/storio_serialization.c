@@ -39,6 +39,7 @@
 uint64_t   storage_unqueued_req[STORIO_DISK_THREAD_MAX_OPCODE]={0};
 uint64_t   storage_queued_req[STORIO_DISK_THREAD_MAX_OPCODE]={0};
 uint64_t   storage_direct_req[STORIO_DISK_THREAD_MAX_OPCODE]={0};
+uint64_t   storage_rejected_req[STORIO_DISK_THREAD_MAX_OPCODE]={0};
 
 
 /*_______________________________________________________________________
@@ -55,6 +56,7 @@ static inline void reset_serialization_counters(void) {
   memset(storage_queued_req,0, sizeof(storage_queued_req));
   memset(storage_unqueued_req,0, sizeof(storage_unqueued_req));
   memset(storage_direct_req,0, sizeof(storage_direct_req));
+  memset(storage_rejected_req,0, sizeof(storage_rejected_req));
 }
 /*_______________________________________________________________________
 * Display opcode
@@ -79,7 +81,7 @@ char * serialize_opcode_string(int opcode) {
 void display_serialization_counters (char * argv[], uint32_t tcpRef, void *bufRef) {
   char          * p = uma_dbg_get_buffer();
   int             opcode;
-  char          * sep = "+----------------+------------------+------------------+------------------+\n";
+  char          * sep = "+----------------+------------------+------------------+------------------+------------------+\n";
   int             doreset=0;
   
   if (argv[1] != NULL) {
@@ -94,7 +96,7 @@ void display_serialization_counters (char * argv[], uint32_t tcpRef, void *bufRe
   } 
       
   p += rozofs_string_append(p, sep);
-  p += rozofs_string_append(p,"|    request     |     direct       |     queued       |     unqueued     |\n");
+  p += rozofs_string_append(p,"|    request     |     direct       |     queued       |     unqueued     |     rejected     |\n");
   p += rozofs_string_append(p, sep); 
   for (opcode=1; opcode<STORIO_DISK_THREAD_MAX_OPCODE; opcode++) {  
     *p++ = '|'; *p++ = ' ';
@@ -106,6 +108,8 @@ void display_serialization_counters (char * argv[], uint32_t tcpRef, void *bufRe
     *p++ = ' '; *p++ = '|';    
     p += rozofs_u64_padded_append(p,17,rozofs_right_alignment,storage_unqueued_req[opcode]);
     *p++ = ' '; *p++ = '|'; 
+    p += rozofs_u64_padded_append(p,17,rozofs_right_alignment,storage_rejected_req[opcode]);
+    *p++ = ' '; *p++ = '|'; 
     p += rozofs_eol(p);;      
   }
   p += rozofs_string_append(p, sep);
@@ -138,12 +142,27 @@ static inline int storio_serialization_direct_run(storio_device_mapping_t * dev_
 ** Put a request in the run queue
 */
 static inline int storio_serialization_unqueue_run(storio_device_mapping_t * dev_map_p, rozorpc_srv_ctx_t *req_ctx_p, uint64_t toc) {
+  sp_status_ret_t ret;
+
   list_remove(&req_ctx_p->list);
   list_push_back(&dev_map_p->running_request,&req_ctx_p->list);
   storage_unqueued_req[req_ctx_p->opcode]++;    
 
-  storio_disk_thread_intf_send(dev_map_p,req_ctx_p,toc) ;
-  return 1;  
+  if (storio_disk_thread_intf_send(dev_map_p,req_ctx_p,toc) == 0) {
+    return 1;
+  }  
+  
+  /*
+  ** No room in the disk thread rings. Fail the request with EAGAIN.
+  ** The failure of every storio reply is encoded as a sp_status_ret_t.
+  */
+  storage_rejected_req[req_ctx_p->opcode]++;
+  ret.status                  = SP_FAILURE;
+  ret.sp_status_ret_t_u.error = EAGAIN;
+  req_ctx_p->xdr_result = (xdrproc_t) xdr_sp_status_ret_t;
+  rozorpc_srv_forward_reply(req_ctx_p,(char*)&ret);
+  rozorpc_srv_release_context(req_ctx_p);
+  return 0;  
 }
 /*
 **___________________________________________________________
@@ -366,7 +385,12 @@ void storio_serialization_end(storio_device_mapping_t * dev_map_p, rozorpc_srv_c
     ** No running request. This request can be unqueued
     */
     if (list_empty(&dev_map_p->running_request)) {
-      storio_serialization_unqueue_run(dev_map_p,req, toc);
+      if (!storio_serialization_unqueue_run(dev_map_p,req, toc)) {
+        /*
+        ** The request has been rejected and released
+        */
+        continue;
+      }
       /*
       ** When 1rst dequeued request is excluse, 
       ** no need to consider the following requests
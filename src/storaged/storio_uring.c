@@ -0,0 +1,158 @@
+/*
+ Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+ This file is part of Rozofs.
+
+ Rozofs is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published
+ by the Free Software Foundation, version 2.
+
+ Rozofs is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see
+ <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "storio_uring.h"
+
+#ifdef HAVE_LINUX_IO_URING_H
+/*
+**__________________________________________________________________________
+*/
+int storio_uring_init(storio_uring_t * ring, uint32_t entries) {
+  struct io_uring_params p;
+  
+  memset(ring,0,sizeof(*ring));
+  memset(&p,0,sizeof(p));
+  ring->fd = -1;
+
+#ifndef __NR_io_uring_setup
+  errno = ENOSYS;
+  return -1;
+#else  
+  ring->fd = syscall(__NR_io_uring_setup, entries, &p);
+  if (ring->fd < 0) {
+    ring->fd = -1;
+    return -1;
+  }
+  ring->entries = p.sq_entries;
+
+  /*
+  ** Map the submission and the completion rings
+  */
+  ring->sq_ring_sz = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+  ring->cq_ring_sz = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    if (ring->cq_ring_sz > ring->sq_ring_sz) ring->sq_ring_sz = ring->cq_ring_sz;
+    ring->cq_ring_sz = ring->sq_ring_sz;
+  }
+  ring->sq_ring = mmap(NULL, ring->sq_ring_sz, PROT_READ|PROT_WRITE, 
+                       MAP_SHARED|MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+  if (ring->sq_ring == MAP_FAILED) {
+    ring->sq_ring = NULL;
+    goto error;
+  }
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    ring->cq_ring = ring->sq_ring;
+  }
+  else {
+    ring->cq_ring = mmap(NULL, ring->cq_ring_sz, PROT_READ|PROT_WRITE, 
+                         MAP_SHARED|MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    if (ring->cq_ring == MAP_FAILED) {
+      ring->cq_ring = NULL;
+      goto error;
+    }  
+  }
+  ring->sqes_sz = p.sq_entries * sizeof(struct io_uring_sqe);
+  ring->sqes = mmap(NULL, ring->sqes_sz, PROT_READ|PROT_WRITE, 
+                    MAP_SHARED|MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+  if (ring->sqes == MAP_FAILED) {
+    ring->sqes = NULL;
+    goto error;
+  }
+
+  ring->sq_head  = (uint32_t*)((char*)ring->sq_ring + p.sq_off.head);
+  ring->sq_tail  = (uint32_t*)((char*)ring->sq_ring + p.sq_off.tail);
+  ring->sq_mask  = (uint32_t*)((char*)ring->sq_ring + p.sq_off.ring_mask);
+  ring->sq_array = (uint32_t*)((char*)ring->sq_ring + p.sq_off.array);
+  ring->cq_head  = (uint32_t*)((char*)ring->cq_ring + p.cq_off.head);
+  ring->cq_tail  = (uint32_t*)((char*)ring->cq_ring + p.cq_off.tail);
+  ring->cq_mask  = (uint32_t*)((char*)ring->cq_ring + p.cq_off.ring_mask);
+  ring->cqes     = (struct io_uring_cqe*)((char*)ring->cq_ring + p.cq_off.cqes);
+  ring->sqe_tail = *ring->sq_tail;
+  return 0;
+
+error:
+  storio_uring_release(ring);
+  return -1;
+#endif  
+}
+/*
+**__________________________________________________________________________
+*/
+void storio_uring_release(storio_uring_t * ring) {
+  int save_errno = errno;
+
+  if (ring->sqes != NULL) munmap(ring->sqes, ring->sqes_sz);
+  if ((ring->cq_ring != NULL) && (ring->cq_ring != ring->sq_ring)) munmap(ring->cq_ring, ring->cq_ring_sz);
+  if (ring->sq_ring != NULL) munmap(ring->sq_ring, ring->sq_ring_sz);
+  if (ring->fd != -1) close(ring->fd);
+  memset(ring,0,sizeof(*ring));
+  ring->fd = -1;
+  errno = save_errno;
+}
+/*
+**__________________________________________________________________________
+*/
+int storio_uring_register_buffer(storio_uring_t * ring, void * base, size_t len) {
+  struct iovec vector;
+  int          ret;
+  
+  vector.iov_base = base;
+  vector.iov_len  = len;
+#ifndef __NR_io_uring_register
+  errno = ENOSYS;
+  return -1;
+#else  
+  ret = syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, &vector, 1);
+  if (ret < 0) return -1;
+  ring->fixed_base = base;
+  ring->fixed_len  = len;
+  return 0;
+#endif  
+}
+/*
+**__________________________________________________________________________
+*/
+int storio_uring_submit_and_wait(storio_uring_t * ring, uint32_t wait_nr) {
+  uint32_t submit = ring->to_submit;
+  int      ret;
+  
+  /*
+  ** Publish the prepared entries to the kernel
+  */
+  __atomic_store_n(ring->sq_tail,ring->sqe_tail,__ATOMIC_RELEASE);
+  
+#ifndef __NR_io_uring_enter
+  errno = ENOSYS;
+  return -1;
+#else  
+  ret = syscall(__NR_io_uring_enter, ring->fd, submit, wait_nr, 
+                (wait_nr ? IORING_ENTER_GETEVENTS : 0), NULL, _NSIG/8);
+  if (ret < 0) return -1;
+  ring->to_submit -= ret;
+  return ret;
+#endif  
+}
+#endif
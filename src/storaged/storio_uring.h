@@ -0,0 +1,219 @@
+/*
+ Copyright (c) 2010 Fizians SAS. <http://www.fizians.com>
+ This file is part of Rozofs.
+
+ Rozofs is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published
+ by the Free Software Foundation, version 2.
+
+ Rozofs is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see
+ <http://www.gnu.org/licenses/>.
+ */
+ 
+#ifndef STORIO_URING_H
+#define STORIO_URING_H
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/uio.h>
+#include "config.h"
+
+/*
+** The io_uring engine is only built when the kernel headers provide it.
+** Otherwise the disk threads use the thread per request model.
+*/
+#ifdef HAVE_LINUX_IO_URING_H
+#include <linux/io_uring.h>
+
+/*
+** Minimal io_uring ring used by the STORIO disk threads.
+** The kernel interface is used directly through the io_uring 
+** system calls, so no extra library is required.
+*/
+typedef struct _storio_uring_t {
+  int                   fd;           /**< io_uring file descriptor */
+  uint32_t              entries;      /**< number of submission entries */
+  /*
+  ** Submission queue
+  */
+  uint32_t            * sq_head;
+  uint32_t            * sq_tail;
+  uint32_t            * sq_mask;
+  uint32_t            * sq_array;
+  struct io_uring_sqe * sqes;
+  uint32_t              sqe_tail;     /**< local tail of the prepared entries */
+  uint32_t              to_submit;    /**< number of prepared entries not yet submitted */
+  /*
+  ** Completion queue
+  */
+  uint32_t            * cq_head;
+  uint32_t            * cq_tail;
+  uint32_t            * cq_mask;
+  struct io_uring_cqe * cqes;
+  /*
+  ** Mapped memory
+  */
+  void                * sq_ring;
+  size_t                sq_ring_sz;
+  void                * cq_ring;
+  size_t                cq_ring_sz;
+  size_t                sqes_sz;
+  /*
+  ** Registered buffer 
+  */
+  char                * fixed_base;
+  size_t                fixed_len;
+} storio_uring_t;
+
+/*__________________________________________________________________________
+*/
+/**
+*  Create an io_uring
+
+  @param ring    : the ring context to initialize
+  @param entries : number of submission entries (power of 2)
+  
+  @retval 0 on success -1 on error (errno is set)
+*/
+int storio_uring_init(storio_uring_t * ring, uint32_t entries);
+/*__________________________________________________________________________
+*/
+/**
+*  Release an io_uring
+
+  @param ring    : the ring context
+*/
+void storio_uring_release(storio_uring_t * ring);
+/*__________________________________________________________________________
+*/
+/**
+*  Register a memory area for the fixed read and write operations
+
+  @param ring    : the ring context
+  @param base    : start of the area
+  @param len     : length of the area
+  
+  @retval 0 on success -1 on error (errno is set)
+*/
+int storio_uring_register_buffer(storio_uring_t * ring, void * base, size_t len);
+/*__________________________________________________________________________
+*/
+/**
+*  Submit the prepared entries and wait for some completions
+
+  @param ring    : the ring context
+  @param wait_nr : number of completions to wait for
+  
+  @retval number of submitted entries on success -1 on error (errno is set)
+*/
+int storio_uring_submit_and_wait(storio_uring_t * ring, uint32_t wait_nr);
+/*__________________________________________________________________________
+*/
+/**
+*  Get a free submission entry 
+
+  @param ring    : the ring context
+  
+  @retval the entry or NULL when the submission queue is full
+*/
+static inline struct io_uring_sqe * storio_uring_get_sqe(storio_uring_t * ring) {
+  struct io_uring_sqe * sqe;
+  uint32_t              head;
+  
+  head = __atomic_load_n(ring->sq_head,__ATOMIC_ACQUIRE);
+  if ((ring->sqe_tail - head) >= ring->entries) return NULL;
+  
+  sqe = &ring->sqes[ring->sqe_tail & *ring->sq_mask];
+  ring->sq_array[ring->sqe_tail & *ring->sq_mask] = ring->sqe_tail & *ring->sq_mask;
+  ring->sqe_tail++;
+  ring->to_submit++;
+  memset(sqe,0,sizeof(*sqe));
+  return sqe;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Prepare a read or a write. A fixed operation is used when the buffer
+   is within the registered area and a vectored one otherwise.
+
+  @param ring      : the ring context
+  @param sqe       : the submission entry
+  @param write     : 1 for a write, 0 for a read
+  @param fd        : file descriptor
+  @param vector    : the vector of buffers
+  @param nb_vect   : number of buffers in the vector
+  @param offset    : offset in the file
+  @param user_data : opaque returned in the completion
+*/
+static inline void storio_uring_prep_rw(storio_uring_t * ring, struct io_uring_sqe * sqe, int write,
+                                        int fd, struct iovec * vector, int nb_vect, 
+                                        off_t offset, uint64_t user_data) {
+  char * base = vector[0].iov_base;
+
+  sqe->fd        = fd;
+  sqe->off       = offset;
+  sqe->user_data = user_data;
+  
+  if ((nb_vect == 1) && (ring->fixed_base != NULL)
+  &&  (base >= ring->fixed_base) 
+  &&  ((base + vector[0].iov_len) <= (ring->fixed_base + ring->fixed_len))) {
+    sqe->opcode    = write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+    sqe->addr      = (uint64_t)(uintptr_t) base;
+    sqe->len       = vector[0].iov_len;
+    sqe->buf_index = 0;
+    return;
+  }
+  sqe->opcode = write ? IORING_OP_WRITEV : IORING_OP_READV;
+  sqe->addr   = (uint64_t)(uintptr_t) vector;
+  sqe->len    = nb_vect;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Prepare a poll of a file descriptor
+
+  @param sqe       : the submission entry
+  @param fd        : file descriptor
+  @param mask      : poll events
+  @param user_data : opaque returned in the completion
+*/
+static inline void storio_uring_prep_poll(struct io_uring_sqe * sqe, int fd, 
+                                          uint32_t mask, uint64_t user_data) {
+  sqe->opcode      = IORING_OP_POLL_ADD;
+  sqe->fd          = fd;
+  sqe->poll_events = mask;
+  sqe->user_data   = user_data;
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Get the next completion if any
+
+  @param ring    : the ring context
+  
+  @retval the completion or NULL when none
+*/
+static inline struct io_uring_cqe * storio_uring_peek_cqe(storio_uring_t * ring) {
+  uint32_t head = *ring->cq_head;
+  
+  if (head == __atomic_load_n(ring->cq_tail,__ATOMIC_ACQUIRE)) return NULL;
+  return &ring->cqes[head & *ring->cq_mask];
+}
+/*__________________________________________________________________________
+*/
+/**
+*  Release the completion got by storio_uring_peek_cqe
+
+  @param ring    : the ring context
+*/
+static inline void storio_uring_cqe_seen(storio_uring_t * ring) {
+  __atomic_store_n(ring->cq_head,*ring->cq_head+1,__ATOMIC_RELEASE);
+}
+#endif
+#endif
@@ -77,9 +77,32 @@ typedef struct _stspare_stat_t {
   uint64_t      rebuild_nominal_success;
   uint64_t      rebuild_spare_attempt;
   uint64_t      rebuild_spare_success;
+  time_t        run_start;             //< Start time of the current run
+  uint64_t      run_files_to_restore;  //< Spare files given to the restore threads in the current run
+  uint64_t      run_files_processed;   //< Spare files processed in the current run
+  uint64_t      restore_running;       //< storage_rebuild commands currently running
 } stspare_stat_t;
 stspare_stat_t stspare_stat={0};
 
+/*
+** Restore pipeline. The spare files to restore are sorted, the most
+** recently written first, and are processed by spare_restore_parallel
+** threads. No more than spare_restore_per_storage storage_rebuild
+** commands run at the same time toward one storage.
+*/
+typedef struct _stspare_restore_job_t {
+  stspare_fid_cache_t * fidCtx;     //< The FID cache context of the spare file
+  uint64_t              sidBitMap;  //< Bitmap of the available sid in the cluster
+  int                   result;     //< 0 when the context is to be released
+} stspare_restore_job_t;
+
+static pthread_mutex_t         stspare_restore_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t          stspare_restore_cond = PTHREAD_COND_INITIALIZER;
+static uint8_t                 stspare_target_busy[ROZOFS_CLUSTERS_MAX+1][SID_MAX+1];
+static stspare_restore_job_t * stspare_restore_jobs = NULL;
+static int                     stspare_restore_nb_jobs = 0;
+static int                     stspare_restore_next_job = 0;
+
 
 #define       MAX_STORAGED_HOSTNAMES 64
 char *        pHostArray[MAX_STORAGED_HOSTNAMES]={0};
@@ -175,6 +198,8 @@ void stspare_debug_stat(char * pChar) {
   STSPARE_DEBUG_STRING(export_host_name_list,common_config.export_hosts);
   STSPARE_DEBUG_INT(spare_restore_loop_delay,common_config.spare_restore_loop_delay);
   STSPARE_DEBUG_INT(read_throughput_MB,common_config.spare_restore_read_throughput);
+  STSPARE_DEBUG_INT(restore_parallel,common_config.spare_restore_parallel);
+  STSPARE_DEBUG_INT(restore_per_storage,common_config.spare_restore_per_storage);
 
   pChar -= 2;
   pChar += sprintf(pChar,"\n  },\n");
@@ -196,6 +221,23 @@ void stspare_debug_stat(char * pChar) {
   STSPARE_DEBUG_STAT(rebuild_spare_attempt);
   STSPARE_DEBUG_STAT(rebuild_spare_success);  
   STSPARE_DEBUG_INT (pending_spare_file,stspare_fid_cache_stat.allocation-stspare_fid_cache_stat.release);
+  STSPARE_DEBUG_STAT(restore_running);
+  STSPARE_DEBUG_STAT(run_files_to_restore);
+  STSPARE_DEBUG_STAT(run_files_processed);
+  {
+    /*
+    ** Estimate the remaining time of the current restore from its rate
+    */
+    uint64_t done    = stspare_stat.run_files_processed;
+    uint64_t todo    = stspare_stat.run_files_to_restore;
+    uint64_t elapsed = 0;
+    uint64_t eta     = 0;
+
+    if (stspare_stat.run_start) elapsed = time(NULL) - stspare_stat.run_start;
+    if ((done != 0) && (todo > done)) eta = ((todo - done) * elapsed) / done;
+    STSPARE_DEBUG_INT (run_elapsed_seconds,elapsed);
+    STSPARE_DEBUG_INT (run_eta_seconds,eta);
+  }
    
   pChar -= 2;
   pChar += sprintf(pChar,"\n  }\n");
@@ -303,18 +345,51 @@ uint64_t stspare_get_sid_bitmap(cid_t cid) {
 /*
 **____________________________________________________
 **
+** Run a storage_rebuild command toward a storage, waiting until less
+** than spare_restore_per_storage commands are running toward it
+**
+** @param cid          The cluster of the storage to rebuild
+** @param sid          The storage to rebuild
+** @param cmd          The storage_rebuild command
+**
+** @retval the exit status of the command
+**____________________________________________________
+*/
+static int stspare_run_rebuild(cid_t cid, sid_t sid, char * cmd) {
+  int ret;
+
+  pthread_mutex_lock(&stspare_restore_lock);
+  while (stspare_target_busy[cid][sid] >= common_config.spare_restore_per_storage) {
+    pthread_cond_wait(&stspare_restore_cond, &stspare_restore_lock);
+  }
+  stspare_target_busy[cid][sid]++;
+  stspare_stat.restore_running++;
+  pthread_mutex_unlock(&stspare_restore_lock);
+
+  ret = system(cmd);
+
+  pthread_mutex_lock(&stspare_restore_lock);
+  stspare_target_busy[cid][sid]--;
+  stspare_stat.restore_running--;
+  pthread_cond_broadcast(&stspare_restore_cond);
+  pthread_mutex_unlock(&stspare_restore_lock);
+
+  return WEXITSTATUS(ret);
+}
+/*
+**____________________________________________________
+**
 ** One spare file with only holes restoring
 **
 ** @param fidCtx       The FID cache context of the spare file
 **
-** @retval 0 when FID context is completly processed
+** @retval 0 when FID context is completly processed and is to be released
 **         1 else
 **____________________________________________________
 */
 int stspare_restore_hole(stspare_fid_cache_t * fidCtx, uint64_t sidBitMap, char * fidString) {
   int                            idx;
   char                           cmd[512];
-  int                            ret;
   int                            result;
   uint8_t                        fwd;
    
@@ -329,7 +404,7 @@ int stspare_restore_hole(stspare_fid_cache_t * fidCtx, uint64_t sidBitMap, char
     ** Abnormal case. Forget about this context,
     ** we will see later.
     */
-    goto release;   
+    return 0;   
   }
   /*
   ** One must rebuild every projections since we do not know which sid is
@@ -359,15 +434,14 @@ int stspare_restore_hole(stspare_fid_cache_t * fidCtx, uint64_t sidBitMap, char
             common_config.spare_restore_read_throughput,
 	    fidCtx->data.key.cid, fidCtx->data.dist[idx-1],  fidString,
 	    fidCtx->data.key.chunk, fidCtx->data.prj[0].start, fidCtx->data.prj[0].stop);	 		 
-    ret    = system(cmd);
-    result = WEXITSTATUS(ret);
+    result = stspare_run_rebuild(fidCtx->data.key.cid, fidCtx->data.dist[idx-1], cmd);
 
     /*
     ** Update statistics
     */
-    stspare_stat.rebuild_nominal_attempt++;
+    __atomic_fetch_add(&stspare_stat.rebuild_nominal_attempt,1,__ATOMIC_SEQ_CST);
     if (result==0) {
-      stspare_stat.rebuild_nominal_success++;
+      __atomic_fetch_add(&stspare_stat.rebuild_nominal_success,1,__ATOMIC_SEQ_CST);
     }    
     sleep(1);    
   } 
@@ -379,27 +453,21 @@ int stspare_restore_hole(stspare_fid_cache_t * fidCtx, uint64_t sidBitMap, char
           common_config.spare_restore_read_throughput,  
 	  fidCtx->data.key.cid, fidCtx->data.key.sid,  fidString,
 	  fidCtx->data.key.chunk, fidCtx->data.prj[0].start, fidCtx->data.prj[0].stop);
-  ret    = system(cmd);
-  result = WEXITSTATUS(ret);
+  result = stspare_run_rebuild(fidCtx->data.key.cid, fidCtx->data.key.sid, cmd);
 
   /*
   ** Update statistics
   */    
-  stspare_stat.rebuild_spare_attempt++;
+  __atomic_fetch_add(&stspare_stat.rebuild_spare_attempt,1,__ATOMIC_SEQ_CST);
   if (result==0) {
-    stspare_stat.rebuild_spare_success++;
+    __atomic_fetch_add(&stspare_stat.rebuild_spare_success,1,__ATOMIC_SEQ_CST);
   }     
   sleep(1);
 
   /*
-  ** Everything that could be done has been done
+  ** Everything that could be done has been done.
+  ** The context is to be released.
   */
-  
-release:
-  /*
-  ** Release context
-  */      
-  stspare_fid_cache_release(fidCtx);   
   return 0;     
 }
 /*
@@ -409,14 +477,13 @@ release:
 **
 ** @param fidCtx       The FID cache context of the spare file
 **
-** @retval 0 when FID context is completly processed
+** @retval 0 when FID context is completly processed and is to be released
 **         1 else
 **____________________________________________________
 */
 int stspare_restore_projections(stspare_fid_cache_t * fidCtx, uint64_t sidBitMap, char * fidString) {
   int                            idx;
   char                           cmd[512];
-  int                            ret;
   int                            result;
   uint8_t                        fwd;
 
@@ -453,8 +520,7 @@ int stspare_restore_projections(stspare_fid_cache_t * fidCtx, uint64_t sidBitMap
                common_config.spare_restore_read_throughput,
 	       fidCtx->data.key.cid, fidCtx->data.dist[idx-1],  fidString,
 	       fidCtx->data.key.chunk, fidCtx->data.prj[idx].start, fidCtx->data.prj[idx].stop);
-      ret    = system(cmd);
-      result = WEXITSTATUS(ret);
+      result = stspare_run_rebuild(fidCtx->data.key.cid, fidCtx->data.dist[idx-1], cmd);
       if (result == 0) {
         /* This projection is done so clear the bit */
 	fidCtx->data.prj_bitmap &= ~(1 << idx);
@@ -464,9 +530,9 @@ int stspare_restore_projections(stspare_fid_cache_t * fidCtx, uint64_t sidBitMap
       /*
       ** Update statistics
       */      
-      stspare_stat.rebuild_nominal_attempt++;
+      __atomic_fetch_add(&stspare_stat.rebuild_nominal_attempt,1,__ATOMIC_SEQ_CST);
       if (result==0) {
-        stspare_stat.rebuild_nominal_success++;
+        __atomic_fetch_add(&stspare_stat.rebuild_nominal_success,1,__ATOMIC_SEQ_CST);
       }     		 
       sleep(1);
     } 
@@ -504,23 +570,21 @@ int stspare_restore_projections(stspare_fid_cache_t * fidCtx, uint64_t sidBitMap
            common_config.spare_restore_read_throughput,
 	   fidCtx->data.key.cid, fidCtx->data.key.sid,  fidString,
 	   fidCtx->data.key.chunk, 0, -1);
-  ret    = system(cmd);
-  result = WEXITSTATUS(ret);
+  result = stspare_run_rebuild(fidCtx->data.key.cid, fidCtx->data.key.sid, cmd);
 
 
   /*
   ** Update statistics
   */      
-  stspare_stat.rebuild_spare_attempt++;
+  __atomic_fetch_add(&stspare_stat.rebuild_spare_attempt,1,__ATOMIC_SEQ_CST);
   if (result==0) {
-    stspare_stat.rebuild_spare_success++;
+    __atomic_fetch_add(&stspare_stat.rebuild_spare_success,1,__ATOMIC_SEQ_CST);
   }     
   sleep(1);
 
   /*
-  ** Release context
+  ** The context is to be released
   */      
-  stspare_fid_cache_release(fidCtx);   
   return 0;     
 }
 /*
@@ -529,26 +593,14 @@ int stspare_restore_projections(stspare_fid_cache_t * fidCtx, uint64_t sidBitMap
 ** One spare file restoring
 **
 ** @param fidCtx       The FID cache context of the spare file
+** @param sidBitMap    The bitmap of the available sid in the cluster
 **
-** @retval 0 when FID context is completly processed
+** @retval 0 when FID context is completly processed and is to be released
 **         1 else
 **____________________________________________________
 */
-int stspare_restore_one_file(stspare_fid_cache_t * fidCtx) {
+int stspare_restore_one_file(stspare_fid_cache_t * fidCtx, uint64_t sidBitMap) {
   char                           fidString[64];
-  uint64_t                       sidBitMap;
-   
-  /*
-  ** mtime is null which means that the spare file has to be read 
-  ** and so is not ready to be processed
-  */
-  if (fidCtx->data.mtime == 0) return 1;  
-
-  /*
-  ** Get cluster bitmap that gives the list of available sid 
-  ** in that cluster
-  */
-  sidBitMap = stspare_get_sid_bitmap(fidCtx->data.key.cid);
 
   rozofs_uuid_unparse(fidCtx->data.key.fid, fidString);
 #if 0  
@@ -913,6 +965,47 @@ release:
 /*
 **____________________________________________________
 **
+** Order the restore jobs, the most recently written spare file first.
+** The FID cache of the storio lives in the storio processes, so the
+** modification time of the spare file tells which files are hot.
+**____________________________________________________
+*/
+static int stspare_restore_job_compare(const void * a, const void * b) {
+  const stspare_restore_job_t * ja = a;
+  const stspare_restore_job_t * jb = b;
+
+  if (ja->fidCtx->data.mtime > jb->fidCtx->data.mtime) return -1;
+  if (ja->fidCtx->data.mtime < jb->fidCtx->data.mtime) return 1;
+  return 0;
+}
+/*
+**____________________________________________________
+**
+** Restore thread. Process the restore jobs until none is left
+**
+**____________________________________________________
+*/
+static void * stspare_restore_thread(void * arg) {
+  stspare_restore_job_t * job;
+  int                     idx;
+
+  while (1) {
+
+    pthread_mutex_lock(&stspare_restore_lock);
+    idx = stspare_restore_next_job++;
+    pthread_mutex_unlock(&stspare_restore_lock);
+
+    if (idx >= stspare_restore_nb_jobs) break;
+
+    job = &stspare_restore_jobs[idx];
+    job->result = stspare_restore_one_file(job->fidCtx, job->sidBitMap);
+    __atomic_fetch_add(&stspare_stat.run_files_processed,1,__ATOMIC_SEQ_CST);
+  }
+  return NULL;
+}
+/*
+**____________________________________________________
+**
 ** Try to restore the spare files pending in the list
 **
 **____________________________________________________
@@ -920,15 +1013,80 @@ release:
 void stspare_restore_pending_files() {
   stspare_fid_cache_t * fidCtx;
   ruc_obj_desc_t               * pnext;
+  uint64_t                       count;
+  int                            nb_threads;
+  pthread_t                      threads[64];
+  int                            idx;
+  
+  count = stspare_fid_cache_stat.allocation-stspare_fid_cache_stat.release;
+  if (count == 0) return;
+  
+  stspare_restore_jobs = xmalloc(count * sizeof(stspare_restore_job_t));
+  stspare_restore_nb_jobs  = 0;
+  stspare_restore_next_job = 0;
    
   /*
-  ** Loop on FID context
+  ** Loop on FID context to build the jobs. The cluster bitmaps are
+  ** requested here since the restore threads can not share the
+  ** export connection.
   */
   pnext = NULL; 
 
   while ((fidCtx = (stspare_fid_cache_t*) ruc_objGetNext(&stspare_fid_cache_running_list, &pnext)) != NULL)  {
-    stspare_restore_one_file(fidCtx);
+    /*
+    ** mtime is null which means that the spare file has to be read 
+    ** and so is not ready to be processed
+    */
+    if (fidCtx->data.mtime == 0) continue;  
+    if (stspare_restore_nb_jobs >= count) break;
+
+    stspare_restore_jobs[stspare_restore_nb_jobs].fidCtx    = fidCtx;
+    stspare_restore_jobs[stspare_restore_nb_jobs].sidBitMap = stspare_get_sid_bitmap(fidCtx->data.key.cid);
+    stspare_restore_jobs[stspare_restore_nb_jobs].result    = 1;
+    stspare_restore_nb_jobs++;
   }       
+  
+  qsort(stspare_restore_jobs, stspare_restore_nb_jobs, sizeof(stspare_restore_job_t), stspare_restore_job_compare);
+  stspare_stat.run_files_to_restore += stspare_restore_nb_jobs;
+
+  /*
+  ** Start the restore threads
+  */
+  nb_threads = common_config.spare_restore_parallel;
+  if (nb_threads > 64) nb_threads = 64;
+  if (nb_threads > stspare_restore_nb_jobs) nb_threads = stspare_restore_nb_jobs;
+  
+  for (idx=0; idx < nb_threads; idx++) {
+    if ((errno = pthread_create(&threads[idx], NULL, stspare_restore_thread, NULL)) != 0) {
+      severe("pthread_create() %s",strerror(errno));
+      break;
+    }
+  }
+  nb_threads = idx;
+  
+  /*
+  ** No thread could be started. Restore from this thread
+  */
+  if (nb_threads == 0) {
+    stspare_restore_thread(NULL);
+  }
+  
+  for (idx=0; idx < nb_threads; idx++) {
+    pthread_join(threads[idx], NULL);
+  }
+  
+  /*
+  ** Release the contexts that are completly processed
+  */
+  for (idx=0; idx < stspare_restore_nb_jobs; idx++) {
+    if (stspare_restore_jobs[idx].result == 0) {
+      stspare_fid_cache_release(stspare_restore_jobs[idx].fidCtx);
+    }
+  }
+  
+  xfree(stspare_restore_jobs);
+  stspare_restore_jobs    = NULL;
+  stspare_restore_nb_jobs = 0;
 }
 /*
 **____________________________________________________
@@ -949,7 +1107,6 @@ void stspare_scan_all_spare_files() {
   fid_t           fid;
   int             chunk;
   time_t          now;
-  stspare_fid_cache_t * fidCtx;
    
   st = storaged_storages;
 
@@ -1003,17 +1160,15 @@ void stspare_scan_all_spare_files() {
 	  ** Let's scan this file if not yet done
 	  */
           sprintf(pathname,"%s/%d/bins_1/%d/%s",st->root, dev, slice,pep->d_name);
-	  fidCtx = stspare_scan_one_spare_file(st,fid,chunk,pathname,now);
-	  if (fidCtx != NULL) {
-	    /*
-	    ** Try to restore the file
-	    */
-	    stspare_restore_one_file(fidCtx);
-	  } 
+	  stspare_scan_one_spare_file(st,fid,chunk,pathname,now);
 	  
 	  /*
-	  ** When no more free context, stop scanning for the files
+	  ** When no more free context, restore the scanned files and 
+	  ** stop scanning when no context could be released
 	  */
+	  if (stspare_fid_cache_distributor_empty()) {
+	    stspare_restore_pending_files();
+	  }  
 	  if (stspare_fid_cache_distributor_empty()) {
 	    closedir(sliceDir);
 	    return;
@@ -1095,6 +1250,9 @@ void *stspare_thread(void *arg) {
     */
     stspare_stat.number_of_run_done++;
     stspare_stat.seconds_before_next_run = 0;
+    stspare_stat.run_start               = time(NULL);
+    stspare_stat.run_files_to_restore    = 0;
+    stspare_stat.run_files_processed     = 0;
     
     /*
     ** Loop on disk to find out the new spare files and
@@ -145,6 +145,7 @@ typedef enum
 
 
 #define ROZOFS_STORCLI_MAX_RETRY   3  /**< max attempts for read or write a projection on a storage */
+#define ROZOFS_STORCLI_MAX_REWRITE 3  /**< max rounds of rewrite of the missing projections of an acknowledged write */
 /**
 * structure used to handle projection construction
 */
@@ -254,8 +255,11 @@ typedef struct _rozofs_storcli_ctx_t
   uint64_t                          wr_bid;           /**< index of the first block to write              */
   uint32_t                          wr_nb_blocks;     /**< number of blocks to write                      */
   dist_t                            wr_distribution;  /**< distribution for the write                     */
+  uint8_t                           wr_rewrite_cpt;   /**< rewrite rounds of the missing projections after the acknowledgment */
+  uint8_t                           wr_rewrite_armed; /**< a rewrite round waits for the guard timer      */
 //  uint32_t                          last_block_size;  /**< effective size of the last block: written in the header of the last projection     */
   ruc_obj_desc_t                      timer_list;    /**< timer linked list used as a guard timer upon received first projection */
+  uint64_t                          hedge_date_us;    /**< date at which a spare projection is read when some are still missing */
   uint8_t      rozofs_storcli_prj_idx_table[ROZOFS_SAFE_MAX_STORCLI*ROZOFS_MAX_BLOCK_PER_MSG];  /**< table of the projection used by the inverse process */
 
   /*
@@ -600,6 +604,40 @@ static inline void storcli_lbg_cnx_sup_clear_tmo(int lbg_id)
   
 int storcli_lbg_cnx_sup_is_selectable(int lbg_id);
 
+/*
+** Response time of the projection reads per load balancing group.
+** It is used to select the storages to read, and the distribution of
+** the response times gives the delay after which a spare projection
+** is read in parallel of a late one (hedged read).
+*/
+#define STORCLI_LAT_HISTO_SZ  24   /**< log2 buckets of the response time in us */
+
+typedef struct _storcli_lbg_latency_t
+{
+  uint32_t   ewma_us;     /**< smoothed response time in us */
+  uint32_t   pending;     /**< projection reads in progress */
+  uint64_t   count;       /**< number of response time samples */
+} storcli_lbg_latency_t;
+
+extern storcli_lbg_latency_t storcli_lbg_latency_tab[];
+
+/**
+*  Selection score of a load balancing group for a read: the lower the better.
+   A storage without any sample yet is preferred to be able to evaluate it.
+  
+  @param lbg_id : index of the load balancing group
+  
+  @retval the score
+ */
+static inline uint64_t storcli_lbg_latency_score(int lbg_id)
+{
+  storcli_lbg_latency_t *p;
+  if ((lbg_id < 0) || (lbg_id >=STORCLI_MAX_LBG)) return (uint64_t)-1;
+  
+  p = &storcli_lbg_latency_tab[lbg_id];
+  return (uint64_t)p->ewma_us * (p->pending+1);
+}
+
 
 /*
 **_________________________________________________________________________________
@@ -861,6 +899,33 @@ void rozofs_storcli_stop_read_guard_timer(rozofs_storcli_ctx_t  *p);
 */
 void rozofs_storcli_start_read_guard_timer(rozofs_storcli_ctx_t  *p);
 /*
+**____________________________________________________
+*/
+/**
+* Account for a projection read request sent to a load balancing group
+
+  @param lbg_id: index of the load balancing group
+  
+ @retval none
+*/
+static inline void rozofs_storcli_lbg_read_sent(int lbg_id)
+{
+  if ((lbg_id < 0) || (lbg_id >=STORCLI_MAX_LBG)) return;
+  storcli_lbg_latency_tab[lbg_id].pending++;
+}
+/*
+**____________________________________________________
+*/
+/**
+* Account for the end of a projection read request of a load balancing group
+
+  @param lbg_id: index of the load balancing group
+  @param start_us: date the request has been sent at in us (0 when no sample is to be taken)
+  
+ @retval none
+*/
+void rozofs_storcli_lbg_read_done(int lbg_id, uint64_t start_us);
+/*
 **__________________________________________________________________________
 */
 /**
@@ -1623,6 +1688,34 @@ typedef struct _storcli_corrupted_fid_ctx {
 } storcli_corrupted_fid_ctx;
 extern storcli_corrupted_fid_ctx storcli_fid_corrupted;
 
+/*
+**____________________________________________________
+** Writes acknowledged to rozofsmount before every projection was written
+** (wr_ack_early or wr_ack_on_inverse) and that could not be completed
+** in the background after ROZOFS_STORCLI_MAX_REWRITE rewrite rounds. The 
+** blocks stay readable from the written projections, but miss some 
+** projections until the storages of these projections are rebuilt.
+**
+*/
+typedef struct _storcli_one_incomplete_wr_ctx {
+  fid_t            fid;
+  uint64_t         off;      /**< offset of the write in the file */
+  uint32_t         len;      /**< length of the write */
+  uint8_t          missing;  /**< number of projections not written */
+  time_t           ts;       /**< time stamp in second */
+} storcli_one_incomplete_wr_ctx;
+
+#define      STORCLI_MAX_INCOMPLETE_WR_NB   16
+
+typedef struct _storcli_incomplete_wr_ctx {
+  uint64_t                      early_ack;    /**< writes acknowledged before completion */
+  uint64_t                      completed;    /**< early acknowledged writes completed afterwards */
+  uint64_t                      incomplete;   /**< early acknowledged writes left incomplete */
+  int                           nextIdx;
+  storcli_one_incomplete_wr_ctx ctx[STORCLI_MAX_INCOMPLETE_WR_NB];
+} storcli_incomplete_wr_ctx;
+extern storcli_incomplete_wr_ctx storcli_wr_incomplete;
+
 
 /*
 **____________________________________________________
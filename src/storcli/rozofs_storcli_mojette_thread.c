@@ -136,6 +136,7 @@ static inline void storcli_mojette_inverse(rozofs_mojette_thread_ctx_t *thread_c
   rozofs_storcli_ctx_t      * working_ctx_p;
   unsigned long long cycleBefore, cycleAfter;
   storcli_read_arg_t *storcli_read_rq_p;
+  int passes;
     
   gettimeofday(&timeDay,(struct timezone *)0);  
   timeBefore = MICROLONG(timeDay);
@@ -151,7 +152,7 @@ static inline void storcli_mojette_inverse(rozofs_mojette_thread_ctx_t *thread_c
   storcli_read_rq_p = (storcli_read_arg_t*)&working_ctx_p->storcli_read_arg;
   uint8_t layout         = storcli_read_rq_p->layout;
   
-  rozofs_storcli_transform_inverse(working_ctx_p->prj_ctx,
+  passes = rozofs_storcli_transform_inverse(working_ctx_p->prj_ctx,
                                    layout, storcli_read_rq_p->bsize,
                                    working_ctx_p->cur_nmbs2read,
                                    working_ctx_p->nb_projections2read,
@@ -166,9 +167,18 @@ static inline void storcli_mojette_inverse(rozofs_mojette_thread_ctx_t *thread_c
   cycleAfter = rdtsc();
   gettimeofday(&timeDay,(struct timezone *)0);  
   timeAfter = MICROLONG(timeDay);
-  thread_ctx_p->stat.MojetteInverse_Byte_count += (working_ctx_p->effective_number_of_blocks*ROZOFS_BSIZE_BYTES(storcli_read_rq_p->bsize));
   thread_ctx_p->stat.MojetteInverse_cycle +=(cycleAfter-cycleBefore);  
   thread_ctx_p->stat.MojetteInverse_time +=(timeAfter-timeBefore);  
+  if (passes < 0) {
+    /*
+    ** The blocks could not be decoded
+    */
+    storio_send_response(thread_ctx_p,msg,-1);
+    return;
+  }
+  thread_ctx_p->stat.MojetteInverse_Byte_count += (working_ctx_p->effective_number_of_blocks*ROZOFS_BSIZE_BYTES(storcli_read_rq_p->bsize));
+  thread_ctx_p->stat.MojetteInverse_block_count += working_ctx_p->effective_number_of_blocks;
+  thread_ctx_p->stat.MojetteInverse_pass_count += passes;
   /*
   ** send the response
   */
@@ -299,19 +309,27 @@ void *rozofs_stcmoj_thread(void *arg) {
      
     }
   while(1) {
-    /*
-    ** read the north disk socket
-    */
-    bytesRcvd = recvfrom(af_unix_disk_socket_ref,
-			 &msg,sizeof(msg), 
-			 0,(struct sockaddr *)NULL,NULL);
-    if (bytesRcvd == -1) {
-      fatal("Disk Thread %d recvfrom %s !!\n",ctx_p->thread_idx,strerror(errno));
-      exit(0);
+    if (storcli_mojette_channel != NULL) {
+      /*
+      ** read the request ring of the thread
+      */
+      rozofs_thread_channel_receive(storcli_mojette_channel, ctx_p->thread_idx, &msg);
     }
-    if (bytesRcvd == 0) {
-      fatal("Disk Thread %d socket is dead %s !!\n",ctx_p->thread_idx,strerror(errno));
-      exit(0);    
+    else {
+      /*
+      ** read the north disk socket
+      */
+      bytesRcvd = recvfrom(af_unix_disk_socket_ref,
+			   &msg,sizeof(msg), 
+			   0,(struct sockaddr *)NULL,NULL);
+      if (bytesRcvd == -1) {
+	fatal("Disk Thread %d recvfrom %s !!\n",ctx_p->thread_idx,strerror(errno));
+	exit(0);
+      }
+      if (bytesRcvd == 0) {
+	fatal("Disk Thread %d socket is dead %s !!\n",ctx_p->thread_idx,strerror(errno));
+	exit(0);    
+      }
     }
 
     switch (msg.opcode) {
@@ -354,12 +372,15 @@ int rozofs_stcmoj_thread_create(char * hostname,int eid,int storcli_idx, int nb_
    memset(rozofs_mojette_thread_ctx_tb,0,sizeof(rozofs_mojette_thread_ctx_tb));
    /*
    ** create the common socket to receive requests on
+   ** unless the requests are given through rings
    */
-   sprintf(socketName,"%s_%s_%d_%d",ROZOFS_SOCK_FAMILY_STORCLI_MOJETTE_NORTH_SUNPATH,storcli_get_owner(),eid,storcli_idx);
-   af_unix_disk_socket_ref = af_unix_mojette_sock_create_internal(socketName,1024*32);
-   if (af_unix_disk_socket_ref < 0) {
-      fatal("af_unix_disk_thread_create af_unix_mojette_sock_create_internal(%s) %s",socketName,strerror(errno));
-      return -1;   
+   if (storcli_mojette_channel == NULL) {
+     sprintf(socketName,"%s_%s_%d_%d",ROZOFS_SOCK_FAMILY_STORCLI_MOJETTE_NORTH_SUNPATH,storcli_get_owner(),eid,storcli_idx);
+     af_unix_disk_socket_ref = af_unix_mojette_sock_create_internal(socketName,1024*32);
+     if (af_unix_disk_socket_ref < 0) {
+	fatal("af_unix_disk_thread_create af_unix_mojette_sock_create_internal(%s) %s",socketName,strerror(errno));
+	return -1;   
+     }
    }
    /*
    ** Now create the threads
@@ -374,12 +395,15 @@ int rozofs_stcmoj_thread_create(char * hostname,int eid,int storcli_idx, int nb_
      /*
      ** create the thread specific socket to send the response from 
      */
-     sprintf(socketName,"%s_%s_%d_%d_%d",ROZOFS_SOCK_FAMILY_STORCLI_MOJETTE_NORTH_SUNPATH,storcli_get_owner(),eid,storcli_idx,i);
-     thread_ctx_p->sendSocket = af_unix_mojette_sock_create_internal(socketName,1024*32);
-     if (thread_ctx_p->sendSocket < 0) {
-	fatal("af_unix_disk_thread_create af_unix_mojette_sock_create_internal(%s) %s",socketName, strerror(errno));
-	return -1;   
-     }   
+     thread_ctx_p->sendSocket = -1;
+     if (storcli_mojette_channel == NULL) {
+       sprintf(socketName,"%s_%s_%d_%d_%d",ROZOFS_SOCK_FAMILY_STORCLI_MOJETTE_NORTH_SUNPATH,storcli_get_owner(),eid,storcli_idx,i);
+       thread_ctx_p->sendSocket = af_unix_mojette_sock_create_internal(socketName,1024*32);
+       if (thread_ctx_p->sendSocket < 0) {
+	  fatal("af_unix_disk_thread_create af_unix_mojette_sock_create_internal(%s) %s",socketName, strerror(errno));
+	  return -1;   
+       }   
+     }
    
      err = pthread_attr_init(&attr);
      if (err != 0) {
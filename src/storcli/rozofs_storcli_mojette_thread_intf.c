@@ -29,6 +29,7 @@
 #include <rozofs/core/ruc_buffer_debug.h>
 #include <rozofs/core/com_cache.h>
 #include <rozofs/rozofs_srv.h>
+#include <rozofs/common/common_config.h>
 
 #include "rozofs_storcli_mojette_thread_intf.h"
 #include "config.h"
@@ -44,6 +45,7 @@ int        af_unix_mojette_thread_count=0;
 int        af_unix_mojette_pending_req_count = 0;
 int        af_unix_mojette_pending_req_max_count = 0;
 int        af_unix_mojette_empty_recv_count = 0;
+rozofs_thread_channel_t * storcli_mojette_channel = NULL;
 
 struct  sockaddr_un storio_south_socket_name;
 struct  sockaddr_un storio_north_socket_name;
@@ -223,8 +225,11 @@ void mojette_thread_debug(char * argv[], uint32_t tcpRef, void *bufRef) {
   display_line_topic("Read Requests");  
   display_line_val_and_sum("   number", MojetteInverse_count);
   display_line_val_and_sum("   Bytes",MojetteInverse_Byte_count);      
+  display_line_val_and_sum("   Blocks",MojetteInverse_block_count);      
+  display_line_val_and_sum("   Passes",MojetteInverse_pass_count);      
   display_line_val_and_sum("   Cumulative Time (us)",MojetteInverse_time);
   display_line_div_and_sum("   Average Bytes",MojetteInverse_Byte_count,MojetteInverse_count);  
+  display_line_div_and_sum("   Average blocks/pass",MojetteInverse_block_count,MojetteInverse_pass_count);  
   display_line_div_and_sum("   Average Time (us)",MojetteInverse_time,MojetteInverse_count);
   display_line_div_and_sum("   Average Cycle",MojetteInverse_cycle,MojetteInverse_count);
   display_line_div_and_sum("   Throughput (MBytes/s)",MojetteInverse_Byte_count,MojetteInverse_time);  
@@ -241,6 +246,10 @@ void mojette_thread_debug(char * argv[], uint32_t tcpRef, void *bufRef) {
   display_line_topic("");  
   pChar += sprintf(pChar,"\n");
   
+  if (storcli_mojette_channel != NULL) {
+    pChar = rozofs_thread_channel_display(storcli_mojette_channel, pChar);
+  }
+  
   if (doreset) {
     for (i=0; i<af_unix_mojette_thread_count; i++) {
       memset(&p[i].stat,0,sizeof(p[i].stat));
@@ -459,6 +468,16 @@ void af_unix_mojette_thread_response(rozofs_stcmoj_thread_msg_t *msg)
        break;     
 
     case STORCLI_MOJETTE_THREAD_INV:
+       if (msg->status < 0) {
+         /*
+         ** The Mojette thread could not decode the blocks
+         */
+         storcli_trace_error(__LINE__,EIO,working_ctx_p);
+         rozofs_storcli_read_reply_error(working_ctx_p,EIO);
+         STORCLI_STOP_NORTH_PROF(working_ctx_p,read,0);
+         rozofs_storcli_release_context(working_ctx_p);
+         break;
+       }
        rozofs_storcli_inverse_threaded_end(working_ctx_p);
        break;
 
@@ -606,13 +625,18 @@ void storio_send_response (rozofs_mojette_thread_ctx_t *thread_ctx_p, rozofs_stc
   
   msg->status = status;
   
-  /*
-  ** send back the response
-  */  
-  ret = sendto(thread_ctx_p->sendSocket,msg, sizeof(*msg),0,(struct sockaddr*)&storio_south_socket_name,sizeof(storio_south_socket_name));
-  if (ret <= 0) {
-     fatal("storio_send_response %d sendto(%s) %s", thread_ctx_p->thread_idx, storio_south_socket_name.sun_path, strerror(errno));
-     exit(0);  
+  if (storcli_mojette_channel != NULL) {
+    rozofs_thread_channel_reply(storcli_mojette_channel, thread_ctx_p->thread_idx, msg);
+  }
+  else {
+    /*
+    ** send back the response
+    */  
+    ret = sendto(thread_ctx_p->sendSocket,msg, sizeof(*msg),0,(struct sockaddr*)&storio_south_socket_name,sizeof(storio_south_socket_name));
+    if (ret <= 0) {
+       fatal("storio_send_response %d sendto(%s) %s", thread_ctx_p->thread_idx, storio_south_socket_name.sun_path, strerror(errno));
+       exit(0);  
+    }
   }
   sched_yield();
 }
@@ -645,11 +669,22 @@ int rozofs_stcmoj_thread_intf_send(rozofs_stcmoj_thread_request_e   opcode,
   msg.working_ctx     = working_ctx;
   
   /* Send the buffer to its destination */
-  ret = sendto(af_unix_mojette_south_socket_ref,&msg, sizeof(msg),0,(struct sockaddr*)&storio_north_socket_name,sizeof(storio_north_socket_name));
-  if (ret <= 0) {
-     fatal("rozofs_stcmoj_thread_intf_send count %d sendto(%s) %s", af_unix_mojette_pending_req_count,
-                                                                    storio_north_socket_name.sun_path, strerror(errno));
-     exit(0);  
+  if (storcli_mojette_channel != NULL) {
+    if (rozofs_thread_channel_send(storcli_mojette_channel, &msg, 1) < 0) {
+      /*
+      ** No room in the Mojette thread rings: the caller runs the
+      ** transform itself
+      */
+      return -1;
+    }
+  }
+  else {
+    ret = sendto(af_unix_mojette_south_socket_ref,&msg, sizeof(msg),0,(struct sockaddr*)&storio_north_socket_name,sizeof(storio_north_socket_name));
+    if (ret <= 0) {
+       fatal("rozofs_stcmoj_thread_intf_send count %d sendto(%s) %s", af_unix_mojette_pending_req_count,
+                                                                      storio_north_socket_name.sun_path, strerror(errno));
+       exit(0);  
+    }
   }
   
   af_unix_mojette_pending_req_count++;
@@ -736,8 +771,28 @@ int af_unix_mojette_thread_response_socket_create(char *socketname)
 */
 void af_unix_mojette_scheduler_entry_point(uint64_t current_time)
 {
+  if (storcli_mojette_channel != NULL) {
+    rozofs_thread_channel_poll(storcli_mojette_channel);
+    return;
+  }
   af_unix_disk_rcvMsgsock(NULL,af_unix_mojette_south_socket_ref);
 }
+/*__________________________________________________________________________
+*/
+/**
+*   Processing of a Mojette response read from the Mojette thread rings
+*
+   @param msg : the Mojette thread response
+*/
+static void storcli_mojette_channel_response(void * msg)
+{
+  af_unix_mojette_pending_req_count--;
+  if (af_unix_mojette_pending_req_count < 0) {
+    severe("af_unix_mojette_pending_req_count is negative");
+    af_unix_mojette_pending_req_count = 0;
+  }
+  af_unix_mojette_thread_response((rozofs_stcmoj_thread_msg_t *) msg);
+}
 
 /*__________________________________________________________________________
 * Initialize the disk thread interface
@@ -773,11 +828,26 @@ int rozofs_stcmoj_thread_intf_create(char * hostname,int eid,int storcli_idx, in
   */ 
 //  sprintf(destination_socketName,"%s_%s", ROZOFS_SOCK_FAMILY_STORCLI_MOJETTE_NORTH_SUNPATH, hostname);
   
-  sprintf(socketName,"%s_%s_%d_%d", ROZOFS_SOCK_FAMILY_STORCLI_MOJETTE_SOUTH_SUNPATH,storcli_get_owner(), eid,storcli_idx);
-  af_unix_mojette_south_socket_ref = af_unix_mojette_thread_response_socket_create(socketName);
-  if (af_unix_mojette_south_socket_ref < 0) {
-    fatal("storio_create_disk_thread_intf af_unix_sock_create(%s) %s",socketName, strerror(errno));
-    return -1;
+  /*
+  ** Exchange with the Mojette threads through rings when configured.
+  ** There can not be more pending requests than sending buffers.
+  */
+  if (common_config.thread_ring) {
+    storcli_mojette_channel = rozofs_thread_channel_create("mojette_ring", nb_threads, 
+                                                           sizeof(rozofs_stcmoj_thread_msg_t),
+                                                           nb_buffer, storcli_mojette_channel_response);
+    if (storcli_mojette_channel == NULL) {
+      warning("Mojette thread rings can not be created. Using AF_UNIX sockets.");
+    }
+  }
+  
+  if (storcli_mojette_channel == NULL) {
+    sprintf(socketName,"%s_%s_%d_%d", ROZOFS_SOCK_FAMILY_STORCLI_MOJETTE_SOUTH_SUNPATH,storcli_get_owner(), eid,storcli_idx);
+    af_unix_mojette_south_socket_ref = af_unix_mojette_thread_response_socket_create(socketName);
+    if (af_unix_mojette_south_socket_ref < 0) {
+      fatal("storio_create_disk_thread_intf af_unix_sock_create(%s) %s",socketName, strerror(errno));
+      return -1;
+    }
   }
   /*
   ** init of the AF_UNIX sockaddr associated with the south socket (socket used for disk response receive)
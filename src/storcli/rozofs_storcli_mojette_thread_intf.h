@@ -29,6 +29,7 @@
 #include <rozofs/core/af_unix_socket_generic.h>
 #include <rozofs/core/af_unix_socket_generic.h>
 #include <rozofs/core/rozofs_socket_family.h>
+#include <rozofs/core/rozofs_ring.h>
 #include "rozofs_storcli.h"
 
 
@@ -44,6 +45,8 @@ typedef struct _rozofs_disk_thread_stat_t {
   uint64_t            diskRead_badCidSid;
   uint64_t            MojetteInverse_time;
   uint64_t            MojetteInverse_cycle;
+  uint64_t            MojetteInverse_block_count;
+  uint64_t            MojetteInverse_pass_count;
   
   uint64_t            MojetteForward_count;
   uint64_t            MojetteForward_Byte_count;
@@ -68,6 +71,10 @@ typedef struct _rozofs_mojette_thread_ctx_t
 } rozofs_mojette_thread_ctx_t;
 
 extern rozofs_mojette_thread_ctx_t rozofs_mojette_thread_ctx_tb[];
+/*
+** Rings between the main thread and the Mojette threads (NULL when AF_UNIX sockets are used)
+*/
+extern rozofs_thread_channel_t * storcli_mojette_channel;
 extern int rozofs_stcmoj_thread_write_enable;
 extern int rozofs_stcmoj_thread_read_enable;
 extern uint32_t rozofs_stcmoj_thread_len_threshold;
@@ -85,7 +92,7 @@ typedef struct _rozofs_stcmoj_thread_msg_t
 {
   uint32_t            msg_len;
   uint32_t            opcode;
-  uint32_t            status;
+  int32_t             status;
   uint32_t            transaction_id;
   uint64_t            timeStart;
   uint64_t            size;
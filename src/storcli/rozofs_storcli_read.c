@@ -50,6 +50,8 @@
 #include "storcli_main.h"
 #include <rozofs/rozofs_timer_conf.h>
 #include "rozofs_storcli_mojette_thread_intf.h"
+#include <rozofs/core/uma_dbg_api.h>
+#include <rozofs/common/common_config.h>
 
 DECLARE_PROFILING(stcpp_profiler_t);
 
@@ -487,6 +489,42 @@ failure:
 /*
 **__________________________________________________________________________
 */
+/**
+*  Order a range of the storages of a distribution by increasing score
+   (response time and pending reads). Storages with the same score keep
+   their relative order so that the rotation still shares the load.
+
+  @param cid: cluster of the distribution
+  @param dist_set: the storages of the distribution
+  @param first: index of the first storage of the range
+  @param last: index following the last storage of the range
+  
+  @retval none
+*/
+static void rozofs_storcli_sort_by_latency(uint8_t cid, uint8_t *dist_set, int first, int last)
+{
+  uint64_t score[ROZOFS_SAFE_MAX_STORCLI];
+  uint64_t cur_score;
+  uint8_t  cur_sid;
+  int      i,k;
+
+  for (i = first; i < last; i++) {
+    score[i] = storcli_lbg_latency_score(rozofs_storcli_get_lbg_for_sid(cid,dist_set[i]));
+  }
+  for (i = first+1; i < last; i++) {
+    cur_score = score[i];
+    cur_sid   = dist_set[i];
+    for (k = i; (k > first) && (score[k-1] > cur_score); k--) {
+      score[k]    = score[k-1];
+      dist_set[k] = dist_set[k-1];
+    }
+    score[k]    = cur_score;
+    dist_set[k] = cur_sid;
+  }
+}
+/*
+**__________________________________________________________________________
+*/
 
 void rozofs_storcli_read_req_processing(rozofs_storcli_ctx_t *working_ctx_p)
 {
@@ -509,6 +547,8 @@ void rozofs_storcli_read_req_processing(rozofs_storcli_ctx_t *working_ctx_p)
   uint8_t rotate_modulo;
   uint8_t local_storage_idx;
   int     j;
+  int     sort_first = 0;
+  int     sort_split = 0;
 
      
   storcli_read_rq_p = (storcli_read_arg_t*)&working_ctx_p->storcli_read_arg;
@@ -567,6 +607,7 @@ void rozofs_storcli_read_req_processing(rozofs_storcli_ctx_t *working_ctx_p)
 	    used_dist_set[rozofs_forward-1-i+j] = storcli_read_rq_p->dist_set[i];
 	  }
     }
+    sort_split = j;
   }
   /*
   ** Local preference is configured
@@ -596,6 +637,7 @@ void rozofs_storcli_read_req_processing(rozofs_storcli_ctx_t *working_ctx_p)
 		  rotate_modulo = (rotate+i) % (rozofs_forward-1);
 		  used_dist_set[rotate_modulo+1] = storcli_read_rq_p->dist_set[(local_storage_idx+i) % rozofs_forward]; 
 		} 
+		sort_first = 1;
 		break;       
       }
       /*
@@ -617,6 +659,20 @@ void rozofs_storcli_read_req_processing(rozofs_storcli_ctx_t *working_ctx_p)
     used_dist_set[i] = storcli_read_rq_p->dist_set[i];     
   } 
 #endif  
+  /*
+  ** Order the forward storages by response time and pending reads,
+  ** keeping the local ones first
+  */
+  if (common_config.storcli_latency_select) {
+    if (sort_split != 0) {
+      rozofs_storcli_sort_by_latency(storcli_read_rq_p->cid,used_dist_set,0,sort_split);
+      rozofs_storcli_sort_by_latency(storcli_read_rq_p->cid,used_dist_set,sort_split,rozofs_forward);
+    }
+    else {
+      rozofs_storcli_sort_by_latency(storcli_read_rq_p->cid,used_dist_set,sort_first,rozofs_forward);
+    }  
+  }
+
   /*
   ** init of the load balancing group/ projection association table with the state of each lbg
   ** search in the current distribution the relative reference of the storage
@@ -760,6 +816,7 @@ retry:
      working_ctx_p->read_ctx_lock++;
      prj_cxt_p[projection_id].prj_state = ROZOFS_PRJ_READ_IN_PRG;
      ruc_buf_inuse_increment(xmit_buf);
+     rozofs_storcli_lbg_read_sent(lbg_id);
      
      ret =  rozofs_sorcli_send_rq_common(lbg_id,ROZOFS_TMR_GET(TMR_STORAGE_PROGRAM),STORAGE_PROGRAM,STORAGE_VERSION,SP_READ,
                                          (xdrproc_t) xdr_sp_read_arg_t, (caddr_t) request,
@@ -774,6 +831,14 @@ retry:
 
      if (ret < 0)
      {
+       /*
+       ** the read is over for the lbg, unless the transaction callback has 
+       ** already been called on a direct transmission failure
+       */
+       if (prj_cxt_p[projection_id].prj_state == ROZOFS_PRJ_READ_IN_PRG)
+       {
+         rozofs_storcli_lbg_read_done(lbg_id,0);
+       }
        /*
        ** the communication with the storage seems to be wrong (more than TCP connection temporary down
        ** attempt to select a new storage
@@ -1019,6 +1084,7 @@ int rozofs_storcli_read_projection_retry(rozofs_storcli_ctx_t *working_ctx_p,uin
      working_ctx_p->read_ctx_lock++;
      ruc_buf_inuse_increment(xmit_buf);
      prj_cxt_p[projection_id].prj_state = ROZOFS_PRJ_READ_IN_PRG;
+     rozofs_storcli_lbg_read_sent(lbg_id);
      
      ret =  rozofs_sorcli_send_rq_common(lbg_id,ROZOFS_TMR_GET(TMR_STORAGE_PROGRAM),STORAGE_PROGRAM,STORAGE_VERSION,SP_READ,
                                          (xdrproc_t) xdr_sp_read_arg_t, (caddr_t) request,
@@ -1033,6 +1099,14 @@ int rozofs_storcli_read_projection_retry(rozofs_storcli_ctx_t *working_ctx_p,uin
      ruc_buf_inuse_decrement(xmit_buf);
     if (ret < 0)
     {
+      /*
+      ** the read is over for the lbg, unless the transaction callback has 
+      ** already been called on a direct transmission failure
+      */
+      if (prj_cxt_p[projection_id].prj_state == ROZOFS_PRJ_READ_IN_PRG)
+      {
+        rozofs_storcli_lbg_read_done(lbg_id,0);
+      }
       /*
       ** the communication with the storage seems to be wrong (more than TCP connection temporary down
       ** attempt to select a new storage
@@ -1195,6 +1269,21 @@ void rozofs_storcli_read_req_processing_cbk(void *this,void *param)
     rozofs_tx_read_opaque_data(this,0,&seqnum);
     rozofs_tx_read_opaque_data(this,1,&projection_id);
     rozofs_tx_read_opaque_data(this,2,(uint32_t*)&lbg_id);
+
+    /*
+    ** Account for the response time of the storage: a time-out is a sample
+    ** too, while an error on the connection tells nothing about the storage
+    */
+    status = rozofs_tx_get_status(this);
+    if ((seqnum == working_ctx_p->read_seqnum) 
+    &&  ((status >= 0) || (rozofs_tx_get_errno(this) == ETIME)))
+    {
+      rozofs_storcli_lbg_read_done(lbg_id,working_ctx_p->prj_ctx[projection_id].timestamp);
+    }
+    else
+    {
+      rozofs_storcli_lbg_read_done(lbg_id,0);
+    }
     
     /*
     ** check if the sequence number of the transaction matches with the one saved in the tranaaction
@@ -1612,21 +1701,21 @@ void rozofs_storcli_read_req_processing_cbk(void *this,void *param)
       if ((rozofs_stcmoj_thread_read_enable) && (blocklen >rozofs_stcmoj_thread_len_threshold)&&
           (rozofs_storcli_check_read_in_progress_projections(layout,working_ctx_p->prj_ctx) == 0)) 
       {
-	ret = rozofs_stcmoj_thread_intf_send(STORCLI_MOJETTE_THREAD_INV,working_ctx_p,0);
-	if (ret < 0) 
-	{
-           errno = EPROTO;
-           storcli_trace_error(__LINE__,errno,working_ctx_p);            
-	   goto io_error;
-	}
 	/*
-	** release the transaction context
+	** When there is no room in the Mojette thread rings, the inverse
+	** transform is done below by the main thread
 	*/
-        rozofs_tx_free_from_ptr(this);
-	return;   
+	if (rozofs_stcmoj_thread_intf_send(STORCLI_MOJETTE_THREAD_INV,working_ctx_p,0) == 0) 
+	{
+	  /*
+	  ** release the transaction context
+	  */
+          rozofs_tx_free_from_ptr(this);
+	  return;   
+	}
       }
       STORCLI_START_KPI(storcli_kpi_transform_inverse);
-      rozofs_storcli_transform_inverse(working_ctx_p->prj_ctx,
+      ret = rozofs_storcli_transform_inverse(working_ctx_p->prj_ctx,
                                        layout, bsize,
                                        working_ctx_p->cur_nmbs2read,
                                        working_ctx_p->effective_number_of_blocks,
@@ -1634,6 +1723,13 @@ void rozofs_storcli_read_req_processing_cbk(void *this,void *param)
                                        working_ctx_p->data_read_p,
                                        &working_ctx_p->effective_number_of_blocks,
 				       &working_ctx_p->rozofs_storcli_prj_idx_table[0]);
+      if (ret < 0)
+      {
+        STORCLI_STOP_KPI(storcli_kpi_transform_inverse,0);
+        error = EIO;
+        storcli_trace_error(__LINE__,error,working_ctx_p);            
+        goto io_error;
+      }
     }
     else
     {
@@ -1867,6 +1963,144 @@ typedef struct _rozofs_storcli_read_clk_t
 
 rozofs_storcli_read_clk_t  rozofs_storcli_read_clk;
 
+/*
+** Hedged reads: distribution of the projection read response times and
+** list of the read contexts waiting for the date of their spare read
+*/
+#define STORCLI_HEDGE_SAMPLES   1024   /**< number of samples between 2 computations of the hedge delay */
+#define STORCLI_LAT_AGING_TICKS   50   /**< number of 20ms ticks between 2 agings of the response times */
+
+typedef struct _rozofs_storcli_hedge_t
+{
+  ruc_obj_desc_t  list;          /**< read contexts waiting for their hedge date */
+  uint64_t        histo[STORCLI_LAT_HISTO_SZ]; /**< log2 histogram of the response times in us */
+  uint32_t        samples;       /**< samples since the last computation of the delay */
+  uint64_t        delay_us;      /**< current hedge delay (0 until computed) */
+  uint32_t        aging_ticks;
+  uint64_t        armed;         /**< number of reads waiting for a hedge date */
+  uint64_t        fired;         /**< number of hedge dates reached */
+} rozofs_storcli_hedge_t;
+
+rozofs_storcli_hedge_t rozofs_storcli_hedge;
+/*
+**____________________________________________________
+*/
+/**
+* Compute the hedge delay from the histogram of the response times, then
+  halve the histogram so that it follows the evolution of the storages
+  
+ @retval none
+*/
+static void rozofs_storcli_hedge_compute_delay()
+{
+  rozofs_storcli_hedge_t *h = &rozofs_storcli_hedge;
+  uint64_t total = 0;
+  uint64_t sum = 0;
+  int      i;
+
+  for (i = 0; i < STORCLI_LAT_HISTO_SZ; i++) total += h->histo[i];
+  if (total == 0) return;
+
+  for (i = 0; i < STORCLI_LAT_HISTO_SZ; i++) {
+    sum += h->histo[i];
+    if ((sum*100) >= (total*common_config.storcli_hedge_percentile)) break;
+  }
+  if (i == STORCLI_LAT_HISTO_SZ) i--;
+  /*
+  ** upper bound of the bucket
+  */
+  h->delay_us = 1ULL<<(i+1);
+
+  for (i = 0; i < STORCLI_LAT_HISTO_SZ; i++) h->histo[i] /= 2;
+  h->samples = 0;
+}
+/*
+**____________________________________________________
+*/
+/**
+* Account for the end of a projection read request of a load balancing group
+
+  @param lbg_id: index of the load balancing group
+  @param start_us: date the request has been sent at in us (0 when no sample is to be taken)
+  
+ @retval none
+*/
+void rozofs_storcli_lbg_read_done(int lbg_id, uint64_t start_us)
+{
+  storcli_lbg_latency_t *p;
+  struct timeval         tv;
+  uint64_t               lat_us;
+  int                    bucket;
+
+  if ((lbg_id < 0) || (lbg_id >=STORCLI_MAX_LBG)) return;
+  p = &storcli_lbg_latency_tab[lbg_id];
+  if (p->pending > 0) p->pending--;
+
+  if (start_us == 0) return;
+  gettimeofday(&tv,(struct timezone *)0);
+  lat_us = MICROLONG(tv);
+  lat_us = (lat_us > start_us) ? (lat_us - start_us) : 1;
+  if (lat_us > 0xFFFFFFFF) lat_us = 0xFFFFFFFF;
+
+  /*
+  ** smoothed response time (1/8 weight for the new sample)
+  */
+  if (p->count == 0) p->ewma_us = (uint32_t)lat_us;
+  else               p->ewma_us = (uint32_t)(((int64_t)p->ewma_us*7 + (int64_t)lat_us)/8);
+  if (p->ewma_us == 0) p->ewma_us = 1;
+  p->count++;
+
+  if (common_config.storcli_hedge_percentile == 0) return;
+  bucket = 0;
+  while ((lat_us > 1) && (bucket < (STORCLI_LAT_HISTO_SZ-1))) {
+    lat_us >>= 1;
+    bucket++;
+  }
+  rozofs_storcli_hedge.histo[bucket]++;
+  if (++rozofs_storcli_hedge.samples >= STORCLI_HEDGE_SAMPLES) rozofs_storcli_hedge_compute_delay();
+}
+/*
+**____________________________________________________
+*/
+/**
+* Process the read contexts whose hedge date is reached: read a spare
+  projection for each missing one. Called every 20ms.
+  
+ @retval none
+*/
+static void rozofs_storcli_hedge_check()
+{
+  rozofs_storcli_hedge_t *h = &rozofs_storcli_hedge;
+  ruc_obj_desc_t         *pnext = NULL;
+  ruc_obj_desc_t         *timer;
+  rozofs_storcli_ctx_t   *read_ctx_p;
+  struct timeval          tv;
+  uint64_t                now;
+  int                     lbg_id;
+
+  /*
+  ** Let the slow storages that are no more read go back in the selection
+  */
+  if (++h->aging_ticks >= STORCLI_LAT_AGING_TICKS) {
+    h->aging_ticks = 0;
+    for (lbg_id = 0; lbg_id < STORCLI_MAX_LBG; lbg_id++) {
+      storcli_lbg_latency_tab[lbg_id].ewma_us -= (storcli_lbg_latency_tab[lbg_id].ewma_us/8);
+    }
+  }
+
+  gettimeofday(&tv,(struct timezone *)0);
+  now = MICROLONG(tv);
+
+  while  ((timer = ruc_objGetNext(&h->list,&pnext)) !=NULL) 
+  {
+    read_ctx_p = (rozofs_storcli_ctx_t * )ruc_listGetAssoc(timer);
+    if (read_ctx_p->hedge_date_us > now) continue;
+    rozofs_storcli_stop_read_guard_timer(read_ctx_p); 
+    h->fired++;
+    rozofs_storcli_read_timeout(read_ctx_p); 
+  }
+}
+
 /*
 **____________________________________________________
 */
@@ -1880,6 +2114,29 @@ rozofs_storcli_read_clk_t  rozofs_storcli_read_clk;
 void rozofs_storcli_start_read_guard_timer(rozofs_storcli_ctx_t  *p)
 {
    rozofs_storcli_stop_read_guard_timer(p);
+   
+   /*
+   ** Hedged read: the spare projection is read when the oldest missing 
+   ** projection has been waiting for the hedge delay
+   */
+   if ((p->opcode_key == STORCLI_READ) && (common_config.storcli_hedge_percentile != 0)
+   &&  (rozofs_storcli_hedge.delay_us != 0)) {
+     storcli_read_arg_t *storcli_read_rq_p = (storcli_read_arg_t*)&p->storcli_read_arg;
+     uint8_t             rozofs_safe = rozofs_get_rozofs_safe(storcli_read_rq_p->layout);
+     uint64_t            oldest = (uint64_t)-1;
+     int                 i;
+
+     for (i = 0; i < rozofs_safe; i++) {
+       if (p->prj_ctx[i].prj_state != ROZOFS_PRJ_READ_IN_PRG) continue;
+       if (p->prj_ctx[i].timestamp < oldest) oldest = p->prj_ctx[i].timestamp;
+     }
+     if (oldest != (uint64_t)-1) {
+       p->hedge_date_us = oldest + rozofs_storcli_hedge.delay_us;
+       rozofs_storcli_hedge.armed++;
+       ruc_objInsertTail(&rozofs_storcli_hedge.list,&p->timer_list);
+       return;
+     }
+   }
    ruc_objInsertTail((ruc_obj_desc_t*)&rozofs_storcli_read_clk.bucket[rozofs_storcli_read_clk.bucket_cur],
                     &p->timer_list);
    
@@ -1916,6 +2173,8 @@ void rozofs_storcli_periodic_ticker(void * param)
    ruc_obj_desc_t  *timer;
    int bucket_idx;
    
+   rozofs_storcli_hedge_check();
+   
    ticker_count += 100;
    if (ticker_count < ROZOFS_TMR_GET(TMR_PRJ_READ_SPARE)) return;
    
@@ -1950,6 +2209,32 @@ void rozofs_storcli_periodic_ticker(void * param)
 /*
 **____________________________________________________
 */
+/*
+  Display the response times of the projection reads per load balancing group
+  and the hedged read statistics
+*/
+void rozofs_storcli_read_latency_debug(char * argv[], uint32_t tcpRef, void *bufRef) {
+  char                  *pChar = uma_dbg_get_buffer();
+  storcli_lbg_latency_t *p = storcli_lbg_latency_tab;
+  int                    lbg_id;
+
+  pChar += sprintf(pChar,"latency selection : %s\n",common_config.storcli_latency_select?"enabled":"disabled");
+  pChar += sprintf(pChar,"hedge percentile  : %d\n",common_config.storcli_hedge_percentile);
+  pChar += sprintf(pChar,"hedge delay       : %llu us\n",(long long unsigned int)rozofs_storcli_hedge.delay_us);
+  pChar += sprintf(pChar,"hedge armed       : %llu\n",(long long unsigned int)rozofs_storcli_hedge.armed);
+  pChar += sprintf(pChar,"hedge fired       : %llu\n",(long long unsigned int)rozofs_storcli_hedge.fired);
+  pChar += sprintf(pChar,"\n lbg |  ewma (us) | pending |      samples |\n");
+  pChar += sprintf(pChar,"-----+------------+---------+--------------+\n");
+  for (lbg_id = 0; lbg_id < STORCLI_MAX_LBG; lbg_id++,p++) {
+    if ((p->count == 0) && (p->pending == 0)) continue;
+    pChar += sprintf(pChar," %3d | %10u | %7u | %12llu |\n",
+                     lbg_id, p->ewma_us, p->pending, (long long unsigned int)p->count);
+  }
+  uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
+}
+/*
+**____________________________________________________
+*/
 /*
   start a periodic timer to chech wether the export LBG is down
   When the export is restarted its port may change, and so
@@ -1965,6 +2250,11 @@ void rozofs_storcli_read_init_timer_module() {
   }
   rozofs_storcli_read_clk.bucket_cur = 0;
   
+  memset(&rozofs_storcli_hedge,0,sizeof(rozofs_storcli_hedge));
+  ruc_listHdrInit(&rozofs_storcli_hedge.list);   
+  memset(storcli_lbg_latency_tab,0,sizeof(storcli_lbg_latency_t)*STORCLI_MAX_LBG);
+  uma_dbg_addTopic("read_latency", rozofs_storcli_read_latency_debug);
+  
   periodic_timer = ruc_timer_alloc(0,0);
   if (periodic_timer == NULL) {
     severe("no timer");
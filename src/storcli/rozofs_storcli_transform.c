@@ -51,11 +51,77 @@ DECLARE_PROFILING(stcpp_profiler_t);
 int transform_libinit()
 {
     rozofs_layout_initialize();
+    /*
+    ** select the Mojette engine according to the CPU capabilities
+    */
+    info("Mojette engine %s",transform128_engine2String(transform128_engine_init()));
+    /*
+    ** build the inverse programs of every projection set
+    */
+    transform128_inverse_prog_init();
     return 0;
 }
 /*
 **__________________________________________________________________________
 */
+/**
+*  Pending batch of blocks decoded with the same inverse program
+*/
+typedef struct _rozofs_storcli_inverse_batch_t {
+  transform128_inverse_prog_t * prog;
+  int                           nb;
+  int                           block_idx[TRANSFORM128_INVERSE_BATCH_MAX];
+  pxl_t                       * supports[TRANSFORM128_INVERSE_BATCH_MAX];
+  projection_opt_t              projections[TRANSFORM128_INVERSE_BATCH_MAX][ROZOFS_SAFE_MAX_STORCLI];
+} rozofs_storcli_inverse_batch_t;
+/*
+**__________________________________________________________________________
+*/
+/** 
+  Decode the blocks pending in the batch and complete their state
+
+ * @param *batch_p: the pending batch
+ * @param max_prj_sz: max projection size in bytes (without header&footer)
+ * @param bbytes: block size in bytes
+ * @param *block_ctx_p: block contexts
+ *
+ * @return: the number of decoding passes, -1 on error (errno is set)
+ */
+static int rozofs_storcli_inverse_batch_flush(rozofs_storcli_inverse_batch_t *batch_p,
+                                              int max_prj_sz, uint32_t bbytes,
+                                              rozofs_storcli_inverse_block_t *block_ctx_p)
+{
+    int passes;
+    int i;
+    
+    if (batch_p->nb == 0) return 0;
+    
+    passes = transform128_inverse_prog_run_batch(batch_p->prog,batch_p->supports,
+                                                 batch_p->projections,batch_p->nb,max_prj_sz);
+    if (passes < 0) return -1;
+    for (i = 0; i < batch_p->nb; i++)
+    {
+      int block_idx = batch_p->block_idx[i];
+      /*
+      ** indicate that transform has been done for the projection
+      */
+      block_ctx_p[block_idx].state = ROZOFS_BLK_TRANSFORM_DONE;
+      /*
+      ** check the case of a block that is not full: need to zero's that part
+      */
+      if (block_ctx_p[block_idx].effective_length < bbytes)
+      {
+         char *raz_p = (char*)batch_p->supports[i] + block_ctx_p[block_idx].effective_length;
+         memset( raz_p,0,(bbytes-block_ctx_p[block_idx].effective_length) );
+      }
+    }
+    batch_p->nb   = 0;
+    batch_p->prog = NULL;
+    return passes;
+}
+/*
+**__________________________________________________________________________
+*/
 /** 
   Apply the transform to a buffer starting at "data". That buffer MUST be ROZOFS_BSIZE
   aligned.
@@ -63,6 +129,8 @@ int transform_libinit()
   The number_of_blocks is the number of ROZOFS_BSIZE that must be transform
   Notice that the first_block_idx offset applies to the output transform buffer only
   not to the input buffer pointed by "data".
+  Consecutive blocks rebuilt from the same set of projections are decoded
+  together by passes of at most TRANSFORM128_INVERSE_BATCH_MAX blocks.
   
  * 
  * @param *prj_ctx_p: pointer to the working array of the projection
@@ -72,7 +140,7 @@ int transform_libinit()
    @param *number_of_blocks_p: pointer to the array where the function returns number of blocks on which the transform was applied
   @param *rozofs_storcli_prj_idx_table: pointer to the array used for storing the projections index for inverse process
  *
- * @return: the length written on success, -1 otherwise (errno is set)
+ * @return: the number of decoding passes, -1 on error (errno is set)
  */
  int rozofs_storcli_transform_inverse(rozofs_storcli_projection_ctx_t *prj_ctx_p,  
                                        uint8_t layout, uint32_t bsize,
@@ -87,9 +155,14 @@ int transform_libinit()
 
     projection_t *projections = NULL;
     projection_t rozofs_inv_projections[ROZOFS_SAFE_MAX_STORCLI]; 
+    projection_opt_t rozofs_opt_projections[ROZOFS_SAFE_MAX_STORCLI];
+    rozofs_storcli_inverse_batch_t batch;
+    transform128_inverse_prog_t * prog;
     int block_idx;
     uint16_t projection_id = 0;
     int prj_ctx_idx;
+    int passes = 0;
+    int ret;
 
     uint32_t bbytes = ROZOFS_BSIZE_BYTES(bsize);
     *number_of_blocks_p = 0;
@@ -100,6 +173,10 @@ int transform_libinit()
     projections = rozofs_inv_projections;
     
     int prj_size_in_msg = rozofs_get_max_psize_in_msg(layout,bsize);
+    int max_prj_sz = rozofs_get_max_psize(layout,bsize)*sizeof(bin_t);
+    
+    batch.nb   = 0;
+    batch.prog = NULL;
         
     /*
     ** Proceed the inverse data transform for the nb_projections2read blocks.
@@ -131,12 +208,15 @@ int transform_libinit()
         if ((block_ctx_p[block_idx].timestamp == 0)  && (block_ctx_p[block_idx].effective_length == 0 ))
         {
           /*
-          ** we have reached end of file
+          ** we have reached end of file: decode the pending blocks first
           */
+          ret = rozofs_storcli_inverse_batch_flush(&batch,max_prj_sz,bbytes,block_ctx_p);
+          if (ret < 0) return -1;
+          passes += ret;
           block_ctx_p[block_idx].state = ROZOFS_BLK_TRANSFORM_DONE;
           *number_of_blocks_p = (block_idx++);
           
-          return 0;        
+          return passes;        
         }      
 	
         /*
@@ -147,6 +227,7 @@ int transform_libinit()
         ** been read!!
         */
         int prj_count = 0;
+        int prj_key = 0;
         for (prj_count = 0; prj_count < rozofs_inverse; prj_count++)
         {
            /*
@@ -163,25 +244,50 @@ int transform_libinit()
            **   For each meta-projection
            */
            projection_id = rozofs_bins_hdr_p->s.projection_id;
+           prj_key |= (1<<projection_id);
+           rozofs_opt_projections[prj_count].projection_id = projection_id;
+           rozofs_opt_projections[prj_count].bins = (bin_t*)(rozofs_bins_hdr_p+1);                   
+        }
+        /*
+        ** Get the precompiled inverse program of that set of projections
+        */
+        prog = transform128_inverse_prog_get(layout,bsize,prj_key);
+        if (prog != NULL)
+        {
+          /*
+          ** Decode the pending blocks when the set of projections changes
+          ** or when the batch is full
+          */
+          if ((batch.prog != prog) || (batch.nb == TRANSFORM128_INVERSE_BATCH_MAX))
+          {
+            ret = rozofs_storcli_inverse_batch_flush(&batch,max_prj_sz,bbytes,block_ctx_p);
+            if (ret < 0) return -1;
+            passes += ret;
+          }
+          batch.prog = prog;
+          batch.block_idx[batch.nb] = block_idx;
+          batch.supports[batch.nb]  = (pxl_t *) (data + (bbytes * (first_block_idx + block_idx)));
+          memcpy(batch.projections[batch.nb],rozofs_opt_projections,rozofs_inverse*sizeof(projection_opt_t));
+          batch.nb++;
+          continue;
+        }
+        /*
+        ** No program for that set (table not built): compute the inverse parameters
+        */
+        for (prj_count = 0; prj_count < rozofs_inverse; prj_count++)
+        {
+           projection_id = rozofs_opt_projections[prj_count].projection_id;
            projections[prj_count].angle.p = rozofs_get_angles_p(layout,projection_id);
            projections[prj_count].angle.q = rozofs_get_angles_q(layout,projection_id);
            projections[prj_count].size = rozofs_get_128bits_psizes(layout,bsize, projection_id);
-           projections[prj_count].bins = (bin_t*)(rozofs_bins_hdr_p+1);                   
+           projections[prj_count].bins = rozofs_opt_projections[prj_count].bins;
         }
-#if 0
-        {
-	
-	   int val128bits = rozofs_get_max_psize_128bits(layout,bsize);
-	   int val64bits = rozofs_get_max_psize(layout,bsize);
-	   info("FDL 128: %d (%d) 64: %d (%d)",val128bits,val128bits*16,val64bits,val64bits*8);
-	
-	}
-#endif
         // Inverse data for the block (first_block_idx + block_idx)
         transform128_inverse_copy((pxl_t *) (data + (bbytes * (first_block_idx + block_idx))),
                 rozofs_inverse,
                 bbytes / rozofs_inverse / sizeof (pxl_t),
-                rozofs_inverse, projections,rozofs_get_max_psize(layout,bsize)*sizeof(bin_t));
+                rozofs_inverse, projections,max_prj_sz);
+        passes++;
         /*
         ** indicate that transform has been done for the projection
         */
@@ -199,11 +305,17 @@ int transform_libinit()
         }
     }
     /*
+    ** decode the last pending blocks
+    */
+    ret = rozofs_storcli_inverse_batch_flush(&batch,max_prj_sz,bbytes,block_ctx_p);
+    if (ret < 0) return -1;
+    passes += ret;
+    /*
     ** now the inverse transform is finished, release the allocated ressources used for
     ** rebuild
     */
     *number_of_blocks_p = number_of_blocks;
-    return 0;   
+    return passes;   
 }
 /*
 **__________________________________________________________________________
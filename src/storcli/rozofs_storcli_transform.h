@@ -156,7 +156,7 @@ extern uint8_t      rozofs_storcli_prj_idx_table[];
    @param *number_of_blocks_p: pointer to the array where the function returns number of blocks on which the transform was applied
    @param *rozofs_storcli_prj_idx_table: pointer to the array used for storing the projections index for inverse process
  *
- * @return: the length written on success, -1 otherwise (errno is set)
+ * @return: the number of decoding passes, -1 on error (errno is set)
  */
  int rozofs_storcli_transform_inverse(rozofs_storcli_projection_ctx_t *prj_ctx_p,  
                                        uint8_t layout, uint32_t bsize,
@@ -151,6 +151,153 @@ static inline int rozofs_storcli_all_prj_write_check(uint8_t layout,rozofs_storc
   if (received == rozofs_inverse) return 1;   
   return 0;
 }
+/*
+**__________________________________________________________________________
+*/
+/**
+* Count the projections that have been written on the storages
+  
+  @param layout : layout association with the file
+  @param prj_cxt_p: pointer to the projection context (working array)
+  
+  @retval number of projections in ROZOFS_PRJ_WR_DONE state
+*/
+static inline int rozofs_storcli_count_prj_write_done(uint8_t layout,rozofs_storcli_projection_ctx_t *prj_cxt_p)
+{
+  uint8_t   rozofs_forward = rozofs_get_rozofs_forward(layout);
+  int i;
+  int received = 0;
+  
+  for (i = 0; i <rozofs_forward; i++,prj_cxt_p++)
+  {
+    if (prj_cxt_p->prj_state == ROZOFS_PRJ_WR_DONE) received++;
+  }
+  return received;
+}
+/*
+**__________________________________________________________________________
+*/
+/**
+* Log a write that has been acknowledged to rozofsmount but for which some
+  projections could not be written on any storage after every rewrite round.
+  The blocks miss these projections until their storages are rebuilt.
+  
+  @param working_ctx_p: pointer to the root transaction context
+*/
+static void rozofs_storcli_write_log_incomplete(rozofs_storcli_ctx_t *working_ctx_p)
+{
+  storcli_write_arg_no_data_t   *storcli_write_rq_p = (storcli_write_arg_no_data_t*)&working_ctx_p->storcli_write_arg;
+  storcli_one_incomplete_wr_ctx *pCtx;
+  uint8_t                        rozofs_forward = rozofs_get_rozofs_forward(storcli_write_rq_p->layout);
+  char                           fidString[40];
+  int                            idx;
+
+  storcli_wr_incomplete.incomplete++;
+  
+  /*
+  ** Look for this FID in the table
+  */
+  pCtx = storcli_wr_incomplete.ctx;
+  for (idx=0; idx<STORCLI_MAX_INCOMPLETE_WR_NB; idx++,pCtx++) {
+    if (memcmp(pCtx->fid,storcli_write_rq_p->fid,sizeof(fid_t))==0) break;
+  }
+  if (idx == STORCLI_MAX_INCOMPLETE_WR_NB) {
+    pCtx = &storcli_wr_incomplete.ctx[storcli_wr_incomplete.nextIdx];
+    storcli_wr_incomplete.nextIdx++;
+    if (storcli_wr_incomplete.nextIdx>=STORCLI_MAX_INCOMPLETE_WR_NB) {
+      storcli_wr_incomplete.nextIdx = 0;
+    }
+    memcpy(pCtx->fid,storcli_write_rq_p->fid,sizeof(fid_t));
+  }
+  pCtx->off     = storcli_write_rq_p->off;
+  pCtx->len     = storcli_write_rq_p->len;
+  pCtx->missing = rozofs_forward - rozofs_storcli_count_prj_write_done(storcli_write_rq_p->layout,working_ctx_p->prj_ctx);
+  pCtx->ts      = time(NULL);
+
+  rozofs_uuid_unparse(storcli_write_rq_p->fid,fidString);
+  severe("FID %s off %llu len %u acknowledged with %d missing projection(s)",
+          fidString,(unsigned long long)pCtx->off,pCtx->len,pCtx->missing);
+}
+/*
+**__________________________________________________________________________
+*/
+/**
+* Schedule a new write of the projections of an acknowledged write that
+  could not be written on any storage. The projections that are not written 
+  are sent again on the guard timer expiration (rozofs_storcli_write_timeout),
+  on their nominal storage first and then on the spare storages. The context 
+  stays in the FID serialization list until the end of the rewrite rounds.
+  
+  @param working_ctx_p: pointer to the root transaction context
+  @param projection_id: the projection that could not be written
+  
+  @retval 0 when a rewrite round is scheduled
+  @retval -1 when every rewrite round has been done
+*/
+static int rozofs_storcli_write_rewrite(rozofs_storcli_ctx_t *working_ctx_p,uint8_t projection_id)
+{
+  storcli_write_arg_no_data_t     *storcli_write_rq_p = (storcli_write_arg_no_data_t*)&working_ctx_p->storcli_write_arg;
+  rozofs_storcli_projection_ctx_t *prj_cxt_p = working_ctx_p->prj_ctx;
+  uint8_t                          rozofs_forward = rozofs_get_rozofs_forward(storcli_write_rq_p->layout);
+  uint8_t                          rozofs_safe    = rozofs_get_rozofs_safe(storcli_write_rq_p->layout);
+  int                              storage_idx;
+  int                              i;
+
+  prj_cxt_p[projection_id].prj_state = ROZOFS_PRJ_WR_ERROR;
+  /*
+  ** A rewrite round is already waiting for the guard timer
+  */
+  if (working_ctx_p->wr_rewrite_armed) return 0;
+  if (working_ctx_p->wr_rewrite_cpt >= ROZOFS_STORCLI_MAX_REWRITE) return -1;
+
+  working_ctx_p->wr_rewrite_cpt++;
+  working_ctx_p->wr_rewrite_armed = 1;
+  /*
+  ** Make selectable again the storages that hold neither a written projection
+  ** nor a projection in progress
+  */
+  for (storage_idx = 0; storage_idx < rozofs_safe; storage_idx++)
+  {
+    for (i = 0; i < rozofs_forward; i++)
+    {
+      if (prj_cxt_p[i].valid_stor_idx == 0) continue;
+      if (prj_cxt_p[i].stor_idx != storage_idx) continue;
+      if ((prj_cxt_p[i].prj_state == ROZOFS_PRJ_WR_DONE) || (prj_cxt_p[i].prj_state == ROZOFS_PRJ_WR_IN_PRG)) break;
+    }
+    if (i == rozofs_forward) rozofs_storcli_lbg_prj_clear_projection_id(working_ctx_p->lbg_assoc_tb,storage_idx,0);
+  }
+  for (i = 0; i < rozofs_forward; i++)
+  {
+    if (prj_cxt_p[i].prj_state == ROZOFS_PRJ_WR_ERROR) prj_cxt_p[i].retry_cpt = 0;
+  }
+  rozofs_storcli_start_read_guard_timer(working_ctx_p);
+  return 0;
+}
+/*
+**__________________________________________________________________________
+*/
+/**
+* Release the buffer of a projection that has been allocated by a previous
+  guard timer expiration
+  
+  @param prj_cxt_p: pointer to the projection context
+*/
+static inline void rozofs_storcli_write_release_missing_buf(rozofs_storcli_projection_ctx_t *prj_cxt_p)
+{
+  int inuse;
+  
+  if (prj_cxt_p->prj_buf_missing == NULL) return;
+  
+  if (prj_cxt_p->inuse_valid_missing == 1) inuse = ruc_buf_inuse_decrement(prj_cxt_p->prj_buf_missing);
+  else                                     inuse = ruc_buf_inuse_get(prj_cxt_p->prj_buf_missing);
+  if (inuse == 1) 
+  {
+    ruc_objRemove((ruc_obj_desc_t*)prj_cxt_p->prj_buf_missing);
+    ruc_buf_freeBuffer(prj_cxt_p->prj_buf_missing);
+  }
+  prj_cxt_p->prj_buf_missing     = NULL;
+  prj_cxt_p->inuse_valid_missing = 0;
+}
 
 /*
 **_________________________________________________________________________
@@ -569,15 +716,14 @@ void rozofs_storcli_write_req_processing_exec(rozofs_storcli_ctx_t *working_ctx_
    if ((rozofs_stcmoj_thread_write_enable) &&(read_req == 0)&& 
         (storcli_write_rq_p->len >rozofs_stcmoj_thread_len_threshold))
    {
-     ret = rozofs_stcmoj_thread_intf_send(STORCLI_MOJETTE_THREAD_FWD,working_ctx_p,0);
-     if (ret < 0) 
+     /*
+     ** When there is no room in the Mojette thread rings, the transform
+     ** is done below by the main thread
+     */
+     if (rozofs_stcmoj_thread_intf_send(STORCLI_MOJETTE_THREAD_FWD,working_ctx_p,0) == 0) 
      {
-        errno = EPROTO;
-        storcli_trace_error(__LINE__,errcode, working_ctx_p);     	   
-	
-	goto failure;
-     }
-     return;   
+       return;
+     }   
    }
     /*
     ** Just to address the case of the buffer on which the fransform must apply
@@ -1402,10 +1548,21 @@ retry:
     */      
     
 reject:  
+     /*
+     ** The write has already been acknowledged to rozofsmount: write the
+     ** missing projections again later
+     */
+     if ((working_ctx_p->reply_done) && (rozofs_storcli_write_rewrite(working_ctx_p,projection_id) == 0)) return;
+
      if (working_ctx_p->write_ctx_lock != 0) return;
 
      storcli_trace_error(line,error, working_ctx_p);     	   
      
+     /*
+     ** The write has already been acknowledged to rozofsmount: keep track
+     ** of the blocks that miss some projections
+     */
+     if (working_ctx_p->reply_done) rozofs_storcli_write_log_incomplete(working_ctx_p);
      /*
      ** we fall in that case when we run out of  storage
      */
@@ -1418,12 +1575,14 @@ reject:
      return; 
       
 fatal:
+     if ((working_ctx_p->reply_done) && (rozofs_storcli_write_rewrite(working_ctx_p,projection_id) == 0)) return;
      /*
      ** caution -> reply error is only generated if the ctx_lock is 0
      */
      if (working_ctx_p->write_ctx_lock != 0) return;
 
      storcli_trace_error(line,error, working_ctx_p);     	   
+     if (working_ctx_p->reply_done) rozofs_storcli_write_log_incomplete(working_ctx_p);
 
      /*
      ** we fall in that case when we run out of  resource-> that case is a BUG !!
@@ -1656,6 +1815,19 @@ void rozofs_storcli_write_req_processing_cbk(void *this,void *param)
                                              &working_ctx_p->wr_distribution);
     if (ret == 0)
     {
+       /*
+       ** In early acknowledge mode, answer to the client as soon as one
+       ** projection more than rozofs_inverse is written. The context remains
+       ** in the FID serialization list until every projection is written,
+       ** so the following requests on this FID wait for it.
+       */
+       if ((common_config.wr_ack_early) && (working_ctx_p->reply_done == 0)
+       &&  (rozofs_storcli_count_prj_write_done(storcli_write_rq_p->layout,working_ctx_p->prj_ctx)
+                == rozofs_get_rozofs_inverse(storcli_write_rq_p->layout)+1))
+       {
+         storcli_wr_incomplete.early_ack++;
+         rozofs_storcli_write_reply_success(working_ctx_p);
+       }
        /*
        ** no enough projection 
        */
@@ -1674,6 +1846,7 @@ void rozofs_storcli_write_req_processing_cbk(void *this,void *param)
       /*
       ** write is finished, send back the response to the client (rozofsmount)
       */       
+      if (working_ctx_p->reply_done) storcli_wr_incomplete.completed++;
       rozofs_storcli_write_reply_success(working_ctx_p);
       rozofs_storcli_stop_read_guard_timer(working_ctx_p);    
       rozofs_storcli_release_context(working_ctx_p);  
@@ -1690,8 +1863,9 @@ void rozofs_storcli_write_req_processing_cbk(void *this,void *param)
     /*
     ** answer by anticipation to the client
     */
-    if (common_config.wr_ack_on_inverse)
+    if ((common_config.wr_ack_on_inverse) && (working_ctx_p->reply_done == 0))
     {
+      storcli_wr_incomplete.early_ack++;
       rozofs_storcli_write_reply_success(working_ctx_p);    
     }  
     return;
@@ -1727,6 +1901,7 @@ fatal:
     rozofs_tx_free_from_ptr(this);
     severe("Cannot get the pointer to the receive buffer");
 
+    if (working_ctx_p->reply_done) rozofs_storcli_write_log_incomplete(working_ctx_p);
     rozofs_storcli_write_reply_error(working_ctx_p,error);
     /*
     ** release the root transaction context
@@ -2263,6 +2438,10 @@ void rozofs_storcli_write_timeout(rozofs_storcli_ctx_t *working_ctx_p)
    storcli_write_rq_p = (storcli_write_arg_no_data_t*)&working_ctx_p->storcli_write_arg;
     layout         = storcli_write_rq_p->layout;
     rozofs_forward = rozofs_get_rozofs_forward(layout);
+    /*
+    ** This is the start of a rewrite round when one has been scheduled
+    */
+    working_ctx_p->wr_rewrite_armed = 0;
 
     prj_cxt_p = working_ctx_p->prj_ctx;
     /*
@@ -2283,8 +2462,10 @@ void rozofs_storcli_write_timeout(rozofs_storcli_ctx_t *working_ctx_p)
     for (i = 0; i < missing; i++)
     {
       /*
-      ** allocate a buffer for the missing projection
+      ** allocate a buffer for the missing projection, after releasing the
+      ** one of a previous round
       */
+      rozofs_storcli_write_release_missing_buf(&working_ctx_p->prj_ctx[projection_id_tab[i]]);
       working_ctx_p->prj_ctx[projection_id_tab[i]].prj_buf_missing   = ruc_buf_getBuffer(ROZOFS_STORCLI_SOUTH_LARGE_POOL);
       if (working_ctx_p->prj_ctx[projection_id_tab[i]].prj_buf_missing == NULL)
       {
@@ -2324,5 +2505,21 @@ void rozofs_storcli_write_timeout(rozofs_storcli_ctx_t *working_ctx_p)
       rozofs_storcli_write_projection_retry(working_ctx_p,projection_id_tab[i],same_storage_retry_acceptable,1);   
       working_ctx_p->write_ctx_lock--;
     }    
+    /*
+    ** An acknowledged write whose last rewrite round failed on every 
+    ** projection in the loop above has nothing left in progress
+    */
+    if ((working_ctx_p->reply_done) && (working_ctx_p->wr_rewrite_armed == 0)) 
+    {
+      prj_cxt_p = working_ctx_p->prj_ctx;
+      for (i = 0; i <rozofs_forward; i++,prj_cxt_p++)
+      {
+        if (prj_cxt_p->prj_state == ROZOFS_PRJ_WR_IN_PRG) return;
+      }
+      if (rozofs_storcli_count_prj_write_done(layout,working_ctx_p->prj_ctx) == rozofs_forward) return;
+      rozofs_storcli_write_log_incomplete(working_ctx_p);
+      STORCLI_STOP_NORTH_PROF(working_ctx_p,write,0);
+      rozofs_storcli_release_context(working_ctx_p);  
+    }
     return;    
 }        
@@ -120,6 +120,7 @@ uint32_t rozofs_storcli_cid_state_table[ROZOFS_CLUSTERS_MAX];
 uint32_t storcli_vid_state = CID_DEPENDENCY_ST;
 
 storcli_lbg_cnx_supervision_t storcli_lbg_cnx_supervision_tab[STORCLI_MAX_LBG];
+storcli_lbg_latency_t storcli_lbg_latency_tab[STORCLI_MAX_LBG];
 
 #define DISPLAY_UINT32_CONFIG(field)   pChar += sprintf(pChar,"%-25s = %u\n",#field, conf.field); 
 #define DISPLAY_STRING_CONFIG(field) \
@@ -224,6 +225,7 @@ void show_profiler(char * argv[], uint32_t tcpRef, void *bufRef) {
 
 
     pChar += sprintf(pChar, "GPROFILER version %s uptime =  %d days, %2.2d:%2.2d:%2.2d\n", gprofiler->vers,days, hours, mins, secs);
+    pChar += sprintf(pChar, "Mojette engine : %s\n", transform128_engine2String(transform128_engine_get()));
     pChar += sprintf(pChar, "   procedure        |     count        |  time(us)  | cumulated time(us)  |     bytes       |\n");
     pChar += sprintf(pChar, "--------------------+------------------+------------+---------------------+-----------------+\n");
 
@@ -428,6 +430,88 @@ void show_corrupted(char * argv[], uint32_t tcpRef, void *bufRef) {
   
   uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
 }
+/*
+**____________________________________________________
+** Writes acknowledged before being complete
+**
+*/
+storcli_incomplete_wr_ctx storcli_wr_incomplete = { 0 };
+/* 
+**____________________________________________________
+** Incomplete write CLI man
+**
+*/
+void man_wr_incomplete(char * pChar) {
+  pChar += rozofs_string_append(pChar,"wr_incomplete       : display the writes acknowledged before every projection was written.\n");
+  pChar += rozofs_string_append(pChar,"wr_incomplete reset : reset the counters and the incomplete write table.\n");
+  pChar += rozofs_string_append(pChar,"\nearly ack  : writes acknowledged before every projection was written.\n");
+  pChar += rozofs_string_append(pChar,"completed  : such writes that have been completed afterwards.\n");
+  pChar += rozofs_string_append(pChar,"incomplete : such writes that miss some projections. The table gives the last ones.\n");
+}
+/*
+**____________________________________________________
+** Display incomplete write counters and table
+**
+*/
+char * display_wr_incomplete(char * pChar) {
+  uint        idx;
+  storcli_one_incomplete_wr_ctx * pCtx;
+  int        first=1;
+
+  pChar += rozofs_string_append(pChar, "{\n   \"early write ack\" : {\n      \"mode\" : ");
+  if (common_config.wr_ack_on_inverse) pChar += rozofs_string_append(pChar, "\"inverse\"");
+  else if (common_config.wr_ack_early) pChar += rozofs_string_append(pChar, "\"inverse+1\"");
+  else                                 pChar += rozofs_string_append(pChar, "\"forward\"");
+  pChar += rozofs_string_append(pChar, ",\n      \"early ack\" : ");
+  pChar += rozofs_u64_append(pChar, storcli_wr_incomplete.early_ack);
+  pChar += rozofs_string_append(pChar, ",\n      \"completed\" : ");
+  pChar += rozofs_u64_append(pChar, storcli_wr_incomplete.completed);
+  pChar += rozofs_string_append(pChar, ",\n      \"incomplete\" : ");
+  pChar += rozofs_u64_append(pChar, storcli_wr_incomplete.incomplete);
+  pChar += rozofs_string_append(pChar, ",\n      \"incomplete writes\" : [\n");  
+
+  pCtx = storcli_wr_incomplete.ctx;
+  for (idx=0; idx<STORCLI_MAX_INCOMPLETE_WR_NB; idx++,pCtx++) {
+    if (pCtx->ts == 0) continue;
+    if (first) first = 0;
+    else       pChar += rozofs_string_append(pChar, ",\n"); 
+    pChar += rozofs_string_append(pChar, "         {\"FID\" : \"@rozofs_uuid@");  
+    rozofs_uuid_unparse(pCtx->fid, pChar);
+    pChar += 36;
+    pChar += rozofs_string_append(pChar, "\", \"offset\" : ");  
+    pChar += rozofs_u64_append(pChar, pCtx->off);
+    pChar += rozofs_string_append(pChar, ", \"length\" : ");  
+    pChar += rozofs_u32_append(pChar, pCtx->len);
+    pChar += rozofs_string_append(pChar, ", \"missing\" : ");  
+    pChar += rozofs_u32_append(pChar, pCtx->missing);
+    pChar += rozofs_string_append(pChar, ", \"time\" : ");  
+    pChar += rozofs_u64_append(pChar, pCtx->ts);
+    pChar += rozofs_string_append(pChar, "}");  
+  }
+  pChar += rozofs_string_append(pChar, "\n      ]\n   }\n}\n");  
+  return pChar;
+}
+/*
+**____________________________________________________
+** Incomplete write CLI
+**
+*/
+void show_wr_incomplete(char * argv[], uint32_t tcpRef, void *bufRef) {
+  char *pChar = uma_dbg_get_buffer();
+
+  if (argv[1] == NULL) {
+    pChar = display_wr_incomplete(pChar);    
+  }
+  else if (strcasecmp(argv[1],"reset")==0) {
+    pChar = display_wr_incomplete(pChar);
+    memset(&storcli_wr_incomplete,0, sizeof(storcli_wr_incomplete));     
+    pChar += rozofs_string_append(pChar, "\nIncomplete write table reset.\n");	
+  }
+  else {
+    man_wr_incomplete(pChar);  
+  }
+  uma_dbg_send(tcpRef, bufRef, TRUE, uma_dbg_get_buffer());
+}
 /* 
 **____________________________________________________
 ** RW error buffer CLI man
@@ -2036,6 +2120,7 @@ int main(int argc, char *argv[]) {
      */
     uma_dbg_addTopicAndMan("corrupted", show_corrupted, man_corrupted, 0);
     uma_dbg_addTopicAndMan("rwerror", show_rwerror, man_rwerror, 0);
+    uma_dbg_addTopicAndMan("wr_incomplete", show_wr_incomplete, man_wr_incomplete, 0);
 
     /*
     ** add the topic for repair capabilities
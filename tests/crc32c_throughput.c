@@ -0,0 +1,143 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+
+#include <rozofs/rozofs.h>
+#include <rozofs/rozofs_srv.h>
+#include "storio_crc32.h"
+
+#define MB (1024.0*1024.0)
+#define NB_PROJ 32
+
+extern int crc32c_hw_supported;
+
+static double throughput(struct timeval *tic, struct timeval *toc, int nrloop, int bytes) {
+    double us;
+
+    us = (toc->tv_sec - tic->tv_sec) * 1000000.0 + (toc->tv_usec - tic->tv_usec);
+    if (us == 0) us = 1;
+    return ((double) nrloop * bytes / MB) / (us / 1000000.0);
+}
+
+/*
+** Check the hardware CRC against the software one on every length
+*/
+static int crc32c_check(int hw, int pclmul) {
+    unsigned char *buf;
+    uint32_t ref[2];
+    uint32_t crc;
+    int len, off;
+    int errors = 0;
+
+    buf = memalign(64, 20000 + 8);
+    for (len = 0; len < 20000 + 8; len++) buf[len] = (unsigned char) rand();
+
+    for (len = 0; len < 20000; len += (len < 1024) ? 1 : 37) {
+        for (off = 0; off < 8; off += 7) {
+            crc32c_hw_supported = 0;
+            crc32c_pclmul_supported = 0;
+            ref[0] = crc32c(0, buf + off, len);
+            ref[1] = crc32c(0x12345678, buf + off, len);
+            crc32c_hw_supported = hw;
+            crc32c_pclmul_supported = pclmul;
+            crc = crc32c(0, buf + off, len);
+            if (crc != ref[0]) errors++;
+            crc = crc32c(0x12345678, buf + off, len);
+            if (crc != ref[1]) errors++;
+        }
+    }
+    free(buf);
+    return errors;
+}
+
+/*
+** Generate and check the CRC of a set of projections of one layout/bsize
+*/
+static void crc32c_throughput(int nrloop, char *mode, int hw, int pclmul, uint8_t layout, uint32_t bsize) {
+    struct iovec vector[NB_PROJ];
+    uint64_t errors[NB_PROJ / 64 + 1];
+    uint32_t filler[NB_PROJ];
+    uint64_t crc_error = 0;
+    uint16_t prj_size = rozofs_get_max_psize_in_msg(layout, bsize);
+    char *bins;
+    int done, i;
+    int result = 0;
+    double gen_mbs, check_mbs;
+    struct timeval tic, toc;
+    char *layout_name[] = {"2_3_4", "4_6_8", "8_12_16"};
+
+    crc32c_hw_supported = hw;
+    crc32c_pclmul_supported = pclmul;
+
+    bins = memalign(64, NB_PROJ * prj_size);
+    for (i = 0; i < NB_PROJ * prj_size; i++) bins[i] = (char) rand();
+    for (i = 0; i < NB_PROJ; i++) {
+        vector[i].iov_base = bins + i * prj_size;
+        vector[i].iov_len = prj_size;
+    }
+
+    gettimeofday(&tic, NULL);
+    for (done = 0; done < nrloop; done++)
+        storio_gen_crc32_vect(vector, NB_PROJ, prj_size, done);
+    gettimeofday(&toc, NULL);
+    gen_mbs = throughput(&tic, &toc, nrloop, NB_PROJ * prj_size);
+
+    /*
+    ** The check clears the CRC of the headers: restore them on each loop
+    */
+    for (i = 0; i < NB_PROJ; i++) filler[i] = ((rozofs_stor_bins_hdr_t *) vector[i].iov_base)->s.filler;
+    memset(errors, 0, sizeof (errors));
+    gettimeofday(&tic, NULL);
+    for (done = 0; done < nrloop; done++) {
+        for (i = 0; i < NB_PROJ; i++) ((rozofs_stor_bins_hdr_t *) vector[i].iov_base)->s.filler = filler[i];
+        result += storio_check_crc32_vect(vector, NB_PROJ, prj_size, &crc_error, nrloop - 1, errors);
+    }
+    gettimeofday(&toc, NULL);
+    check_mbs = throughput(&tic, &toc, nrloop, NB_PROJ * prj_size);
+
+    /*
+    ** A corrupted projection must be detected
+    */
+    for (i = 0; i < NB_PROJ; i++) ((rozofs_stor_bins_hdr_t *) vector[i].iov_base)->s.filler = filler[i];
+    bins[5 * prj_size + prj_size / 2] ^= 1;
+    if ((storio_check_crc32_vect(vector, NB_PROJ, prj_size, &crc_error, nrloop - 1, errors) != 1)
+     || (errors[0] != (1ULL << 5))) result++;
+
+    printf("%-10s %-10s %6d %8d %10.1f %10.1f %s\n", mode, layout_name[layout],
+            ROZOFS_BSIZE_BYTES(bsize), prj_size, gen_mbs, check_mbs,
+            (result == 0) ? "OK" : "FAILED");
+    free(bins);
+}
+
+int main(int argc, char **argv) {
+    int nrloop = 0;
+    int hw, pclmul;
+    uint8_t layout;
+    uint32_t bsize;
+
+    if (argc < 2) {
+        printf("%s : nr loop\n", argv[0]);
+        return -1;
+    }
+    nrloop = atoi(argv[1]);
+    rozofs_layout_initialize();
+    crc32c_init(1, 1, 0);
+    hw = crc32c_hw_supported;
+    pclmul = crc32c_pclmul_supported;
+
+    if (hw) printf("hardware CRC check %s\n", (crc32c_check(hw, 0) == 0) ? "OK" : "FAILED");
+    if (pclmul) printf("folded CRC check   %s\n", (crc32c_check(hw, pclmul) == 0) ? "OK" : "FAILED");
+
+    printf("%-10s %-10s %6s %8s %10s %10s %s\n", "mode", "layout", "bsize", "prj size", "gen MB/s", "check MB/s", "check");
+    for (layout = 0; layout < LAYOUT_MAX; layout++) {
+        for (bsize = ROZOFS_BSIZE_MIN; bsize <= ROZOFS_BSIZE_MAX; bsize++) {
+            crc32c_throughput(nrloop, "software", 0, 0, layout, bsize);
+            if (hw) crc32c_throughput(nrloop, "hardware", hw, 0, layout, bsize);
+            if (pclmul) crc32c_throughput(nrloop, "folded", hw, pclmul, layout, bsize);
+        }
+    }
+    return 0;
+}
@@ -19,6 +19,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/time.h>
+#include <uuid/uuid.h>
 
 #include <rozofs/common/htable.h>
 
@@ -36,12 +38,96 @@ static int string_cmp(void *key1, void *key2) {
     return strcmp((char *) key1, (char *) key2);
 }
 
+static unsigned int fid_hash(void *key) {
+    uint32_t hash = 0;
+    uint8_t *c;
+
+    for (c = key; c != (uint8_t *) key + 16; c++)
+        hash = *c + (hash << 6) + (hash << 16) - hash;
+    return hash;
+}
+
+static int fid_cmp(void *key1, void *key2) {
+    return memcmp(key1, key2, sizeof (uuid_t));
+}
+
+static double ns_per_op(struct timeval *tic, struct timeval *toc, int nb) {
+    double us;
+
+    us = (toc->tv_sec - tic->tv_sec) * 1000000.0 + (toc->tv_usec - tic->tv_usec);
+    return (us * 1000.0) / nb;
+}
+
+/*
+** Insert, look up (found and not found) and remove nb FIDs
+*/
+static void htable_throughput(char *name, htable_t *h, uuid_t *fids, int nb) {
+    struct timeval tic, toc;
+    double put_ns, hit_ns, miss_ns, del_ns;
+    int errors = 0;
+    int i;
+
+    gettimeofday(&tic, NULL);
+    for (i = 0; i < nb; i++) htable_put(h, fids[i], &fids[i]);
+    gettimeofday(&toc, NULL);
+    put_ns = ns_per_op(&tic, &toc, nb);
+
+    gettimeofday(&tic, NULL);
+    for (i = 0; i < nb; i++) if (htable_get(h, fids[i]) != &fids[i]) errors++;
+    gettimeofday(&toc, NULL);
+    hit_ns = ns_per_op(&tic, &toc, nb);
+
+    gettimeofday(&tic, NULL);
+    for (i = nb; i < 2 * nb; i++) if (htable_get(h, fids[i]) != NULL) errors++;
+    gettimeofday(&toc, NULL);
+    miss_ns = ns_per_op(&tic, &toc, nb);
+
+    gettimeofday(&tic, NULL);
+    for (i = 0; i < nb; i++) if (htable_del(h, fids[i]) != &fids[i]) errors++;
+    gettimeofday(&toc, NULL);
+    del_ns = ns_per_op(&tic, &toc, nb);
+    for (i = 0; i < nb; i++) if (htable_get(h, fids[i]) != NULL) errors++;
+
+    printf("%-20s %10d %8.1f %8.1f %8.1f %8.1f %s\n", name, nb, put_ns, hit_ns, miss_ns, del_ns,
+            (errors == 0) ? "OK" : "FAILED");
+    htable_release(h);
+}
+
+static void htable_benchmark(int nb) {
+    uuid_t *fids;
+    htable_t h;
+    int i;
+
+    fids = malloc(2 * nb * sizeof (uuid_t));
+    for (i = 0; i < 2 * nb; i++) uuid_generate(fids[i]);
+
+    printf("%-20s %10s %8s %8s %8s %8s %s\n", "table", "entries", "put ns", "hit ns", "miss ns", "del ns", "check");
+    htable_initialize(&h, nb, fid_hash, fid_cmp);
+    htable_throughput("chained", &h, fids, nb);
+    htable_initialize_oa(&h, nb, 0, fid_hash, fid_cmp);
+    htable_throughput("open addressing", &h, fids, nb);
+    htable_initialize_oa(&h, 1024, 0, fid_hash, fid_cmp);
+    htable_throughput("open addr. growing", &h, fids, nb);
+    htable_initialize_oa(&h, nb, ROZOFS_HTABLE_MAX_LOCK, fid_hash, fid_cmp);
+    htable_throughput("open addr. locked", &h, fids, nb);
+    free(fids);
+}
+
 int main(int argc, char **argv) {
 
     int i;
     htable_t h;
     //void *ptr;
 
+    /*
+    ** test_htable <nb entries> compares the chained and the open
+    ** addressing tables
+    */
+    if (argc > 1) {
+        htable_benchmark(atoi(argv[1]));
+        return 0;
+    }
+
     static char *keys[] = { "a", "b", "c", "d", "e",
         "f", "g", "h", "i", "j", "k", "l",
         "m", "n", "o", "p", "q", "r", "s",
@@ -79,5 +165,17 @@ int main(int argc, char **argv) {
 
     htable_release(&h);
 
+    /*
+    ** Same sequence on an open addressing table growing from 1 group
+    */
+    htable_initialize_oa(&h, 1, 0, string_hash, string_cmp);
+    for (i = 0; i < 26; i++)
+        htable_put(&h, keys[i], vals[i]);
+    htable_del(&h, "z");
+    for (i = 0; i < 25; i++)
+        if (htable_get(&h, keys[i]) != vals[i]) break;
+    printf("open addressing: %s\n", ((i == 25) && (htable_get(&h, "z") == NULL)) ? "OK" : "FAILED");
+    htable_release(&h);
+
     return 0;
 }
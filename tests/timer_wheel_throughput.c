@@ -0,0 +1,146 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <rozofs/core/ruc_common.h>
+#include <rozofs/core/ruc_timer_api.h>
+#include <rozofs/core/com_tx_timer_api.h>
+#include <rozofs/core/com_tx_timer.h>
+
+#define TICK_MS     100
+#define MAX_DELAY_S 300
+
+static uint64_t expired = 0;
+static uint64_t errors = 0;
+
+static double ns_per_op(struct timeval *tic, struct timeval *toc, int nb) {
+    double us;
+
+    us = (toc->tv_sec - tic->tv_sec) * 1000000.0 + (toc->tv_usec - tic->tv_usec);
+    return (us * 1000.0) / nb;
+}
+
+/*
+** A transaction timer must expire on the tick of its date
+*/
+static void com_tx_expired(void *param) {
+    com_tx_tmr_cell_t *cell = param;
+
+    expired++;
+    if (cell->date_s != com_tx_tmr.cur_tick) errors++;
+}
+
+static void com_tx_throughput(int nb) {
+    com_tx_tmr_cell_t *cells;
+    struct timeval tic, toc;
+    double start_ns, stop_ns, expire_ns;
+    uint32_t first, i;
+
+    cells = malloc(nb * sizeof (com_tx_tmr_cell_t));
+    memset(cells, 0, nb * sizeof (com_tx_tmr_cell_t));
+    for (i = 0; i < nb; i++) ruc_listEltInit((ruc_obj_desc_t *) & cells[i]);
+
+    gettimeofday(&tic, NULL);
+    for (i = 0; i < nb; i++)
+        com_tx_tmr_start(i % COM_TX_TMR_SLOT_MAX, &cells[i], (rand() % (MAX_DELAY_S * 1000)) + 1, com_tx_expired, &cells[i]);
+    gettimeofday(&toc, NULL);
+    start_ns = ns_per_op(&tic, &toc, nb);
+
+    gettimeofday(&tic, NULL);
+    for (i = 0; i < nb; i++) com_tx_tmr_stop(&cells[i]);
+    gettimeofday(&toc, NULL);
+    stop_ns = ns_per_op(&tic, &toc, nb);
+
+    /*
+    ** Arm them again and move the wheel forward tick by tick
+    */
+    for (i = 0; i < nb; i++)
+        com_tx_tmr_start(i % COM_TX_TMR_SLOT_MAX, &cells[i], (rand() % (MAX_DELAY_S * 1000)) + 1, com_tx_expired, &cells[i]);
+    expired = 0;
+    errors = 0;
+    first = com_tx_tmr.cur_tick;
+    gettimeofday(&tic, NULL);
+    for (i = 1; i <= (MAX_DELAY_S * 1000 / TICK_MS) + 1; i++) com_tx_tmr_advance(first + i);
+    gettimeofday(&toc, NULL);
+    expire_ns = ns_per_op(&tic, &toc, nb);
+
+    printf("%-10s %10d %10.1f %10.1f %10.1f %10llu %s\n", "com_tx", nb, start_ns, stop_ns, expire_ns,
+            (unsigned long long) expired, ((errors == 0) && (expired == nb)) ? "OK" : "FAILED");
+    free(cells);
+}
+
+/*
+** A ruc timer must expire on the tick of its date
+*/
+static uint64_t ruc_tick = 0;
+static uint64_t *ruc_date;
+
+static void ruc_expired(void *param) {
+    uint64_t idx = (uint64_t) param;
+
+    expired++;
+    if (ruc_date[idx] != ruc_tick) errors++;
+}
+
+static void ruc_throughput(int nb) {
+    struct timer_cell **cells;
+    struct timeval tic, toc;
+    double start_ns, stop_ns, expire_ns;
+    uint64_t i;
+    uint32_t delay;
+
+    cells = malloc(nb * sizeof (struct timer_cell *));
+    ruc_date = malloc(nb * sizeof (uint64_t));
+    for (i = 0; i < nb; i++) cells[i] = ruc_timer_alloc(0, 0);
+
+    gettimeofday(&tic, NULL);
+    for (i = 0; i < nb; i++)
+        ruc_timer_start(cells[i], ((rand() % (MAX_DELAY_S * 10)) + 1) * TICK_MS, ruc_expired, (void *) i);
+    gettimeofday(&toc, NULL);
+    start_ns = ns_per_op(&tic, &toc, nb);
+
+    gettimeofday(&tic, NULL);
+    for (i = 0; i < nb; i++) ruc_timer_stop(cells[i]);
+    gettimeofday(&toc, NULL);
+    stop_ns = ns_per_op(&tic, &toc, nb);
+
+    for (i = 0; i < nb; i++) {
+        delay = (rand() % (MAX_DELAY_S * 10)) + 1;
+        ruc_date[i] = ruc_tick + delay;
+        ruc_timer_start(cells[i], delay * TICK_MS, ruc_expired, (void *) i);
+    }
+    expired = 0;
+    errors = 0;
+    gettimeofday(&tic, NULL);
+    for (i = 0; i < MAX_DELAY_S * 10; i++) {
+        ruc_tick++;
+        ruc_timer_process();
+    }
+    gettimeofday(&toc, NULL);
+    expire_ns = ns_per_op(&tic, &toc, nb);
+
+    printf("%-10s %10d %10.1f %10.1f %10.1f %10llu %s\n", "ruc_timer", nb, start_ns, stop_ns, expire_ns,
+            (unsigned long long) expired, ((errors == 0) && (expired == nb)) ? "OK" : "FAILED");
+    for (i = 0; i < nb; i++) ruc_timer_free(cells[i]);
+    free(cells);
+    free(ruc_date);
+}
+
+int main(int argc, char **argv) {
+    int nb;
+
+    if (argc < 2) {
+        printf("%s : nb timers\n", argv[0]);
+        return -1;
+    }
+    nb = atoi(argv[1]);
+
+    ruc_timer_init(TIMER_TICK_VALUE_100MS, TIMER_SLOT_SIZE_128);
+    com_tx_tmr_init(TICK_MS, 0x7FFFFFFF / COM_TX_TMR_SLOT_MAX);
+
+    printf("%-10s %10s %10s %10s %10s %10s %s\n", "timer", "nb", "start ns", "stop ns", "expire ns", "expired", "check");
+    com_tx_throughput(nb);
+    ruc_throughput(nb);
+    return 0;
+}
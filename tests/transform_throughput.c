@@ -2,15 +2,20 @@
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
+#include <malloc.h>
 
 #include <rozofs/common/xmalloc.h>
 #include <rozofs/common/transform.h>
+#include <rozofs/rozofs.h>
+#include <rozofs/rozofs_srv.h>
 #include <sys/time.h>
 
 #define BSIZE 8192              //BYTES
 #define FORWARD 6
 #define INVERSE	4
 
+#define MB (1024.0*1024.0)
+
 int timeval_subtract(struct timeval *result, struct timeval *t2,
                      struct timeval *t1) {
     long int diff =
@@ -32,20 +37,27 @@ void timeval_print(struct timeval *tv) {
     printf(" = %s.%06ld\n", buffer, tv->tv_usec);
 }
 
-int main(int argc, char **argv) {
+static double throughput(struct timeval *tic, struct timeval *toc, int nrloop, int bbytes) {
+    struct timeval elapse;
+    double us;
+
+    timeval_subtract(&elapse, toc, tic);
+    us = elapse.tv_sec * 1000000.0 + elapse.tv_usec;
+    if (us == 0) us = 1;
+    return ((double) nrloop * bbytes / MB) / (us / 1000000.0);
+}
+
+/*
+** Legacy 64 bits transform (transform.c)
+*/
+static void legacy_throughput(int nrloop) {
     pxl_t *support;
     projection_t *projections;
-    int nrloop = 0, done;
+    int done;
     int mp;
     struct timeval tic;
     struct timeval toc;
-    struct timeval elapse;
 
-    if (argc < 2) {
-        printf("%s : nr loop\n", argv[0]);
-        return -1;
-    }
-    nrloop = atoi(argv[1]);
     support = xmalloc(BSIZE);
     memset(support, 1, BSIZE);
     projections = xmalloc(FORWARD * sizeof (projection_t));
@@ -63,16 +75,157 @@ int main(int argc, char **argv) {
         transform_forward(support, INVERSE, BSIZE / INVERSE / sizeof (pxl_t),
                           FORWARD, projections);
     gettimeofday(&toc, NULL);
-    timeval_subtract(&elapse, &toc, &tic);
-    printf("Forward: %ld.%06ld\n", elapse.tv_sec, elapse.tv_usec);
+    printf("%-8s %-10s %6d %10.1f", "legacy", "4_6_8", BSIZE, throughput(&tic, &toc, nrloop, BSIZE));
 
     gettimeofday(&tic, NULL);
     for (done = 0; done < nrloop; done++)
         transform_inverse(support, INVERSE, BSIZE / INVERSE / sizeof (pxl_t),
                           INVERSE, projections);
     gettimeofday(&toc, NULL);
-    timeval_subtract(&elapse, &toc, &tic);
-    printf("Inverse: %ld.%06ld\n", elapse.tv_sec, elapse.tv_usec);
+    printf(" %10.1f %10s %10s %s\n", throughput(&tic, &toc, nrloop, BSIZE), "-", "-", "-");
+
+    for (mp = 0; mp < FORWARD; mp++) free(projections[mp].bins);
+    free(projections);
+    free(support);
+}
+
+/*
+** 128 bits transform (mojette_transform128.c) for one engine, layout and block size
+*/
+static void engine_throughput(int nrloop, uint8_t layout, uint32_t bsize) {
+    uint8_t forward = rozofs_get_rozofs_forward(layout);
+    uint8_t inverse = rozofs_get_rozofs_inverse(layout);
+    int bbytes = ROZOFS_BSIZE_BYTES(bsize);
+    int max_psize = rozofs_get_max_psize(layout, bsize) * sizeof (bin_t);
+    projection_t fwd[ROZOFS_SAFE_MAX_STORCLI];
+    projection_t inv[ROZOFS_SAFE_MAX_STORCLI];
+    projection_opt_t opt[ROZOFS_SAFE_MAX_STORCLI];
+    projection_opt_t batch_opt[TRANSFORM128_INVERSE_BATCH_MAX][ROZOFS_SAFE_MAX_STORCLI];
+    pxl_t *batch_result[TRANSFORM128_INVERSE_BATCH_MAX];
+    transform128_inverse_prog_t *prog;
+    int key;
+    int check;
+    char *support;
+    char *result;
+    int done;
+    int mp;
+    int b;
+    double fwd_mbs, inv_mbs, prog_mbs, batch_mbs;
+    struct timeval tic;
+    struct timeval toc;
+    char *layout_name[] = {"2_3_4", "4_6_8", "8_12_16"};
+
+    support = memalign(64, bbytes);
+    result  = memalign(64, bbytes);
+    for (done = 0; done < bbytes; done++) support[done] = (char) rand();
+
+    for (mp = 0; mp < forward; mp++) {
+        fwd[mp].angle.p = rozofs_get_angles_p(layout, mp);
+        fwd[mp].angle.q = rozofs_get_angles_q(layout, mp);
+        fwd[mp].size = rozofs_get_128bits_psizes(layout, bsize, mp);
+        fwd[mp].bins = memalign(64, max_psize + 64);
+    }
+
+    gettimeofday(&tic, NULL);
+    for (done = 0; done < nrloop; done++)
+        transform128_forward((bin_t *) support, inverse, bbytes / inverse / sizeof (pxl_t),
+                             forward, fwd);
+    gettimeofday(&toc, NULL);
+    fwd_mbs = throughput(&tic, &toc, nrloop, bbytes);
+
+    /*
+    ** Rebuild from the last projections: that is the less favorable case
+    */
+    gettimeofday(&tic, NULL);
+    for (done = 0; done < nrloop; done++) {
+        memcpy(inv, &fwd[forward - inverse], inverse * sizeof (projection_t));
+        transform128_inverse_copy((pxl_t *) result, inverse, bbytes / inverse / sizeof (pxl_t),
+                                  inverse, inv, max_psize);
+    }
+    gettimeofday(&toc, NULL);
+    inv_mbs = throughput(&tic, &toc, nrloop, bbytes);
+    check = memcmp(support, result, bbytes);
+
+    /*
+    ** Same rebuild with the precompiled inverse program of the projection set
+    */
+    memset(result, 0, bbytes);
+    key = 0;
+    for (mp = 0; mp < inverse; mp++) {
+        opt[mp].projection_id = forward - inverse + mp;
+        opt[mp].bins = fwd[forward - inverse + mp].bins;
+        key |= 1 << opt[mp].projection_id;
+    }
+    prog = transform128_inverse_prog_get(layout, bsize, key);
+    gettimeofday(&tic, NULL);
+    for (done = 0; done < nrloop; done++) {
+        if (transform128_inverse_prog_run(prog, (pxl_t *) result, opt, max_psize) < 0) {
+            check = 1;
+            break;
+        }
+    }
+    gettimeofday(&toc, NULL);
+    prog_mbs = throughput(&tic, &toc, nrloop, bbytes);
+    check |= memcmp(support, result, bbytes);
+
+    /*
+    ** Same rebuild of TRANSFORM128_INVERSE_BATCH_MAX blocks decoded together
+    */
+    for (b = 0; b < TRANSFORM128_INVERSE_BATCH_MAX; b++) {
+        batch_result[b] = memalign(64, bbytes);
+        memset(batch_result[b], 0, bbytes);
+        memcpy(batch_opt[b], opt, inverse * sizeof (projection_opt_t));
+    }
+    gettimeofday(&tic, NULL);
+    for (done = 0; done < nrloop; done++) {
+        transform128_inverse_prog_run_batch(prog, batch_result, batch_opt,
+                                            TRANSFORM128_INVERSE_BATCH_MAX, max_psize);
+    }
+    gettimeofday(&toc, NULL);
+    batch_mbs = throughput(&tic, &toc, nrloop, bbytes * TRANSFORM128_INVERSE_BATCH_MAX);
+    for (b = 0; b < TRANSFORM128_INVERSE_BATCH_MAX; b++) {
+        check |= memcmp(support, batch_result[b], bbytes);
+        free(batch_result[b]);
+    }
+
+    printf("%-8s %-10s %6d %10.1f %10.1f %10.1f %10.1f %s\n",
+            transform128_engine2String(transform128_engine_get()),
+            layout_name[layout], bbytes, fwd_mbs, inv_mbs, prog_mbs, batch_mbs,
+            (check == 0) ? "OK" : "FAILED");
 
+    for (mp = 0; mp < forward; mp++) free(fwd[mp].bins);
+    free(support);
+    free(result);
+}
+
+int main(int argc, char **argv) {
+    int nrloop = 0;
+    int engine;
+    uint8_t layout;
+    uint32_t bsize;
+
+    if (argc < 2) {
+        printf("%s : nr loop\n", argv[0]);
+        return -1;
+    }
+    nrloop = atoi(argv[1]);
+    rozofs_layout_initialize();
+
+    transform128_inverse_prog_init();
+
+    printf("%-8s %-10s %6s %10s %10s %10s %10s %s\n", "engine", "layout", "bsize", "fwd MB/s", "inv MB/s", "prog MB/s", "batch MB/s", "check");
+    legacy_throughput(nrloop);
+
+    for (engine = 0; engine < TRANSFORM128_ENGINE_MAX; engine++) {
+        if (transform128_engine_set(engine) != 0) {
+            printf("%-8s not supported by this CPU\n", transform128_engine2String(engine));
+            continue;
+        }
+        for (layout = 0; layout < LAYOUT_MAX; layout++) {
+            for (bsize = ROZOFS_BSIZE_MIN; bsize <= ROZOFS_BSIZE_MAX; bsize++) {
+                engine_throughput(nrloop, layout, bsize);
+            }
+        }
+    }
     return 0;
 }